@@ -0,0 +1,63 @@
+#!/bin/bash
+
+# Checks that simd::vec costs nothing on AArch64: disassembles neon_vec_example
+# and compares every vec_<name> function with its hand-written raw_<name>
+# twin, as x86/check_vec_codegen.sh does. Addresses and padding are
+# normalised away; the instructions must match, in order or, failing that, as
+# a set with register numbers ignored (the compiler may schedule and allocate
+# differently when argument evaluation order differs between the sources).
+#
+# Usage: ./check_vec_codegen.sh [binary ...]
+# Default: ./build/neon/neon_vec_example
+
+OBJDUMP=${OBJDUMP:-aarch64-linux-gnu-objdump}
+
+if [ $# -eq 0 ]; then
+    set -- ./build/neon/neon_vec_example
+fi
+
+# The instructions of function $2 in binary $1, one per line.
+body() {
+    $OBJDUMP -d --no-show-raw-insn "$1" |
+        awk -v f="<$2>:" '$2 == f { on = 1; next } on && /^$/ { exit } on' |
+        cut -f2- |
+        sed -E 's/[[:space:]]*\/\/.*//;
+                s/[0-9a-f]+ <(raw|vec)_[A-Za-z0-9_]+(\+0x[0-9a-f]+)?>/<self\2>/g;
+                s/[0-9a-f]+ </</g;
+                s/[[:space:]]+/ /g; s/ $//' |
+        grep -vE '^(nop|udf)'
+}
+
+# The same, as a sorted list with branch targets and register numbers dropped.
+unordered() {
+    echo "$1" | sed -E 's/<self\+0x[0-9a-f]+>/<self>/g; s/\b([vqdszp])[0-9]+/\1/g' | sort
+}
+
+status=0
+for bin in "$@"; do
+    if [ ! -f "$bin" ]; then
+        echo "Error: $bin not found; build first (./build.sh)"
+        exit 1
+    fi
+    echo "$bin"
+    for raw in $($OBJDUMP -t "$bin" | awk '$NF ~ /^raw_/ { print $NF }' | sort -u); do
+        name=${raw#raw_}
+        a=$(body "$bin" "$raw")
+        b=$(body "$bin" "vec_$name")
+        if [ -z "$b" ]; then
+            echo "  $name: no vec_$name"
+            status=1
+        elif [ -n "$a" ] && [ "$a" == "$b" ]; then
+            echo "  $name: identical ($(echo "$a" | wc -l) instructions)"
+        elif [ -n "$a" ] && [ "$(unordered "$a")" == "$(unordered "$b")" ]; then
+            echo "  $name: same $(echo "$a" | wc -l) instructions, scheduled differently"
+        elif [ -n "$a" ] && [ -z "$(comm -13 <(unordered "$a") <(unordered "$b"))" ]; then
+            echo "  $name: $(echo "$b" | wc -l) instructions, all in the raw $(echo "$a" | wc -l)"
+        else
+            echo "  $name: DIFFERENT"
+            diff <(echo "$a") <(echo "$b") | sed 's/^/    /'
+            status=1
+        fi
+    done
+done
+exit $status
@@ -0,0 +1,61 @@
+#ifndef AMAC_H
+#define AMAC_H
+
+#include <cstddef>
+
+namespace simd {
+
+// AMAC (asynchronous memory access chaining; Kocberber et al., VLDB 2015),
+// the engine of the x86 amac.h in plain C++ with __builtin_prefetch. It
+// keeps kInFlight pointer-chasing lookups open and advances them round-robin,
+// one dependent load each, prefetching the next address of every lookup it
+// leaves, so their cache misses overlap. A finished lookup's slot starts the
+// next one straight away.
+//
+// A Probe provides:
+//
+//   typedef ... State;
+//   const void* start(size_t i, State& s);   // begins lookup i
+//   const void* step(State& s);              // one dependent load
+//
+// Both return the next address the lookup reads, or null once it is done
+// (the probe stores its result). 8 to 16 lookups in flight suit steps of a
+// few instructions.
+
+template <size_t kInFlight, typename Probe>
+inline void amac_run(Probe& probe, size_t n) {
+    typename Probe::State state[kInFlight];
+    bool live[kInFlight];
+    size_t next = 0, active = 0;
+    // Starts lookups in slot s until one needs a load or none are left.
+    auto refill = [&](size_t s) {
+        while (next < n) {
+            const void* p = probe.start(next++, state[s]);
+            if (p) {
+                __builtin_prefetch(p);
+                return true;
+            }
+        }
+        return false;
+    };
+    for (size_t s = 0; s < kInFlight; ++s) {
+        live[s] = refill(s);
+        active += live[s];
+    }
+    while (active) {
+        for (size_t s = 0; s < kInFlight; ++s) {
+            if (!live[s]) continue;
+            const void* p = probe.step(state[s]);
+            if (p) {
+                __builtin_prefetch(p);
+            } else if (!refill(s)) {
+                live[s] = false;
+                --active;
+            }
+        }
+    }
+}
+
+} // namespace simd
+
+#endif // AMAC_H
@@ -0,0 +1,278 @@
+#ifndef BASE64_H
+#define BASE64_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace simd {
+
+// Base64 for NEON and SVE, with the API of the x86 base64.h. This header has
+// the parts both share: the tables, the scalar group loops, and the
+// streaming classes, which take the vector loops as a Codec:
+//
+//   struct Codec {
+//       // the n / 3 whole groups of src -> 4 characters each
+//       static void encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet);
+//       // n characters, n a multiple of 4, no padding; false if one is
+//       // outside the alphabet
+//       static bool decode(const char* src, size_t n, uint8_t* dst, Base64 alphabet);
+//   };
+//
+// base64_neon.h and base64_sve.h provide one each, with typedefs of the
+// classes below and one-shot base64_encode / base64_decode.
+
+enum class Base64 {
+    Standard,  // A-Z a-z 0-9 + /
+    Url        // A-Z a-z 0-9 - _
+};
+
+// Characters for n bytes: 4 per whole group of 3, 2 or 3 for a last group
+// of 1 or 2 bytes, padded with '=' to 4 if pad is set.
+inline size_t base64_encoded_length(size_t n, bool pad = true) {
+    return pad ? (n + 2) / 3 * 4 : n / 3 * 4 + (n % 3 ? n % 3 + 1 : 0);
+}
+
+// Bytes at most for n characters.
+inline size_t base64_decoded_length(size_t n) {
+    return n / 4 * 3 + n % 4 * 3 / 4;
+}
+
+struct Base64Tables {
+    char encode[64];          // 6-bit value -> character
+    uint8_t decode[256];      // character -> 6-bit value, 0xFF outside the alphabet
+    // 16-entry tables for byte shuffles (svtbl), as in the x86 base64.
+    // encode_shift is the offset from a 6-bit value to its character by
+    // range: 0 for a-z, 1..10 for 0-9, 11 and 12 for 62 and 63, 13 for A-Z.
+    // A character is valid if decode_lo[low nibble] & decode_hi[high
+    // nibble] is 0; decode_roll[high nibble] takes it back to 0..63, after
+    // decode_special moves to slot 1 by adding decode_special_delta.
+    uint8_t encode_shift[16];
+    uint8_t decode_lo[16];
+    uint8_t decode_hi[16];
+    uint8_t decode_roll[16];
+    uint8_t decode_special;
+    uint8_t decode_special_delta;
+};
+
+inline Base64Tables base64_make_tables(Base64 alphabet) {
+    static const uint8_t kLo[2][16] = {
+        {0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A},
+        {0x0B, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x07, 0x37, 0x37, 0x35, 0x37, 0x27}};
+    static const uint8_t kHi[2][16] = {
+        {0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10},
+        {0x01, 0x01, 0x02, 0x04, 0x08, 0x10, 0x08, 0x20, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01}};
+    const bool url = alphabet == Base64::Url;
+    const char c62 = url ? '-' : '+', c63 = url ? '_' : '/';
+    Base64Tables t;
+    std::memcpy(t.encode, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", 62);
+    t.encode[62] = c62;
+    t.encode[63] = c63;
+    std::memset(t.decode, 0xFF, sizeof t.decode);
+    for (int i = 0; i < 64; ++i) t.decode[(uint8_t)t.encode[i]] = (uint8_t)i;
+
+    std::memset(t.encode_shift, 0, 16);
+    t.encode_shift[0] = (uint8_t)('a' - 26);
+    for (int r = 1; r <= 10; ++r) t.encode_shift[r] = (uint8_t)('0' - 52);
+    t.encode_shift[11] = (uint8_t)(c62 - 62);
+    t.encode_shift[12] = (uint8_t)(c63 - 63);
+    t.encode_shift[13] = (uint8_t)'A';
+    std::memcpy(t.decode_lo, kLo[url], 16);
+    std::memcpy(t.decode_hi, kHi[url], 16);
+    // 62 and 63 share a high nibble with another range in either alphabet
+    // ('+' and '/'; 'P'..'Z' and '_'): c63 goes to the unused slot 1.
+    std::memset(t.decode_roll, 0, 16);
+    t.decode_roll[1] = (uint8_t)(63 - c63);
+    t.decode_roll[c62 >> 4] = (uint8_t)(62 - c62);
+    t.decode_roll[3] = (uint8_t)(52 - '0');
+    t.decode_roll[4] = t.decode_roll[5] = (uint8_t)-'A';
+    t.decode_roll[6] = t.decode_roll[7] = (uint8_t)(26 - 'a');
+    t.decode_special = (uint8_t)c63;
+    t.decode_special_delta = (uint8_t)(1 - (c63 >> 4));
+    return t;
+}
+
+inline const Base64Tables& base64_tables(Base64 alphabet) {
+    static const Base64Tables standard = base64_make_tables(Base64::Standard);
+    static const Base64Tables url = base64_make_tables(Base64::Url);
+    return alphabet == Base64::Url ? url : standard;
+}
+
+// The n / 3 whole groups of src, one at a time.
+inline void base64_encode_groups(const Base64Tables& t, const uint8_t* src, size_t n, char* dst) {
+    for (size_t i = 0; i + 3 <= n; i += 3, dst += 4) {
+        uint32_t v = (uint32_t)src[i] << 16 | (uint32_t)src[i + 1] << 8 | src[i + 2];
+        dst[0] = t.encode[v >> 18];
+        dst[1] = t.encode[v >> 12 & 63];
+        dst[2] = t.encode[v >> 6 & 63];
+        dst[3] = t.encode[v & 63];
+    }
+}
+
+// 2, 3 or 4 characters -> 1, 2 or 3 bytes; false if one is outside the
+// alphabet ('=' included).
+inline bool base64_decode_partial(const Base64Tables& t, const char* src, size_t chars, uint8_t* dst) {
+    uint32_t v = 0, bad = 0;
+    for (size_t j = 0; j < chars; ++j) {
+        uint32_t d = t.decode[(uint8_t)src[j]];
+        bad |= d;
+        v |= (d & 63) << (18 - 6 * j);
+    }
+    if (bad & 0x80) return false;
+    for (size_t j = 0; j + 1 < chars; ++j) dst[j] = (uint8_t)(v >> (16 - 8 * j));
+    return true;
+}
+
+// n a multiple of 4.
+inline bool base64_decode_groups(const Base64Tables& t, const char* src, size_t n, uint8_t* dst) {
+    for (size_t i = 0; i < n; i += 4, dst += 3) {
+        if (!base64_decode_partial(t, src + i, 4, dst)) return false;
+    }
+    return true;
+}
+
+// Streaming encoder: update converts what it can and keeps up to 2 bytes
+// for the next call; finish writes the last group and resets.
+template <typename Codec>
+class Base64Encoder {
+public:
+    explicit Base64Encoder(Base64 alphabet = Base64::Standard, bool pad = true)
+        : alphabet_(alphabet), pad_(pad), carry_size_(0) {}
+
+    // Writes at most base64_encoded_length(n + 2) characters; returns the
+    // count.
+    size_t update(const uint8_t* src, size_t n, char* dst) {
+        size_t k = 0;
+        if (carry_size_) {
+            while (carry_size_ < 3 && n) {
+                carry_[carry_size_++] = *src++;
+                --n;
+            }
+            if (carry_size_ < 3) return 0;
+            base64_encode_groups(base64_tables(alphabet_), carry_, 3, dst);
+            k = 4;
+            carry_size_ = 0;
+        }
+        size_t whole = n / 3 * 3;
+        Codec::encode(src, whole, dst + k, alphabet_);
+        k += whole / 3 * 4;
+        for (size_t i = whole; i < n; ++i) carry_[carry_size_++] = src[i];
+        return k;
+    }
+
+    // Writes at most 4 characters; returns the count.
+    size_t finish(char* dst) {
+        size_t k = 0;
+        if (carry_size_) {
+            const char* chars = base64_tables(alphabet_).encode;
+            uint32_t v = (uint32_t)carry_[0] << 16 | (carry_size_ == 2 ? (uint32_t)carry_[1] << 8 : 0);
+            dst[k++] = chars[v >> 18];
+            dst[k++] = chars[v >> 12 & 63];
+            if (carry_size_ == 2) dst[k++] = chars[v >> 6 & 63];
+            while (pad_ && k < 4) dst[k++] = '=';
+        }
+        carry_size_ = 0;
+        return k;
+    }
+
+private:
+    Base64 alphabet_;
+    bool pad_;
+    uint8_t carry_[3];
+    size_t carry_size_;
+};
+
+// Streaming decoder: padding is optional but must complete the last group;
+// whitespace is not skipped. update keeps up to 3 characters for the next
+// call. After a false return every call fails until finish resets it.
+template <typename Codec>
+class Base64Decoder {
+public:
+    explicit Base64Decoder(Base64 alphabet = Base64::Standard)
+        : alphabet_(alphabet), carry_size_(0), ended_(false), failed_(false) {}
+
+    // Writes at most base64_decoded_length(n + 3) bytes and sets *written.
+    bool update(const char* src, size_t n, uint8_t* dst, size_t* written) {
+        size_t k = 0;
+        *written = 0;
+        if (failed_ || (ended_ && n)) return fail();
+        if (carry_size_) {
+            while (carry_size_ < 4 && n) {
+                carry_[carry_size_++] = *src++;
+                --n;
+            }
+            if (carry_size_ == 4 && !flush_group(dst, &k)) return fail();
+        }
+        // Whole groups but a last one with padding: the codec sees none.
+        size_t whole = n / 4 * 4;
+        if (whole && src[whole - 1] == '=') whole -= 4;
+        if (whole) {
+            if (ended_ || !Codec::decode(src, whole, dst + k, alphabet_)) return fail();
+            k += whole / 4 * 3;
+        }
+        for (size_t i = whole; i < n; ++i) {
+            carry_[carry_size_++] = src[i];
+            if (ended_ || (carry_size_ == 4 && !flush_group(dst, &k))) return fail();
+        }
+        *written = k;
+        return true;
+    }
+
+    // Writes at most 2 bytes and sets *written; false if the stream was
+    // invalid or stopped after 4k + 1 characters.
+    bool finish(uint8_t* dst, size_t* written) {
+        *written = 0;
+        bool ok = !failed_ && carry_size_ != 1 && (carry_size_ == 0 || !ended_);
+        if (ok && carry_size_) {
+            ok = base64_decode_partial(base64_tables(alphabet_), carry_, carry_size_, dst);
+            if (ok) *written = carry_size_ - 1;
+        }
+        carry_size_ = 0;
+        ended_ = failed_ = false;
+        return ok;
+    }
+
+private:
+    bool fail() {
+        failed_ = true;
+        return false;
+    }
+
+    // The 4 characters in carry_, which may end in padding.
+    bool flush_group(uint8_t* dst, size_t* k) {
+        size_t chars = 4;
+        if (carry_[3] == '=') chars = carry_[2] == '=' ? 2 : 3;
+        carry_size_ = 0;
+        if (!base64_decode_partial(base64_tables(alphabet_), carry_, chars, dst + *k)) return false;
+        ended_ = chars < 4;
+        *k += chars - 1;
+        return true;
+    }
+
+    Base64 alphabet_;
+    char carry_[4];
+    size_t carry_size_;
+    bool ended_;  // a group with padding was seen; nothing may follow
+    bool failed_;
+};
+
+// One-shot forms for a Codec: the whole input as a single update.
+template <typename Codec>
+size_t base64_encode_with(const uint8_t* src, size_t n, char* dst, Base64 alphabet, bool pad) {
+    Base64Encoder<Codec> enc(alphabet, pad);
+    size_t k = enc.update(src, n, dst);
+    return k + enc.finish(dst + k);
+}
+
+template <typename Codec>
+bool base64_decode_with(const char* src, size_t n, uint8_t* dst, size_t* written, Base64 alphabet) {
+    Base64Decoder<Codec> dec(alphabet);
+    size_t k = 0, tail = 0;
+    bool ok = dec.update(src, n, dst, &k) && dec.finish(dst + k, &tail);
+    *written = k + tail;
+    return ok;
+}
+
+} // namespace simd
+
+#endif // BASE64_H
@@ -0,0 +1,98 @@
+#ifndef BASE64_NEON_H
+#define BASE64_NEON_H
+
+#include <arm_neon.h>
+#include <cstddef>
+#include <cstdint>
+#include "base64.h"
+
+namespace simd {
+namespace neon {
+
+// Base64 with structure loads and stores, which do the (de)interleaving
+// that x86 needs shuffles for:
+//
+//   encode  vld3q_u8 splits 48 bytes into the first, second and third bytes
+//           of 16 groups; shifts and masks make the four 6-bit planes;
+//           vqtbl4q_u8 looks each up in the 64-character alphabet; vst4q_u8
+//           interleaves them into 64 characters.
+//   decode  vld4q_u8 splits 64 characters into 4 planes; each is looked up
+//           in the 128-entry decode table with vqtbl4q_u8 (characters 0-63)
+//           and vqtbx4q_u8 (64-127); 0xFF marks a character outside the
+//           alphabet and characters from 0x80 have the bit themselves, so
+//           one vmaxvq_u8 of the ORs checks the block; shifts merge the
+//           planes into 3 and vst3q_u8 writes 48 bytes.
+//
+// What does not fill a block goes through the scalar group loops.
+
+struct Base64Codec {
+    static void encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet) {
+        const Base64Tables& t = base64_tables(alphabet);
+        const uint8_t* chars = reinterpret_cast<const uint8_t*>(t.encode);
+        uint8x16x4_t table;
+        for (int j = 0; j < 4; ++j) table.val[j] = vld1q_u8(chars + 16 * j);
+        const uint8x16_t low6 = vdupq_n_u8(63);
+        size_t i = 0;
+        for (; n - i >= 48; i += 48, dst += 64) {
+            uint8x16x3_t in = vld3q_u8(src + i);
+            uint8x16x4_t out;
+            out.val[0] = vshrq_n_u8(in.val[0], 2);
+            out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), low6);
+            out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), low6);
+            out.val[3] = vandq_u8(in.val[2], low6);
+            for (int j = 0; j < 4; ++j) out.val[j] = vqtbl4q_u8(table, out.val[j]);
+            vst4q_u8(reinterpret_cast<uint8_t*>(dst), out);
+        }
+        base64_encode_groups(t, src + i, n - i, dst);
+    }
+
+    static bool decode(const char* src, size_t n, uint8_t* dst, Base64 alphabet) {
+        const Base64Tables& t = base64_tables(alphabet);
+        const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+        uint8x16x4_t lo, hi;
+        for (int j = 0; j < 4; ++j) {
+            lo.val[j] = vld1q_u8(t.decode + 16 * j);
+            hi.val[j] = vld1q_u8(t.decode + 64 + 16 * j);
+        }
+        const uint8x16_t sixty_four = vdupq_n_u8(64);
+        size_t i = 0;
+        for (; i + 64 <= n; i += 64, dst += 48) {
+            uint8x16x4_t in = vld4q_u8(s + i);
+            uint8x16_t v[4], bad = vdupq_n_u8(0);
+            for (int j = 0; j < 4; ++j) {
+                v[j] = vqtbx4q_u8(vqtbl4q_u8(lo, in.val[j]), hi, vsubq_u8(in.val[j], sixty_four));
+                bad = vorrq_u8(bad, vorrq_u8(v[j], in.val[j]));
+            }
+            if (vmaxvq_u8(bad) & 0x80) return false;
+            uint8x16x3_t out;
+            out.val[0] = vorrq_u8(vshlq_n_u8(v[0], 2), vshrq_n_u8(v[1], 4));
+            out.val[1] = vorrq_u8(vshlq_n_u8(v[1], 4), vshrq_n_u8(v[2], 2));
+            out.val[2] = vorrq_u8(vshlq_n_u8(v[2], 6), v[3]);
+            vst3q_u8(dst, out);
+        }
+        return base64_decode_groups(t, src + i, n - i, dst);
+    }
+};
+
+typedef simd::Base64Encoder<Base64Codec> Base64Encoder;
+typedef simd::Base64Decoder<Base64Codec> Base64Decoder;
+
+// Encodes n bytes into base64_encoded_length(n, pad) characters; returns
+// that count.
+inline size_t base64_encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet = Base64::Standard,
+                            bool pad = true) {
+    return base64_encode_with<Base64Codec>(src, n, dst, alphabet, pad);
+}
+
+// Decodes n characters into dst (room for base64_decoded_length(n) bytes),
+// setting *written; false on a character outside the alphabet, misplaced
+// padding or a length of 4k + 1.
+inline bool base64_decode(const char* src, size_t n, uint8_t* dst, size_t* written,
+                          Base64 alphabet = Base64::Standard) {
+    return base64_decode_with<Base64Codec>(src, n, dst, written, alphabet);
+}
+
+} // namespace neon
+} // namespace simd
+
+#endif // BASE64_NEON_H
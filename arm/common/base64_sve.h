@@ -0,0 +1,96 @@
+#ifndef BASE64_SVE_H
+#define BASE64_SVE_H
+
+#include <arm_sve.h>
+#include <cstddef>
+#include <cstdint>
+#include "base64.h"
+
+namespace simd {
+namespace sve {
+
+// Base64 for any vector length. svld3/svst4 (encode) and svld4/svst3
+// (decode) split and merge the groups as the NEON structure loads do, under
+// a svwhilelt predicate, so the last partial vector needs no scalar loop.
+// A 64-entry svtbl would need a 512-bit vector, so the translation uses the
+// 16-entry tables of the x86 SSE kernels instead, loaded with svld1rq into
+// the first 16 bytes of a table vector of any length:
+//
+//   encode  offset = encode_shift[range], range from one saturating
+//           subtract and one compare; character = value + offset
+//   decode  invalid if decode_lo[c & 15] & decode_hi[c >> 4] is not 0;
+//           value = c + decode_roll[c >> 4], after the one character that
+//           shares its high nibble with another range moves to slot 1
+
+struct Base64Codec {
+    static void encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet) {
+        const Base64Tables& t = base64_tables(alphabet);
+        const svuint8_t shift = svld1rq_u8(svptrue_b8(), t.encode_shift);
+        uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+        const uint64_t groups = n / 3;
+        for (uint64_t g = 0; g < groups; g += svcntb()) {
+            svbool_t pg = svwhilelt_b8_u64(g, groups);
+            svuint8x3_t in = svld3_u8(pg, src + 3 * g);
+            svuint8_t a = svget3_u8(in, 0), b = svget3_u8(in, 1), c = svget3_u8(in, 2);
+            svuint8_t f[4];
+            f[0] = svlsr_n_u8_x(pg, a, 2);
+            f[1] = svand_n_u8_x(pg, svorr_u8_x(pg, svlsl_n_u8_x(pg, a, 4), svlsr_n_u8_x(pg, b, 4)), 63);
+            f[2] = svand_n_u8_x(pg, svorr_u8_x(pg, svlsl_n_u8_x(pg, b, 2), svlsr_n_u8_x(pg, c, 6)), 63);
+            f[3] = svand_n_u8_x(pg, c, 63);
+            for (int j = 0; j < 4; ++j) {
+                // 0..25 -> 13, 26..51 -> 0, 52..63 -> 1..12.
+                svuint8_t range = svqsub_n_u8(f[j], 51);
+                range = svsel_u8(svcmplt_n_u8(pg, f[j], 26), svdup_n_u8(13), range);
+                f[j] = svadd_u8_x(pg, f[j], svtbl_u8(shift, range));
+            }
+            svst4_u8(pg, out + 4 * g, svcreate4_u8(f[0], f[1], f[2], f[3]));
+        }
+    }
+
+    static bool decode(const char* src, size_t n, uint8_t* dst, Base64 alphabet) {
+        const Base64Tables& t = base64_tables(alphabet);
+        const svbool_t all = svptrue_b8();
+        const svuint8_t lut_lo = svld1rq_u8(all, t.decode_lo);
+        const svuint8_t lut_hi = svld1rq_u8(all, t.decode_hi);
+        const svuint8_t roll = svld1rq_u8(all, t.decode_roll);
+        const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+        const uint64_t groups = n / 4;
+        for (uint64_t g = 0; g < groups; g += svcntb()) {
+            svbool_t pg = svwhilelt_b8_u64(g, groups);
+            svuint8x4_t in = svld4_u8(pg, s + 4 * g);
+            svuint8_t v[4], bad = svdup_n_u8(0);
+            for (int j = 0; j < 4; ++j) {
+                svuint8_t c = svget4_u8(in, j);
+                svuint8_t hi = svlsr_n_u8_x(pg, c, 4);
+                svuint8_t lo = svand_n_u8_x(pg, c, 15);
+                bad = svorr_u8_x(pg, bad, svand_u8_x(pg, svtbl_u8(lut_lo, lo), svtbl_u8(lut_hi, hi)));
+                hi = svadd_n_u8_m(svcmpeq_n_u8(pg, c, t.decode_special), hi, t.decode_special_delta);
+                v[j] = svadd_u8_x(pg, c, svtbl_u8(roll, hi));
+            }
+            if (svptest_any(pg, svcmpne_n_u8(pg, bad, 0))) return false;
+            svuint8_t b0 = svorr_u8_x(pg, svlsl_n_u8_x(pg, v[0], 2), svlsr_n_u8_x(pg, v[1], 4));
+            svuint8_t b1 = svorr_u8_x(pg, svlsl_n_u8_x(pg, v[1], 4), svlsr_n_u8_x(pg, v[2], 2));
+            svuint8_t b2 = svorr_u8_x(pg, svlsl_n_u8_x(pg, v[2], 6), v[3]);
+            svst3_u8(pg, dst + 3 * g, svcreate3_u8(b0, b1, b2));
+        }
+        return true;
+    }
+};
+
+typedef simd::Base64Encoder<Base64Codec> Base64Encoder;
+typedef simd::Base64Decoder<Base64Codec> Base64Decoder;
+
+inline size_t base64_encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet = Base64::Standard,
+                            bool pad = true) {
+    return base64_encode_with<Base64Codec>(src, n, dst, alphabet, pad);
+}
+
+inline bool base64_decode(const char* src, size_t n, uint8_t* dst, size_t* written,
+                          Base64 alphabet = Base64::Standard) {
+    return base64_decode_with<Base64Codec>(src, n, dst, written, alphabet);
+}
+
+} // namespace sve
+} // namespace simd
+
+#endif // BASE64_SVE_H
@@ -0,0 +1,241 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace simd {
+
+// CRC-32C, Adler-32 and hash64 for NEON, with the API and the values of the
+// x86 checksum.h: each takes the value so far and returns it updated, and
+// the copy_ forms copy src to dst in the same pass. This header has what
+// does not depend on the ISA: the tables and constants, the scalar loops
+// and the streaming Hash64, which takes the vector loops as a Codec:
+//
+//   struct Codec {
+//       // The checksum of src[0, n) from crc / adler; src is also copied
+//       // to dst unless it is null.
+//       static uint32_t crc32c(const uint8_t* src, size_t n, uint32_t crc, uint8_t* dst);
+//       static uint32_t adler32(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst);
+//       // Whole 64-byte stripes into the 8 lanes of a hash; the first is at
+//       // position first (0..15) of its 1 KiB block.
+//       static void hash64_stripes(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes,
+//                                  size_t first, uint8_t* dst);
+//   };
+//
+// checksum_neon.h provides one, with a typedef of Hash64 and the one-shot
+// functions.
+
+const uint32_t kAdlerMod = 65521;
+// The most bytes before s2 may overflow 32 bits.
+const size_t kAdlerNmax = 5552;
+
+// hash64: 16 stripes of a block take their key from words [s, s + 8), the
+// scramble after the block from the last 8. The secret is 24 words of
+// splitmix64; the seed is added to the even words and subtracted from the
+// odd ones.
+const size_t kHash64KeyWords = 24;
+const uint64_t kHash64Prime32 = 0x9E3779B1ull;
+const uint64_t kHash64Prime64 = 0x9E3779B185EBCA87ull;
+const uint64_t kHash64Init[8] = {0xC2B2AE3Dull,         0x9E3779B185EBCA87ull, 0xC2B2AE3D27D4EB4Full,
+                                 0x165667B19E3779F9ull, 0x85EBCA77C2B2AE63ull, 0x85EBCA77ull,
+                                 0x27D4EB2F165667C5ull, 0x9E3779B1ull};
+const uint64_t kHash64Secret[kHash64KeyWords] = {
+    0x2CB0F69F4ABEA221ull, 0x9417034723148989ull, 0xDD555950609DFE03ull, 0xDBAFB150DEB12800ull,
+    0x7E789B2E6C442CB6ull, 0xF41E5636C7E4F8C4ull, 0x0959D150F8FBA7E4ull, 0xA97316F13CDB9EEAull,
+    0x74CD8258F9520068ull, 0x55C74A62E116868Bull, 0xD2F4C799A2023CBDull, 0xDF98CB79A37B51B9ull,
+    0x396F5885524F3905ull, 0xAF1D56386CA3B276ull, 0xA9FFBE6B5104E85Aull, 0x6BD0C51B9FD533B3ull,
+    0x980CE91C50AB4B56ull, 0x28AC395780FE62C5ull, 0x768912E3A6BCEDC7ull, 0x50B3E8C9332C7C88ull,
+    0xCE3BBFE520BD47DAull, 0xCBA6C8E8E0BB7C4Full, 0xBF194DB8434A346Dull, 0x7D8F2A7B60416D7Full,
+};
+
+// Slicing-by-8: t[k][b] is the CRC of byte b followed by k zero bytes.
+struct Crc32cTables {
+    uint32_t t[8][256];
+};
+
+inline const Crc32cTables& crc32c_tables() {
+    struct Builder {
+        Crc32cTables tables;
+        Builder() {
+            for (uint32_t b = 0; b < 256; ++b) {
+                uint32_t c = b;
+                for (int k = 0; k < 8; ++k) c = c >> 1 ^ (c & 1 ? 0x82F63B78u : 0);
+                tables.t[0][b] = c;
+            }
+            for (int k = 1; k < 8; ++k) {
+                for (uint32_t b = 0; b < 256; ++b) {
+                    uint32_t c = tables.t[k - 1][b];
+                    tables.t[k][b] = c >> 8 ^ tables.t[0][c & 0xFF];
+                }
+            }
+        }
+    };
+    static const Builder builder;
+    return builder.tables;
+}
+
+// The CRC register (not inverted) after n more bytes.
+inline uint32_t crc32c_bytes(uint32_t c, const uint8_t* p, size_t n) {
+    const uint32_t (*t)[256] = crc32c_tables().t;
+    for (; n >= 8; n -= 8, p += 8) {
+        uint32_t lo, hi;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 4);
+        lo ^= c;
+        c = t[7][lo & 0xFF] ^ t[6][lo >> 8 & 0xFF] ^ t[5][lo >> 16 & 0xFF] ^ t[4][lo >> 24] ^
+            t[3][hi & 0xFF] ^ t[2][hi >> 8 & 0xFF] ^ t[1][hi >> 16 & 0xFF] ^ t[0][hi >> 24];
+    }
+    for (; n; --n) c = c >> 8 ^ t[0][(c ^ *p++) & 0xFF];
+    return c;
+}
+
+// Adler-32 a byte at a time, for inputs below a vector and the tails.
+// Copies to dst unless it is null.
+inline uint32_t adler32_bytes(uint32_t s1, uint32_t s2, const uint8_t* src, size_t n, uint8_t* dst) {
+    if (dst) std::memcpy(dst, src, n);
+    while (n) {
+        size_t m = n < kAdlerNmax ? n : kAdlerNmax;
+        n -= m;
+        for (; m; --m) {
+            s1 += *src++;
+            s2 += s1;
+        }
+        s1 %= kAdlerMod;
+        s2 %= kAdlerMod;
+    }
+    return s2 << 16 | s1;
+}
+
+// The reference the vector codecs are checked against. The copy forms go
+// 4 KiB at a time, copied and then summed while they are still in L1.
+struct ChecksumScalarCodec {
+    static uint32_t crc32c(const uint8_t* src, size_t n, uint32_t crc, uint8_t* dst) {
+        uint32_t c = ~crc;
+        for (size_t i = 0; i < n; i += 4096) {
+            size_t m = n - i < 4096 ? n - i : 4096;
+            if (dst) std::memcpy(dst + i, src + i, m);
+            c = crc32c_bytes(c, src + i, m);
+        }
+        return ~c;
+    }
+
+    static uint32_t adler32(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst) {
+        return adler32_bytes(adler & 0xFFFF, adler >> 16, src, n, dst);
+    }
+
+    static void hash64_stripes(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes, size_t first,
+                               uint8_t* dst) {
+        if (dst) std::memcpy(dst, src, stripes * 64);
+        size_t p = first;
+        for (size_t s = 0; s < stripes; ++s, src += 64) {
+            for (size_t i = 0; i < 8; ++i) {
+                uint64_t d;
+                std::memcpy(&d, src + 8 * i, 8);
+                uint64_t dk = d ^ key[p + i];
+                acc[i ^ 1] += d;
+                acc[i] += (dk & 0xFFFFFFFF) * (dk >> 32);
+            }
+            if (++p == 16) {
+                p = 0;
+                for (size_t i = 0; i < 8; ++i) acc[i] = (acc[i] ^ acc[i] >> 47 ^ key[16 + i]) * kHash64Prime32;
+            }
+        }
+    }
+};
+
+// Streaming hash64, for input that arrives in pieces of any size. update
+// keeps the end of a stripe (at most 63 bytes) for the next call; digest is
+// the hash of everything so far and can be read at any time.
+template <typename Codec>
+class Hash64 {
+public:
+    explicit Hash64(uint64_t seed = 0) {
+        for (size_t j = 0; j < kHash64KeyWords; ++j) key_[j] = kHash64Secret[j] + (j % 2 ? 0 - seed : seed);
+        reset();
+    }
+
+    void update(const void* src, size_t n) { absorb(static_cast<const uint8_t*>(src), n, nullptr); }
+    // update, and copy src to dst.
+    void copy(void* dst, const void* src, size_t n) {
+        absorb(static_cast<const uint8_t*>(src), n, static_cast<uint8_t*>(dst));
+    }
+
+    // The input is hashed as if padded with zeros to whole stripes; the
+    // length tells the padding from data.
+    uint64_t digest() const {
+        uint64_t acc[8];
+        std::memcpy(acc, acc_, sizeof acc);
+        if (carry_size_) {
+            uint8_t last[64] = {};
+            std::memcpy(last, carry_, carry_size_);
+            Codec::hash64_stripes(acc, key_, last, 1, stripe_, nullptr);
+        }
+        // Merged with key bytes from 11 on, off the word grid of the stripes.
+        uint64_t merge[8];
+        std::memcpy(merge, reinterpret_cast<const uint8_t*>(key_) + 11, sizeof merge);
+        uint64_t h = total_ * kHash64Prime64;
+        for (size_t i = 0; i < 8; i += 2) {
+            unsigned __int128 p = (unsigned __int128)(acc[i] ^ merge[i]) * (acc[i + 1] ^ merge[i + 1]);
+            h += (uint64_t)p ^ (uint64_t)(p >> 64);
+        }
+        h ^= h >> 37;
+        h *= 0x165667919E3779F9ull;
+        return h ^ h >> 32;
+    }
+
+    // Starts a new stream with the same seed.
+    void reset() {
+        std::memcpy(acc_, kHash64Init, sizeof acc_);
+        carry_size_ = 0;
+        stripe_ = 0;
+        total_ = 0;
+    }
+
+private:
+    void absorb(const uint8_t* src, size_t n, uint8_t* dst) {
+        total_ += n;
+        if (carry_size_) {
+            size_t take = 64 - carry_size_ < n ? 64 - carry_size_ : n;
+            std::memcpy(carry_ + carry_size_, src, take);
+            if (dst) {
+                std::memcpy(dst, src, take);
+                dst += take;
+            }
+            carry_size_ += take;
+            src += take;
+            n -= take;
+            if (carry_size_ < 64) return;
+            Codec::hash64_stripes(acc_, key_, carry_, 1, stripe_, nullptr);
+            stripe_ = (stripe_ + 1) % 16;
+            carry_size_ = 0;
+        }
+        size_t stripes = n / 64;
+        Codec::hash64_stripes(acc_, key_, src, stripes, stripe_, dst);
+        stripe_ = (stripe_ + stripes) % 16;
+        size_t rest = n - stripes * 64;
+        std::memcpy(carry_, src + stripes * 64, rest);
+        if (dst) std::memcpy(dst + stripes * 64, src + stripes * 64, rest);
+        carry_size_ = rest;
+    }
+
+    uint64_t acc_[8];
+    uint64_t key_[kHash64KeyWords];
+    uint8_t carry_[64];
+    size_t carry_size_;
+    size_t stripe_;    // position of the next stripe in its block
+    uint64_t total_;
+};
+
+template <typename Codec>
+uint64_t hash64_with(const void* src, size_t n, uint64_t seed, void* dst) {
+    Hash64<Codec> h(seed);
+    if (dst) h.copy(dst, src, n);
+    else     h.update(src, n);
+    return h.digest();
+}
+
+} // namespace simd
+
+#endif // CHECKSUM_H
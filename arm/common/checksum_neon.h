@@ -0,0 +1,180 @@
+#ifndef CHECKSUM_NEON_H
+#define CHECKSUM_NEON_H
+
+#include <arm_neon.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "checksum.h"
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace simd {
+namespace neon {
+
+// The checksums with NEON and the optional ARMv8 extensions the build has:
+//
+//   crc32c   with CRC (+crc, mandatory from ARMv8.1), __crc32cd does 8 bytes
+//            per instruction. With AES as well (+aes), 64-byte blocks are
+//            folded into four 128-bit lanes with vmull_p64, by the
+//            constants of the x86 kernel, and two __crc32cd reduce the
+//            result. Without CRC it is the slicing-by-8 table.
+//   adler32  32 bytes per step: vmull_u8 / vmlal_u8 by the weights 32..1
+//            and vpadalq_u16 add to s2, vpaddlq_u8 / vpadalq_u8 /
+//            vpadalq_u16 to s1; s2 also gains 32 times each earlier s1,
+//            kept as one running sum and shifted in at the end.
+//   hash64   per 64-bit lane, vmlal_u32 on vmovn_u64 and vshrn_n_u64 of
+//            d ^ k gives lo32 * hi32, and vextq_u64 swaps the lanes of d.
+//
+// NEON has no streaming store intrinsic, so the copy forms use vst1q.
+
+#if defined(__ARM_FEATURE_CRC32) && defined(__ARM_FEATURE_AES)
+// x's 128 bits moved 512 or 128 bits on, plus y.
+inline uint64x2_t crc32c_fold(uint64x2_t x, poly64x2_t k, uint64x2_t y) {
+    poly128_t lo = vmull_p64((poly64_t)vgetq_lane_u64(x, 0), (poly64_t)vgetq_lane_p64(k, 0));
+    poly128_t hi = vmull_high_p64(vreinterpretq_p64_u64(x), k);
+    return veorq_u64(veorq_u64(vreinterpretq_u64_p128(lo), vreinterpretq_u64_p128(hi)), y);
+}
+#endif
+
+struct ChecksumCodec {
+    static uint32_t crc32c(const uint8_t* src, size_t n, uint32_t crc, uint8_t* dst) {
+#if defined(__ARM_FEATURE_CRC32)
+        uint32_t c = ~crc;
+        size_t i = 0;
+#if defined(__ARM_FEATURE_AES)
+        if (n >= 128) {
+            uint64x2_t x[4];
+            for (int j = 0; j < 4; ++j) {
+                uint8x16_t v = vld1q_u8(src + 16 * j);
+                if (dst) vst1q_u8(dst + 16 * j, v);
+                x[j] = vreinterpretq_u64_u8(v);
+            }
+            // The CRC so far is the same as XORing it into the first 4 bytes.
+            x[0] = veorq_u64(x[0], vreinterpretq_u64_u32(vsetq_lane_u32(c, vdupq_n_u32(0), 0)));
+            const uint64_t k512[2] = {0x740EEF02ull, 0x9E4ADDF8ull};
+            const uint64_t k128[2] = {0xF20C0DFEull, 0x14CD00BD6ull};
+            const poly64x2_t k = vreinterpretq_p64_u64(vld1q_u64(k512));
+            for (i = 64; i + 64 <= n; i += 64) {
+                for (int j = 0; j < 4; ++j) {
+                    uint8x16_t v = vld1q_u8(src + i + 16 * j);
+                    if (dst) vst1q_u8(dst + i + 16 * j, v);
+                    x[j] = crc32c_fold(x[j], k, vreinterpretq_u64_u8(v));
+                }
+            }
+            const poly64x2_t k1 = vreinterpretq_p64_u64(vld1q_u64(k128));
+            x[1] = crc32c_fold(x[0], k1, x[1]);
+            x[2] = crc32c_fold(x[1], k1, x[2]);
+            x[3] = crc32c_fold(x[2], k1, x[3]);
+            // What is left has the CRC of its 16 bytes from zero.
+            c = __crc32cd(__crc32cd(0, vgetq_lane_u64(x[3], 0)), vgetq_lane_u64(x[3], 1));
+        }
+#endif
+        for (; i + 8 <= n; i += 8) {
+            uint64_t v;
+            std::memcpy(&v, src + i, 8);
+            if (dst) std::memcpy(dst + i, &v, 8);
+            c = __crc32cd(c, v);
+        }
+        for (; i < n; ++i) {
+            if (dst) dst[i] = src[i];
+            c = __crc32cb(c, src[i]);
+        }
+        return ~c;
+#else
+        return ChecksumScalarCodec::crc32c(src, n, crc, dst);
+#endif
+    }
+
+    static uint32_t adler32(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst) {
+        static const uint8_t kWeights[32] = {32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+                                             16, 15, 14, 13, 12, 11, 10, 9,  8,  7,  6,  5,  4,  3,  2,  1};
+        const uint8x8_t w0 = vld1_u8(kWeights), w1 = vld1_u8(kWeights + 8);
+        const uint8x8_t w2 = vld1_u8(kWeights + 16), w3 = vld1_u8(kWeights + 24);
+        uint32_t s1 = adler & 0xFFFF, s2 = adler >> 16;
+        size_t i = 0;
+        while (n - i >= 32) {
+            size_t steps = (n - i) / 32 < kAdlerNmax / 32 ? (n - i) / 32 : kAdlerNmax / 32;
+            uint32x4_t ps = vsetq_lane_u32(s1 * (uint32_t)steps, vdupq_n_u32(0), 0);
+            uint32x4_t v1 = vdupq_n_u32(0), v2 = vsetq_lane_u32(s2, vdupq_n_u32(0), 0);
+            for (; steps; --steps, i += 32) {
+                uint8x16_t a = vld1q_u8(src + i), b = vld1q_u8(src + i + 16);
+                if (dst) {
+                    vst1q_u8(dst + i, a);
+                    vst1q_u8(dst + i + 16, b);
+                }
+                ps = vaddq_u32(ps, v1);
+                v1 = vpadalq_u16(v1, vpadalq_u8(vpaddlq_u8(a), b));
+                uint16x8_t m = vmull_u8(vget_low_u8(a), w0);
+                m = vmlal_u8(m, vget_high_u8(a), w1);
+                m = vmlal_u8(m, vget_low_u8(b), w2);
+                m = vmlal_u8(m, vget_high_u8(b), w3);
+                v2 = vpadalq_u16(v2, m);
+            }
+            v2 = vaddq_u32(v2, vshlq_n_u32(ps, 5));
+            s1 = (s1 + vaddvq_u32(v1)) % kAdlerMod;
+            s2 = vaddvq_u32(v2) % kAdlerMod;
+        }
+        return adler32_bytes(s1, s2, src + i, n - i, dst ? dst + i : nullptr);
+    }
+
+    static void hash64_stripes(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes, size_t first,
+                               uint8_t* dst) {
+        uint64x2_t a[4];
+        for (int j = 0; j < 4; ++j) a[j] = vld1q_u64(acc + 2 * j);
+        const uint32x2_t prime = vdup_n_u32((uint32_t)kHash64Prime32);
+        size_t p = first;
+        for (size_t s = 0; s < stripes; ++s, src += 64) {
+            for (int j = 0; j < 4; ++j) {
+                uint8x16_t v = vld1q_u8(src + 16 * j);
+                if (dst) vst1q_u8(dst + 64 * s + 16 * j, v);
+                uint64x2_t d = vreinterpretq_u64_u8(v);
+                uint64x2_t dk = veorq_u64(d, vld1q_u64(key + p + 2 * j));
+                a[j] = vaddq_u64(a[j], vextq_u64(d, d, 1));
+                a[j] = vmlal_u32(a[j], vmovn_u64(dk), vshrn_n_u64(dk, 32));
+            }
+            if (++p == 16) {
+                p = 0;
+                for (int j = 0; j < 4; ++j) {
+                    uint64x2_t x = veorq_u64(veorq_u64(a[j], vshrq_n_u64(a[j], 47)), vld1q_u64(key + 16 + 2 * j));
+                    uint64x2_t hi = vmull_u32(vshrn_n_u64(x, 32), prime);
+                    a[j] = vmlal_u32(vshlq_n_u64(hi, 32), vmovn_u64(x), prime);
+                }
+            }
+        }
+        for (int j = 0; j < 4; ++j) vst1q_u64(acc + 2 * j, a[j]);
+    }
+};
+
+typedef simd::Hash64<ChecksumCodec> Hash64;
+
+inline uint32_t crc32c(const void* src, size_t n, uint32_t crc = 0) {
+    return ChecksumCodec::crc32c(static_cast<const uint8_t*>(src), n, crc, nullptr);
+}
+
+inline uint32_t copy_crc32c(void* dst, const void* src, size_t n, uint32_t crc = 0) {
+    return ChecksumCodec::crc32c(static_cast<const uint8_t*>(src), n, crc, static_cast<uint8_t*>(dst));
+}
+
+inline uint32_t adler32(const void* src, size_t n, uint32_t adler = 1) {
+    return ChecksumCodec::adler32(static_cast<const uint8_t*>(src), n, adler, nullptr);
+}
+
+inline uint32_t copy_adler32(void* dst, const void* src, size_t n, uint32_t adler = 1) {
+    return ChecksumCodec::adler32(static_cast<const uint8_t*>(src), n, adler, static_cast<uint8_t*>(dst));
+}
+
+inline uint64_t hash64(const void* src, size_t n, uint64_t seed = 0) {
+    return hash64_with<ChecksumCodec>(src, n, seed, nullptr);
+}
+
+inline uint64_t copy_hash64(void* dst, const void* src, size_t n, uint64_t seed = 0) {
+    return hash64_with<ChecksumCodec>(src, n, seed, dst);
+}
+
+} // namespace neon
+} // namespace simd
+
+#endif // CHECKSUM_NEON_H
@@ -0,0 +1,95 @@
+#ifndef GATHER_SVE_H
+#define GATHER_SVE_H
+
+#include <arm_sve.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace simd {
+namespace sve {
+
+// Batched lookups with software prefetching, like the x86 gather.h. The
+// lookup `distance` positions ahead is prefetched while the current one is
+// gathered: svprfw_gather_u32index prefetches one whole vector of table
+// entries in a single instruction. Distances are in cache lines of table
+// data; gather_rows runs distance / (lines per row) rows ahead.
+
+// out[i] = table[idx[i]] for every i < n.
+inline void gather(const float* table, const uint32_t* idx, size_t n, float* out, size_t distance) {
+    const size_t vl = svcntw();
+    const svbool_t all = svptrue_b32();
+    size_t i = 0;
+    if (distance) {
+        for (; i + distance + vl <= n; i += vl) {
+            svprfw_gather_u32index(all, table, svld1_u32(all, idx + i + distance), SV_PLDL1KEEP);
+            svst1_f32(all, out + i, svld1_gather_u32index_f32(all, table, svld1_u32(all, idx + i)));
+        }
+    }
+    for (; i < n; i += vl) {
+        svbool_t pg = svwhilelt_b32_u64(i, n);
+        svst1_f32(pg, out + i, svld1_gather_u32index_f32(pg, table, svld1_u32(pg, idx + i)));
+    }
+}
+
+// Embedding lookup: row i of out (dim floats) = row idx[i] of table.
+inline void gather_rows(const float* table, size_t dim, const uint32_t* idx, size_t n, float* out,
+                        size_t distance) {
+    const size_t vl = svcntw();
+    size_t lines = (dim * sizeof(float) + 63) / 64;
+    size_t ahead = distance ? std::max<size_t>(1, distance / std::max<size_t>(1, lines)) : 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (ahead && i + ahead < n) {
+            const char* p = (const char*)(table + (size_t)idx[i + ahead] * dim);
+            for (size_t b = 0; b < dim * sizeof(float); b += 64) __builtin_prefetch(p + b);
+            __builtin_prefetch(p + dim * sizeof(float) - 1);
+        }
+        const float* row = table + (size_t)idx[i] * dim;
+        for (size_t j = 0; j < dim; j += vl) {
+            svbool_t pg = svwhilelt_b32_u64(j, dim);
+            svst1_f32(pg, out + i * dim + j, svld1_f32(pg, row + j));
+        }
+    }
+}
+
+// Times gather over `table` (entries floats, ideally 4x the last-level cache
+// or more) for distances 0 to 128 and returns the shortest one within 3% of
+// the fastest, or 0 if prefetching gains less than 5%.
+inline size_t tune_prefetch_distance(const float* table, size_t entries) {
+    const size_t distances[] = {0, 4, 8, 16, 32, 64, 128};
+    const size_t count = sizeof(distances) / sizeof(distances[0]);
+    std::vector<uint32_t> idx((size_t)1 << 18);
+    std::vector<float> out(idx.size());
+    uint64_t x = 88172645463325252ull;
+    for (uint32_t& i : idx) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        i = (uint32_t)(x % entries);
+    }
+    double time[count];
+    double fastest = 0;
+    for (size_t c = 0; c < count; ++c) {
+        for (int trial = 0; trial < 3; ++trial) {
+            auto start = std::chrono::steady_clock::now();
+            gather(table, idx.data(), idx.size(), out.data(), distances[c]);
+            double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (trial == 0 || sec < time[c]) time[c] = sec;
+        }
+        if (c == 0 || time[c] < fastest) fastest = time[c];
+    }
+    size_t best = 0;
+    if (fastest * 1.05 <= time[0]) {
+        for (size_t c = count; c-- > 1;) {
+            if (time[c] <= fastest * 1.03) best = distances[c];
+        }
+    }
+    return best;
+}
+
+} // namespace sve
+} // namespace simd
+
+#endif // GATHER_SVE_H
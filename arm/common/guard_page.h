@@ -0,0 +1,39 @@
+#ifndef GUARD_PAGE_H
+#define GUARD_PAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Maps `pages` readable pages next to one PROT_NONE guard page: after them,
+// or before them with guard_before. Anything placed so that it ends at end()
+// (or starts at base) is right next to memory that faults on access, which
+// is exactly where a full-vector overread would crash. base is null if the
+// mapping failed.
+struct GuardedBuffer {
+    uint8_t* base;
+    size_t size; // readable bytes
+    size_t map_size;
+    uint8_t* map;
+
+    explicit GuardedBuffer(size_t pages, bool guard_before = false)
+        : base(nullptr), size(0), map_size(0), map(nullptr) {
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        map_size = (pages + 1) * page;
+        void* p = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return;
+        map = static_cast<uint8_t*>(p);
+        size = pages * page;
+        base = guard_before ? map + page : map;
+        mprotect(guard_before ? map : map + size, page, PROT_NONE);
+    }
+    ~GuardedBuffer() {
+        if (map) munmap(map, map_size);
+    }
+    GuardedBuffer(const GuardedBuffer&) = delete;
+    GuardedBuffer& operator=(const GuardedBuffer&) = delete;
+    uint8_t* end() const { return base + size; }
+};
+
+#endif // GUARD_PAGE_H
@@ -0,0 +1,214 @@
+#ifndef HASH_MAP_NEON_H
+#define HASH_MAP_NEON_H
+
+#include <arm_neon.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace simd {
+namespace neon {
+
+// Swiss-table style hash map from uint64_t keys to uint64_t values, like the
+// x86 hash_map.h with 16-byte groups. Each slot has a control byte, 0 when
+// empty or else the low byte of its key's hash (never 0); a probe loads the
+// 16 control bytes of a group with vld1q_u8 and compares them all with the
+// tag with vceqq_u8.
+//
+// NEON has no movemask. vshrn_n_u16(eq, 4) narrows the 0x00/0xFF bytes to
+// one nibble per byte, a 64-bit mask with 4 bits per slot; keeping the top
+// bit of each nibble leaves one bit per slot, 4 apart, to iterate with ctz.
+//
+// Batched calls hash 16 keys and prefetch their groups, then the first
+// matching slot of each, before probing any of them. The table grows at 7/8
+// full; keys are never erased.
+
+class HashMap {
+public:
+    explicit HashMap(size_t expected = 0) : ctrl_(nullptr), slots_(nullptr) {
+        size_t groups = 1;
+        while (max_size_of(groups * kGroup) < expected) groups *= 2;
+        allocate(groups);
+    }
+    ~HashMap() { std::free(ctrl_); }
+    HashMap(const HashMap&) = delete;
+    HashMap& operator=(const HashMap&) = delete;
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return (group_mask_ + 1) * kGroup; }
+
+    bool insert(uint64_t key, uint64_t value) { return insert(&key, &value, 1) != 0; }
+    bool find(uint64_t key, uint64_t* value) const {
+        uint8_t found;
+        return find(&key, 1, value, &found) != 0;
+    }
+
+    // Inserts the absent keys (once for keys repeated in the batch); returns
+    // how many were new, and inserted[i] says whether keys[i] was.
+    size_t insert(const uint64_t* keys, const uint64_t* values, size_t n, uint8_t* inserted = nullptr) {
+        return insert_impl(keys, values, n, false, inserted);
+    }
+    // map[keys[i]] += deltas[i], starting new keys at 0.
+    void add(const uint64_t* keys, const uint64_t* deltas, size_t n) { insert_impl(keys, deltas, n, true, nullptr); }
+
+    // found[i], and values[i] for the keys found; returns the number found.
+    size_t find(const uint64_t* keys, size_t n, uint64_t* values, uint8_t* found) const {
+        uint64_t h[kBatch];
+        size_t hits = 0;
+        for (size_t i0 = 0; i0 < n; i0 += kBatch) {
+            size_t m = n - i0 < kBatch ? n - i0 : kBatch;
+            prefetch(keys + i0, m, h);
+            for (size_t j = 0; j < m; ++j) {
+                size_t empty;
+                size_t s = find_slot(keys[i0 + j], h[j], empty);
+                bool hit = s != SIZE_MAX;
+                if (hit) values[i0 + j] = slots_[2 * s + 1];
+                found[i0 + j] = hit;
+                hits += hit;
+            }
+        }
+        return hits;
+    }
+
+    template <typename F>
+    void for_each(F f) const {
+        for (size_t s = 0, n = capacity(); s < n; ++s) {
+            if (ctrl_[s]) f(slots_[2 * s], slots_[2 * s + 1]);
+        }
+    }
+
+    void clear() {
+        std::memset(ctrl_, 0, capacity());
+        size_ = 0;
+    }
+
+private:
+    static const size_t kGroup = 16;
+    static const size_t kBatch = 16;
+
+    static size_t max_size_of(size_t slots) { return slots - slots / 8; }
+
+    static uint64_t hash(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+    static uint8_t tag_of(uint64_t h) { return (uint8_t)h ? (uint8_t)h : 1; }
+    size_t group_of(uint64_t h) const { return (size_t)(h >> 8) & group_mask_; }
+
+    // One bit per matching byte, at bit 4 * i + 3.
+    static uint64_t to_mask(uint8x16_t eq) {
+        uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ULL;
+    }
+    static uint64_t match(const uint8_t* ctrl, uint8_t tag) { return to_mask(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(tag))); }
+    static uint64_t match_empty(const uint8_t* ctrl) { return to_mask(vceqzq_u8(vld1q_u8(ctrl))); }
+    static size_t slot_in_group(uint64_t m) { return (size_t)__builtin_ctzll(m) >> 2; }
+
+    void allocate(size_t groups) {
+        size_t slots = groups * kGroup;
+        size_t ctrl_bytes = (slots + 63) / 64 * 64;
+        void* mem = nullptr;
+        if (posix_memalign(&mem, 64, ctrl_bytes + slots * 2 * sizeof(uint64_t)) != 0) throw std::bad_alloc();
+        ctrl_ = static_cast<uint8_t*>(mem);
+        slots_ = reinterpret_cast<uint64_t*>(ctrl_ + ctrl_bytes);
+        std::memset(ctrl_, 0, ctrl_bytes);
+        group_mask_ = groups - 1;
+        size_ = 0;
+        max_size_ = max_size_of(slots);
+    }
+
+    // The slot of key, or SIZE_MAX and the first empty slot of its probe
+    // sequence in `empty`. Groups are visited in triangular steps.
+    size_t find_slot(uint64_t key, uint64_t h, size_t& empty) const {
+        const uint8_t tag = tag_of(h);
+        size_t g = group_of(h);
+        for (size_t step = 1;; ++step) {
+            const size_t base = g * kGroup;
+            for (uint64_t m = match(ctrl_ + base, tag); m; m &= m - 1) {
+                size_t s = base + slot_in_group(m);
+                if (slots_[2 * s] == key) return s;
+            }
+            uint64_t e = match_empty(ctrl_ + base);
+            if (e) {
+                empty = base + slot_in_group(e);
+                return SIZE_MAX;
+            }
+            g = (g + step) & group_mask_;
+        }
+    }
+
+    void prefetch(const uint64_t* keys, size_t m, uint64_t* h) const {
+        for (size_t j = 0; j < m; ++j) {
+            h[j] = hash(keys[j]);
+            __builtin_prefetch(ctrl_ + group_of(h[j]) * kGroup);
+        }
+        for (size_t j = 0; j < m; ++j) {
+            const size_t base = group_of(h[j]) * kGroup;
+            uint64_t c = match(ctrl_ + base, tag_of(h[j]));
+            if (c) __builtin_prefetch(slots_ + 2 * (base + slot_in_group(c)));
+        }
+    }
+
+    void grow() {
+        std::vector<uint64_t> keys, values;
+        keys.reserve(size_);
+        values.reserve(size_);
+        for_each([&](uint64_t k, uint64_t v) {
+            keys.push_back(k);
+            values.push_back(v);
+        });
+        uint8_t* old = ctrl_;
+        allocate((group_mask_ + 1) * 2);
+        std::free(old);
+        insert_impl(keys.data(), values.data(), keys.size(), false, nullptr);
+    }
+
+    size_t insert_impl(const uint64_t* keys, const uint64_t* values, size_t n, bool add, uint8_t* inserted) {
+        uint64_t h[kBatch];
+        size_t added = 0;
+        for (size_t i0 = 0; i0 < n; i0 += kBatch) {
+            size_t m = n - i0 < kBatch ? n - i0 : kBatch;
+            prefetch(keys + i0, m, h);
+            for (size_t j = 0; j < m; ++j) {
+                const size_t i = i0 + j;
+                size_t empty = 0;
+                size_t s = find_slot(keys[i], h[j], empty);
+                if (s != SIZE_MAX) {
+                    if (add) slots_[2 * s + 1] += values[i];
+                    if (inserted) inserted[i] = 0;
+                    continue;
+                }
+                if (size_ == max_size_) {
+                    // Rehash and take the rest of the batch from here.
+                    grow();
+                    return added + insert_impl(keys + i, values + i, n - i, add, inserted ? inserted + i : nullptr);
+                }
+                ctrl_[empty] = tag_of(h[j]);
+                slots_[2 * empty] = keys[i];
+                slots_[2 * empty + 1] = values[i];
+                ++size_;
+                ++added;
+                if (inserted) inserted[i] = 1;
+            }
+        }
+        return added;
+    }
+
+    uint8_t* ctrl_;
+    uint64_t* slots_;
+    size_t group_mask_;
+    size_t size_;
+    size_t max_size_;
+};
+
+} // namespace neon
+} // namespace simd
+
+#endif // HASH_MAP_NEON_H
@@ -0,0 +1,116 @@
+#ifndef HISTOGRAM_SVE2_H
+#define HISTOGRAM_SVE2_H
+
+#include <arm_sve.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace simd {
+namespace sve2 {
+
+// Conflict-aware gather-add-scatter. A plain svst1_scatter loses updates when
+// two lanes share an index: both read the same old value and only one write
+// survives. svhistcnt (SVE2) counts, for every lane, the active lanes up to
+// and including it that hold the same index, which is exactly the number of
+// increments a histogram lane has seen so far.
+//
+// Every idx[i] must index a valid element of bins or dst. Counts and sums are
+// added to what the output already holds.
+
+// ++bins[idx[i]]. The forward svhistcnt gives the last lane of each index its
+// full count; the same count on the reversed vector marks which lane is the
+// last one, and only those lanes are gathered and scattered.
+inline void histogram_chunk(const uint32_t* idx, size_t n, uint32_t* bins) {
+    for (size_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32_u64(i, n);
+        svuint32_t v = svld1_u32(pg, idx + i);
+        svuint32_t upto = svhistcnt_u32_z(pg, v, v);
+        svuint32_t rv = svrev_u32(v);
+        svuint32_t from = svrev_u32(svhistcnt_u32_z(svrev_b32(pg), rv, rv));
+        svbool_t last = svcmpeq_n_u32(pg, from, 1);
+        svuint32_t old = svld1_gather_u32index_u32(last, bins, v);
+        svst1_scatter_u32index_u32(last, bins, v, svadd_u32_x(last, old, upto));
+    }
+}
+
+// dst[idx[i]] += values[i]. Sums cannot be read off a count, so each vector is
+// split into conflict-free rounds: lanes whose svhistcnt is 1 are the first
+// of their index among the lanes still to do, and are applied together. The
+// number of rounds is the largest multiplicity of an index in the vector.
+inline void scatter_add_chunk(const uint32_t* idx, const float* values, size_t n, float* dst) {
+    for (size_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32_u64(i, n);
+        svuint32_t v = svld1_u32(pg, idx + i);
+        svfloat32_t x = svld1_f32(pg, values + i);
+        svbool_t todo = pg;
+        do {
+            svbool_t first = svcmpeq_n_u32(todo, svhistcnt_u32_z(todo, v, v), 1);
+            svfloat32_t old = svld1_gather_u32index_f32(first, dst, v);
+            svst1_scatter_u32index_f32(first, dst, v, svadd_f32_x(first, old, x));
+            todo = svbic_b_z(pg, todo, first);
+        } while (svptest_any(pg, todo));
+    }
+}
+
+// Splits [0, n) into `threads` chunks. The calling thread runs chunk 0 on
+// `out` itself; every other chunk runs on a zeroed private copy, added into
+// `out` once all have finished.
+template <typename T, typename Run>
+void run_private(size_t n, T* out, size_t nout, unsigned threads, Run run) {
+    std::vector<std::vector<T>> priv(threads - 1, std::vector<T>(nout));
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) {
+        size_t begin = n * t / threads;
+        size_t end = n * (t + 1) / threads;
+        workers.emplace_back(run, begin, end - begin, priv[t - 1].data());
+    }
+    run(0, n / threads, out);
+    for (std::thread& w : workers) w.join();
+    for (const std::vector<T>& p : priv) {
+        for (size_t b = 0; b < nout; ++b) out[b] += p[b];
+    }
+}
+
+// Thread count for `threads` (0: one per hardware thread). Every extra thread
+// costs a private copy of nbins elements, so inputs with fewer than
+// max(64K, nbins) indices per thread use fewer threads.
+inline unsigned thread_count(unsigned threads, size_t n, size_t nbins) {
+    const size_t min_per_thread = 1 << 16;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    return (unsigned)std::min<size_t>(threads, std::max<size_t>(1, n / std::max(min_per_thread, nbins)));
+}
+
+inline void histogram(const uint32_t* idx, size_t n, uint32_t* bins, size_t nbins, unsigned threads = 0) {
+    threads = thread_count(threads, n, nbins);
+    if (threads <= 1) {
+        histogram_chunk(idx, n, bins);
+        return;
+    }
+    run_private(n, bins, nbins, threads, [idx](size_t begin, size_t count, uint32_t* out) {
+        histogram_chunk(idx + begin, count, out);
+    });
+}
+
+// Within one thread each slot receives its values in input order, as in a
+// scalar loop; with several threads the partial sums are added at the end, so
+// results can differ in the last bits.
+inline void scatter_add(const uint32_t* idx, const float* values, size_t n, float* dst, size_t ndst,
+                        unsigned threads = 0) {
+    threads = thread_count(threads, n, ndst);
+    if (threads <= 1) {
+        scatter_add_chunk(idx, values, n, dst);
+        return;
+    }
+    run_private(n, dst, ndst, threads, [idx, values](size_t begin, size_t count, float* out) {
+        scatter_add_chunk(idx + begin, values + begin, count, out);
+    });
+}
+
+} // namespace sve2
+} // namespace simd
+
+#endif // HISTOGRAM_SVE2_H
@@ -0,0 +1,111 @@
+#ifndef INTERLEAVE_NEON_H
+#define INTERLEAVE_NEON_H
+
+#include <arm_neon.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+namespace neon {
+
+// Conversion between interleaved records (aos[r * channels + c]) and planar
+// columns (planes[c][r]) built on the structure loads and stores vld2q..vld4q
+// and vst2q..vst4q, which de-interleave and re-interleave 2, 3 or 4 channels
+// in hardware. Other channel counts use the scalar loop, as do the records
+// left over after the last full vector.
+
+template <typename T> struct StructOps;
+
+#define SIMD_NEON_STRUCT_OPS(T, V, S)                                                      \
+    template <> struct StructOps<T> {                                                      \
+        static const size_t lanes = 16 / sizeof(T);                                        \
+        static V##x2_t load2(const T* p) { return vld2q_##S(p); }                          \
+        static V##x3_t load3(const T* p) { return vld3q_##S(p); }                          \
+        static V##x4_t load4(const T* p) { return vld4q_##S(p); }                          \
+        static void store2(T* p, V##x2_t v) { vst2q_##S(p, v); }                           \
+        static void store3(T* p, V##x3_t v) { vst3q_##S(p, v); }                           \
+        static void store4(T* p, V##x4_t v) { vst4q_##S(p, v); }                           \
+        static V##_t load(const T* p) { return vld1q_##S(p); }                             \
+        static void store(T* p, V##_t v) { vst1q_##S(p, v); }                             \
+    };
+
+SIMD_NEON_STRUCT_OPS(uint8_t, uint8x16, u8)
+SIMD_NEON_STRUCT_OPS(uint16_t, uint16x8, u16)
+SIMD_NEON_STRUCT_OPS(int32_t, int32x4, s32)
+SIMD_NEON_STRUCT_OPS(float, float32x4, f32)
+
+#undef SIMD_NEON_STRUCT_OPS
+
+// Interleaved -> planar: planes[c][r] = aos[r * channels + c].
+template <typename T>
+void deinterleave(const T* aos, size_t n, size_t channels, T* const* planes) {
+    typedef StructOps<T> Ops;
+    const size_t lanes = Ops::lanes;
+    size_t r = 0;
+    if (channels == 2) {
+        for (; r + lanes <= n; r += lanes) {
+            auto v = Ops::load2(aos + 2 * r);
+            Ops::store(planes[0] + r, v.val[0]);
+            Ops::store(planes[1] + r, v.val[1]);
+        }
+    } else if (channels == 3) {
+        for (; r + lanes <= n; r += lanes) {
+            auto v = Ops::load3(aos + 3 * r);
+            Ops::store(planes[0] + r, v.val[0]);
+            Ops::store(planes[1] + r, v.val[1]);
+            Ops::store(planes[2] + r, v.val[2]);
+        }
+    } else if (channels == 4) {
+        for (; r + lanes <= n; r += lanes) {
+            auto v = Ops::load4(aos + 4 * r);
+            Ops::store(planes[0] + r, v.val[0]);
+            Ops::store(planes[1] + r, v.val[1]);
+            Ops::store(planes[2] + r, v.val[2]);
+            Ops::store(planes[3] + r, v.val[3]);
+        }
+    }
+    for (; r < n; ++r) {
+        for (size_t c = 0; c < channels; ++c) planes[c][r] = aos[r * channels + c];
+    }
+}
+
+// Planar -> interleaved: aos[r * channels + c] = planes[c][r].
+template <typename T>
+void interleave(const T* const* planes, size_t n, size_t channels, T* aos) {
+    typedef StructOps<T> Ops;
+    const size_t lanes = Ops::lanes;
+    size_t r = 0;
+    if (channels == 2) {
+        for (; r + lanes <= n; r += lanes) {
+            decltype(Ops::load2(aos)) v;
+            v.val[0] = Ops::load(planes[0] + r);
+            v.val[1] = Ops::load(planes[1] + r);
+            Ops::store2(aos + 2 * r, v);
+        }
+    } else if (channels == 3) {
+        for (; r + lanes <= n; r += lanes) {
+            decltype(Ops::load3(aos)) v;
+            v.val[0] = Ops::load(planes[0] + r);
+            v.val[1] = Ops::load(planes[1] + r);
+            v.val[2] = Ops::load(planes[2] + r);
+            Ops::store3(aos + 3 * r, v);
+        }
+    } else if (channels == 4) {
+        for (; r + lanes <= n; r += lanes) {
+            decltype(Ops::load4(aos)) v;
+            v.val[0] = Ops::load(planes[0] + r);
+            v.val[1] = Ops::load(planes[1] + r);
+            v.val[2] = Ops::load(planes[2] + r);
+            v.val[3] = Ops::load(planes[3] + r);
+            Ops::store4(aos + 4 * r, v);
+        }
+    }
+    for (; r < n; ++r) {
+        for (size_t c = 0; c < channels; ++c) aos[r * channels + c] = planes[c][r];
+    }
+}
+
+} // namespace neon
+} // namespace simd
+
+#endif // INTERLEAVE_NEON_H
@@ -0,0 +1,84 @@
+#ifndef INTERLEAVE_SVE_H
+#define INTERLEAVE_SVE_H
+
+#include <arm_sve.h>
+#include <cstddef>
+#include <cstdint>
+#include "loop_sve.h"
+
+namespace simd {
+namespace sve {
+
+// Conversion between interleaved records (aos[r * channels + c]) and planar
+// columns (planes[c][r]) with the SVE structure loads and stores svld2..svld4
+// and svst2..svst4. The loop predicate from svwhilelt covers the last partial
+// vector, so 2, 3 and 4 channels need no scalar tail; other channel counts
+// use the scalar loop.
+
+// Interleaved -> planar, for uint8_t, uint16_t, int32_t and float.
+template <typename T>
+void deinterleave(const T* aos, size_t n, size_t channels, T* const* planes) {
+    typedef Lanes<sizeof(T)> L;
+    if (channels == 2) {
+        for (size_t r = 0; r < n; r += L::count()) {
+            svbool_t pg = L::whilelt(r, n);
+            auto v = svld2(pg, aos + 2 * r);
+            svst1(pg, planes[0] + r, svget2(v, 0));
+            svst1(pg, planes[1] + r, svget2(v, 1));
+        }
+    } else if (channels == 3) {
+        for (size_t r = 0; r < n; r += L::count()) {
+            svbool_t pg = L::whilelt(r, n);
+            auto v = svld3(pg, aos + 3 * r);
+            svst1(pg, planes[0] + r, svget3(v, 0));
+            svst1(pg, planes[1] + r, svget3(v, 1));
+            svst1(pg, planes[2] + r, svget3(v, 2));
+        }
+    } else if (channels == 4) {
+        for (size_t r = 0; r < n; r += L::count()) {
+            svbool_t pg = L::whilelt(r, n);
+            auto v = svld4(pg, aos + 4 * r);
+            svst1(pg, planes[0] + r, svget4(v, 0));
+            svst1(pg, planes[1] + r, svget4(v, 1));
+            svst1(pg, planes[2] + r, svget4(v, 2));
+            svst1(pg, planes[3] + r, svget4(v, 3));
+        }
+    } else {
+        for (size_t r = 0; r < n; ++r) {
+            for (size_t c = 0; c < channels; ++c) planes[c][r] = aos[r * channels + c];
+        }
+    }
+}
+
+// Planar -> interleaved.
+template <typename T>
+void interleave(const T* const* planes, size_t n, size_t channels, T* aos) {
+    typedef Lanes<sizeof(T)> L;
+    if (channels == 2) {
+        for (size_t r = 0; r < n; r += L::count()) {
+            svbool_t pg = L::whilelt(r, n);
+            svst2(pg, aos + 2 * r, svcreate2(svld1(pg, planes[0] + r), svld1(pg, planes[1] + r)));
+        }
+    } else if (channels == 3) {
+        for (size_t r = 0; r < n; r += L::count()) {
+            svbool_t pg = L::whilelt(r, n);
+            svst3(pg, aos + 3 * r, svcreate3(svld1(pg, planes[0] + r), svld1(pg, planes[1] + r),
+                                             svld1(pg, planes[2] + r)));
+        }
+    } else if (channels == 4) {
+        for (size_t r = 0; r < n; r += L::count()) {
+            svbool_t pg = L::whilelt(r, n);
+            svst4(pg, aos + 4 * r, svcreate4(svld1(pg, planes[0] + r), svld1(pg, planes[1] + r),
+                                             svld1(pg, planes[2] + r), svld1(pg, planes[3] + r)));
+        }
+    } else {
+        for (size_t r = 0; r < n; ++r) {
+            for (size_t c = 0; c < channels; ++c) aos[r * channels + c] = planes[c][r];
+        }
+    }
+}
+
+} // namespace sve
+} // namespace simd
+
+#endif // INTERLEAVE_SVE_H
@@ -0,0 +1,181 @@
+#ifndef JSON_INDEX_H
+#define JSON_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__ARM_FEATURE_AES)
+#include <arm_neon.h>
+#endif
+
+namespace simd {
+
+// Stage 1 of a JSON parser for NEON and SVE2, with the API of the x86
+// json_index.h: the positions of { } [ ] : , outside strings, of the
+// opening quote of every string and of the first byte of every other value.
+// Grammar is left to the parser and UTF-8 to utf8_validate (utf8.h).
+// Positions are 32-bit, so a document or stream is at most 4 GiB.
+//
+// Each ISA only turns a 64-byte block into five bit masks (JsonBlock); the
+// rest is the 64-bit integer code below, the same as the x86
+// json_internal.h. The vector loops come as a Codec:
+//
+//   struct Codec {
+//       // offset + the position of each structural byte of src[0, n), at
+//       // most n of them, to out; returns the count. state carries
+//       // strings, escapes and values from one call to the next.
+//       static size_t index(const char* src, size_t n, uint32_t offset, JsonIndexState* state, uint32_t* out);
+//   };
+//
+// json_index_neon.h and json_index_sve2.h provide one each, with a typedef
+// of JsonIndexer and a one-shot json_index.
+
+// What one piece of a document leaves for the next; zero at the start.
+struct JsonIndexState {
+    uint64_t in_string;     // all ones while inside a string
+    uint64_t escaped;       // 1 if the next byte follows an odd run of backslashes
+    uint64_t after_scalar;  // 1 if the last byte was part of a number, true, false or null
+    uint64_t error;         // nonzero once a string held a byte below 0x20
+};
+
+struct JsonBlock {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t space;
+    uint64_t op;
+    uint64_t control;   // bytes below 0x20
+};
+
+// Nibble lookups whose AND classifies a byte: 0x01 space, 0x02 tab, newline
+// and carriage return, 0x04 comma, 0x08 colon, 0x10 brackets, 0x20 braces.
+static const uint8_t kJsonLo[16] = {0x01, 0, 0, 0, 0, 0, 0, 0, 0, 0x02, 0x0A, 0x30, 0x04, 0x32, 0, 0};
+static const uint8_t kJsonHi[16] = {0x02, 0, 0x05, 0x08, 0, 0x10, 0, 0x20, 0, 0, 0, 0, 0, 0, 0, 0};
+const uint8_t kJsonSpaceClass = 0x03;
+const uint8_t kJsonOpClass = 0x3C;
+
+// One PMULL by all ones where the build has the AES extension (+aes, or
+// -mcpu= a core that has it), six shifts and XORs otherwise.
+inline uint64_t json_prefix_xor(uint64_t x) {
+#if defined(__ARM_FEATURE_AES)
+    return vgetq_lane_u64(vreinterpretq_u64_p128(vmull_p64((poly64_t)x, (poly64_t)~0ull)), 0);
+#else
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+#endif
+}
+
+// The structural bits of the first r bytes of a block (r in 1..64), whose
+// masks have no bits at or past r except in space and control. Updates the
+// state for the byte after them. A backslash run's first byte added to the
+// run carries to the byte after it, which is escaped when the run is odd:
+// when start and end differ in parity. The prefix XOR of the unescaped
+// quotes marks each string from its opening quote up to the closing one.
+inline uint64_t json_structurals(const JsonBlock& b, size_t r, JsonIndexState* s) {
+    const uint64_t even_bits = 0x5555555555555555ull;
+    uint64_t valid = r == 64 ? ~0ull : (1ull << r) - 1;
+    uint64_t space = b.space | ~valid;
+
+    uint64_t bs = b.backslash & ~s->escaped;
+    uint64_t starts = bs & ~(bs << 1);
+    uint64_t even_ends = (bs + (starts & even_bits)) & ~bs;
+    uint64_t odd_ends = bs + (starts & ~even_bits);
+    bool odd_out = odd_ends < bs;
+    odd_ends &= ~bs;
+    uint64_t escaped = (even_ends & ~even_bits) | (odd_ends & even_bits) | s->escaped;
+    s->escaped = r == 64 ? (uint64_t)odd_out : (escaped >> r) & 1;
+
+    uint64_t quote = b.quote & ~escaped;
+    uint64_t in_string = json_prefix_xor(quote) ^ s->in_string;
+    s->in_string = (uint64_t)((int64_t)in_string >> 63);
+    s->error |= b.control & valid & in_string;
+
+    uint64_t scalar = ~(b.op | space);
+    uint64_t unquoted = scalar & ~quote;
+    uint64_t follows = (unquoted << 1) | s->after_scalar;
+    s->after_scalar = (unquoted >> (r - 1)) & 1;
+    return (b.op | (scalar & ~follows)) & ~(in_string ^ quote);
+}
+
+// out[i] = pos + the index of the i-th set bit (rbit + clz); returns the count.
+inline size_t json_emit(uint64_t bits, uint32_t pos, uint32_t* out) {
+    size_t k = 0;
+    for (; bits; bits &= bits - 1) out[k++] = pos + (uint32_t)__builtin_ctzll(bits);
+    return k;
+}
+
+// The masks of bytes [p, p + r) a byte at a time.
+inline JsonBlock json_classify_scalar(const uint8_t* p, size_t r) {
+    JsonBlock b = {0, 0, 0, 0, 0};
+    for (size_t j = 0; j < r; ++j) {
+        uint8_t c = p[j];
+        uint8_t cls = kJsonLo[c & 0x0F] & kJsonHi[c >> 4];
+        b.quote |= (uint64_t)(c == '"') << j;
+        b.backslash |= (uint64_t)(c == '\\') << j;
+        b.space |= (uint64_t)((cls & kJsonSpaceClass) != 0) << j;
+        b.op |= (uint64_t)((cls & kJsonOpClass) != 0) << j;
+        b.control |= (uint64_t)(c < 0x20) << j;
+    }
+    return b;
+}
+
+// The reference the vector codecs are checked against.
+struct JsonScalarCodec {
+    static size_t index(const char* src, size_t n, uint32_t offset, JsonIndexState* state, uint32_t* out) {
+        const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+        size_t k = 0;
+        for (size_t i = 0; i < n; i += 64) {
+            size_t r = n - i < 64 ? n - i : 64;
+            k += json_emit(json_structurals(json_classify_scalar(s + i, r), r, state), offset + (uint32_t)i,
+                           out + k);
+        }
+        return k;
+    }
+};
+
+// Streaming form, for a document that arrives in pieces of any size. Only
+// the state crosses a cut, so the positions are those of one call on the
+// whole document, counted from the start of the stream.
+template <typename Codec>
+class JsonIndexer {
+public:
+    JsonIndexer() : offset_(0) { state_ = JsonIndexState{0, 0, 0, 0}; }
+
+    // Writes at most n positions and sets *written. Returns false once a
+    // string held a byte below 0x20; the positions are still written.
+    bool update(const char* src, size_t n, uint32_t* out, size_t* written) {
+        *written = Codec::index(src, n, offset_, &state_, out);
+        offset_ += (uint32_t)n;
+        return !state_.error;
+    }
+
+    // Whether the stream ended outside a string without an error. Resets
+    // the object for a new stream.
+    bool finish() {
+        bool ok = !state_.error && !state_.in_string;
+        state_ = JsonIndexState{0, 0, 0, 0};
+        offset_ = 0;
+        return ok;
+    }
+
+private:
+    JsonIndexState state_;
+    uint32_t offset_;
+};
+
+// One-shot form for a Codec: writes the positions, at most n, to out and
+// sets *count. False if a string is left open or holds a byte below 0x20.
+template <typename Codec>
+bool json_index_with(const char* src, size_t n, uint32_t* out, size_t* count) {
+    JsonIndexState state = {0, 0, 0, 0};
+    *count = Codec::index(src, n, 0, &state, out);
+    return !state.error && !state.in_string;
+}
+
+} // namespace simd
+
+#endif // JSON_INDEX_H
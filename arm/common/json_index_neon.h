@@ -0,0 +1,86 @@
+#ifndef JSON_INDEX_NEON_H
+#define JSON_INDEX_NEON_H
+
+#include <arm_neon.h>
+#include <cstddef>
+#include <cstdint>
+#include "json_index.h"
+#include "safe_load_neon.h"
+
+namespace simd {
+namespace neon {
+
+// JSON stage 1 with the classification of the x86 SSE4.1 kernel, four
+// 16-byte vectors per 64-byte block: vqtbl1q_u8 on the low and high nibble
+// of each byte gives whitespace and operators, vceqq_u8 the quotes and
+// backslashes, vcltq_u8 the control bytes. The last partial block is
+// loaded with load_tail_u8, so nothing is read past the end.
+//
+// NEON has no movemask. The 0xFF / 0x00 lanes are ANDed with their bit, as
+// in utf8_neon.h, and three rounds of vpaddq_u8 add each 8 lanes into one
+// byte: the 64 lanes of a block become one 64-bit mask. The positions are
+// then read off the mask bit by bit (rbit + clz).
+
+// Bit i % 8 of lane i of four vectors, side by side in a 64-bit mask.
+inline uint64_t json_mask(uint8x16_t a, uint8x16_t b, uint8x16_t c, uint8x16_t d) {
+    static const uint8_t kBits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t bits = vld1q_u8(kBits);
+    uint8x16_t ab = vpaddq_u8(vandq_u8(a, bits), vandq_u8(b, bits));
+    uint8x16_t cd = vpaddq_u8(vandq_u8(c, bits), vandq_u8(d, bits));
+    uint8x16_t abcd = vpaddq_u8(ab, cd);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(vpaddq_u8(abcd, abcd)), 0);
+}
+
+inline JsonBlock json_classify(const uint8x16_t (&v)[4]) {
+    const uint8x16_t lo = vld1q_u8(kJsonLo), hi = vld1q_u8(kJsonHi);
+    uint8x16_t quote[4], backslash[4], space[4], op[4], control[4];
+    for (int j = 0; j < 4; ++j) {
+        uint8x16_t cls = vandq_u8(vqtbl1q_u8(lo, vandq_u8(v[j], vdupq_n_u8(0x0F))), vqtbl1q_u8(hi, vshrq_n_u8(v[j], 4)));
+        quote[j] = vceqq_u8(v[j], vdupq_n_u8('"'));
+        backslash[j] = vceqq_u8(v[j], vdupq_n_u8('\\'));
+        space[j] = vtstq_u8(cls, vdupq_n_u8(kJsonSpaceClass));
+        op[j] = vtstq_u8(cls, vdupq_n_u8(kJsonOpClass));
+        control[j] = vcltq_u8(v[j], vdupq_n_u8(0x20));
+    }
+    JsonBlock b;
+    b.quote = json_mask(quote[0], quote[1], quote[2], quote[3]);
+    b.backslash = json_mask(backslash[0], backslash[1], backslash[2], backslash[3]);
+    b.space = json_mask(space[0], space[1], space[2], space[3]);
+    b.op = json_mask(op[0], op[1], op[2], op[3]);
+    b.control = json_mask(control[0], control[1], control[2], control[3]);
+    return b;
+}
+
+struct JsonCodec {
+    static size_t index(const char* src, size_t n, uint32_t offset, JsonIndexState* state, uint32_t* out) {
+        const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+        size_t i = 0, k = 0;
+        for (; i + 64 <= n; i += 64) {
+            uint8x16_t v[4] = {vld1q_u8(s + i), vld1q_u8(s + i + 16), vld1q_u8(s + i + 32), vld1q_u8(s + i + 48)};
+            k += json_emit(json_structurals(json_classify(v), 64, state), offset + (uint32_t)i, out + k);
+        }
+        if (i < n) {
+            size_t r = n - i;
+            uint8x16_t v[4];
+            for (size_t j = 0; j < 4; ++j) {
+                size_t m = r > 16 * j ? r - 16 * j : 0;
+                v[j] = m >= 16 ? vld1q_u8(s + i + 16 * j) : load_tail_u8(s + i + 16 * j, m);
+            }
+            k += json_emit(json_structurals(json_classify(v), r, state), offset + (uint32_t)i, out + k);
+        }
+        return k;
+    }
+};
+
+typedef simd::JsonIndexer<JsonCodec> JsonIndexer;
+
+// Writes the positions in src[0, n), at most n of them, to out and sets
+// *count; false if a string is left open or holds a byte below 0x20.
+inline bool json_index(const char* src, size_t n, uint32_t* out, size_t* count) {
+    return json_index_with<JsonCodec>(src, n, out, count);
+}
+
+} // namespace neon
+} // namespace simd
+
+#endif // JSON_INDEX_NEON_H
@@ -0,0 +1,98 @@
+#ifndef JSON_INDEX_SVE2_H
+#define JSON_INDEX_SVE2_H
+
+#include <arm_sve.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "json_index.h"
+
+namespace simd {
+namespace sve2 {
+
+// JSON stage 1 for any vector length. SVE2's svmatch_u8 tests every byte
+// against the 16 bytes of a set (one 128-bit segment, loaded with
+// svld1rq), so whitespace and operators take one instruction each with no
+// nibble tables; quotes, backslashes and control bytes are compares. Loads
+// run under svwhilelt, so the last partial block reads nothing past the end.
+//
+// SVE has no movemask either, and a predicate cannot be moved to a general
+// register. Each lane instead selects its bit weight 1 << (lane % 8), and a
+// multiply by 0x0101010101010101 adds the 8 bytes of each 64-bit element
+// into its top byte; svst1b_u64 stores those bytes side by side, which is
+// the bit mask of the vector. A block is 64 bytes, or a whole vector
+// rounded up to 64 bytes when the vector is longer, so its masks are one
+// 64-bit word per 64 bytes, each run through json_structurals in turn.
+//
+// The positions are read off the words bit by bit, like NEON. svcompact
+// could pack them as vpcompressd does on x86, but a 64-bit word needs
+// 64 / svcntw() rounds of it, 16 at the common 128-bit vector length, which
+// costs more than walking the one position per few bytes of typical JSON.
+
+const uint8_t kJsonOps[16] = {'{', '}', '[', ']', ':', ',', '{', '}', '[', ']', ':', ',', '{', '{', '{', '{'};
+const uint8_t kJsonSpaces[16] = {' ', '\t', '\n', '\r', ' ', '\t', '\n', '\r',
+                                 ' ', '\t', '\n', '\r', ' ', '\t', '\n', '\r'};
+
+// The lanes of p as bits, svcntb() / 8 bytes at dst.
+inline void json_store_bits(svbool_t p, svuint8_t weights, uint8_t* dst) {
+    const svbool_t all = svptrue_b64();
+    svuint64_t w = svreinterpret_u64_u8(svsel_u8(p, weights, svdup_n_u8(0)));
+    svst1b_u64(all, dst, svlsr_n_u64_x(all, svmul_n_u64_x(all, w, 0x0101010101010101ull), 56));
+}
+
+struct JsonCodec {
+    static size_t index(const char* src, size_t n, uint32_t offset, JsonIndexState* state, uint32_t* out) {
+        const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+        const svbool_t all = svptrue_b8();
+        const svuint8_t ops = svld1rq_u8(all, kJsonOps);
+        const svuint8_t spaces = svld1rq_u8(all, kJsonSpaces);
+        const svuint8_t weights = svlsl_u8_x(all, svdup_n_u8(1), svand_n_u8_x(all, svindex_u8(0, 1), 7));
+        const size_t vl = svcntb();
+        const size_t block = (vl + 63) / 64 * 64;
+        // 2048-bit vectors at most: a 256-byte block, and a store may start
+        // a vector's worth of bits before its end. Bits past the input are
+        // left over from the block before, and masked off below.
+        uint8_t bits[5][64] = {};
+        size_t k = 0;
+        for (size_t i = 0; i < n; i += block) {
+            size_t end = n - i < block ? n : i + block;
+            for (size_t j = 0; i + j < end; j += vl) {
+                svbool_t pg = svwhilelt_b8_u64(i + j, end);
+                svuint8_t v = svld1_u8(pg, s + i + j);
+                json_store_bits(svcmpeq_n_u8(pg, v, '"'), weights, bits[0] + j / 8);
+                json_store_bits(svcmpeq_n_u8(pg, v, '\\'), weights, bits[1] + j / 8);
+                json_store_bits(svmatch_u8(pg, v, spaces), weights, bits[2] + j / 8);
+                json_store_bits(svmatch_u8(pg, v, ops), weights, bits[3] + j / 8);
+                json_store_bits(svcmplt_n_u8(pg, v, 0x20), weights, bits[4] + j / 8);
+            }
+            for (size_t w = 0; i + 64 * w < end; ++w) {
+                size_t r = end - (i + 64 * w) < 64 ? end - (i + 64 * w) : 64;
+                JsonBlock b;
+                std::memcpy(&b.quote, bits[0] + 8 * w, 8);
+                std::memcpy(&b.backslash, bits[1] + 8 * w, 8);
+                std::memcpy(&b.space, bits[2] + 8 * w, 8);
+                std::memcpy(&b.op, bits[3] + 8 * w, 8);
+                std::memcpy(&b.control, bits[4] + 8 * w, 8);
+                uint64_t valid = r == 64 ? ~0ull : (1ull << r) - 1;
+                b.quote &= valid;
+                b.backslash &= valid;
+                b.op &= valid;
+                k += json_emit(json_structurals(b, r, state), offset + (uint32_t)(i + 64 * w), out + k);
+            }
+        }
+        return k;
+    }
+};
+
+typedef simd::JsonIndexer<JsonCodec> JsonIndexer;
+
+// Writes the positions in src[0, n), at most n of them, to out and sets
+// *count; false if a string is left open or holds a byte below 0x20.
+inline bool json_index(const char* src, size_t n, uint32_t* out, size_t* count) {
+    return json_index_with<JsonCodec>(src, n, out, count);
+}
+
+} // namespace sve2
+} // namespace simd
+
+#endif // JSON_INDEX_SVE2_H
@@ -0,0 +1,120 @@
+#ifndef LOOP_SVE_H
+#define LOOP_SVE_H
+
+#include <arm_sve.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+namespace sve {
+
+// Vector-length-agnostic loop drivers. The examples in sve/ size their
+// buffers to exactly one vector and use svptrue; real buffers have any length
+// and the vector length is only known at run time (128 to 2048 bits). These
+// drivers walk n elements Unroll vectors at a time under an all-true
+// predicate, then finish with svwhilelt predicates, so a kernel only says how
+// to load, compute and store one vector and never handles a tail itself.
+
+// Vector length, all-true predicate and loop predicate for each element size.
+template <size_t Size> struct Lanes;
+template <> struct Lanes<1> {
+    static uint64_t count() { return svcntb(); }
+    static svbool_t all() { return svptrue_b8(); }
+    static svbool_t whilelt(uint64_t i, uint64_t n) { return svwhilelt_b8_u64(i, n); }
+};
+template <> struct Lanes<2> {
+    static uint64_t count() { return svcnth(); }
+    static svbool_t all() { return svptrue_b16(); }
+    static svbool_t whilelt(uint64_t i, uint64_t n) { return svwhilelt_b16_u64(i, n); }
+};
+template <> struct Lanes<4> {
+    static uint64_t count() { return svcntw(); }
+    static svbool_t all() { return svptrue_b32(); }
+    static svbool_t whilelt(uint64_t i, uint64_t n) { return svwhilelt_b32_u64(i, n); }
+};
+template <> struct Lanes<8> {
+    static uint64_t count() { return svcntd(); }
+    static svbool_t all() { return svptrue_b64(); }
+    static svbool_t whilelt(uint64_t i, uint64_t n) { return svwhilelt_b64_u64(i, n); }
+};
+
+// Element-wise loop. Kernel provides:
+//
+//   typedef T element_type;                  // int8_t ... double; sets the predicate width
+//   V    load(svbool_t pg, size_t i);        // inputs of elements [i, i + VL)
+//   W    compute(svbool_t pg, V v);
+//   void store(svbool_t pg, size_t i, W w);
+//
+// V and W are SVE vector or tuple types (svcreate2 for two inputs). Inactive
+// lanes are never loaded or stored, so the kernel must use predicated memory
+// accesses and must not fault on them.
+//
+// Each unrolled iteration issues all loads first, then all computes, then all
+// stores: Unroll independent chains that the core can overlap.
+template <int Unroll, typename Kernel>
+void transform(size_t n, Kernel k) {
+    static_assert(Unroll >= 1 && Unroll <= 4, "Unroll must be 1 to 4");
+    typedef Lanes<sizeof(typename Kernel::element_type)> L;
+    const uint64_t vl = L::count();
+    const svbool_t all = L::all();
+
+    size_t i = 0;
+    for (; i + Unroll * vl <= n; i += Unroll * vl) {
+        auto v0 = k.load(all, i);
+        auto v1 = Unroll > 1 ? k.load(all, i + vl) : v0;
+        auto v2 = Unroll > 2 ? k.load(all, i + 2 * vl) : v0;
+        auto v3 = Unroll > 3 ? k.load(all, i + 3 * vl) : v0;
+        auto w0 = k.compute(all, v0);
+        auto w1 = Unroll > 1 ? k.compute(all, v1) : w0;
+        auto w2 = Unroll > 2 ? k.compute(all, v2) : w0;
+        auto w3 = Unroll > 3 ? k.compute(all, v3) : w0;
+        k.store(all, i, w0);
+        if (Unroll > 1) k.store(all, i + vl, w1);
+        if (Unroll > 2) k.store(all, i + 2 * vl, w2);
+        if (Unroll > 3) k.store(all, i + 3 * vl, w3);
+    }
+    // Fewer than Unroll vectors left: one vector per step, the last partial.
+    for (; i < n; i += vl) {
+        svbool_t pg = L::whilelt(i, n);
+        k.store(pg, i, k.compute(pg, k.load(pg, i)));
+    }
+}
+
+// Reduction. Kernel provides:
+//
+//   typedef T element_type;
+//   A    zero();                             // identity accumulator
+//   V    load(svbool_t pg, size_t i);
+//   A    accumulate(svbool_t pg, A acc, V v); // inactive lanes keep acc (_m forms)
+//   A    merge(A a, A b);
+//   R    finish(A acc);                      // horizontal reduction to a scalar
+//
+// Every unrolled vector has its own accumulator, which breaks the dependency
+// chain through the adds. The order of accumulation therefore depends on the
+// vector length and Unroll; floating-point results differ in the last bits.
+template <int Unroll, typename Kernel>
+auto reduce(size_t n, Kernel k) -> decltype(k.finish(k.zero())) {
+    static_assert(Unroll >= 1 && Unroll <= 4, "Unroll must be 1 to 4");
+    typedef Lanes<sizeof(typename Kernel::element_type)> L;
+    const uint64_t vl = L::count();
+    const svbool_t all = L::all();
+
+    auto a0 = k.zero(), a1 = k.zero(), a2 = k.zero(), a3 = k.zero();
+    size_t i = 0;
+    for (; i + Unroll * vl <= n; i += Unroll * vl) {
+        a0 = k.accumulate(all, a0, k.load(all, i));
+        if (Unroll > 1) a1 = k.accumulate(all, a1, k.load(all, i + vl));
+        if (Unroll > 2) a2 = k.accumulate(all, a2, k.load(all, i + 2 * vl));
+        if (Unroll > 3) a3 = k.accumulate(all, a3, k.load(all, i + 3 * vl));
+    }
+    for (; i < n; i += vl) {
+        svbool_t pg = L::whilelt(i, n);
+        a0 = k.accumulate(pg, a0, k.load(pg, i));
+    }
+    return k.finish(k.merge(k.merge(a0, a1), k.merge(a2, a3)));
+}
+
+} // namespace sve
+} // namespace simd
+
+#endif // LOOP_SVE_H
@@ -0,0 +1,185 @@
+#ifndef PARTITION_SVE_H
+#define PARTITION_SVE_H
+
+#include <arm_sve.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace simd {
+namespace sve {
+
+// Radix partitioning of 64-bit tuples with software write-combining, like the
+// x86 partition.h. A tuple has its key in the low 32 bits; its partition is
+// bits [shift, shift + bits) of the key (shift + bits <= 32). Each partition
+// owns a 64-byte buffer that mirrors the output line its next tuple goes to;
+// a full buffer is written out as one line with svstnt1, whose non-temporal
+// hint keeps the output from evicting the buffers. Partitions are computed
+// with svlsr/svand and narrowed by svst1w, 64 tuples ahead of the scatter.
+//
+// The first and last line of a partition can be shared with its neighbours,
+// so those are copied word by word instead.
+
+const unsigned kMaxRadixBits = 14;
+
+// Outputs smaller than this are stored normally: they fit in the caches.
+const size_t kStreamMinBytes = (size_t)8 << 20;
+
+// Scatters in[0, n) to out[cursor[p]++]; buffers holds 8 << bits words and
+// is 64-byte aligned.
+inline void partition_chunk(const uint64_t* in, size_t n, unsigned shift, unsigned bits, uint64_t* out,
+                            size_t* cursor, uint64_t* buffers, bool stream) {
+    const size_t line = 8, batch = 64;
+    const size_t fanout = (size_t)1 << bits;
+    const uint64_t mask = fanout - 1;
+    const size_t vl = svcntd();
+    const size_t a = ((uintptr_t)out / sizeof(uint64_t)) % line;
+    std::vector<size_t> start(cursor, cursor + fanout);
+
+    auto flush = [vl, line, stream](uint64_t* dst, const uint64_t* buf) {
+        for (size_t w = 0; w < line; w += vl) {
+            svbool_t pg = svwhilelt_b64_u64(w, line);
+            svuint64_t v = svld1_u64(pg, buf + w);
+            if (stream) svstnt1_u64(pg, dst + w, v);
+            else        svst1_u64(pg, dst + w, v);
+        }
+    };
+    auto put = [&](uint64_t t, size_t p) {
+        size_t pos = cursor[p];
+        cursor[p] = pos + 1;
+        size_t slot = (pos + a) % line;
+        uint64_t* buf = buffers + p * line;
+        buf[slot] = t;
+        if (slot == line - 1) {
+            if (pos + 1 >= start[p] + line) {
+                flush(out + pos + 1 - line, buf);
+            } else {
+                for (size_t j = start[p]; j <= pos; ++j) out[j] = buf[(j + a) % line];
+            }
+        }
+    };
+
+    uint32_t id[batch];
+    size_t i = 0;
+    for (; i + batch <= n; i += batch) {
+        for (size_t k = 0; k < batch; k += vl) {
+            svbool_t pg = svwhilelt_b64_u64(k, batch);
+            svuint64_t v = svand_n_u64_x(pg, svlsr_n_u64_x(pg, svld1_u64(pg, in + i + k), shift), mask);
+            svst1w_u64(pg, id + k, v);
+        }
+        for (size_t k = 0; k < batch; ++k) put(in[i + k], id[k]);
+    }
+    for (; i < n; ++i) put(in[i], ((uint32_t)in[i] >> shift) & mask);
+
+    for (size_t p = 0; p < fanout; ++p) {
+        size_t end = cursor[p];
+        size_t filled = (end + a) % line;
+        size_t begin = end - start[p] > filled ? end - filled : start[p];
+        for (size_t j = begin; j < end; ++j) out[j] = buffers[p * line + (j + a) % line];
+    }
+}
+
+// The 64-byte aligned buffers of one thread.
+struct LineBuffers {
+    uint64_t* p;
+    explicit LineBuffers(unsigned bits) : p(nullptr) {
+        void* mem = nullptr;
+        if (posix_memalign(&mem, 64, (size_t)64 << bits) != 0) throw std::bad_alloc();
+        p = static_cast<uint64_t*>(mem);
+    }
+    ~LineBuffers() { std::free(p); }
+    LineBuffers(const LineBuffers&) = delete;
+    LineBuffers& operator=(const LineBuffers&) = delete;
+};
+
+inline unsigned partition_threads(unsigned threads, size_t n) {
+    const size_t min_per_thread = 1 << 16;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    return (unsigned)std::min<size_t>(threads, std::max<size_t>(1, n / min_per_thread));
+}
+
+template <typename F>
+void run_threads(unsigned threads, F fn) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) workers.emplace_back(fn, t);
+    fn(0);
+    for (std::thread& w : workers) w.join();
+}
+
+inline void count_partitions(const uint64_t* in, size_t n, unsigned shift, unsigned bits, size_t* counts) {
+    const uint32_t mask = (uint32_t)(((size_t)1 << bits) - 1);
+    for (size_t i = 0; i < n; ++i) ++counts[((uint32_t)in[i] >> shift) & mask];
+}
+
+// One pass, threads (0: one per hardware thread) taking one chunk of the
+// input each. Partition p is out[offsets[p], offsets[p + 1]); offsets has
+// 2^bits + 1 entries.
+inline void radix_partition(const uint64_t* in, size_t n, unsigned bits, unsigned shift, uint64_t* out,
+                            size_t* offsets, unsigned threads = 0) {
+    threads = partition_threads(threads, n);
+    const size_t fanout = (size_t)1 << bits;
+    const bool stream = n * sizeof(uint64_t) >= kStreamMinBytes;
+    std::vector<std::vector<size_t> > cursor(threads, std::vector<size_t>(fanout));
+    run_threads(threads, [&](unsigned t) {
+        size_t begin = n * t / threads, end = n * (t + 1) / threads;
+        count_partitions(in + begin, end - begin, shift, bits, cursor[t].data());
+    });
+    size_t pos = 0;
+    for (size_t p = 0; p < fanout; ++p) {
+        offsets[p] = pos;
+        for (unsigned t = 0; t < threads; ++t) {
+            size_t c = cursor[t][p];
+            cursor[t][p] = pos;
+            pos += c;
+        }
+    }
+    offsets[fanout] = pos;
+    run_threads(threads, [&](unsigned t) {
+        size_t begin = n * t / threads, end = n * (t + 1) / threads;
+        LineBuffers buffers(bits);
+        partition_chunk(in + begin, end - begin, shift, bits, out, cursor[t].data(), buffers.p, stream);
+    });
+}
+
+// First by the high bits1 of bits [shift, shift + bits1 + bits2) into tmp,
+// then each first-pass partition by the low bits2 into out: the result of one
+// pass on bits1 + bits2 bits.
+inline void radix_partition_2pass(const uint64_t* in, size_t n, unsigned bits1, unsigned bits2, unsigned shift,
+                                  uint64_t* out, uint64_t* tmp, size_t* offsets, unsigned threads = 0) {
+    const size_t fanout1 = (size_t)1 << bits1, fanout2 = (size_t)1 << bits2;
+    const bool stream = n * sizeof(uint64_t) >= kStreamMinBytes;
+    threads = partition_threads(threads, n);
+    std::vector<size_t> first(fanout1 + 1);
+    radix_partition(in, n, bits1, shift + bits2, tmp, first.data(), threads);
+    auto bound = [&](unsigned t) {
+        if (t == threads) return fanout1;
+        return (size_t)(std::lower_bound(first.begin(), first.begin() + fanout1, n * t / threads) - first.begin());
+    };
+    run_threads(threads, [&](unsigned t) {
+        LineBuffers buffers(bits2);
+        std::vector<size_t> cursor(fanout2);
+        for (size_t q = bound(t); q < bound(t + 1); ++q) {
+            size_t len = first[q + 1] - first[q];
+            std::fill(cursor.begin(), cursor.end(), 0);
+            count_partitions(tmp + first[q], len, shift, bits2, cursor.data());
+            size_t pos = first[q];
+            for (size_t p = 0; p < fanout2; ++p) {
+                size_t c = cursor[p];
+                offsets[q * fanout2 + p] = cursor[p] = pos;
+                pos += c;
+            }
+            partition_chunk(tmp + first[q], len, shift, bits2, out, cursor.data(), buffers.p, stream);
+        }
+    });
+    offsets[fanout1 * fanout2] = n;
+}
+
+} // namespace sve
+} // namespace simd
+
+#endif // PARTITION_SVE_H
@@ -0,0 +1,51 @@
+#ifndef SAFE_LOAD_NEON_H
+#define SAFE_LOAD_NEON_H
+
+#include <arm_neon.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+namespace neon {
+
+// The last r < 16 bytes of a buffer as one vector, like the x86 safe_load.h,
+// so byte loops can finish without a scalar tail:
+//
+//   for (; i + 16 <= n; i += 16) f(vld1q_u8(src + i));
+//   if (i < n) f(load_tail_u8(src + i, n - i));   // bytes r.. are 0
+//
+// A read faults only on a page the buffer does not touch. When the 16 bytes
+// at p stay in p's page, vld1q_u8(p) is safe and the bytes past the end are
+// cleared. Otherwise the 16 bytes that end at p + r are loaded, all in p's
+// page, and vqtbl1q_u8 moves them down; table indices of 16 and above read
+// as 0. Pages are at least 4 KiB on every AArch64 kernel, so the test uses
+// 4 KiB. NEON has no masked load; SVE predicated loads need none of this.
+//
+// p may point one past the end of the buffer when r is 0.
+
+const size_t kSafeLoadPage = 4096;
+
+// Whether [p, p + bytes) lies in one 4 KiB page.
+inline bool within_page(const void* p, size_t bytes) {
+    return ((uintptr_t)p & (kSafeLoadPage - 1)) <= kSafeLoadPage - bytes;
+}
+
+// 16 bytes from kKeepWindow + 16 - r have exactly their first r bytes set;
+// 16 bytes from kShiftWindow + 16 - r move bytes 16 - r .. 15 to 0 .. r - 1.
+alignas(32) static const uint8_t kKeepWindow[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+alignas(32) static const uint8_t kShiftWindow[32] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+// Bytes [p, p + r) in the low r lanes, 0 above; r <= 16.
+inline uint8x16_t load_tail_u8(const uint8_t* p, size_t r) {
+    if (r == 0) return vdupq_n_u8(0);
+    if (within_page(p, 16)) return vandq_u8(vld1q_u8(p), vld1q_u8(kKeepWindow + 16 - r));
+    return vqtbl1q_u8(vld1q_u8(p + r - 16), vld1q_u8(kShiftWindow + 16 - r));
+}
+
+} // namespace neon
+} // namespace simd
+
+#endif // SAFE_LOAD_NEON_H
@@ -0,0 +1,311 @@
+#ifndef SIMD_VEC_H
+#define SIMD_VEC_H
+
+// simd::vec<T, N>: the ARM side of x86/common/simd_vec.h, with the same
+// interface, so a kernel written against native_vec<T> builds on both.
+//
+//   vec<float, 4>, vec<double, 2>, vec<int32_t, 4>    NEON (any AArch64)
+//   vec<T, BITS / 8 / sizeof(T)>                      SVE, with -msve-vector-bits=BITS
+//
+// SVE registers are sizeless (svfloat32_t has no sizeof), so they cannot be
+// class members; a vector-length agnostic vec<T, N> is impossible. Built with
+// -msve-vector-bits=BITS the compiler knows the length, and the fixed-length
+// types (arm_sve_vector_bits) can be members. Such a binary only runs on
+// hardware of exactly that length, so the VLA kernels in this directory keep
+// using the intrinsics directly; vec is for code that also targets x86 or
+// NEON from one source. With -msve-vector-bits=128 the SVE types replace the
+// NEON ones.
+//
+// As on x86, operations the hardware lacks are missing rather than emulated:
+//
+//   load_masked / store_masked / gather / scatter     SVE only
+//   stream                                            svstnt1 on SVE; NEON
+//                                                     has no intrinsic for
+//                                                     STNP, so a plain store
+//
+// Masks are predicates (svbool_t) on SVE and all-ones/all-zeros lanes on NEON.
+// ../check_vec_codegen.sh compares the vec kernels of neon_vec_example with
+// their raw-intrinsic twins.
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_SVE_BITS) && __ARM_FEATURE_SVE_BITS > 0
+#include <arm_sve.h>
+#define SIMD_VEC_SVE_BITS __ARM_FEATURE_SVE_BITS
+#else
+#define SIMD_VEC_SVE_BITS 0
+#endif
+
+namespace simd {
+
+// Internal linkage, so that units built with different -march flags each keep
+// their own code.
+namespace {
+
+namespace detail {
+
+alignas(64) constexpr uint32_t kVecWindow32[8] = {~0u, ~0u, ~0u, ~0u, 0, 0, 0, 0};
+alignas(64) constexpr uint64_t kVecWindow64[4] = {~0ull, ~0ull, 0, 0};
+
+template <typename T, int N> struct vec_ops;
+
+#if SIMD_VEC_SVE_BITS != 128
+
+template <> struct vec_ops<float, 4> {
+    typedef float32x4_t reg;
+    typedef uint32x4_t mask;
+    static reg zero() { return vdupq_n_f32(0.0f); }
+    static reg set1(float x) { return vdupq_n_f32(x); }
+    static reg load(const float* p) { return vld1q_f32(p); }
+    static reg loadu(const float* p) { return vld1q_f32(p); }
+    static void store(float* p, reg v) { vst1q_f32(p, v); }
+    static void storeu(float* p, reg v) { vst1q_f32(p, v); }
+    static void stream(float* p, reg v) { vst1q_f32(p, v); }
+    static reg add(reg a, reg b) { return vaddq_f32(a, b); }
+    static reg sub(reg a, reg b) { return vsubq_f32(a, b); }
+    static reg mul(reg a, reg b) { return vmulq_f32(a, b); }
+    static reg div(reg a, reg b) { return vdivq_f32(a, b); }
+    static reg min(reg a, reg b) { return vminq_f32(a, b); }
+    static reg max(reg a, reg b) { return vmaxq_f32(a, b); }
+    static reg fma(reg a, reg b, reg c) { return vfmaq_f32(c, a, b); }
+    static float reduce_add(reg v) { return vaddvq_f32(v); }
+    static mask lt(reg a, reg b) { return vcltq_f32(a, b); }
+    static mask eq(reg a, reg b) { return vceqq_f32(a, b); }
+    static reg select(mask m, reg a, reg b) { return vbslq_f32(m, a, b); }
+    static mask first_n(size_t n) { return vld1q_u32(kVecWindow32 + 4 - n); }
+};
+
+template <> struct vec_ops<double, 2> {
+    typedef float64x2_t reg;
+    typedef uint64x2_t mask;
+    static reg zero() { return vdupq_n_f64(0.0); }
+    static reg set1(double x) { return vdupq_n_f64(x); }
+    static reg load(const double* p) { return vld1q_f64(p); }
+    static reg loadu(const double* p) { return vld1q_f64(p); }
+    static void store(double* p, reg v) { vst1q_f64(p, v); }
+    static void storeu(double* p, reg v) { vst1q_f64(p, v); }
+    static void stream(double* p, reg v) { vst1q_f64(p, v); }
+    static reg add(reg a, reg b) { return vaddq_f64(a, b); }
+    static reg sub(reg a, reg b) { return vsubq_f64(a, b); }
+    static reg mul(reg a, reg b) { return vmulq_f64(a, b); }
+    static reg div(reg a, reg b) { return vdivq_f64(a, b); }
+    static reg min(reg a, reg b) { return vminq_f64(a, b); }
+    static reg max(reg a, reg b) { return vmaxq_f64(a, b); }
+    static reg fma(reg a, reg b, reg c) { return vfmaq_f64(c, a, b); }
+    static double reduce_add(reg v) { return vaddvq_f64(v); }
+    static mask lt(reg a, reg b) { return vcltq_f64(a, b); }
+    static mask eq(reg a, reg b) { return vceqq_f64(a, b); }
+    static reg select(mask m, reg a, reg b) { return vbslq_f64(m, a, b); }
+    static mask first_n(size_t n) { return vld1q_u64(kVecWindow64 + 2 - n); }
+};
+
+template <> struct vec_ops<int32_t, 4> {
+    typedef int32x4_t reg;
+    typedef uint32x4_t mask;
+    static reg zero() { return vdupq_n_s32(0); }
+    static reg set1(int32_t x) { return vdupq_n_s32(x); }
+    static reg load(const int32_t* p) { return vld1q_s32(p); }
+    static reg loadu(const int32_t* p) { return vld1q_s32(p); }
+    static void store(int32_t* p, reg v) { vst1q_s32(p, v); }
+    static void storeu(int32_t* p, reg v) { vst1q_s32(p, v); }
+    static void stream(int32_t* p, reg v) { vst1q_s32(p, v); }
+    static reg add(reg a, reg b) { return vaddq_s32(a, b); }
+    static reg sub(reg a, reg b) { return vsubq_s32(a, b); }
+    static reg mul(reg a, reg b) { return vmulq_s32(a, b); }
+    static reg min(reg a, reg b) { return vminq_s32(a, b); }
+    static reg max(reg a, reg b) { return vmaxq_s32(a, b); }
+    static reg fma(reg a, reg b, reg c) { return vmlaq_s32(c, a, b); }
+    static int32_t reduce_add(reg v) { return vaddvq_s32(v); }
+    static mask lt(reg a, reg b) { return vcltq_s32(a, b); }
+    static mask eq(reg a, reg b) { return vceqq_s32(a, b); }
+    static reg select(mask m, reg a, reg b) { return vbslq_s32(m, a, b); }
+    static mask first_n(size_t n) { return vld1q_u32(kVecWindow32 + 4 - n); }
+};
+
+#endif // SIMD_VEC_SVE_BITS != 128
+
+#if SIMD_VEC_SVE_BITS > 0
+
+typedef svfloat32_t sve_f32 __attribute__((arm_sve_vector_bits(SIMD_VEC_SVE_BITS)));
+typedef svfloat64_t sve_f64 __attribute__((arm_sve_vector_bits(SIMD_VEC_SVE_BITS)));
+typedef svint32_t sve_s32 __attribute__((arm_sve_vector_bits(SIMD_VEC_SVE_BITS)));
+typedef svint64_t sve_s64 __attribute__((arm_sve_vector_bits(SIMD_VEC_SVE_BITS)));
+typedef svbool_t sve_bool __attribute__((arm_sve_vector_bits(SIMD_VEC_SVE_BITS)));
+
+template <> struct vec_ops<float, SIMD_VEC_SVE_BITS / 32> {
+    typedef sve_f32 reg;
+    typedef sve_bool mask;
+    typedef sve_s32 index;
+    static svbool_t all() { return svptrue_b32(); }
+    static reg zero() { return svdup_n_f32(0.0f); }
+    static reg set1(float x) { return svdup_n_f32(x); }
+    static reg load(const float* p) { return svld1_f32(all(), p); }
+    static reg loadu(const float* p) { return svld1_f32(all(), p); }
+    static void store(float* p, reg v) { svst1_f32(all(), p, v); }
+    static void storeu(float* p, reg v) { svst1_f32(all(), p, v); }
+    static void stream(float* p, reg v) { svstnt1_f32(all(), p, v); }
+    static reg add(reg a, reg b) { return svadd_f32_x(all(), a, b); }
+    static reg sub(reg a, reg b) { return svsub_f32_x(all(), a, b); }
+    static reg mul(reg a, reg b) { return svmul_f32_x(all(), a, b); }
+    static reg div(reg a, reg b) { return svdiv_f32_x(all(), a, b); }
+    static reg min(reg a, reg b) { return svmin_f32_x(all(), a, b); }
+    static reg max(reg a, reg b) { return svmax_f32_x(all(), a, b); }
+    static reg fma(reg a, reg b, reg c) { return svmla_f32_x(all(), c, a, b); }
+    static float reduce_add(reg v) { return svaddv_f32(all(), v); }
+    static mask lt(reg a, reg b) { return svcmplt_f32(all(), a, b); }
+    static mask eq(reg a, reg b) { return svcmpeq_f32(all(), a, b); }
+    static reg select(mask m, reg a, reg b) { return svsel_f32(m, a, b); }
+    static mask first_n(size_t n) { return svwhilelt_b32_u64(0, n); }
+    static reg load_masked(mask m, const float* p) { return svld1_f32(m, p); }
+    static void store_masked(mask m, float* p, reg v) { svst1_f32(m, p, v); }
+    static reg gather(const float* p, index i) { return svld1_gather_s32index_f32(all(), p, i); }
+    static void scatter(float* p, index i, reg v) { svst1_scatter_s32index_f32(all(), p, i, v); }
+};
+
+template <> struct vec_ops<double, SIMD_VEC_SVE_BITS / 64> {
+    typedef sve_f64 reg;
+    typedef sve_bool mask;
+    typedef sve_s64 index;  // SVE has no 32-bit indices for 64-bit lanes
+    static svbool_t all() { return svptrue_b64(); }
+    static reg zero() { return svdup_n_f64(0.0); }
+    static reg set1(double x) { return svdup_n_f64(x); }
+    static reg load(const double* p) { return svld1_f64(all(), p); }
+    static reg loadu(const double* p) { return svld1_f64(all(), p); }
+    static void store(double* p, reg v) { svst1_f64(all(), p, v); }
+    static void storeu(double* p, reg v) { svst1_f64(all(), p, v); }
+    static void stream(double* p, reg v) { svstnt1_f64(all(), p, v); }
+    static reg add(reg a, reg b) { return svadd_f64_x(all(), a, b); }
+    static reg sub(reg a, reg b) { return svsub_f64_x(all(), a, b); }
+    static reg mul(reg a, reg b) { return svmul_f64_x(all(), a, b); }
+    static reg div(reg a, reg b) { return svdiv_f64_x(all(), a, b); }
+    static reg min(reg a, reg b) { return svmin_f64_x(all(), a, b); }
+    static reg max(reg a, reg b) { return svmax_f64_x(all(), a, b); }
+    static reg fma(reg a, reg b, reg c) { return svmla_f64_x(all(), c, a, b); }
+    static double reduce_add(reg v) { return svaddv_f64(all(), v); }
+    static mask lt(reg a, reg b) { return svcmplt_f64(all(), a, b); }
+    static mask eq(reg a, reg b) { return svcmpeq_f64(all(), a, b); }
+    static reg select(mask m, reg a, reg b) { return svsel_f64(m, a, b); }
+    static mask first_n(size_t n) { return svwhilelt_b64_u64(0, n); }
+    static reg load_masked(mask m, const double* p) { return svld1_f64(m, p); }
+    static void store_masked(mask m, double* p, reg v) { svst1_f64(m, p, v); }
+    static reg gather(const double* p, index i) { return svld1_gather_s64index_f64(all(), p, i); }
+    static void scatter(double* p, index i, reg v) { svst1_scatter_s64index_f64(all(), p, i, v); }
+};
+
+template <> struct vec_ops<int32_t, SIMD_VEC_SVE_BITS / 32> {
+    typedef sve_s32 reg;
+    typedef sve_bool mask;
+    typedef sve_s32 index;
+    static svbool_t all() { return svptrue_b32(); }
+    static reg zero() { return svdup_n_s32(0); }
+    static reg set1(int32_t x) { return svdup_n_s32(x); }
+    static reg load(const int32_t* p) { return svld1_s32(all(), p); }
+    static reg loadu(const int32_t* p) { return svld1_s32(all(), p); }
+    static void store(int32_t* p, reg v) { svst1_s32(all(), p, v); }
+    static void storeu(int32_t* p, reg v) { svst1_s32(all(), p, v); }
+    static void stream(int32_t* p, reg v) { svstnt1_s32(all(), p, v); }
+    static reg add(reg a, reg b) { return svadd_s32_x(all(), a, b); }
+    static reg sub(reg a, reg b) { return svsub_s32_x(all(), a, b); }
+    static reg mul(reg a, reg b) { return svmul_s32_x(all(), a, b); }
+    static reg min(reg a, reg b) { return svmin_s32_x(all(), a, b); }
+    static reg max(reg a, reg b) { return svmax_s32_x(all(), a, b); }
+    static reg fma(reg a, reg b, reg c) { return svmla_s32_x(all(), c, a, b); }
+    static int32_t reduce_add(reg v) { return (int32_t)svaddv_s32(all(), v); }
+    static mask lt(reg a, reg b) { return svcmplt_s32(all(), a, b); }
+    static mask eq(reg a, reg b) { return svcmpeq_s32(all(), a, b); }
+    static reg select(mask m, reg a, reg b) { return svsel_s32(m, a, b); }
+    static mask first_n(size_t n) { return svwhilelt_b32_u64(0, n); }
+    static reg load_masked(mask m, const int32_t* p) { return svld1_s32(m, p); }
+    static void store_masked(mask m, int32_t* p, reg v) { svst1_s32(m, p, v); }
+    static reg gather(const int32_t* p, index i) { return svld1_gather_s32index_s32(all(), p, i); }
+    static void scatter(int32_t* p, index i, reg v) { svst1_scatter_s32index_s32(all(), p, i, v); }
+};
+
+#endif // SIMD_VEC_SVE_BITS > 0
+
+} // namespace detail
+
+template <typename T, int N>
+struct vec {
+    typedef detail::vec_ops<T, N> ops;
+    typedef T value_type;
+    typedef typename ops::reg reg_type;
+    typedef typename ops::mask mask_type;
+    static constexpr int lanes = N;
+
+    reg_type r;
+
+    vec() = default;
+    vec(reg_type x) : r(x) {}
+    operator reg_type() const { return r; }
+
+    static vec zero() { return ops::zero(); }
+    static vec broadcast(T x) { return ops::set1(x); }
+    static vec load(const T* p) { return ops::load(p); }
+    static vec loadu(const T* p) { return ops::loadu(p); }
+    static mask_type first_n(size_t n) { return ops::first_n(n); }
+    // SVE only.
+    static vec load_masked(mask_type m, const T* p) { return ops::load_masked(m, p); }
+    template <typename I> static vec gather(const T* base, I idx) { return ops::gather(base, idx); }
+
+    void store(T* p) const { ops::store(p, r); }
+    void storeu(T* p) const { ops::storeu(p, r); }
+    void stream(T* p) const { ops::stream(p, r); }
+    // SVE only.
+    void store_masked(mask_type m, T* p) const { ops::store_masked(m, p, r); }
+    template <typename I> void scatter(T* base, I idx) const { ops::scatter(base, idx, r); }
+};
+
+template <typename T, int N> constexpr int vec<T, N>::lanes;
+
+template <typename T, int N> vec<T, N> operator+(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::add(a.r, b.r); }
+template <typename T, int N> vec<T, N> operator-(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::sub(a.r, b.r); }
+template <typename T, int N> vec<T, N> operator*(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::mul(a.r, b.r); }
+template <typename T, int N> vec<T, N> operator/(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::div(a.r, b.r); }
+template <typename T, int N> vec<T, N>& operator+=(vec<T, N>& a, vec<T, N> b) { return a = a + b; }
+template <typename T, int N> vec<T, N>& operator-=(vec<T, N>& a, vec<T, N> b) { return a = a - b; }
+template <typename T, int N> vec<T, N>& operator*=(vec<T, N>& a, vec<T, N> b) { return a = a * b; }
+
+// a * b + c with one rounding (integer: multiply-accumulate).
+template <typename T, int N> vec<T, N> fma(vec<T, N> a, vec<T, N> b, vec<T, N> c) { return vec<T, N>::ops::fma(a.r, b.r, c.r); }
+template <typename T, int N> vec<T, N> min(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::min(a.r, b.r); }
+template <typename T, int N> vec<T, N> max(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::max(a.r, b.r); }
+template <typename T, int N> T reduce_add(vec<T, N> v) { return vec<T, N>::ops::reduce_add(v.r); }
+
+template <typename T, int N> typename vec<T, N>::mask_type operator<(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::lt(a.r, b.r); }
+template <typename T, int N> typename vec<T, N>::mask_type operator>(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::lt(b.r, a.r); }
+template <typename T, int N> typename vec<T, N>::mask_type operator==(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::eq(a.r, b.r); }
+template <typename T, int N> vec<T, N> select(typename vec<T, N>::mask_type m, vec<T, N> a, vec<T, N> b) {
+    return vec<T, N>::ops::select(m, a.r, b.r);
+}
+
+// Same output as the print_m* helpers of x86/common/simd_utils.h.
+template <typename T, int N> void print(vec<T, N> v) {
+    T val[N];
+    v.storeu(val);
+    std::cout << "Values: ";
+    for (int i = 0; i < N; ++i) std::cout << +val[i] << " ";
+    std::cout << std::endl;
+}
+
+#if SIMD_VEC_SVE_BITS > 0
+#define SIMD_VEC_NATIVE_BYTES (SIMD_VEC_SVE_BITS / 8)
+#define SIMD_VEC_HAS_MASKED 1
+#define SIMD_VEC_HAS_GATHER 1
+#define SIMD_VEC_HAS_SCATTER 1
+#else
+#define SIMD_VEC_NATIVE_BYTES 16
+#define SIMD_VEC_HAS_MASKED 0
+#define SIMD_VEC_HAS_GATHER 0
+#define SIMD_VEC_HAS_SCATTER 0
+#endif
+
+template <typename T> using native_vec = vec<T, (int)(SIMD_VEC_NATIVE_BYTES / sizeof(T))>;
+
+} // namespace
+
+} // namespace simd
+
+#endif // SIMD_VEC_H
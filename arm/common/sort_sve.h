@@ -0,0 +1,368 @@
+#ifndef SORT_SVE_H
+#define SORT_SVE_H
+
+#include <arm_sve.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace simd {
+namespace sve {
+
+// Vector-length-agnostic sort of 32- and 64-bit keys with optional payloads,
+// the same algorithm as the x86 sort.h: blocks of four vectors are sorted
+// with a bitonic network, then runs are merged one vector at a time (the
+// vector of the largest keys so far is held; the next one comes from the run
+// with the smaller head), first inside blocks that stay in L2.
+//
+// A bitonic network needs a power-of-two lane count, and an SVE vector may
+// hold any multiple of 128 bits; the network uses the largest power of two
+// L <= VL lanes, under the predicate svwhilelt(0, L). Everything the
+// fixed-width kernels take from constants is computed from svindex instead:
+//
+//   partner of lane i at step j     svtbl(v, i ^ j)
+//   lanes that keep the max         (i & j) != 0  xor  (i & k) != 0, as a
+//                                   predicate for svsel
+//   reversal                        svtbl(v, L - 1 - i)
+//
+// With payloads, the lanes that take their partner's key are selected from
+// two compares with svsel_b, and both vectors are moved with svsel.
+//
+// Not stable. uint32_t and float keys are mapped to int32_t order in place
+// and back, as on x86.
+
+template <typename K> struct SortTraits;
+template <> struct SortTraits<int32_t> {
+    typedef uint32_t Payload;
+    typedef svint32_t Vec;
+    typedef svuint32_t PayloadVec;
+    typedef svuint32_t Index;
+    static size_t count() { return svcntw(); }
+    static svbool_t whilelt(uint64_t i, uint64_t n) { return svwhilelt_b32_u64(i, n); }
+    static Index iota() { return svindex_u32(0, 1); }
+    static Index flip(svbool_t pg, Index i, size_t j) { return sveor_n_u32_x(pg, i, (uint32_t)j); }
+    static Index from_top(svbool_t pg, Index i, size_t top) { return svsubr_n_u32_x(pg, i, (uint32_t)top); }
+    static svbool_t has_bit(svbool_t pg, Index i, size_t j) {
+        return svcmpne_n_u32(pg, svand_n_u32_x(pg, i, (uint32_t)j), 0);
+    }
+    static PayloadVec zero_payload() { return svdup_n_u32(0); }
+};
+template <> struct SortTraits<int64_t> {
+    typedef uint64_t Payload;
+    typedef svint64_t Vec;
+    typedef svuint64_t PayloadVec;
+    typedef svuint64_t Index;
+    static size_t count() { return svcntd(); }
+    static svbool_t whilelt(uint64_t i, uint64_t n) { return svwhilelt_b64_u64(i, n); }
+    static Index iota() { return svindex_u64(0, 1); }
+    static Index flip(svbool_t pg, Index i, size_t j) { return sveor_n_u64_x(pg, i, (uint64_t)j); }
+    static Index from_top(svbool_t pg, Index i, size_t top) { return svsubr_n_u64_x(pg, i, (uint64_t)top); }
+    static svbool_t has_bit(svbool_t pg, Index i, size_t j) {
+        return svcmpne_n_u64(pg, svand_n_u64_x(pg, i, (uint64_t)j), 0);
+    }
+    static PayloadVec zero_payload() { return svdup_n_u64(0); }
+};
+
+// Lanes of the network: at most 2048 / 32.
+const size_t kMaxSortLanes = 64;
+const size_t kSortBlock = (size_t)1 << 14;
+
+template <typename K, bool kPairs>
+struct Sorter {
+    typedef SortTraits<K> T;
+    typedef typename T::Payload P;
+    typedef typename T::Vec V;
+    typedef typename T::PayloadVec PV;
+    typedef typename T::Index I;
+
+    // Largest power of two that fits the vector.
+    static size_t lanes() {
+        size_t l = 1;
+        while (l * 2 <= T::count()) l *= 2;
+        return l;
+    }
+
+    // Compare-exchange of lane i with lane i ^ j, ascending where
+    // (i & kk) == 0.
+    static void step(svbool_t pg, V& k, PV& p, size_t j, size_t kk) {
+        I i = T::iota();
+        I idx = T::flip(pg, i, j);
+        svbool_t up = sveor_b_z(pg, T::has_bit(pg, i, j), T::has_bit(pg, i, kk));
+        V kp = svtbl(k, idx);
+        if (kPairs) {
+            svbool_t take = svsel_b(up, svcmpgt(pg, kp, k), svcmpgt(pg, k, kp));
+            p = svsel(take, svtbl(p, idx), p);
+            k = svsel(take, kp, k);
+        } else {
+            k = svsel(up, svmax_x(pg, k, kp), svmin_x(pg, k, kp));
+        }
+    }
+
+    static void sort_vec(svbool_t pg, size_t l, V& k, PV& p) {
+        for (size_t kk = 2; kk <= l; kk *= 2) {
+            for (size_t j = kk / 2; j > 0; j /= 2) step(pg, k, p, j, kk);
+        }
+    }
+
+    static void merge_vec(svbool_t pg, size_t l, V& k, PV& p) {
+        for (size_t j = l / 2; j > 0; j /= 2) step(pg, k, p, j, l);
+    }
+
+    static void cmpx(svbool_t pg, V& a, PV& pa, V& b, PV& pb) {
+        if (kPairs) {
+            svbool_t m = svcmpgt(pg, a, b);
+            V lo = svsel(m, b, a);
+            PV plo = svsel(m, pb, pa);
+            b = svsel(m, a, b);
+            pb = svsel(m, pa, pb);
+            a = lo;
+            pa = plo;
+        } else {
+            V lo = svmin_x(pg, a, b);
+            b = svmax_x(pg, a, b);
+            a = lo;
+        }
+    }
+
+    static void reverse(svbool_t pg, size_t l, V& k, PV& p) {
+        I idx = T::from_top(pg, T::iota(), l - 1);
+        k = svtbl(k, idx);
+        if (kPairs) p = svtbl(p, idx);
+    }
+
+    static void merge2(svbool_t pg, size_t l, V& a, PV& pa, V& b, PV& pb) {
+        reverse(pg, l, b, pb);
+        cmpx(pg, a, pa, b, pb);
+        merge_vec(pg, l, a, pa);
+        merge_vec(pg, l, b, pb);
+    }
+
+    // Sorts 4l keys in registers.
+    static void sort_block(svbool_t pg, size_t l, K* k, P* p) {
+        V a = svld1(pg, k), b = svld1(pg, k + l), c = svld1(pg, k + 2 * l), d = svld1(pg, k + 3 * l);
+        PV pa = T::zero_payload(), pb = pa, pc = pa, pd = pa;
+        if (kPairs) {
+            pa = svld1(pg, p);
+            pb = svld1(pg, p + l);
+            pc = svld1(pg, p + 2 * l);
+            pd = svld1(pg, p + 3 * l);
+        }
+        sort_vec(pg, l, a, pa);
+        sort_vec(pg, l, b, pb);
+        sort_vec(pg, l, c, pc);
+        sort_vec(pg, l, d, pd);
+        merge2(pg, l, a, pa, b, pb);
+        merge2(pg, l, c, pc, d, pd);
+        reverse(pg, l, c, pc);
+        reverse(pg, l, d, pd);
+        cmpx(pg, a, pa, d, pd);
+        cmpx(pg, b, pb, c, pc);
+        cmpx(pg, a, pa, b, pb);
+        cmpx(pg, d, pd, c, pc);
+        merge_vec(pg, l, a, pa);
+        merge_vec(pg, l, b, pb);
+        merge_vec(pg, l, d, pd);
+        merge_vec(pg, l, c, pc);
+        svst1(pg, k, a);
+        svst1(pg, k + l, b);
+        svst1(pg, k + 2 * l, d);
+        svst1(pg, k + 3 * l, c);
+        if (kPairs) {
+            svst1(pg, p, pa);
+            svst1(pg, p + l, pb);
+            svst1(pg, p + 2 * l, pd);
+            svst1(pg, p + 3 * l, pc);
+        }
+    }
+
+    static P* at(P* p, size_t i) { return kPairs ? p + i : p; }
+    static const P* at(const P* p, size_t i) { return kPairs ? p + i : p; }
+
+    static void insertion_sort(K* k, P* p, size_t n) {
+        for (size_t i = 1; i < n; ++i) {
+            K key = k[i];
+            P pay = kPairs ? p[i] : P();
+            size_t j = i;
+            for (; j > 0 && k[j - 1] > key; --j) {
+                k[j] = k[j - 1];
+                if (kPairs) p[j] = p[j - 1];
+            }
+            k[j] = key;
+            if (kPairs) p[j] = pay;
+        }
+    }
+
+    static void merge_scalar(const K* a, const P* pa, size_t na, const K* b, const P* pb, size_t nb, K* out,
+                             P* po) {
+        size_t i = 0, j = 0, o = 0;
+        while (i < na && j < nb) {
+            bool from_b = b[j] < a[i];
+            out[o] = from_b ? b[j] : a[i];
+            if (kPairs) po[o] = from_b ? pb[j] : pa[i];
+            ++o;
+            j += from_b;
+            i += !from_b;
+        }
+        std::memcpy(out + o, a + i, (na - i) * sizeof(K));
+        std::memcpy(out + o + na - i, b + j, (nb - j) * sizeof(K));
+        if (kPairs) {
+            std::memcpy(po + o, pa + i, (na - i) * sizeof(P));
+            std::memcpy(po + o + na - i, pb + j, (nb - j) * sizeof(P));
+        }
+    }
+
+    static void merge_runs(svbool_t pg, size_t l, const K* a, const P* pa, size_t na, const K* b, const P* pb,
+                           size_t nb, K* out, P* po) {
+        if (na < l || nb < l) {
+            merge_scalar(a, pa, na, b, pb, nb, out, po);
+            return;
+        }
+        V lo = svld1(pg, a), hi = svld1(pg, b);
+        PV plo = T::zero_payload(), phi = plo;
+        if (kPairs) {
+            plo = svld1(pg, pa);
+            phi = svld1(pg, pb);
+        }
+        a += l;
+        b += l;
+        pa = at(pa, l);
+        pb = at(pb, l);
+        na -= l;
+        nb -= l;
+        for (;;) {
+            merge2(pg, l, lo, plo, hi, phi);
+            svst1(pg, out, lo);
+            if (kPairs) svst1(pg, po, plo);
+            out += l;
+            po = at(po, l);
+            if (na < l || nb < l) break;
+            bool from_a = *a <= *b;
+            lo = svld1(pg, from_a ? a : b);
+            if (kPairs) plo = svld1(pg, from_a ? pa : pb);
+            size_t adv_a = from_a ? l : 0, adv_b = l - adv_a;
+            a += adv_a;
+            na -= adv_a;
+            pa = at(pa, adv_a);
+            b += adv_b;
+            nb -= adv_b;
+            pb = at(pb, adv_b);
+        }
+        // hi and the short tail first, then the result with the long tail.
+        K held[2 * kMaxSortLanes], merged[2 * kMaxSortLanes];
+        P pheld[2 * kMaxSortLanes], pmerged[2 * kMaxSortLanes];
+        svst1(pg, held, hi);
+        if (kPairs) svst1(pg, pheld, phi);
+        if (na < l) {
+            merge_scalar(held, pheld, l, a, pa, na, merged, pmerged);
+            merge_scalar(merged, pmerged, l + na, b, pb, nb, out, po);
+        } else {
+            merge_scalar(held, pheld, l, b, pb, nb, merged, pmerged);
+            merge_scalar(merged, pmerged, l + nb, a, pa, na, out, po);
+        }
+    }
+
+    static void merge_pass(svbool_t pg, size_t l, const K* src, const P* ps, K* dst, P* pd, size_t n, size_t run) {
+        for (size_t i = 0; i < n; i += 2 * run) {
+            size_t na = run < n - i ? run : n - i;
+            size_t nb = run < n - i - na ? run : n - i - na;
+            merge_runs(pg, l, src + i, at(ps, i), na, src + i + na, at(ps, i + na), nb, dst + i, at(pd, i));
+        }
+    }
+
+    static void swap(K*& a, K*& b, P*& pa, P*& pb) {
+        K* t = a;
+        a = b;
+        b = t;
+        P* pt = pa;
+        pa = pb;
+        pb = pt;
+    }
+
+    static void sort(K* keys, P* values, size_t n, K* key_tmp, P* value_tmp) {
+        const size_t l = lanes();
+        const svbool_t pg = T::whilelt(0, l);
+        const size_t block = 4 * l;
+        size_t full = n / block * block;
+        for (size_t i = 0; i < full; i += block) sort_block(pg, l, keys + i, at(values, i));
+        insertion_sort(keys + full, at(values, full), n - full);
+        if (n <= block) return;
+
+        K *src = keys, *dst = key_tmp;
+        P *ps = values, *pd = value_tmp;
+        size_t run = block;
+        if (n > kSortBlock) {
+            for (size_t b = 0; b < n; b += kSortBlock) {
+                size_t m = kSortBlock < n - b ? kSortBlock : n - b;
+                K *s = src + b, *d = dst + b;
+                P *s_p = at(ps, b), *d_p = at(pd, b);
+                for (size_t r = run; r < kSortBlock; r *= 2) {
+                    merge_pass(pg, l, s, s_p, d, d_p, m, r);
+                    swap(s, d, s_p, d_p);
+                }
+            }
+            for (; run < kSortBlock; run *= 2) swap(src, dst, ps, pd);
+        }
+        for (; run < n; run *= 2) {
+            merge_pass(pg, l, src, ps, dst, pd, n, run);
+            swap(src, dst, ps, pd);
+        }
+        if (src != keys) {
+            std::memcpy(keys, src, n * sizeof(K));
+            if (kPairs) std::memcpy(values, ps, n * sizeof(P));
+        }
+    }
+};
+
+template <typename K>
+inline void sort_keys(K* keys, typename SortTraits<K>::Payload* values, size_t n) {
+    typedef typename SortTraits<K>::Payload P;
+    if (n < 2) return;
+    std::vector<K> key_tmp(n);
+    if (values) {
+        std::vector<P> value_tmp(n);
+        Sorter<K, true>::sort(keys, values, n, key_tmp.data(), value_tmp.data());
+    } else {
+        Sorter<K, false>::sort(keys, values, n, key_tmp.data(), nullptr);
+    }
+}
+
+// Order-preserving maps of uint32_t and float keys onto int32_t; each is
+// its own inverse.
+inline void flip_sign(uint32_t* keys, size_t n) {
+    for (size_t i = 0; i < n; ++i) keys[i] ^= 0x80000000u;
+}
+
+inline void flip_negative(float* keys, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        int32_t b;
+        std::memcpy(&b, &keys[i], sizeof(b));
+        b ^= (int32_t)((uint32_t)(b >> 31) >> 1);
+        std::memcpy(&keys[i], &b, sizeof(b));
+    }
+}
+
+inline void sort_pairs(int32_t* keys, uint32_t* values, size_t n) { sort_keys(keys, values, n); }
+inline void sort_pairs(int64_t* keys, uint64_t* values, size_t n) { sort_keys(keys, values, n); }
+
+inline void sort_pairs(uint32_t* keys, uint32_t* values, size_t n) {
+    flip_sign(keys, n);
+    sort_keys(reinterpret_cast<int32_t*>(keys), values, n);
+    flip_sign(keys, n);
+}
+
+inline void sort_pairs(float* keys, uint32_t* values, size_t n) {
+    flip_negative(keys, n);
+    sort_keys(reinterpret_cast<int32_t*>(keys), values, n);
+    flip_negative(keys, n);
+}
+
+inline void sort(int32_t* keys, size_t n) { sort_pairs(keys, nullptr, n); }
+inline void sort(uint32_t* keys, size_t n) { sort_pairs(keys, nullptr, n); }
+inline void sort(float* keys, size_t n) { sort_pairs(keys, nullptr, n); }
+inline void sort(int64_t* keys, size_t n) { sort_pairs(keys, nullptr, n); }
+
+} // namespace sve
+} // namespace simd
+
+#endif // SORT_SVE_H
@@ -0,0 +1,97 @@
+#ifndef SPMV_SVE_H
+#define SPMV_SVE_H
+
+#include <arm_sve.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace simd {
+
+// Sparse matrix in compressed sparse row (CSR) form, laid out like the x86
+// simd::CsrMatrix (x86/kernels/spmv.h). Row r holds values[k] at column
+// col_idx[k] for k in [row_ptr[r], row_ptr[r + 1]). Column indices are 32-bit
+// so that one gather covers a full vector of float lanes.
+struct CsrMatrix {
+    size_t rows;
+    size_t cols;
+    const int64_t* row_ptr;  // rows + 1 entries, row_ptr[0] == 0
+    const int32_t* col_idx;  // nnz entries, each in [0, cols)
+    const float* values;     // nnz entries
+};
+
+namespace sve {
+
+// Each row is a dot product of its values with x gathered at its column
+// indices (svld1_gather_s32index_f32). Rows are walked two vectors at a time
+// under svptrue; the rest of the row, including rows shorter than one vector,
+// runs under svwhilelt predicates, so inactive lanes are neither loaded nor
+// gathered and there is no scalar tail.
+inline float row_dot(const int32_t* col, const float* val, int64_t len, const float* x) {
+    const int64_t vl = (int64_t)svcntw();
+    const svbool_t all = svptrue_b32();
+    svfloat32_t acc0 = svdup_n_f32(0.0f);
+    svfloat32_t acc1 = svdup_n_f32(0.0f);
+    int64_t k = 0;
+    for (; k + 2 * vl <= len; k += 2 * vl) {
+        svint32_t i0 = svld1_s32(all, col + k);
+        svint32_t i1 = svld1_s32(all, col + k + vl);
+        acc0 = svmla_f32_x(all, acc0, svld1_f32(all, val + k), svld1_gather_s32index_f32(all, x, i0));
+        acc1 = svmla_f32_x(all, acc1, svld1_f32(all, val + k + vl), svld1_gather_s32index_f32(all, x, i1));
+    }
+    for (; k < len; k += vl) {
+        svbool_t pg = svwhilelt_b32_s64(k, len);
+        svint32_t i0 = svld1_s32(pg, col + k);
+        acc0 = svmla_f32_m(pg, acc0, svld1_f32(pg, val + k), svld1_gather_s32index_f32(pg, x, i0));
+    }
+    return svaddv_f32(all, svadd_f32_x(all, acc0, acc1));
+}
+
+// y[r] = row r of A times x, for the rows [row_begin, row_end).
+inline void spmv_rows(const CsrMatrix& a, const float* x, float* y, size_t row_begin, size_t row_end) {
+    for (size_t r = row_begin; r < row_end; ++r) {
+        int64_t begin = a.row_ptr[r];
+        y[r] = row_dot(a.col_idx + begin, a.values + begin, a.row_ptr[r + 1] - begin, x);
+    }
+}
+
+// First row of part `part` of `parts`, chosen so that each part covers about
+// nnz / parts nonzeros.
+inline size_t partition_row(const CsrMatrix& a, size_t part, size_t parts) {
+    int64_t nnz = a.row_ptr[a.rows];
+    int64_t target = (int64_t)((double)nnz * part / parts);
+    return (size_t)(std::lower_bound(a.row_ptr, a.row_ptr + a.rows, target) - a.row_ptr);
+}
+
+// y = A * x on `threads` threads (0: one per hardware thread). Rows are split
+// by nonzero count rather than row count, and matrices with fewer than 32K
+// nonzeros per thread use fewer threads. Summation order within a row depends
+// on the vector length, so results differ in the last bits between machines.
+inline void spmv(const CsrMatrix& a, const float* x, float* y, unsigned threads = 0) {
+    const int64_t min_nnz_per_thread = 1 << 15;
+    int64_t nnz = a.row_ptr[a.rows];
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = (unsigned)std::min<int64_t>(threads, std::max<int64_t>(1, nnz / min_nnz_per_thread));
+    if (threads <= 1) {
+        spmv_rows(a, x, y, 0, a.rows);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) {
+        size_t begin = partition_row(a, t, threads);
+        size_t end = t + 1 == threads ? a.rows : partition_row(a, t + 1, threads);
+        workers.emplace_back(spmv_rows, std::cref(a), x, y, begin, end);
+    }
+    spmv_rows(a, x, y, 0, partition_row(a, 1, threads));
+    for (std::thread& w : workers) w.join();
+}
+
+} // namespace sve
+} // namespace simd
+
+#endif // SPMV_SVE_H
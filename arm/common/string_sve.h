@@ -0,0 +1,106 @@
+#ifndef STRING_SVE_H
+#define STRING_SVE_H
+
+#include <arm_sve.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+namespace sve {
+
+// String scanning with first-faulting loads. A scan does not know where its
+// buffer ends, so a full-vector load may run onto an unmapped page. svldff1
+// only faults if the *first* active lane is inaccessible; a fault on a later
+// lane instead clears that lane and all after it in the first-fault register
+// (FFR), which svrdffr reads back. Each step therefore:
+//
+//   1. svsetffr() - mark every lane as loaded;
+//   2. svldff1_u8 - load up to one vector;
+//   3. svrdffr_z  - keep only the lanes that really were loaded;
+//   4. search those lanes, and advance by their count (svcntp).
+//
+// The first lane of the next step is the one that faulted, so if that byte
+// really is inaccessible the next load faults normally - exactly where the
+// scalar function would. svbrkb ("break before") turns the match predicate
+// into the lanes before the first match, whose count is the match position.
+
+// Length of the null-terminated string s.
+inline size_t strlen(const char* s) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(s);
+    const svbool_t all = svptrue_b8();
+    size_t i = 0;
+    for (;;) {
+        svsetffr();
+        svuint8_t v = svldff1_u8(all, p + i);
+        svbool_t loaded = svrdffr_z(all);
+        svbool_t nul = svcmpeq_n_u8(loaded, v, 0);
+        if (svptest_any(loaded, nul)) {
+            return i + svcntp_b8(loaded, svbrkb_z(loaded, nul));
+        }
+        i += svcntp_b8(all, loaded);
+    }
+}
+
+// min(strlen(s), maxlen), reading at most maxlen bytes.
+inline size_t strnlen(const char* s, size_t maxlen) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(s);
+    size_t i = 0;
+    while (i < maxlen) {
+        svbool_t pg = svwhilelt_b8_u64(i, maxlen);
+        svsetffr();
+        svuint8_t v = svldff1_u8(pg, p + i);
+        svbool_t loaded = svrdffr_z(pg);
+        svbool_t nul = svcmpeq_n_u8(loaded, v, 0);
+        if (svptest_any(loaded, nul)) {
+            return i + svcntp_b8(loaded, svbrkb_z(loaded, nul));
+        }
+        i += svcntp_b8(pg, loaded);
+    }
+    return maxlen;
+}
+
+// First occurrence of (unsigned char)c in the first n bytes of s, or nullptr.
+// Like the C function, it may be given an n larger than the buffer as long as
+// c occurs in it: the first-faulting loads never fault past the match.
+inline const void* memchr(const void* s, int c, size_t n) {
+    const uint8_t* p = static_cast<const uint8_t*>(s);
+    const uint8_t byte = (uint8_t)c;
+    size_t i = 0;
+    while (i < n) {
+        svbool_t pg = svwhilelt_b8_u64(i, n);
+        svsetffr();
+        svuint8_t v = svldff1_u8(pg, p + i);
+        svbool_t loaded = svrdffr_z(pg);
+        svbool_t hit = svcmpeq_n_u8(loaded, v, byte);
+        if (svptest_any(loaded, hit)) {
+            return p + i + svcntp_b8(loaded, svbrkb_z(loaded, hit));
+        }
+        i += svcntp_b8(pg, loaded);
+    }
+    return nullptr;
+}
+
+// First occurrence of (char)c in the string s, or nullptr. c == 0 finds the
+// terminator.
+inline const char* strchr(const char* s, int c) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(s);
+    const uint8_t byte = (uint8_t)c;
+    const svbool_t all = svptrue_b8();
+    size_t i = 0;
+    for (;;) {
+        svsetffr();
+        svuint8_t v = svldff1_u8(all, p + i);
+        svbool_t loaded = svrdffr_z(all);
+        svbool_t stop = svorr_z(loaded, svcmpeq_n_u8(loaded, v, byte), svcmpeq_n_u8(loaded, v, 0));
+        if (svptest_any(loaded, stop)) {
+            size_t k = i + svcntp_b8(loaded, svbrkb_z(loaded, stop));
+            return p[k] == byte ? s + k : nullptr;
+        }
+        i += svcntp_b8(all, loaded);
+    }
+}
+
+} // namespace sve
+} // namespace simd
+
+#endif // STRING_SVE_H
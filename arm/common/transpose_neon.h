@@ -0,0 +1,150 @@
+#ifndef TRANSPOSE_NEON_H
+#define TRANSPOSE_NEON_H
+
+#include <arm_neon.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+namespace neon {
+
+// In-register transposes and cache-blocked matrix transposes, like the x86
+// transpose.h. vtrn (TRN1/TRN2) swaps the odd elements of one vector with the
+// even elements of the other; applied to 8-, 16- and 32-bit elements in turn
+// it moves pairs, then pairs of pairs, then quads, and a final swap of 64-bit
+// halves finishes a 16x16 byte block.
+//
+// NEON has no streaming-store intrinsic (STNP is only reachable from
+// assembly), so the large transposes store normally; their tiles keep the
+// destination lines in cache until they are complete instead.
+
+// r0..r3 are rows of a 4x4 block; afterwards r<j> holds column j.
+inline void transpose4x4(float32x4_t& r0, float32x4_t& r1, float32x4_t& r2, float32x4_t& r3) {
+    float32x4x2_t t0 = vtrnq_f32(r0, r1);  // a0 b0 a2 b2 | a1 b1 a3 b3
+    float32x4x2_t t1 = vtrnq_f32(r2, r3);  // c0 d0 c2 d2 | c1 d1 c3 d3
+    r0 = vcombine_f32(vget_low_f32(t0.val[0]), vget_low_f32(t1.val[0]));
+    r1 = vcombine_f32(vget_low_f32(t0.val[1]), vget_low_f32(t1.val[1]));
+    r2 = vcombine_f32(vget_high_f32(t0.val[0]), vget_high_f32(t1.val[0]));
+    r3 = vcombine_f32(vget_high_f32(t0.val[1]), vget_high_f32(t1.val[1]));
+}
+
+// 8x8 bytes: r[i] is row i before, column i after.
+inline void transpose8x8(uint8x8_t r[8]) {
+    // s1[2i + p]: rows 2i, 2i + 1 at the columns = p (mod 2).
+    uint8x8_t s1[8];
+    for (int i = 0; i < 4; ++i) {
+        uint8x8x2_t t = vtrn_u8(r[2 * i], r[2 * i + 1]);
+        s1[2 * i] = t.val[0];
+        s1[2 * i + 1] = t.val[1];
+    }
+    // s2[4i + q]: rows 4i .. 4i + 3 at the columns = q (mod 4).
+    uint16x4_t s2[8];
+    for (int i = 0; i < 2; ++i) {
+        for (int p = 0; p < 2; ++p) {
+            uint16x4x2_t t = vtrn_u16(vreinterpret_u16_u8(s1[4 * i + p]), vreinterpret_u16_u8(s1[4 * i + 2 + p]));
+            s2[4 * i + p] = t.val[0];
+            s2[4 * i + 2 + p] = t.val[1];
+        }
+    }
+    for (int q = 0; q < 4; ++q) {
+        uint32x2x2_t t = vtrn_u32(vreinterpret_u32_u16(s2[q]), vreinterpret_u32_u16(s2[4 + q]));
+        r[q] = vreinterpret_u8_u32(t.val[0]);
+        r[4 + q] = vreinterpret_u8_u32(t.val[1]);
+    }
+}
+
+// 16x16 bytes: the three stages of transpose8x8 on 16-byte vectors leave
+// columns c and c + 8 of eight rows in the two halves of one vector; swapping
+// 64-bit halves between the two groups of eight rows finishes the job.
+inline void transpose16x16(uint8x16_t r[16]) {
+    uint8x16_t s1[16];
+    for (int i = 0; i < 8; ++i) {
+        uint8x16x2_t t = vtrnq_u8(r[2 * i], r[2 * i + 1]);
+        s1[2 * i] = t.val[0];
+        s1[2 * i + 1] = t.val[1];
+    }
+    uint16x8_t s2[16];
+    for (int i = 0; i < 4; ++i) {
+        for (int p = 0; p < 2; ++p) {
+            uint16x8x2_t t =
+                vtrnq_u16(vreinterpretq_u16_u8(s1[4 * i + p]), vreinterpretq_u16_u8(s1[4 * i + 2 + p]));
+            s2[4 * i + p] = t.val[0];
+            s2[4 * i + 2 + p] = t.val[1];
+        }
+    }
+    // s3[8i + c]: columns c and c + 8 of rows 8i .. 8i + 7.
+    uint8x16_t s3[16];
+    for (int i = 0; i < 2; ++i) {
+        for (int q = 0; q < 4; ++q) {
+            uint32x4x2_t t =
+                vtrnq_u32(vreinterpretq_u32_u16(s2[8 * i + q]), vreinterpretq_u32_u16(s2[8 * i + 4 + q]));
+            s3[8 * i + q] = vreinterpretq_u8_u32(t.val[0]);
+            s3[8 * i + 4 + q] = vreinterpretq_u8_u32(t.val[1]);
+        }
+    }
+    for (int c = 0; c < 8; ++c) {
+        r[c] = vcombine_u8(vget_low_u8(s3[c]), vget_low_u8(s3[8 + c]));
+        r[8 + c] = vcombine_u8(vget_high_u8(s3[c]), vget_high_u8(s3[8 + c]));
+    }
+}
+
+// Edge of the cache tiles, in elements: a 64 x 64 tile of floats is 16 KiB.
+const size_t kTransposeTile = 64;
+
+template <typename T>
+inline void transpose_scalar_loop(const T* src, size_t r0, size_t r1, size_t c0, size_t c1, size_t ss, T* dst,
+                                  size_t ds) {
+    for (size_t r = r0; r < r1; ++r) {
+        for (size_t c = c0; c < c1; ++c) dst[c * ds + r] = src[r * ss + c];
+    }
+}
+
+// Walks the KxK blocks of each tile, destination rows outermost; the scalar
+// loop takes the rows and columns past the last multiple of K.
+template <size_t K, typename T, typename Block>
+inline void transpose_blocked(const T* src, size_t rows, size_t cols, size_t ss, T* dst, size_t ds, Block block) {
+    size_t rk = rows / K * K;
+    size_t ck = cols / K * K;
+    for (size_t i0 = 0; i0 < rk; i0 += kTransposeTile) {
+        size_t i1 = i0 + kTransposeTile < rk ? i0 + kTransposeTile : rk;
+        for (size_t j0 = 0; j0 < ck; j0 += kTransposeTile) {
+            size_t j1 = j0 + kTransposeTile < ck ? j0 + kTransposeTile : ck;
+            for (size_t j = j0; j < j1; j += K) {
+                for (size_t i = i0; i < i1; i += K) block(src + i * ss + j, ss, dst + j * ds + i, ds);
+            }
+        }
+    }
+    transpose_scalar_loop(src, 0, rk, ck, cols, ss, dst, ds);
+    transpose_scalar_loop(src, rk, rows, 0, cols, ss, dst, ds);
+}
+
+// dst[c * dst_stride + r] = src[r * src_stride + c]; strides in elements.
+inline void transpose(const float* src, size_t rows, size_t cols, size_t src_stride, float* dst,
+                      size_t dst_stride) {
+    transpose_blocked<4>(src, rows, cols, src_stride, dst, dst_stride,
+                         [](const float* s, size_t ss, float* d, size_t ds) {
+                             float32x4_t r0 = vld1q_f32(s), r1 = vld1q_f32(s + ss);
+                             float32x4_t r2 = vld1q_f32(s + 2 * ss), r3 = vld1q_f32(s + 3 * ss);
+                             transpose4x4(r0, r1, r2, r3);
+                             vst1q_f32(d, r0);
+                             vst1q_f32(d + ds, r1);
+                             vst1q_f32(d + 2 * ds, r2);
+                             vst1q_f32(d + 3 * ds, r3);
+                         });
+}
+
+inline void transpose(const uint8_t* src, size_t rows, size_t cols, size_t src_stride, uint8_t* dst,
+                      size_t dst_stride) {
+    transpose_blocked<16>(src, rows, cols, src_stride, dst, dst_stride,
+                          [](const uint8_t* s, size_t ss, uint8_t* d, size_t ds) {
+                              uint8x16_t r[16];
+                              for (int k = 0; k < 16; ++k) r[k] = vld1q_u8(s + k * ss);
+                              transpose16x16(r);
+                              for (int k = 0; k < 16; ++k) vst1q_u8(d + k * ds, r[k]);
+                          });
+}
+
+} // namespace neon
+} // namespace simd
+
+#endif // TRANSPOSE_NEON_H
@@ -0,0 +1,83 @@
+#ifndef TRANSPOSE_SVE_H
+#define TRANSPOSE_SVE_H
+
+#include <arm_sve.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+namespace sve {
+
+// Vector-length-agnostic transpose of 32-bit elements. svtrn1/svtrn2 pair
+// up neighbouring elements like the NEON vtrn, at any vector length, so four
+// rows of VL columns pass through a 32-bit and then a 64-bit TRN stage and
+// come out as VL / 4 transposed 4x4 blocks, one per 128-bit granule:
+//
+//   u<k>, granule g = column 4g + k of the four rows.
+//
+// Each granule then goes to a different destination row, which a scatter of
+// 64-bit elements (two rows of the column each) writes in one instruction.
+//
+// SVE vector types are sizeless, so they cannot be kept in arrays or
+// structures; the stages are written out with named values instead of the
+// loops of the fixed-width versions.
+
+// dst[c * dst_stride + r] = src[r * src_stride + c]; strides in elements.
+inline void transpose(const uint32_t* src, size_t rows, size_t cols, size_t src_stride, uint32_t* dst,
+                      size_t dst_stride) {
+    const size_t vl = svcntw();
+    const size_t tile = 64;
+    // Byte offsets of the 64-bit lanes: lane e is half e % 2 of granule e / 2.
+    svuint64_t lane = svindex_u64(0, 1);
+    svuint64_t granule = svlsr_n_u64_x(svptrue_b64(), lane, 1);
+    svuint64_t offsets = svadd_u64_x(svptrue_b64(),
+                                     svmul_n_u64_x(svptrue_b64(), granule, 4 * dst_stride * sizeof(uint32_t)),
+                                     svmul_n_u64_x(svptrue_b64(), svand_n_u64_x(svptrue_b64(), lane, 1), 8));
+    size_t r4 = rows / 4 * 4;
+    for (size_t i0 = 0; i0 < r4; i0 += tile) {
+        size_t i1 = i0 + tile < r4 ? i0 + tile : r4;
+        for (size_t j = 0; j < cols; j += vl) {
+            svbool_t pg = svwhilelt_b32_u64(j, cols);
+            // Column 4g + k exists when 4g + k < cols - j.
+            svuint64_t left = svdup_n_u64(cols - j);
+            svuint64_t first = svmul_n_u64_x(svptrue_b64(), granule, 4);
+            svbool_t p0 = svcmplt_u64(svptrue_b64(), first, left);
+            svbool_t p1 = svcmplt_u64(svptrue_b64(), svadd_n_u64_x(svptrue_b64(), first, 1), left);
+            svbool_t p2 = svcmplt_u64(svptrue_b64(), svadd_n_u64_x(svptrue_b64(), first, 2), left);
+            svbool_t p3 = svcmplt_u64(svptrue_b64(), svadd_n_u64_x(svptrue_b64(), first, 3), left);
+            for (size_t i = i0; i < i1; i += 4) {
+                const uint32_t* s = src + i * src_stride + j;
+                svuint32_t r0 = svld1_u32(pg, s);
+                svuint32_t r1 = svld1_u32(pg, s + src_stride);
+                svuint32_t r2 = svld1_u32(pg, s + 2 * src_stride);
+                svuint32_t r3 = svld1_u32(pg, s + 3 * src_stride);
+                svuint64_t t0 = svreinterpret_u64_u32(svtrn1_u32(r0, r1));  // a0 b0 a2 b2
+                svuint64_t t1 = svreinterpret_u64_u32(svtrn2_u32(r0, r1));  // a1 b1 a3 b3
+                svuint64_t t2 = svreinterpret_u64_u32(svtrn1_u32(r2, r3));  // c0 d0 c2 d2
+                svuint64_t t3 = svreinterpret_u64_u32(svtrn2_u32(r2, r3));  // c1 d1 c3 d3
+                uint64_t* d = reinterpret_cast<uint64_t*>(dst + j * dst_stride + i);
+                uint64_t* d1 = reinterpret_cast<uint64_t*>(dst + (j + 1) * dst_stride + i);
+                uint64_t* d2 = reinterpret_cast<uint64_t*>(dst + (j + 2) * dst_stride + i);
+                uint64_t* d3 = reinterpret_cast<uint64_t*>(dst + (j + 3) * dst_stride + i);
+                svst1_scatter_u64offset_u64(p0, d, offsets, svtrn1_u64(t0, t2));
+                svst1_scatter_u64offset_u64(p1, d1, offsets, svtrn1_u64(t1, t3));
+                svst1_scatter_u64offset_u64(p2, d2, offsets, svtrn2_u64(t0, t2));
+                svst1_scatter_u64offset_u64(p3, d3, offsets, svtrn2_u64(t1, t3));
+            }
+        }
+    }
+    for (size_t r = r4; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) dst[c * dst_stride + r] = src[r * src_stride + c];
+    }
+}
+
+inline void transpose(const float* src, size_t rows, size_t cols, size_t src_stride, float* dst,
+                      size_t dst_stride) {
+    transpose(reinterpret_cast<const uint32_t*>(src), rows, cols, src_stride, reinterpret_cast<uint32_t*>(dst),
+              dst_stride);
+}
+
+} // namespace sve
+} // namespace simd
+
+#endif // TRANSPOSE_SVE_H
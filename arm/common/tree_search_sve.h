@@ -0,0 +1,97 @@
+#ifndef TREE_SEARCH_SVE_H
+#define TREE_SEARCH_SVE_H
+
+#include <arm_sve.h>
+#include <cstddef>
+#include <cstdint>
+#include "amac.h"
+
+namespace simd {
+namespace sve {
+
+// Batched lower_bound over an Eytzinger-ordered uint32_t index, like the x86
+// tree_search.h: tree[1] is the root and tree[k] has children tree[2k] and
+// tree[2k + 1]. Each level of a descent is a load that depends on the one
+// before. tree_search overlaps 16 descents with amac_run; tree_search_gather
+// runs a vector of them in lockstep, one svld1_gather per level.
+//
+// out[i] is the position in tree of the first key >= keys[i], or 0 if there
+// is none. n must be below 2^31.
+
+inline size_t eytzinger_fill(const uint32_t* sorted, size_t n, uint32_t* tree, size_t i, size_t k) {
+    if (k > n) return i;
+    i = eytzinger_fill(sorted, n, tree, i, 2 * k);
+    tree[k] = sorted[i++];
+    return eytzinger_fill(sorted, n, tree, i, 2 * k + 1);
+}
+
+// The descent ends below a leaf; the answer is the last level it went left,
+// the lowest zero bit of k.
+inline uint32_t tree_finish(uint32_t k) { return k >> (__builtin_ctz(~k) + 1); }
+
+struct TreeProbe {
+    struct State {
+        uint32_t key;
+        uint32_t k;
+        size_t i;
+    };
+    const uint32_t* tree;
+    uint32_t n;
+    const uint32_t* keys;
+    uint32_t* out;
+
+    const void* start(size_t i, State& s) {
+        s.key = keys[i];
+        s.k = 1;
+        s.i = i;
+        if (n == 0) {
+            out[i] = 0;
+            return nullptr;
+        }
+        return tree + 1;
+    }
+    const void* step(State& s) {
+        s.k = 2 * s.k + (tree[s.k] < s.key);
+        if (s.k <= n) return tree + s.k;
+        out[s.i] = tree_finish(s.k);
+        return nullptr;
+    }
+};
+
+// tree[1..n] from sorted[0, n); tree holds n + 1 entries.
+inline void eytzinger_layout(const uint32_t* sorted, size_t n, uint32_t* tree) {
+    tree[0] = 0;
+    eytzinger_fill(sorted, n, tree, 0, 1);
+}
+
+inline void tree_search(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out) {
+    TreeProbe probe = {tree, (uint32_t)n, keys, out};
+    amac_run<16>(probe, m);
+}
+
+// The lanes still above the leaves stay in `live`; k doubles under it and
+// gains 1 where the node is below the key. The lowest zero bit of k comes
+// from svrbit and svclz.
+inline void tree_search_gather(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out) {
+    const svbool_t all = svptrue_b32();
+    for (size_t i = 0; i < m; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32_u64(i, m);
+        svuint32_t x = svld1_u32(pg, keys + i);
+        svuint32_t k = svdup_n_u32(1);
+        svbool_t live = svcmple_n_u32(pg, k, (uint32_t)n);
+        while (svptest_any(all, live)) {
+            svuint32_t v = svld1_gather_u32index_u32(live, tree, k);
+            svbool_t lt = svcmplt_u32(live, v, x);
+            k = svadd_u32_m(live, k, k);
+            k = svadd_n_u32_m(lt, k, 1);
+            live = svcmple_n_u32(live, k, (uint32_t)n);
+        }
+        svuint32_t shift = svadd_n_u32_x(pg, svclz_u32_x(pg, svrbit_u32_x(pg, svnot_u32_x(pg, k))), 1);
+        svst1_u32(pg, out + i, svlsr_u32_x(pg, k, shift));
+    }
+}
+
+} // namespace sve
+} // namespace simd
+
+#endif // TREE_SEARCH_SVE_H
@@ -0,0 +1,373 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace simd {
+
+// UTF-8 validation and UTF-8 <-> UTF-16 transcoding for NEON, with the API
+// of the x86 utf8.h: valid UTF-8 is the shortest form of a code point up to
+// U+10FFFF that is not a surrogate, valid UTF-16 has every surrogate in a
+// high-low pair, in native byte order. This header has the parts that do
+// not depend on the vector ISA: the tables, the scalar loops, and the
+// streaming classes, which take the vector loops as a Codec:
+//
+//   struct Codec {
+//       // whether n bytes are valid UTF-8; a character cut by the end is not
+//       static bool validate(const char* src, size_t n);
+//       // n bytes into at most n units / n units into at most 3 * n bytes;
+//       // false, with *written 0, on invalid input
+//       static bool to_utf16(const char* src, size_t n, char16_t* dst, size_t* written);
+//       static bool to_utf8(const char16_t* src, size_t n, char* dst, size_t* written);
+//   };
+//
+// utf8_neon.h provides one, with typedefs of the classes below and one-shot
+// utf8_validate / utf8_to_utf16 / utf16_to_utf8.
+
+struct Utf8Tables {
+    // Byte shuffle (vqtbl1q_u8) moving the 16-bit lanes set in an 8-bit mask
+    // to the front.
+    uint8_t pack16[256][16];
+    // For 4 units as 32-bit lanes [b0 b1 b2 -], index m1 | m2 << 4 with bit
+    // j of m1 set if unit j needs 2 bytes or more and of m2 if it needs 3:
+    // the shuffle keeping the bytes in use, and their count.
+    uint8_t pack_utf8[256][16];
+    uint8_t pack_utf8_length[256];
+};
+
+inline Utf8Tables utf8_make_tables() {
+    Utf8Tables t;
+    std::memset(&t, 0xFF, sizeof t);   // an out-of-range index gives 0
+    for (unsigned m = 0; m < 256; ++m) {
+        int k = 0;
+        for (int j = 0; j < 8; ++j) {
+            if (m >> j & 1) {
+                t.pack16[m][k++] = (uint8_t)(2 * j);
+                t.pack16[m][k++] = (uint8_t)(2 * j + 1);
+            }
+        }
+        // Only the indices with m2 a subset of m1 occur.
+        unsigned m1 = m & 15, m2 = m >> 4;
+        k = 0;
+        for (int j = 0; j < 4; ++j) {
+            int bytes = 1 + (m1 >> j & 1) + (m2 >> j & 1);
+            for (int b = 0; b < bytes; ++b) t.pack_utf8[m][k++] = (uint8_t)(4 * j + b);
+        }
+        t.pack_utf8_length[m] = (uint8_t)k;
+    }
+    return t;
+}
+
+inline const Utf8Tables& utf8_tables() {
+    static const Utf8Tables tables = utf8_make_tables();
+    return tables;
+}
+
+// Error classes of the lookup validator (Keiser and Lemire), as in the x86
+// utf8_internal.h: the three tables below classify a pair of adjacent bytes
+// by the high and low nibble of the first and the high nibble of the
+// second, and the pair is in the classes all three agree on.
+const uint8_t kUtf8TooShort = 1 << 0;     // lead followed by a lead or ASCII
+const uint8_t kUtf8TooLong = 1 << 1;      // ASCII followed by a continuation
+const uint8_t kUtf8Overlong3 = 1 << 2;    // E0 80..9F
+const uint8_t kUtf8TooLarge = 1 << 3;     // F4 90..BF, F5..FF
+const uint8_t kUtf8Surrogate = 1 << 4;    // ED A0..BF
+const uint8_t kUtf8Overlong2 = 1 << 5;    // C0, C1
+const uint8_t kUtf8TooLarge1000 = 1 << 6; // F5..FF 80..8F
+const uint8_t kUtf8Overlong4 = 1 << 6;    // F0 80..8F
+const uint8_t kUtf8TwoConts = 1 << 7;     // continuation after continuation
+const uint8_t kUtf8Carry = kUtf8TooShort | kUtf8TooLong | kUtf8TwoConts;
+
+const uint8_t kUtf8Byte1High[16] = {
+    kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong,
+    kUtf8TwoConts, kUtf8TwoConts, kUtf8TwoConts, kUtf8TwoConts,
+    kUtf8TooShort | kUtf8Overlong2,
+    kUtf8TooShort,
+    kUtf8TooShort | kUtf8Overlong3 | kUtf8Surrogate,
+    kUtf8TooShort | kUtf8TooLarge | kUtf8TooLarge1000 | kUtf8Overlong4};
+const uint8_t kUtf8Byte1Low[16] = {
+    kUtf8Carry | kUtf8Overlong3 | kUtf8Overlong2 | kUtf8Overlong4,
+    kUtf8Carry | kUtf8Overlong2,
+    kUtf8Carry,
+    kUtf8Carry,
+    kUtf8Carry | kUtf8TooLarge,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000 | kUtf8Surrogate,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+    kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000};
+const uint8_t kUtf8Byte2High[16] = {
+    kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort,
+    kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort,
+    kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Overlong3 | kUtf8TooLarge1000 | kUtf8Overlong4,
+    kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Overlong3 | kUtf8TooLarge,
+    kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Surrogate | kUtf8TooLarge,
+    kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Surrogate | kUtf8TooLarge,
+    kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort};
+
+// The character at s[i], i < n: its length, or 0 if it is not valid UTF-8
+// or is cut off by n.
+inline size_t utf8_decode_one(const uint8_t* s, size_t i, size_t n, uint32_t* cp) {
+    uint32_t b0 = s[i];
+    if (b0 < 0x80) {
+        *cp = b0;
+        return 1;
+    }
+    // Range of the second byte after each lead; later bytes are 80..BF.
+    size_t len;
+    uint32_t lo = 0x80, hi = 0xBF;
+    if (b0 < 0xC2) return 0;
+    else if (b0 < 0xE0) len = 2;
+    else if (b0 < 0xF0) {
+        len = 3;
+        if (b0 == 0xE0) lo = 0xA0;
+        if (b0 == 0xED) hi = 0x9F;
+    } else if (b0 < 0xF5) {
+        len = 4;
+        if (b0 == 0xF0) lo = 0x90;
+        if (b0 == 0xF4) hi = 0x8F;
+    } else return 0;
+    if (n - i < len || s[i + 1] < lo || s[i + 1] > hi) return 0;
+    uint32_t v = b0 & (0x7F >> len);
+    for (size_t j = 1; j < len; ++j) {
+        if ((s[i + j] & 0xC0) != 0x80) return 0;
+        v = v << 6 | (s[i + j] & 0x3F);
+    }
+    *cp = v;
+    return len;
+}
+
+// Whether n bytes are valid UTF-8, skipping 8 ASCII bytes at a time.
+inline bool utf8_validate_scalar(const uint8_t* s, size_t n) {
+    size_t i = 0;
+    while (i < n) {
+        if (n - i >= 8) {
+            uint64_t w;
+            std::memcpy(&w, s + i, 8);
+            if ((w & 0x8080808080808080ull) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+        uint32_t cp;
+        size_t len = utf8_decode_one(s, i, n, &cp);
+        if (!len) return false;
+        i += len;
+    }
+    return true;
+}
+
+// Decodes the characters that start in [*i, end) into dst + *k, *i at the
+// start of one and end <= n. The last may run past end; *i ends after it.
+// False if one is invalid.
+inline bool utf8_to_utf16_scalar(const uint8_t* s, size_t* i, size_t end, size_t n, char16_t* dst, size_t* k) {
+    size_t j = *i, o = *k;
+    while (j < end) {
+        uint32_t cp;
+        size_t len = utf8_decode_one(s, j, n, &cp);
+        if (!len) return false;
+        if (cp < 0x10000) {
+            dst[o++] = (char16_t)cp;
+        } else {
+            dst[o++] = (char16_t)(0xD7C0 + (cp >> 10));
+            dst[o++] = (char16_t)(0xDC00 | (cp & 0x3FF));
+        }
+        j += len;
+    }
+    *i = j;
+    *k = o;
+    return true;
+}
+
+// Encodes the units that start in [*i, end) into dst + *k, end <= n. A high
+// surrogate at end - 1 takes its low half from s[end]; *i ends after it.
+// False on an unpaired surrogate.
+inline bool utf16_to_utf8_scalar(const char16_t* s, size_t* i, size_t end, size_t n, char* dst, size_t* k) {
+    size_t j = *i, o = *k;
+    while (j < end) {
+        uint32_t u = s[j++];
+        if (u < 0x80) {
+            dst[o++] = (char)u;
+        } else if (u < 0x800) {
+            dst[o++] = (char)(0xC0 | u >> 6);
+            dst[o++] = (char)(0x80 | (u & 0x3F));
+        } else if (u - 0xD800 >= 0x800) {
+            dst[o++] = (char)(0xE0 | u >> 12);
+            dst[o++] = (char)(0x80 | (u >> 6 & 0x3F));
+            dst[o++] = (char)(0x80 | (u & 0x3F));
+        } else {
+            if (u >= 0xDC00 || j == n || s[j] < 0xDC00 || s[j] > 0xDFFF) return false;
+            uint32_t cp = 0x10000 + ((u - 0xD800) << 10) + (s[j++] - 0xDC00);
+            dst[o++] = (char)(0xF0 | cp >> 18);
+            dst[o++] = (char)(0x80 | (cp >> 12 & 0x3F));
+            dst[o++] = (char)(0x80 | (cp >> 6 & 0x3F));
+            dst[o++] = (char)(0x80 | (cp & 0x3F));
+        }
+    }
+    *i = j;
+    *k = o;
+    return true;
+}
+
+// Bytes of the character a byte starts; 1 for ASCII and continuations.
+inline size_t utf8_sequence_length(uint8_t b) {
+    return b >= 0xF0 ? 4 : b >= 0xE0 ? 3 : b >= 0xC0 ? 2 : 1;
+}
+
+// Where the last character of s[0, n) starts if the end cuts it off, else n.
+inline size_t utf8_cut_point(const char* s, size_t n) {
+    for (size_t back = 1; back <= 3 && back <= n; ++back) {
+        uint8_t b = (uint8_t)s[n - back];
+        if ((b & 0xC0) != 0x80) return utf8_sequence_length(b) > back ? n - back : n;
+    }
+    return n;
+}
+
+// Moves bytes from the front of *src into carry until it holds the whole
+// character its first byte starts; returns whether it does.
+inline bool utf8_fill_carry(char* carry, size_t* size, const char** src, size_t* n) {
+    size_t need = utf8_sequence_length((uint8_t)carry[0]);
+    while (*size < need && *n) {
+        carry[(*size)++] = *(*src)++;
+        --*n;
+    }
+    return *size == need;
+}
+
+// Streaming forms, for input that arrives in pieces of any size. update
+// handles the whole characters it has and keeps the start of a character
+// cut by the end of the piece (at most 3 bytes, or a high surrogate) for
+// the next call. finish reports whether the stream ended on a character
+// boundary and resets the object. After a false return every call fails
+// until finish.
+template <typename Codec>
+class Utf8Validator {
+public:
+    Utf8Validator() : carry_size_(0), failed_(false) {}
+
+    bool update(const char* src, size_t n) {
+        if (failed_) return false;
+        if (carry_size_) {
+            if (!utf8_fill_carry(carry_, &carry_size_, &src, &n)) return true;
+            if (!Codec::validate(carry_, carry_size_)) return fail();
+            carry_size_ = 0;
+        }
+        size_t cut = utf8_cut_point(src, n);
+        if (!Codec::validate(src, cut)) return fail();
+        for (size_t i = cut; i < n; ++i) carry_[carry_size_++] = src[i];
+        return true;
+    }
+
+    bool finish() {
+        bool ok = !failed_ && carry_size_ == 0;
+        carry_size_ = 0;
+        failed_ = false;
+        return ok;
+    }
+
+private:
+    bool fail() {
+        failed_ = true;
+        return false;
+    }
+
+    char carry_[4];
+    size_t carry_size_;
+    bool failed_;
+};
+
+template <typename Codec>
+class Utf8ToUtf16 {
+public:
+    Utf8ToUtf16() : carry_size_(0), failed_(false) {}
+
+    // Writes at most n + 1 units and sets *written.
+    bool update(const char* src, size_t n, char16_t* dst, size_t* written) {
+        size_t k = 0, m = 0;
+        *written = 0;
+        if (failed_) return false;
+        if (carry_size_) {
+            if (!utf8_fill_carry(carry_, &carry_size_, &src, &n)) return true;
+            if (!Codec::to_utf16(carry_, carry_size_, dst, &k)) return fail();
+            carry_size_ = 0;
+        }
+        size_t cut = utf8_cut_point(src, n);
+        if (!Codec::to_utf16(src, cut, dst + k, &m)) return fail();
+        for (size_t i = cut; i < n; ++i) carry_[carry_size_++] = src[i];
+        *written = k + m;
+        return true;
+    }
+
+    bool finish() {
+        bool ok = !failed_ && carry_size_ == 0;
+        carry_size_ = 0;
+        failed_ = false;
+        return ok;
+    }
+
+private:
+    bool fail() {
+        failed_ = true;
+        return false;
+    }
+
+    char carry_[4];
+    size_t carry_size_;
+    bool failed_;
+};
+
+template <typename Codec>
+class Utf16ToUtf8 {
+public:
+    Utf16ToUtf8() : carry_(0), has_carry_(false), failed_(false) {}
+
+    // Writes at most 3 * n + 1 bytes and sets *written.
+    bool update(const char16_t* src, size_t n, char* dst, size_t* written) {
+        size_t k = 0, m = 0;
+        *written = 0;
+        if (failed_) return false;
+        if (has_carry_ && n) {
+            const char16_t pair[2] = {carry_, src[0]};
+            if (!Codec::to_utf8(pair, 2, dst, &k)) return fail();
+            has_carry_ = false;
+            ++src;
+            --n;
+        }
+        size_t cut = n && (src[n - 1] & 0xFC00) == 0xD800 ? n - 1 : n;
+        if (!Codec::to_utf8(src, cut, dst + k, &m)) return fail();
+        if (cut < n) {
+            carry_ = src[cut];
+            has_carry_ = true;
+        }
+        *written = k + m;
+        return true;
+    }
+
+    bool finish() {
+        bool ok = !failed_ && !has_carry_;
+        has_carry_ = failed_ = false;
+        return ok;
+    }
+
+private:
+    bool fail() {
+        failed_ = true;
+        return false;
+    }
+
+    char16_t carry_;   // a high surrogate waiting for its low half
+    bool has_carry_;
+    bool failed_;
+};
+
+} // namespace simd
+
+#endif // UTF8_H
@@ -0,0 +1,263 @@
+#ifndef UTF8_NEON_H
+#define UTF8_NEON_H
+
+#include <arm_neon.h>
+#include <cstddef>
+#include <cstdint>
+#include "safe_load_neon.h"
+#include "utf8.h"
+
+namespace simd {
+namespace neon {
+
+// UTF-8 with the lookup validator and the pack tables of the x86 SSE4.1
+// kernels, 16 bytes or 8 units per block:
+//
+//   validate  vqtbl1q_u8 on the nibbles of each byte and the byte before it
+//             (vextq_u8 with the previous block) gives the error classes of
+//             every pair; vqsubq_u8 finds the bytes that must be a 2nd or
+//             3rd continuation. An all-ASCII block (vmaxvq_u8) only settles
+//             a character left open by the one before.
+//   -> UTF-16 ASCII widens with vmovl_u8. Otherwise each byte is taken as a
+//             lead: with vsliq_n_u16 in 16-bit lanes from loads at +1 and
+//             +2, or, in a block with a 4-byte lead, in 32-bit lanes zipped
+//             from loads at +1..+3, its payload cut out by a shift pair
+//             looked up on its high nibble and a 4-byte character turned
+//             into a surrogate pair. vqtbl1q_u8 with pack16 drops the lanes
+//             of continuation bytes.
+//   -> UTF-8  ASCII narrows with vmovn_u16. Units without surrogates are
+//             encoded in 32-bit lanes in all three forms, vbslq_u32 picks
+//             one, and pack_utf8 keeps the bytes in use; blocks with a
+//             surrogate go through the scalar loop.
+//
+// NEON has no movemask, and the pack tables need one bit per lane side by
+// side rather than the nibble mask of hash_map_neon.h: the 0xFF / 0x00
+// lanes are ANDed with their bit and summed with vaddv_u8.
+//
+// The transcoders run the validator over every block and report at the end,
+// so the fast paths check nothing; they only keep dst within bounds
+// whatever the input.
+
+// The lookup validator over 16 bytes at a time.
+struct Utf8Check {
+    uint8x16_t prev, incomplete, error;
+
+    Utf8Check() : prev(vdupq_n_u8(0)), incomplete(vdupq_n_u8(0)), error(vdupq_n_u8(0)) {}
+
+    void add(uint8x16_t in) {
+        if (vmaxvq_u8(in) < 0x80) {
+            // A character cut by the end of the previous block is an error.
+            error = vorrq_u8(error, incomplete);
+            prev = in;
+            incomplete = vdupq_n_u8(0);
+            return;
+        }
+        uint8x16_t prev1 = vextq_u8(prev, in, 15);
+        uint8x16_t b1h = vqtbl1q_u8(vld1q_u8(kUtf8Byte1High), vshrq_n_u8(prev1, 4));
+        uint8x16_t b1l = vqtbl1q_u8(vld1q_u8(kUtf8Byte1Low), vandq_u8(prev1, vdupq_n_u8(0x0F)));
+        uint8x16_t b2h = vqtbl1q_u8(vld1q_u8(kUtf8Byte2High), vshrq_n_u8(in, 4));
+        uint8x16_t special = vandq_u8(vandq_u8(b1h, b1l), b2h);
+        uint8x16_t third = vqsubq_u8(vextq_u8(prev, in, 14), vdupq_n_u8(0xE0 - 0x80));
+        uint8x16_t fourth = vqsubq_u8(vextq_u8(prev, in, 13), vdupq_n_u8(0xF0 - 0x80));
+        uint8x16_t must23 = vandq_u8(vorrq_u8(third, fourth), vdupq_n_u8(0x80));
+        error = vorrq_u8(error, veorq_u8(must23, special));
+        prev = in;
+        // Only the last 3 bytes can be left open.
+        static const uint8_t kMaxOpen[16] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                             0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF};
+        incomplete = vqsubq_u8(in, vld1q_u8(kMaxOpen));
+    }
+
+    bool ok() const { return vmaxvq_u8(vorrq_u8(error, incomplete)) == 0; }
+};
+
+// Bit j set for each 0xFF lane j of v (lanes are 0xFF or 0).
+inline uint32_t utf8_mask8(uint8x8_t v) {
+    static const uint8_t kBits[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+    return vaddv_u8(vand_u8(v, vld1_u8(kBits)));
+}
+
+inline uint32_t utf8_mask16(uint8x16_t v) {
+    return utf8_mask8(vget_low_u8(v)) | utf8_mask8(vget_high_u8(v)) << 8;
+}
+
+// The lanes of u whose bit is set in the 8-bit mask m, packed to dst (8
+// units are stored); returns their count.
+inline size_t utf8_pack_units(uint16x8_t u, uint32_t m, const Utf8Tables& t, uint16_t* dst) {
+    vst1q_u16(dst, vreinterpretq_u16_u8(vqtbl1q_u8(vreinterpretq_u8_u16(u), vld1q_u8(t.pack16[m]))));
+    return (size_t)__builtin_popcount(m);
+}
+
+// Each 16-bit lane decoded as a character of 1 to 3 bytes b0 b1 b2. vsli
+// keeps the low 6 bits of the continuation and shifts out the lead's
+// length bits, all but those of a 2-byte lead.
+inline uint16x8_t utf8_units(uint16x8_t b0, uint16x8_t b1, uint16x8_t b2) {
+    uint16x8_t two = vsliq_n_u16(b1, b0, 6);
+    uint16x8_t three = vsliq_n_u16(b2, two, 6);
+    two = vandq_u16(two, vdupq_n_u16(0x7FF));
+    uint16x8_t u = vbslq_u16(vcgtq_u16(b0, vdupq_n_u16(0xBF)), two, b0);
+    return vbslq_u16(vcgtq_u16(b0, vdupq_n_u16(0xDF)), three, u);
+}
+
+// The 16 bytes at s, 2 more readable, without 4-byte characters.
+inline size_t utf8_to_utf16_bmp(const uint8_t* s, uint8x16_t in, const Utf8Tables& t, uint16_t* dst) {
+    uint8x16_t in1 = vld1q_u8(s + 1), in2 = vld1q_u8(s + 2);
+    uint32_t lead = utf8_mask16(vcgtq_s8(vreinterpretq_s8_u8(in), vdupq_n_s8(-65)));
+    uint16x8_t lo = utf8_units(vmovl_u8(vget_low_u8(in)), vmovl_u8(vget_low_u8(in1)), vmovl_u8(vget_low_u8(in2)));
+    uint16x8_t hi = utf8_units(vmovl_high_u8(in), vmovl_high_u8(in1), vmovl_high_u8(in2));
+    size_t k = utf8_pack_units(lo, lead & 0xFF, t, dst);
+    return k + utf8_pack_units(hi, lead >> 8, t, dst + k);
+}
+
+// Lanes [b3 b2 b1 b0] of 4 bytes from b0 up, b0 taken as a lead: its units
+// packed to dst as above. Two vsli steps put the payloads of all four
+// bytes side by side, b0 whole above them; the shift pair of b0's length
+// (kShift) then cuts out its code point. A lead followed by 3
+// continuations becomes a surrogate pair, high unit in the low half, and
+// keeps both units; invalid input has no more of those than groups of 4
+// bytes, so dst gets at most one unit per byte.
+inline size_t utf8_units_wide(uint32x4_t lanes, const Utf8Tables& t, uint16_t* dst) {
+    // Left and right shift for the high nibble of b0: the payload is bits
+    // 18..24, 12..22, 6..21 or 0..20 of the merged lane.
+    static const int8_t kShift[2][16] = {
+        {7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 9, 9, 10, 11},
+        {-25, -25, -25, -25, -25, -25, -25, -25, -25, -25, -25, -25, -21, -21, -16, -11}};
+    uint16x8_t h = vreinterpretq_u16_u32(lanes);
+    uint32x4_t v = vreinterpretq_u32_u16(vsliq_n_u16(h, vshrq_n_u16(h, 8), 6));
+    v = vsliq_n_u32(v, vshrq_n_u32(v, 16), 12);
+    uint8x16_t nib = vreinterpretq_u8_u32(vshrq_n_u32(lanes, 28));
+    v = vshlq_u32(v, vreinterpretq_s32_s8(vqtbl1q_s8(vld1q_s8(kShift[0]), nib)));
+    v = vshlq_u32(v, vreinterpretq_s32_s8(vqtbl1q_s8(vld1q_s8(kShift[1]), nib)));
+    uint32x4_t p = vsubq_u32(v, vdupq_n_u32(0x10000));
+    p = vandq_u32(vsliq_n_u32(vshrq_n_u32(p, 10), p, 16), vdupq_n_u32(0x03FF03FF));
+    p = vorrq_u32(p, vdupq_n_u32(0xDC00D800));
+    uint32x4_t pair = vceqq_u32(vandq_u32(lanes, vdupq_n_u32(0xF0C0C0C0)), vdupq_n_u32(0xF0808080));
+    uint32x4_t lead = vcgtq_s32(vreinterpretq_s32_u32(lanes), vdupq_n_s32((int32_t)0xBFFFFFFF));
+    uint32x4_t keep = vbslq_u32(vdupq_n_u32(0xFFFF), lead, pair);
+    uint32_t m = utf8_mask8(vmovn_u16(vreinterpretq_u16_u32(keep)));
+    return utf8_pack_units(vreinterpretq_u16_u32(vbslq_u32(pair, p, v)), m, t, dst);
+}
+
+// The 16 bytes at s, 3 more readable, with 4-byte characters.
+inline size_t utf8_to_utf16_wide(const uint8_t* s, uint8x16_t in, const Utf8Tables& t, uint16_t* dst) {
+    uint8x16_t in1 = vld1q_u8(s + 1), in2 = vld1q_u8(s + 2), in3 = vld1q_u8(s + 3);
+    uint16x8_t a = vreinterpretq_u16_u8(vzip1q_u8(in3, in2)), b = vreinterpretq_u16_u8(vzip1q_u8(in1, in));
+    uint16x8_t c = vreinterpretq_u16_u8(vzip2q_u8(in3, in2)), d = vreinterpretq_u16_u8(vzip2q_u8(in1, in));
+    size_t k = utf8_units_wide(vreinterpretq_u32_u16(vzip1q_u16(a, b)), t, dst);
+    k += utf8_units_wide(vreinterpretq_u32_u16(vzip2q_u16(a, b)), t, dst + k);
+    k += utf8_units_wide(vreinterpretq_u32_u16(vzip1q_u16(c, d)), t, dst + k);
+    return k + utf8_units_wide(vreinterpretq_u32_u16(vzip2q_u16(c, d)), t, dst + k);
+}
+
+// 4 units in 32-bit lanes, none a surrogate, to UTF-8 in dst (16 bytes are
+// stored); returns the bytes written.
+inline size_t utf16_encode_bmp_4(uint32x4_t u, const Utf8Tables& t, uint8_t* dst) {
+    static const uint32_t kBits[4] = {1, 2, 4, 8};
+    const uint32x4_t low6 = vdupq_n_u32(0x3F);
+    uint32x4_t two = vorrq_u32(vorrq_u32(vshrq_n_u32(u, 6), vshlq_n_u32(vandq_u32(u, low6), 8)),
+                               vdupq_n_u32(0x80C0));
+    uint32x4_t three = vorrq_u32(vorrq_u32(vshrq_n_u32(u, 12), vshlq_n_u32(vandq_u32(vshrq_n_u32(u, 6), low6), 8)),
+                                 vorrq_u32(vshlq_n_u32(vandq_u32(u, low6), 16), vdupq_n_u32(0x8080E0)));
+    uint32x4_t ge80 = vcgtq_u32(u, vdupq_n_u32(0x7F));
+    uint32x4_t ge800 = vcgtq_u32(u, vdupq_n_u32(0x7FF));
+    uint32x4_t w = vbslq_u32(ge800, three, vbslq_u32(ge80, two, u));
+    uint32_t idx = vaddvq_u32(vandq_u32(ge80, vld1q_u32(kBits))) | vaddvq_u32(vandq_u32(ge800, vld1q_u32(kBits))) << 4;
+    vst1q_u8(dst, vqtbl1q_u8(vreinterpretq_u8_u32(w), vld1q_u8(t.pack_utf8[idx])));
+    return t.pack_utf8_length[idx];
+}
+
+struct Utf8Codec {
+    static bool validate(const char* src, size_t n) {
+        const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+        Utf8Check check;
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) check.add(vld1q_u8(s + i));
+        if (i < n) check.add(load_tail_u8(s + i, n - i));   // zero bytes are ASCII
+        return check.ok();
+    }
+
+    static bool to_utf16(const char* src, size_t n, char16_t* dst, size_t* written) {
+        const Utf8Tables& t = utf8_tables();
+        const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+        uint16_t* d = reinterpret_cast<uint16_t*>(dst);
+        Utf8Check check;
+        size_t i = 0, k = 0;
+        *written = 0;
+        // A block reads 3 bytes past its end. k may lead the block by 3
+        // units after a character that crossed into it, and the last 8-unit
+        // store starts at most 3 units past the block's last 4 bytes.
+        for (; i + 23 <= n; i += 16) {
+            uint8x16_t in = vld1q_u8(s + i);
+            check.add(in);
+            uint8_t top = vmaxvq_u8(in);
+            if (top < 0x80) {
+                vst1q_u16(d + k, vmovl_u8(vget_low_u8(in)));
+                vst1q_u16(d + k + 8, vmovl_high_u8(in));
+                k += 16;
+            } else if (top < 0xF0) {
+                k += utf8_to_utf16_bmp(s + i, in, t, d + k);
+            } else {
+                k += utf8_to_utf16_wide(s + i, in, t, d + k);
+            }
+        }
+        for (size_t j = i; j < n; j += 16) check.add(n - j >= 16 ? vld1q_u8(s + j) : load_tail_u8(s + j, n - j));
+        // Skip the end of the character the last block decoded.
+        while (i < n && (s[i] & 0xC0) == 0x80) ++i;
+        if (!utf8_to_utf16_scalar(s, &i, n, n, dst, &k) || !check.ok()) return false;
+        *written = k;
+        return true;
+    }
+
+    static bool to_utf8(const char16_t* src, size_t n, char* dst, size_t* written) {
+        const Utf8Tables& t = utf8_tables();
+        const uint16_t* s = reinterpret_cast<const uint16_t*>(src);
+        uint8_t* d = reinterpret_cast<uint8_t*>(dst);
+        size_t i = 0, k = 0;
+        *written = 0;
+        // The last 16-byte store of a block may pass its 3 bytes per unit by 4.
+        while (i + 10 <= n) {
+            uint16x8_t v = vld1q_u16(s + i);
+            uint16x8_t sur = vceqq_u16(vandq_u16(v, vdupq_n_u16(0xF800)), vdupq_n_u16(0xD800));
+            if (vmaxvq_u16(v) < 0x80) {
+                vst1_u8(d + k, vmovn_u16(v));
+                k += 8;
+                i += 8;
+            } else if (vmaxvq_u16(sur) == 0) {
+                k += utf16_encode_bmp_4(vmovl_u16(vget_low_u16(v)), t, d + k);
+                k += utf16_encode_bmp_4(vmovl_high_u16(v), t, d + k);
+                i += 8;
+            } else if (!utf16_to_utf8_scalar(src, &i, i + 8, n, dst, &k)) {
+                return false;
+            }
+        }
+        if (!utf16_to_utf8_scalar(src, &i, n, n, dst, &k)) return false;
+        *written = k;
+        return true;
+    }
+};
+
+typedef simd::Utf8Validator<Utf8Codec> Utf8Validator;
+typedef simd::Utf8ToUtf16<Utf8Codec> Utf8ToUtf16;
+typedef simd::Utf16ToUtf8<Utf8Codec> Utf16ToUtf8;
+
+// Whether n bytes are valid UTF-8.
+inline bool utf8_validate(const char* src, size_t n) {
+    return Utf8Codec::validate(src, n);
+}
+
+// Transcodes n bytes of UTF-8 into dst, which needs room for n units, and
+// sets *written; false, with *written 0, if src is not valid UTF-8.
+inline bool utf8_to_utf16(const char* src, size_t n, char16_t* dst, size_t* written) {
+    return Utf8Codec::to_utf16(src, n, dst, written);
+}
+
+// Transcodes n units of UTF-16 into dst, which needs room for 3 * n bytes,
+// and sets *written; false, with *written 0, on an unpaired surrogate.
+inline bool utf16_to_utf8(const char16_t* src, size_t n, char* dst, size_t* written) {
+    return Utf8Codec::to_utf8(src, n, dst, written);
+}
+
+} // namespace neon
+} // namespace simd
+
+#endif // UTF8_NEON_H
@@ -0,0 +1,246 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include "checksum_neon.h"
+#include "guard_page.h"
+
+namespace {
+
+typedef simd::neon::ChecksumCodec Codec;
+typedef simd::ChecksumScalarCodec ScalarCodec;
+typedef std::vector<uint8_t> Bytes;
+
+// References written from the definitions: CRC-32C a bit at a time, Adler-32
+// a byte at a time with a reduction per byte, and hash64 from the steps in
+// checksum.h with none of the codecs' blocking.
+uint32_t reference_crc32c(const Bytes& s, uint32_t crc) {
+    uint32_t c = ~crc;
+    for (uint8_t b : s) {
+        c ^= b;
+        for (int k = 0; k < 8; ++k) c = c >> 1 ^ (c & 1 ? 0x82F63B78u : 0);
+    }
+    return ~c;
+}
+
+uint32_t reference_adler32(const Bytes& s, uint32_t adler) {
+    uint32_t a = adler & 0xFFFF, b = adler >> 16;
+    for (uint8_t x : s) {
+        a = (a + x) % 65521;
+        b = (b + a) % 65521;
+    }
+    return b << 16 | a;
+}
+
+uint64_t reference_hash64(const Bytes& s, uint64_t seed) {
+    uint64_t key[24], acc[8];
+    for (int j = 0; j < 24; ++j) key[j] = j % 2 ? simd::kHash64Secret[j] - seed : simd::kHash64Secret[j] + seed;
+    for (int i = 0; i < 8; ++i) acc[i] = simd::kHash64Init[i];
+    Bytes padded = s;
+    padded.resize((s.size() + 63) / 64 * 64);
+    for (size_t s0 = 0; s0 < padded.size(); s0 += 64) {
+        size_t p = s0 / 64 % 16;
+        for (int i = 0; i < 8; ++i) {
+            uint64_t d = 0;
+            for (int b = 7; b >= 0; --b) d = d << 8 | padded[s0 + 8 * i + b];
+            uint64_t dk = d ^ key[p + i];
+            acc[i ^ 1] += d;
+            acc[i] += (dk & 0xFFFFFFFF) * (dk >> 32);
+        }
+        if (p == 15) {
+            for (int i = 0; i < 8; ++i) acc[i] = (acc[i] ^ acc[i] >> 47 ^ key[16 + i]) * 0x9E3779B1ull;
+        }
+    }
+    uint64_t h = s.size() * 0x9E3779B185EBCA87ull;
+    for (int i = 0; i < 8; i += 2) {
+        uint64_t m0, m1;
+        std::memcpy(&m0, (const uint8_t*)key + 11 + 8 * i, 8);
+        std::memcpy(&m1, (const uint8_t*)key + 19 + 8 * i, 8);
+        unsigned __int128 p = (unsigned __int128)(acc[i] ^ m0) * (acc[i + 1] ^ m1);
+        h += (uint64_t)p ^ (uint64_t)(p >> 64);
+    }
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ull;
+    return h ^ h >> 32;
+}
+
+Bytes random_bytes(size_t n, std::mt19937& rng) {
+    Bytes s(n);
+    for (uint8_t& b : s) b = (uint8_t)rng();
+    return s;
+}
+
+// Input and output end at guard pages, so any read or write out of bounds
+// faults. 1 MiB and more at any page size up to 64 KiB.
+GuardedBuffer g_in(320), g_out(320);
+
+// Each checksum of s and its copy form, from an input that ends at a guard
+// page into an output that ends at one.
+template <typename C>
+bool check_one(const Bytes& s, uint32_t start, uint64_t seed) {
+    uint8_t* in = g_in.end() - s.size();
+    uint8_t* out = g_out.end() - s.size();
+    if (!s.empty()) std::memcpy(in, s.data(), s.size());
+    uint32_t crc = reference_crc32c(s, start), adler = reference_adler32(s, start % 65521 * 65537);
+    uint64_t hash = reference_hash64(s, seed);
+    if (C::crc32c(in, s.size(), start, nullptr) != crc) return false;
+    if (C::adler32(in, s.size(), start % 65521 * 65537, nullptr) != adler) return false;
+    if (simd::hash64_with<C>(in, s.size(), seed, nullptr) != hash) return false;
+
+    std::memset(out, 0, s.size());
+    if (C::crc32c(in, s.size(), start, out) != crc || !std::equal(s.begin(), s.end(), out)) return false;
+    std::memset(out, 0, s.size());
+    if (C::adler32(in, s.size(), start % 65521 * 65537, out) != adler) return false;
+    if (!std::equal(s.begin(), s.end(), out)) return false;
+    std::memset(out, 0, s.size());
+    if (simd::hash64_with<C>(in, s.size(), seed, out) != hash) return false;
+    return std::equal(s.begin(), s.end(), out);
+}
+
+template <typename C>
+bool check_checksums() {
+    // Published values: RFC 3720 B.4 for CRC-32C, and "Wikipedia" for Adler-32.
+    const char* digits = "123456789";
+    if (C::crc32c((const uint8_t*)digits, 9, 0, nullptr) != 0xE3069283u) return false;
+    Bytes zeros(32, 0), ones(32, 0xFF);
+    if (C::crc32c(zeros.data(), 32, 0, nullptr) != 0x8A9136AAu) return false;
+    if (C::crc32c(ones.data(), 32, 0, nullptr) != 0x62A8AB43u) return false;
+    if (C::adler32((const uint8_t*)"Wikipedia", 9, 1, nullptr) != 0x11E60398u) return false;
+
+    std::mt19937 rng(1);
+    for (size_t n = 0; n <= 600; ++n) {
+        if (!check_one<C>(random_bytes(n, rng), rng(), rng())) return false;
+    }
+    for (size_t n : {4096, 5551, 5552, 5553, 65536 + 7, 1 << 20}) {
+        if (!check_one<C>(random_bytes(n, rng), rng(), rng())) return false;
+    }
+    // All 0xFF from the largest start: the sums of Adler-32 at their highest.
+    Bytes high(100000, 0xFF);
+    return C::adler32(high.data(), high.size(), 0xFFF0FFF0, nullptr) == reference_adler32(high, 0xFFF0FFF0);
+}
+
+// Pieces of random size: the checksums must not depend on where the input
+// is cut.
+template <typename C>
+bool check_streaming() {
+    std::mt19937 rng(2);
+    for (int round = 0; round < 200; ++round) {
+        Bytes s = random_bytes(rng() % 5000, rng);
+        uint64_t seed = rng();
+        Bytes out(s.size());
+        uint32_t crc = 0, adler = 1;
+        simd::Hash64<C> h(seed), c(seed);
+        for (size_t i = 0; i < s.size();) {
+            size_t piece = std::min(s.size() - i, (size_t)(rng() % 300));
+            crc = C::crc32c(s.data() + i, piece, crc, nullptr);
+            adler = C::adler32(s.data() + i, piece, adler, nullptr);
+            h.update(s.data() + i, piece);
+            c.copy(out.data() + i, s.data() + i, piece);
+            i += piece;
+        }
+        if (crc != reference_crc32c(s, 0) || adler != reference_adler32(s, 1)) return false;
+        uint64_t hash = reference_hash64(s, seed);
+        if (h.digest() != hash || c.digest() != hash || out != s) return false;
+        h.reset();
+        h.update(s.data(), s.size());
+        if (h.digest() != hash) return false;
+    }
+    return true;
+}
+
+template <typename F>
+double gb_per_s(size_t bytes, F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 5; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return bytes / best / 1e9;
+}
+
+volatile uint64_t g_sink;
+
+template <typename C>
+void bench(const char* name, const Bytes& small) {
+    const uint8_t* p = small.data();
+    size_t n = small.size();
+    double crc = gb_per_s(n, [&] { g_sink = C::crc32c(p, n, 0, nullptr); });
+    double adler = gb_per_s(n, [&] { g_sink = C::adler32(p, n, 1, nullptr); });
+    double hash = gb_per_s(n, [&] { g_sink = simd::hash64_with<C>(p, n, 0, nullptr); });
+    std::cout << std::setw(7) << name << std::setw(10) << crc << std::setw(10) << adler << std::setw(10) << hash
+              << std::endl;
+}
+
+} // namespace
+
+int main() {
+    if (!g_in.base || !g_out.base) {
+        std::cout << "mmap failed" << std::endl;
+        return 1;
+    }
+    bool ok = check_checksums<ScalarCodec>() && check_streaming<ScalarCodec>();
+    std::cout << "scalar CRC-32C, Adler-32, hash64 vs reference, guarded: " << (ok ? "OK" : "MISMATCH") << std::endl;
+    bool good = check_checksums<Codec>() && check_streaming<Codec>();
+    std::cout << "  NEON CRC-32C, Adler-32, hash64 vs reference, guarded: " << (good ? "OK" : "MISMATCH")
+              << std::endl;
+    ok = ok && good;
+#if defined(__ARM_FEATURE_CRC32) && defined(__ARM_FEATURE_AES)
+    std::cout << "crc32c: CRC32CX with PMULL folding" << std::endl;
+#elif defined(__ARM_FEATURE_CRC32)
+    std::cout << "crc32c: CRC32CX" << std::endl;
+#else
+    std::cout << "crc32c: slicing-by-8 (build with +crc for CRC32CX)" << std::endl;
+#endif
+
+    // In cache: the speed of each checksum alone.
+    std::mt19937 rng(3);
+    Bytes small = random_bytes((size_t)1 << 20, rng);
+    std::cout << std::endl << "1 MiB in cache, GB/s:" << std::fixed << std::setprecision(2) << std::endl;
+    std::cout << std::setw(7) << "" << std::setw(10) << "crc32c" << std::setw(10) << "adler32" << std::setw(10)
+              << "hash64" << std::endl;
+    bench<ScalarCodec>("scalar", small);
+    bench<Codec>("neon", small);
+
+    // Out of cache: a copy and then a checksum read the source twice; the
+    // fused copy reads it once.
+    size_t big = (size_t)256 << 20;
+    uint8_t* src = static_cast<uint8_t*>(std::malloc(big));
+    uint8_t* dst = static_cast<uint8_t*>(std::malloc(big));
+    if (!src || !dst) {
+        std::cout << "malloc failed" << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i < big; i += 8) std::memcpy(src + i, &i, 8);
+    std::memset(dst, 0, big);
+    std::cout << std::endl << "256 MiB copy, GB/s:" << std::endl;
+    std::cout << std::setw(10) << "" << std::setw(16) << "copy, then sum" << std::setw(10) << "fused" << std::endl;
+    double two = gb_per_s(big, [&] {
+        std::memcpy(dst, src, big);
+        g_sink = simd::neon::crc32c(src, big);
+    });
+    double one = gb_per_s(big, [&] { g_sink = simd::neon::copy_crc32c(dst, src, big); });
+    std::cout << std::setw(10) << "crc32c" << std::setw(16) << two << std::setw(10) << one << std::endl;
+    two = gb_per_s(big, [&] {
+        std::memcpy(dst, src, big);
+        g_sink = simd::neon::adler32(src, big);
+    });
+    one = gb_per_s(big, [&] { g_sink = simd::neon::copy_adler32(dst, src, big); });
+    std::cout << std::setw(10) << "adler32" << std::setw(16) << two << std::setw(10) << one << std::endl;
+    two = gb_per_s(big, [&] {
+        std::memcpy(dst, src, big);
+        g_sink = simd::neon::hash64(src, big);
+    });
+    one = gb_per_s(big, [&] { g_sink = simd::neon::copy_hash64(dst, src, big); });
+    std::cout << std::setw(10) << "hash64" << std::setw(16) << two << std::setw(10) << one << std::endl;
+    std::free(src);
+    std::free(dst);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include "hash_map_neon.h"
+
+namespace {
+
+// Against std::unordered_map, from an empty map so every rehash is crossed.
+bool check() {
+    std::mt19937_64 rng(7);
+    simd::neon::HashMap map;
+    std::unordered_map<uint64_t, uint64_t> ref;
+    const size_t n = 100000;
+    std::vector<uint64_t> keys(n), values(n);
+    std::vector<uint8_t> inserted(n), found(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = rng() % (n / 2);  // repeats, in and across batches
+        values[i] = rng();
+    }
+    for (size_t i0 = 0; i0 < n; i0 += 1000) {
+        size_t added = map.insert(keys.data() + i0, values.data() + i0, 1000, inserted.data() + i0);
+        size_t expect = 0;
+        for (size_t i = i0; i < i0 + 1000; ++i) {
+            bool is_new = ref.emplace(keys[i], values[i]).second;
+            if (inserted[i] != is_new) return false;
+            expect += is_new;
+        }
+        if (added != expect) return false;
+    }
+    map.add(keys.data(), values.data(), n);
+    for (size_t i = 0; i < n; ++i) ref[keys[i]] += values[i];
+    if (map.size() != ref.size()) return false;
+
+    std::vector<uint64_t> probes(n), got(n);
+    for (size_t i = 0; i < n; ++i) probes[i] = rng() % n;
+    size_t hits = map.find(probes.data(), n, got.data(), found.data());
+    size_t expect = 0;
+    for (size_t i = 0; i < n; ++i) {
+        auto it = ref.find(probes[i]);
+        if (found[i] != (it != ref.end())) return false;
+        if (found[i] && got[i] != it->second) return false;
+        expect += found[i];
+    }
+    if (hits != expect) return false;
+
+    size_t seen = 0;
+    bool same = true;
+    map.for_each([&](uint64_t k, uint64_t v) {
+        auto it = ref.find(k);
+        same = same && it != ref.end() && it->second == v;
+        ++seen;
+    });
+    uint64_t v;
+    return same && seen == ref.size() && !map.insert(keys[0], 1) && map.find(keys[0], &v) && v == ref[keys[0]];
+}
+
+template <typename F>
+double seconds(F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 3; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return best;
+}
+
+// Lookups of which half hit, in random order.
+void bench(size_t n) {
+    std::mt19937_64 rng(1);
+    std::vector<uint64_t> keys(n), probes(n), values(n);
+    std::vector<uint8_t> found(n);
+    for (auto& k : keys) k = rng();
+    for (size_t i = 0; i < n; ++i) probes[i] = i % 2 ? keys[rng() % n] : rng();
+
+    std::unordered_map<uint64_t, uint64_t> ref(n);
+    for (uint64_t k : keys) ref.emplace(k, k);
+    simd::neon::HashMap map(n);
+    map.insert(keys.data(), keys.data(), n);
+
+    uint64_t sink = 0;
+    double t_std = seconds([&] {
+        for (uint64_t p : probes) {
+            auto it = ref.find(p);
+            if (it != ref.end()) sink += it->second;
+        }
+    });
+    double t_one = seconds([&] {
+        for (uint64_t p : probes) {
+            uint64_t v;
+            if (map.find(p, &v)) sink += v;
+        }
+    });
+    double t_batch = seconds([&] {
+        for (size_t i = 0; i < n; i += 1024) {
+            size_t m = n - i < 1024 ? n - i : 1024;
+            map.find(probes.data() + i, m, values.data() + i, found.data() + i);
+        }
+    });
+    std::cout << "  " << std::setw(9) << n << " keys: unordered_map " << std::setw(6) << n / t_std / 1e6
+              << ", one at a time " << std::setw(6) << n / t_one / 1e6 << ", batched " << std::setw(6)
+              << n / t_batch / 1e6 << " M lookups/s" << (sink == 1 ? " " : "") << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::fixed << std::setprecision(1);
+    bool ok = check();
+    std::cout << "HashMap vs std::unordered_map: " << (ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl << "Lookups, half hits:" << std::endl;
+    for (size_t n : {(size_t)1 << 14, (size_t)1 << 20, (size_t)1 << 24}) bench(n);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <arm_neon.h>
+#include "interleave_neon.h"
+
+// Helper function to print the first `count` elements of an array
+template <typename T>
+void print_array(const T* data, size_t count, const std::string& label) {
+    std::cout << label << ": ";
+    for (size_t i = 0; i < count; ++i) {
+        std::cout << +data[i] << " ";
+    }
+    std::cout << std::endl;
+}
+
+// Splits and re-merges every record count up to 100 for 1 to 5 channels and
+// compares with the definition.
+template <typename T>
+bool check_type() {
+    const size_t max_n = 100, max_c = 5;
+    std::vector<T> aos(max_n * max_c), back(max_n * max_c);
+    for (size_t i = 0; i < aos.size(); ++i) aos[i] = (T)(i * 7 + 1);
+    std::vector<std::vector<T> > planes(max_c, std::vector<T>(max_n));
+    for (size_t channels = 1; channels <= max_c; ++channels) {
+        T* p[max_c];
+        const T* cp[max_c];
+        for (size_t c = 0; c < channels; ++c) {
+            p[c] = planes[c].data();
+            cp[c] = planes[c].data();
+        }
+        for (size_t n = 0; n <= max_n; ++n) {
+            simd::neon::deinterleave(aos.data(), n, channels, p);
+            for (size_t r = 0; r < n; ++r)
+                for (size_t c = 0; c < channels; ++c)
+                    if (planes[c][r] != aos[r * channels + c]) return false;
+            simd::neon::interleave(cp, n, channels, back.data());
+            for (size_t i = 0; i < n * channels; ++i)
+                if (back[i] != aos[i]) return false;
+        }
+    }
+    return true;
+}
+
+// --- Demonstration Functions ---
+
+void rgb_to_planes() {
+    std::cout << "\n--- RGB Pixels to Planes and Back (u8, 3 channels) ---" << std::endl;
+    // Not a multiple of the vector length on purpose.
+    const size_t pixels = 19;
+    std::vector<uint8_t> rgb(3 * pixels);
+    for (size_t i = 0; i < pixels; ++i) {
+        rgb[3 * i + 0] = (uint8_t)(100 + i);
+        rgb[3 * i + 1] = (uint8_t)(150 + i);
+        rgb[3 * i + 2] = (uint8_t)(200 + i);
+    }
+    std::vector<uint8_t> r(pixels), g(pixels), b(pixels);
+    uint8_t* planes[3] = {r.data(), g.data(), b.data()};
+    simd::neon::deinterleave(rgb.data(), pixels, 3, planes);
+    print_array(r.data(), pixels, "R");
+    print_array(g.data(), pixels, "G");
+    print_array(b.data(), pixels, "B");
+
+    std::vector<uint8_t> merged(3 * pixels);
+    const uint8_t* const_planes[3] = {r.data(), g.data(), b.data()};
+    simd::neon::interleave(const_planes, pixels, 3, merged.data());
+    std::cout << "Round trip: " << (merged == rgb ? "OK" : "MISMATCH") << std::endl;
+}
+
+void verify_types() {
+    std::cout << "\n--- Cross-check against the Definition ---" << std::endl;
+    std::cout << "u8:  " << (check_type<uint8_t>() ? "OK" : "MISMATCH") << std::endl;
+    std::cout << "u16: " << (check_type<uint16_t>() ? "OK" : "MISMATCH") << std::endl;
+    std::cout << "s32: " << (check_type<int32_t>() ? "OK" : "MISMATCH") << std::endl;
+    std::cout << "f32: " << (check_type<float>() ? "OK" : "MISMATCH") << std::endl;
+}
+
+int main() {
+    rgb_to_planes();
+    verify_types();
+
+    return 0;
+}
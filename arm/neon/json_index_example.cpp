@@ -0,0 +1,204 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include "json_index_neon.h"
+#include "guard_page.h"
+
+namespace {
+
+typedef simd::neon::JsonCodec Codec;
+typedef simd::JsonScalarCodec ScalarCodec;
+
+// Reference indexer: one byte at a time with an explicit state machine,
+// independent of the bit tricks of the codecs. A backslash escapes the next
+// byte anywhere, as in the codecs; outside a string that only matters to a
+// quote, and such input is invalid JSON anyway.
+bool reference_index(const std::string& s, std::vector<uint32_t>* pos) {
+    pos->clear();
+    bool in_string = false, escaped = false, after_scalar = false, error = false;
+    for (size_t i = 0; i < s.size(); ++i) {
+        char c = s[i];
+        bool quote = c == '"' && !escaped;
+        escaped = c == '\\' && !escaped;
+        if (in_string) {
+            if ((uint8_t)c < 0x20) error = true;
+            if (quote) in_string = false;
+            after_scalar = false;
+            continue;
+        }
+        if (std::strchr("{}[]:,", c) && c != '\0') {
+            pos->push_back((uint32_t)i);
+            after_scalar = false;
+        } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            after_scalar = false;
+        } else {
+            if (!after_scalar) pos->push_back((uint32_t)i);
+            after_scalar = !quote;
+            in_string = quote;
+        }
+    }
+    return !error && !in_string;
+}
+
+// Input and output end at guard pages, so any read or write out of bounds
+// faults; out has room for exactly n positions.
+GuardedBuffer g_in(32), g_out(128);
+
+template <typename C>
+bool index_guarded(const std::string& s, std::vector<uint32_t>* pos) {
+    char* in = reinterpret_cast<char*>(g_in.end()) - s.size();
+    if (!s.empty()) std::memcpy(in, s.data(), s.size());
+    uint32_t* out = reinterpret_cast<uint32_t*>(g_out.end()) - s.size();
+    size_t k = 0;
+    bool ok = simd::json_index_with<C>(in, s.size(), out, &k);
+    pos->assign(out, out + k);
+    return ok;
+}
+
+// Log records of the kind the indexer is for: one object per line, strings
+// with escapes and non-ASCII, numbers, literals and nesting.
+std::string random_record(std::mt19937& rng) {
+    static const char* const kWords[] = {"GET", "POST", "/api/v1/items", "timeout", "caf\xC3\xA9",
+                                         "\xE6\x97\xA5\xE6\x9C\xAC", "say \\\"hi\\\"", "C:\\\\tmp\\\\", "\\u00e9",
+                                         "tab\\there", "a,b:c", "{[x]}"};
+    std::string s = "{\"ts\":" + std::to_string(1700000000 + rng() % 1000000) + ",\"level\":\"";
+    s += rng() % 4 ? "info" : "error";
+    s += "\",\"msg\":\"";
+    for (int w = (int)(rng() % 6); w >= 0; --w) {
+        s += kWords[rng() % 12];
+        s += ' ';
+    }
+    s += "\", \"tags\": [";
+    for (int j = (int)(rng() % 4); j > 0; --j) s += j % 2 ? "true, " : "null , ";
+    s += std::to_string((int)(rng() % 2000) - 1000) + "." + std::to_string(rng() % 100);
+    s += "], \"ctx\": {\"id\": " + std::to_string(rng()) + ", \"ok\": false}}\n";
+    return s;
+}
+
+std::string random_records(size_t bytes, std::mt19937& rng) {
+    std::string s;
+    while (s.size() < bytes) s += random_record(rng);
+    return s;
+}
+
+// Bytes from the characters that matter, heavy in quotes and backslashes so
+// that runs of every length cross block boundaries.
+std::string random_soup(size_t n, std::mt19937& rng) {
+    static const char kChars[] = "\"\"\"\\\\\\\\{}[]:, \t\n\r0a-\x01\x1F\x80\xFF";
+    std::string s(n, ' ');
+    for (char& c : s) c = kChars[rng() % (sizeof kChars - 1)];
+    return s;
+}
+
+template <typename C>
+bool check_one(const std::string& s) {
+    std::vector<uint32_t> want, got;
+    bool ok = reference_index(s, &want);
+    return index_guarded<C>(s, &got) == ok && got == want;
+}
+
+template <typename C>
+bool check_index() {
+    // A fixed document with its positions written out by hand.
+    const std::string doc = "{\"a\": [1, true, \"x\\\"y\"], \"b\": null}";
+    const std::vector<uint32_t> want = {0, 1, 4, 6, 7, 8, 10, 14, 16, 22, 23, 25, 28, 30, 34};
+    std::vector<uint32_t> got;
+    if (!index_guarded<C>(doc, &got) || got != want) return false;
+
+    std::mt19937 rng(1);
+    for (size_t n = 0; n <= 300; ++n) {
+        if (!check_one<C>(random_soup(n, rng))) return false;
+        std::string r = random_records(n, rng);
+        if (!check_one<C>(r.substr(0, n))) return false;
+    }
+    for (size_t n : {(size_t)4096, (size_t)4097, (size_t)65536 + 33}) {
+        if (!check_one<C>(random_soup(n, rng)) || !check_one<C>(random_records(n, rng).substr(0, n))) return false;
+    }
+    // A run of 0..130 backslashes before a quote, at every offset in a block.
+    for (size_t run = 0; run <= 130; ++run) {
+        for (size_t at = 0; at < 64; ++at) {
+            if (!check_one<C>(std::string(at, ' ') + "[\"" + std::string(run, '\\') + "\"] 1")) return false;
+        }
+    }
+    // A control byte inside a string is an error, and so is an open string.
+    if (!check_one<C>("[\"a\tb\"]") || index_guarded<C>("[\"a\tb\"]", &got)) return false;
+    if (index_guarded<C>("[\"abc", &got) || !index_guarded<C>("[\"abc\"]\t\n", &got)) return false;
+    return true;
+}
+
+template <typename C>
+bool check_streaming() {
+    std::mt19937 rng(3);
+    for (int round = 0; round < 200; ++round) {
+        std::string s = round % 2 ? random_soup(rng() % 3000, rng) : random_records(rng() % 3000, rng);
+        std::vector<uint32_t> want;
+        bool valid = reference_index(s, &want);
+
+        simd::JsonIndexer<C> ix;
+        std::vector<uint32_t> pos(s.size() + 1);
+        size_t k = 0, got = 0;
+        for (size_t i = 0; i < s.size();) {
+            size_t piece = std::min(s.size() - i, (size_t)(rng() % 150));
+            ix.update(s.data() + i, piece, pos.data() + k, &got);
+            k += got;
+            i += piece;
+        }
+        pos.resize(k);
+        if (ix.finish() != valid || pos != want) return false;
+    }
+    return true;
+}
+
+template <typename F>
+double gb_per_s(size_t bytes, F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 5; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return bytes / best / 1e9;
+}
+
+template <typename C>
+size_t bench(const char* name, const std::string& logs) {
+    std::vector<uint32_t> pos(logs.size());
+    size_t count = 0;
+    double rate = gb_per_s(logs.size(), [&] {
+        simd::JsonIndexState state = {0, 0, 0, 0};
+        count = C::index(logs.data(), logs.size(), 0, &state, pos.data());
+    });
+    std::cout << std::setw(7) << name << std::setw(10) << rate << std::endl;
+    return count;
+}
+
+} // namespace
+
+int main() {
+    if (!g_in.base || !g_out.base) {
+        std::cout << "mmap failed" << std::endl;
+        return 1;
+    }
+    bool ok = check_index<ScalarCodec>() && check_streaming<ScalarCodec>();
+    std::cout << "scalar JSON structural index vs reference, guarded: " << (ok ? "OK" : "MISMATCH") << std::endl;
+    bool good = check_index<Codec>() && check_streaming<Codec>();
+    std::cout << "  NEON JSON structural index vs reference, guarded: " << (good ? "OK" : "MISMATCH") << std::endl;
+    ok = ok && good;
+
+    std::mt19937 rng(4);
+    std::string logs = random_records((size_t)1 << 20, rng);
+    std::cout << std::endl << "1 MiB of JSON log records, GB/s:" << std::fixed << std::setprecision(2) << std::endl;
+    bench<ScalarCodec>("scalar", logs);
+    size_t count = bench<Codec>("neon", logs);
+    std::cout << count << " positions, one per " << std::setprecision(1) << (double)logs.size() / count
+              << " bytes" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+#include <iostream>
+#include <cstdint>
+#include <arm_neon.h>
+#include "guard_page.h"
+#include "safe_load_neon.h"
+
+namespace {
+
+// Count of bytes equal to c, with the tail as one more vector. The lanes past
+// the end load as 0, so the tail's matches are masked to its first r lanes.
+size_t count_byte(const uint8_t* p, size_t n, uint8_t c) {
+    static const uint8_t kLane[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    const uint8x16_t vc = vdupq_n_u8(c);
+    size_t i = 0, count = 0;
+    for (; i + 16 <= n; i += 16) count += vaddvq_u8(vandq_u8(vceqq_u8(vld1q_u8(p + i), vc), vdupq_n_u8(1)));
+    if (i < n) {
+        uint8x16_t in = vcltq_u8(vld1q_u8(kLane), vdupq_n_u8((uint8_t)(n - i)));
+        uint8x16_t eq = vandq_u8(vceqq_u8(simd::neon::load_tail_u8(p + i, n - i), vc), in);
+        count += vaddvq_u8(vandq_u8(eq, vdupq_n_u8(1)));
+    }
+    return count;
+}
+
+// Every tail length, ending at every distance up to two vectors from a guard
+// page and starting right after one. Getting to the end without SIGSEGV is
+// half the check.
+bool check_load_tail(const GuardedBuffer& after, const GuardedBuffer& before) {
+    uint8_t out[16];
+    for (size_t r = 0; r <= 16; ++r) {
+        for (size_t gap = 0; gap <= 32; ++gap) {
+            const uint8_t* p = after.end() - gap - r;
+            vst1q_u8(out, simd::neon::load_tail_u8(p, r));
+            for (size_t j = 0; j < 16; ++j) {
+                if (out[j] != (j < r ? p[j] : 0)) return false;
+            }
+        }
+        vst1q_u8(out, simd::neon::load_tail_u8(before.base, r));
+        for (size_t j = 0; j < 16; ++j) {
+            if (out[j] != (j < r ? before.base[j] : 0)) return false;
+        }
+    }
+    return true;
+}
+
+bool check_count(const GuardedBuffer& after) {
+    for (size_t n = 0; n <= 100; ++n) {
+        const uint8_t* p = after.end() - n;
+        size_t want = 0;
+        for (size_t i = 0; i < n; ++i) want += p[i] == 3;
+        if (count_byte(p, n, 3) != want) return false;
+        // 0 also matches the cleared lanes past the end.
+        want = 0;
+        for (size_t i = 0; i < n; ++i) want += p[i] == 0;
+        if (count_byte(p, n, 0) != want) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    GuardedBuffer after(2), before(2, true);
+    if (!after.base || !before.base) {
+        std::cout << "mmap failed" << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i < after.size; ++i) after.base[i] = before.base[i] = (uint8_t)(i * 7 % 11);
+    bool ok = check_load_tail(after, before);
+    std::cout << "load_tail_u8 against guard pages: " << (ok ? "OK" : "MISMATCH") << std::endl;
+    bool counted = check_count(after);
+    std::cout << "count_byte with a vector tail: " << (counted ? "OK" : "MISMATCH") << std::endl;
+    return ok && counted ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <arm_neon.h>
+#include "transpose_neon.h"
+
+namespace {
+
+template <typename T>
+bool check_type() {
+    const size_t shapes[][2] = {{1, 1}, {3, 5}, {4, 4}, {8, 8}, {16, 16}, {15, 17}, {17, 33}, {100, 37}, {130, 70}};
+    for (const auto& shape : shapes) {
+        size_t rows = shape[0], cols = shape[1];
+        for (size_t pad : {(size_t)0, (size_t)3}) {
+            size_t ss = cols + pad, ds = rows + pad;
+            std::vector<T> src(rows * ss), dst(cols * ds + 1, (T)7);
+            for (size_t i = 0; i < src.size(); ++i) src[i] = (T)(i * 31 + 1);
+            simd::neon::transpose(src.data(), rows, cols, ss, dst.data(), ds);
+            for (size_t r = 0; r < rows; ++r) {
+                for (size_t c = 0; c < cols; ++c) {
+                    if (dst[c * ds + r] != src[r * ss + c]) return false;
+                }
+            }
+            if (dst[cols * ds] != (T)7) return false;
+        }
+    }
+    return true;
+}
+
+// The in-register blocks on their own: rows in, columns out.
+bool check_blocks() {
+    uint8_t m[16 * 16], t[16 * 16];
+    for (int i = 0; i < 256; ++i) m[i] = (uint8_t)i;
+    uint8x8_t r8[8];
+    for (int k = 0; k < 8; ++k) r8[k] = vld1_u8(m + 16 * k);
+    simd::neon::transpose8x8(r8);
+    for (int k = 0; k < 8; ++k) vst1_u8(t + 8 * k, r8[k]);
+    for (int r = 0; r < 8; ++r)
+        for (int c = 0; c < 8; ++c)
+            if (t[c * 8 + r] != m[r * 16 + c]) return false;
+    uint8x16_t r16[16];
+    for (int k = 0; k < 16; ++k) r16[k] = vld1q_u8(m + 16 * k);
+    simd::neon::transpose16x16(r16);
+    for (int k = 0; k < 16; ++k) vst1q_u8(t + 16 * k, r16[k]);
+    for (int r = 0; r < 16; ++r)
+        for (int c = 0; c < 16; ++c)
+            if (t[c * 16 + r] != m[r * 16 + c]) return false;
+    return true;
+}
+
+template <typename F>
+double gbps(size_t bytes, F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 3; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return bytes / best / 1e9;
+}
+
+template <typename T>
+void bench(const char* name, size_t n) {
+    std::vector<T> src(n * n), dst(n * n);
+    for (size_t i = 0; i < src.size(); ++i) src[i] = (T)i;
+    size_t bytes = 2 * n * n * sizeof(T);
+    double naive = gbps(bytes, [&] {
+        for (size_t r = 0; r < n; ++r)
+            for (size_t c = 0; c < n; ++c) dst[c * n + r] = src[r * n + c];
+    });
+    double neon = gbps(bytes, [&] { simd::neon::transpose(src.data(), n, n, n, dst.data(), n); });
+    std::cout << "  " << name << " " << n << " x " << n << ": naive " << std::setw(6) << naive << " GB/s, NEON "
+              << std::setw(6) << neon << " GB/s (" << neon / naive << "x)" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::fixed << std::setprecision(2);
+    bool ok = check_blocks() && check_type<float>() && check_type<uint8_t>();
+    std::cout << "Transposes vs definition: " << (ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl << "Transpose, GB/s (read + write):" << std::endl;
+    bench<float>("f32", 4000);
+    bench<uint8_t>("u8 ", 8000);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,350 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include "utf8_neon.h"
+#include "guard_page.h"
+
+namespace {
+
+typedef simd::neon::Utf8Codec Codec;
+
+// The scalar loops as a Codec, for comparison.
+struct ScalarCodec {
+    static bool validate(const char* src, size_t n) {
+        return simd::utf8_validate_scalar(reinterpret_cast<const uint8_t*>(src), n);
+    }
+    static bool to_utf16(const char* src, size_t n, char16_t* dst, size_t* written) {
+        size_t i = 0;
+        *written = 0;
+        return simd::utf8_to_utf16_scalar(reinterpret_cast<const uint8_t*>(src), &i, n, n, dst, written);
+    }
+    static bool to_utf8(const char16_t* src, size_t n, char* dst, size_t* written) {
+        size_t i = 0;
+        *written = 0;
+        return simd::utf16_to_utf8_scalar(src, &i, n, n, dst, written);
+    }
+};
+
+// Reference codec, written from the definitions rather than from byte
+// ranges: a byte sequence is valid if it decodes to code points that
+// re-encode to the same bytes (shortest form) and are scalar values.
+void encode_utf8(uint32_t cp, std::string* out) {
+    if (cp < 0x80) {
+        *out += (char)cp;
+    } else if (cp < 0x800) {
+        *out += (char)(0xC0 | cp >> 6);
+        *out += (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out += (char)(0xE0 | cp >> 12);
+        *out += (char)(0x80 | (cp >> 6 & 0x3F));
+        *out += (char)(0x80 | (cp & 0x3F));
+    } else {
+        *out += (char)(0xF0 | cp >> 18);
+        *out += (char)(0x80 | (cp >> 12 & 0x3F));
+        *out += (char)(0x80 | (cp >> 6 & 0x3F));
+        *out += (char)(0x80 | (cp & 0x3F));
+    }
+}
+
+bool reference_decode(const std::string& s, std::vector<uint32_t>* cps) {
+    cps->clear();
+    for (size_t i = 0; i < s.size();) {
+        uint8_t b = (uint8_t)s[i];
+        size_t len = b < 0x80 ? 1 : b < 0xC0 ? 0 : b < 0xE0 ? 2 : b < 0xF0 ? 3 : b < 0xF8 ? 4 : 0;
+        if (len == 0 || i + len > s.size()) return false;
+        uint32_t cp = len == 1 ? b : b & (0x7F >> len);
+        for (size_t j = 1; j < len; ++j) {
+            if (((uint8_t)s[i + j] & 0xC0) != 0x80) return false;
+            cp = cp << 6 | ((uint8_t)s[i + j] & 0x3F);
+        }
+        std::string again;
+        encode_utf8(cp, &again);
+        if (cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000) || again != s.substr(i, len)) return false;
+        cps->push_back(cp);
+        i += len;
+    }
+    return true;
+}
+
+std::u16string to_utf16(const std::vector<uint32_t>& cps) {
+    std::u16string out;
+    for (uint32_t cp : cps) {
+        if (cp < 0x10000) {
+            out += (char16_t)cp;
+        } else {
+            out += (char16_t)(0xD800 + ((cp - 0x10000) >> 10));
+            out += (char16_t)(0xDC00 + ((cp - 0x10000) & 0x3FF));
+        }
+    }
+    return out;
+}
+
+bool reference_utf16_valid(const std::u16string& s) {
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (s[i] >= 0xDC00 && s[i] < 0xE000) return false;
+        if (s[i] >= 0xD800 && s[i] < 0xDC00) {
+            if (i + 1 == s.size() || s[i + 1] < 0xDC00 || s[i + 1] >= 0xE000) return false;
+            ++i;
+        }
+    }
+    return true;
+}
+
+// Text of one kind: the share of 1-, 2-, 3- and 4-byte characters.
+struct Mix {
+    const char* name;
+    int weights[4];
+};
+
+const Mix kMixes[] = {
+    {"ascii", {100, 0, 0, 0}},
+    {"latin", {85, 15, 0, 0}},
+    {"cyrillic", {20, 80, 0, 0}},
+    {"cjk", {10, 0, 90, 0}},
+    {"emoji", {60, 0, 10, 30}},
+    {"mixed", {25, 25, 25, 25}},
+};
+
+uint32_t random_char(const Mix& mix, std::mt19937& rng) {
+    int r = (int)(rng() % 100), kind = 0;
+    while (kind < 3 && r >= mix.weights[kind]) r -= mix.weights[kind++];
+    switch (kind) {
+        case 0: return rng() % 0x80;
+        case 1: return 0x80 + rng() % (0x800 - 0x80);
+        case 2: {
+            uint32_t cp = 0x800 + rng() % (0x10000 - 0x800 - 0x800);
+            return cp >= 0xD800 ? cp + 0x800 : cp;   // skip the surrogates
+        }
+        default: return 0x10000 + rng() % (0x110000 - 0x10000);
+    }
+}
+
+std::string random_text(const Mix& mix, size_t bytes, std::mt19937& rng) {
+    std::string s;
+    while (s.size() < bytes) encode_utf8(random_char(mix, rng), &s);
+    return s;
+}
+
+// Input and output end at guard pages, so any byte read or written out of
+// bounds faults.
+GuardedBuffer g_in(64), g_out(64);
+
+template <typename C>
+bool to_utf16_guarded(const std::string& s, std::u16string* out) {
+    char* in = reinterpret_cast<char*>(g_in.end()) - s.size();
+    if (!s.empty()) std::memcpy(in, s.data(), s.size());
+    char16_t* dst = reinterpret_cast<char16_t*>(g_out.end()) - s.size();
+    size_t k = 0;
+    bool ok = C::to_utf16(in, s.size(), dst, &k);
+    out->assign(dst, dst + k);
+    return ok;
+}
+
+template <typename C>
+bool to_utf8_guarded(const std::u16string& s, std::string* out) {
+    char16_t* in = reinterpret_cast<char16_t*>(g_in.end()) - s.size();
+    if (!s.empty()) std::memcpy(in, s.data(), s.size() * sizeof(char16_t));
+    char* dst = reinterpret_cast<char*>(g_out.end()) - s.size() * 3;
+    size_t k = 0;
+    bool ok = C::to_utf8(in, s.size(), dst, &k);
+    out->assign(dst, k);
+    return ok;
+}
+
+template <typename C>
+bool validate_guarded(const std::string& s) {
+    char* in = reinterpret_cast<char*>(g_in.end()) - s.size();
+    if (!s.empty()) std::memcpy(in, s.data(), s.size());
+    return C::validate(in, s.size());
+}
+
+template <typename C>
+bool check_transcode() {
+    std::mt19937 rng(1);
+    std::vector<size_t> sizes;
+    for (size_t n = 0; n <= 200; ++n) sizes.push_back(n);
+    for (size_t n : {(size_t)4095, (size_t)65537}) sizes.push_back(n);
+    std::vector<uint32_t> cps;
+    for (const Mix& mix : kMixes) {
+        for (size_t n : sizes) {
+            std::string s = random_text(mix, n, rng);
+            reference_decode(s, &cps);
+            std::u16string u = to_utf16(cps), u_got;
+            std::string s_got;
+            if (!validate_guarded<C>(s)) return false;
+            if (!to_utf16_guarded<C>(s, &u_got) || u_got != u) return false;
+            if (!to_utf8_guarded<C>(u, &s_got) || s_got != s) return false;
+        }
+    }
+    return true;
+}
+
+// Every byte value at every position, and every prefix, of texts that reach
+// each loop of the kernels.
+template <typename C>
+bool check_validation() {
+    std::mt19937 rng(2);
+    std::vector<uint32_t> cps;
+    std::vector<char16_t> out(512);
+    for (const Mix& mix : kMixes) {
+        std::string good = random_text(mix, 150, rng);
+        for (size_t pos = 0; pos < good.size(); ++pos) {
+            for (int c = 0; c < 256; ++c) {
+                std::string s = good;
+                s[pos] = (char)c;
+                bool want = reference_decode(s, &cps);
+                size_t k = 0;
+                if (C::validate(s.data(), s.size()) != want) return false;
+                if (C::to_utf16(s.data(), s.size(), out.data(), &k) != want) return false;
+            }
+        }
+        for (size_t len = 0; len <= good.size(); ++len) {
+            bool want = reference_decode(good.substr(0, len), &cps);
+            if (C::validate(good.data(), len) != want) return false;
+        }
+    }
+    // Sequences that are only wrong as a whole, at every offset.
+    const char* bad[] = {"\xC0\x80", "\xC1\xBF", "\xE0\x80\x80", "\xE0\x9F\xBF", "\xED\xA0\x80", "\xED\xBF\xBF",
+                         "\xF0\x80\x80\x80", "\xF0\x8F\xBF\xBF", "\xF4\x90\x80\x80", "\xF5\x80\x80\x80",
+                         "\xFF", "\x80", "\xE2\x82", "\xF0\x9F\x98", "\xE2\x82\xAC\xAC"};
+    std::string base = random_text(kMixes[2], 140, rng);
+    for (const char* b : bad) {
+        for (size_t pos = 0; pos <= 130; ++pos) {
+            std::string s = base;
+            s.replace(pos, std::strlen(b), b);
+            size_t k = 0;
+            bool want = reference_decode(s, &cps);
+            if (C::validate(s.data(), s.size()) != want) return false;
+            if (C::to_utf16(s.data(), s.size(), out.data(), &k) != want) return false;
+        }
+    }
+    // Surrogates out of place in UTF-16.
+    std::string text = random_text(kMixes[4], 200, rng);
+    reference_decode(text, &cps);
+    std::u16string u16 = to_utf16(cps);
+    std::vector<char> bytes(u16.size() * 3 + 3);
+    for (size_t pos = 0; pos < u16.size(); ++pos) {
+        for (char16_t c : {(char16_t)0xD800, (char16_t)0xDBFF, (char16_t)0xDC00, (char16_t)0xDFFF, (char16_t)'a'}) {
+            std::u16string s = u16;
+            s[pos] = c;
+            size_t k = 0;
+            if (C::to_utf8(s.data(), s.size(), bytes.data(), &k) != reference_utf16_valid(s)) return false;
+        }
+    }
+    return true;
+}
+
+// The stream classes, over pieces of random size, against the one-shot
+// results.
+template <typename C>
+bool check_streaming() {
+    std::mt19937 rng(3);
+    std::vector<uint32_t> cps;
+    for (const Mix& mix : kMixes) {
+        for (int round = 0; round < 20; ++round) {
+            std::string s = random_text(mix, rng() % 3000, rng);
+            bool truncated = round % 4 == 3 && !s.empty() && (uint8_t)s.back() >= 0x80;
+            if (truncated) s.pop_back();
+            bool valid = reference_decode(s, &cps);
+            std::u16string want = to_utf16(cps);
+
+            simd::Utf8Validator<C> v;
+            simd::Utf8ToUtf16<C> to16;
+            std::vector<char16_t> u(s.size() + 8);
+            size_t k = 0, got = 0;
+            bool ok = true;
+            for (size_t i = 0; i < s.size();) {
+                size_t piece = std::min(s.size() - i, (size_t)(rng() % 40));
+                ok = v.update(s.data() + i, piece) && ok;
+                ok = to16.update(s.data() + i, piece, u.data() + k, &got) && ok;
+                k += got;
+                i += piece;
+            }
+            bool v_ok = v.finish(), to16_ok = to16.finish();
+            if (v_ok != valid || to16_ok != valid || (valid && std::u16string(u.data(), k) != want)) return false;
+            if (!valid) continue;
+
+            simd::Utf16ToUtf8<C> to8;
+            std::string back(want.size() * 3 + 4, '\0');
+            k = 0;
+            for (size_t i = 0; i < want.size();) {
+                size_t piece = std::min(want.size() - i, (size_t)(rng() % 20));
+                if (!to8.update(want.data() + i, piece, &back[k], &got)) return false;
+                k += got;
+                i += piece;
+            }
+            if (!to8.finish() || back.substr(0, k) != s) return false;
+        }
+    }
+    // A high surrogate left open at the end fails finish, and resets.
+    simd::Utf16ToUtf8<C> to8;
+    char out[8];
+    size_t k = 0;
+    const char16_t high = 0xD83D, low = 0xDE00;
+    if (!to8.update(&high, 1, out, &k) || k != 0 || to8.finish()) return false;
+    if (!to8.update(&high, 1, out, &k) || !to8.update(&low, 1, out, &k) || k != 4 || !to8.finish()) return false;
+    return true;
+}
+
+template <typename F>
+double gb_per_s(size_t bytes, F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 5; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return bytes / best / 1e9;
+}
+
+template <typename C>
+void bench(const Mix& mix) {
+    std::mt19937 rng(4);
+    std::string s = random_text(mix, (size_t)1 << 20, rng);
+    std::vector<uint32_t> cps;
+    reference_decode(s, &cps);
+    std::u16string u = to_utf16(cps);
+    std::vector<char16_t> u_out(s.size());
+    std::vector<char> s_out(u.size() * 3);
+    size_t k = 0, valid = 0;
+    double validate = gb_per_s(s.size(), [&] { valid += C::validate(s.data(), s.size()); });
+    double to16 = gb_per_s(s.size(), [&] { C::to_utf16(s.data(), s.size(), u_out.data(), &k); });
+    double to8 = gb_per_s(s.size(), [&] { C::to_utf8(u.data(), u.size(), s_out.data(), &k); });
+    std::cout << std::setw(10) << mix.name << std::setw(10) << validate << std::setw(10) << to16 << std::setw(10)
+              << to8 << (valid == 6 ? "" : "  MISMATCH") << std::endl;
+}
+
+template <typename C>
+void bench_all(const char* name) {
+    std::cout << std::endl << name << std::endl;
+    std::cout << std::setw(10) << "text" << std::setw(10) << "validate" << std::setw(10) << "to utf16"
+              << std::setw(10) << "to utf8" << std::endl;
+    for (const Mix& mix : kMixes) bench<C>(mix);
+}
+
+} // namespace
+
+int main() {
+    if (!g_in.base || !g_out.base) {
+        std::cout << "mmap failed" << std::endl;
+        return 1;
+    }
+    bool ok = check_transcode<ScalarCodec>() && check_validation<ScalarCodec>() && check_streaming<ScalarCodec>();
+    std::cout << "scalar UTF-8/UTF-16 vs reference, guarded: " << (ok ? "OK" : "MISMATCH") << std::endl;
+    bool good = check_transcode<Codec>() && check_validation<Codec>() && check_streaming<Codec>();
+    std::cout << "  NEON UTF-8/UTF-16 vs reference, guarded: " << (good ? "OK" : "MISMATCH") << std::endl;
+    ok = ok && good;
+
+    std::cout << std::endl << "1 MiB of UTF-8 text, GB/s of UTF-8:" << std::fixed << std::setprecision(2);
+    bench_all<ScalarCodec>("scalar");
+    bench_all<Codec>("neon");
+    return ok ? 0 : 1;
+}
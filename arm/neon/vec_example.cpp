@@ -0,0 +1,136 @@
+// The kernels of x86/kernels/vec_example.cpp that NEON can express, each
+// written twice: once against simd::native_vec<T> (vec_*, the same source as
+// on x86) and once with NEON intrinsics (raw_*). Running it checks that each
+// pair computes bit-identical results; ../check_vec_codegen.sh checks that
+// each pair compiles to the same instructions.
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <arm_neon.h>
+#include "simd_vec.h"
+
+#define NOINLINE __attribute__((noinline))
+
+typedef simd::native_vec<float> V;
+
+// --- vec<T, N> ---
+
+extern "C" NOINLINE void vec_saxpy(float a, const float* x, float* y, size_t n) {
+    V va = V::broadcast(a);
+    size_t i = 0;
+    for (; i + V::lanes <= n; i += V::lanes) simd::fma(va, V::loadu(x + i), V::loadu(y + i)).storeu(y + i);
+    for (; i < n; ++i) y[i] = a * x[i] + y[i];
+}
+
+extern "C" NOINLINE float vec_dot(const float* x, const float* y, size_t n) {
+    V acc = V::zero();
+    size_t i = 0;
+    for (; i + V::lanes <= n; i += V::lanes) acc = simd::fma(V::loadu(x + i), V::loadu(y + i), acc);
+    float s = simd::reduce_add(acc);
+    for (; i < n; ++i) s += x[i] * y[i];
+    return s;
+}
+
+extern "C" NOINLINE void vec_leaky_relu(const float* x, float* y, float slope, size_t n) {
+    V vs = V::broadcast(slope);
+    size_t i = 0;
+    for (; i + V::lanes <= n; i += V::lanes) {
+        V v = V::loadu(x + i);
+        simd::select(v < V::zero(), v * vs, v).storeu(y + i);
+    }
+    for (; i < n; ++i) y[i] = x[i] < 0.0f ? x[i] * slope : x[i];
+}
+
+// --- Raw NEON ---
+
+extern "C" NOINLINE void raw_saxpy(float a, const float* x, float* y, size_t n) {
+    float32x4_t va = vdupq_n_f32(a);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) vst1q_f32(y + i, vfmaq_f32(vld1q_f32(y + i), va, vld1q_f32(x + i)));
+    for (; i < n; ++i) y[i] = a * x[i] + y[i];
+}
+
+extern "C" NOINLINE float raw_dot(const float* x, const float* y, size_t n) {
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) acc = vfmaq_f32(acc, vld1q_f32(x + i), vld1q_f32(y + i));
+    float s = vaddvq_f32(acc);
+    for (; i < n; ++i) s += x[i] * y[i];
+    return s;
+}
+
+extern "C" NOINLINE void raw_leaky_relu(const float* x, float* y, float slope, size_t n) {
+    float32x4_t vs = vdupq_n_f32(slope);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t v = vld1q_f32(x + i);
+        uint32x4_t neg = vcltq_f32(v, vdupq_n_f32(0.0f));
+        vst1q_f32(y + i, vbslq_f32(neg, vmulq_f32(v, vs), v));
+    }
+    for (; i < n; ++i) y[i] = x[i] < 0.0f ? x[i] * slope : x[i];
+}
+
+// --- Checks ---
+
+namespace {
+
+bool same_bits(const std::vector<float>& a, const std::vector<float>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+bool same_bits(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+bool report(const char* name, bool identical, bool correct) {
+    std::cout << "  " << name << ": " << (identical && correct ? "OK" : "MISMATCH")
+              << (identical ? "" : " (vec and raw differ)") << (correct ? "" : " (wrong result)") << std::endl;
+    return identical && correct;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "native_vec<float>: " << V::lanes << " lanes (neon)" << std::endl;
+    float ramp[V::lanes];
+    for (int i = 0; i < V::lanes; ++i) ramp[i] = (float)i;
+    std::cout << "V::loadu(0, 1, 2, ...) * 2 = ";
+    simd::print(V::loadu(ramp) * V::broadcast(2.0f));
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> val(-4.0f, 4.0f);
+    bool ok = true;
+    for (size_t n : {(size_t)0, (size_t)1, (size_t)3, (size_t)4, (size_t)1000, (size_t)1003}) {
+        std::cout << "n = " << n << std::endl;
+        std::vector<float> x(n), y(n);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = val(rng);
+            y[i] = val(rng);
+        }
+
+        std::vector<float> ref = y, yr = y, yv = y;
+        for (size_t i = 0; i < n; ++i) ref[i] = 1.5f * x[i] + y[i];
+        raw_saxpy(1.5f, x.data(), yr.data(), n);
+        vec_saxpy(1.5f, x.data(), yv.data(), n);
+        bool close = true;
+        for (size_t i = 0; i < n; ++i) close = close && std::fabs(yv[i] - ref[i]) <= 1e-5f * (1.0f + std::fabs(ref[i]));
+        ok &= report("saxpy", same_bits(yr, yv), close);
+
+        double dref = 0;
+        for (size_t i = 0; i < n; ++i) dref += (double)x[i] * y[i];
+        float dr = raw_dot(x.data(), y.data(), n), dv = vec_dot(x.data(), y.data(), n);
+        ok &= report("dot", same_bits(dr, dv), std::fabs(dv - dref) <= 1e-3 * (1.0 + n));
+
+        for (size_t i = 0; i < n; ++i) ref[i] = x[i] < 0.0f ? x[i] * 0.1f : x[i];
+        raw_leaky_relu(x.data(), yr.data(), 0.1f, n);
+        vec_leaky_relu(x.data(), yv.data(), 0.1f, n);
+        ok &= report("leaky_relu", same_bits(yr, yv), same_bits(yv, ref));
+    }
+
+    std::cout << (ok ? "All checks passed." : "SOME CHECKS FAILED.") << std::endl;
+    return ok ? 0 : 1;
+}
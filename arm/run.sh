@@ -28,5 +28,12 @@ if [ -z "$EXAMPLE_PATH" ]; then
     exit 1
 fi
 
+# SVE_VL=<bits> runs SVE code at that vector length (128 to 2048) instead of
+# QEMU's default; QEMU takes the length in bytes.
+QEMU_CPU="max"
+if [ -n "$SVE_VL" ]; then
+    QEMU_CPU="max,sve-default-vector-length=$((SVE_VL / 8))"
+fi
+
 # Run the example with QEMU
-QEMU_LD_PREFIX=/usr/aarch64-linux-gnu qemu-aarch64-static -cpu max $EXAMPLE_PATH
+QEMU_LD_PREFIX=/usr/aarch64-linux-gnu qemu-aarch64-static -cpu $QEMU_CPU $EXAMPLE_PATH
@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# Runs an SVE example at every vector length from 128 to 2048 bits and
+# reports the lengths at which it exits with an error.
+
+if [ -z "$1" ]; then
+    echo "Usage: ./run_all_vl.sh <example_name>"
+    echo "Example: ./run_all_vl.sh sve_loop_example"
+    exit 1
+fi
+
+FAILED=""
+for VL in $(seq 128 128 2048); do
+    echo "=== SVE_VL=$VL ==="
+    if ! SVE_VL=$VL ./run.sh "$1"; then
+        FAILED="$FAILED $VL"
+    fi
+done
+
+if [ -n "$FAILED" ]; then
+    echo "Failed at vector lengths:$FAILED"
+    exit 1
+fi
+echo "Passed at every vector length."
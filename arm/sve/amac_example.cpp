@@ -0,0 +1,90 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <arm_sve.h>
+#include "tree_search_sve.h"
+
+namespace {
+
+typedef void (*Search)(const uint32_t*, size_t, const uint32_t*, size_t, uint32_t*);
+
+// One descent after another.
+void loop_search(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out) {
+    for (size_t i = 0; i < m; ++i) {
+        uint32_t k = 1;
+        while (k <= n) k = 2 * k + (tree[k] < keys[i]);
+        out[i] = simd::sve::tree_finish(k);
+    }
+}
+
+// Sizes around full trees; keys below, between, on and above the stored
+// ones (even numbers with repeats); tails of every length.
+bool check(Search search) {
+    std::mt19937 rng(3);
+    for (size_t n : {(size_t)0, (size_t)1, (size_t)2, (size_t)3, (size_t)7, (size_t)8, (size_t)15, (size_t)16,
+                     (size_t)17, (size_t)100, (size_t)1000, (size_t)65537}) {
+        std::vector<uint32_t> sorted(n), tree(n + 1);
+        for (size_t i = 0; i < n; ++i) sorted[i] = 2 + 2 * (uint32_t)(i - i % 3 / 2);
+        simd::sve::eytzinger_layout(sorted.data(), n, tree.data());
+        std::vector<uint32_t> keys = {0, 1, 2, 3, 4, 0xFFFFFFFFu, (uint32_t)(2 * n + 2), (uint32_t)(2 * n + 3)};
+        std::uniform_int_distribution<uint32_t> any(0, (uint32_t)(2 * n + 4));
+        while (keys.size() < 1000) keys.push_back(any(rng));
+        for (size_t m : {(size_t)1, (size_t)7, (size_t)16, (size_t)17, keys.size()}) {
+            std::vector<uint32_t> out(m + 1, 12345);
+            search(tree.data(), n, keys.data(), m, out.data());
+            if (out[m] != 12345) return false;
+            for (size_t i = 0; i < m; ++i) {
+                auto it = std::lower_bound(sorted.begin(), sorted.end(), keys[i]);
+                if (it == sorted.end() ? out[i] != 0 : out[i] == 0 || out[i] > n || tree[out[i]] != *it) return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename F>
+double ns_per_lookup(size_t lookups, F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 3; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return best / lookups * 1e9;
+}
+
+void bench(size_t n, size_t lookups) {
+    std::vector<uint32_t> sorted(n), tree(n + 1), keys(lookups), out(lookups);
+    for (size_t i = 0; i < n; ++i) sorted[i] = (uint32_t)(2 * i);
+    simd::sve::eytzinger_layout(sorted.data(), n, tree.data());
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<uint32_t> any(0, (uint32_t)(2 * n));
+    for (uint32_t& k : keys) k = any(rng);
+    const char* names[] = {"loop", "gather", "AMAC"};
+    Search searches[] = {loop_search, simd::sve::tree_search_gather, simd::sve::tree_search};
+    std::cout << "  " << std::setw(6) << n * 4 / 1048576.0 << " MiB tree:";
+    for (int s = 0; s < 3; ++s) {
+        double ns = ns_per_lookup(lookups, [&] { searches[s](tree.data(), n, keys.data(), lookups, out.data()); });
+        std::cout << "  " << names[s] << " " << std::setw(6) << ns;
+    }
+    std::cout << " ns" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "SVE vector length: " << svcntb() * 8 << " bits" << std::endl;
+    bool ok = check(simd::sve::tree_search_gather) && check(simd::sve::tree_search);
+    std::cout << "Lockstep gather and AMAC vs std::lower_bound: " << (ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl << "Tree lower_bound, ns per lookup (one core):" << std::endl;
+    bench((size_t)1 << 16, (size_t)1 << 20);
+    bench((size_t)1 << 26, (size_t)1 << 20);
+    return ok ? 0 : 1;
+}
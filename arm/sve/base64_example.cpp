@@ -0,0 +1,181 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <cstdint>
+#include "base64_sve.h"
+#include "guard_page.h"
+
+namespace {
+
+typedef simd::sve::Base64Codec Codec;
+
+// The scalar group loops as a Codec, for comparison.
+struct ScalarCodec {
+    static void encode(const uint8_t* src, size_t n, char* dst, simd::Base64 alphabet) {
+        simd::base64_encode_groups(simd::base64_tables(alphabet), src, n, dst);
+    }
+    static bool decode(const char* src, size_t n, uint8_t* dst, simd::Base64 alphabet) {
+        return simd::base64_decode_groups(simd::base64_tables(alphabet), src, n, dst);
+    }
+};
+
+// Bit by bit, straight from RFC 4648.
+std::string reference_encode(const std::vector<uint8_t>& src, simd::Base64 alphabet, bool pad) {
+    const char* chars = alphabet == simd::Base64::Url
+                            ? "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+                            : "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    size_t bits = src.size() * 8;
+    for (size_t b = 0; b < bits; b += 6) {
+        int v = 0;
+        for (size_t j = b; j < b + 6; ++j) v = v << 1 | (j < bits ? src[j / 8] >> (7 - j % 8) & 1 : 0);
+        out += chars[v];
+    }
+    while (pad && out.size() % 4) out += '=';
+    return out;
+}
+
+// Input and output end at guard pages, so any byte read or written past
+// either end faults.
+GuardedBuffer g_in(32), g_out(32);
+
+bool roundtrip(const std::vector<uint8_t>& src, simd::Base64 alphabet, bool pad) {
+    std::string want = reference_encode(src, alphabet, pad);
+    uint8_t* in = g_in.end() - src.size();
+    if (!src.empty()) std::memcpy(in, src.data(), src.size());
+    char* text = reinterpret_cast<char*>(g_out.end()) - want.size();
+    if (simd::sve::base64_encode(in, src.size(), text, alphabet, pad) != want.size()) return false;
+    if (std::string(text, want.size()) != want) return false;
+
+    char* chars = reinterpret_cast<char*>(g_in.end()) - want.size();
+    std::memcpy(chars, want.data(), want.size());
+    uint8_t* back = g_out.end() - simd::base64_decoded_length(want.size());
+    size_t k = 0;
+    return simd::sve::base64_decode(chars, want.size(), back, &k, alphabet) && k == src.size() &&
+           (src.empty() || std::memcmp(back, src.data(), k) == 0);
+}
+
+// Through pieces of random size.
+bool roundtrip_pieces(const std::vector<uint8_t>& src, simd::Base64 alphabet, std::mt19937& rng) {
+    simd::sve::Base64Encoder enc(alphabet);
+    std::string text(simd::base64_encoded_length(src.size()) + 8, '\0');
+    size_t k = 0;
+    for (size_t i = 0; i < src.size();) {
+        size_t piece = std::min(src.size() - i, (size_t)(rng() % 70));
+        k += enc.update(src.data() + i, piece, &text[k]);
+        i += piece;
+    }
+    k += enc.finish(&text[k]);
+    text.resize(k);
+    if (text != reference_encode(src, alphabet, true)) return false;
+
+    simd::sve::Base64Decoder dec(alphabet);
+    std::vector<uint8_t> back(src.size() + 8);
+    size_t got = 0;
+    k = 0;
+    for (size_t i = 0; i < text.size();) {
+        size_t piece = std::min(text.size() - i, (size_t)(rng() % 90));
+        if (!dec.update(text.data() + i, piece, back.data() + k, &got)) return false;
+        k += got;
+        i += piece;
+    }
+    if (!dec.finish(back.data() + k, &got)) return false;
+    back.resize(k + got);
+    return back == src;
+}
+
+bool check_roundtrip() {
+    std::mt19937 rng(1);
+    std::vector<size_t> sizes;
+    for (size_t n = 0; n <= 200; ++n) sizes.push_back(n);
+    sizes.push_back(4095);
+    sizes.push_back(65537);
+    for (size_t n : sizes) {
+        std::vector<uint8_t> src(n);
+        for (uint8_t& b : src) b = (uint8_t)rng();
+        for (simd::Base64 alphabet : {simd::Base64::Standard, simd::Base64::Url}) {
+            if (!roundtrip(src, alphabet, true) || !roundtrip(src, alphabet, false)) return false;
+            if (!roundtrip_pieces(src, alphabet, rng)) return false;
+        }
+    }
+    return true;
+}
+
+// Every byte value at every position, in blocks and in the scalar tail:
+// valid exactly when it is in the alphabet, or '=' as the last character.
+bool check_validation() {
+    std::mt19937 rng(2);
+    for (simd::Base64 alphabet : {simd::Base64::Standard, simd::Base64::Url}) {
+        const char* extra = alphabet == simd::Base64::Url ? "-_" : "+/";
+        for (size_t n : {(size_t)4, (size_t)64, (size_t)68, (size_t)128, (size_t)140}) {
+            std::vector<uint8_t> src(n / 4 * 3), back(n);
+            for (uint8_t& b : src) b = (uint8_t)rng();
+            std::string good = reference_encode(src, alphabet, false);
+            for (size_t pos = 0; pos < n; ++pos) {
+                for (int c = 0; c < 256; ++c) {
+                    std::string text = good;
+                    text[pos] = (char)c;
+                    bool in = c < 128 && (std::isalnum(c) || c == extra[0] || c == extra[1]);
+                    in = in || (c == '=' && pos == n - 1);
+                    size_t k = 0;
+                    if (simd::sve::base64_decode(text.data(), n, back.data(), &k, alphabet) != in) return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template <typename F>
+double gb_per_s(size_t bytes, F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 5; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return bytes / best / 1e9;
+}
+
+template <typename C>
+void bench(const char* name) {
+    const size_t n = (size_t)1 << 20;
+    std::vector<uint8_t> src(n), back(n);
+    std::mt19937 rng(3);
+    for (uint8_t& b : src) b = (uint8_t)rng();
+    std::string text(simd::base64_encoded_length(n), '\0');
+    size_t k = 0;
+    double enc = gb_per_s(n, [&] {
+        simd::base64_encode_with<C>(src.data(), n, &text[0], simd::Base64::Standard, true);
+    });
+    double dec = gb_per_s(n, [&] {
+        simd::base64_decode_with<C>(text.data(), text.size(), back.data(), &k, simd::Base64::Standard);
+    });
+    std::cout << "  " << std::setw(6) << name << "  encode " << std::setw(6) << enc << "  decode " << std::setw(6)
+              << dec << " GB/s" << (back == src ? "" : "  MISMATCH") << std::endl;
+}
+
+} // namespace
+
+int main() {
+    if (!g_in.base || !g_out.base) {
+        std::cout << "mmap failed" << std::endl;
+        return 1;
+    }
+    bool ok = check_roundtrip() && check_validation();
+    std::cout << "SVE base64 vs RFC 4648, guarded: " << (ok ? "OK" : "MISMATCH") << std::endl;
+
+    std::cout << std::endl << "1 MiB of random bytes, GB/s of binary data:" << std::fixed << std::setprecision(2)
+              << std::endl;
+    bench<ScalarCodec>("scalar");
+    bench<Codec>("sve");
+    return ok ? 0 : 1;
+}
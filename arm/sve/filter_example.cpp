@@ -0,0 +1,93 @@
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <cstdint>
+#include <arm_sve.h>
+#include "filter_sve.h"
+
+// Helper function to print a vector of int32_t
+void print_s32(const std::vector<int32_t>& vec, size_t count, const std::string& label) {
+    std::cout << label << ": ";
+    for (size_t i = 0; i < count; ++i) {
+        std::cout << vec[i] << " ";
+    }
+    std::cout << std::endl;
+}
+
+// Scalar reference used to check the SVE results.
+template <typename T>
+size_t filter_reference(const T* src, size_t n, simd::CmpOp op, T value, T* dst) {
+    size_t k = 0;
+    for (size_t i = 0; i < n; ++i) {
+        bool keep = false;
+        switch (op) {
+            case simd::CmpOp::EQ: keep = src[i] == value; break;
+            case simd::CmpOp::NE: keep = src[i] != value; break;
+            case simd::CmpOp::LT: keep = src[i] < value; break;
+            case simd::CmpOp::LE: keep = src[i] <= value; break;
+            case simd::CmpOp::GT: keep = src[i] > value; break;
+            case simd::CmpOp::GE: keep = src[i] >= value; break;
+        }
+        if (keep) dst[k++] = src[i];
+    }
+    return k;
+}
+
+template <typename T>
+bool check_all_ops(const std::vector<T>& src, T value) {
+    static const simd::CmpOp ops[] = {simd::CmpOp::EQ, simd::CmpOp::NE, simd::CmpOp::LT,
+                                      simd::CmpOp::LE, simd::CmpOp::GT, simd::CmpOp::GE};
+    std::vector<T> out(src.size()), expect(src.size());
+    for (simd::CmpOp op : ops) {
+        // Every length up to src.size(): covers all partial-vector tails.
+        for (size_t n = 0; n <= src.size(); ++n) {
+            size_t got = simd::sve::filter(src.data(), n, op, value, out.data());
+            size_t want = filter_reference(src.data(), n, op, value, expect.data());
+            if (got != want || !std::equal(out.begin(), out.begin() + got, expect.begin())) return false;
+        }
+    }
+    return true;
+}
+
+// --- Demonstration Functions ---
+
+void compact_s32() {
+    std::cout << "\n--- Stream Compaction with svcompact (s32) ---" << std::endl;
+    // Not a multiple of the vector length on purpose.
+    size_t n = svcntw() * 2 + 3;
+    std::vector<int32_t> data(n);
+    std::iota(data.begin(), data.end(), 0);
+    print_s32(data, n, "Original Data   ");
+
+    std::vector<int32_t> result(n);
+    size_t count = simd::sve::filter(data.data(), n, simd::CmpOp::GT, (int32_t)(n / 2), result.data());
+    print_s32(result, count, "Elements > n / 2");
+}
+
+void verify_types() {
+    std::cout << "\n--- Cross-check against Scalar Reference ---" << std::endl;
+    std::vector<float> f32(100);
+    std::vector<int32_t> s32(100);
+    std::vector<int64_t> s64(100);
+    std::vector<uint8_t> u8(100);
+    for (size_t i = 0; i < 100; ++i) {
+        f32[i] = (float)((i * 7) % 20) - 10.0f;
+        s32[i] = (int32_t)((i * 7) % 20) - 10;
+        s64[i] = ((int64_t)((i * 7) % 20) - 10) << 33;
+        u8[i] = (uint8_t)((i * 7) % 20 + 118);
+    }
+    std::cout << "f32: " << (check_all_ops(f32, 0.0f) ? "OK" : "MISMATCH") << std::endl;
+    std::cout << "s32: " << (check_all_ops(s32, (int32_t)-3) ? "OK" : "MISMATCH") << std::endl;
+    std::cout << "s64: " << (check_all_ops(s64, (int64_t)3 << 33) ? "OK" : "MISMATCH") << std::endl;
+    std::cout << "u8:  " << (check_all_ops(u8, (uint8_t)128) ? "OK" : "MISMATCH") << std::endl;
+}
+
+int main() {
+    std::cout << "SVE vector width for int32_t is " << svcntw() << " elements." << std::endl;
+
+    compact_s32();
+    verify_types();
+
+    return 0;
+}
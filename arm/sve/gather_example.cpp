@@ -0,0 +1,97 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <arm_sve.h>
+#include "gather_sve.h"
+
+namespace {
+
+// Lookups are made in batches of this many, into one output buffer that
+// stays in L2.
+const size_t kBatch = 4096;
+
+bool check() {
+    std::vector<float> table(100000);
+    for (size_t i = 0; i < table.size(); ++i) table[i] = (float)i * 0.5f;
+    std::mt19937 rng(1);
+    std::vector<uint32_t> idx(1003);
+    for (size_t distance : {(size_t)0, (size_t)1, (size_t)5, (size_t)64}) {
+        std::uniform_int_distribution<uint32_t> any(0, (uint32_t)table.size() - 1);
+        for (uint32_t& i : idx) i = any(rng);
+        for (size_t n = 0; n <= 70; ++n) {
+            std::vector<float> out(n + 1, -1.0f);
+            simd::sve::gather(table.data(), idx.data(), n, out.data(), distance);
+            for (size_t i = 0; i < n; ++i) {
+                if (out[i] != table[idx[i]]) return false;
+            }
+            if (out[n] != -1.0f) return false;
+        }
+        for (size_t dim : {(size_t)1, (size_t)7, (size_t)16, (size_t)64, (size_t)100}) {
+            std::uniform_int_distribution<uint32_t> row(0, (uint32_t)(table.size() / dim) - 1);
+            for (uint32_t& i : idx) i = row(rng);
+            size_t n = 37;
+            std::vector<float> out(n * dim + 1, -1.0f);
+            simd::sve::gather_rows(table.data(), dim, idx.data(), n, out.data(), distance);
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j < dim; ++j) {
+                    if (out[i * dim + j] != table[idx[i] * dim + j]) return false;
+                }
+            }
+            if (out[n * dim] != -1.0f) return false;
+        }
+    }
+    return true;
+}
+
+template <typename F>
+double ns_per_lookup(size_t lookups, F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 3; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || ns < best) best = ns;
+    }
+    return best / lookups;
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "SVE vector length: " << svcntb() * 8 << " bits" << std::endl;
+    bool ok = check();
+    std::cout << "gather / gather_rows vs scalar: " << (ok ? "OK" : "MISMATCH") << std::endl << std::endl;
+
+    // 4-byte lookups into 512 MiB: one DRAM miss per lookup.
+    const size_t entries = (size_t)128 << 20, lookups = (size_t)1 << 22;
+    std::vector<float> table(entries, 1.0f);
+    auto start = std::chrono::steady_clock::now();
+    size_t tuned = simd::sve::tune_prefetch_distance(table.data(), entries);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Tuned prefetch distance: " << tuned << " lines (" << ms << " ms)" << std::endl << std::endl;
+
+    std::vector<uint32_t> idx(lookups);
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<uint32_t> any(0, (uint32_t)entries - 1);
+    for (uint32_t& i : idx) i = any(rng);
+    std::vector<float> out(kBatch);
+    std::cout << "gather, 4 M lookups into 512 MiB:" << std::endl;
+    double base = 0;
+    for (size_t d : {(size_t)0, (size_t)4, (size_t)8, (size_t)16, (size_t)32, (size_t)64, (size_t)128}) {
+        double ns = ns_per_lookup(lookups, [&] {
+            for (size_t b = 0; b < lookups; b += kBatch) {
+                simd::sve::gather(table.data(), idx.data() + b, kBatch, out.data(), d);
+            }
+        });
+        if (d == 0) base = ns;
+        std::cout << "  distance " << std::setw(3) << d << ": " << std::setw(7) << ns << " ns/lookup";
+        if (d) std::cout << "  (" << base / ns << "x)";
+        std::cout << std::endl;
+    }
+    return ok ? 0 : 1;
+}
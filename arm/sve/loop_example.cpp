@@ -0,0 +1,176 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <arm_sve.h>
+#include "loop_sve.h"
+
+// --- Kernels: each one only describes a single vector ---
+
+// y[i] = a * x[i] + y[i] on float and double
+struct AxpyF32 {
+    typedef float element_type;
+    float a;
+    const float* x;
+    float* y;
+
+    svfloat32x2_t load(svbool_t pg, size_t i) { return svcreate2(svld1(pg, x + i), svld1(pg, y + i)); }
+    svfloat32_t compute(svbool_t pg, svfloat32x2_t v) { return svmla_x(pg, svget2(v, 1), svget2(v, 0), a); }
+    void store(svbool_t pg, size_t i, svfloat32_t w) { svst1(pg, y + i, w); }
+};
+
+struct AxpyF64 {
+    typedef double element_type;
+    double a;
+    const double* x;
+    double* y;
+
+    svfloat64x2_t load(svbool_t pg, size_t i) { return svcreate2(svld1(pg, x + i), svld1(pg, y + i)); }
+    svfloat64_t compute(svbool_t pg, svfloat64x2_t v) { return svmla_x(pg, svget2(v, 1), svget2(v, 0), a); }
+    void store(svbool_t pg, size_t i, svfloat64_t w) { svst1(pg, y + i, w); }
+};
+
+// dst[i] = saturate(a[i] + b[i]) on int8_t
+struct AddSaturateS8 {
+    typedef int8_t element_type;
+    const int8_t* a;
+    const int8_t* b;
+    int8_t* dst;
+
+    svint8x2_t load(svbool_t pg, size_t i) { return svcreate2(svld1(pg, a + i), svld1(pg, b + i)); }
+    svint8_t compute(svbool_t, svint8x2_t v) { return svqadd(svget2(v, 0), svget2(v, 1)); }
+    void store(svbool_t pg, size_t i, svint8_t w) { svst1(pg, dst + i, w); }
+};
+
+// dst[i] = src[i] * 3 on uint16_t (wrapping)
+struct TripleU16 {
+    typedef uint16_t element_type;
+    const uint16_t* src;
+    uint16_t* dst;
+
+    svuint16_t load(svbool_t pg, size_t i) { return svld1(pg, src + i); }
+    svuint16_t compute(svbool_t pg, svuint16_t v) { return svmul_x(pg, v, (uint16_t)3); }
+    void store(svbool_t pg, size_t i, svuint16_t w) { svst1(pg, dst + i, w); }
+};
+
+// dst[i] = |src[i]| on int64_t
+struct AbsS64 {
+    typedef int64_t element_type;
+    const int64_t* src;
+    int64_t* dst;
+
+    svint64_t load(svbool_t pg, size_t i) { return svld1(pg, src + i); }
+    svint64_t compute(svbool_t pg, svint64_t v) { return svabs_x(pg, v); }
+    void store(svbool_t pg, size_t i, svint64_t w) { svst1(pg, dst + i, w); }
+};
+
+// sum(x[i] * y[i]) on double
+struct DotF64 {
+    typedef double element_type;
+    const double* x;
+    const double* y;
+
+    svfloat64_t zero() { return svdup_f64(0.0); }
+    svfloat64x2_t load(svbool_t pg, size_t i) { return svcreate2(svld1(pg, x + i), svld1(pg, y + i)); }
+    svfloat64_t accumulate(svbool_t pg, svfloat64_t acc, svfloat64x2_t v) {
+        return svmla_m(pg, acc, svget2(v, 0), svget2(v, 1));
+    }
+    svfloat64_t merge(svfloat64_t a, svfloat64_t b) { return svadd_x(svptrue_b64(), a, b); }
+    double finish(svfloat64_t acc) { return svaddv(svptrue_b64(), acc); }
+};
+
+// sum(src[i]) on int32_t
+struct SumS32 {
+    typedef int32_t element_type;
+    const int32_t* src;
+
+    svint32_t zero() { return svdup_s32(0); }
+    svint32_t load(svbool_t pg, size_t i) { return svld1(pg, src + i); }
+    svint32_t accumulate(svbool_t pg, svint32_t acc, svint32_t v) { return svadd_m(pg, acc, v); }
+    svint32_t merge(svint32_t a, svint32_t b) { return svadd_x(svptrue_b32(), a, b); }
+    int64_t finish(svint32_t acc) { return svaddv(svptrue_b32(), acc); }
+};
+
+// --- Checks: every length up to four unrolled groups plus a partial vector ---
+
+// Enough elements for 4 unrolled vectors of bytes plus a partial one.
+size_t max_length() { return 4 * svcntb() + 13; }
+
+template <int Unroll>
+bool check_unroll() {
+    const size_t max_n = max_length();
+    std::vector<float> xf(max_n), yf(max_n);
+    std::vector<double> xd(max_n), yd(max_n);
+    std::vector<int8_t> a8(max_n), b8(max_n), d8(max_n);
+    std::vector<uint16_t> s16(max_n), d16(max_n);
+    std::vector<int64_t> s64(max_n), d64(max_n);
+    std::vector<int32_t> s32(max_n);
+
+    for (size_t n = 0; n <= max_n; ++n) {
+        // Refill everything: elements at and past n must come out unchanged.
+        for (size_t i = 0; i < max_n; ++i) {
+            xf[i] = (float)(i % 17);
+            yf[i] = (float)(i % 5);
+            xd[i] = (double)(i % 13);
+            yd[i] = (double)(i % 7) - 3.0;
+            a8[i] = (int8_t)(i * 37);
+            b8[i] = (int8_t)(i * 91);
+            d8[i] = 0x55;
+            s16[i] = (uint16_t)(i * 2731);
+            d16[i] = 0x5555;
+            s64[i] = ((int64_t)i << 20) * (i % 2 ? 1 : -1);
+            d64[i] = 0x5555;
+            s32[i] = (int32_t)(i % 101) - 50;
+        }
+
+        simd::sve::transform<Unroll>(n, AxpyF32{2.0f, xf.data(), yf.data()});
+        simd::sve::transform<Unroll>(n, AxpyF64{-0.5, xd.data(), yd.data()});
+        simd::sve::transform<Unroll>(n, AddSaturateS8{a8.data(), b8.data(), d8.data()});
+        simd::sve::transform<Unroll>(n, TripleU16{s16.data(), d16.data()});
+        simd::sve::transform<Unroll>(n, AbsS64{s64.data(), d64.data()});
+        double dot = simd::sve::reduce<Unroll>(n, DotF64{xd.data(), xd.data()});
+        int64_t sum = simd::sve::reduce<Unroll>(n, SumS32{s32.data()});
+
+        double dot_ref = 0.0;
+        int64_t sum_ref = 0;
+        for (size_t i = 0; i < max_n; ++i) {
+            bool in = i < n;
+            float yf_ref = in ? 2.0f * (float)(i % 17) + (float)(i % 5) : (float)(i % 5);
+            double yd_ref = in ? -0.5 * (double)(i % 13) + ((double)(i % 7) - 3.0) : (double)(i % 7) - 3.0;
+            int s = (int)(int8_t)(i * 37) + (int)(int8_t)(i * 91);
+            int8_t d8_ref = in ? (int8_t)(s > 127 ? 127 : s < -128 ? -128 : s) : 0x55;
+            uint16_t d16_ref = in ? (uint16_t)(s16[i] * 3) : 0x5555;
+            int64_t d64_ref = in ? (s64[i] < 0 ? -s64[i] : s64[i]) : 0x5555;
+            if (yf[i] != yf_ref || yd[i] != yd_ref || d8[i] != d8_ref || d16[i] != d16_ref || d64[i] != d64_ref) {
+                std::cout << "  mismatch at n=" << n << ", i=" << i << std::endl;
+                return false;
+            }
+            if (in) {
+                dot_ref += xd[i] * xd[i];
+                sum_ref += s32[i];
+            }
+        }
+        // Small integers: every partial sum is exact in any order.
+        if (dot != dot_ref || sum != sum_ref) {
+            std::cout << "  reduction mismatch at n=" << n << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "SVE vector length is " << svcntb() * 8 << " bits ("
+              << svcntw() << " x int32_t)." << std::endl;
+    std::cout << "Checking every length from 0 to " << max_length() << std::endl;
+
+    bool r1 = check_unroll<1>();
+    bool r2 = check_unroll<2>();
+    bool r3 = check_unroll<3>();
+    bool r4 = check_unroll<4>();
+    std::cout << "Unroll 1: " << (r1 ? "OK" : "MISMATCH") << std::endl;
+    std::cout << "Unroll 2: " << (r2 ? "OK" : "MISMATCH") << std::endl;
+    std::cout << "Unroll 3: " << (r3 ? "OK" : "MISMATCH") << std::endl;
+    std::cout << "Unroll 4: " << (r4 ? "OK" : "MISMATCH") << std::endl;
+
+    return r1 && r2 && r3 && r4 ? 0 : 1;
+}
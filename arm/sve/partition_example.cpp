@@ -0,0 +1,123 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <arm_sve.h>
+#include "partition_sve.h"
+
+namespace {
+
+uint32_t radix(uint64_t t, unsigned shift, unsigned bits) {
+    return ((uint32_t)t >> shift) & (uint32_t)(((size_t)1 << bits) - 1);
+}
+
+// Stable counting sort by the radix: what every partitioning must produce.
+std::vector<uint64_t> reference(const uint64_t* in, size_t n, unsigned bits, unsigned shift,
+                                std::vector<size_t>& offsets) {
+    offsets.assign(((size_t)1 << bits) + 1, 0);
+    for (size_t i = 0; i < n; ++i) ++offsets[radix(in[i], shift, bits) + 1];
+    for (size_t p = 1; p < offsets.size(); ++p) offsets[p] += offsets[p - 1];
+    std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+    std::vector<uint64_t> out(n);
+    for (size_t i = 0; i < n; ++i) out[cursor[radix(in[i], shift, bits)]++] = in[i];
+    return out;
+}
+
+std::vector<uint64_t> random_tuples(size_t n, uint64_t seed) {
+    std::vector<uint64_t> t(n);
+    std::mt19937_64 rng(seed);
+    for (uint64_t& x : t) x = rng();
+    return t;
+}
+
+// partition_chunk on lengths and output alignments around a cache line,
+// streamed and not, then the one- and two-pass functions on 1 to 8 threads.
+bool check() {
+    std::vector<uint64_t> in = random_tuples(300001, 1);
+    for (unsigned bits : {1u, 3u, 6u, 10u}) {
+        for (size_t n : {(size_t)0, (size_t)1, (size_t)7, (size_t)9, (size_t)100, (size_t)5000}) {
+            std::vector<size_t> offsets;
+            std::vector<uint64_t> want = reference(in.data(), n, bits, 5, offsets);
+            simd::sve::LineBuffers buffers(bits);
+            for (size_t skew = 0; skew < 8; ++skew) {
+                for (bool stream : {false, true}) {
+                    std::vector<uint64_t> out(n + 16, 7);
+                    std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+                    simd::sve::partition_chunk(in.data(), n, 5, bits, out.data() + skew, cursor.data(), buffers.p,
+                                               stream);
+                    if (!std::equal(want.begin(), want.end(), out.begin() + skew)) return false;
+                    for (size_t i = 0; i < skew; ++i) if (out[i] != 7) return false;
+                    for (size_t i = n + skew; i < out.size(); ++i) if (out[i] != 7) return false;
+                }
+            }
+        }
+    }
+    std::vector<uint64_t> out(in.size()), tmp(in.size());
+    std::vector<size_t> want_offsets, offsets(((size_t)1 << 12) + 1);
+    std::vector<uint64_t> want = reference(in.data(), in.size(), 12, 3, want_offsets);
+    for (unsigned threads : {1u, 2u, 3u, 8u}) {
+        simd::sve::radix_partition(in.data(), in.size(), 12, 3, out.data(), offsets.data(), threads);
+        if (out != want || offsets != want_offsets) return false;
+        std::fill(out.begin(), out.end(), 0);
+        simd::sve::radix_partition_2pass(in.data(), in.size(), 5, 7, 3, out.data(), tmp.data(), offsets.data(),
+                                         threads);
+        if (out != want || offsets != want_offsets) return false;
+    }
+    return true;
+}
+
+template <typename F>
+double seconds(F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 3; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::fixed << std::setprecision(1);
+    bool ok = check();
+    std::cout << "Partitioning vs reference: " << (ok ? "OK" : "MISMATCH") << std::endl;
+
+    // 8 M tuples (64 MiB), M tuples/s with counts included.
+    const size_t n = (size_t)1 << 23;
+    std::vector<uint64_t> in = random_tuples(n, 2), out(n), tmp(n);
+    std::cout << std::endl << "8 M tuples, M tuples/s:" << std::endl;
+    for (unsigned bits : {4u, 8u, 11u, 14u}) {
+        std::vector<size_t> offsets(((size_t)1 << bits) + 1);
+        double naive = seconds([&] {
+            std::vector<size_t> cursor;
+            offsets.assign(offsets.size(), 0);
+            for (size_t i = 0; i < n; ++i) ++offsets[radix(in[i], 0, bits) + 1];
+            for (size_t p = 1; p < offsets.size(); ++p) offsets[p] += offsets[p - 1];
+            cursor.assign(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < n; ++i) out[cursor[radix(in[i], 0, bits)]++] = in[i];
+        });
+        double swwc = seconds([&] { simd::sve::radix_partition(in.data(), n, bits, 0, out.data(), offsets.data(), 1); });
+        std::cout << "  " << std::setw(2) << bits << " bits: naive " << std::setw(6) << n / naive / 1e6 << ", SWWC "
+                  << std::setw(6) << n / swwc / 1e6 << std::endl;
+    }
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> offsets(((size_t)1 << 14) + 1);
+    for (unsigned t = 1;; t = std::min(t * 2, hw)) {
+        double one = seconds([&] { simd::sve::radix_partition(in.data(), n, 14, 0, out.data(), offsets.data(), t); });
+        double two = seconds([&] {
+            simd::sve::radix_partition_2pass(in.data(), n, 7, 7, 0, out.data(), tmp.data(), offsets.data(), t);
+        });
+        std::cout << "  14 bits, " << std::setw(2) << t << " threads: 1 pass " << std::setw(6) << n / one / 1e6
+                  << ", 2 passes " << std::setw(6) << n / two / 1e6 << std::endl;
+        if (t == hw) break;
+    }
+    return ok ? 0 : 1;
+}
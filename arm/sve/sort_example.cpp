@@ -0,0 +1,113 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <arm_sve.h>
+#include "sort_sve.h"
+
+namespace {
+
+template <typename K>
+std::vector<K> random_keys(size_t n, uint64_t range, uint64_t seed) {
+    std::vector<K> keys(n);
+    std::mt19937_64 rng(seed);
+    for (K& k : keys) k = (K)(range ? rng() % range : rng());
+    return keys;
+}
+
+// Sizes around the network (4L keys, L the power-of-two lane count) and the
+// cache blocks; uniform keys and keys with many repeats. Values must stay
+// with their keys; among equal keys their order is free.
+template <typename K, typename V>
+bool check_keys() {
+    const size_t l = simd::sve::Sorter<K, false>::lanes();
+    const size_t sizes[] = {0, 1, 2, l - 1, l, l + 1, 4 * l - 1, 4 * l, 4 * l + 1, 8 * l + 3, 1000, 16384,
+                            16385, 100003};
+    for (size_t n : sizes) {
+        for (uint64_t range : {(uint64_t)0, (uint64_t)10}) {
+            std::vector<K> keys = random_keys<K>(n, range, n + range);
+            std::vector<V> values(n);
+            for (size_t i = 0; i < n; ++i) values[i] = (V)i;
+            std::vector<std::pair<K, V> > want(n);
+            for (size_t i = 0; i < n; ++i) want[i] = std::make_pair(keys[i], values[i]);
+            std::sort(want.begin(), want.end());
+
+            std::vector<K> only = keys;
+            simd::sve::sort(only.data(), n);
+            for (size_t i = 0; i < n; ++i) if (only[i] != want[i].first) return false;
+
+            simd::sve::sort_pairs(keys.data(), values.data(), n);
+            std::vector<std::pair<K, V> > got(n);
+            for (size_t i = 0; i < n; ++i) got[i] = std::make_pair(keys[i], values[i]);
+            for (size_t i = 0; i < n; ++i) if (keys[i] != want[i].first) return false;
+            std::sort(got.begin(), got.end());
+            if (got != want) return false;
+        }
+    }
+    return true;
+}
+
+bool check_mapped() {
+    std::vector<uint32_t> u = random_keys<uint32_t>(10007, 0, 1), uw = u;
+    simd::sve::sort(u.data(), u.size());
+    std::sort(uw.begin(), uw.end());
+    std::vector<float> f(10007);
+    std::mt19937 rng(2);
+    std::normal_distribution<float> normal(0.0f, 100.0f);
+    for (float& x : f) x = normal(rng);
+    std::vector<float> fw = f;
+    simd::sve::sort(f.data(), f.size());
+    std::sort(fw.begin(), fw.end());
+    return u == uw && f == fw;
+}
+
+template <typename F>
+double seconds(F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 3; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return best;
+}
+
+// M keys/s for std::sort and the SVE sort on fresh copies of random keys.
+template <typename K>
+void bench(const char* title, size_t n) {
+    std::vector<K> input = random_keys<K>(n, 0, 3), keys(n);
+    double copy = seconds([&] { keys = input; });
+    double base = seconds([&] {
+        keys = input;
+        std::sort(keys.begin(), keys.end());
+    }) - copy;
+    double sve = seconds([&] {
+        keys = input;
+        simd::sve::sort(keys.data(), n);
+    }) - copy;
+    std::cout << "  " << title << ": std::sort " << n / base / 1e6 << ", SVE " << n / sve / 1e6 << " ("
+              << base / sve << "x)" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Vector length: " << svcntb() * 8 << " bits, network of "
+              << simd::sve::Sorter<int32_t, false>::lanes() << " x 32 bits" << std::endl;
+    bool ok32 = check_keys<int32_t, uint32_t>(), ok64 = check_keys<int64_t, uint64_t>(), mapped = check_mapped();
+    std::cout << "int32 keys and pairs vs std::sort: " << (ok32 ? "OK" : "MISMATCH") << std::endl;
+    std::cout << "int64 keys and pairs vs std::sort: " << (ok64 ? "OK" : "MISMATCH") << std::endl;
+    std::cout << "uint32_t and float keys: " << (mapped ? "OK" : "MISMATCH") << std::endl;
+
+    const size_t n = (size_t)1 << 22;
+    std::cout << "M keys/s, 4 M random keys:" << std::endl;
+    bench<int32_t>("int32", n);
+    bench<int64_t>("int64", n);
+    return ok32 && ok64 && mapped ? 0 : 1;
+}
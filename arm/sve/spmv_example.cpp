@@ -0,0 +1,153 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <cstdint>
+#include <arm_sve.h>
+#include "spmv_sve.h"
+
+// A CSR matrix that owns its arrays.
+struct Matrix {
+    const char* name;
+    size_t rows, cols;
+    std::vector<int64_t> row_ptr;
+    std::vector<int32_t> col_idx;
+    std::vector<float> values;
+
+    simd::CsrMatrix view() const {
+        simd::CsrMatrix m = {rows, cols, row_ptr.data(), col_idx.data(), values.data()};
+        return m;
+    }
+};
+
+// Appends one row with random values and closes it.
+void push_row(Matrix& m, const std::vector<int32_t>& cols, std::mt19937& rng) {
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    for (int32_t c : cols) {
+        m.col_idx.push_back(c);
+        m.values.push_back(value(rng));
+    }
+    m.row_ptr.push_back((int64_t)m.col_idx.size());
+}
+
+// Row lengths 0, 1, 2, ...: every partial-vector tail at any vector length.
+Matrix every_length(size_t n) {
+    Matrix m = {"row lengths 0 .. n-1", n, n, {0}, {}, {}};
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int32_t> col(0, (int32_t)n - 1);
+    std::vector<int32_t> cols;
+    for (size_t r = 0; r < n; ++r) {
+        cols.resize(r);
+        for (int32_t& c : cols) c = col(rng);
+        push_row(m, cols, rng);
+    }
+    return m;
+}
+
+// Web and social graphs: row lengths follow a power law and columns are
+// random, so most gathered elements miss the cache.
+Matrix power_law(size_t n) {
+    Matrix m = {"power-law, random columns (graph-like)", n, n, {0}, {}, {}};
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::uniform_int_distribution<int32_t> col(0, (int32_t)n - 1);
+    std::vector<int32_t> cols;
+    for (size_t r = 0; r < n; ++r) {
+        // Pareto with alpha = 1.5 and minimum 2: mean 6, heavy tail.
+        size_t len = std::min<size_t>(4096, (size_t)(2.0 / std::pow(1.0 - u(rng), 1.0 / 1.5)));
+        cols.resize(len);
+        for (int32_t& c : cols) c = col(rng);
+        push_row(m, cols, rng);
+    }
+    return m;
+}
+
+// Scalar reference used to check the SVE results.
+void spmv_reference(const Matrix& m, const float* x, float* y) {
+    for (size_t r = 0; r < m.rows; ++r) {
+        float sum = 0.0f;
+        for (int64_t k = m.row_ptr[r]; k < m.row_ptr[r + 1]; ++k) sum += m.values[k] * x[m.col_idx[k]];
+        y[r] = sum;
+    }
+}
+
+// y against the reference, relative to the magnitude of each row.
+bool check(const Matrix& m, const std::vector<float>& x, const std::vector<float>& y) {
+    std::vector<float> ref(m.rows);
+    spmv_reference(m, x.data(), ref.data());
+    for (size_t r = 0; r < m.rows; ++r) {
+        double scale = 0.0;
+        for (int64_t k = m.row_ptr[r]; k < m.row_ptr[r + 1]; ++k) {
+            scale += std::fabs(m.values[k] * x[m.col_idx[k]]);
+        }
+        if (std::fabs(y[r] - ref[r]) > 1e-5 * scale + 1e-30) return false;
+    }
+    return true;
+}
+
+template <typename F>
+double gflops(const Matrix& m, F run) {
+    run(); // warm up caches and page tables
+    const int reps = 3;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) run();
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return 2.0 * m.row_ptr.back() * reps / sec / 1e9;
+}
+
+bool benchmark(const Matrix& m) {
+    std::cout << std::endl << "[" << m.name << "]" << std::endl;
+    std::cout << m.rows << " rows, " << m.row_ptr.back() << " nonzeros" << std::endl;
+    std::vector<float> x(m.cols), y(m.rows);
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    for (float& v : x) v = value(rng);
+    simd::CsrMatrix a = m.view();
+
+    simd::sve::spmv_rows(a, x.data(), y.data(), 0, m.rows);
+    bool ok = check(m, x, y);
+    std::cout << "Cross-check: " << (ok ? "OK" : "MISMATCH") << std::endl;
+
+    // Under QEMU these numbers only compare the two paths, not the hardware.
+    double s = gflops(m, [&] { spmv_reference(m, x.data(), y.data()); });
+    double g = gflops(m, [&] { simd::sve::spmv_rows(a, x.data(), y.data(), 0, m.rows); });
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  scalar: " << s << " GFLOP/s" << std::endl;
+    std::cout << "     sve: " << g << " GFLOP/s (" << g / s << "x)" << std::endl;
+
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1;; threads = std::min(threads * 2, hw)) { // 1, 2, 4, ..., hw
+        double t = gflops(m, [&] { simd::sve::spmv(a, x.data(), y.data(), threads); });
+        std::cout << std::setw(3) << threads << " threads: " << t << " GFLOP/s" << std::endl;
+        if (threads == hw) break;
+    }
+    return ok && check(m, x, y);
+}
+
+int main() {
+    std::cout << "SVE vector width for float is " << svcntw() << " elements." << std::endl;
+
+    // [ 1 0 2 0 ]   [1]   [ 7]
+    // [ 0 3 0 0 ] * [2] = [ 6]
+    // [ 0 0 0 0 ]   [3]   [ 0]
+    // [ 4 0 5 6 ]   [4]   [43]
+    std::vector<int64_t> row_ptr = {0, 2, 3, 3, 6};
+    std::vector<int32_t> col_idx = {0, 2, 1, 0, 2, 3};
+    std::vector<float> values = {1, 2, 3, 4, 5, 6};
+    simd::CsrMatrix small = {4, 4, row_ptr.data(), col_idx.data(), values.data()};
+    float x4[4] = {1, 2, 3, 4};
+    float y4[4];
+    simd::sve::spmv(small, x4, y4);
+    std::cout << "\nA * [1 2 3 4] = [" << y4[0] << " " << y4[1] << " " << y4[2] << " " << y4[3] << "]"
+              << std::endl;
+
+    bool ok = true;
+    ok &= benchmark(every_length(300));
+    ok &= benchmark(power_law(1 << 16));
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+// STREAM-style bandwidth benchmark for SVE: copy, scale, add and triad with
+// regular (svld1/svst1) and non-temporal (svldnt1/svstnt1) loads and stores,
+// over working sets from L1 to DRAM and over thread counts. Writes the same
+// JSON layout as x86/kernels/stream_bench; progress goes to stderr.
+//
+//   sve_stream_bench [--quick] [--threads=1,2,8] [--max-mib=N] [--output=FILE]
+//
+// Bandwidth is counted the STREAM way: bytes read plus bytes written (copy and
+// scale 8 per element, add and triad 12), without the line fills that regular
+// stores cause.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <arm_sve.h>
+
+namespace {
+
+// --- Kernels ---
+// Each loop runs under svwhilelt, so n needs no particular multiple; the
+// driver still uses multiples of 64 to match the x86 benchmark.
+
+struct Ld1   { static svfloat32_t get(svbool_t pg, const float* p) { return svld1_f32(pg, p); } };
+struct LdNt1 { static svfloat32_t get(svbool_t pg, const float* p) { return svldnt1_f32(pg, p); } };
+struct St1   { static void put(svbool_t pg, float* p, svfloat32_t v) { svst1_f32(pg, p, v); } };
+struct StNt1 { static void put(svbool_t pg, float* p, svfloat32_t v) { svstnt1_f32(pg, p, v); } };
+
+template <typename L, typename S>
+struct K {
+    static void copy(float* c, const float* a, size_t n) {
+        for (size_t i = 0; i < n; i += svcntw()) {
+            svbool_t pg = svwhilelt_b32_u64(i, n);
+            S::put(pg, c + i, L::get(pg, a + i));
+        }
+    }
+    static void scale(float* b, const float* c, float s, size_t n) {
+        for (size_t i = 0; i < n; i += svcntw()) {
+            svbool_t pg = svwhilelt_b32_u64(i, n);
+            S::put(pg, b + i, svmul_n_f32_x(pg, L::get(pg, c + i), s));
+        }
+    }
+    static void add(float* c, const float* a, const float* b, size_t n) {
+        for (size_t i = 0; i < n; i += svcntw()) {
+            svbool_t pg = svwhilelt_b32_u64(i, n);
+            S::put(pg, c + i, svadd_f32_x(pg, L::get(pg, a + i), L::get(pg, b + i)));
+        }
+    }
+    static void triad(float* a, const float* b, const float* c, float s, size_t n) {
+        for (size_t i = 0; i < n; i += svcntw()) {
+            svbool_t pg = svwhilelt_b32_u64(i, n);
+            S::put(pg, a + i, svmla_n_f32_x(pg, L::get(pg, b + i), L::get(pg, c + i), s));
+        }
+    }
+};
+
+struct Flavor {
+    const char* load;
+    const char* store;
+    void (*copy)(float* c, const float* a, size_t n);
+    void (*scale)(float* b, const float* c, float s, size_t n);
+    void (*add)(float* c, const float* a, const float* b, size_t n);
+    void (*triad)(float* a, const float* b, const float* c, float s, size_t n);
+};
+
+#define FLAVOR(L, S, load, store) {load, store, K<L, S>::copy, K<L, S>::scale, K<L, S>::add, K<L, S>::triad}
+
+const Flavor kFlavors[] = {
+    FLAVOR(Ld1, St1, "ld1", "st1"),
+    FLAVOR(Ld1, StNt1, "ld1", "stnt1"),
+    FLAVOR(LdNt1, St1, "ldnt1", "st1"),
+    FLAVOR(LdNt1, StNt1, "ldnt1", "stnt1"),
+};
+
+#undef FLAVOR
+
+// --- Driver ---
+
+struct Options {
+    bool quick = false;
+    std::vector<unsigned> threads;
+    size_t max_bytes = (size_t)256 << 20;
+    std::string output;
+};
+
+// A flavor as run, with its sources offset by one float or not.
+struct Variant {
+    const Flavor* f;
+    bool misaligned;
+};
+
+enum Op { kCopy, kScale, kAdd, kTriad };
+const char* const kOpNames[] = {"copy", "scale", "add", "triad"};
+const size_t kOpBytes[] = {8, 8, 12, 12};
+const float kScalar = 3.0f;
+
+// Three arrays of n floats, 64-byte aligned, with room for a one-float offset.
+// The memory is left untouched, so that pages are placed by the first thread
+// that writes them.
+struct Arrays {
+    std::unique_ptr<float[]> storage;
+    float* a;
+    float* b;
+    float* c;
+    size_t n;
+
+    explicit Arrays(size_t n_) : storage(new float[3 * (n_ + 32)]), n(n_) {
+        float* p = storage.get();
+        p = (float*)(((uintptr_t)p + 63) & ~(uintptr_t)63);
+        a = p;
+        b = a + n + 16;
+        c = b + n + 16;
+    }
+};
+
+template <typename F>
+double run_threads(unsigned threads, F body) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) workers.emplace_back(body, t);
+    body(0);
+    for (std::thread& w : workers) w.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+size_t slice_of(size_t n, unsigned threads) {
+    return n / threads / 64 * 64;
+}
+
+void run_op(const Variant& v, Op op, const Arrays& m, size_t begin, size_t len) {
+    size_t off = v.misaligned ? 1 : 0;
+    float* a = m.a + begin;
+    float* b = m.b + begin;
+    float* c = m.c + begin;
+    switch (op) {
+        case kCopy:  v.f->copy(c, a + off, len); break;
+        case kScale: v.f->scale(b, c + off, kScalar, len); break;
+        case kAdd:   v.f->add(c, a + off, b + off, len); break;
+        case kTriad: v.f->triad(a, b + off, c + off, kScalar, len); break;
+    }
+}
+
+// Best of three timed runs, each about `target` seconds long.
+double measure(const Variant& v, Op op, const Arrays& m, unsigned threads, double target) {
+    size_t slice = slice_of(m.n, threads);
+    size_t reps = 1;
+    auto body = [&](unsigned t) {
+        for (size_t r = 0; r < reps; ++r) run_op(v, op, m, t * slice, slice);
+    };
+    for (;;) {
+        double sec = run_threads(threads, body);
+        if (sec >= target / 4 || reps >= ((size_t)1 << 30)) {
+            reps = std::max<size_t>(1, (size_t)((double)reps * target / std::max(sec, 1e-9)));
+            break;
+        }
+        reps *= 4;
+    }
+    double best = 1e30;
+    for (int trial = 0; trial < 3; ++trial) best = std::min(best, run_threads(threads, body));
+    return (double)kOpBytes[op] * slice * threads * reps / best / 1e9;
+}
+
+// Every kernel once on exactly representable values, against scalar loops.
+bool check_variant(const Variant& v) {
+    const size_t n = 1024;
+    Arrays m(n);
+    for (size_t i = 0; i < n + 16; ++i) {
+        m.a[i] = (float)(i % 13);
+        m.b[i] = (float)(i % 7);
+        m.c[i] = 0.0f;
+    }
+    size_t off = v.misaligned ? 1 : 0;
+    std::vector<float> a(m.a, m.a + n + 16), b(m.b, m.b + n + 16), c(m.c, m.c + n + 16);
+    for (size_t i = 0; i < n; ++i) c[i] = a[i + off];
+    for (size_t i = 0; i < n; ++i) b[i] = kScalar * c[i + off];
+    for (size_t i = 0; i < n; ++i) c[i] = a[i + off] + b[i + off];
+    for (size_t i = 0; i < n; ++i) a[i] = b[i + off] + kScalar * c[i + off];
+    for (int op = kCopy; op <= kTriad; ++op) run_op(v, (Op)op, m, 0, n);
+    return std::equal(a.begin(), a.begin() + n, m.a) && std::equal(b.begin(), b.begin() + n, m.b) &&
+           std::equal(c.begin(), c.begin() + n, m.c);
+}
+
+bool parse_args(int argc, char** argv, Options* o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--quick") {
+            o->quick = true;
+        } else if (arg.compare(0, 10, "--threads=") == 0) {
+            std::stringstream list(arg.substr(10));
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                int t = std::atoi(item.c_str());
+                if (t <= 0) return false;
+                o->threads.push_back((unsigned)t);
+            }
+        } else if (arg.compare(0, 10, "--max-mib=") == 0) {
+            o->max_bytes = (size_t)std::atoll(arg.c_str() + 10) << 20;
+        } else if (arg.compare(0, 9, "--output=") == 0) {
+            o->output = arg.substr(9);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, &opt)) {
+        std::cerr << "usage: " << argv[0] << " [--quick] [--threads=1,2,...] [--max-mib=N] [--output=FILE]"
+                  << std::endl;
+        return 2;
+    }
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    if (opt.threads.empty()) {
+        for (unsigned t = 1;; t = std::min(t * 2, hw)) { // 1, 2, 4, ..., hw
+            opt.threads.push_back(t);
+            if (t == hw) break;
+        }
+    }
+    double target = opt.quick ? 0.002 : 0.01;
+    size_t step = opt.quick ? 4 : 2;
+
+    std::vector<Variant> variants;
+    for (const Flavor& f : kFlavors) {
+        variants.push_back(Variant{&f, false});
+        variants.push_back(Variant{&f, true});
+    }
+    bool all_ok = true;
+    for (const Variant& v : variants) {
+        if (!check_variant(v)) {
+            std::cerr << "MISMATCH: " << v.f->load << "/" << v.f->store << (v.misaligned ? " misaligned" : "")
+                      << std::endl;
+            all_ok = false;
+        }
+    }
+
+    std::ofstream file;
+    if (!opt.output.empty()) file.open(opt.output.c_str());
+    std::ostream& out = opt.output.empty() ? std::cout : file;
+
+    // SVE does not report cache sizes to user space; the sweep runs up to
+    // --max-mib (256 MiB by default).
+    out << "{\n";
+    out << "  \"cpu\": {\"isa\": \"sve\", \"vector_bits\": " << svcntb() * 8 << ", \"hardware_threads\": " << hw
+        << "},\n";
+    out << "  \"verified\": " << (all_ok ? "true" : "false") << ",\n";
+    out << "  \"results\": [";
+    bool first = true;
+    for (size_t bytes = 12 << 10; bytes <= opt.max_bytes; bytes *= step) {
+        size_t n = bytes / 3 / sizeof(float) / 64 * 64;
+        Arrays m(n);
+        for (unsigned threads : opt.threads) {
+            size_t slice = slice_of(n, threads);
+            if (slice == 0) continue;
+            std::cerr << "working set " << (bytes >> 10) << " KiB, " << threads << " threads" << std::endl;
+            run_threads(threads, [&](unsigned t) {
+                size_t end = t + 1 == threads ? n + 16 : (t + 1) * slice;
+                for (size_t i = t * slice; i < end; ++i) {
+                    m.a[i] = 1.0f;
+                    m.b[i] = 2.0f;
+                    m.c[i] = 0.0f;
+                }
+            });
+            for (const Variant& v : variants) {
+                for (int op = kCopy; op <= kTriad; ++op) {
+                    double gbps = measure(v, (Op)op, m, threads, target);
+                    out << (first ? "\n" : ",\n") << "    {\"kernel\": \"" << kOpNames[op]
+                        << "\", \"isa\": \"sve\", \"bits\": " << svcntb() * 8 << ", \"load\": \"" << v.f->load
+                        << "\", \"misaligned\": " << (v.misaligned ? "true" : "false") << ", \"store\": \""
+                        << v.f->store << "\", \"working_set_bytes\": " << 3 * n * sizeof(float)
+                        << ", \"threads\": " << threads << ", \"gbps\": " << gbps << "}";
+                    first = false;
+                }
+            }
+        }
+    }
+    out << "\n  ]\n}\n";
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <arm_sve.h>
+#include "guard_page.h"
+#include "string_sve.h"
+
+// Every string length up to a few vectors, each placed so that its terminator
+// is the last readable byte.
+bool check_strings(const GuardedBuffer& buf) {
+    const size_t max_len = 4 * svcntb() + 7;
+    for (size_t len = 0; len <= max_len; ++len) {
+        char* s = reinterpret_cast<char*>(buf.end() - len - 1);
+        for (size_t i = 0; i < len; ++i) s[i] = (char)('a' + i % 26);
+        s[len] = '\0';
+
+        if (simd::sve::strlen(s) != len) return false;
+        if (simd::sve::strnlen(s, len + 1000) != len) return false;
+        if (simd::sve::strnlen(s, len / 2) != len / 2) return false;
+        if (simd::sve::strchr(s, 0) != s + len) return false;
+        if (simd::sve::strchr(s, '#') != nullptr) return false;
+        if (len > 0 && simd::sve::strchr(s, s[len - 1]) != std::strchr(s, s[len - 1])) return false;
+
+        // memchr over exactly the bytes up to the guard page.
+        if (simd::sve::memchr(s, '#', len + 1) != nullptr) return false;
+        if (simd::sve::memchr(s, 0, len + 1) != s + len) return false;
+        // ... and with an n that runs far past it: legal because 0 is found
+        // first, and safe because nothing past the match is ever faulted on.
+        if (simd::sve::memchr(s, 0, len + 4096) != s + len) return false;
+    }
+    return true;
+}
+
+void demo() {
+    std::cout << "\n--- Scanning a Key that Ends at a Guard Page ---" << std::endl;
+    GuardedBuffer buf(1);
+    const char key[] = "user:1024:session";
+    char* s = reinterpret_cast<char*>(buf.end() - sizeof(key));
+    std::memcpy(s, key, sizeof(key));
+
+    std::cout << "key:                   " << s << std::endl;
+    std::cout << "strlen:                " << simd::sve::strlen(s) << std::endl;
+    std::cout << "strchr(':') offset:    " << simd::sve::strchr(s, ':') - s << std::endl;
+    std::cout << "memchr('s') offset:    "
+              << static_cast<const char*>(simd::sve::memchr(s, 's', sizeof(key))) - s << std::endl;
+    std::cout << "strnlen(s, 4):         " << simd::sve::strnlen(s, 4) << std::endl;
+}
+
+int main() {
+    std::cout << "SVE vector width for uint8_t is " << svcntb() << " elements." << std::endl;
+
+    demo();
+
+    std::cout << "\n--- Cross-check against libc at the Page Boundary ---" << std::endl;
+    GuardedBuffer buf(2);
+    if (!buf.base) {
+        std::cout << "mmap failed" << std::endl;
+        return 1;
+    }
+    bool ok = check_strings(buf);
+    std::cout << "strlen/strnlen/strchr/memchr: " << (ok ? "OK" : "MISMATCH") << std::endl;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#!/bin/bash
+
+# Checks that simd::vec costs nothing: disassembles each vec_example binary and
+# compares every vec_<name> function with its hand-written raw_<name> twin,
+# instruction by instruction. Addresses, RIP-relative displacements and
+# alignment padding are normalised away; everything else must match, except
+# that the compiler may schedule the same instructions in a different order,
+# with other vector registers, or place a register clear on one path instead
+# of two (argument evaluation order differs between the two sources). A vec
+# function passes if it has no instruction its raw twin lacks.
+#
+# Usage: ./check_vec_codegen.sh [binary ...]
+# Default: ./build/kernels/vec_example_{sse41,avx2,avx512}
+
+OBJDUMP=${OBJDUMP:-objdump}
+
+if [ $# -eq 0 ]; then
+    set -- ./build/kernels/vec_example_sse41 ./build/kernels/vec_example_avx2 ./build/kernels/vec_example_avx512
+fi
+
+# The instructions of function $2 in binary $1, one per line.
+body() {
+    $OBJDUMP -d --no-show-raw-insn "$1" |
+        awk -v f="<$2>:" '$2 == f { on = 1; next } on && /^$/ { exit } on' |
+        cut -f2- |
+        sed -E 's/[[:space:]]*#.*//;
+                s/-?0x[0-9a-f]+\(%rip\)/(%rip)/g;
+                s/[0-9a-f]+ <(raw|vec)_[A-Za-z0-9_]+(\+0x[0-9a-f]+)?>/<self\2>/g;
+                s/[0-9a-f]+ </</g;
+                s/[[:space:]]+/ /g; s/ $//' |
+        grep -vE '^(nop|xchg %ax,%ax|cs nopw|data16|int3)'
+}
+
+# The same, as a sorted list with branch targets and vector register numbers
+# dropped.
+unordered() {
+    echo "$1" | sed -E 's/<self\+0x[0-9a-f]+>/<self>/g; s/%([xyz]mm|k)[0-9]+/%\1/g' | sort
+}
+
+status=0
+for bin in "$@"; do
+    if [ ! -x "$bin" ]; then
+        echo "Error: $bin not found; build first (./build.sh)"
+        exit 1
+    fi
+    echo "$bin"
+    for raw in $(nm "$bin" | awk '$2 == "T" && $3 ~ /^raw_/ { print $3 }' | sort); do
+        name=${raw#raw_}
+        if ! nm "$bin" | grep -q " T vec_$name\$"; then
+            echo "  $name: no vec_$name"
+            status=1
+            continue
+        fi
+        a=$(body "$bin" "$raw")
+        b=$(body "$bin" "vec_$name")
+        if [ -n "$a" ] && [ "$a" == "$b" ]; then
+            echo "  $name: identical ($(echo "$a" | wc -l) instructions)"
+        elif [ -n "$a" ] && [ "$(unordered "$a")" == "$(unordered "$b")" ]; then
+            echo "  $name: same $(echo "$a" | wc -l) instructions, scheduled differently"
+        elif [ -n "$a" ] && [ -z "$(comm -13 <(unordered "$a") <(unordered "$b"))" ]; then
+            echo "  $name: $(echo "$b" | wc -l) instructions, all in the raw $(echo "$a" | wc -l)"
+        else
+            echo "  $name: DIFFERENT"
+            diff <(echo "$a") <(echo "$b") | sed 's/^/    /'
+            status=1
+        fi
+    done
+done
+exit $status
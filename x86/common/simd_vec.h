@@ -0,0 +1,531 @@
+#ifndef SIMD_VEC_H
+#define SIMD_VEC_H
+
+// simd::vec<T, N>: N lanes of T in one SSE, AVX or AVX-512 register, with the
+// same interface at every width. A kernel written against vec<float, 8> compiles
+// to exactly the AVX instructions one would write by hand; the same kernel on
+// vec<float, 16> compiles to AVX-512. Nothing is chosen at run time.
+//
+//   typedef simd::native_vec<float> V;          // widest the flags allow
+//   size_t i = 0;
+//   for (; i + V::lanes <= n; i += V::lanes)
+//       simd::fma(V::broadcast(a), V::loadu(x + i), V::loadu(y + i)).storeu(y + i);
+//   if (i < n) {                                 // AVX and up
+//       V::mask_type m = V::first_n(n - i);
+//       simd::fma(V::broadcast(a), V::load_masked(m, x + i), V::load_masked(m, y + i)).store_masked(m, y + i);
+//   }
+//
+// Available widths, by compiler flags:
+//
+//   vec<float, 4>, vec<double, 2>, vec<int32_t, 4>     -msse4.1
+//   vec<float, 8>, vec<double, 4>                      -mavx
+//   vec<int32_t, 8>                                    -mavx2
+//   vec<float, 16>, vec<double, 8>, vec<int32_t, 16>   -mavx512f
+//
+// and, at every width, only what the hardware has:
+//
+//   load_masked / store_masked    -mavx (int32_t: -mavx2); AVX-512 widths always
+//   gather                        -mavx2; AVX-512 widths always
+//   scatter                       -mavx512vl; AVX-512 widths always
+//
+// Using an operation the flags do not provide is a compile error rather than
+// a silent scalar fallback. For a code path that must build at several levels,
+// SIMD_VEC_HAS_MASKED, SIMD_VEC_HAS_GATHER and SIMD_VEC_HAS_SCATTER say what
+// native_vec<T> supports.
+//
+// Masks are what the hardware compares into: a k-register (__mmask16 or
+// __mmask8) at 512 bits, an all-ones/all-zeros integer vector below. vec<T, N>
+// converts to and from its register type, so raw intrinsics mix freely with
+// it. check_vec_codegen.sh disassembles vec_example and compares each vec
+// kernel against its hand-written intrinsic twin instruction by instruction.
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include "simd_utils.h"
+
+namespace simd {
+
+// Everything here has internal linkage, so that translation units built with
+// different -m flags (see kernels/CMakeLists.txt) each keep their own code.
+namespace {
+
+namespace detail {
+
+// The lanes starting at kVecWindow32 + 8 - n (kVecWindow64 + 4 - n) have
+// exactly their first n set, as in kernels/tail_mask.h.
+alignas(64) constexpr int32_t kVecWindow32[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+alignas(64) constexpr int64_t kVecWindow64[8] = {-1, -1, -1, -1, 0, 0, 0, 0};
+
+// One specialization per (T, N) the target supports; vec<T, N> forwards to it.
+template <typename T, int N> struct vec_ops;
+
+#if defined(__SSE4_1__)
+
+inline float hsum128(__m128 v) {
+    __m128 t = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    t = _mm_add_ss(t, _mm_shuffle_ps(t, t, 1));
+    return _mm_cvtss_f32(t);
+}
+
+inline double hsum128d(__m128d v) {
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+inline int32_t hsum128i(__m128i v) {
+    __m128i t = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0x4E));
+    t = _mm_add_epi32(t, _mm_shuffle_epi32(t, 0xB1));
+    return _mm_cvtsi128_si32(t);
+}
+
+template <> struct vec_ops<float, 4> {
+    typedef __m128 reg;
+    typedef __m128i mask;
+    typedef __m128i index;
+    static reg zero() { return _mm_setzero_ps(); }
+    static reg set1(float x) { return _mm_set1_ps(x); }
+    static reg load(const float* p) { return _mm_load_ps(p); }
+    static reg loadu(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, reg v) { _mm_store_ps(p, v); }
+    static void storeu(float* p, reg v) { _mm_storeu_ps(p, v); }
+    static void stream(float* p, reg v) { _mm_stream_ps(p, v); }
+    static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+    static reg div(reg a, reg b) { return _mm_div_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+#if defined(__FMA__)
+    static reg fma(reg a, reg b, reg c) { return _mm_fmadd_ps(a, b, c); }
+#else
+    static reg fma(reg a, reg b, reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#endif
+    static float reduce_add(reg v) { return hsum128(v); }
+    static mask lt(reg a, reg b) { return _mm_castps_si128(_mm_cmplt_ps(a, b)); }
+    static mask eq(reg a, reg b) { return _mm_castps_si128(_mm_cmpeq_ps(a, b)); }
+    static reg select(mask m, reg a, reg b) { return _mm_blendv_ps(b, a, _mm_castsi128_ps(m)); }
+    static mask first_n(size_t n) { return _mm_loadu_si128((const __m128i*)(kVecWindow32 + 8 - n)); }
+#if defined(__AVX__)
+    static reg load_masked(mask m, const float* p) { return _mm_maskload_ps(p, m); }
+    static void store_masked(mask m, float* p, reg v) { _mm_maskstore_ps(p, m, v); }
+#endif
+#if defined(__AVX2__)
+    static reg gather(const float* p, index i) { return _mm_i32gather_ps(p, i, 4); }
+#endif
+#if defined(__AVX512VL__)
+    static void scatter(float* p, index i, reg v) { _mm_i32scatter_ps(p, i, v, 4); }
+#endif
+};
+
+template <> struct vec_ops<double, 2> {
+    typedef __m128d reg;
+    typedef __m128i mask;
+    typedef __m128i index;  // lanes 0 and 1
+    static reg zero() { return _mm_setzero_pd(); }
+    static reg set1(double x) { return _mm_set1_pd(x); }
+    static reg load(const double* p) { return _mm_load_pd(p); }
+    static reg loadu(const double* p) { return _mm_loadu_pd(p); }
+    static void store(double* p, reg v) { _mm_store_pd(p, v); }
+    static void storeu(double* p, reg v) { _mm_storeu_pd(p, v); }
+    static void stream(double* p, reg v) { _mm_stream_pd(p, v); }
+    static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+    static reg div(reg a, reg b) { return _mm_div_pd(a, b); }
+    static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+#if defined(__FMA__)
+    static reg fma(reg a, reg b, reg c) { return _mm_fmadd_pd(a, b, c); }
+#else
+    static reg fma(reg a, reg b, reg c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+#endif
+    static double reduce_add(reg v) { return hsum128d(v); }
+    static mask lt(reg a, reg b) { return _mm_castpd_si128(_mm_cmplt_pd(a, b)); }
+    static mask eq(reg a, reg b) { return _mm_castpd_si128(_mm_cmpeq_pd(a, b)); }
+    static reg select(mask m, reg a, reg b) { return _mm_blendv_pd(b, a, _mm_castsi128_pd(m)); }
+    static mask first_n(size_t n) { return _mm_loadu_si128((const __m128i*)(kVecWindow64 + 4 - n)); }
+#if defined(__AVX__)
+    static reg load_masked(mask m, const double* p) { return _mm_maskload_pd(p, m); }
+    static void store_masked(mask m, double* p, reg v) { _mm_maskstore_pd(p, m, v); }
+#endif
+#if defined(__AVX2__)
+    static reg gather(const double* p, index i) { return _mm_i32gather_pd(p, i, 8); }
+#endif
+#if defined(__AVX512VL__)
+    static void scatter(double* p, index i, reg v) { _mm_i32scatter_pd(p, i, v, 8); }
+#endif
+};
+
+template <> struct vec_ops<int32_t, 4> {
+    typedef __m128i reg;
+    typedef __m128i mask;
+    typedef __m128i index;
+    static reg zero() { return _mm_setzero_si128(); }
+    static reg set1(int32_t x) { return _mm_set1_epi32(x); }
+    static reg load(const int32_t* p) { return _mm_load_si128((const __m128i*)p); }
+    static reg loadu(const int32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static void store(int32_t* p, reg v) { _mm_store_si128((__m128i*)p, v); }
+    static void storeu(int32_t* p, reg v) { _mm_storeu_si128((__m128i*)p, v); }
+    static void stream(int32_t* p, reg v) { _mm_stream_si128((__m128i*)p, v); }
+    static reg add(reg a, reg b) { return _mm_add_epi32(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_epi32(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mullo_epi32(a, b); }
+    static reg min(reg a, reg b) { return _mm_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm_max_epi32(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm_add_epi32(_mm_mullo_epi32(a, b), c); }
+    static int32_t reduce_add(reg v) { return hsum128i(v); }
+    static mask lt(reg a, reg b) { return _mm_cmplt_epi32(a, b); }
+    static mask eq(reg a, reg b) { return _mm_cmpeq_epi32(a, b); }
+    static reg select(mask m, reg a, reg b) { return _mm_blendv_epi8(b, a, m); }
+    static mask first_n(size_t n) { return _mm_loadu_si128((const __m128i*)(kVecWindow32 + 8 - n)); }
+#if defined(__AVX2__)
+    static reg load_masked(mask m, const int32_t* p) { return _mm_maskload_epi32((const int*)p, m); }
+    static void store_masked(mask m, int32_t* p, reg v) { _mm_maskstore_epi32((int*)p, m, v); }
+    static reg gather(const int32_t* p, index i) { return _mm_i32gather_epi32((const int*)p, i, 4); }
+#endif
+#if defined(__AVX512VL__)
+    static void scatter(int32_t* p, index i, reg v) { _mm_i32scatter_epi32(p, i, v, 4); }
+#endif
+};
+
+#endif // __SSE4_1__
+
+#if defined(__AVX__)
+
+template <> struct vec_ops<float, 8> {
+    typedef __m256 reg;
+    typedef __m256i mask;
+    typedef __m256i index;
+    static reg zero() { return _mm256_setzero_ps(); }
+    static reg set1(float x) { return _mm256_set1_ps(x); }
+    static reg load(const float* p) { return _mm256_load_ps(p); }
+    static reg loadu(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, reg v) { _mm256_store_ps(p, v); }
+    static void storeu(float* p, reg v) { _mm256_storeu_ps(p, v); }
+    static void stream(float* p, reg v) { _mm256_stream_ps(p, v); }
+    static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+    static reg div(reg a, reg b) { return _mm256_div_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+#if defined(__FMA__)
+    static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+    static reg fma(reg a, reg b, reg c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+    static float reduce_add(reg v) {
+        return hsum128(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+    }
+    static mask lt(reg a, reg b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+    static mask eq(reg a, reg b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+    static reg select(mask m, reg a, reg b) { return _mm256_blendv_ps(b, a, _mm256_castsi256_ps(m)); }
+    static mask first_n(size_t n) { return _mm256_loadu_si256((const __m256i*)(kVecWindow32 + 8 - n)); }
+    static reg load_masked(mask m, const float* p) { return _mm256_maskload_ps(p, m); }
+    static void store_masked(mask m, float* p, reg v) { _mm256_maskstore_ps(p, m, v); }
+#if defined(__AVX2__)
+    static reg gather(const float* p, index i) { return _mm256_i32gather_ps(p, i, 4); }
+#endif
+#if defined(__AVX512VL__)
+    static void scatter(float* p, index i, reg v) { _mm256_i32scatter_ps(p, i, v, 4); }
+#endif
+};
+
+template <> struct vec_ops<double, 4> {
+    typedef __m256d reg;
+    typedef __m256i mask;
+    typedef __m128i index;
+    static reg zero() { return _mm256_setzero_pd(); }
+    static reg set1(double x) { return _mm256_set1_pd(x); }
+    static reg load(const double* p) { return _mm256_load_pd(p); }
+    static reg loadu(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, reg v) { _mm256_store_pd(p, v); }
+    static void storeu(double* p, reg v) { _mm256_storeu_pd(p, v); }
+    static void stream(double* p, reg v) { _mm256_stream_pd(p, v); }
+    static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+    static reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+#if defined(__FMA__)
+    static reg fma(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+#else
+    static reg fma(reg a, reg b, reg c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+#endif
+    static double reduce_add(reg v) {
+        return hsum128d(_mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)));
+    }
+    static mask lt(reg a, reg b) { return _mm256_castpd_si256(_mm256_cmp_pd(a, b, _CMP_LT_OQ)); }
+    static mask eq(reg a, reg b) { return _mm256_castpd_si256(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+    static reg select(mask m, reg a, reg b) { return _mm256_blendv_pd(b, a, _mm256_castsi256_pd(m)); }
+    static mask first_n(size_t n) { return _mm256_loadu_si256((const __m256i*)(kVecWindow64 + 4 - n)); }
+    static reg load_masked(mask m, const double* p) { return _mm256_maskload_pd(p, m); }
+    static void store_masked(mask m, double* p, reg v) { _mm256_maskstore_pd(p, m, v); }
+#if defined(__AVX2__)
+    static reg gather(const double* p, index i) { return _mm256_i32gather_pd(p, i, 8); }
+#endif
+#if defined(__AVX512VL__)
+    static void scatter(double* p, index i, reg v) { _mm256_i32scatter_pd(p, i, v, 8); }
+#endif
+};
+
+#endif // __AVX__
+
+#if defined(__AVX2__)
+
+template <> struct vec_ops<int32_t, 8> {
+    typedef __m256i reg;
+    typedef __m256i mask;
+    typedef __m256i index;
+    static reg zero() { return _mm256_setzero_si256(); }
+    static reg set1(int32_t x) { return _mm256_set1_epi32(x); }
+    static reg load(const int32_t* p) { return _mm256_load_si256((const __m256i*)p); }
+    static reg loadu(const int32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static void store(int32_t* p, reg v) { _mm256_store_si256((__m256i*)p, v); }
+    static void storeu(int32_t* p, reg v) { _mm256_storeu_si256((__m256i*)p, v); }
+    static void stream(int32_t* p, reg v) { _mm256_stream_si256((__m256i*)p, v); }
+    static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_epi32(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mullo_epi32(a, b); }
+    static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm256_add_epi32(_mm256_mullo_epi32(a, b), c); }
+    static int32_t reduce_add(reg v) {
+        return hsum128i(_mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+    }
+    static mask lt(reg a, reg b) { return _mm256_cmpgt_epi32(b, a); }
+    static mask eq(reg a, reg b) { return _mm256_cmpeq_epi32(a, b); }
+    static reg select(mask m, reg a, reg b) { return _mm256_blendv_epi8(b, a, m); }
+    static mask first_n(size_t n) { return _mm256_loadu_si256((const __m256i*)(kVecWindow32 + 8 - n)); }
+    static reg load_masked(mask m, const int32_t* p) { return _mm256_maskload_epi32((const int*)p, m); }
+    static void store_masked(mask m, int32_t* p, reg v) { _mm256_maskstore_epi32((int*)p, m, v); }
+    static reg gather(const int32_t* p, index i) { return _mm256_i32gather_epi32((const int*)p, i, 4); }
+#if defined(__AVX512VL__)
+    static void scatter(int32_t* p, index i, reg v) { _mm256_i32scatter_epi32(p, i, v, 4); }
+#endif
+};
+
+#endif // __AVX2__
+
+#if defined(__AVX512F__)
+
+// The low n bits set, as a k-register mask.
+inline unsigned low_bits(unsigned n) {
+#if defined(__BMI2__)
+    return _bzhi_u32(0xFFFF, n);
+#else
+    return (1u << n) - 1;
+#endif
+}
+
+template <> struct vec_ops<float, 16> {
+    typedef __m512 reg;
+    typedef __mmask16 mask;
+    typedef __m512i index;
+    static reg zero() { return _mm512_setzero_ps(); }
+    static reg set1(float x) { return _mm512_set1_ps(x); }
+    static reg load(const float* p) { return _mm512_load_ps(p); }
+    static reg loadu(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, reg v) { _mm512_store_ps(p, v); }
+    static void storeu(float* p, reg v) { _mm512_storeu_ps(p, v); }
+    static void stream(float* p, reg v) { _mm512_stream_ps(p, v); }
+    static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+    static reg div(reg a, reg b) { return _mm512_div_ps(a, b); }
+    static reg min(reg a, reg b) { return _mm512_min_ps(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_ps(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+    static float reduce_add(reg v) { return _mm512_reduce_add_ps(v); }
+    static mask lt(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static mask eq(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+    static reg select(mask m, reg a, reg b) { return _mm512_mask_blend_ps(m, b, a); }
+    static mask first_n(size_t n) { return (mask)detail::low_bits((unsigned)n); }
+    static reg load_masked(mask m, const float* p) { return _mm512_maskz_loadu_ps(m, p); }
+    static void store_masked(mask m, float* p, reg v) { _mm512_mask_storeu_ps(p, m, v); }
+    static reg gather(const float* p, index i) { return _mm512_i32gather_ps(i, p, 4); }
+    static void scatter(float* p, index i, reg v) { _mm512_i32scatter_ps(p, i, v, 4); }
+};
+
+template <> struct vec_ops<double, 8> {
+    typedef __m512d reg;
+    typedef __mmask8 mask;
+    typedef __m256i index;
+    static reg zero() { return _mm512_setzero_pd(); }
+    static reg set1(double x) { return _mm512_set1_pd(x); }
+    static reg load(const double* p) { return _mm512_load_pd(p); }
+    static reg loadu(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, reg v) { _mm512_store_pd(p, v); }
+    static void storeu(double* p, reg v) { _mm512_storeu_pd(p, v); }
+    static void stream(double* p, reg v) { _mm512_stream_pd(p, v); }
+    static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+    static reg div(reg a, reg b) { return _mm512_div_pd(a, b); }
+    static reg min(reg a, reg b) { return _mm512_min_pd(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_pd(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+    static double reduce_add(reg v) { return _mm512_reduce_add_pd(v); }
+    static mask lt(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static mask eq(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+    static reg select(mask m, reg a, reg b) { return _mm512_mask_blend_pd(m, b, a); }
+    static mask first_n(size_t n) { return (mask)detail::low_bits((unsigned)n); }
+    static reg load_masked(mask m, const double* p) { return _mm512_maskz_loadu_pd(m, p); }
+    static void store_masked(mask m, double* p, reg v) { _mm512_mask_storeu_pd(p, m, v); }
+    static reg gather(const double* p, index i) { return _mm512_i32gather_pd(i, p, 8); }
+    static void scatter(double* p, index i, reg v) { _mm512_i32scatter_pd(p, i, v, 8); }
+};
+
+template <> struct vec_ops<int32_t, 16> {
+    typedef __m512i reg;
+    typedef __mmask16 mask;
+    typedef __m512i index;
+    static reg zero() { return _mm512_setzero_si512(); }
+    static reg set1(int32_t x) { return _mm512_set1_epi32(x); }
+    static reg load(const int32_t* p) { return _mm512_load_si512(p); }
+    static reg loadu(const int32_t* p) { return _mm512_loadu_si512(p); }
+    static void store(int32_t* p, reg v) { _mm512_store_si512(p, v); }
+    static void storeu(int32_t* p, reg v) { _mm512_storeu_si512(p, v); }
+    static void stream(int32_t* p, reg v) { _mm512_stream_si512((__m512i*)p, v); }
+    static reg add(reg a, reg b) { return _mm512_add_epi32(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_epi32(a, b); }
+    static reg mul(reg a, reg b) { return _mm512_mullo_epi32(a, b); }
+    static reg min(reg a, reg b) { return _mm512_min_epi32(a, b); }
+    static reg max(reg a, reg b) { return _mm512_max_epi32(a, b); }
+    static reg fma(reg a, reg b, reg c) { return _mm512_add_epi32(_mm512_mullo_epi32(a, b), c); }
+    static int32_t reduce_add(reg v) { return _mm512_reduce_add_epi32(v); }
+    static mask lt(reg a, reg b) { return _mm512_cmplt_epi32_mask(a, b); }
+    static mask eq(reg a, reg b) { return _mm512_cmpeq_epi32_mask(a, b); }
+    static reg select(mask m, reg a, reg b) { return _mm512_mask_blend_epi32(m, b, a); }
+    static mask first_n(size_t n) { return (mask)detail::low_bits((unsigned)n); }
+    static reg load_masked(mask m, const int32_t* p) { return _mm512_maskz_loadu_epi32(m, p); }
+    static void store_masked(mask m, int32_t* p, reg v) { _mm512_mask_storeu_epi32(p, m, v); }
+    static reg gather(const int32_t* p, index i) { return _mm512_i32gather_epi32(i, p, 4); }
+    static void scatter(int32_t* p, index i, reg v) { _mm512_i32scatter_epi32(p, i, v, 4); }
+};
+
+#endif // __AVX512F__
+
+} // namespace detail
+
+template <typename T, int N>
+struct vec {
+    typedef detail::vec_ops<T, N> ops;
+    typedef T value_type;
+    typedef typename ops::reg reg_type;
+    typedef typename ops::mask mask_type;
+    // Lane indices for gather/scatter: vec<int32_t, N>, or its low lanes for
+    // double.
+    typedef typename ops::index index_type;
+    static constexpr int lanes = N;
+
+    reg_type r;
+
+    vec() = default;
+    vec(reg_type x) : r(x) {}
+    operator reg_type() const { return r; }
+
+    static vec zero() { return ops::zero(); }
+    static vec broadcast(T x) { return ops::set1(x); }
+    static vec load(const T* p) { return ops::load(p); }  // aligned to sizeof(vec)
+    static vec loadu(const T* p) { return ops::loadu(p); }
+    static vec load_masked(mask_type m, const T* p) { return ops::load_masked(m, p); }
+    static vec gather(const T* base, index_type idx) { return ops::gather(base, idx); }
+    // Mask of the first n lanes, n <= N.
+    static mask_type first_n(size_t n) { return ops::first_n(n); }
+
+    void store(T* p) const { ops::store(p, r); }
+    void storeu(T* p) const { ops::storeu(p, r); }
+    // Non-temporal, aligned; follow a run of them with _mm_sfence().
+    void stream(T* p) const { ops::stream(p, r); }
+    void store_masked(mask_type m, T* p) const { ops::store_masked(m, p, r); }
+    // Lanes with equal indices land in lane order: the highest lane wins.
+    void scatter(T* base, index_type idx) const { ops::scatter(base, idx, r); }
+};
+
+template <typename T, int N> constexpr int vec<T, N>::lanes;
+
+template <typename T, int N> vec<T, N> operator+(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::add(a.r, b.r); }
+template <typename T, int N> vec<T, N> operator-(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::sub(a.r, b.r); }
+template <typename T, int N> vec<T, N> operator*(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::mul(a.r, b.r); }
+template <typename T, int N> vec<T, N> operator/(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::div(a.r, b.r); }
+template <typename T, int N> vec<T, N>& operator+=(vec<T, N>& a, vec<T, N> b) { return a = a + b; }
+template <typename T, int N> vec<T, N>& operator-=(vec<T, N>& a, vec<T, N> b) { return a = a - b; }
+template <typename T, int N> vec<T, N>& operator*=(vec<T, N>& a, vec<T, N> b) { return a = a * b; }
+
+// a * b + c, fused where the flags allow (one rounding) and two instructions
+// otherwise.
+template <typename T, int N> vec<T, N> fma(vec<T, N> a, vec<T, N> b, vec<T, N> c) { return vec<T, N>::ops::fma(a.r, b.r, c.r); }
+template <typename T, int N> vec<T, N> min(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::min(a.r, b.r); }
+template <typename T, int N> vec<T, N> max(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::max(a.r, b.r); }
+template <typename T, int N> T reduce_add(vec<T, N> v) { return vec<T, N>::ops::reduce_add(v.r); }
+
+template <typename T, int N> typename vec<T, N>::mask_type operator<(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::lt(a.r, b.r); }
+template <typename T, int N> typename vec<T, N>::mask_type operator>(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::lt(b.r, a.r); }
+template <typename T, int N> typename vec<T, N>::mask_type operator==(vec<T, N> a, vec<T, N> b) { return vec<T, N>::ops::eq(a.r, b.r); }
+// Lane i is a[i] where m is set, b[i] elsewhere.
+template <typename T, int N> vec<T, N> select(typename vec<T, N>::mask_type m, vec<T, N> a, vec<T, N> b) {
+    return vec<T, N>::ops::select(m, a.r, b.r);
+}
+
+// The print_* helpers of simd_utils.h, for any vec.
+#if defined(__SSE4_1__)
+inline void print(vec<float, 4> v) { print_m128(v); }
+inline void print(vec<double, 2> v) { print_m128d(v); }
+inline void print(vec<int32_t, 4> v) { print_m128i(v); }
+#endif
+#if defined(__AVX__)
+inline void print(vec<float, 8> v) { print_m256(v); }
+inline void print(vec<double, 4> v) { print_m256d(v); }
+#endif
+#if defined(__AVX2__)
+inline void print(vec<int32_t, 8> v) { print_m256i(v); }
+#endif
+#if defined(__AVX512F__)
+inline void print(vec<float, 16> v) { print_m512(v); }
+inline void print(vec<double, 8> v) { print_m512d(v); }
+inline void print(vec<int32_t, 16> v) { print_m512i(v); }
+#endif
+
+// The widest register the compiler flags allow.
+#if defined(__AVX512F__)
+#define SIMD_VEC_NATIVE_BYTES 64
+#elif defined(__AVX__)
+#define SIMD_VEC_NATIVE_BYTES 32
+#else
+#define SIMD_VEC_NATIVE_BYTES 16
+#endif
+
+// native_vec<T> exists for float and double everywhere from -msse4.1, and for
+// int32_t where its width does (AVX alone has no 256-bit integer vector, so
+// -mavx without -mavx2 gives vec<int32_t, 4>).
+template <typename T> struct native_width { enum { value = SIMD_VEC_NATIVE_BYTES / sizeof(T) }; };
+#if defined(__AVX__) && !defined(__AVX2__) && !defined(__AVX512F__)
+template <> struct native_width<int32_t> { enum { value = 4 }; };
+#endif
+template <typename T> using native_vec = vec<T, native_width<T>::value>;
+
+#if defined(__AVX512F__)
+#define SIMD_VEC_HAS_MASKED 1
+#define SIMD_VEC_HAS_GATHER 1
+#define SIMD_VEC_HAS_SCATTER 1
+#elif defined(__AVX2__)
+#define SIMD_VEC_HAS_MASKED 1
+#define SIMD_VEC_HAS_GATHER 1
+#define SIMD_VEC_HAS_SCATTER 0
+#elif defined(__AVX__)
+#define SIMD_VEC_HAS_MASKED 1  // float and double only
+#define SIMD_VEC_HAS_GATHER 0
+#define SIMD_VEC_HAS_SCATTER 0
+#else
+#define SIMD_VEC_HAS_MASKED 0
+#define SIMD_VEC_HAS_GATHER 0
+#define SIMD_VEC_HAS_SCATTER 0
+#endif
+
+} // namespace
+
+} // namespace simd
+
+#endif // SIMD_VEC_H
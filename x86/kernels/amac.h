@@ -0,0 +1,74 @@
+#ifndef SIMD_AMAC_H
+#define SIMD_AMAC_H
+
+#include <cstddef>
+#include <xmmintrin.h>
+
+namespace simd {
+
+// Interleaved execution of independent pointer-chasing lookups (AMAC,
+// asynchronous memory access chaining; Kocberber et al., VLDB 2015).
+//
+// A tree descent or a walk down a hash chain is a chain of dependent loads:
+// the next address is known only once the current load is back. One lookup
+// at a time therefore costs one DRAM round trip per level, and neither the
+// out-of-order window nor a hardware gather helps, because there is nothing
+// independent to issue. amac_run keeps kInFlight lookups open instead. Each
+// is a small state machine that, at every step, does one load and returns
+// the address of the next one; the engine prefetches that address and moves
+// on to the other lookups, so by the time it comes back the line is there.
+// When a lookup finishes, its slot starts the next one at once, so lookups of
+// different lengths keep all slots busy.
+//
+// A Probe provides:
+//
+//   typedef ... State;                             one lookup in flight
+//   const void* start(size_t i, State& s);         begins lookup i
+//   const void* step(State& s);                    does one dependent load
+//
+// Both return the address the lookup will read next, or null once it is
+// done (the probe writes the result itself); start may finish a lookup that
+// needs no load. Lookups start in order 0 .. n - 1 but may finish in any
+// order.
+//
+// kInFlight should cover the memory latency divided by the work of one
+// step: 8 to 16 for a few instructions per step. More slots than the core
+// has line fill buffers (10 to 16) only add state.
+
+template <size_t kInFlight, typename Probe>
+void amac_run(Probe& probe, size_t n) {
+    typename Probe::State state[kInFlight];
+    bool live[kInFlight];
+    size_t next = 0, active = 0;
+    // Starts lookups in slot s until one needs a load or none are left.
+    auto refill = [&](size_t s) {
+        while (next < n) {
+            const void* p = probe.start(next++, state[s]);
+            if (p) {
+                _mm_prefetch((const char*)p, _MM_HINT_T0);
+                return true;
+            }
+        }
+        return false;
+    };
+    for (size_t s = 0; s < kInFlight; ++s) {
+        live[s] = refill(s);
+        active += live[s];
+    }
+    while (active) {
+        for (size_t s = 0; s < kInFlight; ++s) {
+            if (!live[s]) continue;
+            const void* p = probe.step(state[s]);
+            if (p) {
+                _mm_prefetch((const char*)p, _MM_HINT_T0);
+            } else if (!refill(s)) {
+                live[s] = false;
+                --active;
+            }
+        }
+    }
+}
+
+} // namespace simd
+
+#endif // SIMD_AMAC_H
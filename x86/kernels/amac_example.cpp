@@ -0,0 +1,230 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include "amac.h"
+#include "dispatch.h"
+#include "tree_search.h"
+
+namespace {
+
+// Position in tree of the first key >= key, from the sorted array.
+bool same_answer(const std::vector<uint32_t>& sorted, const std::vector<uint32_t>& tree, uint32_t key,
+                 uint32_t pos) {
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), key);
+    if (it == sorted.end()) return pos == 0;
+    return pos != 0 && pos < tree.size() && tree[pos] == *it;
+}
+
+// Sizes around full trees, keys below, between, on and above the stored ones
+// (which are the even numbers from 2, with repeats), and tails of every
+// length.
+bool check(void (*search)(const uint32_t*, size_t, const uint32_t*, size_t, uint32_t*)) {
+    std::mt19937 rng(3);
+    for (size_t n : {(size_t)0, (size_t)1, (size_t)2, (size_t)3, (size_t)7, (size_t)8, (size_t)15, (size_t)16,
+                     (size_t)17, (size_t)100, (size_t)1000, (size_t)65537}) {
+        std::vector<uint32_t> sorted(n);
+        for (size_t i = 0; i < n; ++i) sorted[i] = 2 + 2 * (uint32_t)(i - i % 3 / 2);
+        std::vector<uint32_t> tree(n + 1);
+        simd::eytzinger_layout(sorted.data(), n, tree.data());
+        std::vector<uint32_t> keys = {0, 1, 2, 3, 4, 0xFFFFFFFFu, (uint32_t)(2 * n + 2), (uint32_t)(2 * n + 3)};
+        std::uniform_int_distribution<uint32_t> any(0, (uint32_t)(2 * n + 4));
+        while (keys.size() < 1000) keys.push_back(any(rng));
+        for (size_t m : {(size_t)1, (size_t)7, (size_t)16, (size_t)17, keys.size()}) {
+            std::vector<uint32_t> out(m + 1, 12345);
+            search(tree.data(), n, keys.data(), m, out.data());
+            if (out[m] != 12345) return false;
+            for (size_t i = 0; i < m; ++i) {
+                if (!same_answer(sorted, tree, keys[i], out[i])) return false;
+            }
+        }
+    }
+    return true;
+}
+
+const simd::KernelTable* g_level;
+void level_search(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out) {
+    g_level->tree_search_u32(tree, n, keys, m, out);
+}
+
+const uint64_t kNone = ~(uint64_t)0;
+
+// A chained hash index, as a key-value store probes it: buckets hold the
+// first node of their chain, nodes sit in random places in a large pool.
+// One lookup is a bucket miss and then one miss per node it visits.
+struct ChainIndex {
+    struct Node {
+        uint64_t key;
+        uint64_t value;
+        uint64_t next;  // kNone at the end of a chain
+    };
+    std::vector<uint64_t> buckets;
+    std::vector<Node> nodes;
+    uint64_t mask;
+
+    static uint64_t hash(uint64_t k) { return k * 0x9E3779B97F4A7C15ULL >> 20; }
+
+    ChainIndex(const std::vector<uint64_t>& keys) : buckets(keys.size(), kNone), nodes(keys.size()) {
+        mask = keys.size() - 1;
+        std::vector<uint64_t> place(keys.size());
+        for (size_t i = 0; i < place.size(); ++i) place[i] = i;
+        std::shuffle(place.begin(), place.end(), std::mt19937_64(4));
+        for (size_t i = 0; i < keys.size(); ++i) {
+            uint64_t b = hash(keys[i]) & mask;
+            nodes[place[i]] = {keys[i], keys[i] ^ 0x5555, buckets[b]};
+            buckets[b] = place[i];
+        }
+    }
+
+    uint64_t find(uint64_t key) const {
+        for (uint64_t p = buckets[hash(key) & mask]; p != kNone; p = nodes[p].next) {
+            if (nodes[p].key == key) return nodes[p].value;
+        }
+        return 0;
+    }
+};
+
+// The same walk as ChainIndex::find, one load per step.
+struct ChainProbe {
+    struct State {
+        uint64_t key;
+        uint64_t node;  // kNone while the bucket is being read
+        size_t i;
+    };
+    const ChainIndex* index;
+    const uint64_t* keys;
+    uint64_t* out;
+
+    const void* start(size_t i, State& s) {
+        s.key = keys[i];
+        s.node = kNone;
+        s.i = i;
+        return &index->buckets[ChainIndex::hash(s.key) & index->mask];
+    }
+    const void* step(State& s) {
+        uint64_t p;
+        if (s.node == kNone) {
+            p = index->buckets[ChainIndex::hash(s.key) & index->mask];
+        } else {
+            const ChainIndex::Node& node = index->nodes[s.node];
+            if (node.key == s.key) {
+                out[s.i] = node.value;
+                return nullptr;
+            }
+            p = node.next;
+        }
+        if (p == kNone) {
+            out[s.i] = 0;
+            return nullptr;
+        }
+        s.node = p;
+        return &index->nodes[p];
+    }
+};
+
+template <size_t kInFlight>
+void chain_amac(const ChainIndex& index, const std::vector<uint64_t>& keys, std::vector<uint64_t>& out) {
+    ChainProbe probe = {&index, keys.data(), out.data()};
+    simd::amac_run<kInFlight>(probe, keys.size());
+}
+
+template <typename F>
+double ns_per_lookup(size_t lookups, F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 3; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return best / lookups * 1e9;
+}
+
+void bench_tree(size_t n, size_t lookups) {
+    std::vector<uint32_t> sorted(n), tree(n + 1), keys(lookups), out(lookups);
+    for (size_t i = 0; i < n; ++i) sorted[i] = (uint32_t)(2 * i);
+    simd::eytzinger_layout(sorted.data(), n, tree.data());
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<uint32_t> any(0, (uint32_t)(2 * n));
+    for (uint32_t& k : keys) k = any(rng);
+
+    std::cout << "  " << std::setw(6) << n * 4 / 1048576.0 << " MiB tree:  ";
+    for (simd::Isa isa : {simd::Isa::Scalar, simd::Isa::AVX2, simd::Isa::AVX512}) {
+        if (isa > simd::detect_isa()) break;
+        const simd::KernelTable& t = simd::kernels_for(isa);
+        double ns = ns_per_lookup(lookups, [&] { t.tree_search_u32(tree.data(), n, keys.data(), lookups, out.data()); });
+        std::cout << "  " << simd::isa_name(isa) << (isa == simd::Isa::Scalar ? " loop " : " gather ") << std::setw(6)
+                  << ns;
+    }
+    double ns = ns_per_lookup(lookups, [&] { simd::tree_search(tree.data(), n, keys.data(), lookups, out.data()); });
+    std::cout << "  AMAC " << std::setw(6) << ns << " ns" << std::endl;
+}
+
+void bench_chain(size_t n, size_t lookups) {
+    std::mt19937_64 rng(6);
+    std::vector<uint64_t> stored(n), keys(lookups), out(lookups);
+    for (uint64_t& k : stored) k = rng();
+    ChainIndex index(stored);
+    for (size_t i = 0; i < lookups; ++i) keys[i] = i % 2 ? stored[rng() % n] : rng();
+
+    size_t bytes = n * (sizeof(uint64_t) + sizeof(ChainIndex::Node));
+    std::cout << "  " << std::setw(6) << bytes / 1048576.0 << " MiB chains:";
+    double naive = ns_per_lookup(lookups, [&] {
+        for (size_t i = 0; i < lookups; ++i) out[i] = index.find(keys[i]);
+    });
+    std::cout << "  loop " << std::setw(6) << naive;
+    std::cout << "  AMAC x4 " << std::setw(6) << ns_per_lookup(lookups, [&] { chain_amac<4>(index, keys, out); });
+    std::cout << "  x8 " << std::setw(6) << ns_per_lookup(lookups, [&] { chain_amac<8>(index, keys, out); });
+    std::cout << "  x16 " << std::setw(6) << ns_per_lookup(lookups, [&] { chain_amac<16>(index, keys, out); });
+    std::cout << "  x32 " << std::setw(6) << ns_per_lookup(lookups, [&] { chain_amac<32>(index, keys, out); })
+              << " ns" << std::endl;
+}
+
+bool check_chain() {
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> stored(1 << 12), keys(5003);
+    for (uint64_t& k : stored) k = rng() % 100000;  // some repeats
+    ChainIndex index(stored);
+    for (uint64_t& k : keys) k = rng() % 100000;
+    std::vector<uint64_t> out(keys.size(), 1);
+    chain_amac<8>(index, keys, out);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (out[i] != index.find(keys[i])) return false;
+    }
+    std::vector<uint64_t> none;
+    chain_amac<8>(index, none, none);
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::fixed << std::setprecision(1);
+    bool ok = true;
+    for (simd::Isa isa : {simd::Isa::Scalar, simd::Isa::AVX2, simd::Isa::AVX512}) {
+        if (isa > simd::detect_isa()) break;
+        g_level = &simd::kernels_for(isa);
+        bool good = check(level_search);
+        std::cout << std::setw(7) << simd::isa_name(isa) << " lockstep vs std::lower_bound: " << (good ? "OK" : "MISMATCH")
+                  << std::endl;
+        ok = ok && good;
+    }
+    bool good = check(simd::tree_search);
+    std::cout << "   AMAC tree_search vs std::lower_bound: " << (good ? "OK" : "MISMATCH") << std::endl;
+    ok = ok && good;
+    good = check_chain();
+    std::cout << "   AMAC chain walk vs loop: " << (good ? "OK" : "MISMATCH") << std::endl;
+    ok = ok && good;
+
+    std::cout << std::endl << "Tree lower_bound, ns per lookup (one core):" << std::endl;
+    bench_tree((size_t)1 << 16, (size_t)1 << 20);
+    bench_tree((size_t)1 << 26, (size_t)1 << 20);
+    std::cout << std::endl << "Hash chain walk, half hits, ns per lookup:" << std::endl;
+    bench_chain((size_t)1 << 16, (size_t)1 << 20);
+    bench_chain((size_t)1 << 23, (size_t)1 << 20);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,309 @@
+#include "arena.h"
+
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+
+namespace simd {
+
+namespace {
+
+uintptr_t round_up(uintptr_t x, size_t to) {
+    return (x + to - 1) & ~(uintptr_t)(to - 1);
+}
+
+// What map_pages actually maps for `bytes`; unmap_pages recomputes it. Huge
+// page mappings must be whole huge pages (MAP_HUGETLB requires it of munmap),
+// so from 2 MiB the length is rounded to that in every mode.
+size_t mapping_length(size_t bytes) {
+    size_t unit = bytes >= kHugePageSize ? kHugePageSize : kPageSize;
+    return round_up(bytes ? bytes : 1, unit);
+}
+
+void* mmap_anonymous(size_t len, int extra_flags) {
+    return mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+}
+
+HugePages parse_huge_pages() {
+    const char* env = std::getenv("SIMD_HUGEPAGES");
+    if (env && std::strcmp(env, "off") == 0) return HugePages::Off;
+    if (env && std::strcmp(env, "hugetlb") == 0) return HugePages::HugeTLB;
+    return HugePages::Transparent;
+}
+
+} // namespace
+
+HugePages default_huge_pages() {
+    static const HugePages mode = parse_huge_pages();
+    return mode;
+}
+
+void* map_pages(size_t bytes, size_t align, HugePages mode) {
+    size_t len = mapping_length(bytes);
+    bool huge = mode != HugePages::Off && len >= kHugePageSize;
+    if (align < kPageSize) align = kPageSize;
+    if (huge && align < kHugePageSize) align = kHugePageSize;
+
+#ifdef MAP_HUGETLB
+    // Fails with ENOMEM when no huge pages are reserved; fall back to THP.
+    if (huge && mode == HugePages::HugeTLB && align == kHugePageSize) {
+        void* p = mmap_anonymous(len, MAP_HUGETLB);
+        if (p != MAP_FAILED) return p;
+    }
+#endif
+
+    if (align == kPageSize) {
+        void* p = mmap_anonymous(len, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+        return p;
+    }
+    // mmap only promises page alignment: map align - 4 KiB more and trim
+    // both ends.
+    size_t span = len + align - kPageSize;
+    void* m = mmap_anonymous(span, 0);
+    if (m == MAP_FAILED) throw std::bad_alloc();
+    char* raw = static_cast<char*>(m);
+    char* p = reinterpret_cast<char*>(round_up(reinterpret_cast<uintptr_t>(raw), align));
+    if (p > raw) munmap(raw, p - raw);
+    if (raw + span > p + len) munmap(p + len, raw + span - (p + len));
+#ifdef MADV_HUGEPAGE
+    if (huge) madvise(p, len, MADV_HUGEPAGE);
+#endif
+    return p;
+}
+
+void unmap_pages(void* p, size_t bytes) {
+    if (p) munmap(p, mapping_length(bytes));
+}
+
+// --- Guard pages ---
+
+GuardedBuffer::GuardedBuffer(size_t bytes, Guard side) : bytes_(bytes) {
+    size_t data_pages = round_up(bytes, kPageSize);
+    map_bytes_ = data_pages + kPageSize;
+    map_ = mmap_anonymous(map_bytes_, 0);
+    if (map_ == MAP_FAILED) throw std::bad_alloc();
+    char* base = static_cast<char*>(map_);
+    if (side == Guard::After) {
+        mprotect(base + data_pages, kPageSize, PROT_NONE);
+        data_ = reinterpret_cast<unsigned char*>(base + data_pages - bytes);
+    } else {
+        mprotect(base, kPageSize, PROT_NONE);
+        data_ = reinterpret_cast<unsigned char*>(base + kPageSize);
+    }
+}
+
+GuardedBuffer::~GuardedBuffer() {
+    munmap(map_, map_bytes_);
+}
+
+void* aligned_malloc(size_t bytes, size_t align) {
+    if (align < sizeof(void*)) align = sizeof(void*);
+    void* p = nullptr;
+    if (posix_memalign(&p, align, bytes ? bytes : 1) != 0) throw std::bad_alloc();
+    return p;
+}
+
+void aligned_free(void* p) {
+    std::free(p);
+}
+
+// --- Arena ---
+
+Arena::Arena(size_t chunk_bytes, HugePages mode)
+    : current_(0), cur_(nullptr), end_(nullptr), chunk_bytes_(chunk_bytes ? chunk_bytes : kPageSize), mode_(mode) {}
+
+Arena::~Arena() {
+    for (const Chunk& c : chunks_) unmap_pages(c.base, c.size);
+}
+
+void* Arena::carve(size_t bytes, size_t align) {
+    if (!cur_) return nullptr;
+    uintptr_t p = round_up(reinterpret_cast<uintptr_t>(cur_), align);
+    uintptr_t end = reinterpret_cast<uintptr_t>(end_);
+    if (p > end || bytes > end - p) return nullptr;
+    cur_ = reinterpret_cast<char*>(p + bytes);
+    return reinterpret_cast<void*>(p);
+}
+
+void* Arena::allocate(size_t bytes, size_t align) {
+    if (align == 0 || (align & (align - 1)) != 0) throw std::bad_alloc();
+    if (void* p = carve(bytes, align)) return p;
+    // Chunks kept by reset() first, then a new one. A kept chunk that is too
+    // small for this request is skipped until the next reset().
+    while (current_ + 1 < chunks_.size()) {
+        ++current_;
+        cur_ = chunks_[current_].base;
+        end_ = cur_ + chunks_[current_].size;
+        if (void* p = carve(bytes, align)) return p;
+    }
+    Chunk c;
+    c.size = bytes > chunk_bytes_ ? bytes : chunk_bytes_;
+    c.base = static_cast<char*>(map_pages(c.size, align, mode_));  // starts aligned
+    chunks_.push_back(c);
+    current_ = chunks_.size() - 1;
+    cur_ = c.base;
+    end_ = c.base + c.size;
+    return carve(bytes, align);
+}
+
+void Arena::reset() {
+    current_ = 0;
+    cur_ = chunks_.empty() ? nullptr : chunks_[0].base;
+    end_ = chunks_.empty() ? nullptr : chunks_[0].base + chunks_[0].size;
+}
+
+size_t Arena::reserved() const {
+    size_t total = 0;
+    for (const Chunk& c : chunks_) total += c.size;
+    return total;
+}
+
+// --- Pool ---
+
+namespace {
+
+// Class c holds blocks of 2^c bytes, from 64 B (c = 6).
+const int kMinClass = 6;
+const int kClasses = 48;
+// Blocks a thread keeps per class before passing them to the shared list, and
+// the most the shared list holds before freeing to the system.
+const size_t kThreadBlocksSmall = 8;
+const size_t kThreadBlocksLarge = 2;  // from 1 MiB
+const size_t kSharedMaxBytes = (size_t)512 << 20;
+
+int size_class(size_t bytes) {
+    if (bytes <= ((size_t)1 << kMinClass)) return kMinClass;
+    int c = 64 - __builtin_clzll((unsigned long long)(bytes - 1));
+    if (c >= kClasses) throw std::bad_alloc();
+    return c;
+}
+
+size_t class_bytes(int c) {
+    return (size_t)1 << c;
+}
+
+void* system_allocate(int c) {
+    size_t n = class_bytes(c);
+    if (n < kPageSize) return aligned_malloc(n, kCacheLine);
+    return map_pages(n, n >= kHugePageSize ? kHugePageSize : kPageSize, default_huge_pages());
+}
+
+void system_free(void* p, int c) {
+    size_t n = class_bytes(c);
+    if (n < kPageSize) aligned_free(p);
+    else unmap_pages(p, n);
+}
+
+struct Shared {
+    std::mutex mutex;
+    std::vector<void*> lists[kClasses];
+    size_t bytes = 0;
+    std::atomic<size_t> hits{0};
+    std::atomic<size_t> misses{0};
+
+    // Takes a block of class c if the shared list has room for it.
+    bool put(void* p, int c) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bytes + class_bytes(c) > kSharedMaxBytes) return false;
+        lists[c].push_back(p);
+        bytes += class_bytes(c);
+        return true;
+    }
+
+    void* take(int c) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (lists[c].empty()) return nullptr;
+        void* p = lists[c].back();
+        lists[c].pop_back();
+        bytes -= class_bytes(c);
+        return p;
+    }
+};
+
+// Never destroyed, so that thread caches and containers torn down while the
+// program exits can still reach it.
+Shared& shared() {
+    static Shared* s = new Shared;
+    return *s;
+}
+
+// Set once a thread's cache is destroyed: containers freed later in the
+// thread's (or, for the main thread, the program's) teardown go straight to
+// the shared list.
+thread_local bool t_cache_gone = false;
+
+struct ThreadCache {
+    std::vector<void*> lists[kClasses];
+
+    ~ThreadCache() {
+        t_cache_gone = true;
+        for (int c = 0; c < kClasses; ++c) {
+            for (void* p : lists[c]) {
+                if (!shared().put(p, c)) system_free(p, c);
+            }
+        }
+    }
+};
+
+thread_local ThreadCache t_cache;
+
+size_t thread_blocks(int c) {
+    return class_bytes(c) >= ((size_t)1 << 20) ? kThreadBlocksLarge : kThreadBlocksSmall;
+}
+
+} // namespace
+
+void* pool_allocate(size_t bytes) {
+    int c = size_class(bytes);
+    if (!t_cache_gone && !t_cache.lists[c].empty()) {
+        void* p = t_cache.lists[c].back();
+        t_cache.lists[c].pop_back();
+        shared().hits.fetch_add(1, std::memory_order_relaxed);
+        return p;
+    }
+    if (void* p = shared().take(c)) {
+        shared().hits.fetch_add(1, std::memory_order_relaxed);
+        return p;
+    }
+    shared().misses.fetch_add(1, std::memory_order_relaxed);
+    return system_allocate(c);
+}
+
+void pool_deallocate(void* p, size_t bytes) {
+    if (!p) return;
+    int c = size_class(bytes);
+    if (!t_cache_gone && t_cache.lists[c].size() < thread_blocks(c)) {
+        t_cache.lists[c].push_back(p);
+        return;
+    }
+    if (!shared().put(p, c)) system_free(p, c);
+}
+
+void pool_trim() {
+    Shared& s = shared();
+    std::vector<void*> lists[kClasses];
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        for (int c = 0; c < kClasses; ++c) lists[c].swap(s.lists[c]);
+        s.bytes = 0;
+    }
+    for (int c = 0; c < kClasses; ++c) {
+        for (void* p : lists[c]) system_free(p, c);
+    }
+}
+
+PoolStats pool_stats() {
+    Shared& s = shared();
+    PoolStats st;
+    st.hits = s.hits.load(std::memory_order_relaxed);
+    st.misses = s.misses.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    st.cached_bytes = s.bytes;
+    return st;
+}
+
+} // namespace simd
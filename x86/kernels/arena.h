@@ -0,0 +1,189 @@
+#ifndef SIMD_ARENA_H
+#define SIMD_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace simd {
+
+// Memory for SIMD buffers, at three levels:
+//
+//   AlignedAllocator<T>  drop-in std::allocator for std::vector and friends;
+//                        every buffer starts on a cache line, so the aligned
+//                        _mm256_load_ps / _mm512_load_ps paths are always legal.
+//   Arena                bump allocation from large page-backed chunks, freed
+//                        all at once with reset(); for per-batch scratch.
+//   pool_allocate        size-class pool with per-thread free lists; for large
+//                        buffers that are allocated and freed over and over.
+//
+// Large mappings can be backed by 2 MiB pages, which cover 512x more memory per
+// TLB entry than 4 KiB pages. The default policy comes from SIMD_HUGEPAGES:
+//
+//   SIMD_HUGEPAGES=thp      madvise(MADV_HUGEPAGE) on 2 MiB-aligned ranges
+//                           (default; needs THP "madvise" or "always")
+//   SIMD_HUGEPAGES=hugetlb  MAP_HUGETLB from the reserved pool
+//                           (vm.nr_hugepages), falling back to thp
+//   SIMD_HUGEPAGES=off      4 KiB pages only
+
+const size_t kCacheLine = 64;
+const size_t kPageSize = 4096;
+const size_t kHugePageSize = (size_t)2 << 20;
+
+enum class HugePages { Off, Transparent, HugeTLB };
+
+// The SIMD_HUGEPAGES policy, read once.
+HugePages default_huge_pages();
+
+// --- Pages ---
+
+// Anonymous zero-filled pages, untouched (so that first touch places them on
+// the NUMA node of the touching thread), aligned to `align` (a power of two;
+// at least a page). With Transparent or HugeTLB, ranges of 2 MiB or more are
+// 2 MiB-aligned and huge-page backed where the kernel allows.
+// Throws std::bad_alloc.
+void* map_pages(size_t bytes, size_t align = kPageSize, HugePages mode = default_huge_pages());
+// `bytes` must be what was passed to map_pages.
+void unmap_pages(void* p, size_t bytes);
+
+// --- Guard pages ---
+
+// For tests of tails and overreads: `bytes` of read-write memory right before
+// (Guard::After) or right after (Guard::Before) a PROT_NONE page, so a read
+// of one byte past the end (or before the start) faults at once. The buffer
+// starts zero-filled. Throws std::bad_alloc.
+enum class Guard { After, Before };
+
+class GuardedBuffer {
+public:
+    explicit GuardedBuffer(size_t bytes, Guard side = Guard::After);
+    ~GuardedBuffer();
+    GuardedBuffer(const GuardedBuffer&) = delete;
+    GuardedBuffer& operator=(const GuardedBuffer&) = delete;
+
+    unsigned char* data() const { return data_; }
+    size_t size() const { return bytes_; }
+
+private:
+    void* map_;
+    size_t map_bytes_;
+    unsigned char* data_;
+    size_t bytes_;
+};
+
+// --- Heap ---
+
+// Heap memory aligned to `align` (a power of two). Throws std::bad_alloc.
+void* aligned_malloc(size_t bytes, size_t align = kCacheLine);
+void aligned_free(void* p);
+
+template <typename T, size_t Align = kCacheLine>
+struct AlignedAllocator {
+    static_assert(Align >= alignof(T) && (Align & (Align - 1)) == 0, "Align must be a power of two >= alignof(T)");
+    typedef T value_type;
+    template <typename U> struct rebind { typedef AlignedAllocator<U, Align> other; };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    T* allocate(size_t n) {
+        if (n > (size_t)-1 / sizeof(T)) throw std::bad_alloc();
+        return static_cast<T*>(aligned_malloc(n * sizeof(T), Align));
+    }
+    void deallocate(T* p, size_t) { aligned_free(p); }
+};
+
+template <typename T, typename U, size_t A>
+bool operator==(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) { return true; }
+template <typename T, typename U, size_t A>
+bool operator!=(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) { return false; }
+
+// --- Arena ---
+
+// Hands out aligned slices of large page-mapped chunks. Nothing is freed
+// individually: reset() makes all chunks available again (keeping their pages
+// mapped and faulted in), the destructor unmaps them. Not thread-safe; use one
+// arena per thread or per job.
+class Arena {
+public:
+    // Chunks are at least chunk_bytes; requests larger than that get a chunk
+    // of their own.
+    explicit Arena(size_t chunk_bytes = (size_t)4 << 20, HugePages mode = default_huge_pages());
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // `align` is any power of two (64, 4096 and 2 MiB are the useful ones).
+    // Throws std::bad_alloc.
+    void* allocate(size_t bytes, size_t align = kCacheLine);
+    template <typename T> T* allocate_array(size_t n, size_t align = kCacheLine) {
+        if (n > (size_t)-1 / sizeof(T)) throw std::bad_alloc();
+        return static_cast<T*>(allocate(n * sizeof(T), align < alignof(T) ? alignof(T) : align));
+    }
+
+    void reset();
+    // Bytes mapped by the arena's chunks.
+    size_t reserved() const;
+
+private:
+    struct Chunk {
+        char* base;
+        size_t size;
+    };
+    void* carve(size_t bytes, size_t align);
+
+    std::vector<Chunk> chunks_;
+    size_t current_;  // chunk being carved (0 when there are none)
+    char* cur_;
+    char* end_;
+    size_t chunk_bytes_;
+    HugePages mode_;
+};
+
+// --- Pool ---
+
+// One process-wide pool of blocks in power-of-two size classes. Blocks are
+// 64-byte aligned; from 4 KiB they are whole pages, and from 2 MiB they are
+// huge-page aligned and backed per default_huge_pages(). A freed block goes to
+// the calling thread's free list for its class (a few blocks per class) and
+// from there to a shared list, so a loop that allocates and frees the same
+// sizes stops paying for mmap, munmap and page faults after the first round.
+// Blocks freed by a thread that exits move to the shared list.
+//
+// pool_deallocate must get the size that was passed to pool_allocate.
+void* pool_allocate(size_t bytes);
+void pool_deallocate(void* p, size_t bytes);
+// Returns the blocks on the shared list (not the per-thread ones) to the
+// system.
+void pool_trim();
+
+struct PoolStats {
+    size_t hits;          // allocations served from a free list
+    size_t misses;        // allocations that went to the system
+    size_t cached_bytes;  // bytes on the shared list
+};
+PoolStats pool_stats();
+
+template <typename T>
+struct PoolAllocator {
+    typedef T value_type;
+    template <typename U> struct rebind { typedef PoolAllocator<U> other; };
+
+    PoolAllocator() = default;
+    template <typename U> PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        if (n > (size_t)-1 / sizeof(T)) throw std::bad_alloc();
+        return static_cast<T*>(pool_allocate(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) { pool_deallocate(p, n * sizeof(T)); }
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) { return false; }
+
+} // namespace simd
+
+#endif // SIMD_ARENA_H
@@ -0,0 +1,193 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <cstdlib>
+#include "arena.h"
+#include "memops.h"
+
+namespace {
+
+bool aligned(const void* p, size_t to) {
+    return ((uintptr_t)p & (to - 1)) == 0;
+}
+
+// Writes every byte of [p, p + n) and reads it back.
+bool usable(void* p, size_t n, unsigned char value) {
+    unsigned char* b = static_cast<unsigned char*>(p);
+    simd::simd_memset(b, value, n);
+    for (size_t i = 0; i < n; i += 61) {
+        if (b[i] != value) return false;
+    }
+    return n == 0 || b[n - 1] == value;
+}
+
+bool check_allocators() {
+    bool ok = true;
+
+    std::vector<float, simd::AlignedAllocator<float> > v(1000, 1.0f);
+    std::vector<double, simd::AlignedAllocator<double, simd::kPageSize> > pages(3);
+    ok &= aligned(v.data(), 64) && aligned(pages.data(), simd::kPageSize);
+    for (int i = 0; i < 100; ++i) v.push_back((float)i);  // reallocates
+    ok &= aligned(v.data(), 64);
+
+    simd::Arena arena((size_t)1 << 20);
+    void* a = arena.allocate(3);
+    void* b = arena.allocate(100, simd::kPageSize);
+    void* c = arena.allocate((size_t)5 << 20);  // larger than a chunk
+    void* d = arena.allocate((size_t)1 << 20, simd::kHugePageSize);
+    ok &= aligned(a, 64) && aligned(b, simd::kPageSize) && aligned(c, 64) && aligned(d, simd::kHugePageSize);
+    ok &= usable(a, 3, 1) && usable(b, 100, 2) && usable(c, (size_t)5 << 20, 3) && usable(d, (size_t)1 << 20, 4);
+    arena.reset();
+    ok &= arena.allocate(3) == a;  // chunks are reused
+
+    const size_t sizes[] = {1, 100, 5000, (size_t)3 << 20};
+    for (size_t n : sizes) {
+        void* p = simd::pool_allocate(n);
+        size_t want = n >= simd::kHugePageSize ? simd::kHugePageSize : n >= simd::kPageSize ? simd::kPageSize : 64;
+        ok &= aligned(p, want) && usable(p, n, 5);
+        simd::pool_deallocate(p, n);
+        ok &= simd::pool_allocate(n) == p;  // from this thread's free list
+        simd::pool_deallocate(p, n);
+    }
+
+    std::vector<int, simd::PoolAllocator<int> > grow;
+    for (int i = 0; i < 100000; ++i) grow.push_back(i);
+    ok &= aligned(grow.data(), 64) && grow[99999] == 99999;
+    return ok;
+}
+
+// Threads allocate, fill, check and free overlapping size classes; blocks
+// move between threads through the shared list.
+bool check_threads() {
+    const unsigned threads = 4;
+    std::vector<int> failures(threads, 0);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([t, &failures] {
+            std::vector<std::pair<void*, size_t> > held;
+            for (int i = 0; i < 2000; ++i) {
+                size_t n = (size_t)64 << ((i * 7 + t) % 12);
+                void* p = simd::pool_allocate(n);
+                if (!aligned(p, 64) || !usable(p, n, (unsigned char)(t + 1))) ++failures[t];
+                held.push_back(std::make_pair(p, n));
+                if (held.size() > 16) {
+                    const unsigned char* b = static_cast<const unsigned char*>(held.front().first);
+                    if (b[0] != t + 1 || b[held.front().second - 1] != t + 1) ++failures[t];
+                    simd::pool_deallocate(held.front().first, held.front().second);
+                    held.erase(held.begin());
+                }
+            }
+            for (auto& h : held) simd::pool_deallocate(h.first, h.second);
+        });
+    }
+    for (std::thread& w : workers) w.join();
+    for (int f : failures) {
+        if (f) return false;
+    }
+    return true;
+}
+
+template <typename F>
+double ms_per_call(int reps, F body) {
+    body(0);
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) body(r);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / reps;
+}
+
+// A 64 MiB scratch buffer per batch, allocated, filled and freed each time.
+// glibc serves blocks this large with mmap and returns them with munmap, so
+// every batch faults in 16384 fresh pages; the pool hands back the same,
+// already-faulted pages.
+void bench_churn() {
+    const size_t bytes = (size_t)64 << 20;
+    const int reps = 20;
+    double t_malloc = ms_per_call(reps, [&](int r) {
+        void* p = std::malloc(bytes);
+        simd::simd_memset(p, r, bytes);
+        std::free(p);
+    });
+    double t_pool = ms_per_call(reps, [&](int r) {
+        void* p = simd::pool_allocate(bytes);
+        simd::simd_memset(p, r, bytes);
+        simd::pool_deallocate(p, bytes);
+    });
+    std::cout << "Allocate + fill + free 64 MiB, per batch:" << std::endl;
+    std::cout << "  malloc/free:  " << std::setw(8) << t_malloc << " ms" << std::endl;
+    std::cout << "  pool:         " << std::setw(8) << t_pool << " ms  (" << t_malloc / t_pool << "x)" << std::endl;
+}
+
+// AnonHugePages of this process, in KiB.
+long anon_huge_kib() {
+    std::ifstream f("/proc/self/smaps_rollup");
+    std::string line;
+    while (std::getline(f, line)) {
+        if (line.compare(0, 14, "AnonHugePages:") == 0) return std::atol(line.c_str() + 14);
+    }
+    return -1;
+}
+
+volatile uint64_t sink;
+
+// Random 4-byte reads over 512 MiB: nearly every read misses the 4 KiB TLB,
+// while 2 MiB pages cover 512x more per entry.
+void bench_tlb() {
+    const size_t bytes = (size_t)512 << 20;
+    const size_t n = bytes / sizeof(uint32_t);
+    const size_t reads = (size_t)1 << 24;
+    std::ifstream thp("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string setting;
+    std::getline(thp, setting);
+    std::cout << std::endl << "Random reads over 512 MiB (THP: " << (setting.empty() ? "unknown" : setting) << "):"
+              << std::endl;
+
+    const simd::HugePages modes[] = {simd::HugePages::Off, simd::HugePages::Transparent};
+    const char* names[] = {"4 KiB pages:  ", "2 MiB (THP):  "};
+    double base = 0;
+    for (int m = 0; m < 2; ++m) {
+        long before = anon_huge_kib();
+        uint32_t* p = static_cast<uint32_t*>(simd::map_pages(bytes, simd::kPageSize, modes[m]));
+        simd::simd_memset(p, 1, bytes);
+        long huge = anon_huge_kib() - before;
+        uint64_t x = 88172645463325252ull, sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < reads; ++i) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            sum += p[x % n];
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / reads;
+        simd::unmap_pages(p, bytes);
+        sink = sum;
+        if (m == 0) base = ns;
+        std::cout << "  " << names[m] << std::setw(8) << ns << " ns/read";
+        if (m > 0) std::cout << "  (" << base / ns << "x)";
+        std::cout << "  (" << (huge < 0 ? 0 : huge >> 10) << " MiB in huge pages)" << std::endl;
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::fixed << std::setprecision(2);
+    bool ok = check_allocators();
+    std::cout << "Alignment and reuse:         " << (ok ? "OK" : "MISMATCH") << std::endl;
+    bool threads_ok = check_threads();
+    std::cout << "Per-thread free lists:       " << (threads_ok ? "OK" : "MISMATCH") << std::endl;
+    ok &= threads_ok;
+    simd::PoolStats st = simd::pool_stats();
+    std::cout << "Pool: " << st.hits << " hits, " << st.misses << " misses, " << (st.cached_bytes >> 20)
+              << " MiB on the shared list" << std::endl
+              << std::endl;
+
+    bench_churn();
+    bench_tlb();
+    simd::pool_trim();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+#include "base64.h"
+#include "base64_internal.h"
+#include "dispatch.h"
+
+namespace simd {
+
+namespace {
+
+// One group of 2, 3 or 4 characters -> 1, 2 or 3 bytes; false if one is
+// outside the alphabet ('=' included).
+bool decode_partial(const Base64Tables& t, const char* src, size_t chars, uint8_t* dst) {
+    uint32_t v = 0, bad = 0;
+    for (size_t j = 0; j < chars; ++j) {
+        uint32_t d = t.decode[(uint8_t)src[j]];
+        bad |= d;
+        v |= (d & 63) << (18 - 6 * j);
+    }
+    if (bad & 0x80) return false;
+    for (size_t j = 0; j + 1 < chars; ++j) dst[j] = (uint8_t)(v >> (16 - 8 * j));
+    return true;
+}
+
+} // namespace
+
+Base64Encoder::Base64Encoder(Base64 alphabet, bool pad) : Base64Encoder(alphabet, pad, kernels()) {}
+
+Base64Encoder::Base64Encoder(Base64 alphabet, bool pad, const KernelTable& kernels)
+    : kernels_(&kernels), alphabet_(alphabet), pad_(pad), carry_size_(0) {}
+
+size_t Base64Encoder::update(const uint8_t* src, size_t n, char* dst) {
+    size_t k = 0;
+    if (carry_size_) {
+        while (carry_size_ < 3 && n) {
+            carry_[carry_size_++] = *src++;
+            --n;
+        }
+        if (carry_size_ < 3) return 0;
+        uint8_t group[3] = {carry_[0], carry_[1], carry_[2]};
+        kernels_->base64_encode(group, 3, dst, alphabet_);
+        k = 4;
+        carry_size_ = 0;
+    }
+    size_t whole = n / 3 * 3;
+    kernels_->base64_encode(src, whole, dst + k, alphabet_);
+    k += whole / 3 * 4;
+    for (size_t i = whole; i < n; ++i) carry_[carry_size_++] = src[i];
+    return k;
+}
+
+size_t Base64Encoder::finish(char* dst) {
+    size_t k = 0;
+    if (carry_size_) {
+        const char* chars = base64_tables(alphabet_).encode;
+        uint32_t v = (uint32_t)carry_[0] << 16 | (carry_size_ == 2 ? (uint32_t)carry_[1] << 8 : 0);
+        dst[k++] = chars[v >> 18];
+        dst[k++] = chars[v >> 12 & 63];
+        if (carry_size_ == 2) dst[k++] = chars[v >> 6 & 63];
+        while (pad_ && k < 4) dst[k++] = '=';
+    }
+    carry_size_ = 0;
+    return k;
+}
+
+Base64Decoder::Base64Decoder(Base64 alphabet) : Base64Decoder(alphabet, kernels()) {}
+
+Base64Decoder::Base64Decoder(Base64 alphabet, const KernelTable& kernels)
+    : kernels_(&kernels), alphabet_(alphabet), carry_size_(0), ended_(false), failed_(false) {}
+
+// The 4 characters in carry_, which may end in padding.
+bool Base64Decoder::flush_group(uint8_t* dst, size_t* k) {
+    size_t chars = 4;
+    if (carry_[3] == '=') chars = carry_[2] == '=' ? 2 : 3;
+    carry_size_ = 0;
+    if (!decode_partial(base64_tables(alphabet_), carry_, chars, dst + *k)) return false;
+    ended_ = chars < 4;
+    *k += chars - 1;
+    return true;
+}
+
+bool Base64Decoder::update(const char* src, size_t n, uint8_t* dst, size_t* written) {
+    size_t k = 0;
+    *written = 0;
+    if (failed_ || (ended_ && n)) {
+        failed_ = true;
+        return false;
+    }
+    if (carry_size_) {
+        while (carry_size_ < 4 && n) {
+            carry_[carry_size_++] = *src++;
+            --n;
+        }
+        if (carry_size_ == 4 && !flush_group(dst, &k)) {
+            failed_ = true;
+            return false;
+        }
+    }
+    // Whole groups but the last, which may hold padding: the kernels see none.
+    size_t whole = n / 4 * 4;
+    if (whole && src[whole - 1] == '=') whole -= 4;
+    if (whole) {
+        if (ended_ || !kernels_->base64_decode(src, whole, dst + k, alphabet_)) {
+            failed_ = true;
+            return false;
+        }
+        k += whole / 4 * 3;
+    }
+    for (size_t i = whole; i < n; ++i) {
+        carry_[carry_size_++] = src[i];
+        if (ended_ || (carry_size_ == 4 && !flush_group(dst, &k))) {
+            failed_ = true;
+            return false;
+        }
+    }
+    *written = k;
+    return true;
+}
+
+bool Base64Decoder::finish(uint8_t* dst, size_t* written) {
+    *written = 0;
+    bool ok = !failed_ && carry_size_ != 1 && (carry_size_ == 0 || !ended_);
+    if (ok && carry_size_) {
+        ok = decode_partial(base64_tables(alphabet_), carry_, carry_size_, dst);
+        if (ok) *written = carry_size_ - 1;
+    }
+    carry_size_ = 0;
+    ended_ = failed_ = false;
+    return ok;
+}
+
+size_t base64_encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet, bool pad) {
+    Base64Encoder enc(alphabet, pad);
+    size_t k = enc.update(src, n, dst);
+    return k + enc.finish(dst + k);
+}
+
+bool base64_decode(const char* src, size_t n, uint8_t* dst, size_t* written, Base64 alphabet) {
+    Base64Decoder dec(alphabet);
+    size_t k = 0, tail = 0;
+    bool ok = dec.update(src, n, dst, &k) && dec.finish(dst + k, &tail);
+    *written = k + tail;
+    return ok;
+}
+
+} // namespace simd
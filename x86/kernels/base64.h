@@ -0,0 +1,100 @@
+#ifndef SIMD_BASE64_H
+#define SIMD_BASE64_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+struct KernelTable;
+
+// The two alphabets of RFC 4648. They differ only in the characters for 62
+// and 63.
+enum class Base64 {
+    Standard,  // A-Z a-z 0-9 + /
+    Url        // A-Z a-z 0-9 - _
+};
+
+// Characters for n bytes: whole groups of 3 bytes take 4 characters, a last
+// group of 1 or 2 bytes 2 or 3, padded with '=' to 4 if pad is set.
+inline size_t base64_encoded_length(size_t n, bool pad = true) {
+    return pad ? (n + 2) / 3 * 4 : n / 3 * 4 + (n % 3 ? n % 3 + 1 : 0);
+}
+
+// Bytes at most for n characters (exact if they hold no padding).
+inline size_t base64_decoded_length(size_t n) {
+    return n / 4 * 3 + n % 4 * 3 / 4;
+}
+
+// Encodes n bytes into base64_encoded_length(n, pad) characters; returns
+// that count. No terminating 0 is written.
+size_t base64_encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet = Base64::Standard, bool pad = true);
+
+// Decodes n characters into dst (room for base64_decoded_length(n) bytes)
+// and sets *written to the bytes written. Padding is optional, but if
+// present it must complete the last group of 4. Returns false, with dst
+// partly written, on a character outside the alphabet (whitespace
+// included), misplaced '=' or a length of 4k + 1. Bits left over in the
+// last character are ignored.
+bool base64_decode(const char* src, size_t n, uint8_t* dst, size_t* written, Base64 alphabet = Base64::Standard);
+
+// Streaming forms, for input that arrives in pieces of any size. Each
+// update converts what it can and keeps the rest of a group for the next
+// call: between calls at most 2 bytes or 3 characters, and while completing
+// a group up to a whole one (3 bytes or 4 characters). finish writes the end
+// and resets the object for a new stream.
+//
+//   Base64Decoder dec;
+//   while (size_t got = read(fd, buf, sizeof buf)) {
+//       if (!dec.update(buf, got, out, &k)) return error;
+//       consume(out, k);
+//   }
+//   if (!dec.finish(out, &k)) return error;
+//   consume(out, k);
+class Base64Encoder {
+public:
+    explicit Base64Encoder(Base64 alphabet = Base64::Standard, bool pad = true);
+    // With a specific level's kernels, for benchmarks and cross-checking.
+    Base64Encoder(Base64 alphabet, bool pad, const KernelTable& kernels);
+
+    // Writes at most base64_encoded_length(n + 2) characters; returns the
+    // count.
+    size_t update(const uint8_t* src, size_t n, char* dst);
+    // Writes at most 4 characters; returns the count.
+    size_t finish(char* dst);
+
+private:
+    const KernelTable* kernels_;
+    Base64 alphabet_;
+    bool pad_;
+    uint8_t carry_[3];
+    size_t carry_size_;
+};
+
+class Base64Decoder {
+public:
+    explicit Base64Decoder(Base64 alphabet = Base64::Standard);
+    Base64Decoder(Base64 alphabet, const KernelTable& kernels);
+
+    // Writes at most base64_decoded_length(n + 3) bytes and sets *written.
+    // After a false return the stream is invalid: every later call fails
+    // until finish resets it.
+    bool update(const char* src, size_t n, uint8_t* dst, size_t* written);
+    // Writes at most 2 bytes and sets *written; false if the stream was
+    // invalid or stopped within a group (after 4k + 1 characters).
+    bool finish(uint8_t* dst, size_t* written);
+
+private:
+    bool flush_group(uint8_t* dst, size_t* k);
+
+    const KernelTable* kernels_;
+    Base64 alphabet_;
+    char carry_[4];
+    size_t carry_size_;
+    bool ended_;   // a group with padding was seen; nothing may follow
+    bool failed_;
+};
+
+} // namespace simd
+
+#endif // SIMD_BASE64_H
@@ -0,0 +1,57 @@
+#include "kernels_internal.h"
+#include "base64_internal.h"
+#include "safe_load.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx2 {
+
+// The SSE4.1 steps in both 128-bit lanes: 24 bytes -> 32 characters per
+// vector, the input loaded as two 12-byte halves since pshufb cannot cross
+// lanes. What is left after the 256-bit loop goes through the 128-bit one.
+
+void base64_encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet) {
+    const Base64Tables& t = base64_tables(alphabet);
+    const Base64Luts128 l(t);
+    const Base64Luts256 l2(l);
+    size_t i = 0;
+    for (; n - i >= 28; i += 24, dst += 32) {
+        __m128i lo = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i hi = _mm_loadu_si128((const __m128i*)(src + i + 12));
+        __m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        _mm256_storeu_si256((__m256i*)dst, base64_encode_256(x, l2));
+    }
+    for (; n - i >= 12; i += 12, dst += 16) {
+        __m128i x = n - i >= 16 ? _mm_loadu_si128((const __m128i*)(src + i)) : load_tail_128(src + i, 12);
+        _mm_storeu_si128((__m128i*)dst, base64_encode_128(x, l));
+    }
+    base64_encode_groups(t, src + i, n - i, dst);
+}
+
+bool base64_decode(const char* src, size_t n, uint8_t* dst, Base64 alphabet) {
+    const Base64Tables& t = base64_tables(alphabet);
+    const Base64Luts128 l(t);
+    const Base64Luts256 l2(l);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32, dst += 24) {
+        __m256i v;
+        if (!base64_decode_256(_mm256_loadu_si256((const __m256i*)(src + i)), l2, &v)) return false;
+        if (i + 64 <= n) {
+            _mm256_storeu_si256((__m256i*)dst, v);
+        } else {
+            _mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(v));
+            _mm_storel_epi64((__m128i*)(dst + 16), _mm256_extracti128_si256(v, 1));
+        }
+    }
+    for (; i + 16 <= n; i += 16, dst += 12) {
+        __m128i v;
+        if (!base64_decode_128(_mm_loadu_si128((const __m128i*)(src + i)), l, &v)) return false;
+        if (i + 32 <= n) _mm_storeu_si128((__m128i*)dst, v);
+        else base64_store_12(dst, v);
+    }
+    return base64_decode_groups(t, src + i, n - i, dst);
+}
+
+} // namespace avx2
+} // namespace simd
@@ -0,0 +1,93 @@
+#include "kernels_internal.h"
+#include "base64_internal.h"
+#include "safe_load.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512icl {
+
+// VBMI permutes bytes across the whole register, so 48 bytes -> 64
+// characters per vector with no lane split:
+//   encode  vpermb spreads 3 bytes over each 32-bit lane, vpmultishiftqb
+//           pulls the four 6-bit fields into bytes, and vpermb with the
+//           alphabet as the table (low 6 bits of each index) translates;
+//   decode  vpermi2b looks every character up in a 128-entry table (0xFF
+//           outside the alphabet; characters from 0x80 have bit 7 set
+//           themselves), pmaddubsw/pmaddwd merge, vpermb packs 48 bytes.
+// The tail is one masked block, so there is no scalar loop.
+
+namespace {
+
+// For 32-bit lane j: bytes 3j + 1, 3j, 3j + 2, 3j + 1.
+alignas(64) const uint8_t kSpread[64] = {
+    1,  0,  2,  1,  4,  3,  5,  4,  7,  6,  8,  7,  10, 9,  11, 10, 13, 12, 14, 13, 16, 15,
+    17, 16, 19, 18, 20, 19, 22, 21, 23, 22, 25, 24, 26, 25, 28, 27, 29, 28, 31, 30, 32, 31,
+    34, 33, 35, 34, 37, 36, 38, 37, 40, 39, 41, 40, 43, 42, 44, 43, 46, 45, 47, 46};
+
+// Bytes 2, 1, 0 of 32-bit lane j to 3j .. 3j + 2.
+alignas(64) const uint8_t kPack[64] = {
+    2,  1,  0,  6,  5,  4,  10, 9,  8,  14, 13, 12, 18, 17, 16, 22, 21, 20, 26, 25, 24, 30,
+    29, 28, 34, 33, 32, 38, 37, 36, 42, 41, 40, 46, 45, 44, 50, 49, 48, 54, 53, 52, 58, 57,
+    56, 62, 61, 60};
+
+inline __m512i encode_48(__m512i x, __m512i spread, __m512i shifts, __m512i chars) {
+    x = _mm512_multishift_epi64_epi8(shifts, _mm512_permutexvar_epi8(spread, x));
+    return _mm512_permutexvar_epi8(x, chars);
+}
+
+// 64 characters -> bytes 0..47 of *out.
+inline bool decode_64(__m512i x, __m512i table_lo, __m512i table_hi, __m512i pack, __m512i* out) {
+    __m512i v = _mm512_permutex2var_epi8(table_lo, x, table_hi);
+    if (_mm512_movepi8_mask(_mm512_or_si512(v, x))) return false;
+    v = _mm512_madd_epi16(_mm512_maddubs_epi16(v, _mm512_set1_epi32(0x01400140)), _mm512_set1_epi32(0x00011000));
+    *out = _mm512_permutexvar_epi8(pack, v);
+    return true;
+}
+
+} // namespace
+
+void base64_encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet) {
+    const Base64Tables& t = base64_tables(alphabet);
+    const __m512i spread = _mm512_load_si512((const void*)kSpread);
+    // The field order within each 64-bit lane, as bit offsets.
+    const __m512i shifts = _mm512_set1_epi64(0x3036242A1016040AULL);
+    const __m512i chars = _mm512_loadu_si512((const void*)t.encode);
+    size_t i = 0;
+    for (; n - i >= 48; i += 48, dst += 64) {
+        __m512i x = n - i >= 64 ? _mm512_loadu_si512((const void*)(src + i)) : load_tail_512(src + i, 48);
+        _mm512_storeu_si512((void*)dst, encode_48(x, spread, shifts, chars));
+    }
+    size_t r = (n - i) / 3 * 3;
+    if (r) {
+        __m512i x = encode_48(load_tail_512(src + i, r), spread, shifts, chars);
+        _mm512_mask_storeu_epi8(dst, _bzhi_u64(~0ull, (unsigned)(r / 3 * 4)), x);
+    }
+}
+
+bool base64_decode(const char* src, size_t n, uint8_t* dst, Base64 alphabet) {
+    const Base64Tables& t = base64_tables(alphabet);
+    const __m512i table_lo = _mm512_loadu_si512((const void*)t.decode);
+    const __m512i table_hi = _mm512_loadu_si512((const void*)(t.decode + 64));
+    const __m512i pack = _mm512_load_si512((const void*)kPack);
+    const uint8_t* s = (const uint8_t*)src;
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64, dst += 48) {
+        __m512i v;
+        if (!decode_64(_mm512_loadu_si512((const void*)(s + i)), table_lo, table_hi, pack, &v)) return false;
+        if (i + 128 <= n) _mm512_storeu_si512((void*)dst, v);
+        else _mm512_mask_storeu_epi8(dst, ~0ull >> 16, v);
+    }
+    if (i < n) {
+        __mmask64 k = _bzhi_u64(~0ull, (unsigned)(n - i));
+        // Lanes past the end read as 'A', which is valid and ignored.
+        __m512i v;
+        __m512i x = _mm512_mask_mov_epi8(_mm512_set1_epi8('A'), k, load_tail_512(s + i, n - i));
+        if (!decode_64(x, table_lo, table_hi, pack, &v)) return false;
+        _mm512_mask_storeu_epi8(dst, _bzhi_u64(~0ull, (unsigned)((n - i) / 4 * 3)), v);
+    }
+    return true;
+}
+
+} // namespace avx512icl
+} // namespace simd
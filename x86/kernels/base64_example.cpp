@@ -0,0 +1,234 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <cstdint>
+#include "arena.h"
+#include "base64.h"
+#include "cpu_features.h"
+#include "dispatch.h"
+
+namespace {
+
+// Bit by bit, straight from RFC 4648.
+std::string reference_encode(const std::vector<uint8_t>& src, simd::Base64 alphabet, bool pad) {
+    const char* chars = alphabet == simd::Base64::Url
+                            ? "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+                            : "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    size_t bits = src.size() * 8;
+    for (size_t b = 0; b < bits; b += 6) {
+        int v = 0;
+        for (size_t j = b; j < b + 6; ++j) {
+            v = v << 1 | (j < bits ? src[j / 8] >> (7 - j % 8) & 1 : 0);
+        }
+        out += chars[v];
+    }
+    while (pad && out.size() % 4) out += '=';
+    return out;
+}
+
+// Encoding into a destination that ends at a guard page, from a source that
+// ends at one, so any byte read or written out of bounds faults.
+std::string encode(const simd::KernelTable& t, const std::vector<uint8_t>& src, simd::Base64 alphabet, bool pad) {
+    simd::GuardedBuffer in(src.size()), out(simd::base64_encoded_length(src.size(), pad));
+    if (!src.empty()) std::memcpy(in.data(), src.data(), src.size());
+    simd::Base64Encoder enc(alphabet, pad, t);
+    char* dst = (char*)out.data();
+    size_t k = enc.update(in.data(), src.size(), dst);
+    k += enc.finish(dst + k);
+    return std::string(dst, k);
+}
+
+bool decode(const simd::KernelTable& t, const std::string& text, simd::Base64 alphabet, std::vector<uint8_t>* bytes) {
+    simd::GuardedBuffer in(text.size()), out(simd::base64_decoded_length(text.size()));
+    if (!text.empty()) std::memcpy(in.data(), text.data(), text.size());
+    simd::Base64Decoder dec(alphabet, t);
+    size_t k = 0, tail = 0;
+    bool ok = dec.update((const char*)in.data(), text.size(), out.data(), &k) && dec.finish(out.data() + k, &tail);
+    bytes->assign(out.data(), out.data() + k + tail);
+    return ok;
+}
+
+// Without guard pages, for the many short decodes of check_validation.
+bool decode_plain(const simd::KernelTable& t, const std::string& text, simd::Base64 alphabet) {
+    uint8_t out[256];
+    simd::Base64Decoder dec(alphabet, t);
+    size_t k = 0, tail = 0;
+    return dec.update(text.data(), text.size(), out, &k) && dec.finish(out + k, &tail);
+}
+
+// The same through pieces of random size.
+std::string encode_pieces(const simd::KernelTable& t, const std::vector<uint8_t>& src, simd::Base64 alphabet,
+                          std::mt19937& rng) {
+    simd::Base64Encoder enc(alphabet, true, t);
+    std::string out(simd::base64_encoded_length(src.size()) + 8, '\0');
+    size_t k = 0;
+    for (size_t i = 0; i < src.size();) {
+        size_t piece = std::min(src.size() - i, (size_t)(rng() % 70));
+        k += enc.update(src.data() + i, piece, &out[k]);
+        i += piece;
+    }
+    k += enc.finish(&out[k]);
+    out.resize(k);
+    return out;
+}
+
+bool decode_pieces(const simd::KernelTable& t, const std::string& text, simd::Base64 alphabet, std::mt19937& rng,
+                   std::vector<uint8_t>* bytes) {
+    simd::Base64Decoder dec(alphabet, t);
+    bytes->assign(simd::base64_decoded_length(text.size()) + 8, 0);
+    size_t k = 0, got = 0;
+    for (size_t i = 0; i < text.size();) {
+        size_t piece = std::min(text.size() - i, (size_t)(rng() % 90));
+        if (!dec.update(text.data() + i, piece, bytes->data() + k, &got)) return false;
+        k += got;
+        i += piece;
+    }
+    bool ok = dec.finish(bytes->data() + k, &got);
+    bytes->resize(k + got);
+    return ok;
+}
+
+bool check_roundtrip(const simd::KernelTable& t) {
+    std::mt19937 rng(1);
+    std::vector<size_t> sizes;
+    for (size_t n = 0; n <= 200; ++n) sizes.push_back(n);
+    for (size_t n : {(size_t)4095, (size_t)4096, (size_t)65537}) sizes.push_back(n);
+    for (size_t n : sizes) {
+        std::vector<uint8_t> src(n), back;
+        for (uint8_t& b : src) b = (uint8_t)rng();
+        for (simd::Base64 alphabet : {simd::Base64::Standard, simd::Base64::Url}) {
+            for (bool pad : {true, false}) {
+                std::string want = reference_encode(src, alphabet, pad);
+                if (encode(t, src, alphabet, pad) != want) return false;
+                if (!decode(t, want, alphabet, &back) || back != src) return false;
+            }
+            std::string text = encode_pieces(t, src, alphabet, rng);
+            if (text != reference_encode(src, alphabet, true)) return false;
+            if (!decode_pieces(t, text, alphabet, rng, &back) || back != src) return false;
+        }
+    }
+    return true;
+}
+
+// Every byte value at every position of inputs that reach each loop of the
+// kernels: valid exactly when it is in the alphabet.
+bool check_validation(const simd::KernelTable& t) {
+    std::mt19937 rng(2);
+    for (simd::Base64 alphabet : {simd::Base64::Standard, simd::Base64::Url}) {
+        for (size_t n : {(size_t)4, (size_t)16, (size_t)20, (size_t)32, (size_t)48, (size_t)64, (size_t)68,
+                         (size_t)100, (size_t)128, (size_t)196}) {
+            std::vector<uint8_t> src(n / 4 * 3);
+            for (uint8_t& b : src) b = (uint8_t)rng();
+            std::string good = reference_encode(src, alphabet, false);
+            const char* extra = alphabet == simd::Base64::Url ? "-_" : "+/";
+            for (size_t pos = 0; pos < n; ++pos) {
+                for (int c = 0; c < 256; ++c) {
+                    std::string text = good;
+                    text[pos] = (char)c;
+                    // '=' last is padding.
+                    bool in = c < 128 && (std::isalnum(c) || c == extra[0] || c == extra[1]);
+                    in = in || (c == '=' && pos == n - 1);
+                    if (decode_plain(t, text, alphabet) != in) return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Padding and lengths.
+bool check_edges(const simd::KernelTable& t) {
+    struct Case {
+        const char* text;
+        bool ok;
+        const char* bytes;
+    };
+    const Case cases[] = {
+        {"", true, ""},          {"QQ==", true, "A"},      {"QUI=", true, "AB"},      {"QUJD", true, "ABC"},
+        {"QQ", true, "A"},       {"QUI", true, "AB"},      {"Q", false, ""},          {"Q===", false, ""},
+        {"QQ=", false, ""},      {"QQ=A", false, ""},      {"=QQQ", false, ""},       {"QQ==QUJD", false, ""},
+        {"QUJDQQ==", true, "ABCA"}, {"QUJD\n", false, ""}, {"QUJD QUJD", false, ""}, {"QUJDQ", false, ""},
+        {"QR==", true, "A"},     {"====", false, ""},
+    };
+    std::vector<uint8_t> back;
+    for (const Case& c : cases) {
+        if (decode(t, c.text, simd::Base64::Standard, &back) != c.ok) return false;
+        if (c.ok && std::string(back.begin(), back.end()) != c.bytes) return false;
+    }
+    // Padding split across updates, and nothing after it.
+    simd::Base64Decoder dec(simd::Base64::Standard, t);
+    uint8_t out[8];
+    size_t k = 0;
+    if (!dec.update("QUJDQQ=", 7, out, &k) || k != 3 || !dec.update("=", 1, out + 3, &k) || k != 1) return false;
+    if (dec.update("QQ", 2, out, &k) || dec.update("", 0, out, &k) || dec.finish(out, &k)) return false;
+    // finish resets the decoder.
+    return dec.update("QUJD", 4, out, &k) && k == 3 && dec.finish(out, &k) && k == 0;
+}
+
+template <typename F>
+double gb_per_s(size_t bytes, F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 5; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return bytes / best / 1e9;
+}
+
+void bench(const simd::KernelTable& t, const std::string& name) {
+    const size_t n = (size_t)1 << 20;
+    std::vector<uint8_t> src(n), back(n);
+    std::mt19937 rng(3);
+    for (uint8_t& b : src) b = (uint8_t)rng();
+    std::string text(simd::base64_encoded_length(n), '\0');
+    double enc = gb_per_s(n, [&] {
+        simd::Base64Encoder e(simd::Base64::Standard, true, t);
+        size_t k = e.update(src.data(), n, &text[0]);
+        e.finish(&text[k]);
+    });
+    double dec = gb_per_s(n, [&] {
+        simd::Base64Decoder d(simd::Base64::Standard, t);
+        size_t k = 0, tail = 0;
+        d.update(text.data(), text.size(), back.data(), &k);
+        d.finish(back.data() + k, &tail);
+    });
+    std::cout << "  " << std::setw(13) << std::left << name << std::right << " encode " << std::setw(6) << enc
+              << "  decode " << std::setw(6) << dec << " GB/s" << (back == src ? "" : "  MISMATCH") << std::endl;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    std::vector<simd::Isa> levels;
+    for (simd::Isa isa : {simd::Isa::Scalar, simd::Isa::SSE41, simd::Isa::AVX2, simd::Isa::AVX512}) {
+        if (isa <= simd::detect_isa()) levels.push_back(isa);
+    }
+    for (simd::Isa isa : levels) {
+        const simd::KernelTable& t = simd::kernels_for(isa);
+        bool good = check_roundtrip(t) && check_validation(t) && check_edges(t);
+        std::cout << std::setw(7) << simd::isa_name(isa) << " encode/decode vs RFC 4648, guarded: "
+                  << (good ? "OK" : "MISMATCH") << std::endl;
+        ok = ok && good;
+    }
+
+    std::cout << std::endl << "1 MiB of random bytes, GB/s of binary data:" << std::fixed << std::setprecision(2)
+              << std::endl;
+    for (simd::Isa isa : levels) {
+        std::string name = simd::isa_name(isa);
+        const simd::CpuFeatures& f = simd::cpu_features();
+        if (isa == simd::Isa::AVX512 && f.avx512vbmi && f.avx512vbmi2) name += " (vbmi)";
+        bench(simd::kernels_for(isa), name);
+    }
+    return ok ? 0 : 1;
+}
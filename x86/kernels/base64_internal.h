@@ -0,0 +1,173 @@
+#ifndef SIMD_BASE64_INTERNAL_H
+#define SIMD_BASE64_INTERNAL_H
+
+// Helpers shared by the per-ISA base64 kernels. Everything but the tables
+// has internal linkage so each translation unit compiles its own copy with
+// its own flags.
+//
+// Encoding works on groups of 3 bytes -> 4 characters, 12 bytes per
+// 16-byte vector:
+//   1. pshufb repeats the middle byte of each group, so each 32-bit lane
+//      holds [b1 b0 b2 b1] and every 6-bit field lies within one 16-bit half;
+//   2. one mulhi and one mullo shift the four fields into the four bytes;
+//   3. the fields become characters by adding an offset per range (A-Z,
+//      a-z, 0-9, 62, 63), which a saturating subtract, one compare and a
+//      16-entry pshufb pick.
+// Decoding reverses it, 16 characters -> 12 bytes:
+//   1. validation: every high nibble has one bit in decode_hi, and
+//      decode_lo[low nibble] has that bit set when the character is not in
+//      the alphabet, so the block is valid if the two pshufb results have no
+//      bit in common (one ptest);
+//   2. a pshufb on the high nibble picks the offset back to 0..63; the one
+//      character that shares its high nibble with another range is moved to
+//      an unused slot first (decode_special, decode_special_delta);
+//   3. pmaddubsw and pmaddwd merge 4 fields into 24 bits per lane, and a
+//      pshufb packs them.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+#include "base64.h"
+
+namespace simd {
+
+struct Base64Tables {
+    char encode[64];          // 6-bit value -> character
+    uint8_t decode[256];      // character -> 6-bit value, 0xFF outside the alphabet
+    int8_t encode_shift[16];
+    uint8_t decode_lo[16];
+    uint8_t decode_hi[16];
+    int8_t decode_roll[16];
+    uint8_t decode_special;
+    int8_t decode_special_delta;
+};
+
+// Built once, in base64_scalar.cpp.
+const Base64Tables& base64_tables(Base64 alphabet);
+
+namespace {
+
+// The n / 3 whole groups of src.
+inline void base64_encode_groups(const Base64Tables& t, const uint8_t* src, size_t n, char* dst) {
+    for (size_t i = 0; i + 3 <= n; i += 3, dst += 4) {
+        uint32_t v = (uint32_t)src[i] << 16 | (uint32_t)src[i + 1] << 8 | src[i + 2];
+        dst[0] = t.encode[v >> 18];
+        dst[1] = t.encode[v >> 12 & 63];
+        dst[2] = t.encode[v >> 6 & 63];
+        dst[3] = t.encode[v & 63];
+    }
+}
+
+// n a multiple of 4.
+inline bool base64_decode_groups(const Base64Tables& t, const char* src, size_t n, uint8_t* dst) {
+    const uint8_t* s = (const uint8_t*)src;
+    for (size_t i = 0; i < n; i += 4, dst += 3) {
+        uint32_t a = t.decode[s[i]], b = t.decode[s[i + 1]], c = t.decode[s[i + 2]], d = t.decode[s[i + 3]];
+        if ((a | b | c | d) & 0x80) return false;
+        uint32_t v = a << 18 | b << 12 | c << 6 | d;
+        dst[0] = (uint8_t)(v >> 16);
+        dst[1] = (uint8_t)(v >> 8);
+        dst[2] = (uint8_t)v;
+    }
+    return true;
+}
+
+#if defined(__SSE4_1__)
+
+struct Base64Luts128 {
+    __m128i shift, lo, hi, roll, special, delta;
+
+    explicit Base64Luts128(const Base64Tables& t)
+        : shift(_mm_loadu_si128((const __m128i*)t.encode_shift)),
+          lo(_mm_loadu_si128((const __m128i*)t.decode_lo)),
+          hi(_mm_loadu_si128((const __m128i*)t.decode_hi)),
+          roll(_mm_loadu_si128((const __m128i*)t.decode_roll)),
+          special(_mm_set1_epi8((char)t.decode_special)),
+          delta(_mm_set1_epi8(t.decode_special_delta)) {}
+};
+
+// Bytes 0..11 of x -> 16 characters.
+inline __m128i base64_encode_128(__m128i x, const Base64Luts128& l) {
+    x = _mm_shuffle_epi8(x, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    __m128i ac = _mm_mulhi_epu16(_mm_and_si128(x, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+    __m128i bd = _mm_mullo_epi16(_mm_and_si128(x, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+    __m128i idx = _mm_or_si128(ac, bd);
+    // 0..25 -> 13, 26..51 -> 0, 52..63 -> 1..12.
+    __m128i range = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+    range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), idx), _mm_set1_epi8(13)));
+    return _mm_add_epi8(idx, _mm_shuffle_epi8(l.shift, range));
+}
+
+// 16 characters -> bytes 0..11 of *out; false if any is not in the alphabet.
+inline bool base64_decode_128(__m128i x, const Base64Luts128& l, __m128i* out) {
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i hi = _mm_and_si128(_mm_srli_epi32(x, 4), nibble);
+    __m128i bad = _mm_and_si128(_mm_shuffle_epi8(l.lo, _mm_and_si128(x, nibble)), _mm_shuffle_epi8(l.hi, hi));
+    if (!_mm_testz_si128(bad, bad)) return false;
+    hi = _mm_add_epi8(hi, _mm_and_si128(_mm_cmpeq_epi8(x, l.special), l.delta));
+    x = _mm_add_epi8(x, _mm_shuffle_epi8(l.roll, hi));
+    x = _mm_madd_epi16(_mm_maddubs_epi16(x, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+    *out = _mm_shuffle_epi8(x, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    return true;
+}
+
+// Bytes 0..11 of v.
+inline void base64_store_12(uint8_t* dst, __m128i v) {
+    _mm_storel_epi64((__m128i*)dst, v);
+    uint32_t w = (uint32_t)_mm_extract_epi32(v, 2);
+    std::memcpy(dst + 8, &w, 4);
+}
+
+#endif
+
+#if defined(__AVX2__)
+
+struct Base64Luts256 {
+    __m256i shift, lo, hi, roll, special, delta;
+
+    explicit Base64Luts256(const Base64Luts128& l)
+        : shift(_mm256_broadcastsi128_si256(l.shift)),
+          lo(_mm256_broadcastsi128_si256(l.lo)),
+          hi(_mm256_broadcastsi128_si256(l.hi)),
+          roll(_mm256_broadcastsi128_si256(l.roll)),
+          special(_mm256_broadcastsi128_si256(l.special)),
+          delta(_mm256_broadcastsi128_si256(l.delta)) {}
+};
+
+// The 128-bit steps in both lanes: bytes 0..11 of each lane -> 32
+// characters.
+inline __m256i base64_encode_256(__m256i x, const Base64Luts256& l) {
+    x = _mm256_shuffle_epi8(x, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                                1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    __m256i ac = _mm256_mulhi_epu16(_mm256_and_si256(x, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+    __m256i bd = _mm256_mullo_epi16(_mm256_and_si256(x, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+    __m256i idx = _mm256_or_si256(ac, bd);
+    __m256i range = _mm256_subs_epu8(idx, _mm256_set1_epi8(51));
+    range = _mm256_or_si256(range, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), idx), _mm256_set1_epi8(13)));
+    return _mm256_add_epi8(idx, _mm256_shuffle_epi8(l.shift, range));
+}
+
+// 32 characters -> bytes 0..23 of *out.
+inline bool base64_decode_256(__m256i x, const Base64Luts256& l, __m256i* out) {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi32(x, 4), nibble);
+    __m256i bad = _mm256_and_si256(_mm256_shuffle_epi8(l.lo, _mm256_and_si256(x, nibble)), _mm256_shuffle_epi8(l.hi, hi));
+    if (!_mm256_testz_si256(bad, bad)) return false;
+    hi = _mm256_add_epi8(hi, _mm256_and_si256(_mm256_cmpeq_epi8(x, l.special), l.delta));
+    x = _mm256_add_epi8(x, _mm256_shuffle_epi8(l.roll, hi));
+    x = _mm256_madd_epi16(_mm256_maddubs_epi16(x, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+    x = _mm256_shuffle_epi8(x, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    // 12 bytes at the bottom of each lane -> 24 at the bottom.
+    *out = _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    return true;
+}
+
+#endif
+
+} // namespace
+
+} // namespace simd
+
+#endif // SIMD_BASE64_INTERNAL_H
@@ -0,0 +1,74 @@
+#include "kernels_internal.h"
+#include "base64_internal.h"
+
+namespace simd {
+
+namespace {
+
+Base64Tables make_tables(const char* alphabet, const int8_t (&shift)[16], const uint8_t (&lo)[16],
+                         const uint8_t (&hi)[16], const int8_t (&roll)[16], char special, int8_t delta) {
+    Base64Tables t;
+    std::memcpy(t.encode, alphabet, 64);
+    std::memset(t.decode, 0xFF, sizeof t.decode);
+    for (int i = 0; i < 64; ++i) t.decode[(uint8_t)alphabet[i]] = (uint8_t)i;
+    std::memcpy(t.encode_shift, shift, 16);
+    std::memcpy(t.decode_lo, lo, 16);
+    std::memcpy(t.decode_hi, hi, 16);
+    std::memcpy(t.decode_roll, roll, 16);
+    t.decode_special = (uint8_t)special;
+    t.decode_special_delta = delta;
+    return t;
+}
+
+// Encoding offsets by range (see base64_internal.h): 0 for a-z, 1..10 for
+// 0-9, 11 and 12 for the values 62 and 63, 13 for A-Z.
+const int8_t kShiftStandard[16] = {'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                   '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0};
+const int8_t kShiftUrl[16] = {'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                              '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0};
+
+// Validation bits. Standard: 0x01 for high nibble 2 (valid: + /), 0x02 for 3
+// (0-9), 0x04 for 4 and 6 (A-O, a-o), 0x08 for 5 and 7 (P-Z, p-z), 0x10
+// for the nibbles with no valid character.
+const uint8_t kLoStandard[16] = {0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A};
+const uint8_t kHiStandard[16] = {0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10};
+// Url: 0x01 for no valid character, 0x02 for 2 (-), 0x04 for 3, 0x08 for 4
+// and 6, 0x10 for 5 (P-Z, _), 0x20 for 7.
+const uint8_t kLoUrl[16] = {0x0B, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+                            0x03, 0x03, 0x07, 0x37, 0x37, 0x35, 0x37, 0x27};
+const uint8_t kHiUrl[16] = {0x01, 0x01, 0x02, 0x04, 0x08, 0x10, 0x08, 0x20,
+                            0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01};
+
+// Offsets back to 0..63 by high nibble. '+' and '/' (standard) share
+// nibble 2, as do 'P'-'Z' and '_' (url); '/' and '_' move to slot 1.
+const int8_t kRollStandard[16] = {0, 63 - '/', 62 - '+', 52 - '0', -'A', -'A', 26 - 'a', 26 - 'a',
+                                  0, 0, 0, 0, 0, 0, 0, 0};
+const int8_t kRollUrl[16] = {0, 63 - '_', 62 - '-', 52 - '0', -'A', -'A', 26 - 'a', 26 - 'a',
+                             0, 0, 0, 0, 0, 0, 0, 0};
+
+} // namespace
+
+const Base64Tables& base64_tables(Base64 alphabet) {
+    static const Base64Tables standard =
+        make_tables("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/", kShiftStandard,
+                    kLoStandard, kHiStandard, kRollStandard, '/', 1 - 2);
+    static const Base64Tables url =
+        make_tables("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_", kShiftUrl, kLoUrl, kHiUrl,
+                    kRollUrl, '_', 1 - 5);
+    return alphabet == Base64::Url ? url : standard;
+}
+
+namespace scalar {
+
+void base64_encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet) {
+    base64_encode_groups(base64_tables(alphabet), src, n, dst);
+}
+
+bool base64_decode(const char* src, size_t n, uint8_t* dst, Base64 alphabet) {
+    return base64_decode_groups(base64_tables(alphabet), src, n, dst);
+}
+
+} // namespace scalar
+} // namespace simd
@@ -0,0 +1,40 @@
+#include "kernels_internal.h"
+#include "base64_internal.h"
+#include "safe_load.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace sse41 {
+
+// 12 bytes -> 16 characters and back per vector (base64_internal.h). The
+// last whole block of the input is read with load_tail_128, so no load
+// passes the end of src near a page boundary.
+
+void base64_encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet) {
+    const Base64Tables& t = base64_tables(alphabet);
+    const Base64Luts128 l(t);
+    size_t i = 0;
+    for (; n - i >= 12; i += 12, dst += 16) {
+        __m128i x = n - i >= 16 ? _mm_loadu_si128((const __m128i*)(src + i)) : load_tail_128(src + i, 12);
+        _mm_storeu_si128((__m128i*)dst, base64_encode_128(x, l));
+    }
+    base64_encode_groups(t, src + i, n - i, dst);
+}
+
+bool base64_decode(const char* src, size_t n, uint8_t* dst, Base64 alphabet) {
+    const Base64Tables& t = base64_tables(alphabet);
+    const Base64Luts128 l(t);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16, dst += 12) {
+        __m128i v;
+        if (!base64_decode_128(_mm_loadu_si128((const __m128i*)(src + i)), l, &v)) return false;
+        // A full store is safe while another block follows.
+        if (i + 32 <= n) _mm_storeu_si128((__m128i*)dst, v);
+        else base64_store_12(dst, v);
+    }
+    return base64_decode_groups(t, src + i, n - i, dst);
+}
+
+} // namespace sse41
+} // namespace simd
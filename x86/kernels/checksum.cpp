@@ -0,0 +1,118 @@
+#include "checksum.h"
+#include "checksum_internal.h"
+#include "dispatch.h"
+#include "memops.h"
+
+namespace simd {
+
+namespace {
+
+// The 128-bit product of a and b, high half XOR low half.
+uint64_t mul_fold64(uint64_t a, uint64_t b) {
+    unsigned __int128 p = (unsigned __int128)a * b;
+    return (uint64_t)p ^ (uint64_t)(p >> 64);
+}
+
+uint64_t avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ull;
+    return h ^ h >> 32;
+}
+
+} // namespace
+
+uint32_t crc32c(const void* src, size_t n, uint32_t crc) {
+    return kernels().crc32c((const uint8_t*)src, n, crc, nullptr, 0);
+}
+
+uint32_t copy_crc32c(void* dst, const void* src, size_t n, uint32_t crc) {
+    return kernels().crc32c((const uint8_t*)src, n, crc, (uint8_t*)dst, nt_threshold());
+}
+
+uint32_t adler32(const void* src, size_t n, uint32_t adler) {
+    return kernels().adler32((const uint8_t*)src, n, adler, nullptr, 0);
+}
+
+uint32_t copy_adler32(void* dst, const void* src, size_t n, uint32_t adler) {
+    return kernels().adler32((const uint8_t*)src, n, adler, (uint8_t*)dst, nt_threshold());
+}
+
+uint64_t hash64(const void* src, size_t n, uint64_t seed) {
+    Hash64 h(seed);
+    h.update(src, n);
+    return h.digest();
+}
+
+uint64_t copy_hash64(void* dst, const void* src, size_t n, uint64_t seed) {
+    Hash64 h(seed);
+    h.copy(dst, src, n);
+    return h.digest();
+}
+
+Hash64::Hash64(uint64_t seed) : Hash64(seed, kernels()) {}
+
+Hash64::Hash64(uint64_t seed, const KernelTable& kernels) : kernels_(&kernels) {
+    for (size_t j = 0; j < kHash64KeyWords; ++j) key_[j] = kHash64Secret[j] + (j % 2 ? 0 - seed : seed);
+    reset();
+}
+
+void Hash64::reset() {
+    for (size_t i = 0; i < 8; ++i) acc_[i] = kHash64Init[i];
+    carry_size_ = 0;
+    stripe_ = 0;
+    total_ = 0;
+}
+
+void Hash64::update(const void* src, size_t n) {
+    absorb((const uint8_t*)src, n, nullptr);
+}
+
+void Hash64::copy(void* dst, const void* src, size_t n) {
+    absorb((const uint8_t*)src, n, (uint8_t*)dst);
+}
+
+void Hash64::absorb(const uint8_t* src, size_t n, uint8_t* dst) {
+    total_ += n;
+    if (carry_size_) {
+        size_t take = 64 - carry_size_ < n ? 64 - carry_size_ : n;
+        std::memcpy(carry_ + carry_size_, src, take);
+        if (dst) {
+            std::memcpy(dst, src, take);
+            dst += take;
+        }
+        carry_size_ += take;
+        src += take;
+        n -= take;
+        if (carry_size_ < 64) return;
+        kernels_->hash64_stripes(acc_, key_, carry_, 1, stripe_, nullptr, 0);
+        stripe_ = (stripe_ + 1) % 16;
+        carry_size_ = 0;
+    }
+    size_t stripes = n / 64;
+    kernels_->hash64_stripes(acc_, key_, src, stripes, stripe_, dst, nt_threshold());
+    stripe_ = (stripe_ + stripes) % 16;
+    size_t rest = n - stripes * 64;
+    std::memcpy(carry_, src + stripes * 64, rest);
+    if (dst) std::memcpy(dst + stripes * 64, src + stripes * 64, rest);
+    carry_size_ = rest;
+}
+
+// The input is hashed as if padded with zeros to whole stripes; the length
+// tells the padding from data.
+uint64_t Hash64::digest() const {
+    uint64_t acc[8];
+    std::memcpy(acc, acc_, sizeof acc);
+    if (carry_size_) {
+        uint8_t last[64] = {};
+        std::memcpy(last, carry_, carry_size_);
+        kernels_->hash64_stripes(acc, key_, last, 1, stripe_, nullptr, 0);
+    }
+    // Merged with key bytes from 11 on, off the word grid of the stripes.
+    uint64_t merge[8];
+    std::memcpy(merge, (const uint8_t*)key_ + 11, sizeof merge);
+    uint64_t h = total_ * kHash64Prime64;
+    for (size_t i = 0; i < 8; i += 2) h += mul_fold64(acc[i] ^ merge[i], acc[i + 1] ^ merge[i + 1]);
+    return avalanche(h);
+}
+
+} // namespace simd
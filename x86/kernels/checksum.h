@@ -0,0 +1,77 @@
+#ifndef SIMD_CHECKSUM_H
+#define SIMD_CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+struct KernelTable;
+
+// Checksums for data in flight: CRC-32C, Adler-32 and a 64-bit
+// non-cryptographic hash. Each takes the value so far and returns it
+// updated, as zlib does, so a buffer can be checked in pieces:
+//
+//   crc32c(b, nb, crc32c(a, na)) == crc32c(ab, na + nb)
+//
+// The copy_ forms also copy src to dst in the same pass, so a block that is
+// replicated is read once: below nt_threshold() (memops.h) with regular
+// stores, at or above it with streaming stores if dst is aligned to the
+// level's vector width.
+// The buffers must not overlap.
+
+// CRC-32C (Castagnoli polynomial 0x1EDC6F41, reflected, inverted at both
+// ends), the checksum of iSCSI, SCTP, ext4 and Btrfs. Start with 0.
+uint32_t crc32c(const void* src, size_t n, uint32_t crc = 0);
+uint32_t copy_crc32c(void* dst, const void* src, size_t n, uint32_t crc = 0);
+
+// Adler-32 of RFC 1950 (zlib). Start with 1.
+uint32_t adler32(const void* src, size_t n, uint32_t adler = 1);
+uint32_t copy_adler32(void* dst, const void* src, size_t n, uint32_t adler = 1);
+
+// 64-bit hash of n bytes. The same on every level, but not XXH3: it has the
+// XXH3 long-input loop on all input, 8 lanes of 64 bits fed 64-byte stripes
+// through 32x32 -> 64-bit multiplies, and a seed that changes the key rather
+// than the start. Not for adversarial input.
+uint64_t hash64(const void* src, size_t n, uint64_t seed = 0);
+uint64_t copy_hash64(void* dst, const void* src, size_t n, uint64_t seed = 0);
+
+// The words of the hash64 key: 16 stripes of a 1 KiB block take their key
+// from words [s, s + 8), and the scramble after the block from the last 8.
+const size_t kHash64KeyWords = 24;
+
+// Streaming hash64, for input that arrives in pieces of any size. update
+// keeps the end of a stripe (at most 63 bytes) for the next call; digest is
+// hash64 of everything so far and can be read at any time.
+//
+//   Hash64 h;
+//   while (size_t got = read(fd, buf, sizeof buf)) h.update(buf, got);
+//   uint64_t sum = h.digest();
+class Hash64 {
+public:
+    explicit Hash64(uint64_t seed = 0);
+    // With a specific level's kernels, for benchmarks and cross-checking.
+    Hash64(uint64_t seed, const KernelTable& kernels);
+
+    void update(const void* src, size_t n);
+    // update, and copy src to dst as copy_hash64 does.
+    void copy(void* dst, const void* src, size_t n);
+    uint64_t digest() const;
+    // Starts a new stream with the same seed.
+    void reset();
+
+private:
+    void absorb(const uint8_t* src, size_t n, uint8_t* dst);
+
+    const KernelTable* kernels_;
+    uint64_t acc_[8];
+    uint64_t key_[kHash64KeyWords];
+    uint8_t carry_[64];
+    size_t carry_size_;
+    size_t stripe_;    // position of the next stripe in its block
+    uint64_t total_;
+};
+
+} // namespace simd
+
+#endif // SIMD_CHECKSUM_H
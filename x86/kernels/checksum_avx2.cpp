@@ -0,0 +1,107 @@
+#include "kernels_internal.h"
+#include "checksum_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx2 {
+
+namespace {
+
+// 64 bytes per step, as two vectors with the weights 64..33 and 32..1.
+template <CopyMode kMode>
+uint32_t adler32_loop(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst) {
+    uint32_t s1 = adler & 0xFFFF, s2 = adler >> 16;
+    const __m256i w0 = _mm256_load_si256((const __m256i*)kAdlerWeights);
+    const __m256i w1 = _mm256_load_si256((const __m256i*)(kAdlerWeights + 32));
+    const __m256i ones = _mm256_set1_epi16(1), zero = _mm256_setzero_si256();
+    size_t i = 0;
+    while (n - i >= 64) {
+        size_t steps = (n - i) / 64 < kAdlerNmax / 64 ? (n - i) / 64 : kAdlerNmax / 64;
+        __m256i ps = _mm256_zextsi128_si256(_mm_cvtsi32_si128((int)(s1 * steps)));
+        __m256i v1 = zero, v2 = _mm256_zextsi128_si256(_mm_cvtsi32_si128((int)s2));
+        for (; steps; --steps, i += 64) {
+            __m256i a = _mm256_loadu_si256((const __m256i*)(src + i));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(src + i + 32));
+            put_256<kMode>(dst + i, a);
+            put_256<kMode>(dst + i + 32, b);
+            ps = _mm256_add_epi32(ps, v1);
+            v1 = _mm256_add_epi32(v1, _mm256_add_epi32(_mm256_sad_epu8(a, zero), _mm256_sad_epu8(b, zero)));
+            v2 = _mm256_add_epi32(v2, _mm256_madd_epi16(_mm256_maddubs_epi16(a, w0), ones));
+            v2 = _mm256_add_epi32(v2, _mm256_madd_epi16(_mm256_maddubs_epi16(b, w1), ones));
+        }
+        v2 = _mm256_add_epi32(v2, _mm256_slli_epi32(ps, 6));
+        s1 = (s1 + hsum_epi32_256(v1)) % kAdlerMod;
+        s2 = hsum_epi32_256(v2) % kAdlerMod;
+    }
+    return adler32_bytes(s1, s2, src + i, n - i, kMode == CopyMode::None ? nullptr : dst + i);
+}
+
+template <CopyMode kMode>
+void hash64_loop(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes, size_t first,
+                 uint8_t* dst) {
+    __m256i a0 = _mm256_loadu_si256((const __m256i*)acc);
+    __m256i a1 = _mm256_loadu_si256((const __m256i*)(acc + 4));
+    const __m256i prime = _mm256_set1_epi32((int)kHash64Prime32);
+    size_t p = first;
+    for (size_t s = 0; s < stripes; ++s, src += 64) {
+        __m256i d0 = _mm256_loadu_si256((const __m256i*)src);
+        __m256i d1 = _mm256_loadu_si256((const __m256i*)(src + 32));
+        put_256<kMode>(dst + 64 * s, d0);
+        put_256<kMode>(dst + 64 * s + 32, d1);
+        __m256i dk0 = _mm256_xor_si256(d0, _mm256_loadu_si256((const __m256i*)(key + p)));
+        __m256i dk1 = _mm256_xor_si256(d1, _mm256_loadu_si256((const __m256i*)(key + p + 4)));
+        a0 = _mm256_add_epi64(a0, _mm256_shuffle_epi32(d0, 0x4E));
+        a1 = _mm256_add_epi64(a1, _mm256_shuffle_epi32(d1, 0x4E));
+        a0 = _mm256_add_epi64(a0, _mm256_mul_epu32(dk0, _mm256_srli_epi64(dk0, 32)));
+        a1 = _mm256_add_epi64(a1, _mm256_mul_epu32(dk1, _mm256_srli_epi64(dk1, 32)));
+        if (++p == 16) {
+            p = 0;
+            __m256i x0 = _mm256_xor_si256(_mm256_xor_si256(a0, _mm256_srli_epi64(a0, 47)),
+                                          _mm256_loadu_si256((const __m256i*)(key + 16)));
+            __m256i x1 = _mm256_xor_si256(_mm256_xor_si256(a1, _mm256_srli_epi64(a1, 47)),
+                                          _mm256_loadu_si256((const __m256i*)(key + 20)));
+            a0 = _mm256_add_epi64(_mm256_mul_epu32(x0, prime),
+                                  _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x0, 32), prime), 32));
+            a1 = _mm256_add_epi64(_mm256_mul_epu32(x1, prime),
+                                  _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x1, 32), prime), 32));
+        }
+    }
+    _mm256_storeu_si256((__m256i*)acc, a0);
+    _mm256_storeu_si256((__m256i*)(acc + 4), a1);
+}
+
+} // namespace
+
+uint32_t adler32(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst, size_t nt_threshold) {
+    switch (copy_mode(dst, n, nt_threshold, 32)) {
+        case CopyMode::None:
+            return adler32_loop<CopyMode::None>(src, n, adler, dst);
+        case CopyMode::Store:
+            return adler32_loop<CopyMode::Store>(src, n, adler, dst);
+        default: {
+            uint32_t r = adler32_loop<CopyMode::Stream>(src, n, adler, dst);
+            _mm_sfence();
+            return r;
+        }
+    }
+}
+
+void hash64_stripes(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes, size_t first,
+                    uint8_t* dst, size_t nt_threshold) {
+    switch (copy_mode(dst, stripes * 64, nt_threshold, 32)) {
+        case CopyMode::None:
+            hash64_loop<CopyMode::None>(acc, key, src, stripes, first, dst);
+            break;
+        case CopyMode::Store:
+            hash64_loop<CopyMode::Store>(acc, key, src, stripes, first, dst);
+            break;
+        default:
+            hash64_loop<CopyMode::Stream>(acc, key, src, stripes, first, dst);
+            _mm_sfence();
+            break;
+    }
+}
+
+} // namespace avx2
+} // namespace simd
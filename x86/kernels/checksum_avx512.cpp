@@ -0,0 +1,93 @@
+#include "kernels_internal.h"
+#include "checksum_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512 {
+
+namespace {
+
+// 64 bytes per step, one vector with the weights 64..1.
+template <CopyMode kMode>
+uint32_t adler32_loop(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst) {
+    uint32_t s1 = adler & 0xFFFF, s2 = adler >> 16;
+    const __m512i w = _mm512_load_si512((const void*)kAdlerWeights);
+    const __m512i ones = _mm512_set1_epi16(1), zero = _mm512_setzero_si512();
+    size_t i = 0;
+    while (n - i >= 64) {
+        size_t steps = (n - i) / 64 < kAdlerNmax / 64 ? (n - i) / 64 : kAdlerNmax / 64;
+        __m512i ps = _mm512_zextsi128_si512(_mm_cvtsi32_si128((int)(s1 * steps)));
+        __m512i v1 = zero, v2 = _mm512_zextsi128_si512(_mm_cvtsi32_si128((int)s2));
+        for (; steps; --steps, i += 64) {
+            __m512i a = _mm512_loadu_si512((const void*)(src + i));
+            put_512<kMode>(dst + i, a);
+            ps = _mm512_add_epi32(ps, v1);
+            v1 = _mm512_add_epi32(v1, _mm512_sad_epu8(a, zero));
+            v2 = _mm512_add_epi32(v2, _mm512_madd_epi16(_mm512_maddubs_epi16(a, w), ones));
+        }
+        v2 = _mm512_add_epi32(v2, _mm512_slli_epi32(ps, 6));
+        s1 = (s1 + (uint32_t)_mm512_reduce_add_epi32(v1)) % kAdlerMod;
+        s2 = (uint32_t)_mm512_reduce_add_epi32(v2) % kAdlerMod;
+    }
+    return adler32_bytes(s1, s2, src + i, n - i, kMode == CopyMode::None ? nullptr : dst + i);
+}
+
+// A stripe is one vector: the 8 lanes of the hash are the 8 lanes of a.
+template <CopyMode kMode>
+void hash64_loop(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes, size_t first,
+                 uint8_t* dst) {
+    __m512i a = _mm512_loadu_si512((const void*)acc);
+    const __m512i prime = _mm512_set1_epi64((long long)kHash64Prime32);
+    size_t p = first;
+    for (size_t s = 0; s < stripes; ++s, src += 64) {
+        __m512i d = _mm512_loadu_si512((const void*)src);
+        put_512<kMode>(dst + 64 * s, d);
+        __m512i dk = _mm512_xor_si512(d, _mm512_loadu_si512((const void*)(key + p)));
+        a = _mm512_add_epi64(a, _mm512_shuffle_epi32(d, (_MM_PERM_ENUM)0x4E));
+        a = _mm512_add_epi64(a, _mm512_mul_epu32(dk, _mm512_srli_epi64(dk, 32)));
+        if (++p == 16) {
+            p = 0;
+            // a ^ (a >> 47) ^ key in one ternary-logic op.
+            __m512i x = _mm512_ternarylogic_epi64(a, _mm512_srli_epi64(a, 47),
+                                                  _mm512_loadu_si512((const void*)(key + 16)), 0x96);
+            a = _mm512_mullo_epi64(x, prime);
+        }
+    }
+    _mm512_storeu_si512((void*)acc, a);
+}
+
+} // namespace
+
+uint32_t adler32(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst, size_t nt_threshold) {
+    switch (copy_mode(dst, n, nt_threshold, 64)) {
+        case CopyMode::None:
+            return adler32_loop<CopyMode::None>(src, n, adler, dst);
+        case CopyMode::Store:
+            return adler32_loop<CopyMode::Store>(src, n, adler, dst);
+        default: {
+            uint32_t r = adler32_loop<CopyMode::Stream>(src, n, adler, dst);
+            _mm_sfence();
+            return r;
+        }
+    }
+}
+
+void hash64_stripes(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes, size_t first,
+                    uint8_t* dst, size_t nt_threshold) {
+    switch (copy_mode(dst, stripes * 64, nt_threshold, 64)) {
+        case CopyMode::None:
+            hash64_loop<CopyMode::None>(acc, key, src, stripes, first, dst);
+            break;
+        case CopyMode::Store:
+            hash64_loop<CopyMode::Store>(acc, key, src, stripes, first, dst);
+            break;
+        default:
+            hash64_loop<CopyMode::Stream>(acc, key, src, stripes, first, dst);
+            _mm_sfence();
+            break;
+    }
+}
+
+} // namespace avx512
+} // namespace simd
@@ -0,0 +1,253 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include "arena.h"
+#include "checksum.h"
+#include "dispatch.h"
+#include "memops.h"
+
+namespace {
+
+typedef std::vector<uint8_t> Bytes;
+
+// References written from the definitions: CRC-32C a bit at a time, Adler-32
+// a byte at a time with a reduction per byte, and hash64 from the steps in
+// checksum.h with none of the kernels' blocking.
+uint32_t reference_crc32c(const Bytes& s, uint32_t crc) {
+    uint32_t c = ~crc;
+    for (uint8_t b : s) {
+        c ^= b;
+        for (int k = 0; k < 8; ++k) c = c >> 1 ^ (c & 1 ? 0x82F63B78u : 0);
+    }
+    return ~c;
+}
+
+uint32_t reference_adler32(const Bytes& s, uint32_t adler) {
+    uint32_t a = adler & 0xFFFF, b = adler >> 16;
+    for (uint8_t x : s) {
+        a = (a + x) % 65521;
+        b = (b + a) % 65521;
+    }
+    return b << 16 | a;
+}
+
+uint64_t reference_hash64(const Bytes& s, uint64_t seed) {
+    static const uint64_t kSecret[24] = {
+        0x2CB0F69F4ABEA221ull, 0x9417034723148989ull, 0xDD555950609DFE03ull, 0xDBAFB150DEB12800ull,
+        0x7E789B2E6C442CB6ull, 0xF41E5636C7E4F8C4ull, 0x0959D150F8FBA7E4ull, 0xA97316F13CDB9EEAull,
+        0x74CD8258F9520068ull, 0x55C74A62E116868Bull, 0xD2F4C799A2023CBDull, 0xDF98CB79A37B51B9ull,
+        0x396F5885524F3905ull, 0xAF1D56386CA3B276ull, 0xA9FFBE6B5104E85Aull, 0x6BD0C51B9FD533B3ull,
+        0x980CE91C50AB4B56ull, 0x28AC395780FE62C5ull, 0x768912E3A6BCEDC7ull, 0x50B3E8C9332C7C88ull,
+        0xCE3BBFE520BD47DAull, 0xCBA6C8E8E0BB7C4Full, 0xBF194DB8434A346Dull, 0x7D8F2A7B60416D7Full};
+    uint64_t key[24], acc[8] = {0xC2B2AE3Dull,         0x9E3779B185EBCA87ull, 0xC2B2AE3D27D4EB4Full,
+                                0x165667B19E3779F9ull, 0x85EBCA77C2B2AE63ull, 0x85EBCA77ull,
+                                0x27D4EB2F165667C5ull, 0x9E3779B1ull};
+    for (int j = 0; j < 24; ++j) key[j] = j % 2 ? kSecret[j] - seed : kSecret[j] + seed;
+    Bytes padded = s;
+    padded.resize((s.size() + 63) / 64 * 64);
+    for (size_t s0 = 0; s0 < padded.size(); s0 += 64) {
+        size_t p = s0 / 64 % 16;
+        for (int i = 0; i < 8; ++i) {
+            uint64_t d = 0;
+            for (int b = 7; b >= 0; --b) d = d << 8 | padded[s0 + 8 * i + b];
+            uint64_t dk = d ^ key[p + i];
+            acc[i ^ 1] += d;
+            acc[i] += (dk & 0xFFFFFFFF) * (dk >> 32);
+        }
+        if (p == 15) {
+            for (int i = 0; i < 8; ++i) acc[i] = (acc[i] ^ acc[i] >> 47 ^ key[16 + i]) * 0x9E3779B1ull;
+        }
+    }
+    uint64_t h = s.size() * 0x9E3779B185EBCA87ull;
+    for (int i = 0; i < 8; i += 2) {
+        uint64_t m0, m1;
+        std::memcpy(&m0, (const uint8_t*)key + 11 + 8 * i, 8);
+        std::memcpy(&m1, (const uint8_t*)key + 19 + 8 * i, 8);
+        unsigned __int128 p = (unsigned __int128)(acc[i] ^ m0) * (acc[i + 1] ^ m1);
+        h += (uint64_t)p ^ (uint64_t)(p >> 64);
+    }
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ull;
+    return h ^ h >> 32;
+}
+
+Bytes random_bytes(size_t n, std::mt19937& rng) {
+    Bytes s(n);
+    for (uint8_t& b : s) b = (uint8_t)rng();
+    return s;
+}
+
+// Each checksum of s, from an input that ends at a guard page, and its copy
+// form into an output that ends at one.
+bool check_one(const simd::KernelTable& t, const Bytes& s, uint32_t start, uint64_t seed) {
+    simd::GuardedBuffer in(s.size()), out(s.size());
+    if (!s.empty()) std::memcpy(in.data(), s.data(), s.size());
+    uint32_t crc = reference_crc32c(s, start), adler = reference_adler32(s, start % 65521 * 65537);
+    uint64_t hash = reference_hash64(s, seed);
+    if (t.crc32c(in.data(), s.size(), start, nullptr, 0) != crc) return false;
+    if (t.adler32(in.data(), s.size(), start % 65521 * 65537, nullptr, 0) != adler) return false;
+    if (simd::Hash64(seed, t).digest() != reference_hash64(Bytes(), seed)) return false;
+    simd::Hash64 h(seed, t);
+    h.update(in.data(), s.size());
+    if (h.digest() != hash) return false;
+
+    // Regular stores, then streaming stores from a threshold of 0.
+    for (size_t nt : {(size_t)-1, (size_t)0}) {
+        std::memset(out.data(), 0, s.size());
+        if (t.crc32c(in.data(), s.size(), start, out.data(), nt) != crc) return false;
+        if (!std::equal(s.begin(), s.end(), out.data())) return false;
+        std::memset(out.data(), 0, s.size());
+        if (t.adler32(in.data(), s.size(), start % 65521 * 65537, out.data(), nt) != adler) return false;
+        if (!std::equal(s.begin(), s.end(), out.data())) return false;
+    }
+    // Hash64::copy takes the threshold from memops.h.
+    size_t saved = simd::nt_threshold();
+    bool good = true;
+    for (size_t nt : {(size_t)-1, (size_t)0}) {
+        simd::set_nt_threshold(nt);
+        std::memset(out.data(), 0, s.size());
+        simd::Hash64 c(seed, t);
+        c.copy(out.data(), in.data(), s.size());
+        good = good && c.digest() == hash && std::equal(s.begin(), s.end(), out.data());
+    }
+    simd::set_nt_threshold(saved);
+    return good;
+}
+
+bool check_checksums(const simd::KernelTable& t) {
+    // Published values: RFC 3720 B.4 for CRC-32C, and "Wikipedia" for Adler-32.
+    const char* digits = "123456789";
+    if (t.crc32c((const uint8_t*)digits, 9, 0, nullptr, 0) != 0xE3069283u) return false;
+    Bytes zeros(32, 0), ones(32, 0xFF);
+    if (t.crc32c(zeros.data(), 32, 0, nullptr, 0) != 0x8A9136AAu) return false;
+    if (t.crc32c(ones.data(), 32, 0, nullptr, 0) != 0x62A8AB43u) return false;
+    if (t.adler32((const uint8_t*)"Wikipedia", 9, 1, nullptr, 0) != 0x11E60398u) return false;
+
+    std::mt19937 rng(1);
+    for (size_t n = 0; n <= 600; ++n) {
+        if (!check_one(t, random_bytes(n, rng), rng(), rng())) return false;
+    }
+    for (size_t n : {4096, 5551, 5552, 5553, 65536 + 7, 1 << 20}) {
+        if (!check_one(t, random_bytes(n, rng), rng(), rng())) return false;
+    }
+    // All 0xFF from the largest start: the sums of Adler-32 at their highest.
+    Bytes high(100000, 0xFF);
+    if (t.adler32(high.data(), high.size(), 0xFFF0FFF0, nullptr, 0) != reference_adler32(high, 0xFFF0FFF0)) {
+        return false;
+    }
+    return true;
+}
+
+// Pieces of random size, through the same objects: the checksums must not
+// depend on where the input is cut.
+bool check_streaming(const simd::KernelTable& t) {
+    std::mt19937 rng(2);
+    for (int round = 0; round < 200; ++round) {
+        Bytes s = random_bytes(rng() % 5000, rng);
+        uint64_t seed = rng();
+        Bytes out(s.size());
+        uint32_t crc = 0, adler = 1;
+        simd::Hash64 h(seed, t), c(seed, t);
+        for (size_t i = 0; i < s.size();) {
+            size_t piece = std::min(s.size() - i, (size_t)(rng() % 300));
+            crc = t.crc32c(s.data() + i, piece, crc, nullptr, 0);
+            adler = t.adler32(s.data() + i, piece, adler, nullptr, 0);
+            h.update(s.data() + i, piece);
+            c.copy(out.data() + i, s.data() + i, piece);
+            i += piece;
+        }
+        if (crc != reference_crc32c(s, 0) || adler != reference_adler32(s, 1)) return false;
+        uint64_t hash = reference_hash64(s, seed);
+        if (h.digest() != hash || c.digest() != hash || out != s) return false;
+        h.reset();
+        h.update(s.data(), s.size());
+        if (h.digest() != hash) return false;
+    }
+    return true;
+}
+
+template <typename F>
+double gb_per_s(size_t bytes, F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 5; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return bytes / best / 1e9;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    std::vector<simd::Isa> levels;
+    for (simd::Isa isa : {simd::Isa::Scalar, simd::Isa::SSE41, simd::Isa::AVX2, simd::Isa::AVX512}) {
+        if (isa <= simd::detect_isa()) levels.push_back(isa);
+    }
+    for (simd::Isa isa : levels) {
+        const simd::KernelTable& t = simd::kernels_for(isa);
+        bool good = check_checksums(t) && check_streaming(t);
+        std::cout << std::setw(7) << simd::isa_name(isa) << " CRC-32C, Adler-32, hash64 vs reference, guarded: "
+                  << (good ? "OK" : "MISMATCH") << std::endl;
+        ok = ok && good;
+    }
+
+    // In cache: the speed of each checksum alone.
+    std::mt19937 rng(3);
+    Bytes small = random_bytes((size_t)1 << 20, rng);
+    volatile uint64_t sink = 0;
+    std::cout << std::endl << "1 MiB in cache, GB/s:" << std::fixed << std::setprecision(2) << std::endl;
+    std::cout << std::setw(7) << "" << std::setw(10) << "crc32c" << std::setw(10) << "adler32" << std::setw(10)
+              << "hash64" << std::endl;
+    for (simd::Isa isa : levels) {
+        const simd::KernelTable& t = simd::kernels_for(isa);
+        double crc = gb_per_s(small.size(), [&] { sink = t.crc32c(small.data(), small.size(), 0, nullptr, 0); });
+        double adler = gb_per_s(small.size(), [&] { sink = t.adler32(small.data(), small.size(), 1, nullptr, 0); });
+        double hash = gb_per_s(small.size(), [&] {
+            simd::Hash64 h(0, t);
+            h.update(small.data(), small.size());
+            sink = h.digest();
+        });
+        std::cout << std::setw(7) << simd::isa_name(isa) << std::setw(10) << crc << std::setw(10) << adler
+                  << std::setw(10) << hash << std::endl;
+    }
+
+    // Out of cache: a copy and then a checksum read the source twice; the
+    // fused copy reads it once.
+    size_t big = (size_t)256 << 20;
+    uint8_t* src = (uint8_t*)simd::aligned_malloc(big);
+    uint8_t* dst = (uint8_t*)simd::aligned_malloc(big);
+    for (size_t i = 0; i < big; i += 8) std::memcpy(src + i, &i, 8);
+    std::memset(dst, 0, big);
+    std::cout << std::endl << "256 MiB copy at " << simd::isa_name(simd::detect_isa()) << ", GB/s:" << std::endl;
+    std::cout << std::setw(10) << "" << std::setw(16) << "copy, then sum" << std::setw(10) << "fused" << std::endl;
+    double two = gb_per_s(big, [&] {
+        simd::simd_memcpy(dst, src, big);
+        sink = simd::crc32c(src, big);
+    });
+    double one = gb_per_s(big, [&] { sink = simd::copy_crc32c(dst, src, big); });
+    std::cout << std::setw(10) << "crc32c" << std::setw(16) << two << std::setw(10) << one << std::endl;
+    two = gb_per_s(big, [&] {
+        simd::simd_memcpy(dst, src, big);
+        sink = simd::adler32(src, big);
+    });
+    one = gb_per_s(big, [&] { sink = simd::copy_adler32(dst, src, big); });
+    std::cout << std::setw(10) << "adler32" << std::setw(16) << two << std::setw(10) << one << std::endl;
+    two = gb_per_s(big, [&] {
+        simd::simd_memcpy(dst, src, big);
+        sink = simd::hash64(src, big);
+    });
+    one = gb_per_s(big, [&] { sink = simd::copy_hash64(dst, src, big); });
+    std::cout << std::setw(10) << "hash64" << std::setw(16) << two << std::setw(10) << one << std::endl;
+    simd::aligned_free(src);
+    simd::aligned_free(dst);
+    return ok ? 0 : 1;
+}
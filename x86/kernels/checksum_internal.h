@@ -0,0 +1,135 @@
+#ifndef SIMD_CHECKSUM_INTERNAL_H
+#define SIMD_CHECKSUM_INTERNAL_H
+
+// Helpers shared by the per-ISA checksum kernels (checksum.h). Like the
+// other *_internal.h helpers they have internal linkage, so each translation
+// unit compiles its own copy with its own flags.
+//
+//   crc32c   4 x 128 bits folded 64 bytes at a time with PCLMUL, reduced to
+//            32 bits with two crc32 instructions, the rest with crc32 on 8
+//            bytes at a time. A fold multiplies the two halves of a lane by
+//            x^(D+32) and x^(D-32) mod P (bit-reflected, D the distance in
+//            bits) and XORs the data D bits further on.
+//   adler32  per vector, pmaddubsw by the weights n..1 then pmaddwd by ones
+//            add to s2, psadbw to s1; s2 also gains n times each earlier
+//            value of s1, kept as one running sum and shifted in at the
+//            end. Reduced mod 65521 every 5552 bytes, as zlib does.
+//   hash64   per 64-bit lane, acc[i] += lo32(d ^ k) * hi32(d ^ k) with
+//            pmuludq and acc[i ^ 1] += d with a pshufd.
+//
+// The copy forms store each vector once it is loaded, so the loops are
+// templated on how (CopyMode).
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "checksum.h"
+
+#if defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace simd {
+
+const uint32_t kAdlerMod = 65521;
+// The most bytes before s2 may overflow 32 bits.
+const size_t kAdlerNmax = 5552;
+
+const uint64_t kHash64Prime32 = 0x9E3779B1ull;
+const uint64_t kHash64Prime64 = 0x9E3779B185EBCA87ull;
+const uint64_t kHash64Init[8] = {0xC2B2AE3Dull,         0x9E3779B185EBCA87ull, 0xC2B2AE3D27D4EB4Full,
+                                 0x165667B19E3779F9ull, 0x85EBCA77C2B2AE63ull, 0x85EBCA77ull,
+                                 0x27D4EB2F165667C5ull, 0x9E3779B1ull};
+// 24 words of splitmix64, in checksum_scalar.cpp; the seed is added to the
+// even words and subtracted from the odd ones.
+extern const uint64_t kHash64Secret[kHash64KeyWords];
+
+// Folding constants for CRC-32C: 512 bits for the main loop, 128 bits to
+// merge the four lanes.
+const uint64_t kCrc32cFold512Lo = 0x740EEF02ull;
+const uint64_t kCrc32cFold512Hi = 0x9E4ADDF8ull;
+const uint64_t kCrc32cFold128Lo = 0xF20C0DFEull;
+const uint64_t kCrc32cFold128Hi = 0x14CD00BD6ull;
+
+namespace {
+
+enum class CopyMode { None, Store, Stream };
+
+// How a checksum kernel writes dst: not at all without one, with streaming
+// stores for large copies to a destination aligned to the vector.
+inline CopyMode copy_mode(const uint8_t* dst, size_t n, size_t nt_threshold, size_t align) {
+    if (!dst) return CopyMode::None;
+    if (n >= nt_threshold && ((uintptr_t)dst & (align - 1)) == 0) return CopyMode::Stream;
+    return CopyMode::Store;
+}
+
+// Adler-32 a byte at a time, for inputs below a vector and the tails.
+// Copies to dst unless it is null.
+inline uint32_t adler32_bytes(uint32_t s1, uint32_t s2, const uint8_t* src, size_t n, uint8_t* dst) {
+    if (dst) std::memcpy(dst, src, n);
+    while (n) {
+        size_t m = n < kAdlerNmax ? n : kAdlerNmax;
+        n -= m;
+        for (; m; --m) {
+            s1 += *src++;
+            s2 += s1;
+        }
+        s1 %= kAdlerMod;
+        s2 %= kAdlerMod;
+    }
+    return s2 << 16 | s1;
+}
+
+// Weights 64..1 for pmaddubsw; a level with w-byte vectors uses the last w.
+alignas(64) const int8_t kAdlerWeights[64] = {
+    64, 63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47, 46, 45, 44, 43,
+    42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21,
+    20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9,  8,  7,  6,  5,  4,  3,  2,  1};
+
+#if defined(__SSE4_1__)
+template <CopyMode kMode>
+inline void put_128(uint8_t* p, __m128i v) {
+    if (kMode == CopyMode::Store)       _mm_storeu_si128((__m128i*)p, v);
+    else if (kMode == CopyMode::Stream) _mm_stream_si128((__m128i*)p, v);
+}
+
+inline uint32_t hsum_epi32_128(__m128i v) {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0x4E));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0xB1));
+    return (uint32_t)_mm_cvtsi128_si32(v);
+}
+
+// acc * kHash64Prime32 in 64-bit lanes, from two pmuludq.
+inline __m128i hash64_mul_prime_128(__m128i acc) {
+    const __m128i prime = _mm_set1_epi32((int)kHash64Prime32);
+    __m128i lo = _mm_mul_epu32(acc, prime);
+    __m128i hi = _mm_mul_epu32(_mm_srli_epi64(acc, 32), prime);
+    return _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+}
+#endif
+
+#if defined(__AVX2__)
+template <CopyMode kMode>
+inline void put_256(uint8_t* p, __m256i v) {
+    if (kMode == CopyMode::Store)       _mm256_storeu_si256((__m256i*)p, v);
+    else if (kMode == CopyMode::Stream) _mm256_stream_si256((__m256i*)p, v);
+}
+
+inline uint32_t hsum_epi32_256(__m256i v) {
+    return hsum_epi32_128(_mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+}
+#endif
+
+#if defined(__AVX512F__)
+template <CopyMode kMode>
+inline void put_512(uint8_t* p, __m512i v) {
+    if (kMode == CopyMode::Store)       _mm512_storeu_si512((void*)p, v);
+    else if (kMode == CopyMode::Stream) _mm512_stream_si512((__m512i*)p, v);
+}
+#endif
+
+} // namespace
+
+} // namespace simd
+
+#endif // SIMD_CHECKSUM_INTERNAL_H
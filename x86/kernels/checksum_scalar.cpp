@@ -0,0 +1,120 @@
+#include "kernels_internal.h"
+#include "checksum_internal.h"
+
+#include <cstring>
+
+namespace simd {
+
+const uint64_t kHash64Secret[kHash64KeyWords] = {
+    0x2CB0F69F4ABEA221ull, 0x9417034723148989ull, 0xDD555950609DFE03ull, 0xDBAFB150DEB12800ull,
+    0x7E789B2E6C442CB6ull, 0xF41E5636C7E4F8C4ull, 0x0959D150F8FBA7E4ull, 0xA97316F13CDB9EEAull,
+    0x74CD8258F9520068ull, 0x55C74A62E116868Bull, 0xD2F4C799A2023CBDull, 0xDF98CB79A37B51B9ull,
+    0x396F5885524F3905ull, 0xAF1D56386CA3B276ull, 0xA9FFBE6B5104E85Aull, 0x6BD0C51B9FD533B3ull,
+    0x980CE91C50AB4B56ull, 0x28AC395780FE62C5ull, 0x768912E3A6BCEDC7ull, 0x50B3E8C9332C7C88ull,
+    0xCE3BBFE520BD47DAull, 0xCBA6C8E8E0BB7C4Full, 0xBF194DB8434A346Dull, 0x7D8F2A7B60416D7Full,
+};
+
+namespace {
+
+// Slicing-by-8: table[k][b] is the CRC of byte b followed by k zero bytes.
+struct Crc32cTables {
+    uint32_t t[8][256];
+};
+
+Crc32cTables make_crc32c_tables() {
+    Crc32cTables tables;
+    for (uint32_t b = 0; b < 256; ++b) {
+        uint32_t c = b;
+        for (int k = 0; k < 8; ++k) c = c >> 1 ^ (c & 1 ? 0x82F63B78u : 0);
+        tables.t[0][b] = c;
+    }
+    for (int k = 1; k < 8; ++k) {
+        for (uint32_t b = 0; b < 256; ++b) {
+            uint32_t c = tables.t[k - 1][b];
+            tables.t[k][b] = c >> 8 ^ tables.t[0][c & 0xFF];
+        }
+    }
+    return tables;
+}
+
+const Crc32cTables& crc32c_tables() {
+    static const Crc32cTables tables = make_crc32c_tables();
+    return tables;
+}
+
+uint32_t crc32c_bytes(const Crc32cTables& tables, uint32_t c, const uint8_t* p, size_t n) {
+    const uint32_t (*t)[256] = tables.t;
+    for (; n >= 8; n -= 8, p += 8) {
+        uint32_t lo, hi;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 4);
+        lo ^= c;
+        c = t[7][lo & 0xFF] ^ t[6][lo >> 8 & 0xFF] ^ t[5][lo >> 16 & 0xFF] ^ t[4][lo >> 24] ^
+            t[3][hi & 0xFF] ^ t[2][hi >> 8 & 0xFF] ^ t[1][hi >> 16 & 0xFF] ^ t[0][hi >> 24];
+    }
+    for (; n; --n) c = c >> 8 ^ t[0][(c ^ *p++) & 0xFF];
+    return c;
+}
+
+// The copy forms go a few KiB at a time, copied and then summed while they
+// are still in L1.
+const size_t kCopyChunk = 4096;
+
+} // namespace
+
+namespace scalar {
+
+uint32_t crc32c(const uint8_t* src, size_t n, uint32_t crc, uint8_t* dst, size_t) {
+    const Crc32cTables& tables = crc32c_tables();
+    uint32_t c = ~crc;
+    for (size_t i = 0; i < n; i += kCopyChunk) {
+        size_t m = n - i < kCopyChunk ? n - i : kCopyChunk;
+        if (dst) std::memcpy(dst + i, src + i, m);
+        c = crc32c_bytes(tables, c, src + i, m);
+    }
+    return ~c;
+}
+
+uint32_t adler32(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst, size_t) {
+    uint32_t s1 = adler & 0xFFFF, s2 = adler >> 16;
+    size_t i = 0;
+    for (; n - i >= kAdlerNmax; i += kAdlerNmax) {
+        if (dst) std::memcpy(dst + i, src + i, kAdlerNmax);
+        const uint8_t* p = src + i;
+        for (size_t j = 0; j < kAdlerNmax; j += 8) {
+            s1 += p[j];     s2 += s1;
+            s1 += p[j + 1]; s2 += s1;
+            s1 += p[j + 2]; s2 += s1;
+            s1 += p[j + 3]; s2 += s1;
+            s1 += p[j + 4]; s2 += s1;
+            s1 += p[j + 5]; s2 += s1;
+            s1 += p[j + 6]; s2 += s1;
+            s1 += p[j + 7]; s2 += s1;
+        }
+        s1 %= kAdlerMod;
+        s2 %= kAdlerMod;
+    }
+    return adler32_bytes(s1, s2, src + i, n - i, dst ? dst + i : nullptr);
+}
+
+void hash64_stripes(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes, size_t first,
+                    uint8_t* dst, size_t) {
+    if (dst) std::memcpy(dst, src, stripes * 64);
+    size_t p = first;
+    for (size_t s = 0; s < stripes; ++s, src += 64) {
+        for (size_t i = 0; i < 8; ++i) {
+            uint64_t d;
+            std::memcpy(&d, src + 8 * i, 8);
+            uint64_t dk = d ^ key[p + i];
+            acc[i ^ 1] += d;
+            acc[i] += (dk & 0xFFFFFFFF) * (dk >> 32);
+        }
+        if (++p == 16) {
+            p = 0;
+            for (size_t i = 0; i < 8; ++i) acc[i] = (acc[i] ^ acc[i] >> 47 ^ key[16 + i]) * kHash64Prime32;
+        }
+    }
+}
+
+} // namespace scalar
+} // namespace simd
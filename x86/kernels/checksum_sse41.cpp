@@ -0,0 +1,99 @@
+#include "kernels_internal.h"
+#include "checksum_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace sse41 {
+
+namespace {
+
+// 32 bytes per step, as two vectors with the weights 32..17 and 16..1.
+template <CopyMode kMode>
+uint32_t adler32_loop(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst) {
+    uint32_t s1 = adler & 0xFFFF, s2 = adler >> 16;
+    const __m128i w0 = _mm_load_si128((const __m128i*)(kAdlerWeights + 32));
+    const __m128i w1 = _mm_load_si128((const __m128i*)(kAdlerWeights + 48));
+    const __m128i ones = _mm_set1_epi16(1), zero = _mm_setzero_si128();
+    size_t i = 0;
+    while (n - i >= 32) {
+        size_t steps = (n - i) / 32 < kAdlerNmax / 32 ? (n - i) / 32 : kAdlerNmax / 32;
+        // ps adds up s1 before each step; s1 from earlier calls counts once per step.
+        __m128i ps = _mm_cvtsi32_si128((int)(s1 * steps));
+        __m128i v1 = zero, v2 = _mm_cvtsi32_si128((int)s2);
+        for (; steps; --steps, i += 32) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 16));
+            put_128<kMode>(dst + i, a);
+            put_128<kMode>(dst + i + 16, b);
+            ps = _mm_add_epi32(ps, v1);
+            v1 = _mm_add_epi32(v1, _mm_add_epi32(_mm_sad_epu8(a, zero), _mm_sad_epu8(b, zero)));
+            v2 = _mm_add_epi32(v2, _mm_madd_epi16(_mm_maddubs_epi16(a, w0), ones));
+            v2 = _mm_add_epi32(v2, _mm_madd_epi16(_mm_maddubs_epi16(b, w1), ones));
+        }
+        v2 = _mm_add_epi32(v2, _mm_slli_epi32(ps, 5));
+        s1 = (s1 + hsum_epi32_128(v1)) % kAdlerMod;
+        s2 = hsum_epi32_128(v2) % kAdlerMod;
+    }
+    return adler32_bytes(s1, s2, src + i, n - i, kMode == CopyMode::None ? nullptr : dst + i);
+}
+
+template <CopyMode kMode>
+void hash64_loop(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes, size_t first,
+                 uint8_t* dst) {
+    __m128i a[4];
+    for (int j = 0; j < 4; ++j) a[j] = _mm_loadu_si128((const __m128i*)(acc + 2 * j));
+    size_t p = first;
+    for (size_t s = 0; s < stripes; ++s, src += 64) {
+        for (int j = 0; j < 4; ++j) {
+            __m128i d = _mm_loadu_si128((const __m128i*)(src + 16 * j));
+            put_128<kMode>(dst + 64 * s + 16 * j, d);
+            __m128i dk = _mm_xor_si128(d, _mm_loadu_si128((const __m128i*)(key + p + 2 * j)));
+            a[j] = _mm_add_epi64(a[j], _mm_shuffle_epi32(d, 0x4E));
+            a[j] = _mm_add_epi64(a[j], _mm_mul_epu32(dk, _mm_srli_epi64(dk, 32)));
+        }
+        if (++p == 16) {
+            p = 0;
+            for (int j = 0; j < 4; ++j) {
+                __m128i k = _mm_loadu_si128((const __m128i*)(key + 16 + 2 * j));
+                a[j] = hash64_mul_prime_128(_mm_xor_si128(_mm_xor_si128(a[j], _mm_srli_epi64(a[j], 47)), k));
+            }
+        }
+    }
+    for (int j = 0; j < 4; ++j) _mm_storeu_si128((__m128i*)(acc + 2 * j), a[j]);
+}
+
+} // namespace
+
+uint32_t adler32(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst, size_t nt_threshold) {
+    switch (copy_mode(dst, n, nt_threshold, 16)) {
+        case CopyMode::None:
+            return adler32_loop<CopyMode::None>(src, n, adler, dst);
+        case CopyMode::Store:
+            return adler32_loop<CopyMode::Store>(src, n, adler, dst);
+        default: {
+            uint32_t r = adler32_loop<CopyMode::Stream>(src, n, adler, dst);
+            _mm_sfence();
+            return r;
+        }
+    }
+}
+
+void hash64_stripes(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes, size_t first,
+                    uint8_t* dst, size_t nt_threshold) {
+    switch (copy_mode(dst, stripes * 64, nt_threshold, 16)) {
+        case CopyMode::None:
+            hash64_loop<CopyMode::None>(acc, key, src, stripes, first, dst);
+            break;
+        case CopyMode::Store:
+            hash64_loop<CopyMode::Store>(acc, key, src, stripes, first, dst);
+            break;
+        default:
+            hash64_loop<CopyMode::Stream>(acc, key, src, stripes, first, dst);
+            _mm_sfence();
+            break;
+    }
+}
+
+} // namespace sse41
+} // namespace simd
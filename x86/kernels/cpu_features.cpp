@@ -0,0 +1,114 @@
+#include "cpu_features.h"
+
+#include <cpuid.h>
+#include <cstdint>
+#include <unistd.h>
+
+namespace simd {
+
+namespace {
+
+// XGETBV(0) returns XCR0: which register states the OS saves/restores.
+// Issued via inline asm so this file does not need -mxsave.
+uint64_t read_xcr0() {
+    uint32_t eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+}
+
+// Walks the deterministic cache parameters: leaf 4 on Intel, 0x8000001D on
+// AMD (needs TOPOEXT). Both share the same register layout.
+void detect_caches(CpuFeatures& f, unsigned int max_leaf, bool amd) {
+    unsigned int eax, ebx, ecx, edx;
+    unsigned int leaf = 0;
+    if (amd) {
+        if (__get_cpuid_max(0x80000000, nullptr) >= 0x8000001D) {
+            __cpuid(0x80000001, eax, ebx, ecx, edx);
+            if (ecx & (1u << 22)) leaf = 0x8000001D;
+        }
+    } else if (max_leaf >= 4) {
+        leaf = 4;
+    }
+
+    unsigned int llc_level = 0;
+    for (unsigned int sub = 0; leaf != 0 && sub < 16; ++sub) {
+        __cpuid_count(leaf, sub, eax, ebx, ecx, edx);
+        unsigned int type = eax & 0x1F;  // 0 = no more caches, 2 = instruction
+        if (type == 0) break;
+        if (type == 2) continue;
+        unsigned int level = (eax >> 5) & 0x7;
+        size_t ways       = ((ebx >> 22) & 0x3FF) + 1;
+        size_t partitions = ((ebx >> 12) & 0x3FF) + 1;
+        size_t line       = (ebx & 0xFFF) + 1;
+        size_t sets       = (size_t)ecx + 1;
+        size_t bytes = ways * partitions * line * sets;
+        if (level == 1) f.l1d_bytes = bytes;
+        if (level == 2) f.l2_bytes = bytes;
+        if (level >= llc_level) {
+            llc_level = level;
+            f.llc_bytes = bytes;
+        }
+    }
+
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    // Hypervisors sometimes hide the cache leaves; ask glibc instead.
+    if (f.llc_bytes == 0) {
+        long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        if (l2 > 0) f.l2_bytes = (size_t)l2;
+        f.llc_bytes = l3 > 0 ? (size_t)l3 : f.l2_bytes;
+    }
+#endif
+}
+
+CpuFeatures detect() {
+    CpuFeatures f = {};
+    unsigned int eax, ebx, ecx, edx;
+
+    unsigned int max_leaf = __get_cpuid_max(0, nullptr);
+    if (max_leaf < 1) return f;
+
+    __cpuid(0, eax, ebx, ecx, edx);
+    detect_caches(f, max_leaf, ebx == signature_AMD_ebx);
+
+    __cpuid(1, eax, ebx, ecx, edx);
+    f.sse2   = (edx & bit_SSE2) != 0;
+    f.ssse3  = (ecx & bit_SSSE3) != 0;
+    f.sse41  = (ecx & bit_SSE4_1) != 0;
+    f.sse42  = (ecx & bit_SSE4_2) != 0;
+    f.popcnt = (ecx & bit_POPCNT) != 0;
+    f.pclmul = (ecx & bit_PCLMUL) != 0;
+
+    // XCR0 bits: 1 = SSE (XMM), 2 = AVX (upper YMM),
+    // 5..7 = AVX-512 (opmask, upper ZMM0-15, ZMM16-31).
+    uint64_t xcr0 = (ecx & bit_OSXSAVE) ? read_xcr0() : 0;
+    bool os_ymm = (xcr0 & 0x06) == 0x06;
+    bool os_zmm = (xcr0 & 0xE6) == 0xE6;
+
+    f.avx = (ecx & bit_AVX) && os_ymm;
+    f.fma = (ecx & bit_FMA) && os_ymm;
+
+    if (max_leaf >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        f.avx2        = (ebx & bit_AVX2) && os_ymm;
+        f.bmi1        = (ebx & bit_BMI) != 0;
+        f.bmi2        = (ebx & bit_BMI2) != 0;
+        f.avx512f     = (ebx & bit_AVX512F) && os_zmm;
+        f.avx512cd    = (ebx & bit_AVX512CD) && os_zmm;
+        f.avx512bw    = (ebx & bit_AVX512BW) && os_zmm;
+        f.avx512dq    = (ebx & bit_AVX512DQ) && os_zmm;
+        f.avx512vl    = (ebx & bit_AVX512VL) && os_zmm;
+        f.avx512vbmi  = (ecx & bit_AVX512VBMI) && os_zmm;
+        f.avx512vbmi2 = (ecx & bit_AVX512VBMI2) && os_zmm;
+    }
+    return f;
+}
+
+} // namespace
+
+const CpuFeatures& cpu_features() {
+    static const CpuFeatures features = detect();
+    return features;
+}
+
+} // namespace simd
@@ -0,0 +1,44 @@
+#ifndef SIMD_CPU_FEATURES_H
+#define SIMD_CPU_FEATURES_H
+
+#include <cstddef>
+
+namespace simd {
+
+// CPU capabilities as seen by user code. A vector extension is only reported
+// when BOTH the CPU implements it (CPUID) AND the OS saves the corresponding
+// register state on context switch (XGETBV / XCR0). An AVX-capable CPU running
+// under an OS that does not enable YMM state must not execute AVX code.
+struct CpuFeatures {
+    bool sse2;
+    bool ssse3;
+    bool sse41;
+    bool sse42;
+    bool popcnt;
+    bool pclmul;
+    bool avx;
+    bool fma;
+    bool avx2;
+    bool bmi1;
+    bool bmi2;
+    bool avx512f;
+    bool avx512cd;
+    bool avx512bw;
+    bool avx512dq;
+    bool avx512vl;
+    bool avx512vbmi;
+    bool avx512vbmi2;
+
+    // Data cache sizes in bytes, 0 if unknown. llc_bytes is the last level
+    // (usually the shared L3); on parts without an L3 it is the L2.
+    size_t l1d_bytes;
+    size_t l2_bytes;
+    size_t llc_bytes;
+};
+
+// Detected once (thread-safe), then cached.
+const CpuFeatures& cpu_features();
+
+} // namespace simd
+
+#endif // SIMD_CPU_FEATURES_H
@@ -0,0 +1,249 @@
+#include "dispatch.h"
+#include "cpu_features.h"
+#include "kernels_internal.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace simd {
+
+namespace {
+
+// Each fill_* overrides only the kernels its level improves on; a table for
+// level L is built by applying every fill_* up to and including L.
+void fill_scalar(KernelTable& t) {
+    t.copy_f32         = scalar::copy_f32;
+    t.scale_f32        = scalar::scale_f32;
+    t.add_f32          = scalar::add_f32;
+    t.sum_f32          = scalar::sum_f32;
+    t.copy_bytes       = scalar::copy_bytes;
+    t.fill_bytes       = scalar::fill_bytes;
+    t.filter_f32       = scalar::filter_f32;
+    t.filter_i32       = scalar::filter_i32;
+    t.filter_i64       = scalar::filter_i64;
+    t.filter_u8        = scalar::filter_u8;
+    t.deinterleave_u8  = scalar::deinterleave_u8;
+    t.deinterleave_u16 = scalar::deinterleave_u16;
+    t.deinterleave_u32 = scalar::deinterleave_u32;
+    t.interleave_u8    = scalar::interleave_u8;
+    t.interleave_u16   = scalar::interleave_u16;
+    t.interleave_u32   = scalar::interleave_u32;
+    t.spmv_f32         = scalar::spmv_f32;
+    t.histogram_u32    = scalar::histogram_u32;
+    t.scatter_add_f32  = scalar::scatter_add_f32;
+    t.gather_f32       = scalar::gather_f32;
+    t.gather_rows_f32  = scalar::gather_rows_f32;
+    t.transpose_u32    = scalar::transpose_u32;
+    t.radix_partition_u64 = scalar::radix_partition_u64;
+    t.sort_i32         = scalar::sort_i32;
+    t.sort_i64         = scalar::sort_i64;
+    t.hash_group       = 8;
+    t.hash_find_u64    = scalar::hash_find_u64;
+    t.hash_insert_u64  = scalar::hash_insert_u64;
+    t.tree_search_u32  = scalar::tree_search_u32;
+    t.base64_encode    = scalar::base64_encode;
+    t.base64_decode    = scalar::base64_decode;
+    t.utf8_validate    = scalar::utf8_validate;
+    t.utf8_to_utf16    = scalar::utf8_to_utf16;
+    t.utf16_to_utf8    = scalar::utf16_to_utf8;
+    t.json_index       = scalar::json_index;
+    t.crc32c           = scalar::crc32c;
+    t.adler32          = scalar::adler32;
+    t.hash64_stripes   = scalar::hash64_stripes;
+}
+
+void fill_sse41(KernelTable& t) {
+    t.copy_f32         = sse41::copy_f32;
+    t.scale_f32        = sse41::scale_f32;
+    t.add_f32          = sse41::add_f32;
+    t.sum_f32          = sse41::sum_f32;
+    t.copy_bytes       = sse41::copy_bytes;
+    t.fill_bytes       = sse41::fill_bytes;
+    t.deinterleave_u8  = sse41::deinterleave_u8;
+    t.deinterleave_u16 = sse41::deinterleave_u16;
+    t.deinterleave_u32 = sse41::deinterleave_u32;
+    t.interleave_u8    = sse41::interleave_u8;
+    t.interleave_u16   = sse41::interleave_u16;
+    t.interleave_u32   = sse41::interleave_u32;
+    t.transpose_u32    = sse41::transpose_u32;
+    t.radix_partition_u64 = sse41::radix_partition_u64;
+    t.hash_group       = 16;
+    t.hash_find_u64    = sse41::hash_find_u64;
+    t.hash_insert_u64  = sse41::hash_insert_u64;
+    t.base64_encode    = sse41::base64_encode;
+    t.base64_decode    = sse41::base64_decode;
+    t.utf8_validate    = sse41::utf8_validate;
+    t.utf8_to_utf16    = sse41::utf8_to_utf16;
+    t.utf16_to_utf8    = sse41::utf16_to_utf8;
+    t.json_index       = sse41::json_index;
+    t.adler32          = sse41::adler32;
+    t.hash64_stripes   = sse41::hash64_stripes;
+
+    const CpuFeatures& f = cpu_features();
+    if (f.sse42 && f.pclmul) {
+        t.crc32c           = sse42::crc32c;
+    }
+}
+
+void fill_avx(KernelTable& t) {
+    t.copy_f32         = avx::copy_f32;
+    t.scale_f32        = avx::scale_f32;
+    t.add_f32          = avx::add_f32;
+    t.sum_f32          = avx::sum_f32;
+    t.copy_bytes       = avx::copy_bytes;
+    t.fill_bytes       = avx::fill_bytes;
+    t.transpose_u32    = avx::transpose_u32;
+}
+
+void fill_avx2(KernelTable& t) {
+    t.sum_f32          = avx2::sum_f32;
+    t.filter_f32       = avx2::filter_f32;
+    t.filter_i32       = avx2::filter_i32;
+    t.filter_i64       = avx2::filter_i64;
+    t.filter_u8        = avx2::filter_u8;
+    t.deinterleave_u8  = avx2::deinterleave_u8;
+    t.deinterleave_u16 = avx2::deinterleave_u16;
+    t.deinterleave_u32 = avx2::deinterleave_u32;
+    t.interleave_u8    = avx2::interleave_u8;
+    t.interleave_u16   = avx2::interleave_u16;
+    t.interleave_u32   = avx2::interleave_u32;
+    t.spmv_f32         = avx2::spmv_f32;
+    t.gather_f32       = avx2::gather_f32;
+    t.gather_rows_f32  = avx2::gather_rows_f32;
+    t.radix_partition_u64 = avx2::radix_partition_u64;
+    t.sort_i32         = avx2::sort_i32;
+    t.sort_i64         = avx2::sort_i64;
+    t.hash_group       = 32;
+    t.hash_find_u64    = avx2::hash_find_u64;
+    t.hash_insert_u64  = avx2::hash_insert_u64;
+    t.tree_search_u32  = avx2::tree_search_u32;
+    t.base64_encode    = avx2::base64_encode;
+    t.base64_decode    = avx2::base64_decode;
+    t.utf8_validate    = avx2::utf8_validate;
+    t.utf8_to_utf16    = avx2::utf8_to_utf16;
+    t.utf16_to_utf8    = avx2::utf16_to_utf8;
+    t.json_index       = avx2::json_index;
+    t.adler32          = avx2::adler32;
+    t.hash64_stripes   = avx2::hash64_stripes;
+}
+
+void fill_avx512(KernelTable& t) {
+    t.copy_f32         = avx512::copy_f32;
+    t.scale_f32        = avx512::scale_f32;
+    t.add_f32          = avx512::add_f32;
+    t.sum_f32          = avx512::sum_f32;
+    t.copy_bytes       = avx512::copy_bytes;
+    t.fill_bytes       = avx512::fill_bytes;
+    t.filter_f32       = avx512::filter_f32;
+    t.filter_i32       = avx512::filter_i32;
+    t.filter_i64       = avx512::filter_i64;
+    t.filter_u8        = avx512::filter_u8;
+    t.deinterleave_u16 = avx512::deinterleave_u16;
+    t.deinterleave_u32 = avx512::deinterleave_u32;
+    t.interleave_u16   = avx512::interleave_u16;
+    t.interleave_u32   = avx512::interleave_u32;
+    t.spmv_f32         = avx512::spmv_f32;
+    t.histogram_u32    = avx512::histogram_u32;
+    t.scatter_add_f32  = avx512::scatter_add_f32;
+    t.gather_f32       = avx512::gather_f32;
+    t.gather_rows_f32  = avx512::gather_rows_f32;
+    t.transpose_u32    = avx512::transpose_u32;
+    t.radix_partition_u64 = avx512::radix_partition_u64;
+    t.sort_i32         = avx512::sort_i32;
+    t.sort_i64         = avx512::sort_i64;
+    t.hash_group       = 64;
+    t.hash_find_u64    = avx512::hash_find_u64;
+    t.hash_insert_u64  = avx512::hash_insert_u64;
+    t.tree_search_u32  = avx512::tree_search_u32;
+    t.utf8_validate    = avx512::utf8_validate;
+    t.utf8_to_utf16    = avx512::utf8_to_utf16;
+    t.utf16_to_utf8    = avx512::utf16_to_utf8;
+    t.json_index       = avx512::json_index;
+    t.adler32          = avx512::adler32;
+    t.hash64_stripes   = avx512::hash64_stripes;
+
+    const CpuFeatures& f = cpu_features();
+    if (f.avx512vbmi && f.avx512vbmi2) {
+        t.filter_u8        = avx512icl::filter_u8;
+        t.deinterleave_u8  = avx512icl::deinterleave_u8;
+        t.interleave_u8    = avx512icl::interleave_u8;
+        t.base64_encode    = avx512icl::base64_encode;
+        t.base64_decode    = avx512icl::base64_decode;
+    }
+}
+
+KernelTable build_table(Isa isa) {
+    KernelTable t = {};
+    t.isa              = isa;
+    fill_scalar(t);
+    if (isa >= Isa::SSE41)  fill_sse41(t);
+    if (isa >= Isa::AVX)    fill_avx(t);
+    if (isa >= Isa::AVX2)   fill_avx2(t);
+    if (isa >= Isa::AVX512) fill_avx512(t);
+    return t;
+}
+
+// Must match the -m flags each level is compiled with.
+Isa best_supported_isa() {
+    const CpuFeatures& f = cpu_features();
+    bool sse41 = f.sse41 && f.popcnt;
+    bool avx = sse41 && f.avx;
+    bool avx2 = avx && f.avx2 && f.fma && f.bmi1 && f.bmi2 && f.pclmul;
+    bool avx512 = avx2 && f.avx512f && f.avx512cd && f.avx512bw && f.avx512dq && f.avx512vl;
+    if (avx512) return Isa::AVX512;
+    if (avx2) return Isa::AVX2;
+    if (avx) return Isa::AVX;
+    if (sse41) return Isa::SSE41;
+    return Isa::Scalar;
+}
+
+bool parse_isa(const char* name, Isa* out) {
+    static const Isa all[] = {Isa::Scalar, Isa::SSE41, Isa::AVX, Isa::AVX2, Isa::AVX512};
+    for (Isa isa : all) {
+        if (std::strcmp(name, isa_name(isa)) == 0) {
+            *out = isa;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::SSE41:  return "sse41";
+        case Isa::AVX:    return "avx";
+        case Isa::AVX2:   return "avx2";
+        case Isa::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+Isa detect_isa() {
+    Isa isa = best_supported_isa();
+    Isa cap;
+    const char* env = std::getenv("SIMD_ISA");
+    // A request above what the hardware supports is ignored, never honoured.
+    if (env && parse_isa(env, &cap) && cap < isa) isa = cap;
+    return isa;
+}
+
+const KernelTable& kernels_for(Isa isa) {
+    static const KernelTable tables[] = {
+        build_table(Isa::Scalar),
+        build_table(Isa::SSE41),
+        build_table(Isa::AVX),
+        build_table(Isa::AVX2),
+        build_table(Isa::AVX512),
+    };
+    return tables[static_cast<int>(isa)];
+}
+
+const KernelTable& kernels() {
+    static const KernelTable& table = kernels_for(detect_isa());
+    return table;
+}
+
+} // namespace simd
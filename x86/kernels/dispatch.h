@@ -0,0 +1,158 @@
+#ifndef SIMD_DISPATCH_H
+#define SIMD_DISPATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include "base64.h"
+#include "checksum.h"
+#include "filter.h"
+#include "hash_map.h"
+#include "json_index.h"
+#include "spmv.h"
+
+namespace simd {
+
+// Instruction-set levels the library is compiled for. Each level implies the
+// ones below it; the CMake flags of every level are listed in CMakeLists.txt.
+enum class Isa {
+    Scalar,  // plain C++, baseline x86-64
+    SSE41,   // -msse4.1 -mpopcnt          (Nehalem,   sde -nhm)
+    AVX,     // -mavx -mpopcnt             (Sandy Bridge, sde -snb)
+    AVX2,    // -mavx2 -mfma -mbmi -mbmi2 -mpclmul (Haswell, sde -hsw)
+    AVX512   // AVX2 + -mavx512{f,cd,bw,dq,vl} (Skylake-X / Ice Lake, sde -skx / -icl)
+};
+
+const char* isa_name(Isa isa);
+
+// One function pointer per kernel. Every entry is always valid: a level that
+// has no specialised version of a kernel inherits the one from the level below.
+struct KernelTable {
+    Isa isa;
+
+    // dst[i] = src[i]
+    void (*copy_f32)(float* dst, const float* src, size_t n);
+    // dst[i] = a * src[i]
+    void (*scale_f32)(float* dst, const float* src, float a, size_t n);
+    // dst[i] = x[i] + y[i]
+    void (*add_f32)(float* dst, const float* x, const float* y, size_t n);
+    // returns sum(src[i]); summation order (and so rounding) differs per ISA
+    float (*sum_f32)(const float* src, size_t n);
+
+    // Byte copy/fill behind simd_memcpy/simd_memset (memops.h). Streaming
+    // stores are used when n >= nt_threshold.
+    void (*copy_bytes)(void* dst, const void* src, size_t n, size_t nt_threshold);
+    void (*fill_bytes)(void* dst, int value, size_t n, size_t nt_threshold);
+
+    // Stream compaction behind simd::filter (filter.h).
+    size_t (*filter_f32)(const float* src, size_t n, CmpOp op, float value, float* dst);
+    size_t (*filter_i32)(const int32_t* src, size_t n, CmpOp op, int32_t value, int32_t* dst);
+    size_t (*filter_i64)(const int64_t* src, size_t n, CmpOp op, int64_t value, int64_t* dst);
+    size_t (*filter_u8)(const uint8_t* src, size_t n, CmpOp op, uint8_t value, uint8_t* dst);
+
+    // AoS <-> SoA conversion behind simd::deinterleave/interleave
+    // (interleave.h). 32-bit entries serve both int32_t and float.
+    void (*deinterleave_u8)(const uint8_t* aos, size_t n, size_t channels, uint8_t* const* planes);
+    void (*deinterleave_u16)(const uint16_t* aos, size_t n, size_t channels, uint16_t* const* planes);
+    void (*deinterleave_u32)(const uint32_t* aos, size_t n, size_t channels, uint32_t* const* planes);
+    void (*interleave_u8)(const uint8_t* const* planes, size_t n, size_t channels, uint8_t* aos);
+    void (*interleave_u16)(const uint16_t* const* planes, size_t n, size_t channels, uint16_t* aos);
+    void (*interleave_u32)(const uint32_t* const* planes, size_t n, size_t channels, uint32_t* aos);
+
+    // y[r] = sum of a.values[k] * x[a.col_idx[k]] over row r, for the rows
+    // [row_begin, row_end). One thread's share of simd::spmv (spmv.h).
+    void (*spmv_f32)(const CsrMatrix& a, const float* x, float* y, size_t row_begin, size_t row_end);
+
+    // bins[idx[i]] += 1 and dst[idx[i]] += values[i], behind simd::histogram
+    // and simd::scatter_add (histogram.h). Repeated indices are combined.
+    void (*histogram_u32)(const uint32_t* idx, size_t n, uint32_t* bins);
+    void (*scatter_add_f32)(const uint32_t* idx, const float* values, size_t n, float* dst);
+
+    // out[i] = table[idx[i]] and row gathers behind simd::gather and
+    // simd::gather_rows (gather.h). The lookup `distance` positions ahead is
+    // prefetched; 0 disables prefetching.
+    void (*gather_f32)(const float* table, const uint32_t* idx, size_t n, float* out, size_t distance);
+    void (*gather_rows_f32)(const float* table, size_t dim, const uint32_t* idx, size_t n, float* out,
+                            size_t distance);
+
+    // dst[c * dst_stride + r] = src[r * src_stride + c] behind simd::transpose
+    // (transpose.h); serves float and int32_t. Streaming stores are used when
+    // rows * cols * 4 >= nt_threshold and the destination allows them.
+    void (*transpose_u32)(const uint32_t* src, size_t rows, size_t cols, size_t src_stride, uint32_t* dst,
+                          size_t dst_stride, size_t nt_threshold);
+
+    // Scatters in[i] to out[cursor[p]++] for p = bits [shift, shift + bits) of
+    // its low 32 bits, through 64-byte write-combining buffers (8 << bits
+    // words, 64-byte aligned), behind simd::radix_partition (partition.h).
+    // Full lines are streamed when n * 8 >= nt_threshold.
+    void (*radix_partition_u64)(const uint64_t* in, size_t n, unsigned shift, unsigned bits, uint64_t* out,
+                                size_t* cursor, uint64_t* buffers, size_t nt_threshold);
+
+    // Ascending sort of keys, moving values[i] with keys[i] unless values is
+    // null, behind simd::sort and simd::sort_pairs (sort.h). The temporaries
+    // hold n entries (value_tmp only with values). Not stable.
+    void (*sort_i32)(int32_t* keys, uint32_t* values, size_t n, int32_t* key_tmp, uint32_t* value_tmp);
+    void (*sort_i64)(int64_t* keys, uint64_t* values, size_t n, int64_t* key_tmp, uint64_t* value_tmp);
+
+    // Batched probes of the table behind simd::HashMap (hash_map.h), which
+    // match hash_group control bytes at a time; a table only works with the
+    // kernels that built it. find returns the number of keys found. insert
+    // (or, with add, accumulates into) stops before a new key once the
+    // table holds max_size keys, and returns the number of keys it took.
+    size_t hash_group;
+    size_t (*hash_find_u64)(const HashTable& t, const uint64_t* keys, size_t n, uint64_t* values, uint8_t* found);
+    size_t (*hash_insert_u64)(HashTable& t, const uint64_t* keys, const uint64_t* values, size_t n, bool add,
+                              uint8_t* inserted);
+
+    // Batched lower_bound in an Eytzinger-ordered tree of n keys behind
+    // simd::tree_search_gather (tree_search.h): lookups descend in lockstep,
+    // one gather per level.
+    void (*tree_search_u32)(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out);
+
+    // Base64 behind simd::base64_encode/decode and the stream classes
+    // (base64.h). encode turns the n / 3 whole groups of src into 4
+    // characters each; decode turns n characters (n a multiple of 4, no
+    // padding) into n / 4 * 3 bytes and returns false if one is outside the
+    // alphabet.
+    void (*base64_encode)(const uint8_t* src, size_t n, char* dst, Base64 alphabet);
+    bool (*base64_decode)(const char* src, size_t n, uint8_t* dst, Base64 alphabet);
+
+    // UTF-8 behind simd::utf8_validate, utf8_to_utf16, utf16_to_utf8 and the
+    // stream classes (utf8.h), on whole inputs: a character cut off by the
+    // end is invalid.
+    bool (*utf8_validate)(const char* src, size_t n);
+    bool (*utf8_to_utf16)(const char* src, size_t n, char16_t* dst, size_t* written);
+    bool (*utf16_to_utf8)(const char16_t* src, size_t n, char* dst, size_t* written);
+
+    // JSON stage 1 behind simd::json_index and JsonIndexer (json_index.h):
+    // writes offset + the position of each structural byte of src[0, n), at
+    // most n of them, and returns the count. state carries strings, escapes
+    // and values across calls, so n need not be a multiple of anything.
+    size_t (*json_index)(const char* src, size_t n, uint32_t offset, JsonIndexState* state, uint32_t* out);
+
+    // Checksums behind simd::crc32c, adler32, hash64 and Hash64
+    // (checksum.h), each updating the value so far. Unless dst is null, src
+    // is also copied there in the same pass, with streaming stores when
+    // n >= nt_threshold and dst is aligned to the vector. hash64_stripes adds
+    // whole 64-byte stripes to the 8 lanes of a hash; the first is at
+    // position first (0..15) of its block.
+    uint32_t (*crc32c)(const uint8_t* src, size_t n, uint32_t crc, uint8_t* dst, size_t nt_threshold);
+    uint32_t (*adler32)(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst, size_t nt_threshold);
+    void (*hash64_stripes)(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes, size_t first,
+                           uint8_t* dst, size_t nt_threshold);
+};
+
+// Highest level supported by this CPU and OS. The environment variable
+// SIMD_ISA (scalar, sse41, avx, avx2, avx512) caps the choice, which is handy
+// to exercise the lower paths on a modern machine.
+Isa detect_isa();
+
+// Table for the detected level, resolved on first use and cached.
+const KernelTable& kernels();
+
+// Table for a specific level. Calling its kernels on a CPU that lacks the
+// level is undefined; meant for benchmarks and cross-checking.
+const KernelTable& kernels_for(Isa isa);
+
+} // namespace simd
+
+#endif // SIMD_DISPATCH_H
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include "cpu_features.h"
+#include "dispatch.h"
+
+// Helper to print a C-style array
+template<typename T>
+void print_array(const char* title, const T* data, int size) {
+    std::cout << title;
+    for (int i = 0; i < size; ++i) {
+        std::cout << data[i] << (i == size - 1 ? "" : ", ");
+    }
+    std::cout << std::endl;
+}
+
+// Runs every kernel of `t` on a length that is not a multiple of any vector
+// width and compares against the scalar table.
+bool check_table(const simd::KernelTable& t) {
+    const simd::KernelTable& ref = simd::kernels_for(simd::Isa::Scalar);
+    const size_t n = 1003;
+    std::vector<float> x(n), y(n), out(n), expect(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = 0.5f * (float)i;
+        y[i] = 1000.0f - (float)i;
+    }
+
+    bool ok = true;
+    t.copy_f32(out.data(), x.data(), n);
+    ok &= out == x;
+
+    t.scale_f32(out.data(), x.data(), 3.0f, n);
+    ref.scale_f32(expect.data(), x.data(), 3.0f, n);
+    ok &= out == expect;
+
+    t.add_f32(out.data(), x.data(), y.data(), n);
+    ref.add_f32(expect.data(), x.data(), y.data(), n);
+    ok &= out == expect;
+
+    // Different summation orders round differently; compare with a tolerance.
+    float sum = t.sum_f32(x.data(), n);
+    float sum_ref = ref.sum_f32(x.data(), n);
+    ok &= std::fabs(sum - sum_ref) <= 1e-5f * std::fabs(sum_ref);
+
+    // Short arrays end in a masked tail: every length up to 40, and nothing
+    // past dst + len may change.
+    for (size_t len = 0; len <= 40; ++len) {
+        std::vector<float> o(len + 16, -1.0f), e(len + 16, -1.0f);
+        t.copy_f32(o.data(), x.data(), len);
+        std::copy(x.begin(), x.begin() + len, e.begin());
+        ok &= o == e;
+        t.scale_f32(o.data(), x.data(), 3.0f, len);
+        ref.scale_f32(e.data(), x.data(), 3.0f, len);
+        ok &= o == e;
+        t.add_f32(o.data(), x.data(), y.data(), len);
+        ref.add_f32(e.data(), x.data(), y.data(), len);
+        ok &= o == e;
+        // Halves of small integers: exact in any summation order.
+        ok &= t.sum_f32(x.data(), len) == ref.sum_f32(x.data(), len);
+    }
+    return ok;
+}
+
+int main() {
+    std::cout << "--- Runtime ISA Dispatch Tutorial ---" << std::endl;
+
+    // =================================================================
+    // 1. Feature Detection (CPUID + XGETBV)
+    // =================================================================
+    std::cout << std::endl << "[1. Feature Detection]" << std::endl;
+    const simd::CpuFeatures& f = simd::cpu_features();
+    std::cout << "sse4.1: " << f.sse41 << "  sse4.2: " << f.sse42 << "  popcnt: " << f.popcnt << std::endl;
+    std::cout << "avx:    " << f.avx << "  avx2:   " << f.avx2 << "  fma:    " << f.fma
+              << "  bmi2: " << f.bmi2 << std::endl;
+    std::cout << "avx512f: " << f.avx512f << "  cd: " << f.avx512cd << "  bw: " << f.avx512bw
+              << "  dq: " << f.avx512dq << "  vl: " << f.avx512vl << "  vbmi: " << f.avx512vbmi << std::endl;
+
+    // =================================================================
+    // 2. Resolved Kernel Table
+    // =================================================================
+    std::cout << std::endl << "[2. Resolved Kernel Table]" << std::endl;
+    // kernels() is resolved once; afterwards every call is one indirect jump.
+    const simd::KernelTable& k = simd::kernels();
+    std::cout << "Selected ISA: " << simd::isa_name(k.isa)
+              << " (set SIMD_ISA=scalar|sse41|avx|avx2|avx512 to cap it)" << std::endl;
+
+    alignas(64) float a[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    alignas(64) float b[10];
+    k.scale_f32(b, a, 2.0f, 10);
+    print_array("scale_f32(a, 2): ", b, 10);
+    k.add_f32(b, a, b, 10);
+    print_array("add_f32(a, b):   ", b, 10);
+    std::cout << "sum_f32(a):      " << k.sum_f32(a, 10) << std::endl;
+
+    // =================================================================
+    // 3. Cross-check Every Supported Level
+    // =================================================================
+    std::cout << std::endl << "[3. Cross-check Every Supported Level]" << std::endl;
+    static const simd::Isa levels[] = {simd::Isa::Scalar, simd::Isa::SSE41, simd::Isa::AVX,
+                                       simd::Isa::AVX2, simd::Isa::AVX512};
+    bool all_ok = true;
+    for (simd::Isa isa : levels) {
+        if (isa > k.isa) break;
+        bool ok = check_table(simd::kernels_for(isa));
+        all_ok &= ok;
+        std::cout << simd::isa_name(isa) << ": " << (ok ? "OK" : "MISMATCH") << std::endl;
+    }
+
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,22 @@
+#include "filter.h"
+#include "dispatch.h"
+
+namespace simd {
+
+size_t filter(const float* src, size_t n, Predicate<float> pred, float* dst) {
+    return kernels().filter_f32(src, n, pred.op, pred.value, dst);
+}
+
+size_t filter(const int32_t* src, size_t n, Predicate<int32_t> pred, int32_t* dst) {
+    return kernels().filter_i32(src, n, pred.op, pred.value, dst);
+}
+
+size_t filter(const int64_t* src, size_t n, Predicate<int64_t> pred, int64_t* dst) {
+    return kernels().filter_i64(src, n, pred.op, pred.value, dst);
+}
+
+size_t filter(const uint8_t* src, size_t n, Predicate<uint8_t> pred, uint8_t* dst) {
+    return kernels().filter_u8(src, n, pred.op, pred.value, dst);
+}
+
+} // namespace simd
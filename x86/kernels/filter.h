@@ -0,0 +1,32 @@
+#ifndef SIMD_FILTER_H
+#define SIMD_FILTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+// Comparison applied as `src[i] <op> value`. Floating-point comparisons follow
+// C++ semantics: every op except NE is false when either side is NaN.
+enum class CmpOp { EQ, NE, LT, LE, GT, GE };
+
+template <typename T>
+struct Predicate {
+    CmpOp op;
+    T value;
+};
+
+// Stream compaction: copies every src[i] that satisfies `pred` to dst, keeping
+// their order, and returns how many were written.
+//
+// dst must have room for n elements even if fewer are selected: the vector
+// kernels write whole vectors and let the next iteration overwrite the unused
+// lanes. src and dst must not overlap.
+size_t filter(const float* src, size_t n, Predicate<float> pred, float* dst);
+size_t filter(const int32_t* src, size_t n, Predicate<int32_t> pred, int32_t* dst);
+size_t filter(const int64_t* src, size_t n, Predicate<int64_t> pred, int64_t* dst);
+size_t filter(const uint8_t* src, size_t n, Predicate<uint8_t> pred, uint8_t* dst);
+
+} // namespace simd
+
+#endif // SIMD_FILTER_H
@@ -0,0 +1,179 @@
+#include "kernels_internal.h"
+#include "filter_internal.h"
+#include "safe_load.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx2 {
+
+// AVX2 has no compress instruction. Each comparison result is turned into a
+// bitmask with movemask, and the bitmask indexes a table of permutations that
+// move the selected lanes to the front (kLeftPack8). The whole permuted vector
+// is stored; the lanes past the popcount are garbage that the next store
+// overwrites, which is why dst needs room for n elements.
+
+namespace {
+
+// Per-op masks. AVX2 only has EQ and signed GT for integers; the other
+// orderings are derived by swapping operands or inverting the mask.
+template <CmpOp Op>
+inline unsigned cmp_mask_f32(__m256 x, __m256 v) {
+    switch (Op) {
+        case CmpOp::EQ: return _mm256_movemask_ps(_mm256_cmp_ps(x, v, _CMP_EQ_OQ));
+        case CmpOp::NE: return _mm256_movemask_ps(_mm256_cmp_ps(x, v, _CMP_NEQ_UQ));
+        case CmpOp::LT: return _mm256_movemask_ps(_mm256_cmp_ps(x, v, _CMP_LT_OQ));
+        case CmpOp::LE: return _mm256_movemask_ps(_mm256_cmp_ps(x, v, _CMP_LE_OQ));
+        case CmpOp::GT: return _mm256_movemask_ps(_mm256_cmp_ps(x, v, _CMP_GT_OQ));
+        case CmpOp::GE: return _mm256_movemask_ps(_mm256_cmp_ps(x, v, _CMP_GE_OQ));
+    }
+    return 0;
+}
+
+template <CmpOp Op>
+inline unsigned cmp_mask_i32(__m256i x, __m256i v) {
+    switch (Op) {
+        case CmpOp::EQ: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, v)));
+        case CmpOp::NE: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, v))) ^ 0xFF;
+        case CmpOp::LT: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, x)));
+        case CmpOp::LE: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, v))) ^ 0xFF;
+        case CmpOp::GT: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, v)));
+        case CmpOp::GE: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, x))) ^ 0xFF;
+    }
+    return 0;
+}
+
+template <CmpOp Op>
+inline unsigned cmp_mask_i64(__m256i x, __m256i v) {
+    switch (Op) {
+        case CmpOp::EQ: return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(x, v)));
+        case CmpOp::NE: return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(x, v))) ^ 0xF;
+        case CmpOp::LT: return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(v, x)));
+        case CmpOp::LE: return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(x, v))) ^ 0xF;
+        case CmpOp::GT: return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(x, v)));
+        case CmpOp::GE: return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(v, x))) ^ 0xF;
+    }
+    return 0;
+}
+
+// Unsigned byte ordering via min/max: x >= v  <=>  max(x, v) == x.
+template <CmpOp Op>
+inline uint32_t cmp_mask_u8(__m256i x, __m256i v) {
+    switch (Op) {
+        case CmpOp::EQ: return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, v));
+        case CmpOp::NE: return ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, v));
+        case CmpOp::LT: return ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(x, v), x));
+        case CmpOp::LE: return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(x, v), x));
+        case CmpOp::GT: return ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(x, v), x));
+        case CmpOp::GE: return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(x, v), x));
+    }
+    return 0;
+}
+
+inline __m256i left_pack_perm8(unsigned m) {
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)&kLeftPack8[m]));
+}
+
+template <CmpOp Op>
+size_t filter_f32_loop(const float* src, size_t n, float value, float* dst) {
+    const __m256 v = _mm256_set1_ps(value);
+    size_t i = 0, k = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(src + i);
+        unsigned m = cmp_mask_f32<Op>(x, v);
+        _mm256_storeu_ps(dst + k, _mm256_permutevar8x32_ps(x, left_pack_perm8(m)));
+        k += _mm_popcnt_u32(m);
+    }
+    return k + filter_scalar_loop<Op>(src + i, n - i, value, dst + k);
+}
+
+template <CmpOp Op>
+size_t filter_i32_loop(const int32_t* src, size_t n, int32_t value, int32_t* dst) {
+    const __m256i v = _mm256_set1_epi32(value);
+    size_t i = 0, k = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(src + i));
+        unsigned m = cmp_mask_i32<Op>(x, v);
+        _mm256_storeu_si256((__m256i*)(dst + k), _mm256_permutevar8x32_epi32(x, left_pack_perm8(m)));
+        k += _mm_popcnt_u32(m);
+    }
+    return k + filter_scalar_loop<Op>(src + i, n - i, value, dst + k);
+}
+
+template <CmpOp Op>
+size_t filter_i64_loop(const int64_t* src, size_t n, int64_t value, int64_t* dst) {
+    const __m256i v = _mm256_set1_epi64x(value);
+    size_t i = 0, k = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(src + i));
+        unsigned m = cmp_mask_i64<Op>(x, v);
+        __m256i perm = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)&kLeftPack4x64[m]));
+        _mm256_storeu_si256((__m256i*)(dst + k), _mm256_permutevar8x32_epi32(x, perm));
+        k += _mm_popcnt_u32(m);
+    }
+    return k + filter_scalar_loop<Op>(src + i, n - i, value, dst + k);
+}
+
+// Bytes are compared 32 at a time but packed 8 at a time: the same table is a
+// valid pshufb control for one 8-byte group.
+template <CmpOp Op>
+size_t filter_u8_loop(const uint8_t* src, size_t n, uint8_t value, uint8_t* dst) {
+    const __m256i v = _mm256_set1_epi8((char)value);
+    size_t i = 0, k = 0;
+    for (; i + 32 <= n; i += 32) {
+        uint32_t m = cmp_mask_u8<Op>(_mm256_loadu_si256((const __m256i*)(src + i)), v);
+        for (int j = 0; j < 4; ++j) {
+            unsigned mj = (m >> (8 * j)) & 0xFF;
+            __m128i bytes = _mm_loadl_epi64((const __m128i*)(src + i + 8 * j));
+            __m128i ctrl = _mm_loadl_epi64((const __m128i*)&kLeftPack8[mj]);
+            _mm_storel_epi64((__m128i*)(dst + k), _mm_shuffle_epi8(bytes, ctrl));
+            k += _mm_popcnt_u32(mj);
+        }
+    }
+    if (i < n) {
+        // The tail is one vector from load_tail_256, packed from a copy so no
+        // load reads past src + n. A group's 8-byte store could pass dst + n
+        // only in the last groups; those copy their matches byte by byte.
+        size_t r = n - i;
+        __m256i x = load_tail_256(src + i, r);
+        uint32_t m = cmp_mask_u8<Op>(x, v) & _bzhi_u32(~0u, (unsigned)r);
+        alignas(32) uint8_t bytes[32];
+        _mm256_store_si256((__m256i*)bytes, x);
+        for (size_t j = 0; 8 * j < r; ++j) {
+            unsigned mj = (m >> (8 * j)) & 0xFF;
+            __m128i ctrl = _mm_loadl_epi64((const __m128i*)&kLeftPack8[mj]);
+            __m128i packed = _mm_shuffle_epi8(_mm_loadl_epi64((const __m128i*)(bytes + 8 * j)), ctrl);
+            unsigned count = _mm_popcnt_u32(mj);
+            if (k + 8 <= n) {
+                _mm_storel_epi64((__m128i*)(dst + k), packed);
+            } else {
+                alignas(16) uint8_t out[16];
+                _mm_store_si128((__m128i*)out, packed);
+                for (unsigned b = 0; b < count; ++b) dst[k + b] = out[b];
+            }
+            k += count;
+        }
+    }
+    return k;
+}
+
+} // namespace
+
+size_t filter_f32(const float* src, size_t n, CmpOp op, float value, float* dst) {
+    SIMD_FILTER_SWITCH(filter_f32_loop, src, n, op, value, dst);
+}
+
+size_t filter_i32(const int32_t* src, size_t n, CmpOp op, int32_t value, int32_t* dst) {
+    SIMD_FILTER_SWITCH(filter_i32_loop, src, n, op, value, dst);
+}
+
+size_t filter_i64(const int64_t* src, size_t n, CmpOp op, int64_t value, int64_t* dst) {
+    SIMD_FILTER_SWITCH(filter_i64_loop, src, n, op, value, dst);
+}
+
+size_t filter_u8(const uint8_t* src, size_t n, CmpOp op, uint8_t value, uint8_t* dst) {
+    SIMD_FILTER_SWITCH(filter_u8_loop, src, n, op, value, dst);
+}
+
+} // namespace avx2
+} // namespace simd
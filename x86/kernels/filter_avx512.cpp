@@ -0,0 +1,147 @@
+#include "kernels_internal.h"
+#include "filter_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512 {
+
+// AVX-512 compares straight into a mask register, and vcompress packs the
+// selected lanes. The main loop compresses into a register and writes the full
+// vector (dst has room for n elements): vcompress with a memory destination is
+// several times slower on current cores, so compress-store is only used for
+// the final partial vector, where it must not write past the end.
+
+namespace {
+
+template <CmpOp Op>
+inline __mmask16 cmp_f32(__mmask16 k, __m512 x, __m512 v) {
+    switch (Op) {
+        case CmpOp::EQ: return _mm512_mask_cmp_ps_mask(k, x, v, _CMP_EQ_OQ);
+        case CmpOp::NE: return _mm512_mask_cmp_ps_mask(k, x, v, _CMP_NEQ_UQ);
+        case CmpOp::LT: return _mm512_mask_cmp_ps_mask(k, x, v, _CMP_LT_OQ);
+        case CmpOp::LE: return _mm512_mask_cmp_ps_mask(k, x, v, _CMP_LE_OQ);
+        case CmpOp::GT: return _mm512_mask_cmp_ps_mask(k, x, v, _CMP_GT_OQ);
+        case CmpOp::GE: return _mm512_mask_cmp_ps_mask(k, x, v, _CMP_GE_OQ);
+    }
+    return 0;
+}
+
+template <CmpOp Op>
+size_t filter_f32_loop(const float* src, size_t n, float value, float* dst) {
+    const __m512 v = _mm512_set1_ps(value);
+    size_t i = 0, k = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 x = _mm512_loadu_ps(src + i);
+        __mmask16 m = cmp_f32<Op>(0xFFFF, x, v);
+        _mm512_storeu_ps(dst + k, _mm512_maskz_compress_ps(m, x));
+        k += _mm_popcnt_u32(m);
+    }
+    if (i < n) {
+        __mmask16 tail = (__mmask16)_bzhi_u32(0xFFFF, (unsigned)(n - i));
+        __m512 x = _mm512_maskz_loadu_ps(tail, src + i);
+        __mmask16 m = cmp_f32<Op>(tail, x, v);
+        _mm512_mask_compressstoreu_ps(dst + k, m, x);
+        k += _mm_popcnt_u32(m);
+    }
+    return k;
+}
+
+template <CmpOp Op>
+size_t filter_i32_loop(const int32_t* src, size_t n, int32_t value, int32_t* dst) {
+    const __m512i v = _mm512_set1_epi32(value);
+    size_t i = 0, k = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i x = _mm512_loadu_si512((const void*)(src + i));
+        __mmask16 m = _mm512_cmp_epi32_mask(x, v, IntCmp<Op>::value);
+        _mm512_storeu_si512((void*)(dst + k), _mm512_maskz_compress_epi32(m, x));
+        k += _mm_popcnt_u32(m);
+    }
+    if (i < n) {
+        __mmask16 tail = (__mmask16)_bzhi_u32(0xFFFF, (unsigned)(n - i));
+        __m512i x = _mm512_maskz_loadu_epi32(tail, src + i);
+        __mmask16 m = _mm512_mask_cmp_epi32_mask(tail, x, v, IntCmp<Op>::value);
+        _mm512_mask_compressstoreu_epi32(dst + k, m, x);
+        k += _mm_popcnt_u32(m);
+    }
+    return k;
+}
+
+template <CmpOp Op>
+size_t filter_i64_loop(const int64_t* src, size_t n, int64_t value, int64_t* dst) {
+    const __m512i v = _mm512_set1_epi64(value);
+    size_t i = 0, k = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i x = _mm512_loadu_si512((const void*)(src + i));
+        __mmask8 m = _mm512_cmp_epi64_mask(x, v, IntCmp<Op>::value);
+        _mm512_storeu_si512((void*)(dst + k), _mm512_maskz_compress_epi64(m, x));
+        k += _mm_popcnt_u32(m);
+    }
+    if (i < n) {
+        __mmask8 tail = (__mmask8)_bzhi_u32(0xFF, (unsigned)(n - i));
+        __m512i x = _mm512_maskz_loadu_epi64(tail, src + i);
+        __mmask8 m = _mm512_mask_cmp_epi64_mask(tail, x, v, IntCmp<Op>::value);
+        _mm512_mask_compressstoreu_epi64(dst + k, m, x);
+        k += _mm_popcnt_u32(m);
+    }
+    return k;
+}
+
+// Byte compress needs VBMI2 (see filter_avx512icl.cpp). Without it, each
+// 16-byte quarter is widened to 32-bit lanes, compressed with vpcompressd and
+// narrowed back with vpmovdb.
+template <bool kTail>
+inline size_t pack_u8_quarter(__m128i bytes, __mmask16 m, uint8_t* dst) {
+    __m512i packed = _mm512_maskz_compress_epi32(m, _mm512_cvtepu8_epi32(bytes));
+    unsigned count = _mm_popcnt_u32(m);
+    if (kTail) _mm512_mask_cvtepi32_storeu_epi8(dst, (__mmask16)_bzhi_u32(0xFFFF, count), packed);
+    else       _mm_storeu_si128((__m128i*)dst, _mm512_cvtepi32_epi8(packed));
+    return count;
+}
+
+template <bool kTail>
+inline size_t pack_u8_block(__m512i x, __mmask64 m, uint8_t* dst) {
+    size_t k = 0;
+    k += pack_u8_quarter<kTail>(_mm512_extracti32x4_epi32(x, 0), (__mmask16)(m), dst + k);
+    k += pack_u8_quarter<kTail>(_mm512_extracti32x4_epi32(x, 1), (__mmask16)(m >> 16), dst + k);
+    k += pack_u8_quarter<kTail>(_mm512_extracti32x4_epi32(x, 2), (__mmask16)(m >> 32), dst + k);
+    k += pack_u8_quarter<kTail>(_mm512_extracti32x4_epi32(x, 3), (__mmask16)(m >> 48), dst + k);
+    return k;
+}
+
+template <CmpOp Op>
+size_t filter_u8_loop(const uint8_t* src, size_t n, uint8_t value, uint8_t* dst) {
+    const __m512i v = _mm512_set1_epi8((char)value);
+    size_t i = 0, k = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m512i x = _mm512_loadu_si512((const void*)(src + i));
+        k += pack_u8_block<false>(x, _mm512_cmp_epu8_mask(x, v, IntCmp<Op>::value), dst + k);
+    }
+    if (i < n) {
+        __mmask64 tail = _bzhi_u64(~0ull, (unsigned)(n - i));
+        __m512i x = _mm512_maskz_loadu_epi8(tail, src + i);
+        k += pack_u8_block<true>(x, _mm512_mask_cmp_epu8_mask(tail, x, v, IntCmp<Op>::value), dst + k);
+    }
+    return k;
+}
+
+} // namespace
+
+size_t filter_f32(const float* src, size_t n, CmpOp op, float value, float* dst) {
+    SIMD_FILTER_SWITCH(filter_f32_loop, src, n, op, value, dst);
+}
+
+size_t filter_i32(const int32_t* src, size_t n, CmpOp op, int32_t value, int32_t* dst) {
+    SIMD_FILTER_SWITCH(filter_i32_loop, src, n, op, value, dst);
+}
+
+size_t filter_i64(const int64_t* src, size_t n, CmpOp op, int64_t value, int64_t* dst) {
+    SIMD_FILTER_SWITCH(filter_i64_loop, src, n, op, value, dst);
+}
+
+size_t filter_u8(const uint8_t* src, size_t n, CmpOp op, uint8_t value, uint8_t* dst) {
+    SIMD_FILTER_SWITCH(filter_u8_loop, src, n, op, value, dst);
+}
+
+} // namespace avx512
+} // namespace simd
@@ -0,0 +1,40 @@
+#include "kernels_internal.h"
+#include "filter_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512icl {
+
+// Ice Lake adds VBMI2, whose vpcompressb packs 64 bytes in one instruction.
+
+namespace {
+
+template <CmpOp Op>
+size_t filter_u8_loop(const uint8_t* src, size_t n, uint8_t value, uint8_t* dst) {
+    const __m512i v = _mm512_set1_epi8((char)value);
+    size_t i = 0, k = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m512i x = _mm512_loadu_si512((const void*)(src + i));
+        __mmask64 m = _mm512_cmp_epu8_mask(x, v, IntCmp<Op>::value);
+        _mm512_storeu_si512((void*)(dst + k), _mm512_maskz_compress_epi8(m, x));
+        k += _mm_popcnt_u64(m);
+    }
+    if (i < n) {
+        __mmask64 tail = _bzhi_u64(~0ull, (unsigned)(n - i));
+        __m512i x = _mm512_maskz_loadu_epi8(tail, src + i);
+        __mmask64 m = _mm512_mask_cmp_epu8_mask(tail, x, v, IntCmp<Op>::value);
+        _mm512_mask_compressstoreu_epi8(dst + k, m, x);
+        k += _mm_popcnt_u64(m);
+    }
+    return k;
+}
+
+} // namespace
+
+size_t filter_u8(const uint8_t* src, size_t n, CmpOp op, uint8_t value, uint8_t* dst) {
+    SIMD_FILTER_SWITCH(filter_u8_loop, src, n, op, value, dst);
+}
+
+} // namespace avx512icl
+} // namespace simd
@@ -0,0 +1,125 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <limits>
+#include "dispatch.h"
+#include "filter.h"
+
+// Helper to print a C-style array
+template<typename T>
+void print_array(const char* title, const T* data, int size) {
+    std::cout << title;
+    for (int i = 0; i < size; ++i) {
+        std::cout << +data[i] << (i == size - 1 ? "" : ", ");
+    }
+    std::cout << std::endl;
+}
+
+static const simd::CmpOp kOps[] = {simd::CmpOp::EQ, simd::CmpOp::NE, simd::CmpOp::LT,
+                                   simd::CmpOp::LE, simd::CmpOp::GT, simd::CmpOp::GE};
+
+// Compares one kernel against the scalar one for every op and every length up
+// to 300 (all tail sizes of every vector width).
+template <typename T, typename Kernel>
+bool check_kernel(Kernel kernel, Kernel reference, const std::vector<T>& src, T value) {
+    std::vector<T> out(src.size()), expect(src.size());
+    for (simd::CmpOp op : kOps) {
+        for (size_t n = 0; n <= 300; ++n) {
+            size_t got = kernel(src.data(), n, op, value, out.data());
+            size_t want = reference(src.data(), n, op, value, expect.data());
+            if (got != want) return false;
+            for (size_t i = 0; i < got; ++i) {
+                if (!(out[i] == expect[i]) && !(out[i] != out[i] && expect[i] != expect[i])) return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool check_table(const simd::KernelTable& t) {
+    const simd::KernelTable& ref = simd::kernels_for(simd::Isa::Scalar);
+    std::mt19937 rng(42);
+    std::vector<float> f32(301);
+    std::vector<int32_t> i32(301);
+    std::vector<int64_t> i64(301);
+    std::vector<uint8_t> u8(301);
+    for (size_t i = 0; i < f32.size(); ++i) {
+        f32[i] = (float)(rng() % 20) - 10.0f;
+        i32[i] = (int32_t)(rng() % 20) - 10;
+        i64[i] = ((int64_t)(rng() % 20) - 10) << 33;
+        u8[i] = (uint8_t)(rng() % 20 + 118); // straddles 128: catches signed byte compares
+    }
+    f32[7] = std::numeric_limits<float>::quiet_NaN();
+
+    bool ok = true;
+    ok &= check_kernel(t.filter_f32, ref.filter_f32, f32, 0.0f);
+    ok &= check_kernel(t.filter_i32, ref.filter_i32, i32, (int32_t)-3);
+    ok &= check_kernel(t.filter_i64, ref.filter_i64, i64, (int64_t)3 << 33);
+    ok &= check_kernel(t.filter_u8, ref.filter_u8, u8, (uint8_t)128);
+    return ok;
+}
+
+double filter_mrows(const simd::KernelTable& t, const std::vector<float>& src, std::vector<float>& dst) {
+    const int reps = 10;
+    size_t kept = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        kept += t.filter_f32(src.data(), src.size(), simd::CmpOp::LT, 0.5f, dst.data());
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (kept == 0) std::cout << "(nothing selected)" << std::endl;
+    return src.size() * reps / sec / 1e6;
+}
+
+int main() {
+    std::cout << "--- Stream Compaction (filter) ---" << std::endl;
+
+    // =================================================================
+    // 1. Usage
+    // =================================================================
+    std::cout << std::endl << "[1. Usage]" << std::endl;
+    float prices[20] = {3.5f, 12.f, 7.25f, 0.5f, 19.f, 8.f, 11.f, 2.f, 15.5f, 9.f,
+                        1.f, 14.f, 6.f, 13.f, 10.f, 4.f, 18.f, 5.f, 16.f, 17.f};
+    float selected[20];
+    size_t count = simd::filter(prices, 20, simd::Predicate<float>{simd::CmpOp::GE, 10.f}, selected);
+    print_array("prices:          ", prices, 20);
+    print_array("prices >= 10:    ", selected, (int)count);
+
+    uint8_t bytes[40];
+    uint8_t kept[40];
+    for (int i = 0; i < 40; ++i) bytes[i] = (uint8_t)(i * 37);
+    count = simd::filter(bytes, 40, simd::Predicate<uint8_t>{simd::CmpOp::LT, 64}, kept);
+    print_array("bytes < 64:      ", kept, (int)count);
+
+    // =================================================================
+    // 2. Cross-check Every Supported Level
+    // =================================================================
+    std::cout << std::endl << "[2. Cross-check Every Supported Level]" << std::endl;
+    static const simd::Isa levels[] = {simd::Isa::Scalar, simd::Isa::SSE41, simd::Isa::AVX,
+                                       simd::Isa::AVX2, simd::Isa::AVX512};
+    bool all_ok = true;
+    for (simd::Isa isa : levels) {
+        if (isa > simd::kernels().isa) break;
+        bool ok = check_table(simd::kernels_for(isa));
+        all_ok &= ok;
+        std::cout << simd::isa_name(isa) << ": " << (ok ? "OK" : "MISMATCH") << std::endl;
+    }
+
+    // =================================================================
+    // 3. Throughput at 50% Selectivity (the worst case for branches)
+    // =================================================================
+    std::cout << std::endl << "[3. Throughput, 50% selectivity]" << std::endl;
+    std::vector<float> src(1 << 22), dst(src.size());
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    for (float& x : src) x = uniform(rng);
+    for (simd::Isa isa : levels) {
+        if (isa > simd::kernels().isa) break;
+        std::cout << simd::isa_name(isa) << ": "
+                  << filter_mrows(simd::kernels_for(isa), src, dst) << " M rows/s" << std::endl;
+    }
+
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+#ifndef SIMD_FILTER_INTERNAL_H
+#define SIMD_FILTER_INTERNAL_H
+
+// Helpers shared by the per-ISA filter kernels. Everything has internal
+// linkage so each translation unit compiles its own copy with its own flags.
+
+#include <cstdint>
+#include <immintrin.h>
+#include "filter.h"
+
+namespace simd {
+
+namespace {
+
+template <CmpOp Op, typename T>
+inline bool compare(T a, T b) {
+    switch (Op) {
+        case CmpOp::EQ: return a == b;
+        case CmpOp::NE: return a != b;
+        case CmpOp::LT: return a < b;
+        case CmpOp::LE: return a <= b;
+        case CmpOp::GT: return a > b;
+        case CmpOp::GE: return a >= b;
+    }
+    return false;
+}
+
+// Branch-free scalar compaction: always write, advance only on a match.
+// Used for the scalar level and for the tails of the vector kernels.
+template <CmpOp Op, typename T>
+inline size_t filter_scalar_loop(const T* src, size_t n, T value, T* dst) {
+    size_t k = 0;
+    for (size_t i = 0; i < n; ++i) {
+        T x = src[i];
+        dst[k] = x;
+        k += compare<Op>(x, value);
+    }
+    return k;
+}
+
+#ifdef __AVX512F__
+// AVX-512 integer compare predicate for each op. NLE is "greater than",
+// NLT is "greater or equal".
+template <CmpOp Op> struct IntCmp;
+template <> struct IntCmp<CmpOp::EQ> { static const int value = _MM_CMPINT_EQ; };
+template <> struct IntCmp<CmpOp::NE> { static const int value = _MM_CMPINT_NE; };
+template <> struct IntCmp<CmpOp::LT> { static const int value = _MM_CMPINT_LT; };
+template <> struct IntCmp<CmpOp::LE> { static const int value = _MM_CMPINT_LE; };
+template <> struct IntCmp<CmpOp::GT> { static const int value = _MM_CMPINT_NLE; };
+template <> struct IntCmp<CmpOp::GE> { static const int value = _MM_CMPINT_NLT; };
+#endif
+
+// Expands to a switch that instantiates `loop<Op>(src, n, value, dst)` for
+// the runtime op, so the comparison is a compile-time constant in the loop.
+#define SIMD_FILTER_SWITCH(loop, src, n, op, value, dst)                         \
+    switch (op) {                                                                \
+        case CmpOp::EQ: return loop<CmpOp::EQ>(src, n, value, dst);              \
+        case CmpOp::NE: return loop<CmpOp::NE>(src, n, value, dst);              \
+        case CmpOp::LT: return loop<CmpOp::LT>(src, n, value, dst);              \
+        case CmpOp::LE: return loop<CmpOp::LE>(src, n, value, dst);              \
+        case CmpOp::GT: return loop<CmpOp::GT>(src, n, value, dst);              \
+        case CmpOp::GE: return loop<CmpOp::GE>(src, n, value, dst);              \
+    }                                                                            \
+    return 0
+
+// Left-pack permutations for an 8-lane mask: byte j of kLeftPack8[m] is the
+// index of the j-th set bit of m (unused bytes are 0). Widened with
+// _mm256_cvtepu8_epi32 it drives vpermps/vpermd; used as-is it is a pshufb
+// control for 8 bytes.
+alignas(64) static const uint64_t kLeftPack8[256] = {
+    0x0000000000000000ull, 0x0000000000000000ull, 0x0000000000000001ull, 0x0000000000000100ull,
+    0x0000000000000002ull, 0x0000000000000200ull, 0x0000000000000201ull, 0x0000000000020100ull,
+    0x0000000000000003ull, 0x0000000000000300ull, 0x0000000000000301ull, 0x0000000000030100ull,
+    0x0000000000000302ull, 0x0000000000030200ull, 0x0000000000030201ull, 0x0000000003020100ull,
+    0x0000000000000004ull, 0x0000000000000400ull, 0x0000000000000401ull, 0x0000000000040100ull,
+    0x0000000000000402ull, 0x0000000000040200ull, 0x0000000000040201ull, 0x0000000004020100ull,
+    0x0000000000000403ull, 0x0000000000040300ull, 0x0000000000040301ull, 0x0000000004030100ull,
+    0x0000000000040302ull, 0x0000000004030200ull, 0x0000000004030201ull, 0x0000000403020100ull,
+    0x0000000000000005ull, 0x0000000000000500ull, 0x0000000000000501ull, 0x0000000000050100ull,
+    0x0000000000000502ull, 0x0000000000050200ull, 0x0000000000050201ull, 0x0000000005020100ull,
+    0x0000000000000503ull, 0x0000000000050300ull, 0x0000000000050301ull, 0x0000000005030100ull,
+    0x0000000000050302ull, 0x0000000005030200ull, 0x0000000005030201ull, 0x0000000503020100ull,
+    0x0000000000000504ull, 0x0000000000050400ull, 0x0000000000050401ull, 0x0000000005040100ull,
+    0x0000000000050402ull, 0x0000000005040200ull, 0x0000000005040201ull, 0x0000000504020100ull,
+    0x0000000000050403ull, 0x0000000005040300ull, 0x0000000005040301ull, 0x0000000504030100ull,
+    0x0000000005040302ull, 0x0000000504030200ull, 0x0000000504030201ull, 0x0000050403020100ull,
+    0x0000000000000006ull, 0x0000000000000600ull, 0x0000000000000601ull, 0x0000000000060100ull,
+    0x0000000000000602ull, 0x0000000000060200ull, 0x0000000000060201ull, 0x0000000006020100ull,
+    0x0000000000000603ull, 0x0000000000060300ull, 0x0000000000060301ull, 0x0000000006030100ull,
+    0x0000000000060302ull, 0x0000000006030200ull, 0x0000000006030201ull, 0x0000000603020100ull,
+    0x0000000000000604ull, 0x0000000000060400ull, 0x0000000000060401ull, 0x0000000006040100ull,
+    0x0000000000060402ull, 0x0000000006040200ull, 0x0000000006040201ull, 0x0000000604020100ull,
+    0x0000000000060403ull, 0x0000000006040300ull, 0x0000000006040301ull, 0x0000000604030100ull,
+    0x0000000006040302ull, 0x0000000604030200ull, 0x0000000604030201ull, 0x0000060403020100ull,
+    0x0000000000000605ull, 0x0000000000060500ull, 0x0000000000060501ull, 0x0000000006050100ull,
+    0x0000000000060502ull, 0x0000000006050200ull, 0x0000000006050201ull, 0x0000000605020100ull,
+    0x0000000000060503ull, 0x0000000006050300ull, 0x0000000006050301ull, 0x0000000605030100ull,
+    0x0000000006050302ull, 0x0000000605030200ull, 0x0000000605030201ull, 0x0000060503020100ull,
+    0x0000000000060504ull, 0x0000000006050400ull, 0x0000000006050401ull, 0x0000000605040100ull,
+    0x0000000006050402ull, 0x0000000605040200ull, 0x0000000605040201ull, 0x0000060504020100ull,
+    0x0000000006050403ull, 0x0000000605040300ull, 0x0000000605040301ull, 0x0000060504030100ull,
+    0x0000000605040302ull, 0x0000060504030200ull, 0x0000060504030201ull, 0x0006050403020100ull,
+    0x0000000000000007ull, 0x0000000000000700ull, 0x0000000000000701ull, 0x0000000000070100ull,
+    0x0000000000000702ull, 0x0000000000070200ull, 0x0000000000070201ull, 0x0000000007020100ull,
+    0x0000000000000703ull, 0x0000000000070300ull, 0x0000000000070301ull, 0x0000000007030100ull,
+    0x0000000000070302ull, 0x0000000007030200ull, 0x0000000007030201ull, 0x0000000703020100ull,
+    0x0000000000000704ull, 0x0000000000070400ull, 0x0000000000070401ull, 0x0000000007040100ull,
+    0x0000000000070402ull, 0x0000000007040200ull, 0x0000000007040201ull, 0x0000000704020100ull,
+    0x0000000000070403ull, 0x0000000007040300ull, 0x0000000007040301ull, 0x0000000704030100ull,
+    0x0000000007040302ull, 0x0000000704030200ull, 0x0000000704030201ull, 0x0000070403020100ull,
+    0x0000000000000705ull, 0x0000000000070500ull, 0x0000000000070501ull, 0x0000000007050100ull,
+    0x0000000000070502ull, 0x0000000007050200ull, 0x0000000007050201ull, 0x0000000705020100ull,
+    0x0000000000070503ull, 0x0000000007050300ull, 0x0000000007050301ull, 0x0000000705030100ull,
+    0x0000000007050302ull, 0x0000000705030200ull, 0x0000000705030201ull, 0x0000070503020100ull,
+    0x0000000000070504ull, 0x0000000007050400ull, 0x0000000007050401ull, 0x0000000705040100ull,
+    0x0000000007050402ull, 0x0000000705040200ull, 0x0000000705040201ull, 0x0000070504020100ull,
+    0x0000000007050403ull, 0x0000000705040300ull, 0x0000000705040301ull, 0x0000070504030100ull,
+    0x0000000705040302ull, 0x0000070504030200ull, 0x0000070504030201ull, 0x0007050403020100ull,
+    0x0000000000000706ull, 0x0000000000070600ull, 0x0000000000070601ull, 0x0000000007060100ull,
+    0x0000000000070602ull, 0x0000000007060200ull, 0x0000000007060201ull, 0x0000000706020100ull,
+    0x0000000000070603ull, 0x0000000007060300ull, 0x0000000007060301ull, 0x0000000706030100ull,
+    0x0000000007060302ull, 0x0000000706030200ull, 0x0000000706030201ull, 0x0000070603020100ull,
+    0x0000000000070604ull, 0x0000000007060400ull, 0x0000000007060401ull, 0x0000000706040100ull,
+    0x0000000007060402ull, 0x0000000706040200ull, 0x0000000706040201ull, 0x0000070604020100ull,
+    0x0000000007060403ull, 0x0000000706040300ull, 0x0000000706040301ull, 0x0000070604030100ull,
+    0x0000000706040302ull, 0x0000070604030200ull, 0x0000070604030201ull, 0x0007060403020100ull,
+    0x0000000000070605ull, 0x0000000007060500ull, 0x0000000007060501ull, 0x0000000706050100ull,
+    0x0000000007060502ull, 0x0000000706050200ull, 0x0000000706050201ull, 0x0000070605020100ull,
+    0x0000000007060503ull, 0x0000000706050300ull, 0x0000000706050301ull, 0x0000070605030100ull,
+    0x0000000706050302ull, 0x0000070605030200ull, 0x0000070605030201ull, 0x0007060503020100ull,
+    0x0000000007060504ull, 0x0000000706050400ull, 0x0000000706050401ull, 0x0000070605040100ull,
+    0x0000000706050402ull, 0x0000070605040200ull, 0x0000070605040201ull, 0x0007060504020100ull,
+    0x0000000706050403ull, 0x0000070605040300ull, 0x0000070605040301ull, 0x0007060504030100ull,
+    0x0000070605040302ull, 0x0007060504030200ull, 0x0007060504030201ull, 0x0706050403020100ull,
+};
+
+// Same for 4 x 64-bit lanes, expressed as 8 x 32-bit indices for vpermd.
+alignas(64) static const uint64_t kLeftPack4x64[16] = {
+    0x0000000000000000ull, 0x0000000000000100ull, 0x0000000000000302ull, 0x0000000003020100ull,
+    0x0000000000000504ull, 0x0000000005040100ull, 0x0000000005040302ull, 0x0000050403020100ull,
+    0x0000000000000706ull, 0x0000000007060100ull, 0x0000000007060302ull, 0x0000070603020100ull,
+    0x0000000007060504ull, 0x0000070605040100ull, 0x0000070605040302ull, 0x0706050403020100ull,
+};
+
+} // namespace
+
+} // namespace simd
+
+#endif // SIMD_FILTER_INTERNAL_H
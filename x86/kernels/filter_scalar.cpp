@@ -0,0 +1,24 @@
+#include "kernels_internal.h"
+#include "filter_internal.h"
+
+namespace simd {
+namespace scalar {
+
+size_t filter_f32(const float* src, size_t n, CmpOp op, float value, float* dst) {
+    SIMD_FILTER_SWITCH(filter_scalar_loop, src, n, op, value, dst);
+}
+
+size_t filter_i32(const int32_t* src, size_t n, CmpOp op, int32_t value, int32_t* dst) {
+    SIMD_FILTER_SWITCH(filter_scalar_loop, src, n, op, value, dst);
+}
+
+size_t filter_i64(const int64_t* src, size_t n, CmpOp op, int64_t value, int64_t* dst) {
+    SIMD_FILTER_SWITCH(filter_scalar_loop, src, n, op, value, dst);
+}
+
+size_t filter_u8(const uint8_t* src, size_t n, CmpOp op, uint8_t value, uint8_t* dst) {
+    SIMD_FILTER_SWITCH(filter_scalar_loop, src, n, op, value, dst);
+}
+
+} // namespace scalar
+} // namespace simd
@@ -0,0 +1,123 @@
+#include "gather.h"
+#include "arena.h"
+#include "cpu_features.h"
+#include "dispatch.h"
+#include "memops.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+namespace simd {
+
+namespace {
+
+// Candidates for tune_prefetch_distance, in cache lines. A distance must
+// beat no prefetching by kMinGain to be chosen: prefetches cost load slots,
+// and the hardware gather already overlaps the misses of one vector.
+const size_t kDistances[] = {0, 4, 8, 16, 32, 64, 128};
+const size_t kTuneLookups = (size_t)1 << 18;
+const double kMinGain = 1.05;
+const double kTolerance = 1.03;
+
+// n random indices below `entries`, from the xorshift state x.
+void random_indices(uint32_t* idx, size_t n, size_t entries, uint64_t& x) {
+    for (size_t i = 0; i < n; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        idx[i] = (uint32_t)(x % entries);
+    }
+}
+
+size_t run_tuning() {
+    // Large enough that most lookups miss the LLC, whatever its size.
+    size_t llc = cpu_features().llc_bytes;
+    size_t bytes = std::max<size_t>((size_t)64 << 20, 4 * llc);
+    size_t entries = bytes / sizeof(float);
+    float* table = static_cast<float*>(map_pages(bytes));
+    simd_memset(table, 0, bytes);  // fault the pages in
+
+    std::vector<uint32_t> idx(kTuneLookups);
+    std::vector<float> out(kTuneLookups);
+    uint64_t x = 88172645463325252ull;
+
+    const KernelTable& k = kernels();
+    const size_t count = sizeof(kDistances) / sizeof(kDistances[0]);
+    double time[count];
+    double fastest = 0;
+    for (size_t c = 0; c < count; ++c) {
+        for (int trial = 0; trial < 3; ++trial) {
+            // New indices every run: the lines of the last one are in cache.
+            random_indices(idx.data(), idx.size(), entries, x);
+            auto start = std::chrono::steady_clock::now();
+            k.gather_f32(table, idx.data(), idx.size(), out.data(), kDistances[c]);
+            double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (trial == 0 || sec < time[c]) time[c] = sec;
+        }
+        if (c == 0 || time[c] < fastest) fastest = time[c];
+    }
+    // The shortest distance within kTolerance of the fastest: the longer ones
+    // keep more lines in flight for no gain.
+    size_t best = 0;
+    if (fastest * kMinGain <= time[0]) {
+        for (size_t c = count; c-- > 1;) {
+            if (time[c] <= fastest * kTolerance) best = kDistances[c];
+        }
+    }
+    unmap_pages(table, bytes);
+    return best;
+}
+
+size_t initial_distance() {
+    const char* env = std::getenv("SIMD_PREFETCH_DISTANCE");
+    if (env && *env) return (size_t)std::strtoul(env, nullptr, 10);
+    return run_tuning();
+}
+
+// Until set or tuned, the first prefetch_distance() call tunes. set_ and
+// tune_prefetch_distance store directly, so they never tune twice.
+const size_t kUntuned = SIZE_MAX;
+std::atomic<size_t> g_distance(kUntuned);
+
+// The distance in lookups for lookups of `bytes` each.
+size_t lookups_ahead(size_t bytes) {
+    size_t lines = prefetch_distance();
+    if (lines == 0) return 0;
+    size_t per_lookup = (bytes + 63) / 64;
+    return std::max<size_t>(1, lines / per_lookup);
+}
+
+} // namespace
+
+size_t prefetch_distance() {
+    size_t d = g_distance.load(std::memory_order_relaxed);
+    if (d != kUntuned) return d;
+    static const size_t initial = initial_distance();
+    g_distance.compare_exchange_strong(d, initial, std::memory_order_relaxed);
+    return g_distance.load(std::memory_order_relaxed);
+}
+
+void set_prefetch_distance(size_t lines) {
+    g_distance.store(lines, std::memory_order_relaxed);
+}
+
+size_t tune_prefetch_distance() {
+    size_t d = run_tuning();
+    set_prefetch_distance(d);
+    return d;
+}
+
+void gather(const float* table, const uint32_t* idx, size_t n, float* out) {
+    kernels().gather_f32(table, idx, n, out, lookups_ahead(sizeof(float)));
+}
+
+void gather_rows(const float* table, size_t dim, const uint32_t* idx, size_t n, float* out) {
+    if (dim == 0) return;
+    kernels().gather_rows_f32(table, dim, idx, n, out, lookups_ahead(dim * sizeof(float)));
+}
+
+} // namespace simd
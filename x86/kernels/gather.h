@@ -0,0 +1,47 @@
+#ifndef SIMD_GATHER_H
+#define SIMD_GATHER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+// Batched lookups into tables far larger than the caches, with software
+// prefetching.
+//
+// A gather instruction waits for all of its lanes, so a loop of gathers over
+// a multi-GB table runs at the speed of one DRAM round trip per vector: the
+// core's out-of-order window is too short to reach the next vector's misses.
+// Because the whole index stream is known up front, the kernels instead issue
+// a prefetch for the lookup `distance` positions ahead while gathering the
+// current one, so that by the time it is gathered its line is in L1.
+//
+// The distance is measured in cache lines of table data. gather() fetches one
+// line per lookup, so it runs `distance` lookups ahead; gather_rows() runs
+// `distance / lines per row` rows ahead (at least one). Too short leaves
+// latency exposed; too long evicts prefetched lines before they are used.
+
+// out[i] = table[idx[i]] for every i < n. Every idx[i] must be below 2^31
+// (vgatherdps takes signed 32-bit indices), so the table holds at most 8 GiB.
+void gather(const float* table, const uint32_t* idx, size_t n, float* out);
+
+// Embedding lookup: out[i * dim + j] = table[idx[i] * dim + j] for every
+// i < n and j < dim. Row offsets are computed in 64 bits, so the table may be
+// of any size.
+void gather_rows(const float* table, size_t dim, const uint32_t* idx, size_t n, float* out);
+
+// Prefetch distance in cache lines (0: no prefetching). SIMD_PREFETCH_DISTANCE
+// sets it; otherwise it is tuned on first use (see tune_prefetch_distance).
+size_t prefetch_distance();
+void set_prefetch_distance(size_t lines);
+
+// Times gather() with fresh random indices per run over a table of 4x the
+// last-level cache (at least 64 MiB, pages as map_pages gives them) for
+// distances 0 to 128 and keeps the shortest one within 3% of the fastest, or
+// 0 if prefetching gains less than 5%. Takes up to about a second, most
+// of it faulting the table in; returns the distance.
+size_t tune_prefetch_distance();
+
+} // namespace simd
+
+#endif // SIMD_GATHER_H
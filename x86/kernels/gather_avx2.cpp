@@ -0,0 +1,67 @@
+#include "kernels_internal.h"
+#include "tail_mask.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx2 {
+
+// vgatherdps fetches 8 floats per instruction but retires only once all 8
+// have arrived, so with random indices into a large table every vector waits
+// for the slowest of up to 8 DRAM misses. Issuing the 8 prefetches of the
+// vector `distance` lookups ahead overlaps those misses with the current ones.
+
+namespace {
+
+inline void prefetch8(const float* table, const uint32_t* idx) {
+    for (int j = 0; j < 8; ++j) _mm_prefetch((const char*)(table + idx[j]), _MM_HINT_T0);
+}
+
+// Every cache line of [p, p + bytes).
+inline void prefetch_lines(const void* p, size_t bytes) {
+    uintptr_t b = (uintptr_t)p & ~(uintptr_t)63;
+    for (uintptr_t e = (uintptr_t)p + bytes; b < e; b += 64) _mm_prefetch((const char*)b, _MM_HINT_T0);
+}
+
+inline void gather8(const float* table, const uint32_t* idx, float* out) {
+    __m256i i = _mm256_loadu_si256((const __m256i*)idx);
+    _mm256_storeu_ps(out, _mm256_i32gather_ps(table, i, 4));
+}
+
+} // namespace
+
+void gather_f32(const float* table, const uint32_t* idx, size_t n, float* out, size_t distance) {
+    size_t i = 0;
+    if (distance) {
+        for (; i + distance + 8 <= n; i += 8) {
+            prefetch8(table, idx + i + distance);
+            gather8(table, idx + i, out + i);
+        }
+    }
+    for (; i + 8 <= n; i += 8) gather8(table, idx + i, out + i);
+    if (i < n) {
+        Tail256<int32_t> t(n - i);
+        __m256i v = t.load((const int32_t*)idx + i);
+        __m256 g = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), table, v, _mm256_castsi256_ps(t.m), 4);
+        Tail256<float>(n - i).store(out + i, g);
+    }
+}
+
+void gather_rows_f32(const float* table, size_t dim, const uint32_t* idx, size_t n, float* out, size_t distance) {
+    for (size_t i = 0; i < n; ++i) {
+        if (distance && i + distance < n) {
+            prefetch_lines(table + (size_t)idx[i + distance] * dim, dim * sizeof(float));
+        }
+        const float* row = table + (size_t)idx[i] * dim;
+        float* dst = out + i * dim;
+        size_t j = 0;
+        for (; j + 8 <= dim; j += 8) _mm256_storeu_ps(dst + j, _mm256_loadu_ps(row + j));
+        if (j < dim) {
+            Tail256<float> t(dim - j);
+            t.store(dst + j, t.load(row + j));
+        }
+    }
+}
+
+} // namespace avx2
+} // namespace simd
@@ -0,0 +1,65 @@
+#include "kernels_internal.h"
+#include "tail_mask.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512 {
+
+// Same scheme as the AVX2 kernels with 16-wide gathers. The prefetch
+// instructions of AVX-512PF existed only on Xeon Phi, so the 16 prefetches
+// of a vector are scalar _mm_prefetch, as on AVX2.
+
+namespace {
+
+inline void prefetch16(const float* table, const uint32_t* idx) {
+    for (int j = 0; j < 16; ++j) _mm_prefetch((const char*)(table + idx[j]), _MM_HINT_T0);
+}
+
+// Every cache line of [p, p + bytes).
+inline void prefetch_lines(const void* p, size_t bytes) {
+    uintptr_t b = (uintptr_t)p & ~(uintptr_t)63;
+    for (uintptr_t e = (uintptr_t)p + bytes; b < e; b += 64) _mm_prefetch((const char*)b, _MM_HINT_T0);
+}
+
+inline void gather16(const float* table, const uint32_t* idx, float* out) {
+    __m512i i = _mm512_loadu_si512((const void*)idx);
+    _mm512_storeu_ps(out, _mm512_i32gather_ps(i, table, 4));
+}
+
+} // namespace
+
+void gather_f32(const float* table, const uint32_t* idx, size_t n, float* out, size_t distance) {
+    size_t i = 0;
+    if (distance) {
+        for (; i + distance + 16 <= n; i += 16) {
+            prefetch16(table, idx + i + distance);
+            gather16(table, idx + i, out + i);
+        }
+    }
+    for (; i + 16 <= n; i += 16) gather16(table, idx + i, out + i);
+    if (i < n) {
+        Tail512<int32_t> t(n - i);
+        __m512i v = t.load((const int32_t*)idx + i);
+        _mm512_mask_storeu_ps(out + i, t.k, _mm512_mask_i32gather_ps(_mm512_setzero_ps(), t.k, v, table, 4));
+    }
+}
+
+void gather_rows_f32(const float* table, size_t dim, const uint32_t* idx, size_t n, float* out, size_t distance) {
+    for (size_t i = 0; i < n; ++i) {
+        if (distance && i + distance < n) {
+            prefetch_lines(table + (size_t)idx[i + distance] * dim, dim * sizeof(float));
+        }
+        const float* row = table + (size_t)idx[i] * dim;
+        float* dst = out + i * dim;
+        size_t j = 0;
+        for (; j + 16 <= dim; j += 16) _mm512_storeu_ps(dst + j, _mm512_loadu_ps(row + j));
+        if (j < dim) {
+            Tail512<float> t(dim - j);
+            t.store(dst + j, t.load(row + j));
+        }
+    }
+}
+
+} // namespace avx512
+} // namespace simd
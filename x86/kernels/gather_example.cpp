@@ -0,0 +1,138 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include "arena.h"
+#include "dispatch.h"
+#include "gather.h"
+#include "memops.h"
+
+namespace {
+
+// Lookups are made in batches of this many, into one output buffer that
+// stays in L2, as a model serving requests would.
+const size_t kBatch = 4096;
+
+// Every level against the scalar kernels, with and without prefetching, on
+// lengths around a vector and rows around a vector.
+bool check_level(const simd::KernelTable& t) {
+    const simd::KernelTable& ref = simd::kernels_for(simd::Isa::Scalar);
+    std::vector<float> table(100000);
+    for (size_t i = 0; i < table.size(); ++i) table[i] = (float)i * 0.5f;
+    std::mt19937 rng(1);
+    std::vector<uint32_t> idx(1003);
+
+    for (size_t distance : {(size_t)0, (size_t)1, (size_t)5, (size_t)64}) {
+        std::uniform_int_distribution<uint32_t> any(0, (uint32_t)table.size() - 1);
+        for (uint32_t& i : idx) i = any(rng);
+        for (size_t n : {(size_t)0, (size_t)1, (size_t)7, (size_t)8, (size_t)9, (size_t)15, (size_t)16,
+                         (size_t)17, idx.size()}) {
+            std::vector<float> out(n + 1, -1.0f), want(n + 1, -1.0f);
+            t.gather_f32(table.data(), idx.data(), n, out.data(), distance);
+            ref.gather_f32(table.data(), idx.data(), n, want.data(), 0);
+            if (out != want) return false;
+        }
+        for (size_t dim : {(size_t)1, (size_t)7, (size_t)16, (size_t)64, (size_t)100}) {
+            size_t rows = table.size() / dim;
+            std::uniform_int_distribution<uint32_t> row(0, (uint32_t)rows - 1);
+            for (uint32_t& i : idx) i = row(rng);
+            size_t n = 37;
+            std::vector<float> out(n * dim + 1, -1.0f), want(n * dim + 1, -1.0f);
+            t.gather_rows_f32(table.data(), dim, idx.data(), n, out.data(), distance);
+            ref.gather_rows_f32(table.data(), dim, idx.data(), n, want.data(), 0);
+            if (out != want) return false;
+        }
+    }
+    return true;
+}
+
+std::vector<uint32_t> random_indices(size_t n, size_t range) {
+    std::vector<uint32_t> idx(n);
+    std::mt19937_64 rng(2);
+    std::uniform_int_distribution<uint64_t> any(0, range - 1);
+    for (uint32_t& i : idx) i = (uint32_t)any(rng);
+    return idx;
+}
+
+template <typename F>
+double ns_per_lookup(size_t lookups, F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 3; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || ns < best) best = ns;
+    }
+    return best / lookups;
+}
+
+// ns per lookup for each prefetch distance, against no prefetching.
+template <typename F>
+void sweep(const char* title, size_t lookups, F body) {
+    std::cout << title << std::endl;
+    double base = 0;
+    for (size_t d : {(size_t)0, (size_t)4, (size_t)8, (size_t)16, (size_t)32, (size_t)64, (size_t)128}) {
+        simd::set_prefetch_distance(d);
+        double ns = ns_per_lookup(lookups, body);
+        if (d == 0) base = ns;
+        std::cout << "  distance " << std::setw(3) << d << ": " << std::setw(7) << ns << " ns/lookup";
+        if (d) std::cout << "  (" << base / ns << "x)";
+        std::cout << std::endl;
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::fixed << std::setprecision(2);
+    bool ok = true;
+    const simd::Isa levels[] = {simd::Isa::Scalar, simd::Isa::AVX2, simd::Isa::AVX512};
+    for (simd::Isa isa : levels) {
+        if (isa > simd::detect_isa()) break;
+        bool level_ok = check_level(simd::kernels_for(isa));
+        std::cout << std::setw(7) << simd::isa_name(isa) << " vs scalar: " << (level_ok ? "OK" : "MISMATCH")
+                  << std::endl;
+        ok &= level_ok;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t tuned = simd::tune_prefetch_distance();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::endl << "Tuned prefetch distance: " << tuned << " lines (" << ms << " ms)" << std::endl
+              << std::endl;
+
+    // 4-byte lookups into 512 MiB: one DRAM miss per lookup.
+    {
+        const size_t bytes = (size_t)512 << 20, lookups = (size_t)1 << 22;
+        float* table = static_cast<float*>(simd::map_pages(bytes));
+        simd::simd_memset(table, 0, bytes);
+        std::vector<uint32_t> idx = random_indices(lookups, bytes / sizeof(float));
+        std::vector<float> out(kBatch);
+        sweep("gather, 4 M lookups into 512 MiB:", lookups, [&] {
+            for (size_t b = 0; b < lookups; b += kBatch) simd::gather(table, idx.data() + b, kBatch, out.data());
+        });
+        simd::unmap_pages(table, bytes);
+    }
+
+    // Embedding rows of 64 floats (4 cache lines) out of 2M rows.
+    {
+        const size_t dim = 64, rows = (size_t)1 << 21, bytes = rows * dim * sizeof(float);
+        const size_t lookups = (size_t)1 << 20;
+        float* table = static_cast<float*>(simd::map_pages(bytes));
+        simd::simd_memset(table, 0, bytes);
+        std::vector<uint32_t> idx = random_indices(lookups, rows);
+        std::vector<float> out(kBatch * dim);
+        std::cout << std::endl;
+        sweep("gather_rows, 1 M rows of 256 B out of 512 MiB:", lookups, [&] {
+            for (size_t b = 0; b < lookups; b += kBatch) {
+                simd::gather_rows(table, dim, idx.data() + b, kBatch, out.data());
+            }
+        });
+        simd::unmap_pages(table, bytes);
+    }
+    simd::set_prefetch_distance(tuned);
+    return ok ? 0 : 1;
+}
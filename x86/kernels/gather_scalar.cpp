@@ -0,0 +1,42 @@
+#include "kernels_internal.h"
+
+#include <xmmintrin.h>
+
+namespace simd {
+namespace scalar {
+
+// _mm_prefetch is SSE, part of baseline x86-64.
+
+namespace {
+
+// Every cache line of [p, p + bytes).
+inline void prefetch_lines(const void* p, size_t bytes) {
+    uintptr_t b = (uintptr_t)p & ~(uintptr_t)63;
+    for (uintptr_t e = (uintptr_t)p + bytes; b < e; b += 64) _mm_prefetch((const char*)b, _MM_HINT_T0);
+}
+
+} // namespace
+
+void gather_f32(const float* table, const uint32_t* idx, size_t n, float* out, size_t distance) {
+    size_t i = 0;
+    if (distance) {
+        for (; i + distance < n; ++i) {
+            _mm_prefetch((const char*)(table + idx[i + distance]), _MM_HINT_T0);
+            out[i] = table[idx[i]];
+        }
+    }
+    for (; i < n; ++i) out[i] = table[idx[i]];
+}
+
+void gather_rows_f32(const float* table, size_t dim, const uint32_t* idx, size_t n, float* out, size_t distance) {
+    for (size_t i = 0; i < n; ++i) {
+        if (distance && i + distance < n) {
+            prefetch_lines(table + (size_t)idx[i + distance] * dim, dim * sizeof(float));
+        }
+        const float* row = table + (size_t)idx[i] * dim;
+        for (size_t j = 0; j < dim; ++j) out[i * dim + j] = row[j];
+    }
+}
+
+} // namespace scalar
+} // namespace simd
@@ -0,0 +1,37 @@
+#include "kernels_internal.h"
+#include "hash_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx2 {
+
+namespace {
+
+// 32 control bytes: vpcmpeqb and vpmovmskb.
+struct Group32 {
+    static const size_t kBytes = 32;
+    static const unsigned kShift = 0;
+    static uint64_t match(const uint8_t* ctrl, uint8_t tag) {
+        __m256i g = _mm256_load_si256((const __m256i*)ctrl);
+        return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(g, _mm256_set1_epi8((char)tag)));
+    }
+    static uint64_t match_empty(const uint8_t* ctrl) {
+        __m256i g = _mm256_load_si256((const __m256i*)ctrl);
+        return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(g, _mm256_setzero_si256()));
+    }
+};
+
+} // namespace
+
+size_t hash_find_u64(const HashTable& t, const uint64_t* keys, size_t n, uint64_t* values, uint8_t* found) {
+    return find_batch<Group32>(t, keys, n, values, found);
+}
+
+size_t hash_insert_u64(HashTable& t, const uint64_t* keys, const uint64_t* values, size_t n, bool add,
+                       uint8_t* inserted) {
+    return insert_batch<Group32>(t, keys, values, n, add, inserted);
+}
+
+} // namespace avx2
+} // namespace simd
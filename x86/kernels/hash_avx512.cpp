@@ -0,0 +1,37 @@
+#include "kernels_internal.h"
+#include "hash_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512 {
+
+namespace {
+
+// 64 control bytes, a whole cache line: vpcmpeqb into a 64-bit mask
+// register (AVX-512BW).
+struct Group64 {
+    static const size_t kBytes = 64;
+    static const unsigned kShift = 0;
+    static uint64_t match(const uint8_t* ctrl, uint8_t tag) {
+        __m512i g = _mm512_load_si512(ctrl);
+        return _mm512_cmpeq_epi8_mask(g, _mm512_set1_epi8((char)tag));
+    }
+    static uint64_t match_empty(const uint8_t* ctrl) {
+        return _mm512_cmpeq_epi8_mask(_mm512_load_si512(ctrl), _mm512_setzero_si512());
+    }
+};
+
+} // namespace
+
+size_t hash_find_u64(const HashTable& t, const uint64_t* keys, size_t n, uint64_t* values, uint8_t* found) {
+    return find_batch<Group64>(t, keys, n, values, found);
+}
+
+size_t hash_insert_u64(HashTable& t, const uint64_t* keys, const uint64_t* values, size_t n, bool add,
+                       uint8_t* inserted) {
+    return insert_batch<Group64>(t, keys, values, n, add, inserted);
+}
+
+} // namespace avx512
+} // namespace simd
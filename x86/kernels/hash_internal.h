@@ -0,0 +1,166 @@
+#ifndef SIMD_HASH_INTERNAL_H
+#define SIMD_HASH_INTERNAL_H
+
+// Probing of the HashMap table (hash_map.h), shared by the per-ISA kernels.
+// Everything has internal linkage so each translation unit compiles its own
+// copy with its own flags.
+//
+// The kernels differ only in the Group they probe with:
+//
+//   kBytes                 control bytes per group
+//   kShift                 match bits per slot are 1 << kShift apart
+//   match(ctrl, tag)       mask of the slots whose control byte is tag
+//   match_empty(ctrl)      mask of the empty slots
+//
+// ctrl is the group's first control byte, aligned to kBytes. match may
+// report false positives (the key is compared anyway), never false negatives.
+
+#include <cstddef>
+#include <cstdint>
+#include <xmmintrin.h>
+#include "hash_map.h"
+
+namespace simd {
+
+namespace {
+
+inline uint64_t hash_u64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+// The tag is the low byte of the hash; 0 marks empty slots, so hashes that
+// end in 0 share tag 1 with those that end in 1.
+inline uint8_t tag_of(uint64_t h) {
+    uint8_t t = (uint8_t)h;
+    return t ? t : 1;
+}
+inline size_t group_of(uint64_t h, size_t group_mask) { return (size_t)(h >> 8) & group_mask; }
+
+// Keys hashed and prefetched ahead of their probes. 16 keep the line fill
+// buffers of one core busy without evicting the groups before their probe.
+const size_t kProbeBatch = 16;
+
+// The slot of key, or SIZE_MAX and in `empty` the first empty slot of its
+// probe sequence, where it would be inserted. The table always has an empty
+// slot, so the loop ends.
+template <typename Group>
+inline size_t find_slot(const HashTable& t, uint64_t key, uint64_t h, size_t& empty) {
+    const uint8_t tag = tag_of(h);
+    size_t g = group_of(h, t.group_mask);
+    for (size_t step = 1;; ++step) {
+        const size_t base = g * Group::kBytes;
+        const uint8_t* ctrl = t.ctrl + base;
+        for (uint64_t m = Group::match(ctrl, tag); m; m &= m - 1) {
+            size_t s = base + ((size_t)__builtin_ctzll(m) >> Group::kShift);
+            if (t.slots[2 * s] == key) return s;
+        }
+        uint64_t e = Group::match_empty(ctrl);
+        if (e) {
+            empty = base + ((size_t)__builtin_ctzll(e) >> Group::kShift);
+            return SIZE_MAX;
+        }
+        g = (g + step) & t.group_mask;
+    }
+}
+
+// Hashes keys[0, m) into h and prefetches their control groups, then the
+// first candidate slot of each.
+template <typename Group>
+inline void prefetch_batch(const HashTable& t, const uint64_t* keys, size_t m, uint64_t* h) {
+    for (size_t j = 0; j < m; ++j) {
+        h[j] = hash_u64(keys[j]);
+        _mm_prefetch((const char*)(t.ctrl + group_of(h[j], t.group_mask) * Group::kBytes), _MM_HINT_T0);
+    }
+    for (size_t j = 0; j < m; ++j) {
+        const size_t base = group_of(h[j], t.group_mask) * Group::kBytes;
+        uint64_t c = Group::match(t.ctrl + base, tag_of(h[j]));
+        if (c) {
+            size_t s = base + ((size_t)__builtin_ctzll(c) >> Group::kShift);
+            _mm_prefetch((const char*)(t.slots + 2 * s), _MM_HINT_T0);
+        }
+    }
+}
+
+template <typename Group>
+inline size_t find_batch(const HashTable& t, const uint64_t* keys, size_t n, uint64_t* values, uint8_t* found) {
+    uint64_t h[kProbeBatch];
+    size_t hits = 0;
+    for (size_t i0 = 0; i0 < n; i0 += kProbeBatch) {
+        size_t m = n - i0 < kProbeBatch ? n - i0 : kProbeBatch;
+        prefetch_batch<Group>(t, keys + i0, m, h);
+        for (size_t j = 0; j < m; ++j) {
+            size_t empty = 0;
+            size_t s = find_slot<Group>(t, keys[i0 + j], h[j], empty);
+            bool hit = s != SIZE_MAX;
+            if (hit) values[i0 + j] = t.slots[2 * s + 1];
+            found[i0 + j] = hit;
+            hits += hit;
+        }
+    }
+    return hits;
+}
+
+// Inserts or, with add, accumulates; returns the number of keys taken,
+// which is n unless the table reached max_size.
+template <typename Group>
+inline size_t insert_batch(HashTable& t, const uint64_t* keys, const uint64_t* values, size_t n, bool add,
+                           uint8_t* inserted) {
+    uint64_t h[kProbeBatch];
+    for (size_t i0 = 0; i0 < n; i0 += kProbeBatch) {
+        size_t m = n - i0 < kProbeBatch ? n - i0 : kProbeBatch;
+        prefetch_batch<Group>(t, keys + i0, m, h);
+        for (size_t j = 0; j < m; ++j) {
+            const size_t i = i0 + j;
+            size_t empty = 0;
+            size_t s = find_slot<Group>(t, keys[i], h[j], empty);
+            if (s != SIZE_MAX) {
+                if (add) t.slots[2 * s + 1] += values[i];
+                if (inserted) inserted[i] = 0;
+                continue;
+            }
+            if (t.size == t.max_size) return i;
+            t.ctrl[empty] = tag_of(h[j]);
+            t.slots[2 * empty] = keys[i];
+            t.slots[2 * empty + 1] = values[i];
+            ++t.size;
+            if (inserted) inserted[i] = 1;
+        }
+    }
+    return n;
+}
+
+// Eight control bytes in a uint64_t. A byte equal to the tag becomes zero
+// after the xor; (x - 0x01..) & ~x sets the top bit of every zero byte, and
+// of a 0x01 byte just above one (a false positive the key check rejects).
+// Empty slots must be exact, so their test adds 0x7F to the low seven bits
+// instead, which cannot carry into the next byte.
+struct GroupSwar8 {
+    static const size_t kBytes = 8;
+    static const unsigned kShift = 3;
+    static uint64_t load(const uint8_t* ctrl) {
+        uint64_t x;
+        __builtin_memcpy(&x, ctrl, sizeof(x));
+        return x;
+    }
+    static uint64_t match(const uint8_t* ctrl, uint8_t tag) {
+        const uint64_t lsbs = 0x0101010101010101ULL, msbs = 0x8080808080808080ULL;
+        uint64_t x = load(ctrl) ^ (lsbs * tag);
+        return (x - lsbs) & ~x & msbs;
+    }
+    static uint64_t match_empty(const uint8_t* ctrl) {
+        const uint64_t lows = 0x7F7F7F7F7F7F7F7FULL;
+        uint64_t x = load(ctrl);
+        return ~(((x & lows) + lows) | x | lows);
+    }
+};
+
+} // namespace
+
+} // namespace simd
+
+#endif // SIMD_HASH_INTERNAL_H
@@ -0,0 +1,123 @@
+#include "hash_map.h"
+#include "arena.h"
+#include "dispatch.h"
+
+#include <cstring>
+#include <vector>
+
+namespace simd {
+
+namespace {
+
+// The table fills to 7/8 before it doubles. Probe sequences stay short up
+// to there because a probe moves on only past a full group.
+size_t max_size_of(size_t slots) {
+    return slots - slots / 8;
+}
+
+// Tables from this size on get huge-page backed memory: a probe of a large
+// table is one TLB miss per lookup otherwise.
+const size_t kMapPagesBytes = kHugePageSize;
+
+size_t round_up(size_t x, size_t a) {
+    return (x + a - 1) / a * a;
+}
+
+} // namespace
+
+HashMap::HashMap(size_t expected) : HashMap(expected, kernels()) {}
+
+HashMap::HashMap(size_t expected, const KernelTable& kernels)
+    : kernels_(&kernels), group_(kernels.hash_group), storage_(nullptr), storage_bytes_(0) {
+    size_t groups = 1;
+    while (max_size_of(groups * group_) < expected) groups *= 2;
+    allocate(groups);
+}
+
+HashMap::~HashMap() {
+    release();
+}
+
+void HashMap::allocate(size_t groups) {
+    size_t slots = groups * group_;
+    size_t ctrl_bytes = round_up(slots, kCacheLine);
+    storage_bytes_ = ctrl_bytes + slots * 2 * sizeof(uint64_t);
+    // Empty control bytes are 0, which fresh pages already are.
+    if (storage_bytes_ >= kMapPagesBytes) {
+        storage_ = map_pages(storage_bytes_);
+    } else {
+        storage_ = aligned_malloc(storage_bytes_, kCacheLine);
+        std::memset(storage_, kHashEmpty, ctrl_bytes);
+    }
+    table_.ctrl = static_cast<uint8_t*>(storage_);
+    table_.slots = reinterpret_cast<uint64_t*>(table_.ctrl + ctrl_bytes);
+    table_.group_mask = groups - 1;
+    table_.size = 0;
+    table_.max_size = max_size_of(slots);
+}
+
+void HashMap::release() {
+    if (storage_bytes_ >= kMapPagesBytes) {
+        unmap_pages(storage_, storage_bytes_);
+    } else {
+        aligned_free(storage_);
+    }
+    storage_ = nullptr;
+}
+
+// Doubles the groups and re-inserts every entry through the kernel.
+void HashMap::grow() {
+    std::vector<uint64_t> keys, values;
+    keys.reserve(size());
+    values.reserve(size());
+    for_each([&](uint64_t k, uint64_t v) {
+        keys.push_back(k);
+        values.push_back(v);
+    });
+    size_t groups = (table_.group_mask + 1) * 2;
+    release();
+    allocate(groups);
+    kernels_->hash_insert_u64(table_, keys.data(), values.data(), keys.size(), false, nullptr);
+}
+
+size_t HashMap::insert_impl(const uint64_t* keys, const uint64_t* values, size_t n, bool add, uint8_t* inserted) {
+    size_t before = size();
+    size_t added = 0;
+    for (size_t i = 0; i < n;) {
+        i += kernels_->hash_insert_u64(table_, keys + i, values + i, n - i, add, inserted ? inserted + i : nullptr);
+        if (i < n) {
+            added += size() - before;
+            grow();
+            before = size();
+        }
+    }
+    return added + size() - before;
+}
+
+bool HashMap::insert(uint64_t key, uint64_t value) {
+    return insert_impl(&key, &value, 1, false, nullptr) != 0;
+}
+
+bool HashMap::find(uint64_t key, uint64_t* value) const {
+    uint8_t found;
+    return kernels_->hash_find_u64(table_, &key, 1, value, &found) != 0;
+}
+
+size_t HashMap::insert(const uint64_t* keys, const uint64_t* values, size_t n, uint8_t* inserted) {
+    return insert_impl(keys, values, n, false, inserted);
+}
+
+void HashMap::add(const uint64_t* keys, const uint64_t* deltas, size_t n) {
+    insert_impl(keys, deltas, n, true, nullptr);
+}
+
+size_t HashMap::find(const uint64_t* keys, size_t n, uint64_t* values, uint8_t* found) const {
+    return kernels_->hash_find_u64(table_, keys, n, values, found);
+}
+
+void HashMap::clear() {
+    std::memset(table_.ctrl, kHashEmpty, capacity());
+    table_.size = 0;
+}
+
+} // namespace simd
@@ -0,0 +1,96 @@
+#ifndef SIMD_HASH_MAP_H
+#define SIMD_HASH_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+struct KernelTable;
+
+// Open-addressing hash map from uint64_t keys to uint64_t values, Swiss-table
+// style, for the build and probe sides of dedup and aggregation.
+//
+// Every slot has a control byte: kHashEmpty, or the low byte of its key's
+// hash (the tag, never 0). Slots come in groups whose control bytes are one aligned
+// vector: 16 bytes with SSE4.1, 32 with AVX2, 64 with AVX-512 (8 bytes,
+// matched with 64-bit arithmetic, at the scalar level). A probe loads the
+// group the hash points to, compares all of its tags with the key's tag in
+// one instruction and only reads the keys of the slots that match: most
+// probes touch one control line and one slot. It moves on to the next group
+// (triangular steps, so every group is visited) only if the group is full.
+//
+// The batch functions hash a batch of keys and prefetch their control groups
+// first, then the first matching slot of each, and probe only then: the
+// cache misses of the batch overlap instead of coming one after another.
+//
+// The table grows at 7/8 full. Keys are never erased. The layout depends on
+// the group width, so a map keeps the kernels it was built with.
+
+const uint8_t kHashEmpty = 0;
+
+// The table as the kernels see it. slots holds key, value pairs: slot s is
+// slots[2 s], slots[2 s + 1]; its control byte is ctrl[s]. ctrl is 64-byte
+// aligned, and the number of groups is a power of two.
+struct HashTable {
+    uint8_t* ctrl;
+    uint64_t* slots;
+    size_t group_mask;  // groups - 1
+    size_t size;
+    size_t max_size;    // insert stops before a new key beyond this
+};
+
+class HashMap {
+public:
+    // Room for `expected` keys before the first rehash.
+    explicit HashMap(size_t expected = 0);
+    // With a specific level's kernels, for benchmarks and cross-checking.
+    HashMap(size_t expected, const KernelTable& kernels);
+    ~HashMap();
+    HashMap(const HashMap&) = delete;
+    HashMap& operator=(const HashMap&) = delete;
+
+    size_t size() const { return table_.size; }
+    size_t capacity() const { return (table_.group_mask + 1) * group_; }
+
+    // Inserts (key, value) if key is absent; returns whether it was.
+    bool insert(uint64_t key, uint64_t value);
+    // Copies the value of key to *value if present.
+    bool find(uint64_t key, uint64_t* value) const;
+
+    // Batched forms. insert keeps the value already there for keys that are
+    // present and sets inserted[i] (if given) to whether keys[i] was new;
+    // returns the number of new keys. A key repeated in the batch is
+    // inserted once. add does map[keys[i]] += deltas[i], starting new keys
+    // at 0. find sets found[i] and, for the keys found, values[i]; returns
+    // the number found.
+    size_t insert(const uint64_t* keys, const uint64_t* values, size_t n, uint8_t* inserted = nullptr);
+    void add(const uint64_t* keys, const uint64_t* deltas, size_t n);
+    size_t find(const uint64_t* keys, size_t n, uint64_t* values, uint8_t* found) const;
+
+    // f(key, value) for every entry, in slot order.
+    template <typename F>
+    void for_each(F f) const {
+        for (size_t s = 0, n = capacity(); s < n; ++s) {
+            if (table_.ctrl[s] != kHashEmpty) f(table_.slots[2 * s], table_.slots[2 * s + 1]);
+        }
+    }
+
+    void clear();
+
+private:
+    void allocate(size_t groups);
+    void release();
+    void grow();
+    size_t insert_impl(const uint64_t* keys, const uint64_t* values, size_t n, bool add, uint8_t* inserted);
+
+    const KernelTable* kernels_;
+    size_t group_;
+    HashTable table_;
+    void* storage_;
+    size_t storage_bytes_;
+};
+
+} // namespace simd
+
+#endif // SIMD_HASH_MAP_H
@@ -0,0 +1,137 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <unordered_map>
+#include <cstdint>
+#include "dispatch.h"
+#include "hash_map.h"
+
+namespace {
+
+std::vector<uint64_t> random_keys(size_t n, uint64_t range, uint64_t seed) {
+    std::vector<uint64_t> keys(n);
+    std::mt19937_64 rng(seed);
+    for (uint64_t& k : keys) k = range ? rng() % range : rng();
+    return keys;
+}
+
+// One level's map against std::unordered_map: batched inserts with repeats
+// (through several rehashes from an empty map), adds, then lookups of keys
+// that are present and absent.
+bool check_level(const simd::KernelTable& t) {
+    for (size_t n : {(size_t)1, (size_t)7, (size_t)100, (size_t)5000, (size_t)200000}) {
+        simd::HashMap map(0, t);
+        std::unordered_map<uint64_t, uint64_t> want;
+        std::vector<uint64_t> keys = random_keys(n, n, n), values(n), deltas(n, 3);
+        for (size_t i = 0; i < n; ++i) values[i] = keys[i] * 10;
+        std::vector<uint8_t> inserted(n);
+        size_t added = map.insert(keys.data(), values.data(), n, inserted.data());
+        size_t want_added = 0;
+        for (size_t i = 0; i < n; ++i) {
+            bool is_new = want.insert(std::make_pair(keys[i], values[i])).second;
+            if (inserted[i] != is_new) return false;
+            want_added += is_new;
+        }
+        if (added != want_added || map.size() != want.size()) return false;
+
+        std::vector<uint64_t> more = random_keys(n, 2 * n, n + 1);
+        map.add(more.data(), deltas.data(), n);
+        for (uint64_t k : more) want[k] += 3;
+
+        std::vector<uint64_t> probe = random_keys(n, 4 * n, n + 2), got(n);
+        std::vector<uint8_t> found(n);
+        size_t hits = map.find(probe.data(), n, got.data(), found.data());
+        size_t want_hits = 0;
+        for (size_t i = 0; i < n; ++i) {
+            auto it = want.find(probe[i]);
+            if (found[i] != (it != want.end())) return false;
+            if (found[i] && got[i] != it->second) return false;
+            want_hits += found[i];
+        }
+        if (hits != want_hits || map.size() != want.size()) return false;
+        size_t entries = 0;
+        bool same = true;
+        map.for_each([&](uint64_t k, uint64_t v) {
+            ++entries;
+            auto it = want.find(k);
+            same &= it != want.end() && it->second == v;
+        });
+        if (!same || entries != want.size()) return false;
+    }
+    return true;
+}
+
+template <typename F>
+double seconds(F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 3; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return best;
+}
+
+// M lookups/s into a map of `size` keys, half of the lookups hitting: one
+// key per call, then batches of 1024; std::unordered_map for reference.
+void bench(size_t size) {
+    const size_t lookups = (size_t)1 << 22, batch = 1024;
+    std::vector<uint64_t> keys = random_keys(size, 0, 1), values(size, 1);
+    std::vector<uint64_t> probe = random_keys(lookups, 0, 2), out(lookups);
+    std::mt19937_64 rng(3);
+    for (size_t i = 0; i < lookups; i += 2) probe[i] = keys[rng() % size];
+    std::vector<uint8_t> found(lookups);
+
+    std::unordered_map<uint64_t, uint64_t> std_map;
+    for (uint64_t k : keys) std_map[k] = 1;
+    size_t sink = 0;
+    double ref = seconds([&] {
+        for (uint64_t k : probe) sink += std_map.count(k);
+    });
+    std::cout << "  " << std::setw(5) << (size >> 10) << " K keys  " << std::setw(8) << lookups / ref / 1e6;
+
+    const simd::Isa levels[] = {simd::Isa::Scalar, simd::Isa::SSE41, simd::Isa::AVX2, simd::Isa::AVX512};
+    for (simd::Isa isa : levels) {
+        if (isa > simd::detect_isa()) break;
+        simd::HashMap map(size, simd::kernels_for(isa));
+        map.insert(keys.data(), values.data(), size);
+        double one = seconds([&] {
+            for (size_t i = 0; i < lookups; ++i) sink += map.find(probe[i], &out[i]);
+        });
+        double batched = seconds([&] {
+            for (size_t i = 0; i < lookups; i += batch) sink += map.find(probe.data() + i, batch, out.data() + i, found.data() + i);
+        });
+        std::cout << "  " << std::setw(6) << lookups / one / 1e6 << " / " << std::setw(6) << lookups / batched / 1e6;
+    }
+    std::cout << std::endl;
+    if (sink == 42) std::cout << "";
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::fixed << std::setprecision(1);
+    bool ok = true;
+    const simd::Isa levels[] = {simd::Isa::Scalar, simd::Isa::SSE41, simd::Isa::AVX2, simd::Isa::AVX512};
+    for (simd::Isa isa : levels) {
+        if (isa > simd::detect_isa()) break;
+        bool level_ok = check_level(simd::kernels_for(isa));
+        std::cout << std::setw(7) << simd::isa_name(isa) << " vs std::unordered_map: " << (level_ok ? "OK" : "MISMATCH")
+                  << std::endl;
+        ok &= level_ok;
+    }
+
+    std::cout << std::endl << "M lookups/s, half hits (one key per call / batches of 1024):" << std::endl
+              << "  " << std::setw(13) << "" << "  unordered";
+    for (simd::Isa isa : levels) {
+        if (isa > simd::detect_isa()) break;
+        std::cout << "  " << std::setw(15) << simd::isa_name(isa);
+    }
+    std::cout << std::endl;
+    for (size_t size : {(size_t)1 << 14, (size_t)1 << 20, (size_t)1 << 24}) bench(size);
+    return ok ? 0 : 1;
+}
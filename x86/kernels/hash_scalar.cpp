@@ -0,0 +1,18 @@
+#include "kernels_internal.h"
+#include "hash_internal.h"
+
+namespace simd {
+namespace scalar {
+
+// Groups of 8 control bytes matched with 64-bit arithmetic (GroupSwar8).
+size_t hash_find_u64(const HashTable& t, const uint64_t* keys, size_t n, uint64_t* values, uint8_t* found) {
+    return find_batch<GroupSwar8>(t, keys, n, values, found);
+}
+
+size_t hash_insert_u64(HashTable& t, const uint64_t* keys, const uint64_t* values, size_t n, bool add,
+                       uint8_t* inserted) {
+    return insert_batch<GroupSwar8>(t, keys, values, n, add, inserted);
+}
+
+} // namespace scalar
+} // namespace simd
@@ -0,0 +1,37 @@
+#include "kernels_internal.h"
+#include "hash_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace sse41 {
+
+namespace {
+
+// 16 control bytes: pcmpeqb and pmovmskb.
+struct Group16 {
+    static const size_t kBytes = 16;
+    static const unsigned kShift = 0;
+    static uint64_t match(const uint8_t* ctrl, uint8_t tag) {
+        __m128i g = _mm_load_si128((const __m128i*)ctrl);
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)tag)));
+    }
+    static uint64_t match_empty(const uint8_t* ctrl) {
+        __m128i g = _mm_load_si128((const __m128i*)ctrl);
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_setzero_si128()));
+    }
+};
+
+} // namespace
+
+size_t hash_find_u64(const HashTable& t, const uint64_t* keys, size_t n, uint64_t* values, uint8_t* found) {
+    return find_batch<Group16>(t, keys, n, values, found);
+}
+
+size_t hash_insert_u64(HashTable& t, const uint64_t* keys, const uint64_t* values, size_t n, bool add,
+                       uint8_t* inserted) {
+    return insert_batch<Group16>(t, keys, values, n, add, inserted);
+}
+
+} // namespace sse41
+} // namespace simd
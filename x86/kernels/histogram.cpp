@@ -0,0 +1,67 @@
+#include "histogram.h"
+#include "dispatch.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace simd {
+
+namespace {
+
+// Below this many indices, starting a thread costs more than counting.
+const size_t kMinPerThread = 1 << 16;
+
+unsigned thread_count(unsigned threads, size_t n, size_t nbins) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    return (unsigned)std::min<size_t>(threads, std::max<size_t>(1, n / std::max(kMinPerThread, nbins)));
+}
+
+// Splits [0, n) into `threads` chunks. The calling thread runs chunk 0 with
+// `out` itself; every other chunk runs with a zeroed private copy, added into
+// `out` once all have finished.
+template <typename T, typename Run>
+void run_private(size_t n, T* out, size_t nout, unsigned threads, Run run) {
+    std::vector<std::vector<T>> priv(threads - 1, std::vector<T>(nout));
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) {
+        size_t begin = n * t / threads;
+        size_t end = n * (t + 1) / threads;
+        workers.emplace_back(run, begin, end - begin, priv[t - 1].data());
+    }
+    run(0, n / threads, out);
+    for (std::thread& w : workers) w.join();
+    for (const std::vector<T>& p : priv) {
+        for (size_t b = 0; b < nout; ++b) out[b] += p[b];
+    }
+}
+
+} // namespace
+
+void histogram(const uint32_t* idx, size_t n, uint32_t* bins, size_t nbins, unsigned threads) {
+    const KernelTable& k = kernels();
+    threads = thread_count(threads, n, nbins);
+    if (threads <= 1) {
+        k.histogram_u32(idx, n, bins);
+        return;
+    }
+    run_private(n, bins, nbins, threads, [&](size_t begin, size_t count, uint32_t* out) {
+        k.histogram_u32(idx + begin, count, out);
+    });
+}
+
+void scatter_add(const uint32_t* idx, const float* values, size_t n, float* dst, size_t ndst,
+                 unsigned threads) {
+    const KernelTable& k = kernels();
+    threads = thread_count(threads, n, ndst);
+    if (threads <= 1) {
+        k.scatter_add_f32(idx, values, n, dst);
+        return;
+    }
+    run_private(n, dst, ndst, threads, [&](size_t begin, size_t count, float* out) {
+        k.scatter_add_f32(idx + begin, values + begin, count, out);
+    });
+}
+
+} // namespace simd
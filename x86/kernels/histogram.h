@@ -0,0 +1,32 @@
+#ifndef SIMD_HISTOGRAM_H
+#define SIMD_HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+// Histogram: ++bins[idx[i]] for every i < n. Counts are added to what bins
+// already holds, so a histogram can be built over several calls.
+//
+// Every idx[i] must be below nbins, and nbins below 2^31 (the gather and
+// scatter instructions take signed 32-bit indices). Duplicate indices within
+// one vector are detected and combined, so no update is lost.
+//
+// With more than one thread (0: one per hardware thread) every thread but the
+// calling one counts into a private sub-histogram, and the sub-histograms are
+// added into bins at the end. Each thread therefore costs nbins of memory and
+// merge work; inputs with fewer than max(64K, nbins) indices per thread use
+// fewer threads.
+void histogram(const uint32_t* idx, size_t n, uint32_t* bins, size_t nbins, unsigned threads = 0);
+
+// Scatter-add: dst[idx[i]] += values[i] for every i < n, with the same
+// requirements and threading as histogram. Values that hit the same slot are
+// summed in a different order than a scalar loop would, so results can differ
+// in the last bits between levels and thread counts.
+void scatter_add(const uint32_t* idx, const float* values, size_t n, float* dst, size_t ndst,
+                 unsigned threads = 0);
+
+} // namespace simd
+
+#endif // SIMD_HISTOGRAM_H
@@ -0,0 +1,89 @@
+#include "kernels_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512 {
+
+// Gather the bins of 16 indices, add, scatter back. A plain scatter loses
+// updates when two lanes share an index: both read the same old value and the
+// later write wins. vpconflictd (AVX-512CD) gives each lane a bit mask of the
+// earlier lanes with the same index, which is enough to fold all duplicates
+// into the last lane of each group. Scatters write lanes in order, so that
+// last lane, which holds the complete update, is the one that lands.
+
+namespace {
+
+// Population count of 32-bit lanes that are below 2^16. VPOPCNTDQ is not part
+// of the avx512 level, and conflict masks never exceed 15 bits.
+inline __m512i popcnt16(__m512i v) {
+    const __m512i m1 = _mm512_set1_epi32(0x5555);
+    const __m512i m2 = _mm512_set1_epi32(0x3333);
+    const __m512i m4 = _mm512_set1_epi32(0x0F0F);
+    v = _mm512_sub_epi32(v, _mm512_and_si512(_mm512_srli_epi32(v, 1), m1));
+    v = _mm512_add_epi32(_mm512_and_si512(v, m2), _mm512_and_si512(_mm512_srli_epi32(v, 2), m2));
+    v = _mm512_and_si512(_mm512_add_epi32(v, _mm512_srli_epi32(v, 4)), m4);
+    return _mm512_and_si512(_mm512_add_epi32(v, _mm512_srli_epi32(v, 8)), _mm512_set1_epi32(0x1F));
+}
+
+// Lane i of the result is the sum of x over every lane j <= i with the same
+// index. Each duplicate lane points at its nearest earlier duplicate
+// (31 - lzcnt of the conflict mask) and pointer jumping doubles the covered
+// run per step: at most 4 steps for 16 equal indices, none without conflicts.
+inline __m512 combine_duplicates(__m512i conflicts, __m512 x) {
+    __mmask16 dup = _mm512_test_epi32_mask(conflicts, conflicts);
+    if (!dup) return x;
+    __m512i pos = _mm512_sub_epi32(_mm512_set1_epi32(31), _mm512_lzcnt_epi32(conflicts));
+    do {
+        __m512 prev = _mm512_permutexvar_ps(pos, x);
+        __m512i prev_pos = _mm512_permutexvar_epi32(pos, pos);
+        __mmask16 prev_dup = _mm512_movepi32_mask(_mm512_permutexvar_epi32(pos, _mm512_movm_epi32(dup)));
+        x = _mm512_mask_add_ps(x, dup, x, prev);
+        pos = _mm512_mask_mov_epi32(pos, dup, prev_pos);
+        dup &= prev_dup;
+    } while (dup);
+    return x;
+}
+
+} // namespace
+
+void histogram_u32(const uint32_t* idx, size_t n, uint32_t* bins) {
+    const __m512i one = _mm512_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = _mm512_loadu_si512((const void*)(idx + i));
+        // Lane i adds 1 + (number of earlier lanes with its index).
+        __m512i cnt = _mm512_add_epi32(popcnt16(_mm512_conflict_epi32(v)), one);
+        __m512i old = _mm512_i32gather_epi32(v, (const void*)bins, 4);
+        _mm512_i32scatter_epi32((void*)bins, v, _mm512_add_epi32(old, cnt), 4);
+    }
+    if (i < n) {
+        // Lanes past the end load index 0; they only come after the real
+        // lanes, so they never add to a real lane's count, and are not written.
+        __mmask16 m = (__mmask16)_bzhi_u32(0xFFFF, (unsigned)(n - i));
+        __m512i v = _mm512_maskz_loadu_epi32(m, idx + i);
+        __m512i cnt = _mm512_add_epi32(popcnt16(_mm512_conflict_epi32(v)), one);
+        __m512i old = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), m, v, (const void*)bins, 4);
+        _mm512_mask_i32scatter_epi32((void*)bins, m, v, _mm512_add_epi32(old, cnt), 4);
+    }
+}
+
+void scatter_add_f32(const uint32_t* idx, const float* values, size_t n, float* dst) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i v = _mm512_loadu_si512((const void*)(idx + i));
+        __m512 x = combine_duplicates(_mm512_conflict_epi32(v), _mm512_loadu_ps(values + i));
+        __m512 old = _mm512_i32gather_ps(v, dst, 4);
+        _mm512_i32scatter_ps(dst, v, _mm512_add_ps(old, x), 4);
+    }
+    if (i < n) {
+        __mmask16 m = (__mmask16)_bzhi_u32(0xFFFF, (unsigned)(n - i));
+        __m512i v = _mm512_maskz_loadu_epi32(m, idx + i);
+        __m512 x = combine_duplicates(_mm512_maskz_conflict_epi32(m, v), _mm512_maskz_loadu_ps(m, values + i));
+        __m512 old = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), m, v, dst, 4);
+        _mm512_mask_i32scatter_ps(dst, m, v, _mm512_add_ps(old, x), 4);
+    }
+}
+
+} // namespace avx512
+} // namespace simd
@@ -0,0 +1,15 @@
+#include "kernels_internal.h"
+
+namespace simd {
+namespace scalar {
+
+void histogram_u32(const uint32_t* idx, size_t n, uint32_t* bins) {
+    for (size_t i = 0; i < n; ++i) ++bins[idx[i]];
+}
+
+void scatter_add_f32(const uint32_t* idx, const float* values, size_t n, float* dst) {
+    for (size_t i = 0; i < n; ++i) dst[idx[i]] += values[i];
+}
+
+} // namespace scalar
+} // namespace simd
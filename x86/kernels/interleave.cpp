@@ -0,0 +1,44 @@
+#include "interleave.h"
+#include "dispatch.h"
+
+namespace simd {
+
+// int32_t and float only move bits, so they share the 32-bit kernels.
+
+void deinterleave(const uint8_t* aos, size_t n, size_t channels, uint8_t* const* planes) {
+    kernels().deinterleave_u8(aos, n, channels, planes);
+}
+
+void deinterleave(const uint16_t* aos, size_t n, size_t channels, uint16_t* const* planes) {
+    kernels().deinterleave_u16(aos, n, channels, planes);
+}
+
+void deinterleave(const int32_t* aos, size_t n, size_t channels, int32_t* const* planes) {
+    kernels().deinterleave_u32(reinterpret_cast<const uint32_t*>(aos), n, channels,
+                               reinterpret_cast<uint32_t* const*>(planes));
+}
+
+void deinterleave(const float* aos, size_t n, size_t channels, float* const* planes) {
+    kernels().deinterleave_u32(reinterpret_cast<const uint32_t*>(aos), n, channels,
+                               reinterpret_cast<uint32_t* const*>(planes));
+}
+
+void interleave(const uint8_t* const* planes, size_t n, size_t channels, uint8_t* aos) {
+    kernels().interleave_u8(planes, n, channels, aos);
+}
+
+void interleave(const uint16_t* const* planes, size_t n, size_t channels, uint16_t* aos) {
+    kernels().interleave_u16(planes, n, channels, aos);
+}
+
+void interleave(const int32_t* const* planes, size_t n, size_t channels, int32_t* aos) {
+    kernels().interleave_u32(reinterpret_cast<const uint32_t* const*>(planes), n, channels,
+                             reinterpret_cast<uint32_t*>(aos));
+}
+
+void interleave(const float* const* planes, size_t n, size_t channels, float* aos) {
+    kernels().interleave_u32(reinterpret_cast<const uint32_t* const*>(planes), n, channels,
+                             reinterpret_cast<uint32_t*>(aos));
+}
+
+} // namespace simd
@@ -0,0 +1,31 @@
+#ifndef SIMD_INTERLEAVE_H
+#define SIMD_INTERLEAVE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+// Conversion between interleaved records (array of structures) and planar
+// columns (structure of arrays), e.g. RGBRGB... <-> RRR... GGG... BBB...
+//
+// A buffer of n records with `channels` elements each is laid out as
+// aos[r * channels + c]; plane c is planes[c][0..n). Any channel count >= 1
+// works; 2, 3 and 4 channels use the vector kernels. The planes must not
+// overlap each other or the interleaved buffer.
+
+// Interleaved -> planar: planes[c][r] = aos[r * channels + c].
+void deinterleave(const uint8_t* aos, size_t n, size_t channels, uint8_t* const* planes);
+void deinterleave(const uint16_t* aos, size_t n, size_t channels, uint16_t* const* planes);
+void deinterleave(const int32_t* aos, size_t n, size_t channels, int32_t* const* planes);
+void deinterleave(const float* aos, size_t n, size_t channels, float* const* planes);
+
+// Planar -> interleaved: aos[r * channels + c] = planes[c][r].
+void interleave(const uint8_t* const* planes, size_t n, size_t channels, uint8_t* aos);
+void interleave(const uint16_t* const* planes, size_t n, size_t channels, uint16_t* aos);
+void interleave(const int32_t* const* planes, size_t n, size_t channels, int32_t* aos);
+void interleave(const float* const* planes, size_t n, size_t channels, float* aos);
+
+} // namespace simd
+
+#endif // SIMD_INTERLEAVE_H
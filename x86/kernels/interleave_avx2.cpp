@@ -0,0 +1,104 @@
+#include "kernels_internal.h"
+#include "interleave_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx2 {
+
+// vpshufb only shuffles within 128-bit lanes, so the AVX2 kernels run the
+// SSE4.1 scheme on two blocks at once: the low lane holds block A and the high
+// lane the following block B. The planar side is then contiguous (A's L
+// records followed by B's), and only the interleaved side needs split 128-bit
+// loads or stores.
+
+namespace {
+
+inline __m256i load_two(const void* lo, const void* hi) {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)lo)),
+                                   _mm_loadu_si128((const __m128i*)hi), 1);
+}
+
+inline void store_two(void* lo, void* hi, __m256i v) {
+    _mm_storeu_si128((__m128i*)lo, _mm256_castsi256_si128(v));
+    _mm_storeu_si128((__m128i*)hi, _mm256_extracti128_si256(v, 1));
+}
+
+template <size_t C, typename T>
+void deinterleave_loop(const T* aos, size_t n, T* const* planes) {
+    const size_t lanes = 16 / sizeof(T);
+    uint8_t ctrl_bytes[4][4][16];
+    build_deinterleave_shuffles(C, sizeof(T), ctrl_bytes);
+    __m256i ctrl[C][C];
+    for (size_t c = 0; c < C; ++c)
+        for (size_t j = 0; j < C; ++j)
+            ctrl[c][j] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)ctrl_bytes[c][j]));
+
+    size_t r = 0;
+    for (; r + 2 * lanes <= n; r += 2 * lanes) {
+        const T* a = aos + r * C;
+        const T* b = a + lanes * C;
+        __m256i v[C];
+        for (size_t j = 0; j < C; ++j) v[j] = load_two(a + j * lanes, b + j * lanes);
+        for (size_t c = 0; c < C; ++c) {
+            __m256i p = _mm256_shuffle_epi8(v[0], ctrl[c][0]);
+            for (size_t j = 1; j < C; ++j) p = _mm256_or_si256(p, _mm256_shuffle_epi8(v[j], ctrl[c][j]));
+            _mm256_storeu_si256((__m256i*)(planes[c] + r), p);
+        }
+    }
+    deinterleave_scalar_loop(aos, r, n, C, planes);
+}
+
+template <size_t C, typename T>
+void interleave_loop(const T* const* planes, size_t n, T* aos) {
+    const size_t lanes = 16 / sizeof(T);
+    uint8_t ctrl_bytes[4][4][16];
+    build_interleave_shuffles(C, sizeof(T), ctrl_bytes);
+    __m256i ctrl[C][C];
+    for (size_t j = 0; j < C; ++j)
+        for (size_t c = 0; c < C; ++c)
+            ctrl[j][c] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)ctrl_bytes[j][c]));
+
+    size_t r = 0;
+    for (; r + 2 * lanes <= n; r += 2 * lanes) {
+        __m256i v[C];
+        for (size_t c = 0; c < C; ++c) v[c] = _mm256_loadu_si256((const __m256i*)(planes[c] + r));
+        T* a = aos + r * C;
+        T* b = a + lanes * C;
+        for (size_t j = 0; j < C; ++j) {
+            __m256i p = _mm256_shuffle_epi8(v[0], ctrl[j][0]);
+            for (size_t c = 1; c < C; ++c) p = _mm256_or_si256(p, _mm256_shuffle_epi8(v[c], ctrl[j][c]));
+            store_two(a + j * lanes, b + j * lanes, p);
+        }
+    }
+    interleave_scalar_loop(planes, r, n, C, aos);
+}
+
+} // namespace
+
+void deinterleave_u8(const uint8_t* aos, size_t n, size_t channels, uint8_t* const* planes) {
+    SIMD_DEINTERLEAVE_SWITCH(deinterleave_loop, aos, n, channels, planes);
+}
+
+void deinterleave_u16(const uint16_t* aos, size_t n, size_t channels, uint16_t* const* planes) {
+    SIMD_DEINTERLEAVE_SWITCH(deinterleave_loop, aos, n, channels, planes);
+}
+
+void deinterleave_u32(const uint32_t* aos, size_t n, size_t channels, uint32_t* const* planes) {
+    SIMD_DEINTERLEAVE_SWITCH(deinterleave_loop, aos, n, channels, planes);
+}
+
+void interleave_u8(const uint8_t* const* planes, size_t n, size_t channels, uint8_t* aos) {
+    SIMD_INTERLEAVE_SWITCH(interleave_loop, planes, n, channels, aos);
+}
+
+void interleave_u16(const uint16_t* const* planes, size_t n, size_t channels, uint16_t* aos) {
+    SIMD_INTERLEAVE_SWITCH(interleave_loop, planes, n, channels, aos);
+}
+
+void interleave_u32(const uint32_t* const* planes, size_t n, size_t channels, uint32_t* aos) {
+    SIMD_INTERLEAVE_SWITCH(interleave_loop, planes, n, channels, aos);
+}
+
+} // namespace avx2
+} // namespace simd
@@ -0,0 +1,31 @@
+#include "kernels_internal.h"
+#include "interleave_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512 {
+
+// vpermt2w/vpermt2d permute across the whole register and take two sources,
+// so no lane splitting is needed (see deinterleave_permute_loop). Bytes need
+// vpermt2b from VBMI, see interleave_avx512icl.cpp; without it the AVX2
+// kernels are used.
+
+void deinterleave_u16(const uint16_t* aos, size_t n, size_t channels, uint16_t* const* planes) {
+    SIMD_DEINTERLEAVE_SWITCH(deinterleave_permute_loop, aos, n, channels, planes);
+}
+
+void deinterleave_u32(const uint32_t* aos, size_t n, size_t channels, uint32_t* const* planes) {
+    SIMD_DEINTERLEAVE_SWITCH(deinterleave_permute_loop, aos, n, channels, planes);
+}
+
+void interleave_u16(const uint16_t* const* planes, size_t n, size_t channels, uint16_t* aos) {
+    SIMD_INTERLEAVE_SWITCH(interleave_permute_loop, planes, n, channels, aos);
+}
+
+void interleave_u32(const uint32_t* const* planes, size_t n, size_t channels, uint32_t* aos) {
+    SIMD_INTERLEAVE_SWITCH(interleave_permute_loop, planes, n, channels, aos);
+}
+
+} // namespace avx512
+} // namespace simd
@@ -0,0 +1,21 @@
+#include "kernels_internal.h"
+#include "interleave_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512icl {
+
+// VBMI adds vpermt2b, which lets bytes use the same permute kernels as the
+// wider elements in interleave_avx512.cpp.
+
+void deinterleave_u8(const uint8_t* aos, size_t n, size_t channels, uint8_t* const* planes) {
+    SIMD_DEINTERLEAVE_SWITCH(deinterleave_permute_loop, aos, n, channels, planes);
+}
+
+void interleave_u8(const uint8_t* const* planes, size_t n, size_t channels, uint8_t* aos) {
+    SIMD_INTERLEAVE_SWITCH(interleave_permute_loop, planes, n, channels, aos);
+}
+
+} // namespace avx512icl
+} // namespace simd
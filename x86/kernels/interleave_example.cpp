@@ -0,0 +1,137 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include "dispatch.h"
+#include "interleave.h"
+
+// Helper to print a C-style array
+template<typename T>
+void print_array(const char* title, const T* data, int size) {
+    std::cout << title;
+    for (int i = 0; i < size; ++i) {
+        std::cout << +data[i] << (i == size - 1 ? "" : ", ");
+    }
+    std::cout << std::endl;
+}
+
+// Checks one element size of a table against the definition, for 1 to 5
+// channels and every record count up to 200 (all block tails of all widths),
+// then checks that interleave undoes deinterleave.
+template <typename T, typename Split, typename Merge>
+bool check_kernels(Split split, Merge merge) {
+    const size_t max_n = 200, max_c = 5;
+    std::vector<T> aos(max_n * max_c), back(max_n * max_c);
+    std::vector<std::vector<T> > planes(max_c, std::vector<T>(max_n));
+    std::mt19937 rng(42);
+    for (T& x : aos) x = (T)rng();
+
+    for (size_t channels = 1; channels <= max_c; ++channels) {
+        T* plane_ptrs[max_c];
+        const T* const_plane_ptrs[max_c];
+        for (size_t c = 0; c < channels; ++c) {
+            plane_ptrs[c] = planes[c].data();
+            const_plane_ptrs[c] = planes[c].data();
+        }
+        for (size_t n = 0; n <= max_n; ++n) {
+            split(aos.data(), n, channels, plane_ptrs);
+            for (size_t r = 0; r < n; ++r)
+                for (size_t c = 0; c < channels; ++c)
+                    if (planes[c][r] != aos[r * channels + c]) return false;
+            merge(const_plane_ptrs, n, channels, back.data());
+            for (size_t i = 0; i < n * channels; ++i)
+                if (back[i] != aos[i]) return false;
+        }
+    }
+    return true;
+}
+
+bool check_table(const simd::KernelTable& t) {
+    bool ok = true;
+    ok &= check_kernels<uint8_t>(t.deinterleave_u8, t.interleave_u8);
+    ok &= check_kernels<uint16_t>(t.deinterleave_u16, t.interleave_u16);
+    ok &= check_kernels<uint32_t>(t.deinterleave_u32, t.interleave_u32);
+    return ok;
+}
+
+// GB/s of interleaved data converted to planes and back.
+double roundtrip_gbps(const simd::KernelTable& t, std::vector<uint8_t>& rgb, std::vector<uint8_t>* planes) {
+    const size_t pixels = rgb.size() / 3;
+    uint8_t* p[3] = {planes[0].data(), planes[1].data(), planes[2].data()};
+    const uint8_t* cp[3] = {planes[0].data(), planes[1].data(), planes[2].data()};
+    const int reps = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        t.deinterleave_u8(rgb.data(), pixels, 3, p);
+        t.interleave_u8(cp, pixels, 3, rgb.data());
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return 2.0 * rgb.size() * reps / sec / 1e9;
+}
+
+int main() {
+    std::cout << "--- AoS <-> SoA (interleave / deinterleave) ---" << std::endl;
+
+    // =================================================================
+    // 1. Usage: RGB Pixels to Planes and Back
+    // =================================================================
+    std::cout << std::endl << "[1. Usage: RGB Pixels to Planes and Back]" << std::endl;
+    uint8_t rgb[3 * 8];
+    for (int i = 0; i < 8; ++i) {
+        rgb[3 * i + 0] = (uint8_t)(10 + i);
+        rgb[3 * i + 1] = (uint8_t)(20 + i);
+        rgb[3 * i + 2] = (uint8_t)(30 + i);
+    }
+    uint8_t red[8], green[8], blue[8];
+    uint8_t* planes[3] = {red, green, blue};
+    simd::deinterleave(rgb, 8, 3, planes);
+    print_array("rgb:   ", rgb, 24);
+    print_array("red:   ", red, 8);
+    print_array("green: ", green, 8);
+    print_array("blue:  ", blue, 8);
+
+    // Telemetry records {time, x, y, z} to columns.
+    float records[4 * 5];
+    for (int i = 0; i < 20; ++i) records[i] = (float)i;
+    float columns[4][5];
+    float* column_ptrs[4] = {columns[0], columns[1], columns[2], columns[3]};
+    simd::deinterleave(records, 5, 4, column_ptrs);
+    print_array("time:  ", columns[0], 5);
+    print_array("z:     ", columns[3], 5);
+
+    uint8_t merged[3 * 8];
+    const uint8_t* const_planes[3] = {red, green, blue};
+    simd::interleave(const_planes, 8, 3, merged);
+    print_array("back:  ", merged, 24);
+
+    // =================================================================
+    // 2. Cross-check Every Supported Level
+    // =================================================================
+    std::cout << std::endl << "[2. Cross-check Every Supported Level]" << std::endl;
+    static const simd::Isa levels[] = {simd::Isa::Scalar, simd::Isa::SSE41, simd::Isa::AVX,
+                                       simd::Isa::AVX2, simd::Isa::AVX512};
+    bool all_ok = true;
+    for (simd::Isa isa : levels) {
+        if (isa > simd::kernels().isa) break;
+        bool ok = check_table(simd::kernels_for(isa));
+        all_ok &= ok;
+        std::cout << simd::isa_name(isa) << ": " << (ok ? "OK" : "MISMATCH") << std::endl;
+    }
+
+    // =================================================================
+    // 3. Throughput: 1920x1080 RGB Frame, Split and Merged
+    // =================================================================
+    std::cout << std::endl << "[3. Throughput, 1920x1080 RGB frame]" << std::endl;
+    std::vector<uint8_t> frame(1920 * 1080 * 3);
+    std::vector<uint8_t> frame_planes[3];
+    for (int c = 0; c < 3; ++c) frame_planes[c].resize(1920 * 1080);
+    for (size_t i = 0; i < frame.size(); ++i) frame[i] = (uint8_t)i;
+    for (simd::Isa isa : levels) {
+        if (isa > simd::kernels().isa) break;
+        std::cout << simd::isa_name(isa) << ": "
+                  << roundtrip_gbps(simd::kernels_for(isa), frame, frame_planes) << " GB/s" << std::endl;
+    }
+
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+#ifndef SIMD_INTERLEAVE_INTERNAL_H
+#define SIMD_INTERLEAVE_INTERNAL_H
+
+// Helpers shared by the per-ISA interleave kernels. Everything has internal
+// linkage so each translation unit compiles its own copy with its own flags.
+//
+// A "block" is the C vectors that hold exactly one vector's worth of records:
+// with L elements per vector, L records of C channels fill C vectors. The
+// kernels load a block, shuffle it into C planar vectors (or back), and leave
+// the records that do not fill a whole block to the scalar loops below.
+
+#include <cstdint>
+#include <immintrin.h>
+
+namespace simd {
+
+namespace {
+
+template <typename T>
+inline void deinterleave_scalar_loop(const T* aos, size_t first, size_t n, size_t channels,
+                                     T* const* planes) {
+    for (size_t r = first; r < n; ++r) {
+        for (size_t c = 0; c < channels; ++c) {
+            planes[c][r] = aos[r * channels + c];
+        }
+    }
+}
+
+template <typename T>
+inline void interleave_scalar_loop(const T* const* planes, size_t first, size_t n, size_t channels,
+                                   T* aos) {
+    for (size_t r = first; r < n; ++r) {
+        for (size_t c = 0; c < channels; ++c) {
+            aos[r * channels + c] = planes[c][r];
+        }
+    }
+}
+
+// pshufb controls for one 16-byte block of C vectors holding elements of
+// `size` bytes. ctrl[c][j] moves the elements of plane c that live in input
+// vector j to their place in the output and zeroes every other byte (0x80),
+// so a plane is the OR of C shuffles.
+inline void build_deinterleave_shuffles(size_t channels, size_t size, uint8_t ctrl[4][4][16]) {
+    const size_t lanes = 16 / size;
+    for (size_t c = 0; c < channels; ++c)
+        for (size_t j = 0; j < channels; ++j)
+            for (size_t b = 0; b < 16; ++b) ctrl[c][j][b] = 0x80;
+    for (size_t c = 0; c < channels; ++c) {
+        for (size_t r = 0; r < lanes; ++r) {
+            size_t s = r * channels + c; // position of record r, channel c in the block
+            for (size_t b = 0; b < size; ++b) {
+                ctrl[c][s / lanes][r * size + b] = (uint8_t)((s % lanes) * size + b);
+            }
+        }
+    }
+}
+
+// The inverse: ctrl[j][c] moves the elements of plane c that belong in output
+// vector j.
+inline void build_interleave_shuffles(size_t channels, size_t size, uint8_t ctrl[4][4][16]) {
+    const size_t lanes = 16 / size;
+    for (size_t j = 0; j < channels; ++j)
+        for (size_t c = 0; c < channels; ++c)
+            for (size_t b = 0; b < 16; ++b) ctrl[j][c][b] = 0x80;
+    for (size_t s = 0; s < channels * lanes; ++s) {
+        size_t r = s / channels, c = s % channels;
+        for (size_t b = 0; b < size; ++b) {
+            ctrl[s / lanes][c][(s % lanes) * size + b] = (uint8_t)(r * size + b);
+        }
+    }
+}
+
+// vpermt2* indices for one 64-byte block. The C vectors are taken in pairs,
+// (v0, v1) and (v2, v3) (or (v2, v2) for three channels), and both pairs use
+// the same index: element s of the block is lane s mod 2L of pair s / 2L.
+// mask bit r says lane r comes from the second pair.
+template <typename T>
+inline void build_deinterleave_permutes(size_t channels, T idx[4][64 / sizeof(T)], uint64_t mask[4]) {
+    const size_t lanes = 64 / sizeof(T);
+    for (size_t c = 0; c < channels; ++c) {
+        mask[c] = 0;
+        for (size_t r = 0; r < lanes; ++r) {
+            size_t s = r * channels + c;
+            idx[c][r] = (T)(s % (2 * lanes));
+            if (s >= 2 * lanes) mask[c] |= 1ull << r;
+        }
+    }
+}
+
+// The inverse: output vector j gathers from plane pairs (p0, p1) and (p2, p3).
+template <typename T>
+inline void build_interleave_permutes(size_t channels, T idx[4][64 / sizeof(T)], uint64_t mask[4]) {
+    const size_t lanes = 64 / sizeof(T);
+    for (size_t j = 0; j < channels; ++j) {
+        mask[j] = 0;
+        for (size_t l = 0; l < lanes; ++l) {
+            size_t s = j * lanes + l;
+            size_t r = s / channels, c = s % channels;
+            idx[j][l] = (T)(r + (c & 1) * lanes);
+            if (c >= 2) mask[j] |= 1ull << l;
+        }
+    }
+}
+
+#ifdef __AVX512BW__
+// Two-source permute and masked blend for each element size.
+template <typename T> struct Permute512;
+
+template <> struct Permute512<uint32_t> {
+    static __m512i permute(__m512i a, __m512i idx, __m512i b) { return _mm512_permutex2var_epi32(a, idx, b); }
+    static __m512i blend(__m512i a, uint64_t m, __m512i b) { return _mm512_mask_mov_epi32(a, (__mmask16)m, b); }
+};
+
+template <> struct Permute512<uint16_t> {
+    static __m512i permute(__m512i a, __m512i idx, __m512i b) { return _mm512_permutex2var_epi16(a, idx, b); }
+    static __m512i blend(__m512i a, uint64_t m, __m512i b) { return _mm512_mask_mov_epi16(a, (__mmask32)m, b); }
+};
+
+#ifdef __AVX512VBMI__
+template <> struct Permute512<uint8_t> {
+    static __m512i permute(__m512i a, __m512i idx, __m512i b) { return _mm512_permutex2var_epi8(a, idx, b); }
+    static __m512i blend(__m512i a, uint64_t m, __m512i b) { return _mm512_mask_mov_epi8(a, (__mmask64)m, b); }
+};
+#endif
+
+// One block is C full-width vectors. Two channels need one permute per
+// output vector; three and four need two permutes and a blend.
+template <size_t C, typename T>
+void deinterleave_permute_loop(const T* aos, size_t n, T* const* planes) {
+    typedef Permute512<T> P;
+    const size_t lanes = 64 / sizeof(T);
+    T idx_table[4][64 / sizeof(T)];
+    uint64_t mask[4];
+    build_deinterleave_permutes<T>(C, idx_table, mask);
+    __m512i idx[C];
+    for (size_t c = 0; c < C; ++c) idx[c] = _mm512_loadu_si512((const void*)idx_table[c]);
+
+    size_t r = 0;
+    for (; r + lanes <= n; r += lanes) {
+        const T* block = aos + r * C;
+        __m512i v[C];
+        for (size_t j = 0; j < C; ++j) v[j] = _mm512_loadu_si512((const void*)(block + j * lanes));
+        for (size_t c = 0; c < C; ++c) {
+            __m512i p = P::permute(v[0], idx[c], v[1]);
+            if (C > 2) p = P::blend(p, mask[c], P::permute(v[2 % C], idx[c], v[(C - 1) % C]));
+            _mm512_storeu_si512((void*)(planes[c] + r), p);
+        }
+    }
+    deinterleave_scalar_loop(aos, r, n, C, planes);
+}
+
+template <size_t C, typename T>
+void interleave_permute_loop(const T* const* planes, size_t n, T* aos) {
+    typedef Permute512<T> P;
+    const size_t lanes = 64 / sizeof(T);
+    T idx_table[4][64 / sizeof(T)];
+    uint64_t mask[4];
+    build_interleave_permutes<T>(C, idx_table, mask);
+    __m512i idx[C];
+    for (size_t j = 0; j < C; ++j) idx[j] = _mm512_loadu_si512((const void*)idx_table[j]);
+
+    size_t r = 0;
+    for (; r + lanes <= n; r += lanes) {
+        __m512i v[C];
+        for (size_t c = 0; c < C; ++c) v[c] = _mm512_loadu_si512((const void*)(planes[c] + r));
+        T* block = aos + r * C;
+        for (size_t j = 0; j < C; ++j) {
+            __m512i p = P::permute(v[0], idx[j], v[1]);
+            if (C > 2) p = P::blend(p, mask[j], P::permute(v[2 % C], idx[j], v[(C - 1) % C]));
+            _mm512_storeu_si512((void*)(block + j * lanes), p);
+        }
+    }
+    interleave_scalar_loop(planes, r, n, C, aos);
+}
+#endif
+
+} // namespace
+
+// Expands to a switch that instantiates `loop<C>(args...)` for 2, 3 and 4
+// channels and falls back to the scalar loop for any other count.
+#define SIMD_DEINTERLEAVE_SWITCH(loop, aos, n, channels, planes)                 \
+    switch (channels) {                                                          \
+        case 2: return loop<2>(aos, n, planes);                                  \
+        case 3: return loop<3>(aos, n, planes);                                  \
+        case 4: return loop<4>(aos, n, planes);                                  \
+        default: return deinterleave_scalar_loop(aos, 0, n, channels, planes);   \
+    }
+
+#define SIMD_INTERLEAVE_SWITCH(loop, planes, n, channels, aos)                   \
+    switch (channels) {                                                          \
+        case 2: return loop<2>(planes, n, aos);                                  \
+        case 3: return loop<3>(planes, n, aos);                                  \
+        case 4: return loop<4>(planes, n, aos);                                  \
+        default: return interleave_scalar_loop(planes, 0, n, channels, aos);     \
+    }
+
+} // namespace simd
+
+#endif // SIMD_INTERLEAVE_INTERNAL_H
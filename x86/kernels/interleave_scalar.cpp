@@ -0,0 +1,47 @@
+#include "kernels_internal.h"
+#include "interleave_internal.h"
+
+namespace simd {
+namespace scalar {
+
+namespace {
+
+// Fixing the channel count lets the compiler unroll the inner loop.
+template <size_t C, typename T>
+void deinterleave_loop(const T* aos, size_t n, T* const* planes) {
+    deinterleave_scalar_loop(aos, 0, n, C, planes);
+}
+
+template <size_t C, typename T>
+void interleave_loop(const T* const* planes, size_t n, T* aos) {
+    interleave_scalar_loop(planes, 0, n, C, aos);
+}
+
+} // namespace
+
+void deinterleave_u8(const uint8_t* aos, size_t n, size_t channels, uint8_t* const* planes) {
+    SIMD_DEINTERLEAVE_SWITCH(deinterleave_loop, aos, n, channels, planes);
+}
+
+void deinterleave_u16(const uint16_t* aos, size_t n, size_t channels, uint16_t* const* planes) {
+    SIMD_DEINTERLEAVE_SWITCH(deinterleave_loop, aos, n, channels, planes);
+}
+
+void deinterleave_u32(const uint32_t* aos, size_t n, size_t channels, uint32_t* const* planes) {
+    SIMD_DEINTERLEAVE_SWITCH(deinterleave_loop, aos, n, channels, planes);
+}
+
+void interleave_u8(const uint8_t* const* planes, size_t n, size_t channels, uint8_t* aos) {
+    SIMD_INTERLEAVE_SWITCH(interleave_loop, planes, n, channels, aos);
+}
+
+void interleave_u16(const uint16_t* const* planes, size_t n, size_t channels, uint16_t* aos) {
+    SIMD_INTERLEAVE_SWITCH(interleave_loop, planes, n, channels, aos);
+}
+
+void interleave_u32(const uint32_t* const* planes, size_t n, size_t channels, uint32_t* aos) {
+    SIMD_INTERLEAVE_SWITCH(interleave_loop, planes, n, channels, aos);
+}
+
+} // namespace scalar
+} // namespace simd
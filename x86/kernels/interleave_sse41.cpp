@@ -0,0 +1,90 @@
+#include "kernels_internal.h"
+#include "interleave_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace sse41 {
+
+// x86 has no vld3/vst3. pshufb emulates them: every output vector is the OR
+// of C shuffles, one per input vector of the block, each picking the bytes
+// that belong to it and zeroing the rest (see interleave_internal.h). The
+// controls depend only on the element size and channel count and are built
+// once per call.
+
+namespace {
+
+template <size_t C, typename T>
+void deinterleave_loop(const T* aos, size_t n, T* const* planes) {
+    const size_t lanes = 16 / sizeof(T);
+    uint8_t ctrl_bytes[4][4][16];
+    build_deinterleave_shuffles(C, sizeof(T), ctrl_bytes);
+    __m128i ctrl[C][C];
+    for (size_t c = 0; c < C; ++c)
+        for (size_t j = 0; j < C; ++j) ctrl[c][j] = _mm_loadu_si128((const __m128i*)ctrl_bytes[c][j]);
+
+    size_t r = 0;
+    for (; r + lanes <= n; r += lanes) {
+        const T* block = aos + r * C;
+        __m128i v[C];
+        for (size_t j = 0; j < C; ++j) v[j] = _mm_loadu_si128((const __m128i*)(block + j * lanes));
+        for (size_t c = 0; c < C; ++c) {
+            __m128i p = _mm_shuffle_epi8(v[0], ctrl[c][0]);
+            for (size_t j = 1; j < C; ++j) p = _mm_or_si128(p, _mm_shuffle_epi8(v[j], ctrl[c][j]));
+            _mm_storeu_si128((__m128i*)(planes[c] + r), p);
+        }
+    }
+    deinterleave_scalar_loop(aos, r, n, C, planes);
+}
+
+template <size_t C, typename T>
+void interleave_loop(const T* const* planes, size_t n, T* aos) {
+    const size_t lanes = 16 / sizeof(T);
+    uint8_t ctrl_bytes[4][4][16];
+    build_interleave_shuffles(C, sizeof(T), ctrl_bytes);
+    __m128i ctrl[C][C];
+    for (size_t j = 0; j < C; ++j)
+        for (size_t c = 0; c < C; ++c) ctrl[j][c] = _mm_loadu_si128((const __m128i*)ctrl_bytes[j][c]);
+
+    size_t r = 0;
+    for (; r + lanes <= n; r += lanes) {
+        __m128i v[C];
+        for (size_t c = 0; c < C; ++c) v[c] = _mm_loadu_si128((const __m128i*)(planes[c] + r));
+        T* block = aos + r * C;
+        for (size_t j = 0; j < C; ++j) {
+            __m128i p = _mm_shuffle_epi8(v[0], ctrl[j][0]);
+            for (size_t c = 1; c < C; ++c) p = _mm_or_si128(p, _mm_shuffle_epi8(v[c], ctrl[j][c]));
+            _mm_storeu_si128((__m128i*)(block + j * lanes), p);
+        }
+    }
+    interleave_scalar_loop(planes, r, n, C, aos);
+}
+
+} // namespace
+
+void deinterleave_u8(const uint8_t* aos, size_t n, size_t channels, uint8_t* const* planes) {
+    SIMD_DEINTERLEAVE_SWITCH(deinterleave_loop, aos, n, channels, planes);
+}
+
+void deinterleave_u16(const uint16_t* aos, size_t n, size_t channels, uint16_t* const* planes) {
+    SIMD_DEINTERLEAVE_SWITCH(deinterleave_loop, aos, n, channels, planes);
+}
+
+void deinterleave_u32(const uint32_t* aos, size_t n, size_t channels, uint32_t* const* planes) {
+    SIMD_DEINTERLEAVE_SWITCH(deinterleave_loop, aos, n, channels, planes);
+}
+
+void interleave_u8(const uint8_t* const* planes, size_t n, size_t channels, uint8_t* aos) {
+    SIMD_INTERLEAVE_SWITCH(interleave_loop, planes, n, channels, aos);
+}
+
+void interleave_u16(const uint16_t* const* planes, size_t n, size_t channels, uint16_t* aos) {
+    SIMD_INTERLEAVE_SWITCH(interleave_loop, planes, n, channels, aos);
+}
+
+void interleave_u32(const uint32_t* const* planes, size_t n, size_t channels, uint32_t* aos) {
+    SIMD_INTERLEAVE_SWITCH(interleave_loop, planes, n, channels, aos);
+}
+
+} // namespace sse41
+} // namespace simd
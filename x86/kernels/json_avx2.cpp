@@ -0,0 +1,57 @@
+#include "kernels_internal.h"
+#include "json_internal.h"
+#include "safe_load.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx2 {
+
+namespace {
+
+inline uint64_t mask_256(__m256i lo, __m256i hi) {
+    return (uint64_t)(uint32_t)_mm256_movemask_epi8(lo) | (uint64_t)(uint32_t)_mm256_movemask_epi8(hi) << 32;
+}
+
+// Two 32-byte vectors make a block; the quotes take one PCLMUL.
+inline JsonBlock classify(__m256i v0, __m256i v1) {
+    __m256i c0 = json_classes_256(v0), c1 = json_classes_256(v1);
+    __m256i quote = _mm256_set1_epi8('"'), backslash = _mm256_set1_epi8('\\');
+    __m256i space = _mm256_set1_epi8(kJsonSpaceClass), op = _mm256_set1_epi8(kJsonOpClass);
+    __m256i zero = _mm256_setzero_si256(), below = _mm256_set1_epi8(0x1F);
+    JsonBlock b;
+    b.quote = mask_256(_mm256_cmpeq_epi8(v0, quote), _mm256_cmpeq_epi8(v1, quote));
+    b.backslash = mask_256(_mm256_cmpeq_epi8(v0, backslash), _mm256_cmpeq_epi8(v1, backslash));
+    b.space = ~mask_256(_mm256_cmpeq_epi8(_mm256_and_si256(c0, space), zero),
+                        _mm256_cmpeq_epi8(_mm256_and_si256(c1, space), zero));
+    b.op = ~mask_256(_mm256_cmpeq_epi8(_mm256_and_si256(c0, op), zero),
+                     _mm256_cmpeq_epi8(_mm256_and_si256(c1, op), zero));
+    b.control = mask_256(_mm256_cmpeq_epi8(_mm256_min_epu8(v0, below), v0),
+                         _mm256_cmpeq_epi8(_mm256_min_epu8(v1, below), v1));
+    return b;
+}
+
+} // namespace
+
+// Full blocks emit eight positions at a time (json_emit_unrolled). The
+// positions before block i number at most i, so its up to 64 writes stay
+// within the n entries of out; the last, partial block writes exactly.
+size_t json_index(const char* src, size_t n, uint32_t offset, JsonIndexState* state, uint32_t* out) {
+    const uint8_t* s = (const uint8_t*)src;
+    size_t i = 0, k = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i*)(s + i));
+        __m256i v1 = _mm256_loadu_si256((const __m256i*)(s + i + 32));
+        k += json_emit_unrolled(json_structurals(classify(v0, v1), 64, state), offset + (uint32_t)i, out + k);
+    }
+    if (i < n) {
+        size_t r = n - i;
+        __m256i v0 = r >= 32 ? _mm256_loadu_si256((const __m256i*)(s + i)) : load_tail_256(s + i, r);
+        __m256i v1 = r > 32 ? load_tail_256(s + i + 32, r - 32) : _mm256_setzero_si256();
+        k += json_emit(json_structurals(classify(v0, v1), r, state), offset + (uint32_t)i, out + k);
+    }
+    return k;
+}
+
+} // namespace avx2
+} // namespace simd
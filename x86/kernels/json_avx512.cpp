@@ -0,0 +1,59 @@
+#include "kernels_internal.h"
+#include "json_internal.h"
+#include "safe_load.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512 {
+
+namespace {
+
+// One vector is a block, and every mask comes straight out of a compare.
+inline JsonBlock classify(__m512i v) {
+    __m512i cls = json_classes_512(v);
+    JsonBlock b;
+    b.quote = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('"'));
+    b.backslash = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\\'));
+    b.space = _mm512_test_epi8_mask(cls, _mm512_set1_epi8(kJsonSpaceClass));
+    b.op = _mm512_test_epi8_mask(cls, _mm512_set1_epi8(kJsonOpClass));
+    b.control = _mm512_cmple_epu8_mask(v, _mm512_set1_epi8(0x1F));
+    return b;
+}
+
+} // namespace
+
+// vpcompressd packs the byte indices of the structural bits, 16 at a time.
+// Full blocks compress into a register and store the whole vector (see
+// filter_avx512.cpp for why not compress-store); like the AVX2 kernel's
+// writes these stay within out. The last block compress-stores exactly.
+size_t json_index(const char* src, size_t n, uint32_t offset, JsonIndexState* state, uint32_t* out) {
+    const uint8_t* s = (const uint8_t*)src;
+    const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    size_t i = 0, k = 0;
+    for (; i + 64 <= n; i += 64) {
+        uint64_t bits = json_structurals(classify(_mm512_loadu_si512(s + i)), 64, state);
+        __m512i pos = _mm512_add_epi32(lanes, _mm512_set1_epi32((int)(offset + (uint32_t)i)));
+        for (int j = 0; j < 4; ++j) {
+            __mmask16 m = (__mmask16)(bits >> (16 * j));
+            _mm512_storeu_si512(out + k, _mm512_maskz_compress_epi32(m, pos));
+            k += (size_t)_mm_popcnt_u32(m);
+            pos = _mm512_add_epi32(pos, _mm512_set1_epi32(16));
+        }
+    }
+    if (i < n) {
+        size_t r = n - i;
+        uint64_t bits = json_structurals(classify(load_tail_512(s + i, r)), r, state);
+        __m512i pos = _mm512_add_epi32(lanes, _mm512_set1_epi32((int)(offset + (uint32_t)i)));
+        for (int j = 0; j < 4; ++j) {
+            __mmask16 m = (__mmask16)(bits >> (16 * j));
+            _mm512_mask_compressstoreu_epi32(out + k, m, pos);
+            k += (size_t)_mm_popcnt_u32(m);
+            pos = _mm512_add_epi32(pos, _mm512_set1_epi32(16));
+        }
+    }
+    return k;
+}
+
+} // namespace avx512
+} // namespace simd
@@ -0,0 +1,31 @@
+#include "json_index.h"
+#include "dispatch.h"
+
+namespace simd {
+
+bool json_index(const char* src, size_t n, uint32_t* out, size_t* count) {
+    JsonIndexState state = {0, 0, 0, 0};
+    *count = kernels().json_index(src, n, 0, &state, out);
+    return !state.error && !state.in_string;
+}
+
+JsonIndexer::JsonIndexer() : JsonIndexer(kernels()) {}
+
+JsonIndexer::JsonIndexer(const KernelTable& kernels) : kernels_(&kernels), offset_(0) {
+    state_ = JsonIndexState{0, 0, 0, 0};
+}
+
+bool JsonIndexer::update(const char* src, size_t n, uint32_t* out, size_t* written) {
+    *written = kernels_->json_index(src, n, offset_, &state_, out);
+    offset_ += (uint32_t)n;
+    return !state_.error;
+}
+
+bool JsonIndexer::finish() {
+    bool ok = !state_.error && !state_.in_string;
+    state_ = JsonIndexState{0, 0, 0, 0};
+    offset_ = 0;
+    return ok;
+}
+
+} // namespace simd
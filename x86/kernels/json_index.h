@@ -0,0 +1,67 @@
+#ifndef SIMD_JSON_INDEX_H
+#define SIMD_JSON_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+struct KernelTable;
+
+// Stage 1 of a JSON parser, after simdjson (Langdale and Lemire, "Parsing
+// Gigabytes of JSON per Second"): the positions of the bytes a parser has to
+// look at, in order. These are
+//   - { } [ ] : , outside strings,
+//   - the opening quote of every string,
+//   - the first byte of every other value (number, true, false, null),
+// so whitespace and the inside of strings are never visited again. Grammar
+// is left to the parser, and UTF-8 to utf8_validate (utf8.h). Positions are
+// 32-bit: a document or stream is at most 4 GiB. Newline-delimited JSON can
+// be indexed in one call; the newlines are whitespace.
+
+// Writes the positions in src[0, n), at most n of them, to out and sets
+// *count. Returns false, with out and *count still filled in, if a string is
+// left open at the end or holds a byte below 0x20 (which must be escaped).
+bool json_index(const char* src, size_t n, uint32_t* out, size_t* count);
+
+// What the kernels carry from one piece of a document to the next. Zero at
+// the start of a document; bits past the ones named here are always zero.
+struct JsonIndexState {
+    uint64_t in_string;     // all ones while inside a string
+    uint64_t escaped;       // 1 if the next byte follows an odd run of backslashes
+    uint64_t after_scalar;  // 1 if the last byte was part of a number, true, false or null
+    uint64_t error;         // nonzero once a string held a byte below 0x20
+};
+
+// Streaming form, for a document that arrives in pieces of any size. A
+// piece needs no carry bytes: the state above is all that crosses a cut, so
+// the positions are the same as from one call on the whole document.
+//
+//   JsonIndexer ix;
+//   while (size_t got = read(fd, buf, sizeof buf)) {
+//       ix.update(buf, got, pos, &k);   // positions from the start of the stream
+//       ...
+//   }
+//   if (!ix.finish()) return error;
+class JsonIndexer {
+public:
+    JsonIndexer();
+    // With a specific level's kernels, for benchmarks and cross-checking.
+    explicit JsonIndexer(const KernelTable& kernels);
+
+    // Writes at most n positions and sets *written. Returns false once a
+    // string held a byte below 0x20; the positions are still written.
+    bool update(const char* src, size_t n, uint32_t* out, size_t* written);
+    // Whether the stream so far ended outside a string without an error.
+    // Resets the object for a new stream.
+    bool finish();
+
+private:
+    const KernelTable* kernels_;
+    JsonIndexState state_;
+    uint32_t offset_;
+};
+
+} // namespace simd
+
+#endif // SIMD_JSON_INDEX_H
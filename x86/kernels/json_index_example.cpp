@@ -0,0 +1,196 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include "arena.h"
+#include "dispatch.h"
+#include "json_index.h"
+
+namespace {
+
+// Reference indexer: one byte at a time with an explicit state machine,
+// independent of the bit tricks of the kernels. A backslash escapes the next
+// byte anywhere, as in the kernels; outside a string that only matters to a
+// quote, and such input is invalid JSON anyway.
+bool reference_index(const std::string& s, std::vector<uint32_t>* pos) {
+    pos->clear();
+    bool in_string = false, escaped = false, after_scalar = false, error = false;
+    for (size_t i = 0; i < s.size(); ++i) {
+        char c = s[i];
+        bool quote = c == '"' && !escaped;
+        escaped = c == '\\' && !escaped;
+        if (in_string) {
+            if ((uint8_t)c < 0x20) error = true;
+            if (quote) in_string = false;
+            after_scalar = false;
+            continue;
+        }
+        if (std::strchr("{}[]:,", c) && c != '\0') {
+            pos->push_back((uint32_t)i);
+            after_scalar = false;
+        } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            after_scalar = false;
+        } else {
+            if (!after_scalar) pos->push_back((uint32_t)i);
+            after_scalar = !quote;
+            in_string = quote;
+        }
+    }
+    return !error && !in_string;
+}
+
+// Indexing from an input buffer and into an output buffer of exactly n
+// entries that end at guard pages, so any read or write out of bounds faults.
+bool index_guarded(const simd::KernelTable& t, const std::string& s, std::vector<uint32_t>* pos) {
+    simd::GuardedBuffer in(s.size()), buf(s.size() * sizeof(uint32_t));
+    if (!s.empty()) std::memcpy(in.data(), s.data(), s.size());
+    uint32_t* out = (uint32_t*)buf.data();
+    simd::JsonIndexState state = {0, 0, 0, 0};
+    size_t k = t.json_index((const char*)in.data(), s.size(), 0, &state, out);
+    pos->assign(out, out + k);
+    return !state.error && !state.in_string;
+}
+
+// Log records of the kind the indexer is for: one object per line, strings
+// with escapes and non-ASCII, numbers, literals and nesting.
+std::string random_record(std::mt19937& rng) {
+    static const char* const kWords[] = {"GET", "POST", "/api/v1/items", "timeout", "caf\xC3\xA9",
+                                         "\xE6\x97\xA5\xE6\x9C\xAC", "say \\\"hi\\\"", "C:\\\\tmp\\\\", "\\u00e9",
+                                         "tab\\there", "a,b:c", "{[x]}"};
+    std::string s = "{\"ts\":" + std::to_string(1700000000 + rng() % 1000000) + ",\"level\":\"";
+    s += rng() % 4 ? "info" : "error";
+    s += "\",\"msg\":\"";
+    for (int w = (int)(rng() % 6); w >= 0; --w) {
+        s += kWords[rng() % 12];
+        s += ' ';
+    }
+    s += "\", \"tags\": [";
+    for (int j = (int)(rng() % 4); j > 0; --j) s += j % 2 ? "true, " : "null , ";
+    s += std::to_string((int)(rng() % 2000) - 1000) + "." + std::to_string(rng() % 100);
+    s += "], \"ctx\": {\"id\": " + std::to_string(rng()) + ", \"ok\": false}}\n";
+    return s;
+}
+
+std::string random_records(size_t bytes, std::mt19937& rng) {
+    std::string s;
+    while (s.size() < bytes) s += random_record(rng);
+    return s;
+}
+
+// Bytes from the characters that matter, heavy in quotes and backslashes so
+// that runs of every length cross block boundaries.
+std::string random_soup(size_t n, std::mt19937& rng) {
+    static const char kChars[] = "\"\"\"\\\\\\\\{}[]:, \t\n\r0a-\x01\x1F\x80\xFF";
+    std::string s(n, ' ');
+    for (char& c : s) c = kChars[rng() % (sizeof kChars - 1)];
+    return s;
+}
+
+bool check_one(const simd::KernelTable& t, const std::string& s) {
+    std::vector<uint32_t> want, got;
+    bool ok = reference_index(s, &want);
+    return index_guarded(t, s, &got) == ok && got == want;
+}
+
+bool check_index(const simd::KernelTable& t) {
+    // A fixed document with its positions written out by hand.
+    const std::string doc = "{\"a\": [1, true, \"x\\\"y\"], \"b\": null}";
+    const std::vector<uint32_t> want = {0, 1, 4, 6, 7, 8, 10, 14, 16, 22, 23, 25, 28, 30, 34};
+    std::vector<uint32_t> got;
+    if (!index_guarded(t, doc, &got) || got != want) return false;
+
+    std::mt19937 rng(1);
+    for (size_t n = 0; n <= 300; ++n) {
+        if (!check_one(t, random_soup(n, rng))) return false;
+        std::string r = random_records(n, rng);
+        if (!check_one(t, r.substr(0, n))) return false;
+    }
+    for (size_t n : {4096, 4097, 65536 + 33, 100000}) {
+        if (!check_one(t, random_soup(n, rng)) || !check_one(t, random_records(n, rng))) return false;
+    }
+    // A run of 0..130 backslashes before a quote, at every offset in a block.
+    for (size_t run = 0; run <= 130; ++run) {
+        for (size_t at = 0; at < 64; ++at) {
+            std::string s = std::string(at, ' ') + "[\"" + std::string(run, '\\') + "\"] 1";
+            if (!check_one(t, s)) return false;
+        }
+    }
+    // A control byte inside a string is an error, and so is an open string.
+    if (!check_one(t, "[\"a\tb\"]") || index_guarded(t, "[\"a\tb\"]", &got)) return false;
+    if (index_guarded(t, "[\"abc", &got) || !index_guarded(t, "[\"abc\"]\t\n", &got)) return false;
+    return true;
+}
+
+bool check_streaming(const simd::KernelTable& t) {
+    std::mt19937 rng(3);
+    for (int round = 0; round < 200; ++round) {
+        std::string s = round % 2 ? random_soup(rng() % 3000, rng) : random_records(rng() % 3000, rng);
+        std::vector<uint32_t> want;
+        bool valid = reference_index(s, &want);
+
+        simd::JsonIndexer ix(t);
+        std::vector<uint32_t> pos(s.size() + 1);
+        size_t k = 0, got = 0;
+        for (size_t i = 0; i < s.size();) {
+            size_t piece = std::min(s.size() - i, (size_t)(rng() % 150));
+            ix.update(s.data() + i, piece, pos.data() + k, &got);
+            k += got;
+            i += piece;
+        }
+        pos.resize(k);
+        if (ix.finish() != valid || pos != want) return false;
+    }
+    return true;
+}
+
+template <typename F>
+double gb_per_s(size_t bytes, F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 5; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return bytes / best / 1e9;
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    std::vector<simd::Isa> levels;
+    for (simd::Isa isa : {simd::Isa::Scalar, simd::Isa::SSE41, simd::Isa::AVX2, simd::Isa::AVX512}) {
+        if (isa <= simd::detect_isa()) levels.push_back(isa);
+    }
+    for (simd::Isa isa : levels) {
+        const simd::KernelTable& t = simd::kernels_for(isa);
+        bool good = check_index(t) && check_streaming(t);
+        std::cout << std::setw(7) << simd::isa_name(isa) << " JSON structural index vs reference, guarded: "
+                  << (good ? "OK" : "MISMATCH") << std::endl;
+        ok = ok && good;
+    }
+
+    std::mt19937 rng(4);
+    std::string logs = random_records((size_t)1 << 20, rng);
+    std::vector<uint32_t> pos(logs.size());
+    size_t count = 0;
+    std::cout << std::endl << "1 MiB of JSON log records, GB/s:" << std::fixed << std::setprecision(2) << std::endl;
+    for (simd::Isa isa : levels) {
+        const simd::KernelTable& t = simd::kernels_for(isa);
+        double rate = gb_per_s(logs.size(), [&] {
+            simd::JsonIndexState state = {0, 0, 0, 0};
+            count = t.json_index(logs.data(), logs.size(), 0, &state, pos.data());
+        });
+        std::cout << std::setw(7) << simd::isa_name(isa) << std::setw(10) << rate << std::endl;
+    }
+    std::cout << count << " positions, one per " << std::setprecision(1) << (double)logs.size() / count
+              << " bytes" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+#ifndef SIMD_JSON_INTERNAL_H
+#define SIMD_JSON_INTERNAL_H
+
+// Helpers shared by the per-ISA JSON indexing kernels (json_index.h). Each
+// level only turns a 64-byte block into five bit masks, one bit per byte
+// (JsonBlock); everything after that is 64-bit integer arithmetic on the
+// masks, the same at every level and in this header. Like the other
+// *_internal.h helpers it has internal linkage, so each translation unit
+// compiles its own copy with its own flags.
+//
+// From the masks to the positions, per block:
+//   escaped     a byte after an odd run of backslashes. Adding the first
+//               backslash of each run to the backslash mask carries to the
+//               byte after the run; the run is odd when that byte and the
+//               first differ in parity. Even and odd starts are added
+//               separately, and the odd add's carry out of bit 63 is the
+//               escape carried into the next block.
+//   in_string   the prefix XOR of the unescaped quotes: from each opening
+//               quote up to, not including, the closing one. One carry-less
+//               multiply by all ones where the level has PCLMUL (avx2 and
+//               up), six shifts and XORs otherwise.
+//   structural  { } [ ] : , and the first byte of each run of other
+//               non-whitespace bytes (which covers the opening quote),
+//               minus the inside of strings and their closing quote.
+// The classification is two pshufb lookups, on the low and high nibble of
+// each byte, whose AND has a bit for each kind of whitespace or operator.
+
+#include <cstddef>
+#include <cstdint>
+#include "json_index.h"
+
+#if defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace simd {
+
+// Class bits of the nibble lookups: 0x01 space, 0x02 tab, newline and
+// carriage return, 0x04 comma, 0x08 colon, 0x10 brackets, 0x20 braces.
+const uint8_t kJsonSpaceClass = 0x03;
+const uint8_t kJsonOpClass = 0x3C;
+extern const uint8_t kJsonLo[16];
+extern const uint8_t kJsonHi[16];
+
+namespace {
+
+struct JsonBlock {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t space;
+    uint64_t op;
+    uint64_t control;   // bytes below 0x20
+};
+
+const uint64_t kJsonEvenBits = 0x5555555555555555ull;
+
+inline uint64_t json_prefix_xor(uint64_t x) {
+#if defined(__PCLMUL__)
+    return (uint64_t)_mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)x), _mm_set1_epi8(-1), 0));
+#else
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+#endif
+}
+
+// The structural bits of the first r bytes of a block (r in 1..64), whose
+// masks have no bits at or past r except in space and control. Updates the
+// state for the byte after them.
+inline uint64_t json_structurals(const JsonBlock& b, size_t r, JsonIndexState* s) {
+    uint64_t valid = r == 64 ? ~0ull : (1ull << r) - 1;
+    uint64_t space = b.space | ~valid;
+
+    // A backslash that is itself escaped starts no run.
+    uint64_t bs = b.backslash & ~s->escaped;
+    uint64_t starts = bs & ~(bs << 1);
+    uint64_t even_ends = (bs + (starts & kJsonEvenBits)) & ~bs;
+    uint64_t odd_ends = bs + (starts & ~kJsonEvenBits);
+    bool odd_out = odd_ends < bs;
+    odd_ends &= ~bs;
+    uint64_t escaped = (even_ends & ~kJsonEvenBits) | (odd_ends & kJsonEvenBits) | s->escaped;
+    s->escaped = r == 64 ? (uint64_t)odd_out : (escaped >> r) & 1;
+
+    uint64_t quote = b.quote & ~escaped;
+    uint64_t in_string = json_prefix_xor(quote) ^ s->in_string;
+    s->in_string = (uint64_t)((int64_t)in_string >> 63);
+    s->error |= b.control & valid & in_string;
+
+    uint64_t scalar = ~(b.op | space);
+    uint64_t unquoted = scalar & ~quote;
+    uint64_t follows = (unquoted << 1) | s->after_scalar;
+    s->after_scalar = (unquoted >> (r - 1)) & 1;
+    return (b.op | (scalar & ~follows)) & ~(in_string ^ quote);
+}
+
+// out[i] = pos + the index of the i-th set bit; returns the count.
+inline size_t json_emit(uint64_t bits, uint32_t pos, uint32_t* out) {
+    size_t k = 0;
+    for (; bits; bits &= bits - 1) out[k++] = pos + (uint32_t)__builtin_ctzll(bits);
+    return k;
+}
+
+#if defined(__AVX2__)
+// json_emit for a block that may write 64 entries: eight at a time with no
+// branch per bit, as simdjson does. tzcnt of 0 is 64, so the entries past
+// the count are harmless garbage.
+inline size_t json_emit_unrolled(uint64_t bits, uint32_t pos, uint32_t* out) {
+    size_t count = (size_t)_mm_popcnt_u64(bits);
+    for (size_t k = 0; k < count; k += 8) {
+        for (int j = 0; j < 8; ++j) {
+            out[k + j] = pos + (uint32_t)_tzcnt_u64(bits);
+            bits = _blsr_u64(bits);
+        }
+    }
+    return count;
+}
+#endif
+
+#if defined(__SSE4_1__)
+inline uint64_t json_mask_128(__m128i a, __m128i b, __m128i c, __m128i d) {
+    return (uint64_t)(uint16_t)_mm_movemask_epi8(a) | (uint64_t)(uint16_t)_mm_movemask_epi8(b) << 16 |
+           (uint64_t)(uint16_t)_mm_movemask_epi8(c) << 32 | (uint64_t)(uint16_t)_mm_movemask_epi8(d) << 48;
+}
+
+// The class bits of each byte of x; bytes from 0x80 up have none.
+inline __m128i json_classes_128(__m128i x) {
+    __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)kJsonLo), x);
+    __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)kJsonHi),
+                                  _mm_and_si128(_mm_srli_epi16(x, 4), _mm_set1_epi8(0x0F)));
+    return _mm_and_si128(lo, hi);
+}
+#endif
+
+#if defined(__AVX2__)
+inline __m256i json_classes_256(__m256i x) {
+    __m256i lo = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)kJsonLo)), x);
+    __m256i hi = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)kJsonHi)),
+                                     _mm256_and_si256(_mm256_srli_epi16(x, 4), _mm256_set1_epi8(0x0F)));
+    return _mm256_and_si256(lo, hi);
+}
+#endif
+
+#if defined(__AVX512BW__)
+inline __m512i json_classes_512(__m512i x) {
+    __m512i lo = _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)kJsonLo)), x);
+    __m512i hi = _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)kJsonHi)),
+                                     _mm512_and_si512(_mm512_srli_epi16(x, 4), _mm512_set1_epi8(0x0F)));
+    return _mm512_and_si512(lo, hi);
+}
+#endif
+
+} // namespace
+
+} // namespace simd
+
+#endif // SIMD_JSON_INTERNAL_H
@@ -0,0 +1,37 @@
+#include "kernels_internal.h"
+#include "json_internal.h"
+
+namespace simd {
+
+// Low nibble: 0x0 space, 0x9 tab, 0xA newline and colon, 0xB [ {, 0xC comma,
+// 0xD carriage return ] }. High nibble: 0x0 tab, newline, carriage return,
+// 0x2 space and comma, 0x3 colon, 0x5 [ ], 0x7 { }.
+const uint8_t kJsonLo[16] = {0x01, 0, 0, 0, 0, 0, 0, 0, 0, 0x02, 0x0A, 0x30, 0x04, 0x32, 0, 0};
+const uint8_t kJsonHi[16] = {0x02, 0, 0x05, 0x08, 0, 0x10, 0, 0x20, 0, 0, 0, 0, 0, 0, 0, 0};
+
+namespace scalar {
+
+// The masks of a block are built a byte at a time; the rest is the shared
+// integer code, so the scalar level gives the same positions as the others.
+size_t json_index(const char* src, size_t n, uint32_t offset, JsonIndexState* state, uint32_t* out) {
+    const uint8_t* s = (const uint8_t*)src;
+    size_t k = 0;
+    for (size_t i = 0; i < n; i += 64) {
+        size_t r = n - i < 64 ? n - i : 64;
+        JsonBlock b = {0, 0, 0, 0, 0};
+        for (size_t j = 0; j < r; ++j) {
+            uint8_t c = s[i + j];
+            uint8_t cls = kJsonLo[c & 0x0F] & kJsonHi[c >> 4];
+            b.quote |= (uint64_t)(c == '"') << j;
+            b.backslash |= (uint64_t)(c == '\\') << j;
+            b.space |= (uint64_t)((cls & kJsonSpaceClass) != 0) << j;
+            b.op |= (uint64_t)((cls & kJsonOpClass) != 0) << j;
+            b.control |= (uint64_t)(c < 0x20) << j;
+        }
+        k += json_emit(json_structurals(b, r, state), offset + (uint32_t)i, out + k);
+    }
+    return k;
+}
+
+} // namespace scalar
+} // namespace simd
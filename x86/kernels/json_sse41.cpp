@@ -0,0 +1,57 @@
+#include "kernels_internal.h"
+#include "json_internal.h"
+#include "safe_load.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace sse41 {
+
+namespace {
+
+// Four 16-byte vectors make a block. SSE4.1 parts predate PCLMUL, so
+// json_prefix_xor takes the shift path here.
+inline JsonBlock classify(const __m128i (&v)[4]) {
+    __m128i quote[4], backslash[4], other[4], plain[4], control[4];
+    for (int j = 0; j < 4; ++j) {
+        __m128i cls = json_classes_128(v[j]);
+        quote[j] = _mm_cmpeq_epi8(v[j], _mm_set1_epi8('"'));
+        backslash[j] = _mm_cmpeq_epi8(v[j], _mm_set1_epi8('\\'));
+        other[j] = _mm_cmpeq_epi8(_mm_and_si128(cls, _mm_set1_epi8(kJsonSpaceClass)), _mm_setzero_si128());
+        plain[j] = _mm_cmpeq_epi8(_mm_and_si128(cls, _mm_set1_epi8(kJsonOpClass)), _mm_setzero_si128());
+        control[j] = _mm_cmpeq_epi8(_mm_min_epu8(v[j], _mm_set1_epi8(0x1F)), v[j]);
+    }
+    JsonBlock b;
+    b.quote = json_mask_128(quote[0], quote[1], quote[2], quote[3]);
+    b.backslash = json_mask_128(backslash[0], backslash[1], backslash[2], backslash[3]);
+    b.space = ~json_mask_128(other[0], other[1], other[2], other[3]);
+    b.op = ~json_mask_128(plain[0], plain[1], plain[2], plain[3]);
+    b.control = json_mask_128(control[0], control[1], control[2], control[3]);
+    return b;
+}
+
+} // namespace
+
+size_t json_index(const char* src, size_t n, uint32_t offset, JsonIndexState* state, uint32_t* out) {
+    const uint8_t* s = (const uint8_t*)src;
+    size_t i = 0, k = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m128i v[4];
+        for (int j = 0; j < 4; ++j) v[j] = _mm_loadu_si128((const __m128i*)(s + i + 16 * j));
+        k += json_emit(json_structurals(classify(v), 64, state), offset + (uint32_t)i, out + k);
+    }
+    if (i < n) {
+        size_t r = n - i;
+        __m128i v[4];
+        for (size_t j = 0; j < 4; ++j) {
+            size_t m = r > 16 * j ? r - 16 * j : 0;
+            v[j] = m >= 16 ? _mm_loadu_si128((const __m128i*)(s + i + 16 * j))
+                 : m ? load_tail_128(s + i + 16 * j, m) : _mm_setzero_si128();
+        }
+        k += json_emit(json_structurals(classify(v), r, state), offset + (uint32_t)i, out + k);
+    }
+    return k;
+}
+
+} // namespace sse41
+} // namespace simd
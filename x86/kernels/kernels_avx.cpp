@@ -0,0 +1,78 @@
+#include "kernels_internal.h"
+#include "tail_mask.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx {
+
+// The last 1-7 elements go through vmaskmovps (tail_mask.h) rather than a
+// scalar loop: on arrays of a few dozen floats the epilogue would otherwise
+// cost as much as the vector body.
+
+void copy_f32(float* dst, const float* src, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 a = _mm256_loadu_ps(src + i);
+        __m256 b = _mm256_loadu_ps(src + i + 8);
+        _mm256_storeu_ps(dst + i, a);
+        _mm256_storeu_ps(dst + i + 8, b);
+    }
+    if (i + 8 <= n) {
+        _mm256_storeu_ps(dst + i, _mm256_loadu_ps(src + i));
+        i += 8;
+    }
+    if (i < n) {
+        Tail256<float> t(n - i);
+        t.store(dst + i, t.load(src + i));
+    }
+}
+
+void scale_f32(float* dst, const float* src, float a, size_t n) {
+    const __m256 va = _mm256_set1_ps(a);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(va, _mm256_loadu_ps(src + i)));
+    }
+    if (i < n) {
+        Tail256<float> t(n - i);
+        t.store(dst + i, _mm256_mul_ps(va, t.load(src + i)));
+    }
+}
+
+void add_f32(float* dst, const float* x, const float* y, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    }
+    if (i < n) {
+        Tail256<float> t(n - i);
+        t.store(dst + i, _mm256_add_ps(t.load(x + i), t.load(y + i)));
+    }
+}
+
+float sum_f32(const float* src, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(src + i));
+        acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(src + i + 8));
+    }
+    if (i + 8 <= n) {
+        acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(src + i));
+        i += 8;
+    }
+    if (i < n) {
+        // Masked-off lanes load 0.0f and leave the sum unchanged.
+        acc1 = _mm256_add_ps(acc1, Tail256<float>(n - i).load(src + i));
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    lo = _mm_hadd_ps(lo, lo);
+    lo = _mm_hadd_ps(lo, lo);
+    return _mm_cvtss_f32(lo);
+}
+
+} // namespace avx
+} // namespace simd
@@ -0,0 +1,38 @@
+#include "kernels_internal.h"
+#include "tail_mask.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx2 {
+
+// copy/scale/add gain nothing from AVX2 over AVX for floats and are inherited
+// from the AVX level. The sum uses four accumulators: Haswell has two FP add
+// ports with a 3-4 cycle latency, so two chains cannot keep them busy.
+float sum_f32(const float* src, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps();
+    __m256 acc3 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(src + i));
+        acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(src + i + 8));
+        acc2 = _mm256_add_ps(acc2, _mm256_loadu_ps(src + i + 16));
+        acc3 = _mm256_add_ps(acc3, _mm256_loadu_ps(src + i + 24));
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(src + i));
+    }
+    if (i < n) {
+        acc1 = _mm256_add_ps(acc1, Tail256<float>(n - i).load(src + i));
+    }
+    __m256 acc = _mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3));
+    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_movehdup_ps(lo));
+    return _mm_cvtss_f32(lo);
+}
+
+} // namespace avx2
+} // namespace simd
@@ -0,0 +1,75 @@
+#include "kernels_internal.h"
+#include "tail_mask.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512 {
+
+// AVX-512 handles the tail with a mask register instead of a scalar loop:
+// lanes beyond n are neither read nor written, so no fault is possible.
+
+void copy_f32(float* dst, const float* src, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512 a = _mm512_loadu_ps(src + i);
+        __m512 b = _mm512_loadu_ps(src + i + 16);
+        _mm512_storeu_ps(dst + i, a);
+        _mm512_storeu_ps(dst + i + 16, b);
+    }
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(dst + i, _mm512_loadu_ps(src + i));
+    }
+    if (i < n) {
+        Tail512<float> t(n - i);
+        t.store(dst + i, t.load(src + i));
+    }
+}
+
+void scale_f32(float* dst, const float* src, float a, size_t n) {
+    const __m512 va = _mm512_set1_ps(a);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(dst + i, _mm512_mul_ps(va, _mm512_loadu_ps(src + i)));
+    }
+    if (i < n) {
+        Tail512<float> t(n - i);
+        t.store(dst + i, _mm512_mul_ps(va, t.load(src + i)));
+    }
+}
+
+void add_f32(float* dst, const float* x, const float* y, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(dst + i, _mm512_add_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+    }
+    if (i < n) {
+        Tail512<float> t(n - i);
+        t.store(dst + i, _mm512_add_ps(t.load(x + i), t.load(y + i)));
+    }
+}
+
+float sum_f32(const float* src, size_t n) {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    __m512 acc2 = _mm512_setzero_ps();
+    __m512 acc3 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        acc0 = _mm512_add_ps(acc0, _mm512_loadu_ps(src + i));
+        acc1 = _mm512_add_ps(acc1, _mm512_loadu_ps(src + i + 16));
+        acc2 = _mm512_add_ps(acc2, _mm512_loadu_ps(src + i + 32));
+        acc3 = _mm512_add_ps(acc3, _mm512_loadu_ps(src + i + 48));
+    }
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_add_ps(acc0, _mm512_loadu_ps(src + i));
+    }
+    if (i < n) {
+        acc1 = _mm512_add_ps(acc1, Tail512<float>(n - i).load(src + i));
+    }
+    __m512 acc = _mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3));
+    return _mm512_reduce_add_ps(acc);
+}
+
+} // namespace avx512
+} // namespace simd
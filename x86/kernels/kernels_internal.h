@@ -0,0 +1,202 @@
+#ifndef SIMD_KERNELS_INTERNAL_H
+#define SIMD_KERNELS_INTERNAL_H
+
+// Per-ISA kernel entry points. Each namespace is implemented in translation
+// units compiled with that level's -m flags (see CMakeLists.txt) and must only
+// be called through the dispatch table once the level has been detected.
+//
+// Rule for those translation units: do not include headers that instantiate
+// inline or template code (<vector>, <algorithm>, <iostream>, ...). The linker
+// keeps one copy of each inline function, and if it keeps the one compiled
+// with -mavx512f, older CPUs crash in code that was never meant to dispatch.
+// Intrinsics are always_inline and therefore safe.
+
+#include <cstddef>
+#include <cstdint>
+#include "base64.h"
+#include "checksum.h"
+#include "filter.h"
+#include "hash_map.h"
+#include "json_index.h"
+#include "spmv.h"
+
+namespace simd {
+
+namespace scalar {
+void copy_f32(float* dst, const float* src, size_t n);
+void scale_f32(float* dst, const float* src, float a, size_t n);
+void add_f32(float* dst, const float* x, const float* y, size_t n);
+float sum_f32(const float* src, size_t n);
+void copy_bytes(void* dst, const void* src, size_t n, size_t nt_threshold);
+void fill_bytes(void* dst, int value, size_t n, size_t nt_threshold);
+size_t filter_f32(const float* src, size_t n, CmpOp op, float value, float* dst);
+size_t filter_i32(const int32_t* src, size_t n, CmpOp op, int32_t value, int32_t* dst);
+size_t filter_i64(const int64_t* src, size_t n, CmpOp op, int64_t value, int64_t* dst);
+size_t filter_u8(const uint8_t* src, size_t n, CmpOp op, uint8_t value, uint8_t* dst);
+void deinterleave_u8(const uint8_t* aos, size_t n, size_t channels, uint8_t* const* planes);
+void deinterleave_u16(const uint16_t* aos, size_t n, size_t channels, uint16_t* const* planes);
+void deinterleave_u32(const uint32_t* aos, size_t n, size_t channels, uint32_t* const* planes);
+void interleave_u8(const uint8_t* const* planes, size_t n, size_t channels, uint8_t* aos);
+void interleave_u16(const uint16_t* const* planes, size_t n, size_t channels, uint16_t* aos);
+void interleave_u32(const uint32_t* const* planes, size_t n, size_t channels, uint32_t* aos);
+void spmv_f32(const CsrMatrix& a, const float* x, float* y, size_t row_begin, size_t row_end);
+void histogram_u32(const uint32_t* idx, size_t n, uint32_t* bins);
+void scatter_add_f32(const uint32_t* idx, const float* values, size_t n, float* dst);
+void gather_f32(const float* table, const uint32_t* idx, size_t n, float* out, size_t distance);
+void gather_rows_f32(const float* table, size_t dim, const uint32_t* idx, size_t n, float* out, size_t distance);
+void transpose_u32(const uint32_t* src, size_t rows, size_t cols, size_t src_stride, uint32_t* dst,
+                   size_t dst_stride, size_t nt_threshold);
+void radix_partition_u64(const uint64_t* in, size_t n, unsigned shift, unsigned bits, uint64_t* out,
+                         size_t* cursor, uint64_t* buffers, size_t nt_threshold);
+void sort_i32(int32_t* keys, uint32_t* values, size_t n, int32_t* key_tmp, uint32_t* value_tmp);
+void sort_i64(int64_t* keys, uint64_t* values, size_t n, int64_t* key_tmp, uint64_t* value_tmp);
+size_t hash_find_u64(const HashTable& t, const uint64_t* keys, size_t n, uint64_t* values, uint8_t* found);
+size_t hash_insert_u64(HashTable& t, const uint64_t* keys, const uint64_t* values, size_t n, bool add,
+                       uint8_t* inserted);
+void tree_search_u32(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out);
+void base64_encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet);
+bool base64_decode(const char* src, size_t n, uint8_t* dst, Base64 alphabet);
+bool utf8_validate(const char* src, size_t n);
+bool utf8_to_utf16(const char* src, size_t n, char16_t* dst, size_t* written);
+bool utf16_to_utf8(const char16_t* src, size_t n, char* dst, size_t* written);
+size_t json_index(const char* src, size_t n, uint32_t offset, JsonIndexState* state, uint32_t* out);
+uint32_t crc32c(const uint8_t* src, size_t n, uint32_t crc, uint8_t* dst, size_t nt_threshold);
+uint32_t adler32(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst, size_t nt_threshold);
+void hash64_stripes(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes, size_t first,
+                    uint8_t* dst, size_t nt_threshold);
+} // namespace scalar
+
+namespace sse41 {
+void copy_f32(float* dst, const float* src, size_t n);
+void scale_f32(float* dst, const float* src, float a, size_t n);
+void add_f32(float* dst, const float* x, const float* y, size_t n);
+float sum_f32(const float* src, size_t n);
+void copy_bytes(void* dst, const void* src, size_t n, size_t nt_threshold);
+void fill_bytes(void* dst, int value, size_t n, size_t nt_threshold);
+void deinterleave_u8(const uint8_t* aos, size_t n, size_t channels, uint8_t* const* planes);
+void deinterleave_u16(const uint16_t* aos, size_t n, size_t channels, uint16_t* const* planes);
+void deinterleave_u32(const uint32_t* aos, size_t n, size_t channels, uint32_t* const* planes);
+void interleave_u8(const uint8_t* const* planes, size_t n, size_t channels, uint8_t* aos);
+void interleave_u16(const uint16_t* const* planes, size_t n, size_t channels, uint16_t* aos);
+void interleave_u32(const uint32_t* const* planes, size_t n, size_t channels, uint32_t* aos);
+void transpose_u32(const uint32_t* src, size_t rows, size_t cols, size_t src_stride, uint32_t* dst,
+                   size_t dst_stride, size_t nt_threshold);
+void radix_partition_u64(const uint64_t* in, size_t n, unsigned shift, unsigned bits, uint64_t* out,
+                         size_t* cursor, uint64_t* buffers, size_t nt_threshold);
+size_t hash_find_u64(const HashTable& t, const uint64_t* keys, size_t n, uint64_t* values, uint8_t* found);
+size_t hash_insert_u64(HashTable& t, const uint64_t* keys, const uint64_t* values, size_t n, bool add,
+                       uint8_t* inserted);
+void base64_encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet);
+bool base64_decode(const char* src, size_t n, uint8_t* dst, Base64 alphabet);
+bool utf8_validate(const char* src, size_t n);
+bool utf8_to_utf16(const char* src, size_t n, char16_t* dst, size_t* written);
+bool utf16_to_utf8(const char16_t* src, size_t n, char* dst, size_t* written);
+size_t json_index(const char* src, size_t n, uint32_t offset, JsonIndexState* state, uint32_t* out);
+uint32_t adler32(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst, size_t nt_threshold);
+void hash64_stripes(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes, size_t first,
+                    uint8_t* dst, size_t nt_threshold);
+} // namespace sse41
+
+namespace avx {
+void copy_f32(float* dst, const float* src, size_t n);
+void scale_f32(float* dst, const float* src, float a, size_t n);
+void add_f32(float* dst, const float* x, const float* y, size_t n);
+float sum_f32(const float* src, size_t n);
+void copy_bytes(void* dst, const void* src, size_t n, size_t nt_threshold);
+void fill_bytes(void* dst, int value, size_t n, size_t nt_threshold);
+void transpose_u32(const uint32_t* src, size_t rows, size_t cols, size_t src_stride, uint32_t* dst,
+                   size_t dst_stride, size_t nt_threshold);
+} // namespace avx
+
+namespace avx2 {
+float sum_f32(const float* src, size_t n);
+size_t filter_f32(const float* src, size_t n, CmpOp op, float value, float* dst);
+size_t filter_i32(const int32_t* src, size_t n, CmpOp op, int32_t value, int32_t* dst);
+size_t filter_i64(const int64_t* src, size_t n, CmpOp op, int64_t value, int64_t* dst);
+size_t filter_u8(const uint8_t* src, size_t n, CmpOp op, uint8_t value, uint8_t* dst);
+void deinterleave_u8(const uint8_t* aos, size_t n, size_t channels, uint8_t* const* planes);
+void deinterleave_u16(const uint16_t* aos, size_t n, size_t channels, uint16_t* const* planes);
+void deinterleave_u32(const uint32_t* aos, size_t n, size_t channels, uint32_t* const* planes);
+void interleave_u8(const uint8_t* const* planes, size_t n, size_t channels, uint8_t* aos);
+void interleave_u16(const uint16_t* const* planes, size_t n, size_t channels, uint16_t* aos);
+void interleave_u32(const uint32_t* const* planes, size_t n, size_t channels, uint32_t* aos);
+void spmv_f32(const CsrMatrix& a, const float* x, float* y, size_t row_begin, size_t row_end);
+void gather_f32(const float* table, const uint32_t* idx, size_t n, float* out, size_t distance);
+void gather_rows_f32(const float* table, size_t dim, const uint32_t* idx, size_t n, float* out, size_t distance);
+void radix_partition_u64(const uint64_t* in, size_t n, unsigned shift, unsigned bits, uint64_t* out,
+                         size_t* cursor, uint64_t* buffers, size_t nt_threshold);
+void sort_i32(int32_t* keys, uint32_t* values, size_t n, int32_t* key_tmp, uint32_t* value_tmp);
+void sort_i64(int64_t* keys, uint64_t* values, size_t n, int64_t* key_tmp, uint64_t* value_tmp);
+size_t hash_find_u64(const HashTable& t, const uint64_t* keys, size_t n, uint64_t* values, uint8_t* found);
+size_t hash_insert_u64(HashTable& t, const uint64_t* keys, const uint64_t* values, size_t n, bool add,
+                       uint8_t* inserted);
+void tree_search_u32(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out);
+void base64_encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet);
+bool base64_decode(const char* src, size_t n, uint8_t* dst, Base64 alphabet);
+bool utf8_validate(const char* src, size_t n);
+bool utf8_to_utf16(const char* src, size_t n, char16_t* dst, size_t* written);
+bool utf16_to_utf8(const char16_t* src, size_t n, char* dst, size_t* written);
+size_t json_index(const char* src, size_t n, uint32_t offset, JsonIndexState* state, uint32_t* out);
+uint32_t adler32(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst, size_t nt_threshold);
+void hash64_stripes(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes, size_t first,
+                    uint8_t* dst, size_t nt_threshold);
+} // namespace avx2
+
+namespace avx512 {
+void copy_f32(float* dst, const float* src, size_t n);
+void scale_f32(float* dst, const float* src, float a, size_t n);
+void add_f32(float* dst, const float* x, const float* y, size_t n);
+float sum_f32(const float* src, size_t n);
+void copy_bytes(void* dst, const void* src, size_t n, size_t nt_threshold);
+void fill_bytes(void* dst, int value, size_t n, size_t nt_threshold);
+size_t filter_f32(const float* src, size_t n, CmpOp op, float value, float* dst);
+size_t filter_i32(const int32_t* src, size_t n, CmpOp op, int32_t value, int32_t* dst);
+size_t filter_i64(const int64_t* src, size_t n, CmpOp op, int64_t value, int64_t* dst);
+size_t filter_u8(const uint8_t* src, size_t n, CmpOp op, uint8_t value, uint8_t* dst);
+void deinterleave_u16(const uint16_t* aos, size_t n, size_t channels, uint16_t* const* planes);
+void deinterleave_u32(const uint32_t* aos, size_t n, size_t channels, uint32_t* const* planes);
+void interleave_u16(const uint16_t* const* planes, size_t n, size_t channels, uint16_t* aos);
+void interleave_u32(const uint32_t* const* planes, size_t n, size_t channels, uint32_t* aos);
+void spmv_f32(const CsrMatrix& a, const float* x, float* y, size_t row_begin, size_t row_end);
+void histogram_u32(const uint32_t* idx, size_t n, uint32_t* bins);
+void scatter_add_f32(const uint32_t* idx, const float* values, size_t n, float* dst);
+void gather_f32(const float* table, const uint32_t* idx, size_t n, float* out, size_t distance);
+void gather_rows_f32(const float* table, size_t dim, const uint32_t* idx, size_t n, float* out, size_t distance);
+void transpose_u32(const uint32_t* src, size_t rows, size_t cols, size_t src_stride, uint32_t* dst,
+                   size_t dst_stride, size_t nt_threshold);
+void radix_partition_u64(const uint64_t* in, size_t n, unsigned shift, unsigned bits, uint64_t* out,
+                         size_t* cursor, uint64_t* buffers, size_t nt_threshold);
+void sort_i32(int32_t* keys, uint32_t* values, size_t n, int32_t* key_tmp, uint32_t* value_tmp);
+void sort_i64(int64_t* keys, uint64_t* values, size_t n, int64_t* key_tmp, uint64_t* value_tmp);
+size_t hash_find_u64(const HashTable& t, const uint64_t* keys, size_t n, uint64_t* values, uint8_t* found);
+size_t hash_insert_u64(HashTable& t, const uint64_t* keys, const uint64_t* values, size_t n, bool add,
+                       uint8_t* inserted);
+void tree_search_u32(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out);
+bool utf8_validate(const char* src, size_t n);
+bool utf8_to_utf16(const char* src, size_t n, char16_t* dst, size_t* written);
+bool utf16_to_utf8(const char16_t* src, size_t n, char* dst, size_t* written);
+size_t json_index(const char* src, size_t n, uint32_t offset, JsonIndexState* state, uint32_t* out);
+uint32_t adler32(const uint8_t* src, size_t n, uint32_t adler, uint8_t* dst, size_t nt_threshold);
+void hash64_stripes(uint64_t* acc, const uint64_t* key, const uint8_t* src, size_t stripes, size_t first,
+                    uint8_t* dst, size_t nt_threshold);
+} // namespace avx512
+
+// SSE4.2 and PCLMUL, selected per kernel on top of the sse41 level when the
+// CPU reports them.
+namespace sse42 {
+uint32_t crc32c(const uint8_t* src, size_t n, uint32_t crc, uint8_t* dst, size_t nt_threshold);
+} // namespace sse42
+
+// AVX-512 additions of Ice Lake (VBMI, VBMI2), selected per kernel on top of
+// the avx512 level when the CPU reports them.
+namespace avx512icl {
+size_t filter_u8(const uint8_t* src, size_t n, CmpOp op, uint8_t value, uint8_t* dst);
+void deinterleave_u8(const uint8_t* aos, size_t n, size_t channels, uint8_t* const* planes);
+void interleave_u8(const uint8_t* const* planes, size_t n, size_t channels, uint8_t* aos);
+void base64_encode(const uint8_t* src, size_t n, char* dst, Base64 alphabet);
+bool base64_decode(const char* src, size_t n, uint8_t* dst, Base64 alphabet);
+} // namespace avx512icl
+
+} // namespace simd
+
+#endif // SIMD_KERNELS_INTERNAL_H
@@ -0,0 +1,25 @@
+#include "kernels_internal.h"
+
+namespace simd {
+namespace scalar {
+
+void copy_f32(float* dst, const float* src, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] = src[i];
+}
+
+void scale_f32(float* dst, const float* src, float a, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] = a * src[i];
+}
+
+void add_f32(float* dst, const float* x, const float* y, size_t n) {
+    for (size_t i = 0; i < n; ++i) dst[i] = x[i] + y[i];
+}
+
+float sum_f32(const float* src, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) sum += src[i];
+    return sum;
+}
+
+} // namespace scalar
+} // namespace simd
@@ -0,0 +1,54 @@
+#include "kernels_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace sse41 {
+
+void copy_f32(float* dst, const float* src, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128 a = _mm_loadu_ps(src + i);
+        __m128 b = _mm_loadu_ps(src + i + 4);
+        _mm_storeu_ps(dst + i, a);
+        _mm_storeu_ps(dst + i + 4, b);
+    }
+    for (; i < n; ++i) dst[i] = src[i];
+}
+
+void scale_f32(float* dst, const float* src, float a, size_t n) {
+    const __m128 va = _mm_set1_ps(a);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_mul_ps(va, _mm_loadu_ps(src + i)));
+    }
+    for (; i < n; ++i) dst[i] = a * src[i];
+}
+
+void add_f32(float* dst, const float* x, const float* y, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+    }
+    for (; i < n; ++i) dst[i] = x[i] + y[i];
+}
+
+float sum_f32(const float* src, size_t n) {
+    // Two accumulators hide the latency of addps.
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_loadu_ps(src + i));
+        acc1 = _mm_add_ps(acc1, _mm_loadu_ps(src + i + 4));
+    }
+    __m128 acc = _mm_add_ps(acc0, acc1);
+    acc = _mm_hadd_ps(acc, acc);
+    acc = _mm_hadd_ps(acc, acc);
+    float sum = _mm_cvtss_f32(acc);
+    for (; i < n; ++i) sum += src[i];
+    return sum;
+}
+
+} // namespace sse41
+} // namespace simd
@@ -0,0 +1,41 @@
+#include "memops.h"
+#include "cpu_features.h"
+#include "dispatch.h"
+
+#include <atomic>
+
+namespace simd {
+
+namespace {
+
+size_t default_nt_threshold() {
+    size_t llc = cpu_features().llc_bytes;
+    return llc ? llc / 2 : (size_t)4 << 20;
+}
+
+std::atomic<size_t>& threshold_storage() {
+    static std::atomic<size_t> threshold(default_nt_threshold());
+    return threshold;
+}
+
+} // namespace
+
+size_t nt_threshold() {
+    return threshold_storage().load(std::memory_order_relaxed);
+}
+
+void set_nt_threshold(size_t bytes) {
+    threshold_storage().store(bytes, std::memory_order_relaxed);
+}
+
+void* simd_memcpy(void* dst, const void* src, size_t n) {
+    kernels().copy_bytes(dst, src, n, nt_threshold());
+    return dst;
+}
+
+void* simd_memset(void* dst, int value, size_t n) {
+    kernels().fill_bytes(dst, value, n, nt_threshold());
+    return dst;
+}
+
+} // namespace simd
@@ -0,0 +1,35 @@
+#ifndef SIMD_MEMOPS_H
+#define SIMD_MEMOPS_H
+
+#include <cstddef>
+
+namespace simd {
+
+// Bulk memory copy and fill for large buffers.
+//
+// Below the non-temporal threshold the kernels behave like a regular memcpy:
+// unaligned loads, aligned stores into the cache. At or above it the body is
+// written with streaming stores (movntdq / vmovntdq), which go to DRAM through
+// the write-combining buffers without evicting the working set of whatever
+// else runs on the socket. The function issues an sfence before returning, so
+// the data is ordered before any later store (e.g. a flag that publishes the
+// buffer to another thread).
+//
+// Misaligned heads and tails are written with one unaligned vector each; the
+// body between them is aligned on the destination.
+
+// Copies n bytes from src to dst. The buffers must not overlap.
+void* simd_memcpy(void* dst, const void* src, size_t n);
+
+// Sets n bytes of dst to (unsigned char)value.
+void* simd_memset(void* dst, int value, size_t n);
+
+// Size in bytes from which simd_memcpy/simd_memset use streaming stores.
+// Defaults to half of the detected last-level cache (4 MiB if unknown): a
+// copy that large would evict most of the LLC anyway. Override it per SKU.
+size_t nt_threshold();
+void set_nt_threshold(size_t bytes);
+
+} // namespace simd
+
+#endif // SIMD_MEMOPS_H
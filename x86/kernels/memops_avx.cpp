@@ -0,0 +1,112 @@
+#include "kernels_internal.h"
+#include "memops_small.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx {
+
+namespace {
+
+template <bool kStream>
+inline void store_vec(unsigned char* p, __m256i v) {
+    if (kStream) _mm256_stream_si256((__m256i*)p, v);
+    else         _mm256_store_si256((__m256i*)p, v);
+}
+
+// Copies `count` 32-byte vectors to a 32-byte aligned destination.
+template <bool kStream>
+void copy_body(unsigned char* d, const unsigned char* s, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(s + 32 * i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(s + 32 * i + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i*)(s + 32 * i + 64));
+        __m256i e = _mm256_loadu_si256((const __m256i*)(s + 32 * i + 96));
+        store_vec<kStream>(d + 32 * i, a);
+        store_vec<kStream>(d + 32 * i + 32, b);
+        store_vec<kStream>(d + 32 * i + 64, c);
+        store_vec<kStream>(d + 32 * i + 96, e);
+    }
+    for (; i < count; ++i) {
+        store_vec<kStream>(d + 32 * i, _mm256_loadu_si256((const __m256i*)(s + 32 * i)));
+    }
+}
+
+template <bool kStream>
+void fill_body(unsigned char* d, __m256i v, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        store_vec<kStream>(d + 32 * i, v);
+        store_vec<kStream>(d + 32 * i + 32, v);
+        store_vec<kStream>(d + 32 * i + 64, v);
+        store_vec<kStream>(d + 32 * i + 96, v);
+    }
+    for (; i < count; ++i) store_vec<kStream>(d + 32 * i, v);
+}
+
+} // namespace
+
+void copy_bytes(void* dst, const void* src, size_t n, size_t nt_threshold) {
+    unsigned char* d = (unsigned char*)dst;
+    const unsigned char* s = (const unsigned char*)src;
+    if (n <= 16) {
+        copy_small_bytes(d, s, n);
+        return;
+    }
+    if (n <= 32) {
+        __m128i a = _mm_loadu_si128((const __m128i*)s);
+        __m128i b = _mm_loadu_si128((const __m128i*)(s + n - 16));
+        _mm_storeu_si128((__m128i*)d, a);
+        _mm_storeu_si128((__m128i*)(d + n - 16), b);
+        return;
+    }
+    __m256i head = _mm256_loadu_si256((const __m256i*)s);
+    __m256i tail = _mm256_loadu_si256((const __m256i*)(s + n - 32));
+    if (n <= 64) {
+        _mm256_storeu_si256((__m256i*)d, head);
+        _mm256_storeu_si256((__m256i*)(d + n - 32), tail);
+        return;
+    }
+
+    size_t skew = 32 - ((uintptr_t)d & 31);
+    size_t count = (n - skew) / 32;
+    _mm256_storeu_si256((__m256i*)d, head);
+    if (n >= nt_threshold) {
+        copy_body<true>(d + skew, s + skew, count);
+        _mm_sfence();
+    } else {
+        copy_body<false>(d + skew, s + skew, count);
+    }
+    _mm256_storeu_si256((__m256i*)(d + n - 32), tail);
+}
+
+void fill_bytes(void* dst, int value, size_t n, size_t nt_threshold) {
+    unsigned char* d = (unsigned char*)dst;
+    if (n <= 16) {
+        fill_small_bytes(d, (unsigned char)value, n);
+        return;
+    }
+    if (n <= 32) {
+        __m128i v = _mm_set1_epi8((char)value);
+        _mm_storeu_si128((__m128i*)d, v);
+        _mm_storeu_si128((__m128i*)(d + n - 16), v);
+        return;
+    }
+    __m256i v = _mm256_set1_epi8((char)value);
+    _mm256_storeu_si256((__m256i*)d, v);
+    _mm256_storeu_si256((__m256i*)(d + n - 32), v);
+    if (n <= 64) return;
+
+    size_t skew = 32 - ((uintptr_t)d & 31);
+    size_t count = (n - skew) / 32;
+    if (n >= nt_threshold) {
+        fill_body<true>(d + skew, v, count);
+        _mm_sfence();
+    } else {
+        fill_body<false>(d + skew, v, count);
+    }
+}
+
+} // namespace avx
+} // namespace simd
@@ -0,0 +1,103 @@
+#include "kernels_internal.h"
+
+#include <cstdint>
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512 {
+
+namespace {
+
+template <bool kStream>
+inline void store_vec(unsigned char* p, __m512i v) {
+    if (kStream) _mm512_stream_si512((__m512i*)p, v);
+    else         _mm512_store_si512((void*)p, v);
+}
+
+// Copies `count` 64-byte vectors (one cache line each) to a 64-byte aligned
+// destination, so every streaming store fills a whole write-combining buffer.
+template <bool kStream>
+void copy_body(unsigned char* d, const unsigned char* s, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m512i a = _mm512_loadu_si512((const void*)(s + 64 * i));
+        __m512i b = _mm512_loadu_si512((const void*)(s + 64 * i + 64));
+        __m512i c = _mm512_loadu_si512((const void*)(s + 64 * i + 128));
+        __m512i e = _mm512_loadu_si512((const void*)(s + 64 * i + 192));
+        store_vec<kStream>(d + 64 * i, a);
+        store_vec<kStream>(d + 64 * i + 64, b);
+        store_vec<kStream>(d + 64 * i + 128, c);
+        store_vec<kStream>(d + 64 * i + 192, e);
+    }
+    for (; i < count; ++i) {
+        store_vec<kStream>(d + 64 * i, _mm512_loadu_si512((const void*)(s + 64 * i)));
+    }
+}
+
+template <bool kStream>
+void fill_body(unsigned char* d, __m512i v, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        store_vec<kStream>(d + 64 * i, v);
+        store_vec<kStream>(d + 64 * i + 64, v);
+        store_vec<kStream>(d + 64 * i + 128, v);
+        store_vec<kStream>(d + 64 * i + 192, v);
+    }
+    for (; i < count; ++i) store_vec<kStream>(d + 64 * i, v);
+}
+
+} // namespace
+
+void copy_bytes(void* dst, const void* src, size_t n, size_t nt_threshold) {
+    unsigned char* d = (unsigned char*)dst;
+    const unsigned char* s = (const unsigned char*)src;
+    if (n <= 64) {
+        // One masked byte move replaces the whole small-size ladder.
+        // BZHI leaves all 64 bits set when n == 64.
+        __mmask64 k = _bzhi_u64(~0ull, (unsigned int)n);
+        _mm512_mask_storeu_epi8(d, k, _mm512_maskz_loadu_epi8(k, s));
+        return;
+    }
+    __m512i head = _mm512_loadu_si512((const void*)s);
+    __m512i tail = _mm512_loadu_si512((const void*)(s + n - 64));
+    if (n <= 128) {
+        _mm512_storeu_si512((void*)d, head);
+        _mm512_storeu_si512((void*)(d + n - 64), tail);
+        return;
+    }
+
+    size_t skew = 64 - ((uintptr_t)d & 63);
+    size_t count = (n - skew) / 64;
+    _mm512_storeu_si512((void*)d, head);
+    if (n >= nt_threshold) {
+        copy_body<true>(d + skew, s + skew, count);
+        _mm_sfence();
+    } else {
+        copy_body<false>(d + skew, s + skew, count);
+    }
+    _mm512_storeu_si512((void*)(d + n - 64), tail);
+}
+
+void fill_bytes(void* dst, int value, size_t n, size_t nt_threshold) {
+    unsigned char* d = (unsigned char*)dst;
+    __m512i v = _mm512_set1_epi8((char)value);
+    if (n <= 64) {
+        _mm512_mask_storeu_epi8(d, _bzhi_u64(~0ull, (unsigned int)n), v);
+        return;
+    }
+    _mm512_storeu_si512((void*)d, v);
+    _mm512_storeu_si512((void*)(d + n - 64), v);
+    if (n <= 128) return;
+
+    size_t skew = 64 - ((uintptr_t)d & 63);
+    size_t count = (n - skew) / 64;
+    if (n >= nt_threshold) {
+        fill_body<true>(d + skew, v, count);
+        _mm_sfence();
+    } else {
+        fill_body<false>(d + skew, v, count);
+    }
+}
+
+} // namespace avx512
+} // namespace simd
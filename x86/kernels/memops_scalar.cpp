@@ -0,0 +1,19 @@
+#include "kernels_internal.h"
+
+#include <cstring>
+
+namespace simd {
+namespace scalar {
+
+// The C library already picks a good strategy for the CPU; the threshold is
+// only honoured by the vector levels.
+void copy_bytes(void* dst, const void* src, size_t n, size_t) {
+    std::memcpy(dst, src, n);
+}
+
+void fill_bytes(void* dst, int value, size_t n, size_t) {
+    std::memset(dst, value, n);
+}
+
+} // namespace scalar
+} // namespace simd
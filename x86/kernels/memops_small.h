@@ -0,0 +1,55 @@
+#ifndef SIMD_MEMOPS_SMALL_H
+#define SIMD_MEMOPS_SMALL_H
+
+// Copy/fill of at most 16 bytes with two overlapping scalar moves, shared by
+// the SSE4.1 and AVX memops. The functions are static so every per-ISA
+// translation unit gets its own copy compiled with its own flags.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+static inline void copy_small_bytes(unsigned char* d, const unsigned char* s, size_t n) {
+    if (n >= 8) {
+        uint64_t a, b;
+        __builtin_memcpy(&a, s, 8);
+        __builtin_memcpy(&b, s + n - 8, 8);
+        __builtin_memcpy(d, &a, 8);
+        __builtin_memcpy(d + n - 8, &b, 8);
+    } else if (n >= 4) {
+        uint32_t a, b;
+        __builtin_memcpy(&a, s, 4);
+        __builtin_memcpy(&b, s + n - 4, 4);
+        __builtin_memcpy(d, &a, 4);
+        __builtin_memcpy(d + n - 4, &b, 4);
+    } else if (n >= 2) {
+        uint16_t a, b;
+        __builtin_memcpy(&a, s, 2);
+        __builtin_memcpy(&b, s + n - 2, 2);
+        __builtin_memcpy(d, &a, 2);
+        __builtin_memcpy(d + n - 2, &b, 2);
+    } else if (n == 1) {
+        d[0] = s[0];
+    }
+}
+
+static inline void fill_small_bytes(unsigned char* d, unsigned char value, size_t n) {
+    uint64_t v = 0x0101010101010101ull * value;
+    if (n >= 8) {
+        __builtin_memcpy(d, &v, 8);
+        __builtin_memcpy(d + n - 8, &v, 8);
+    } else if (n >= 4) {
+        __builtin_memcpy(d, &v, 4);
+        __builtin_memcpy(d + n - 4, &v, 4);
+    } else if (n >= 2) {
+        __builtin_memcpy(d, &v, 2);
+        __builtin_memcpy(d + n - 2, &v, 2);
+    } else if (n == 1) {
+        d[0] = value;
+    }
+}
+
+} // namespace simd
+
+#endif // SIMD_MEMOPS_SMALL_H
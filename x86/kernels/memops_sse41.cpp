@@ -0,0 +1,101 @@
+#include "kernels_internal.h"
+#include "memops_small.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace sse41 {
+
+namespace {
+
+template <bool kStream>
+inline void store_vec(unsigned char* p, __m128i v) {
+    if (kStream) _mm_stream_si128((__m128i*)p, v);
+    else         _mm_store_si128((__m128i*)p, v);
+}
+
+// Copies `count` 16-byte vectors to a 16-byte aligned destination.
+template <bool kStream>
+void copy_body(unsigned char* d, const unsigned char* s, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(s + 16 * i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(s + 16 * i + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(s + 16 * i + 32));
+        __m128i e = _mm_loadu_si128((const __m128i*)(s + 16 * i + 48));
+        store_vec<kStream>(d + 16 * i, a);
+        store_vec<kStream>(d + 16 * i + 16, b);
+        store_vec<kStream>(d + 16 * i + 32, c);
+        store_vec<kStream>(d + 16 * i + 48, e);
+    }
+    for (; i < count; ++i) {
+        store_vec<kStream>(d + 16 * i, _mm_loadu_si128((const __m128i*)(s + 16 * i)));
+    }
+}
+
+template <bool kStream>
+void fill_body(unsigned char* d, __m128i v, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        store_vec<kStream>(d + 16 * i, v);
+        store_vec<kStream>(d + 16 * i + 16, v);
+        store_vec<kStream>(d + 16 * i + 32, v);
+        store_vec<kStream>(d + 16 * i + 48, v);
+    }
+    for (; i < count; ++i) store_vec<kStream>(d + 16 * i, v);
+}
+
+} // namespace
+
+void copy_bytes(void* dst, const void* src, size_t n, size_t nt_threshold) {
+    unsigned char* d = (unsigned char*)dst;
+    const unsigned char* s = (const unsigned char*)src;
+    if (n <= 16) {
+        copy_small_bytes(d, s, n);
+        return;
+    }
+    __m128i head = _mm_loadu_si128((const __m128i*)s);
+    __m128i tail = _mm_loadu_si128((const __m128i*)(s + n - 16));
+    if (n <= 32) {
+        _mm_storeu_si128((__m128i*)d, head);
+        _mm_storeu_si128((__m128i*)(d + n - 16), tail);
+        return;
+    }
+
+    // The unaligned head covers [0, skew); the body starts on a 16-byte
+    // boundary of dst; the unaligned tail covers whatever the body leaves.
+    size_t skew = 16 - ((uintptr_t)d & 15);
+    size_t count = (n - skew) / 16;
+    _mm_storeu_si128((__m128i*)d, head);
+    if (n >= nt_threshold) {
+        copy_body<true>(d + skew, s + skew, count);
+        _mm_sfence();
+    } else {
+        copy_body<false>(d + skew, s + skew, count);
+    }
+    _mm_storeu_si128((__m128i*)(d + n - 16), tail);
+}
+
+void fill_bytes(void* dst, int value, size_t n, size_t nt_threshold) {
+    unsigned char* d = (unsigned char*)dst;
+    if (n <= 16) {
+        fill_small_bytes(d, (unsigned char)value, n);
+        return;
+    }
+    __m128i v = _mm_set1_epi8((char)value);
+    _mm_storeu_si128((__m128i*)d, v);
+    _mm_storeu_si128((__m128i*)(d + n - 16), v);
+    if (n <= 32) return;
+
+    size_t skew = 16 - ((uintptr_t)d & 15);
+    size_t count = (n - skew) / 16;
+    if (n >= nt_threshold) {
+        fill_body<true>(d + skew, v, count);
+        _mm_sfence();
+    } else {
+        fill_body<false>(d + skew, v, count);
+    }
+}
+
+} // namespace sse41
+} // namespace simd
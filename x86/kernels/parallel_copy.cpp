@@ -0,0 +1,296 @@
+#include "parallel_copy.h"
+#include "arena.h"
+#include "dispatch.h"
+#include "memops.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <cstdlib>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace simd {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Below this per worker, starting and pinning threads costs more than the copy.
+const size_t kMinBytesPerThread = (size_t)1 << 20;
+// Shares are cut at 2 MiB boundaries once each gets at least this many huge
+// pages, so that no huge page is split between two nodes.
+const size_t kMinHugePagesPerShare = 8;
+
+// "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}
+std::vector<int> parse_list(const std::string& s) {
+    std::vector<int> out;
+    std::stringstream in(s);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        if (range.empty() || range[0] < '0' || range[0] > '9') continue;
+        int lo = std::atoi(range.c_str());
+        size_t dash = range.find('-');
+        int hi = dash == std::string::npos ? lo : std::atoi(range.c_str() + dash + 1);
+        for (int i = lo; i <= hi; ++i) out.push_back(i);
+    }
+    return out;
+}
+
+std::string read_line(const std::string& path) {
+    std::ifstream f(path);
+    std::string line;
+    std::getline(f, line);
+    return line;
+}
+
+NumaTopology read_topology() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned c = 0; c < hw && c < CPU_SETSIZE; ++c) CPU_SET(c, &allowed);
+    }
+
+    NumaTopology t;
+    for (int node : parse_list(read_line("/sys/devices/system/node/online"))) {
+        std::vector<int> cpus;
+        std::string list = read_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        for (int c : parse_list(list)) {
+            if (c < CPU_SETSIZE && CPU_ISSET(c, &allowed)) cpus.push_back(c);
+        }
+        t.nodes.push_back(node);
+        t.cpus.push_back(cpus);
+    }
+    bool any = false;
+    for (const std::vector<int>& c : t.cpus) any |= !c.empty();
+    if (!any) {
+        t.nodes.assign(1, 0);
+        t.cpus.assign(1, std::vector<int>());
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &allowed)) t.cpus[0].push_back(c);
+        }
+    }
+    return t;
+}
+
+// Who does what: worker w handles [bounds[w], bounds[w + 1]) on `cpu[w]`
+// (-1: not pinned), which belongs to node `node[w]` (index into the topology).
+struct Plan {
+    unsigned threads;
+    std::vector<size_t> bounds;
+    std::vector<int> cpu;
+    std::vector<int> node;
+};
+
+Plan make_plan(const void* dst, size_t n, const ParallelOptions& opt) {
+    const NumaTopology& topo = numa_topology();
+    std::vector<int> usable;  // topology indices of nodes with CPUs
+    size_t cpus = 0;
+    for (size_t i = 0; i < topo.nodes.size(); ++i) {
+        if (!topo.cpus[i].empty()) usable.push_back((int)i);
+        cpus += topo.cpus[i].size();
+    }
+
+    Plan plan;
+    plan.threads = opt.threads ? opt.threads : (unsigned)std::max<size_t>(1, cpus);
+    plan.threads = (unsigned)std::min<size_t>(plan.threads, std::max<size_t>(1, n / kMinBytesPerThread));
+
+    size_t grain = n / plan.threads >= kMinHugePagesPerShare * kHugePageSize ? kHugePageSize : kPageSize;
+    uintptr_t base = reinterpret_cast<uintptr_t>(dst);
+    plan.bounds.push_back(0);
+    for (unsigned w = 1; w < plan.threads; ++w) {
+        uintptr_t cut = (base + n / plan.threads * w + grain - 1) & ~(uintptr_t)(grain - 1);
+        plan.bounds.push_back(std::min<size_t>(cut - base, n));
+    }
+    plan.bounds.push_back(n);
+
+    for (unsigned w = 0; w < plan.threads; ++w) {
+        if (!opt.pin || usable.empty()) {
+            plan.cpu.push_back(-1);
+            plan.node.push_back(-1);
+            continue;
+        }
+        int node = usable[w % usable.size()];
+        const std::vector<int>& list = topo.cpus[node];
+        plan.cpu.push_back(list[(w / usable.size()) % list.size()]);
+        plan.node.push_back(node);
+    }
+    return plan;
+}
+
+void pin_to(int cpu) {
+    if (cpu < 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+// Runs body(w, begin, end) on one pinned thread per worker. The calling thread
+// only starts and joins them, so its own affinity is left alone. The clock
+// starts once every worker is pinned and waiting; `bytes_per_byte` is the
+// traffic per byte of the buffer (2 for copies, 1 for fills).
+template <typename F>
+void run_plan(const Plan& plan, size_t bytes_per_byte, TransferStats* stats, F body) {
+    std::atomic<unsigned> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<Clock::time_point> end(plan.threads);
+    std::vector<std::thread> workers;
+    workers.reserve(plan.threads);
+    for (unsigned w = 0; w < plan.threads; ++w) {
+        workers.emplace_back([&, w] {
+            pin_to(plan.cpu[w]);
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            if (plan.bounds[w + 1] > plan.bounds[w]) body(w, plan.bounds[w], plan.bounds[w + 1]);
+            end[w] = Clock::now();
+        });
+    }
+    while (ready.load() < plan.threads) std::this_thread::yield();
+    Clock::time_point start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread& t : workers) t.join();
+    if (!stats) return;
+
+    const NumaTopology& topo = numa_topology();
+    stats->threads = plan.threads;
+    stats->seconds = 0;
+    stats->nodes.clear();
+    std::vector<double> slowest;  // per entry of stats->nodes
+    size_t total = 0;
+    for (unsigned w = 0; w < plan.threads; ++w) {
+        double sec = std::chrono::duration<double>(end[w] - start).count();
+        size_t bytes = (plan.bounds[w + 1] - plan.bounds[w]) * bytes_per_byte;
+        int node = plan.node[w] < 0 ? -1 : topo.nodes[plan.node[w]];
+        size_t i = 0;
+        while (i < stats->nodes.size() && stats->nodes[i].node != node) ++i;
+        if (i == stats->nodes.size()) {
+            NodeTransfer t = {node, 0, 0, 0.0};
+            stats->nodes.push_back(t);
+            slowest.push_back(0);
+        }
+        stats->nodes[i].threads += 1;
+        stats->nodes[i].bytes += bytes;
+        slowest[i] = std::max(slowest[i], sec);
+        stats->seconds = std::max(stats->seconds, sec);
+        total += bytes;
+    }
+    for (size_t i = 0; i < stats->nodes.size(); ++i) {
+        stats->nodes[i].gbps = slowest[i] > 0 ? stats->nodes[i].bytes / slowest[i] / 1e9 : 0;
+    }
+    stats->gbps = stats->seconds > 0 ? total / stats->seconds / 1e9 : 0;
+}
+
+// The streaming-store threshold for the share kernels: chosen for the whole
+// buffer, since every share on its own may be below it.
+size_t share_threshold(size_t n) {
+    return n >= nt_threshold() ? 0 : SIZE_MAX;
+}
+
+// Sets the preferred node of the whole pages in [p, p + n) and moves those
+// already faulted in. Best effort: without mbind, first touch does the work.
+void prefer_node(char* p, size_t n, int node) {
+#ifdef SYS_mbind
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(p) + kPageSize - 1) & ~(uintptr_t)(kPageSize - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(p) + n) & ~(uintptr_t)(kPageSize - 1);
+    if (node < 0 || node >= 1024 || end <= begin) return;
+    const long kMpolPreferred = 1;
+    const unsigned kMpolMfMove = 1 << 1;
+    unsigned long mask[1024 / 64] = {};
+    mask[node / 64] = 1ul << (node % 64);
+    // maxnode counts one more than the bits the kernel reads.
+    syscall(SYS_mbind, begin, end - begin, kMpolPreferred, mask, 1024 + 1, kMpolMfMove);
+#else
+    (void)p; (void)n; (void)node;
+#endif
+}
+
+} // namespace
+
+const NumaTopology& numa_topology() {
+    static const NumaTopology topology = read_topology();
+    return topology;
+}
+
+void parallel_memcpy(void* dst, const void* src, size_t n, const ParallelOptions& opt, TransferStats* stats) {
+    Plan plan = make_plan(dst, n, opt);
+    const KernelTable& k = kernels();
+    size_t threshold = share_threshold(n);
+    char* d = static_cast<char*>(dst);
+    const char* s = static_cast<const char*>(src);
+    run_plan(plan, 2, stats, [&](unsigned, size_t begin, size_t end) {
+        k.copy_bytes(d + begin, s + begin, end - begin, threshold);
+    });
+}
+
+void parallel_memset(void* dst, int value, size_t n, const ParallelOptions& opt, TransferStats* stats) {
+    Plan plan = make_plan(dst, n, opt);
+    const KernelTable& k = kernels();
+    size_t threshold = share_threshold(n);
+    char* d = static_cast<char*>(dst);
+    run_plan(plan, 1, stats, [&](unsigned, size_t begin, size_t end) {
+        k.fill_bytes(d + begin, value, end - begin, threshold);
+    });
+}
+
+void parallel_transform(void* dst, const void* src, size_t n, const TransformFn& fn, const ParallelOptions& opt,
+                        TransferStats* stats) {
+    Plan plan = make_plan(dst, n, opt);
+    char* d = static_cast<char*>(dst);
+    const char* s = static_cast<const char*>(src);
+    run_plan(plan, 2, stats, [&](unsigned, size_t begin, size_t end) {
+        fn(d + begin, s + begin, end - begin);
+    });
+}
+
+void first_touch(void* p, size_t n, const ParallelOptions& opt) {
+    Plan plan = make_plan(p, n, opt);
+    const KernelTable& k = kernels();
+    const NumaTopology& topo = numa_topology();
+    size_t threshold = share_threshold(n);
+    char* d = static_cast<char*>(p);
+    run_plan(plan, 1, nullptr, [&](unsigned w, size_t begin, size_t end) {
+        if (plan.node[w] >= 0 && topo.nodes.size() > 1) prefer_node(d + begin, end - begin, topo.nodes[plan.node[w]]);
+        k.fill_bytes(d + begin, 0, end - begin, threshold);
+    });
+}
+
+std::vector<size_t> bytes_per_node(const void* p, size_t n) {
+    const NumaTopology& topo = numa_topology();
+    std::vector<size_t> out(topo.nodes.size(), 0);
+#ifdef SYS_move_pages
+    uintptr_t begin = reinterpret_cast<uintptr_t>(p) & ~(uintptr_t)(kPageSize - 1);
+    uintptr_t end = reinterpret_cast<uintptr_t>(p) + n;
+    const size_t kBatch = 4096;
+    std::vector<void*> pages;
+    std::vector<int> status(kBatch);
+    pages.reserve(kBatch);
+    for (uintptr_t page = begin; page < end;) {
+        pages.clear();
+        for (; page < end && pages.size() < kBatch; page += kPageSize) pages.push_back(reinterpret_cast<void*>(page));
+        // With nodes == NULL, move_pages only reports where each page is.
+        if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) != 0) {
+            return std::vector<size_t>();
+        }
+        for (size_t i = 0; i < pages.size(); ++i) {
+            for (size_t j = 0; j < topo.nodes.size(); ++j) {
+                if (status[i] == topo.nodes[j]) out[j] += kPageSize;
+            }
+        }
+    }
+#else
+    (void)p; (void)n;
+    out.clear();
+#endif
+    return out;
+}
+
+} // namespace simd
@@ -0,0 +1,90 @@
+#ifndef SIMD_PARALLEL_COPY_H
+#define SIMD_PARALLEL_COPY_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace simd {
+
+// Multithreaded copy, fill and transform of large buffers.
+//
+// One core cannot keep enough cache misses in flight to saturate DRAM, let
+// alone the memory of a second socket. These functions split a buffer into
+// one contiguous share per worker thread, cut at page boundaries of the
+// destination (2 MiB boundaries when the shares are large enough to keep huge
+// pages whole), pin each worker to a CPU, and run the simd_memcpy /
+// simd_memset kernels on the shares. Whether streaming stores are used is
+// decided on the whole buffer against nt_threshold(), not per share.
+//
+// Workers are spread over the NUMA nodes round-robin: worker w runs on node
+// w % nodes, on the (w / nodes)-th CPU of that node that the process may use
+// (physical cores come first in the usual CPU numbering). The split depends
+// only on the destination address, the size and the number of workers, so a
+// buffer placed with first_touch() and then copied with the same options has
+// every worker write to its own node.
+
+// Online NUMA nodes and their CPUs, restricted to the CPUs this process may
+// run on (sched_getaffinity); a node without such CPUs gets no workers.
+// Without NUMA information, one node 0 with all of them.
+struct NumaTopology {
+    std::vector<int> nodes;                // node ids
+    std::vector<std::vector<int> > cpus;   // cpus[i]: CPUs of nodes[i]
+};
+
+// Read once from /sys/devices/system/node, then cached.
+const NumaTopology& numa_topology();
+
+struct ParallelOptions {
+    unsigned threads = 0;  // 0: one per allowed CPU; fewer for small buffers
+    bool pin = true;       // pin workers as described above
+};
+
+// Result of one call, with bandwidth counted as in stream_bench: bytes read
+// plus bytes written (a copy of n bytes moves 2n, a fill n).
+struct NodeTransfer {
+    int node;          // -1 when the workers are not pinned
+    unsigned threads;
+    size_t bytes;      // moved by this node's workers
+    double gbps;       // over the time of this node's slowest worker
+};
+
+struct TransferStats {
+    unsigned threads;
+    double seconds;                  // first worker start to last worker end
+    double gbps;
+    std::vector<NodeTransfer> nodes;
+};
+
+// Copies n bytes from src to dst in parallel. The buffers must not overlap.
+void parallel_memcpy(void* dst, const void* src, size_t n, const ParallelOptions& opt = ParallelOptions(),
+                     TransferStats* stats = nullptr);
+
+// Sets n bytes of dst to (unsigned char)value in parallel.
+void parallel_memset(void* dst, int value, size_t n, const ParallelOptions& opt = ParallelOptions(),
+                     TransferStats* stats = nullptr);
+
+// Calls fn(dst + off, src + off, len) once per worker, in parallel, with the
+// shares parallel_memcpy would use. Offsets are multiples of the element size
+// as long as dst is aligned to it and the element size divides 4096; every
+// share but the last is then a whole number of elements. Stats count 2n bytes.
+typedef std::function<void(void* dst, const void* src, size_t bytes)> TransformFn;
+void parallel_transform(void* dst, const void* src, size_t n, const TransformFn& fn,
+                        const ParallelOptions& opt = ParallelOptions(), TransferStats* stats = nullptr);
+
+// Places the pages of [p, p + n) on the nodes of the workers that
+// parallel_memcpy(p, ..., n, opt) would give them to: each share is bound to
+// its worker's node as preferred node with mbind (moving pages that are
+// already faulted in), then zeroed by that worker, pinned, so untouched pages
+// are faulted in locally even where mbind is unavailable. Pages that only
+// partly belong to the buffer are left to first touch.
+void first_touch(void* p, size_t n, const ParallelOptions& opt = ParallelOptions());
+
+// Bytes of [p, p + n) per node, as reported by move_pages for the pages that
+// are faulted in: result[i] is for numa_topology().nodes[i]. Empty when the
+// kernel does not tell.
+std::vector<size_t> bytes_per_node(const void* p, size_t n);
+
+} // namespace simd
+
+#endif // SIMD_PARALLEL_COPY_H
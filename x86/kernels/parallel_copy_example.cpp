@@ -0,0 +1,120 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "arena.h"
+#include "dispatch.h"
+#include "parallel_copy.h"
+
+namespace {
+
+// Odd sizes and offsets, thread counts that do and do not divide them, and a
+// buffer large enough for 2 MiB cuts and streaming stores.
+bool check() {
+    const size_t big = (size_t)40 << 20;
+    std::vector<unsigned char> src(big + 64), dst(big + 64), want(big + 64);
+    for (size_t i = 0; i < src.size(); ++i) src[i] = (unsigned char)(i * 131 + (i >> 12));
+    const simd::KernelTable& ref = simd::kernels_for(simd::Isa::Scalar);
+
+    for (size_t n : {(size_t)0, (size_t)1, (size_t)100, (size_t)4099, ((size_t)5 << 20) + 17, big}) {
+        for (unsigned threads : {1u, 3u, 4u}) {
+            simd::ParallelOptions opt;
+            opt.threads = threads;
+            std::fill(dst.begin(), dst.end(), 0);
+            simd::parallel_memcpy(dst.data() + 3, src.data() + 1, n, opt);
+            if (std::memcmp(dst.data() + 3, src.data() + 1, n) != 0 || dst[2] != 0 || dst[3 + n] != 0) return false;
+
+            simd::parallel_memset(dst.data() + 5, 0xAB, n, opt);
+            for (size_t i = 0; i < n; i += 97) {
+                if (dst[5 + i] != 0xAB) return false;
+            }
+            if ((n && dst[5 + n - 1] != 0xAB) || dst[5 + n] != 0) return false;
+
+            // Transform: scale floats, each share with the dispatched kernel.
+            size_t floats = n / sizeof(float);
+            float* out = reinterpret_cast<float*>(dst.data());
+            float* expect = reinterpret_cast<float*>(want.data());
+            const float* in = reinterpret_cast<const float*>(src.data());
+            simd::parallel_transform(out, in, floats * sizeof(float),
+                                     [](void* d, const void* s, size_t bytes) {
+                                         simd::kernels().scale_f32(static_cast<float*>(d),
+                                                                   static_cast<const float*>(s), 0.5f,
+                                                                   bytes / sizeof(float));
+                                     },
+                                     opt);
+            ref.scale_f32(expect, in, 0.5f, floats);
+            if (std::memcmp(out, expect, floats * sizeof(float)) != 0) return false;
+        }
+    }
+    return true;
+}
+
+void print_topology() {
+    const simd::NumaTopology& t = simd::numa_topology();
+    for (size_t i = 0; i < t.nodes.size(); ++i) {
+        std::cout << "Node " << t.nodes[i] << ": " << t.cpus[i].size() << " CPUs";
+        if (!t.cpus[i].empty()) std::cout << " (" << t.cpus[i].front() << "..." << t.cpus[i].back() << ")";
+        std::cout << std::endl;
+    }
+}
+
+void print_placement(const char* name, const void* p, size_t bytes) {
+    std::vector<size_t> per_node = simd::bytes_per_node(p, bytes);
+    std::cout << "  " << name << ":";
+    if (per_node.empty()) std::cout << " (move_pages unavailable)";
+    for (size_t i = 0; i < per_node.size(); ++i) {
+        std::cout << " node " << simd::numa_topology().nodes[i] << " " << (per_node[i] >> 20) << " MiB";
+    }
+    std::cout << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::cout << std::fixed << std::setprecision(1);
+    print_topology();
+    bool ok = check();
+    std::cout << "Copy, fill, transform vs scalar: " << (ok ? "OK" : "MISMATCH") << std::endl << std::endl;
+
+    size_t mib = argc > 1 ? (size_t)std::atol(argv[1]) : 512;
+    size_t bytes = mib << 20;
+    char* src = static_cast<char*>(simd::map_pages(bytes));
+    char* dst = static_cast<char*>(simd::map_pages(bytes));
+    simd::first_touch(src, bytes);
+    simd::first_touch(dst, bytes);
+    simd::parallel_memset(src, 7, bytes);
+    std::cout << "Placement after first_touch (" << mib << " MiB each):" << std::endl;
+    print_placement("src", src, bytes);
+    print_placement("dst", dst, bytes);
+
+    // Bandwidth counted as bytes read + bytes written; best of three.
+    std::cout << std::endl << "parallel_memcpy, " << mib << " MiB:" << std::endl;
+    size_t cpus = 0;
+    for (const std::vector<int>& c : simd::numa_topology().cpus) cpus += c.size();
+    unsigned hw = (unsigned)std::max<size_t>(1, cpus);
+    for (unsigned t = 1;; t = std::min(t * 2, hw)) {
+        simd::ParallelOptions opt;
+        opt.threads = t;
+        simd::TransferStats best;
+        best.gbps = 0;
+        for (int rep = 0; rep < 3; ++rep) {
+            simd::TransferStats st;
+            simd::parallel_memcpy(dst, src, bytes, opt, &st);
+            if (st.gbps > best.gbps) best = st;
+        }
+        std::cout << "  " << std::setw(3) << t << " threads: " << std::setw(7) << best.gbps << " GB/s  (";
+        for (size_t i = 0; i < best.nodes.size(); ++i) {
+            std::cout << (i ? ", " : "") << "node " << best.nodes[i].node << " with " << best.nodes[i].threads << ": "
+                      << best.nodes[i].gbps;
+        }
+        std::cout << ")" << std::endl;
+        if (t == hw) break;
+    }
+    ok &= std::memcmp(dst, src, bytes) == 0;
+
+    simd::unmap_pages(src, bytes);
+    simd::unmap_pages(dst, bytes);
+    return ok ? 0 : 1;
+}
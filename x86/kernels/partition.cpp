@@ -0,0 +1,118 @@
+#include "partition.h"
+#include "arena.h"
+#include "dispatch.h"
+#include "memops.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace simd {
+
+namespace {
+
+// Below this many tuples per thread, starting a thread costs more than the
+// partitioning.
+const size_t kMinPerThread = 1 << 16;
+const size_t kLineWords = 8;
+
+typedef std::vector<uint64_t, AlignedAllocator<uint64_t> > LineBuffers;
+
+unsigned thread_count(unsigned threads, size_t n) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    return (unsigned)std::min<size_t>(threads, std::max<size_t>(1, n / kMinPerThread));
+}
+
+// Runs fn(t) for every t < threads, t = 0 on the calling thread.
+template <typename F>
+void run_threads(unsigned threads, F fn) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) workers.emplace_back(fn, t);
+    fn(0);
+    for (std::thread& w : workers) w.join();
+}
+
+void count(const uint64_t* in, size_t n, unsigned shift, unsigned bits, size_t* counts) {
+    const uint32_t mask = (uint32_t)(((size_t)1 << bits) - 1);
+    for (size_t i = 0; i < n; ++i) ++counts[((uint32_t)in[i] >> shift) & mask];
+}
+
+// One pass over in, split into one chunk per thread. Each thread counts its
+// chunk, then every partition is laid out as the regions of threads 0, 1, ...
+// in turn, and each thread scatters its chunk into its regions.
+void partition_pass(const uint64_t* in, size_t n, unsigned shift, unsigned bits, uint64_t* out, size_t* offsets,
+                    unsigned threads, size_t nt) {
+    const KernelTable& k = kernels();
+    const size_t fanout = (size_t)1 << bits;
+    std::vector<std::vector<size_t> > cursor(threads, std::vector<size_t>(fanout));
+    run_threads(threads, [&](unsigned t) {
+        size_t begin = n * t / threads, end = n * (t + 1) / threads;
+        count(in + begin, end - begin, shift, bits, cursor[t].data());
+    });
+    size_t pos = 0;
+    for (size_t p = 0; p < fanout; ++p) {
+        offsets[p] = pos;
+        for (unsigned t = 0; t < threads; ++t) {
+            size_t c = cursor[t][p];
+            cursor[t][p] = pos;
+            pos += c;
+        }
+    }
+    offsets[fanout] = pos;
+    run_threads(threads, [&](unsigned t) {
+        size_t begin = n * t / threads, end = n * (t + 1) / threads;
+        LineBuffers buffers(kLineWords << bits);
+        k.radix_partition_u64(in + begin, end - begin, shift, bits, out, cursor[t].data(), buffers.data(), nt);
+    });
+}
+
+// Streaming is decided on the whole output, as in parallel_memcpy.
+size_t stream_threshold(size_t n) {
+    return n * sizeof(uint64_t) >= nt_threshold() ? 0 : SIZE_MAX;
+}
+
+} // namespace
+
+void radix_partition(const uint64_t* in, size_t n, unsigned bits, unsigned shift, uint64_t* out,
+                     size_t* offsets, unsigned threads) {
+    partition_pass(in, n, shift, bits, out, offsets, thread_count(threads, n), stream_threshold(n));
+}
+
+void radix_partition_2pass(const uint64_t* in, size_t n, unsigned bits1, unsigned bits2, unsigned shift,
+                           uint64_t* out, uint64_t* tmp, size_t* offsets, unsigned threads) {
+    const KernelTable& k = kernels();
+    const size_t fanout1 = (size_t)1 << bits1, fanout2 = (size_t)1 << bits2;
+    const size_t nt = stream_threshold(n);
+    threads = thread_count(threads, n);
+    std::vector<size_t> first(fanout1 + 1);
+    partition_pass(in, n, shift + bits2, bits1, tmp, first.data(), threads, nt);
+
+    // Second pass: thread t takes the first-pass partitions that start in
+    // [n * t / threads, n * (t + 1) / threads), and each of those partitions
+    // is split in place into the same range of out.
+    auto bound = [&](unsigned t) {
+        if (t == threads) return fanout1;
+        return (size_t)(std::lower_bound(first.begin(), first.begin() + fanout1, n * t / threads) - first.begin());
+    };
+    run_threads(threads, [&](unsigned t) {
+        LineBuffers buffers(kLineWords << bits2);
+        std::vector<size_t> cursor(fanout2);
+        for (size_t q = bound(t); q < bound(t + 1); ++q) {
+            const uint64_t* part = tmp + first[q];
+            size_t len = first[q + 1] - first[q];
+            std::fill(cursor.begin(), cursor.end(), 0);
+            count(part, len, shift, bits2, cursor.data());
+            size_t pos = first[q];
+            for (size_t p = 0; p < fanout2; ++p) {
+                size_t c = cursor[p];
+                offsets[q * fanout2 + p] = cursor[p] = pos;
+                pos += c;
+            }
+            k.radix_partition_u64(part, len, shift, bits2, out, cursor.data(), buffers.data(), nt);
+        }
+    });
+    offsets[fanout1 * fanout2] = n;
+}
+
+} // namespace simd
@@ -0,0 +1,45 @@
+#ifndef SIMD_PARTITION_H
+#define SIMD_PARTITION_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+// Radix partitioning of 64-bit tuples, the first step of a radix hash join or
+// a radix sort: tuples are grouped by `bits` bits of their key, in the order
+// they come within each group.
+//
+// A tuple is a uint64_t with the key (or its hash) in the low 32 bits and the
+// payload in the high 32; its partition is bits [shift, shift + bits) of the
+// key. shift + bits must not exceed 32.
+//
+// Writing each tuple straight to its partition touches 2^bits output streams
+// at once; past a few dozen, every store misses the cache and the TLB. The
+// kernels instead append tuples to a 64-byte buffer per partition, which stays
+// in L1/L2, and write a buffer out as one cache line when it is full
+// (software write-combining). From nt_threshold() bytes (memops.h) on, the
+// full lines are written with streaming stores.
+
+// Most bits per pass: the buffers take 64 << bits bytes (1 MiB at 14).
+const unsigned kMaxRadixBits = 14;
+
+// One pass, 1 <= bits <= kMaxRadixBits. Partition p is written to
+// out[offsets[p], offsets[p + 1]); offsets has 2^bits + 1 entries. in and out
+// must not overlap. Threads (0: one per hardware thread) each partition one
+// contiguous chunk of the input into their own region of every partition, so
+// the result is the same for every thread count.
+void radix_partition(const uint64_t* in, size_t n, unsigned bits, unsigned shift, uint64_t* out,
+                     size_t* offsets, unsigned threads = 0);
+
+// Two passes for fanouts too large for one: first by the high bits1 bits of
+// bits [shift, shift + bits1 + bits2) into tmp, then each of those partitions
+// by the low bits2 bits into out. The result is that of one pass on
+// bits1 + bits2 bits; offsets has 2^(bits1 + bits2) + 1 entries, tmp room for
+// n tuples. The second pass gives each thread whole first-pass partitions.
+void radix_partition_2pass(const uint64_t* in, size_t n, unsigned bits1, unsigned bits2, unsigned shift,
+                           uint64_t* out, uint64_t* tmp, size_t* offsets, unsigned threads = 0);
+
+} // namespace simd
+
+#endif // SIMD_PARTITION_H
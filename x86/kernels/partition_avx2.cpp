@@ -0,0 +1,54 @@
+#include "kernels_internal.h"
+#include "partition_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx2 {
+
+namespace {
+
+// Partitions of 8 tuples: shift and mask 4 x 64 bits, then gather the low
+// halves of both vectors into one (shuffle_ps interleaves them per 128-bit
+// lane, permute4x64 puts the lanes back in order).
+struct Ids8 {
+    __m128i count;
+    __m256i mask;
+    void operator()(const uint64_t* in, uint32_t* id) const {
+        __m256i v0 = _mm256_and_si256(_mm256_srl_epi64(_mm256_loadu_si256((const __m256i*)in), count), mask);
+        __m256i v1 = _mm256_and_si256(_mm256_srl_epi64(_mm256_loadu_si256((const __m256i*)(in + 4)), count), mask);
+        __m256 lo = _mm256_shuffle_ps(_mm256_castsi256_ps(v0), _mm256_castsi256_ps(v1), 0x88);
+        _mm256_storeu_si256((__m256i*)id, _mm256_permute4x64_epi64(_mm256_castps_si256(lo), 0xD8));
+    }
+};
+
+template <bool kStream>
+struct Flush {
+    void operator()(uint64_t* dst, const uint64_t* buf) const {
+        __m256i v0 = _mm256_load_si256((const __m256i*)buf);
+        __m256i v1 = _mm256_load_si256((const __m256i*)(buf + 4));
+        if (kStream) {
+            _mm256_stream_si256((__m256i*)dst, v0);
+            _mm256_stream_si256((__m256i*)(dst + 4), v1);
+        } else {
+            _mm256_store_si256((__m256i*)dst, v0);
+            _mm256_store_si256((__m256i*)(dst + 4), v1);
+        }
+    }
+};
+
+} // namespace
+
+void radix_partition_u64(const uint64_t* in, size_t n, unsigned shift, unsigned bits, uint64_t* out,
+                         size_t* cursor, uint64_t* buffers, size_t nt_threshold) {
+    Ids8 ids = {_mm_cvtsi32_si128((int)shift), _mm256_set1_epi64x((int64_t)(((size_t)1 << bits) - 1))};
+    if (n * sizeof(uint64_t) >= nt_threshold) {
+        swwc_partition<8>(in, n, shift, bits, out, cursor, buffers, ids, Flush<true>());
+        _mm_sfence();
+    } else {
+        swwc_partition<8>(in, n, shift, bits, out, cursor, buffers, ids, Flush<false>());
+    }
+}
+
+} // namespace avx2
+} // namespace simd
@@ -0,0 +1,47 @@
+#include "kernels_internal.h"
+#include "partition_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512 {
+
+namespace {
+
+// Partitions of 16 tuples: shift and mask 8 x 64 bits, narrow with vpmovqd.
+struct Ids16 {
+    __m128i count;
+    __m512i mask;
+    void operator()(const uint64_t* in, uint32_t* id) const {
+        __m512i v0 = _mm512_and_si512(_mm512_srl_epi64(_mm512_loadu_si512(in), count), mask);
+        __m512i v1 = _mm512_and_si512(_mm512_srl_epi64(_mm512_loadu_si512(in + 8), count), mask);
+        _mm256_storeu_si256((__m256i*)id, _mm512_cvtepi64_epi32(v0));
+        _mm256_storeu_si256((__m256i*)(id + 8), _mm512_cvtepi64_epi32(v1));
+    }
+};
+
+// A whole buffer is one zmm: the flush is a single 64-byte store.
+template <bool kStream>
+struct Flush {
+    void operator()(uint64_t* dst, const uint64_t* buf) const {
+        __m512i v = _mm512_load_si512(buf);
+        if (kStream) _mm512_stream_si512((__m512i*)dst, v);
+        else         _mm512_store_si512(dst, v);
+    }
+};
+
+} // namespace
+
+void radix_partition_u64(const uint64_t* in, size_t n, unsigned shift, unsigned bits, uint64_t* out,
+                         size_t* cursor, uint64_t* buffers, size_t nt_threshold) {
+    Ids16 ids = {_mm_cvtsi32_si128((int)shift), _mm512_set1_epi64((int64_t)(((size_t)1 << bits) - 1))};
+    if (n * sizeof(uint64_t) >= nt_threshold) {
+        swwc_partition<16>(in, n, shift, bits, out, cursor, buffers, ids, Flush<true>());
+        _mm_sfence();
+    } else {
+        swwc_partition<16>(in, n, shift, bits, out, cursor, buffers, ids, Flush<false>());
+    }
+}
+
+} // namespace avx512
+} // namespace simd
@@ -0,0 +1,174 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include "arena.h"
+#include "dispatch.h"
+#include "memops.h"
+#include "partition.h"
+
+namespace {
+
+typedef std::vector<uint64_t, simd::AlignedAllocator<uint64_t> > Tuples;
+
+uint32_t radix(uint64_t t, unsigned shift, unsigned bits) {
+    return ((uint32_t)t >> shift) & (uint32_t)(((size_t)1 << bits) - 1);
+}
+
+// Stable counting sort by the radix: what every partitioning must produce.
+std::vector<uint64_t> reference(const uint64_t* in, size_t n, unsigned bits, unsigned shift,
+                                std::vector<size_t>& offsets) {
+    offsets.assign(((size_t)1 << bits) + 1, 0);
+    for (size_t i = 0; i < n; ++i) ++offsets[radix(in[i], shift, bits) + 1];
+    for (size_t p = 1; p < offsets.size(); ++p) offsets[p] += offsets[p - 1];
+    std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+    std::vector<uint64_t> out(n);
+    for (size_t i = 0; i < n; ++i) out[cursor[radix(in[i], shift, bits)]++] = in[i];
+    return out;
+}
+
+Tuples random_tuples(size_t n, uint64_t seed) {
+    Tuples t(n);
+    std::mt19937_64 rng(seed);
+    for (uint64_t& x : t) x = rng();
+    return t;
+}
+
+// Every level's kernel on lengths and output alignments around a cache line,
+// streamed and not; the words around the output must stay untouched.
+bool check_level(const simd::KernelTable& k) {
+    Tuples in = random_tuples(5000, 1);
+    for (unsigned bits : {1u, 3u, 6u, 10u}) {
+        for (size_t n : {(size_t)0, (size_t)1, (size_t)7, (size_t)8, (size_t)9, (size_t)100, (size_t)5000}) {
+            std::vector<size_t> offsets;
+            std::vector<uint64_t> want = reference(in.data(), n, bits, 5, offsets);
+            for (size_t skew = 0; skew < 8; ++skew) {
+                for (size_t nt : {(size_t)0, SIZE_MAX}) {
+                    Tuples out(n + 16, 7);
+                    Tuples buffers((size_t)8 << bits);
+                    std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+                    k.radix_partition_u64(in.data(), n, 5, bits, out.data() + skew, cursor.data(), buffers.data(),
+                                          nt);
+                    if (!std::equal(want.begin(), want.end(), out.begin() + skew)) return false;
+                    for (size_t i = 0; i < skew; ++i) if (out[i] != 7) return false;
+                    for (size_t i = n + skew; i < out.size(); ++i) if (out[i] != 7) return false;
+                    for (size_t p = 0; p + 1 < offsets.size(); ++p) if (cursor[p] != offsets[p + 1]) return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// The public functions, one and two passes, for several thread counts.
+bool check_api() {
+    const size_t n = 300001;
+    Tuples in = random_tuples(n, 2), out(n), tmp(n);
+    for (unsigned threads : {1u, 2u, 3u, 8u}) {
+        std::vector<size_t> want_offsets, offsets(((size_t)1 << 12) + 1);
+        std::vector<uint64_t> want = reference(in.data(), n, 12, 3, want_offsets);
+        simd::radix_partition(in.data(), n, 12, 3, out.data(), offsets.data(), threads);
+        if (!std::equal(want.begin(), want.end(), out.begin()) || offsets != want_offsets) return false;
+        std::fill(out.begin(), out.end(), 0);
+        simd::radix_partition_2pass(in.data(), n, 5, 7, 3, out.data(), tmp.data(), offsets.data(), threads);
+        if (!std::equal(want.begin(), want.end(), out.begin()) || offsets != want_offsets) return false;
+    }
+    return true;
+}
+
+template <typename F>
+double seconds(F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 3; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::fixed << std::setprecision(1);
+    bool ok = true;
+    const simd::Isa levels[] = {simd::Isa::Scalar, simd::Isa::SSE41, simd::Isa::AVX2, simd::Isa::AVX512};
+    for (simd::Isa isa : levels) {
+        if (isa > simd::detect_isa()) break;
+        bool level_ok = check_level(simd::kernels_for(isa));
+        std::cout << std::setw(7) << simd::isa_name(isa) << " vs reference: " << (level_ok ? "OK" : "MISMATCH")
+                  << std::endl;
+        ok &= level_ok;
+    }
+    bool api_ok = check_api();
+    std::cout << "radix_partition, 1 and 2 passes, 1-8 threads: " << (api_ok ? "OK" : "MISMATCH") << std::endl;
+    ok &= api_ok;
+
+    // The scatter alone (counts are computed once), 8 M tuples = 64 MiB, in
+    // M tuples/s.
+    const size_t n = (size_t)1 << 23;
+    Tuples in = random_tuples(n, 3);
+    uint64_t* out = static_cast<uint64_t*>(simd::map_pages(n * sizeof(uint64_t)));
+    uint64_t* tmp = static_cast<uint64_t*>(simd::map_pages(n * sizeof(uint64_t)));
+    simd::simd_memset(out, 0, n * sizeof(uint64_t));
+    simd::simd_memset(tmp, 0, n * sizeof(uint64_t));
+    std::cout << std::endl << "Scatter of 8 M tuples, M tuples/s (one thread):" << std::endl;
+    std::cout << "  bits   naive";
+    for (simd::Isa isa : levels) {
+        if (isa > simd::detect_isa()) break;
+        std::cout << "  " << std::setw(7) << simd::isa_name(isa) << " / stream";
+    }
+    std::cout << std::endl;
+    for (unsigned bits : {4u, 8u, 11u, 14u}) {
+        std::vector<size_t> offsets;
+        offsets.assign(((size_t)1 << bits) + 1, 0);
+        for (size_t i = 0; i < n; ++i) ++offsets[radix(in[i], 0, bits) + 1];
+        for (size_t p = 1; p < offsets.size(); ++p) offsets[p] += offsets[p - 1];
+        std::vector<size_t> cursor;
+        double naive = seconds([&] {
+            cursor.assign(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < n; ++i) out[cursor[radix(in[i], 0, bits)]++] = in[i];
+        });
+        std::cout << "  " << std::setw(4) << bits << "  " << std::setw(6) << n / naive / 1e6;
+        Tuples buffers((size_t)8 << bits);
+        for (simd::Isa isa : levels) {
+            if (isa > simd::detect_isa()) break;
+            const simd::KernelTable& k = simd::kernels_for(isa);
+            double sec[2];
+            for (int stream = 0; stream < 2; ++stream) {
+                sec[stream] = seconds([&] {
+                    cursor.assign(offsets.begin(), offsets.end() - 1);
+                    k.radix_partition_u64(in.data(), n, 0, bits, out, cursor.data(), buffers.data(),
+                                          stream ? 0 : SIZE_MAX);
+                });
+            }
+            std::cout << "  " << std::setw(7) << n / sec[0] / 1e6 << " / " << std::setw(6) << n / sec[1] / 1e6;
+        }
+        std::cout << std::endl;
+    }
+
+    // The largest one-pass fanout against the same bits in two passes,
+    // counts included.
+    const unsigned bits = simd::kMaxRadixBits;
+    std::vector<size_t> offsets(((size_t)1 << bits) + 1);
+    std::cout << std::endl << bits << "-bit fanout, counts included, M tuples/s:" << std::endl;
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 1;; t = std::min(t * 2, hw)) {
+        double one = seconds([&] { simd::radix_partition(in.data(), n, bits, 0, out, offsets.data(), t); });
+        double two = seconds([&] {
+            simd::radix_partition_2pass(in.data(), n, bits / 2, bits - bits / 2, 0, out, tmp, offsets.data(), t);
+        });
+        std::cout << "  " << std::setw(2) << t << " threads: 1 pass " << std::setw(6) << n / one / 1e6
+                  << ", 2 passes " << std::setw(6) << n / two / 1e6 << std::endl;
+        if (t == hw) break;
+    }
+    simd::unmap_pages(out, n * sizeof(uint64_t));
+    simd::unmap_pages(tmp, n * sizeof(uint64_t));
+    return ok ? 0 : 1;
+}
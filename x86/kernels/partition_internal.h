@@ -0,0 +1,101 @@
+#ifndef SIMD_PARTITION_INTERNAL_H
+#define SIMD_PARTITION_INTERNAL_H
+
+// The software write-combining (SWWC) scatter shared by the per-ISA radix
+// partition kernels. Everything has internal linkage so each translation unit
+// compiles its own copy with its own flags.
+//
+// Each partition owns one 64-byte buffer, a cache line of 8 tuples, that
+// mirrors the output line its next tuple goes to: slot s of the buffer is
+// word s of that line. Tuples are appended to their buffer; when the slot of
+// the last word is written, the line is complete and is flushed with one
+// 64-byte store. Only the fanout buffers (64 << bits bytes) are written
+// tuple by tuple, so they stay in L1/L2 and need no TLB entry per partition;
+// the output sees whole-line stores only, which is what streaming stores
+// need.
+//
+// The first line of a partition may start in the middle of a cache line that
+// the previous partition (or another thread) also writes, and its last line
+// may end there. Those partial lines are copied word by word, never flushed
+// whole, so partitions that share a line do not overwrite each other.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace simd {
+
+namespace {
+
+const size_t kLineWords = 8;
+
+inline size_t word_in_line(const uint64_t* p) {
+    return ((uintptr_t)p / sizeof(uint64_t)) % kLineWords;
+}
+
+inline uint32_t radix_of(uint64_t t, unsigned shift, uint32_t mask) {
+    return ((uint32_t)t >> shift) & mask;
+}
+
+// Partitions are computed for this many tuples before any of them is
+// scattered. Scattering straight after each vector of partitions made the
+// SSE and AVX2 kernels slower than scalar code: the loads of the partitions
+// then wait on the vector store that has just written them.
+const size_t kIdBatch = 64;
+
+// ids(in, id) writes the partitions of the kLanes tuples at in to id;
+// flush(dst, buf) writes the 8 words at buf to the 64-byte aligned dst.
+// cursor[p] is where partition p starts on entry and ends on return.
+template <size_t kLanes, typename Ids, typename Flush>
+inline void swwc_partition(const uint64_t* in, size_t n, unsigned shift, unsigned bits, uint64_t* out,
+                           size_t* cursor, uint64_t* buffers, Ids ids, Flush flush) {
+    const size_t fanout = (size_t)1 << bits;
+    const uint32_t mask = (uint32_t)(fanout - 1);
+    const size_t a = word_in_line(out);  // words of out's first line before out
+    // Plain new[]: <vector> would instantiate inline code in the ISA units
+    // (see kernels_internal.h).
+    size_t* start_copy = new size_t[fanout];
+    std::memcpy(start_copy, cursor, fanout * sizeof(size_t));
+    const size_t* start = start_copy;
+
+    // Tuples are uint64_t like the cursors, so everything the loop needs is
+    // held in locals: a store to a buffer cannot change them.
+    auto put = [cursor, buffers, out, start, a, flush](uint64_t t, uint32_t p) {
+        size_t pos = cursor[p];
+        cursor[p] = pos + 1;
+        size_t slot = (pos + a) % kLineWords;
+        uint64_t* buf = buffers + p * kLineWords;
+        buf[slot] = t;
+        if (slot == kLineWords - 1) {
+            if (pos + 1 >= start[p] + kLineWords) {
+                flush(out + pos + 1 - kLineWords, buf);
+            } else {
+                for (size_t j = start[p]; j <= pos; ++j) out[j] = buf[(j + a) % kLineWords];
+            }
+        }
+    };
+
+    uint32_t id[kIdBatch];
+    size_t i = 0;
+    for (; i + kIdBatch <= n; i += kIdBatch) {
+        for (size_t k = 0; k < kIdBatch; k += kLanes) ids(in + i + k, id + k);
+        for (size_t k = 0; k < kIdBatch; ++k) put(in[i + k], id[k]);
+    }
+    for (; i < n; ++i) put(in[i], radix_of(in[i], shift, mask));
+
+    // The lines still in the buffers are partial: copy their words.
+    for (size_t p = 0; p < fanout; ++p) {
+        size_t end = cursor[p];
+        size_t filled = (end + a) % kLineWords;
+        size_t begin = end - start[p] > filled ? end - filled : start[p];
+        const uint64_t* buf = buffers + p * kLineWords;
+        for (size_t j = begin; j < end; ++j) out[j] = buf[(j + a) % kLineWords];
+    }
+    delete[] start_copy;
+}
+
+} // namespace
+
+} // namespace simd
+
+#endif // SIMD_PARTITION_INTERNAL_H
@@ -0,0 +1,22 @@
+#include "kernels_internal.h"
+#include "partition_internal.h"
+
+#include <cstring>
+
+namespace simd {
+namespace scalar {
+
+// Software write-combining with plain 64-byte copies; streaming stores need
+// SSE2 and live in the sse41 kernel.
+void radix_partition_u64(const uint64_t* in, size_t n, unsigned shift, unsigned bits, uint64_t* out,
+                         size_t* cursor, uint64_t* buffers, size_t nt_threshold) {
+    (void)nt_threshold;
+    const uint32_t mask = (uint32_t)(((size_t)1 << bits) - 1);
+    swwc_partition<1>(
+        in, n, shift, bits, out, cursor, buffers,
+        [=](const uint64_t* t, uint32_t* id) { id[0] = radix_of(t[0], shift, mask); },
+        [](uint64_t* dst, const uint64_t* buf) { std::memcpy(dst, buf, kLineWords * sizeof(uint64_t)); });
+}
+
+} // namespace scalar
+} // namespace simd
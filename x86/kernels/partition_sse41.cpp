@@ -0,0 +1,47 @@
+#include "kernels_internal.h"
+#include "partition_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace sse41 {
+
+namespace {
+
+// Partitions of 4 tuples: shift and mask 2 x 64 bits, keep the low halves.
+struct Ids4 {
+    __m128i count, mask;
+    void operator()(const uint64_t* in, uint32_t* id) const {
+        __m128i v0 = _mm_and_si128(_mm_srl_epi64(_mm_loadu_si128((const __m128i*)in), count), mask);
+        __m128i v1 = _mm_and_si128(_mm_srl_epi64(_mm_loadu_si128((const __m128i*)(in + 2)), count), mask);
+        __m128 ids = _mm_shuffle_ps(_mm_castsi128_ps(v0), _mm_castsi128_ps(v1), 0x88);
+        _mm_storeu_si128((__m128i*)id, _mm_castps_si128(ids));
+    }
+};
+
+template <bool kStream>
+struct Flush {
+    void operator()(uint64_t* dst, const uint64_t* buf) const {
+        for (size_t w = 0; w < kLineWords; w += 2) {
+            __m128i v = _mm_load_si128((const __m128i*)(buf + w));
+            if (kStream) _mm_stream_si128((__m128i*)(dst + w), v);
+            else         _mm_store_si128((__m128i*)(dst + w), v);
+        }
+    }
+};
+
+} // namespace
+
+void radix_partition_u64(const uint64_t* in, size_t n, unsigned shift, unsigned bits, uint64_t* out,
+                         size_t* cursor, uint64_t* buffers, size_t nt_threshold) {
+    Ids4 ids = {_mm_cvtsi32_si128((int)shift), _mm_set1_epi64x((int64_t)(((size_t)1 << bits) - 1))};
+    if (n * sizeof(uint64_t) >= nt_threshold) {
+        swwc_partition<4>(in, n, shift, bits, out, cursor, buffers, ids, Flush<true>());
+        _mm_sfence();
+    } else {
+        swwc_partition<4>(in, n, shift, bits, out, cursor, buffers, ids, Flush<false>());
+    }
+}
+
+} // namespace sse41
+} // namespace simd
@@ -0,0 +1,513 @@
+#ifndef SIMD_PIPELINE_H
+#define SIMD_PIPELINE_H
+
+// Fused copy-and-transform passes. A buffer that is checked, byte-swapped,
+// converted and filtered by one kernel after another crosses the memory bus
+// once per kernel; out of cache each pass costs as much as a copy. A
+// pipeline composes the steps at compile time into one loop, so every block
+// of the input is loaded once, goes through all the stages in a register and
+// is stored once:
+//
+//   simd::pipeline::Crc32c crc;                              // of the raw input
+//   simd::pipeline::ByteSwap<uint32_t> swap;                 // big-endian in
+//   simd::pipeline::Convert<int32_t, float> to_float;
+//   simd::pipeline::StreamStore out(dst);                    // dst 64-byte aligned
+//   simd::pipeline::run<simd::pipeline::LoadUnaligned>(src, n, crc, swap, to_float, out);
+//   uint32_t check = crc.value();
+//
+// A block is one register of the widest level the flags allow (16, 32 or 64
+// bytes; kBlock) with the number of bytes in it that are data. The source
+// loads it, each stage takes it and returns it, and the last stage, the
+// sink, stores it. Stages are plain classes, so a kernel adds its own with
+//
+//   Block apply(Block b);     // a transform; may return fewer bytes
+//   void put(Block b);        // a sink, with
+//   void finish();            // after the last block
+//
+// The transforms work on whole elements: n must be a multiple of the element
+// size of every stage. The last partial block is loaded with load_tail_*
+// (safe_load.h), zero-filled past the data, so no stage needs an epilogue.
+//
+// Sources, by how they read the input:
+//
+//   LoadUnaligned   any address
+//   LoadAligned     src aligned to kBlock
+//   LoadStream      movntdqa; src aligned to kBlock. Non-temporal only on
+//                   write-combining memory (device buffers); on ordinary
+//                   memory it is an aligned load
+//
+// Transforms:
+//
+//   ByteSwap<T>        reverses the bytes of each T (2, 4 or 8 bytes) with pshufb
+//   Crc32c             CRC-32C of the bytes that pass, as simd::crc32c; crc32
+//                      with SSE4.2, simd::crc32c per 1 KiB without it
+//   Convert<F, T>      int32_t <-> float, as a C++ cast (float -> int32_t
+//                      truncates); one register in, one out
+//   Filter<T, Op>      keeps the int32_t or float lanes with `x <op> value`
+//                      (filter.h) and packs them to the front: vpcompressd on
+//                      AVX-512, a kLeftPack8 permutation below
+//
+// Sinks:
+//
+//   Store          regular stores. dst must have room for capacity bytes:
+//                  after a Filter the whole register is stored and the next
+//                  block overwrites the unused part, as in filter.h
+//   StreamStore    streaming stores; dst aligned to kBlock. Blocks a Filter
+//                  shortened are gathered into whole lines first. finish
+//                  issues the sfence
+//   ScatterStore<T>  element k of the output to base[index[k]]: vpscatterdd /
+//                    vpscatterdq on AVX-512, a store per element below
+//
+// A sink writes one stream: use it for one run. The helpers have internal
+// linkage, so each translation unit compiles its own copy with its own flags.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+#include "checksum.h"
+#include "filter.h"
+#include "filter_internal.h"
+#include "safe_load.h"
+
+namespace simd {
+
+namespace {
+
+namespace pipeline {
+
+#if defined(__AVX512BW__)
+typedef __m512i Reg;
+const size_t kBlock = 64;
+#elif defined(__AVX2__)
+typedef __m256i Reg;
+const size_t kBlock = 32;
+#elif defined(__SSE4_1__)
+typedef __m128i Reg;
+const size_t kBlock = 16;
+#else
+#error "pipeline.h needs -msse4.1 or higher"
+#endif
+
+// Bytes [0, bytes) of v are data; the rest are unspecified.
+struct Block {
+    Reg v;
+    size_t bytes;
+};
+
+namespace detail {
+
+#if defined(__AVX512BW__)
+
+inline Reg load(const uint8_t* p) { return _mm512_load_si512((const void*)p); }
+inline Reg loadu(const uint8_t* p) { return _mm512_loadu_si512((const void*)p); }
+inline Reg stream_load(const uint8_t* p) { return _mm512_stream_load_si512((void*)p); }
+inline Reg load_tail(const uint8_t* p, size_t r) { return load_tail_512(p, r); }
+inline void store(uint8_t* p, Reg v) { _mm512_store_si512((void*)p, v); }
+inline void storeu(uint8_t* p, Reg v) { _mm512_storeu_si512((void*)p, v); }
+inline void stream(uint8_t* p, Reg v) { _mm512_stream_si512((__m512i*)p, v); }
+inline void store_first(uint8_t* p, Reg v, size_t r) { _mm512_mask_storeu_epi8(p, _bzhi_u64(~0ull, (unsigned)r), v); }
+inline Reg shuffle_bytes(Reg v, __m128i ctrl) { return _mm512_shuffle_epi8(v, _mm512_broadcast_i32x4(ctrl)); }
+inline Reg i32_to_f32(Reg v) { return _mm512_castps_si512(_mm512_cvtepi32_ps(v)); }
+inline Reg f32_to_i32(Reg v) { return _mm512_cvttps_epi32(_mm512_castsi512_ps(v)); }
+
+template <CmpOp Op>
+inline unsigned keep_mask(Reg x, int32_t value) {
+    return _mm512_cmp_epi32_mask(x, _mm512_set1_epi32(value), IntCmp<Op>::value);
+}
+
+template <CmpOp Op>
+inline unsigned keep_mask(Reg x, float value) {
+    __m512 a = _mm512_castsi512_ps(x), b = _mm512_set1_ps(value);
+    switch (Op) {
+        case CmpOp::EQ: return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ);
+        case CmpOp::NE: return _mm512_cmp_ps_mask(a, b, _CMP_NEQ_UQ);
+        case CmpOp::LT: return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);
+        case CmpOp::LE: return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ);
+        case CmpOp::GT: return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ);
+        case CmpOp::GE: return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ);
+    }
+    return 0;
+}
+
+// The 32-bit lanes set in m, moved to the front.
+inline Reg compress32(Reg v, unsigned m) { return _mm512_maskz_compress_epi32((__mmask16)m, v); }
+
+#elif defined(__AVX2__)
+
+inline Reg load(const uint8_t* p) { return _mm256_load_si256((const __m256i*)p); }
+inline Reg loadu(const uint8_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+inline Reg stream_load(const uint8_t* p) { return _mm256_stream_load_si256((const __m256i*)p); }
+inline Reg load_tail(const uint8_t* p, size_t r) { return load_tail_256(p, r); }
+inline void store(uint8_t* p, Reg v) { _mm256_store_si256((__m256i*)p, v); }
+inline void storeu(uint8_t* p, Reg v) { _mm256_storeu_si256((__m256i*)p, v); }
+inline void stream(uint8_t* p, Reg v) { _mm256_stream_si256((__m256i*)p, v); }
+inline Reg shuffle_bytes(Reg v, __m128i ctrl) { return _mm256_shuffle_epi8(v, _mm256_broadcastsi128_si256(ctrl)); }
+inline Reg i32_to_f32(Reg v) { return _mm256_castps_si256(_mm256_cvtepi32_ps(v)); }
+inline Reg f32_to_i32(Reg v) { return _mm256_cvttps_epi32(_mm256_castsi256_ps(v)); }
+
+// AVX2 compares integers for EQ and signed GT only; the other orderings swap
+// the operands or invert the mask.
+template <CmpOp Op>
+inline unsigned keep_mask(Reg x, int32_t value) {
+    __m256i v = _mm256_set1_epi32(value);
+    switch (Op) {
+        case CmpOp::EQ: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, v)));
+        case CmpOp::NE: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, v))) ^ 0xFF;
+        case CmpOp::LT: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, x)));
+        case CmpOp::LE: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, v))) ^ 0xFF;
+        case CmpOp::GT: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, v)));
+        case CmpOp::GE: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, x))) ^ 0xFF;
+    }
+    return 0;
+}
+
+template <CmpOp Op>
+inline unsigned keep_mask(Reg x, float value) {
+    __m256 a = _mm256_castsi256_ps(x), b = _mm256_set1_ps(value);
+    switch (Op) {
+        case CmpOp::EQ: return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+        case CmpOp::NE: return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_NEQ_UQ));
+        case CmpOp::LT: return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ));
+        case CmpOp::LE: return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LE_OQ));
+        case CmpOp::GT: return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ));
+        case CmpOp::GE: return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ));
+    }
+    return 0;
+}
+
+inline Reg compress32(Reg v, unsigned m) {
+    __m256i perm = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)&kLeftPack8[m]));
+    return _mm256_permutevar8x32_epi32(v, perm);
+}
+
+#else
+
+inline Reg load(const uint8_t* p) { return _mm_load_si128((const __m128i*)p); }
+inline Reg loadu(const uint8_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+inline Reg stream_load(const uint8_t* p) { return _mm_stream_load_si128((__m128i*)p); }
+inline Reg load_tail(const uint8_t* p, size_t r) { return load_tail_128(p, r); }
+inline void store(uint8_t* p, Reg v) { _mm_store_si128((__m128i*)p, v); }
+inline void storeu(uint8_t* p, Reg v) { _mm_storeu_si128((__m128i*)p, v); }
+inline void stream(uint8_t* p, Reg v) { _mm_stream_si128((__m128i*)p, v); }
+inline Reg shuffle_bytes(Reg v, __m128i ctrl) { return _mm_shuffle_epi8(v, ctrl); }
+inline Reg i32_to_f32(Reg v) { return _mm_castps_si128(_mm_cvtepi32_ps(v)); }
+inline Reg f32_to_i32(Reg v) { return _mm_cvttps_epi32(_mm_castsi128_ps(v)); }
+
+template <CmpOp Op>
+inline unsigned keep_mask(Reg x, int32_t value) {
+    __m128i v = _mm_set1_epi32(value);
+    switch (Op) {
+        case CmpOp::EQ: return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(x, v)));
+        case CmpOp::NE: return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(x, v))) ^ 0xF;
+        case CmpOp::LT: return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(v, x)));
+        case CmpOp::LE: return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(x, v))) ^ 0xF;
+        case CmpOp::GT: return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(x, v)));
+        case CmpOp::GE: return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(v, x))) ^ 0xF;
+    }
+    return 0;
+}
+
+template <CmpOp Op>
+inline unsigned keep_mask(Reg x, float value) {
+    __m128 a = _mm_castsi128_ps(x), b = _mm_set1_ps(value);
+    switch (Op) {
+        case CmpOp::EQ: return _mm_movemask_ps(_mm_cmpeq_ps(a, b));
+        case CmpOp::NE: return _mm_movemask_ps(_mm_cmpneq_ps(a, b));
+        case CmpOp::LT: return _mm_movemask_ps(_mm_cmplt_ps(a, b));
+        case CmpOp::LE: return _mm_movemask_ps(_mm_cmple_ps(a, b));
+        case CmpOp::GT: return _mm_movemask_ps(_mm_cmpgt_ps(a, b));
+        case CmpOp::GE: return _mm_movemask_ps(_mm_cmpge_ps(a, b));
+    }
+    return 0;
+}
+
+// kLeftPack8 gives the lane of each kept element; pshufb wants its 4 bytes.
+inline Reg compress32(Reg v, unsigned m) {
+    __m128i lanes = _mm_cvtsi32_si128((int)kLeftPack8[m]);
+    __m128i spread = _mm_shuffle_epi8(lanes, _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3));
+    __m128i ctrl = _mm_add_epi8(_mm_slli_epi16(spread, 2), _mm_setr_epi8(0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3));
+    return _mm_shuffle_epi8(v, ctrl);
+}
+
+#endif
+
+#if !defined(__AVX512BW__)
+inline void store_first(uint8_t* p, Reg v, size_t r) {
+    alignas(64) uint8_t tmp[kBlock];
+    store(tmp, v);
+    std::memcpy(p, tmp, r);
+}
+#endif
+
+// Each stage's output to the next; an empty block goes no further.
+template <typename Sink>
+inline void push(Block b, Sink& sink) {
+    sink.put(b);
+}
+
+template <typename Stage, typename Next, typename... Rest>
+inline void push(Block b, Stage& stage, Next& next, Rest&... rest) {
+    b = stage.apply(b);
+    if (b.bytes) push(b, next, rest...);
+}
+
+template <typename Sink>
+inline void finish(Sink& sink) {
+    sink.finish();
+}
+
+template <typename Stage, typename Next, typename... Rest>
+inline void finish(Stage&, Next& next, Rest&... rest) {
+    finish(next, rest...);
+}
+
+} // namespace detail
+
+// --- Sources ---
+
+struct LoadUnaligned {
+    static Reg load(const uint8_t* p) { return detail::loadu(p); }
+};
+
+struct LoadAligned {
+    static Reg load(const uint8_t* p) { return detail::load(p); }
+};
+
+struct LoadStream {
+    static Reg load(const uint8_t* p) { return detail::stream_load(p); }
+};
+
+// --- Transforms ---
+
+template <typename T>
+struct ByteSwap {
+    static_assert(sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8, "ByteSwap takes 2-, 4- or 8-byte elements");
+
+    Block apply(Block b) {
+        __m128i ctrl = sizeof(T) == 2   ? _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)
+                       : sizeof(T) == 4 ? _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+                                        : _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+        b.v = detail::shuffle_bytes(b.v, ctrl);
+        return b;
+    }
+};
+
+// crc32 runs on one dependency chain, 8 bytes per 3 cycles: about 10 GB/s,
+// above what one core streams from DRAM. Without SSE4.2 the blocks are
+// gathered and passed to simd::crc32c 1 KiB at a time.
+class Crc32c {
+public:
+#if defined(__SSE4_2__)
+    explicit Crc32c(uint32_t crc = 0) : crc_(crc) {}
+#else
+    explicit Crc32c(uint32_t crc = 0) : crc_(crc), fill_(0) {}
+#endif
+
+    Block apply(Block b) {
+#if defined(__SSE4_2__)
+        alignas(64) uint8_t tmp[kBlock];
+        detail::store(tmp, b.v);
+        uint64_t c = ~crc_;
+        size_t i = 0;
+        for (; i + 8 <= b.bytes; i += 8) {
+            uint64_t w;
+            std::memcpy(&w, tmp + i, 8);
+            c = _mm_crc32_u64(c, w);
+        }
+        for (; i < b.bytes; ++i) c = _mm_crc32_u8((uint32_t)c, tmp[i]);
+        crc_ = ~(uint32_t)c;
+#else
+        detail::storeu(pending_ + fill_, b.v);
+        fill_ += b.bytes;
+        if (fill_ >= kPending) {
+            crc_ = simd::crc32c(pending_, kPending, crc_);
+            fill_ -= kPending;
+            std::memcpy(pending_, pending_ + kPending, fill_);
+        }
+#endif
+        return b;
+    }
+
+#if defined(__SSE4_2__)
+    uint32_t value() const { return crc_; }
+
+private:
+    uint32_t crc_;
+#else
+    uint32_t value() const { return simd::crc32c(pending_, fill_, crc_); }
+
+private:
+    static const size_t kPending = 1024;
+    uint32_t crc_;
+    size_t fill_;    // bytes in pending_ not yet in crc_
+    alignas(64) uint8_t pending_[kPending + kBlock];
+#endif
+};
+
+template <typename From, typename To>
+struct Convert;
+
+template <>
+struct Convert<int32_t, float> {
+    Block apply(Block b) {
+        b.v = detail::i32_to_f32(b.v);
+        return b;
+    }
+};
+
+template <>
+struct Convert<float, int32_t> {
+    Block apply(Block b) {
+        b.v = detail::f32_to_i32(b.v);
+        return b;
+    }
+};
+
+template <typename T, CmpOp Op>
+class Filter {
+public:
+    static_assert(sizeof(T) == 4, "Filter takes 32-bit lanes: int32_t or float");
+
+    explicit Filter(T value) : value_(value) {}
+
+    Block apply(Block b) {
+        unsigned lanes = (unsigned)(b.bytes / 4);
+        unsigned m = detail::keep_mask<Op>(b.v, value_) & (unsigned)((1ull << lanes) - 1);
+        b.v = detail::compress32(b.v, m);
+        b.bytes = 4 * (size_t)_mm_popcnt_u32(m);
+        return b;
+    }
+
+private:
+    T value_;
+};
+
+// --- Sinks ---
+
+class Store {
+public:
+    Store(void* dst, size_t capacity)
+        : begin_(static_cast<uint8_t*>(dst)), end_(begin_ + capacity), at_(begin_) {}
+
+    void put(Block b) {
+        if (at_ + kBlock <= end_) detail::storeu(at_, b.v);
+        else                      detail::store_first(at_, b.v, b.bytes);
+        at_ += b.bytes;
+    }
+    void finish() {}
+
+    // Bytes written.
+    size_t size() const { return (size_t)(at_ - begin_); }
+
+private:
+    uint8_t* begin_;
+    uint8_t* end_;
+    uint8_t* at_;
+};
+
+// Short blocks are gathered in stage_ and streamed out 1 KiB at a time. By
+// then the stores that filled it have left the store buffer; a vector load
+// over several of them still in flight would wait for them to commit.
+class StreamStore {
+public:
+    explicit StreamStore(void* dst) : begin_(static_cast<uint8_t*>(dst)), at_(begin_), fill_(0) {}
+
+    void put(Block b) {
+        if (fill_ == 0 && b.bytes == kBlock) {
+            detail::stream(at_, b.v);
+            at_ += kBlock;
+            return;
+        }
+        // fill_ is read before the store into stage_, which the compiler
+        // would otherwise assume may overwrite it.
+        size_t fill = fill_;
+        detail::storeu(stage_ + fill, b.v);
+        fill += b.bytes;
+        if (fill >= kStage) {
+            for (size_t i = 0; i < kStage; i += kBlock) detail::stream(at_ + i, detail::load(stage_ + i));
+            at_ += kStage;
+            fill -= kStage;
+            std::memcpy(stage_, stage_ + kStage, fill);
+        }
+        fill_ = fill;
+    }
+
+    void finish() {
+        std::memcpy(at_, stage_, fill_);
+        at_ += fill_;
+        fill_ = 0;
+        _mm_sfence();
+    }
+
+    size_t size() const { return (size_t)(at_ - begin_) + fill_; }
+
+private:
+    static const size_t kStage = 1024;
+    uint8_t* begin_;
+    uint8_t* at_;    // kBlock-aligned until finish
+    size_t fill_;    // bytes waiting in stage_
+    alignas(64) uint8_t stage_[kStage + kBlock];
+};
+
+template <typename T>
+class ScatterStore {
+public:
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "ScatterStore takes 4- or 8-byte elements");
+
+    ScatterStore(T* base, const int32_t* index) : base_(base), index_(index), count_(0) {}
+
+    void put(Block b) {
+        size_t lanes = b.bytes / sizeof(T);
+#if defined(__AVX512BW__)
+        __mmask16 k = (__mmask16)_bzhi_u32(~0u, (unsigned)lanes);
+        if (sizeof(T) == 4) {
+            __m512i idx = _mm512_maskz_loadu_epi32(k, index_);
+            _mm512_mask_i32scatter_epi32((void*)base_, k, idx, b.v, 4);
+        } else {
+            __m256i idx = _mm256_maskz_loadu_epi32((__mmask8)k, index_);
+            _mm512_mask_i32scatter_epi64((void*)base_, (__mmask8)k, idx, b.v, 8);
+        }
+#else
+        alignas(64) T tmp[kBlock / sizeof(T)];
+        detail::store(reinterpret_cast<uint8_t*>(tmp), b.v);
+        for (size_t l = 0; l < lanes; ++l) base_[index_[l]] = tmp[l];
+#endif
+        index_ += lanes;
+        count_ += lanes;
+    }
+    void finish() {}
+
+    // Elements written.
+    size_t size() const { return count_; }
+
+private:
+    T* base_;
+    const int32_t* index_;
+    size_t count_;
+};
+
+// Runs bytes [0, n) of src through the stages; the last one is the sink.
+template <typename Source, typename... Stages>
+void run(const void* src, size_t n, Stages&... stages) {
+    static_assert(sizeof...(Stages) >= 1, "a pipeline ends in a sink");
+    const uint8_t* p = static_cast<const uint8_t*>(src);
+    size_t i = 0;
+    for (; i + kBlock <= n; i += kBlock) {
+        Block b = {Source::load(p + i), kBlock};
+        detail::push(b, stages...);
+    }
+    if (i < n) {
+        Block b = {detail::load_tail(p + i, n - i), n - i};
+        detail::push(b, stages...);
+    }
+    detail::finish(stages...);
+}
+
+} // namespace pipeline
+
+} // namespace
+
+} // namespace simd
+
+#endif // SIMD_PIPELINE_H
@@ -0,0 +1,332 @@
+// Fused pipelines (pipeline.h) against the same steps one at a time. CMake
+// builds this file at three levels (pipeline_example_sse41, _avx2, _avx512),
+// since a pipeline is compiled into the translation unit that runs it. Each
+// checks every source, transform and sink of its level on buffers that end at
+// guard pages, then times a load-check-swap-convert job and a swap-filter job
+// on 256 MiB, fused and as separate passes.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cstdint>
+#include "arena.h"
+#include "checksum.h"
+#include "dispatch.h"
+#include "filter.h"
+#include "pipeline.h"
+
+namespace {
+
+namespace pl = simd::pipeline;
+
+#if defined(__AVX512BW__)
+const simd::Isa kLevel = simd::Isa::AVX512;
+#elif defined(__AVX2__)
+const simd::Isa kLevel = simd::Isa::AVX2;
+#else
+const simd::Isa kLevel = simd::Isa::SSE41;
+#endif
+
+uint32_t bswap32(uint32_t x) { return __builtin_bswap32(x); }
+
+std::vector<uint32_t> random_words(size_t n, std::mt19937& rng) {
+    std::vector<uint32_t> v(n);
+    for (uint32_t& x : v) x = rng();
+    return v;
+}
+
+// Plain copies: every length up to four blocks, through each sink.
+bool check_copy() {
+    std::mt19937 rng(1);
+    for (size_t n = 0; n <= 4 * pl::kBlock + 3; ++n) {
+        simd::GuardedBuffer src(n), dst(n);
+        for (size_t i = 0; i < n; ++i) src.data()[i] = (uint8_t)rng();
+        pl::Store out(dst.data(), n);
+        pl::run<pl::LoadUnaligned>(src.data(), n, out);
+        if (out.size() != n || std::memcmp(src.data(), dst.data(), n) != 0) return false;
+    }
+    uint8_t* a = (uint8_t*)simd::aligned_malloc(8192, 64);
+    uint8_t* b = (uint8_t*)simd::aligned_malloc(8192, 64);
+    bool ok = true;
+    for (size_t n = 0; n <= 8192 && ok; n += 1 + n / 4) {
+        for (size_t i = 0; i < n; ++i) a[i] = (uint8_t)rng();
+        pl::StreamStore out(b);
+        pl::run<pl::LoadAligned>(a, n, out);
+        ok = out.size() == n && std::memcmp(a, b, n) == 0;
+        pl::StreamStore again(b);
+        std::memset(b, 0, n);
+        pl::run<pl::LoadStream>(a, n, again);
+        ok = ok && again.size() == n && std::memcmp(a, b, n) == 0;
+    }
+    simd::aligned_free(a);
+    simd::aligned_free(b);
+    return ok;
+}
+
+// Big-endian int32 in, float out, with the CRC of the input: the fused job
+// and the steps done by hand must agree.
+template <typename Source, typename Sink>
+bool etl_matches(const uint32_t* in, size_t n, float* out, Sink& sink) {
+    pl::Crc32c crc;
+    pl::ByteSwap<uint32_t> swap;
+    pl::Convert<int32_t, float> to_float;
+    pl::run<Source>(in, 4 * n, crc, swap, to_float, sink);
+    if (sink.size() != 4 * n || crc.value() != simd::crc32c(in, 4 * n)) return false;
+    for (size_t i = 0; i < n; ++i) {
+        if (out[i] != (float)(int32_t)bswap32(in[i])) return false;
+    }
+    return true;
+}
+
+bool check_etl() {
+    std::mt19937 rng(2);
+    for (size_t n = 0; n <= 300; ++n) {
+        std::vector<uint32_t> words = random_words(n, rng);
+        simd::GuardedBuffer src(4 * n), dst(4 * n);
+        if (n) std::memcpy(src.data(), words.data(), 4 * n);
+        pl::Store out(dst.data(), 4 * n);
+        if (!etl_matches<pl::LoadUnaligned>((const uint32_t*)src.data(), n, (float*)dst.data(), out)) return false;
+    }
+    uint32_t* in = (uint32_t*)simd::aligned_malloc(4 * 5000, 64);
+    float* out = (float*)simd::aligned_malloc(4 * 5000, 64);
+    bool ok = true;
+    for (size_t n = 0; n <= 5000 && ok; n += 1 + n / 3) {
+        std::vector<uint32_t> words = random_words(n, rng);
+        if (n) std::memcpy(in, words.data(), 4 * n);
+        pl::StreamStore a(out), b(out);
+        ok = etl_matches<pl::LoadAligned>(in, n, out, a) && etl_matches<pl::LoadStream>(in, n, out, b);
+    }
+    // The other conversion and swap widths, against single elements.
+    for (size_t n = 0; n <= 200 && ok; ++n) {
+        std::vector<float> f(n);
+        for (float& x : f) x = (float)((int32_t)rng() % 100000) / 7.0f;
+        std::vector<int32_t> got(n);
+        pl::Convert<float, int32_t> to_int;
+        pl::Store sink(got.data(), 4 * n);
+        pl::run<pl::LoadUnaligned>(f.data(), 4 * n, to_int, sink);
+        for (size_t i = 0; i < n; ++i) ok = ok && got[i] == (int32_t)f[i];
+
+        std::vector<uint64_t> q(n), swapped(n);
+        for (uint64_t& x : q) x = (uint64_t)rng() << 32 | rng();
+        pl::ByteSwap<uint64_t> swap64;
+        pl::Store sink64(swapped.data(), 8 * n);
+        pl::run<pl::LoadUnaligned>(q.data(), 8 * n, swap64, sink64);
+        for (size_t i = 0; i < n; ++i) ok = ok && swapped[i] == __builtin_bswap64(q[i]);
+
+        std::vector<uint16_t> h(n), swapped16(n);
+        for (uint16_t& x : h) x = (uint16_t)rng();
+        pl::ByteSwap<uint16_t> swap16;
+        pl::Store sink16(swapped16.data(), 2 * n);
+        pl::run<pl::LoadUnaligned>(h.data(), 2 * n, swap16, sink16);
+        for (size_t i = 0; i < n; ++i) ok = ok && swapped16[i] == __builtin_bswap16(h[i]);
+    }
+    simd::aligned_free(in);
+    simd::aligned_free(out);
+    return ok;
+}
+
+template <simd::CmpOp Op, typename T>
+bool keep(T x, T v) {
+    switch (Op) {
+        case simd::CmpOp::EQ: return x == v;
+        case simd::CmpOp::NE: return x != v;
+        case simd::CmpOp::LT: return x < v;
+        case simd::CmpOp::LE: return x <= v;
+        case simd::CmpOp::GT: return x > v;
+        case simd::CmpOp::GE: return x >= v;
+    }
+    return false;
+}
+
+// Small values so that every op keeps some lanes and drops others; floats
+// include NaN.
+template <typename T>
+std::vector<T> random_values(size_t n, std::mt19937& rng) {
+    std::vector<T> v(n);
+    for (T& x : v) x = rng() % 17 ? (T)((int)(rng() % 19) - 9) : std::numeric_limits<T>::quiet_NaN();
+    return v;
+}
+
+template <>
+std::vector<int32_t> random_values<int32_t>(size_t n, std::mt19937& rng) {
+    std::vector<int32_t> v(n);
+    for (int32_t& x : v) x = (int32_t)(rng() % 19) - 9;
+    return v;
+}
+
+template <simd::CmpOp Op, typename T>
+bool check_filter_op() {
+    std::mt19937 rng(3);
+    for (size_t n = 0; n <= 300; ++n) {
+        std::vector<T> v = random_values<T>(n, rng), want;
+        for (T x : v) {
+            if (keep<Op>(x, (T)2)) want.push_back(x);
+        }
+        simd::GuardedBuffer src(4 * n), dst(4 * n);
+        if (n) std::memcpy(src.data(), v.data(), 4 * n);
+        pl::Filter<T, Op> f((T)2);
+        pl::Store out(dst.data(), 4 * n);
+        pl::run<pl::LoadUnaligned>(src.data(), 4 * n, f, out);
+        if (out.size() != 4 * want.size() || std::memcmp(dst.data(), want.data(), out.size()) != 0) return false;
+    }
+    // Through the streaming sink, which gathers the short blocks.
+    T* a = (T*)simd::aligned_malloc(4 * 5000, 64);
+    T* b = (T*)simd::aligned_malloc(4 * 5000, 64);
+    bool ok = true;
+    for (size_t n = 0; n <= 5000 && ok; n += 1 + n / 3) {
+        std::vector<T> v = random_values<T>(n, rng), want;
+        for (T x : v) {
+            if (keep<Op>(x, (T)2)) want.push_back(x);
+        }
+        if (n) std::memcpy(a, v.data(), 4 * n);
+        pl::Filter<T, Op> f((T)2);
+        pl::StreamStore out(b);
+        pl::run<pl::LoadAligned>(a, 4 * n, f, out);
+        ok = out.size() == 4 * want.size() && std::memcmp(b, want.data(), out.size()) == 0;
+    }
+    simd::aligned_free(a);
+    simd::aligned_free(b);
+    return ok;
+}
+
+template <typename T>
+bool check_filter_type() {
+    return check_filter_op<simd::CmpOp::EQ, T>() && check_filter_op<simd::CmpOp::NE, T>() &&
+           check_filter_op<simd::CmpOp::LT, T>() && check_filter_op<simd::CmpOp::LE, T>() &&
+           check_filter_op<simd::CmpOp::GT, T>() && check_filter_op<simd::CmpOp::GE, T>();
+}
+
+// Swapped words to a random permutation of their slots, both widths; and a
+// filter in front, so the scatter takes short blocks.
+bool check_scatter() {
+    std::mt19937 rng(4);
+    for (size_t n = 0; n <= 300; ++n) {
+        std::vector<int32_t> index(n);
+        for (size_t i = 0; i < n; ++i) index[i] = (int32_t)i;
+        std::shuffle(index.begin(), index.end(), rng);
+        simd::GuardedBuffer idx(4 * n);
+        if (n) std::memcpy(idx.data(), index.data(), 4 * n);
+        const int32_t* guarded_index = (const int32_t*)idx.data();
+
+        std::vector<uint32_t> words = random_words(n, rng), out32(n);
+        pl::ByteSwap<uint32_t> swap;
+        pl::ScatterStore<uint32_t> to32(out32.data(), guarded_index);
+        pl::run<pl::LoadUnaligned>(words.data(), 4 * n, swap, to32);
+        if (to32.size() != n) return false;
+        for (size_t i = 0; i < n; ++i) {
+            if (out32[index[i]] != bswap32(words[i])) return false;
+        }
+
+        std::vector<uint64_t> q(n), out64(n);
+        for (uint64_t& x : q) x = (uint64_t)rng() << 32 | rng();
+        pl::ByteSwap<uint64_t> swap64;
+        pl::ScatterStore<uint64_t> to64(out64.data(), guarded_index);
+        pl::run<pl::LoadUnaligned>(q.data(), 8 * n, swap64, to64);
+        if (to64.size() != n) return false;
+        for (size_t i = 0; i < n; ++i) {
+            if (out64[index[i]] != __builtin_bswap64(q[i])) return false;
+        }
+
+        std::vector<int32_t> v = random_values<int32_t>(n, rng), kept, scattered(n, 99);
+        for (int32_t x : v) {
+            if (x >= 0) kept.push_back(x);
+        }
+        pl::Filter<int32_t, simd::CmpOp::GE> f(0);
+        pl::ScatterStore<int32_t> to(scattered.data(), guarded_index);
+        pl::run<pl::LoadUnaligned>(v.data(), 4 * n, f, to);
+        if (to.size() != kept.size()) return false;
+        for (size_t k = 0; k < kept.size(); ++k) {
+            if (scattered[index[k]] != kept[k]) return false;
+        }
+    }
+    return true;
+}
+
+template <typename F>
+double gb_per_s(size_t bytes, F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 5; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return bytes / best / 1e9;
+}
+
+} // namespace
+
+int main() {
+    if (kLevel > simd::detect_isa()) {
+        std::cout << simd::isa_name(kLevel) << " not supported here; nothing to check" << std::endl;
+        return 0;
+    }
+    bool ok = check_copy() && check_etl();
+    std::cout << simd::isa_name(kLevel) << " sources, swaps, conversions, CRC and sinks, guarded: "
+              << (ok ? "OK" : "MISMATCH") << std::endl;
+    bool good = check_filter_type<int32_t>() && check_filter_type<float>() && check_scatter();
+    std::cout << simd::isa_name(kLevel) << " filters and scatters, guarded: " << (good ? "OK" : "MISMATCH")
+              << std::endl;
+    ok = ok && good;
+
+    // 256 MiB of big-endian int32: the passes one at a time against one fused
+    // pass. GB/s of input.
+    size_t n = (size_t)64 << 20, bytes = 4 * n;
+    uint32_t* src = (uint32_t*)simd::aligned_malloc(bytes, 64);
+    uint32_t* dst = (uint32_t*)simd::aligned_malloc(bytes, 64);
+    uint32_t* dst2 = (uint32_t*)simd::aligned_malloc(bytes, 64);
+    std::mt19937 rng(5);
+    for (size_t i = 0; i < n; ++i) src[i] = rng();
+    std::memset(dst, 0, bytes);
+    std::memset(dst2, 0, bytes);
+    volatile uint64_t sink = 0;
+    std::cout << std::endl << "256 MiB at " << simd::isa_name(kLevel) << ", GB/s:" << std::fixed
+              << std::setprecision(2) << std::endl;
+    std::cout << std::setw(32) << "" << std::setw(10) << "passes" << std::setw(10) << "fused" << std::endl;
+
+    double passes = gb_per_s(bytes, [&] {
+        sink = simd::crc32c(src, bytes);
+        pl::ByteSwap<uint32_t> swap;
+        pl::StreamStore a(dst);
+        pl::run<pl::LoadAligned>(src, bytes, swap, a);
+        pl::Convert<int32_t, float> to_float;
+        pl::StreamStore b(dst);
+        pl::run<pl::LoadAligned>(dst, bytes, to_float, b);
+    });
+    double fused = gb_per_s(bytes, [&] {
+        pl::Crc32c crc;
+        pl::ByteSwap<uint32_t> swap;
+        pl::Convert<int32_t, float> to_float;
+        pl::StreamStore out(dst);
+        pl::run<pl::LoadAligned>(src, bytes, crc, swap, to_float, out);
+        sink = crc.value();
+    });
+    std::cout << std::setw(32) << "crc32c, bswap, int32 -> float" << std::setw(10) << passes << std::setw(10)
+              << fused << std::endl;
+
+    passes = gb_per_s(bytes, [&] {
+        pl::ByteSwap<uint32_t> swap;
+        pl::StreamStore a(dst);
+        pl::run<pl::LoadAligned>(src, bytes, swap, a);
+        sink = simd::filter((const int32_t*)dst, n, simd::Predicate<int32_t>{simd::CmpOp::GE, 0}, (int32_t*)dst2);
+    });
+    fused = gb_per_s(bytes, [&] {
+        pl::ByteSwap<uint32_t> swap;
+        pl::Filter<int32_t, simd::CmpOp::GE> f(0);
+        pl::StreamStore out(dst2);
+        pl::run<pl::LoadAligned>(src, bytes, swap, f, out);
+        sink = out.size();
+    });
+    std::cout << std::setw(32) << "bswap, filter x >= 0" << std::setw(10) << passes << std::setw(10) << fused
+              << std::endl;
+    simd::aligned_free(src);
+    simd::aligned_free(dst);
+    simd::aligned_free(dst2);
+    return ok ? 0 : 1;
+}
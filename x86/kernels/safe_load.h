@@ -0,0 +1,104 @@
+#ifndef SIMD_SAFE_LOAD_H
+#define SIMD_SAFE_LOAD_H
+
+// Loads of the last r bytes of a buffer into a whole vector, for byte
+// kernels (string, parse, filter) that would otherwise finish with a scalar
+// loop:
+//
+//   size_t i = 0;
+//   for (; i + 32 <= n; i += 32) f(_mm256_loadu_si256((const __m256i*)(src + i)));
+//   if (i < n) f(load_tail_256(src + i, n - i));   // bytes r.. are 0
+//
+// Reading past the end of a buffer faults only if the read reaches a page the
+// buffer does not touch; protection is per page, and 4 KiB is the smallest
+// page. So when the vector at p stays within p's page, a plain unaligned load
+// is safe whatever lies beyond p + r, and the extra bytes are masked to 0.
+// Only near the end of a page does the load change:
+//
+//   SSE4.1   the 16 bytes that end at p + r (all in p's page, which is mapped
+//            because p is) are loaded and shifted down with pshufb
+//   AVX2     16 bytes at a time, the same way
+//   AVX-512  a masked vmovdqu8, whose masked-off bytes never fault
+//
+// Masked loads could do every tail, but on several cores a masked load whose
+// masked-off part touches an unmapped page takes a slow microcode assist;
+// the page test keeps them for the rare loads that need them. Element tails
+// of float and int32_t arrays use tail_mask.h.
+//
+// p may point one past the end of the buffer when r is 0. The helpers have
+// internal linkage so each translation unit compiles its own copy with its
+// own flags.
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace simd {
+
+namespace {
+
+const size_t kSafeLoadPage = 4096;
+
+// Whether [p, p + bytes) lies in one 4 KiB page.
+inline bool within_page(const void* p, size_t bytes) {
+    return ((uintptr_t)p & (kSafeLoadPage - 1)) <= kSafeLoadPage - bytes;
+}
+
+#if defined(__SSSE3__)
+
+// 32 bytes from kKeepWindow + 32 - r have exactly their first r bytes set.
+// 16 bytes from kShiftWindow + 16 - r are a pshufb control that moves bytes
+// 16 - r .. 15 down to 0 .. r - 1 and zeroes the rest.
+alignas(64) constexpr int8_t kKeepWindow[64] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+alignas(32) constexpr int8_t kShiftWindow[32] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+
+// Bytes [p, p + r) in the low r lanes, 0 above; r <= 16.
+inline __m128i load_tail_128(const uint8_t* p, size_t r) {
+    if (r == 0) return _mm_setzero_si128();
+    if (within_page(p, 16)) {
+        __m128i keep = _mm_loadu_si128((const __m128i*)(kKeepWindow + 32 - r));
+        return _mm_and_si128(_mm_loadu_si128((const __m128i*)p), keep);
+    }
+    __m128i v = _mm_loadu_si128((const __m128i*)(p + r - 16));
+    return _mm_shuffle_epi8(v, _mm_loadu_si128((const __m128i*)(kShiftWindow + 16 - r)));
+}
+
+#endif
+
+#if defined(__AVX2__)
+
+// Bytes [p, p + r) in the low r lanes, 0 above; r <= 32.
+inline __m256i load_tail_256(const uint8_t* p, size_t r) {
+    if (r == 0) return _mm256_setzero_si256();
+    if (within_page(p, 32)) {
+        __m256i keep = _mm256_loadu_si256((const __m256i*)(kKeepWindow + 32 - r));
+        return _mm256_and_si256(_mm256_loadu_si256((const __m256i*)p), keep);
+    }
+    // The page ends within the vector. A full low half is all buffer.
+    if (r <= 16) return _mm256_zextsi128_si256(load_tail_128(p, r));
+    __m128i lo = _mm_loadu_si128((const __m128i*)p);
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), load_tail_128(p + 16, r - 16), 1);
+}
+
+#endif
+
+#if defined(__AVX512BW__)
+
+// Bytes [p, p + r) in the low r lanes, 0 above; r <= 64.
+inline __m512i load_tail_512(const uint8_t* p, size_t r) {
+    __mmask64 k = _bzhi_u64(~0ull, (unsigned)r);
+    if (r && within_page(p, 64)) return _mm512_maskz_mov_epi8(k, _mm512_loadu_si512((const void*)p));
+    return _mm512_maskz_loadu_epi8(k, p);
+}
+
+#endif
+
+} // namespace
+
+} // namespace simd
+
+#endif // SIMD_SAFE_LOAD_H
@@ -0,0 +1,122 @@
+// Tails against guard pages. CMake builds this file at three levels
+// (safe_load_example_sse41, _avx2, _avx512); each checks the safe_load.h
+// helpers of its level and then runs that level's kernels on buffers that end
+// right before, or start right after, a PROT_NONE page. A read or write one
+// byte out of bounds kills the process with SIGSEGV, so getting to "OK" is
+// the proof.
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include "arena.h"
+#include "dispatch.h"
+#include "filter.h"
+#include "safe_load.h"
+
+namespace {
+
+#if defined(__AVX512BW__)
+const simd::Isa kLevel = simd::Isa::AVX512;
+const size_t kVector = 64;
+void load_tail(const uint8_t* p, size_t r, uint8_t* out) {
+    _mm512_storeu_si512((void*)out, simd::load_tail_512(p, r));
+}
+#elif defined(__AVX2__)
+const simd::Isa kLevel = simd::Isa::AVX2;
+const size_t kVector = 32;
+void load_tail(const uint8_t* p, size_t r, uint8_t* out) {
+    _mm256_storeu_si256((__m256i*)out, simd::load_tail_256(p, r));
+}
+#else
+const simd::Isa kLevel = simd::Isa::SSE41;
+const size_t kVector = 16;
+void load_tail(const uint8_t* p, size_t r, uint8_t* out) {
+    _mm_storeu_si128((__m128i*)out, simd::load_tail_128(p, r));
+}
+#endif
+
+// Every tail length with its end at every distance up to two vectors from
+// the guard page, and with its start on the first byte after one.
+bool check_load_tail() {
+    simd::GuardedBuffer after(2 * simd::kPageSize), before(2 * simd::kPageSize, simd::Guard::Before);
+    for (size_t i = 0; i < after.size(); ++i) after.data()[i] = before.data()[i] = (uint8_t)(i * 7 + 1);
+    uint8_t out[64];
+    for (size_t r = 0; r <= kVector; ++r) {
+        for (size_t gap = 0; gap <= 2 * kVector; ++gap) {
+            const uint8_t* p = after.data() + after.size() - gap - r;
+            load_tail(p, r, out);
+            for (size_t j = 0; j < kVector; ++j) {
+                if (out[j] != (j < r ? p[j] : 0)) return false;
+            }
+        }
+        load_tail(before.data(), r, out);
+        for (size_t j = 0; j < kVector; ++j) {
+            if (out[j] != (j < r ? before.data()[j] : 0)) return false;
+        }
+    }
+    return true;
+}
+
+// src ends and dst ends at a guard page; the result must match scalar.
+template <typename T, typename F>
+bool check_guarded(size_t max_n, F kernel) {
+    for (size_t n = 0; n <= max_n; ++n) {
+        simd::GuardedBuffer src(n * sizeof(T)), dst(n * sizeof(T));
+        std::vector<T> want(n);
+        T* s = reinterpret_cast<T*>(src.data());
+        for (size_t i = 0; i < n; ++i) s[i] = (T)((i * 37 + 11) % 23);
+        if (!kernel(s, n, reinterpret_cast<T*>(dst.data()), want.data())) return false;
+    }
+    return true;
+}
+
+bool check_kernels() {
+    const simd::KernelTable& t = simd::kernels_for(kLevel);
+    const simd::KernelTable& ref = simd::kernels_for(simd::Isa::Scalar);
+    const size_t max_n = 4 * kVector + 3;
+    bool ok = true;
+    for (simd::CmpOp op : {simd::CmpOp::LT, simd::CmpOp::EQ, simd::CmpOp::GE}) {
+        ok = ok && check_guarded<uint8_t>(max_n, [&](const uint8_t* s, size_t n, uint8_t* d, uint8_t* w) {
+            size_t k = t.filter_u8(s, n, op, 9, d);
+            return k == ref.filter_u8(s, n, op, 9, w) && std::memcmp(d, w, k) == 0;
+        });
+        ok = ok && check_guarded<int32_t>(max_n, [&](const int32_t* s, size_t n, int32_t* d, int32_t* w) {
+            size_t k = t.filter_i32(s, n, op, 9, d);
+            return k == ref.filter_i32(s, n, op, 9, w) && std::memcmp(d, w, k * 4) == 0;
+        });
+        ok = ok && check_guarded<float>(max_n, [&](const float* s, size_t n, float* d, float* w) {
+            size_t k = t.filter_f32(s, n, op, 9.0f, d);
+            return k == ref.filter_f32(s, n, op, 9.0f, w) && std::memcmp(d, w, k * 4) == 0;
+        });
+        ok = ok && check_guarded<int64_t>(max_n, [&](const int64_t* s, size_t n, int64_t* d, int64_t* w) {
+            size_t k = t.filter_i64(s, n, op, 9, d);
+            return k == ref.filter_i64(s, n, op, 9, w) && std::memcmp(d, w, k * 8) == 0;
+        });
+    }
+    ok = ok && check_guarded<uint8_t>(max_n, [&](const uint8_t* s, size_t n, uint8_t* d, uint8_t*) {
+        t.copy_bytes(d, s, n, (size_t)-1);
+        return std::memcmp(d, s, n) == 0;
+    });
+    ok = ok && check_guarded<float>(max_n, [&](const float* s, size_t n, float* d, float*) {
+        t.copy_f32(d, s, n);
+        return std::memcmp(d, s, n * 4) == 0 && t.sum_f32(s, n) == ref.sum_f32(s, n);
+    });
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    if (kLevel > simd::detect_isa()) {
+        std::cout << simd::isa_name(kLevel) << " not supported here; nothing to check" << std::endl;
+        return 0;
+    }
+    bool loads = check_load_tail();
+    std::cout << simd::isa_name(kLevel) << " load_tail against guard pages: " << (loads ? "OK" : "MISMATCH")
+              << std::endl;
+    bool kernels = check_kernels();
+    std::cout << simd::isa_name(kLevel) << " kernels with guarded src and dst: " << (kernels ? "OK" : "MISMATCH")
+              << std::endl;
+    return loads && kernels ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+#include "sort.h"
+#include "dispatch.h"
+
+#include <memory>
+#include <cstring>
+
+namespace simd {
+
+namespace {
+
+// uint32_t and float keys are mapped in place to int32_t keys in the same
+// order, sorted by the 32-bit kernel and mapped back; both maps are their
+// own inverse. Flipping the sign bit orders unsigned keys as signed ones. A
+// float is sign-magnitude: flipping the magnitude bits of negative values
+// makes their order that of two's complement.
+void flip_sign(uint32_t* keys, size_t n) {
+    for (size_t i = 0; i < n; ++i) keys[i] ^= 0x80000000u;
+}
+
+void flip_negative(float* keys, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        int32_t b;
+        std::memcpy(&b, &keys[i], sizeof(b));
+        b ^= (int32_t)((uint32_t)(b >> 31) >> 1);
+        std::memcpy(&keys[i], &b, sizeof(b));
+    }
+}
+
+void sort32(int32_t* keys, uint32_t* values, size_t n) {
+    if (n < 2) return;
+    // Uninitialised: the merge passes write every entry before reading it.
+    std::unique_ptr<int32_t[]> key_tmp(new int32_t[n]);
+    std::unique_ptr<uint32_t[]> value_tmp(values ? new uint32_t[n] : nullptr);
+    kernels().sort_i32(keys, values, n, key_tmp.get(), value_tmp.get());
+}
+
+void sort64(int64_t* keys, uint64_t* values, size_t n) {
+    if (n < 2) return;
+    // Uninitialised: the merge passes write every entry before reading it.
+    std::unique_ptr<int64_t[]> key_tmp(new int64_t[n]);
+    std::unique_ptr<uint64_t[]> value_tmp(values ? new uint64_t[n] : nullptr);
+    kernels().sort_i64(keys, values, n, key_tmp.get(), value_tmp.get());
+}
+
+} // namespace
+
+void sort(int32_t* keys, size_t n) {
+    sort32(keys, nullptr, n);
+}
+
+void sort(uint32_t* keys, size_t n) {
+    sort_pairs(keys, nullptr, n);
+}
+
+void sort(float* keys, size_t n) {
+    sort_pairs(keys, nullptr, n);
+}
+
+void sort(int64_t* keys, size_t n) {
+    sort64(keys, nullptr, n);
+}
+
+void sort_pairs(int32_t* keys, uint32_t* values, size_t n) {
+    sort32(keys, values, n);
+}
+
+void sort_pairs(uint32_t* keys, uint32_t* values, size_t n) {
+    flip_sign(keys, n);
+    sort32(reinterpret_cast<int32_t*>(keys), values, n);
+    flip_sign(keys, n);
+}
+
+void sort_pairs(float* keys, uint32_t* values, size_t n) {
+    flip_negative(keys, n);
+    sort32(reinterpret_cast<int32_t*>(keys), values, n);
+    flip_negative(keys, n);
+}
+
+void sort_pairs(int64_t* keys, uint64_t* values, size_t n) {
+    sort64(keys, values, n);
+}
+
+} // namespace simd
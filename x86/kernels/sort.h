@@ -0,0 +1,35 @@
+#ifndef SIMD_SORT_H
+#define SIMD_SORT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+// Ascending in-memory sort with sorting networks in registers and vector
+// merges (AVX2 and AVX-512 kernels; the scalar level runs the same merge sort
+// one key at a time).
+//
+// Blocks of four vectors are sorted with a bitonic network; the runs are then
+// merged one vector at a time, first inside blocks that stay in L2, then over
+// the whole array. Each call allocates a temporary as large as the input.
+//
+// The sort is not stable: values that come with equal keys may end up in any
+// order. uint32_t keys are compared as unsigned; floats in IEEE total order:
+// -0.0 before +0.0, and NaNs with the sign bit clear after +inf (set: before
+// -inf).
+void sort(int32_t* keys, size_t n);
+void sort(uint32_t* keys, size_t n);
+void sort(float* keys, size_t n);
+void sort(int64_t* keys, size_t n);
+
+// The same, moving values[i] with keys[i]: a sort by key of (key, value)
+// pairs held as two arrays, such as row ids behind an ORDER BY column.
+void sort_pairs(int32_t* keys, uint32_t* values, size_t n);
+void sort_pairs(uint32_t* keys, uint32_t* values, size_t n);
+void sort_pairs(float* keys, uint32_t* values, size_t n);
+void sort_pairs(int64_t* keys, uint64_t* values, size_t n);
+
+} // namespace simd
+
+#endif // SIMD_SORT_H
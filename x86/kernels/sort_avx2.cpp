@@ -0,0 +1,84 @@
+#include "kernels_internal.h"
+#include "sort_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx2 {
+
+namespace {
+
+// Masks are vectors on AVX2. Partners within a 128-bit lane use the cheap
+// in-lane shuffles; only the lane-crossing steps and the reversal permute.
+struct Ops8x32 {
+    typedef int32_t Key;
+    typedef uint32_t Payload;
+    typedef __m256i Vec;
+    typedef __m256i Mask;
+    static const unsigned kLanes = 8;
+
+    template <typename T>
+    static Vec load(const T* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    template <typename T>
+    static void store(T* p, Vec v) { _mm256_storeu_si256((__m256i*)p, v); }
+    template <unsigned J>
+    static Vec partner(Vec v) {
+        return J == 1 ? _mm256_shuffle_epi32(v, 0xB1)
+             : J == 2 ? _mm256_shuffle_epi32(v, 0x4E)
+                      : _mm256_permute2x128_si256(v, v, 0x01);
+    }
+    static Vec reverse(Vec v) { return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0)); }
+    template <unsigned kBits>
+    static Vec blend(Vec a, Vec b) { return _mm256_blend_epi32(a, b, kBits); }
+    static Vec min(Vec a, Vec b) { return _mm256_min_epi32(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm256_max_epi32(a, b); }
+    static Mask gt(Vec a, Vec b) { return _mm256_cmpgt_epi32(a, b); }
+    template <unsigned kBits>
+    static Mask blend_mask(Mask a, Mask b) { return _mm256_blend_epi32(a, b, kBits); }
+    static Vec select(Mask m, Vec a, Vec b) { return _mm256_blendv_epi8(a, b, m); }
+};
+
+// Two 32-bit blend bits per 64-bit lane.
+constexpr unsigned widen_bits(unsigned bits, unsigned i = 0) {
+    return i == 4 ? 0u : (((bits >> i) & 1u) ? 3u << (2 * i) : 0u) | widen_bits(bits, i + 1);
+}
+
+// No 64-bit min/max below AVX-512: both come from one compare.
+struct Ops4x64 {
+    typedef int64_t Key;
+    typedef uint64_t Payload;
+    typedef __m256i Vec;
+    typedef __m256i Mask;
+    static const unsigned kLanes = 4;
+
+    template <typename T>
+    static Vec load(const T* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    template <typename T>
+    static void store(T* p, Vec v) { _mm256_storeu_si256((__m256i*)p, v); }
+    template <unsigned J>
+    static Vec partner(Vec v) {
+        return J == 1 ? _mm256_shuffle_epi32(v, 0x4E) : _mm256_permute2x128_si256(v, v, 0x01);
+    }
+    static Vec reverse(Vec v) { return _mm256_permute4x64_epi64(v, 0x1B); }
+    template <unsigned kBits>
+    static Vec blend(Vec a, Vec b) { return _mm256_blend_epi32(a, b, widen_bits(kBits)); }
+    static Vec min(Vec a, Vec b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+    static Vec max(Vec a, Vec b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+    static Mask gt(Vec a, Vec b) { return _mm256_cmpgt_epi64(a, b); }
+    template <unsigned kBits>
+    static Mask blend_mask(Mask a, Mask b) { return _mm256_blend_epi32(a, b, widen_bits(kBits)); }
+    static Vec select(Mask m, Vec a, Vec b) { return _mm256_blendv_epi8(a, b, m); }
+};
+
+} // namespace
+
+void sort_i32(int32_t* keys, uint32_t* values, size_t n, int32_t* key_tmp, uint32_t* value_tmp) {
+    sort_keys<Ops8x32>(keys, values, n, key_tmp, value_tmp);
+}
+
+void sort_i64(int64_t* keys, uint64_t* values, size_t n, int64_t* key_tmp, uint64_t* value_tmp) {
+    sort_keys<Ops4x64>(keys, values, n, key_tmp, value_tmp);
+}
+
+} // namespace avx2
+} // namespace simd
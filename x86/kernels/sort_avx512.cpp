@@ -0,0 +1,87 @@
+#include "kernels_internal.h"
+#include "sort_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512 {
+
+namespace {
+
+// Lane-crossing partners and the reversal are one vpermd/vpermq with a
+// constant index (_mm512_permutexvar); partners within a 128-bit lane use
+// vpshufd, which has a third of the latency. Blends are mask moves with an
+// immediate mask, and the payload steps compare into mask registers.
+struct Ops16x32 {
+    typedef int32_t Key;
+    typedef uint32_t Payload;
+    typedef __m512i Vec;
+    typedef __mmask16 Mask;
+    static const unsigned kLanes = 16;
+
+    template <typename T>
+    static Vec load(const T* p) { return _mm512_loadu_si512(p); }
+    template <typename T>
+    static void store(T* p, Vec v) { _mm512_storeu_si512(p, v); }
+    template <unsigned J>
+    static Vec partner(Vec v) {
+        return J == 1 ? _mm512_shuffle_epi32(v, (_MM_PERM_ENUM)0xB1)
+             : J == 2 ? _mm512_shuffle_epi32(v, (_MM_PERM_ENUM)0x4E)
+                      : _mm512_permutexvar_epi32(
+                            _mm512_set_epi32(15 ^ J, 14 ^ J, 13 ^ J, 12 ^ J, 11 ^ J, 10 ^ J, 9 ^ J, 8 ^ J, 7 ^ J,
+                                             6 ^ J, 5 ^ J, 4 ^ J, 3 ^ J, 2 ^ J, 1 ^ J, 0 ^ J),
+                            v);
+    }
+    static Vec reverse(Vec v) {
+        return _mm512_permutexvar_epi32(_mm512_setr_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0), v);
+    }
+    template <unsigned kBits>
+    static Vec blend(Vec a, Vec b) { return _mm512_mask_mov_epi32(a, (__mmask16)kBits, b); }
+    static Vec min(Vec a, Vec b) { return _mm512_min_epi32(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm512_max_epi32(a, b); }
+    static Mask gt(Vec a, Vec b) { return _mm512_cmpgt_epi32_mask(a, b); }
+    template <unsigned kBits>
+    static Mask blend_mask(Mask a, Mask b) { return (Mask)((a & ~kBits) | (b & kBits)); }
+    static Vec select(Mask m, Vec a, Vec b) { return _mm512_mask_mov_epi32(a, m, b); }
+};
+
+struct Ops8x64 {
+    typedef int64_t Key;
+    typedef uint64_t Payload;
+    typedef __m512i Vec;
+    typedef __mmask8 Mask;
+    static const unsigned kLanes = 8;
+
+    template <typename T>
+    static Vec load(const T* p) { return _mm512_loadu_si512(p); }
+    template <typename T>
+    static void store(T* p, Vec v) { _mm512_storeu_si512(p, v); }
+    template <unsigned J>
+    static Vec partner(Vec v) {
+        return J == 1 ? _mm512_shuffle_epi32(v, (_MM_PERM_ENUM)0x4E)
+                      : _mm512_permutexvar_epi64(
+                            _mm512_set_epi64(7 ^ J, 6 ^ J, 5 ^ J, 4 ^ J, 3 ^ J, 2 ^ J, 1 ^ J, 0 ^ J), v);
+    }
+    static Vec reverse(Vec v) { return _mm512_permutexvar_epi64(_mm512_setr_epi64(7, 6, 5, 4, 3, 2, 1, 0), v); }
+    template <unsigned kBits>
+    static Vec blend(Vec a, Vec b) { return _mm512_mask_mov_epi64(a, (__mmask8)kBits, b); }
+    static Vec min(Vec a, Vec b) { return _mm512_min_epi64(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm512_max_epi64(a, b); }
+    static Mask gt(Vec a, Vec b) { return _mm512_cmpgt_epi64_mask(a, b); }
+    template <unsigned kBits>
+    static Mask blend_mask(Mask a, Mask b) { return (Mask)((a & ~kBits) | (b & kBits)); }
+    static Vec select(Mask m, Vec a, Vec b) { return _mm512_mask_mov_epi64(a, m, b); }
+};
+
+} // namespace
+
+void sort_i32(int32_t* keys, uint32_t* values, size_t n, int32_t* key_tmp, uint32_t* value_tmp) {
+    sort_keys<Ops16x32>(keys, values, n, key_tmp, value_tmp);
+}
+
+void sort_i64(int64_t* keys, uint64_t* values, size_t n, int64_t* key_tmp, uint64_t* value_tmp) {
+    sort_keys<Ops8x64>(keys, values, n, key_tmp, value_tmp);
+}
+
+} // namespace avx512
+} // namespace simd
@@ -0,0 +1,179 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "dispatch.h"
+#include "sort.h"
+
+namespace {
+
+// Random keys in [0, range), or any value when range is 0.
+template <typename K>
+std::vector<K> random_keys(size_t n, uint64_t range, uint64_t seed) {
+    std::vector<K> keys(n);
+    std::mt19937_64 rng(seed);
+    for (K& k : keys) k = (K)(range ? rng() % range : rng());
+    return keys;
+}
+
+// Sizes around the vector blocks and the cache blocks of the merge passes;
+// keys uniform, with many repeats, sorted and reversed.
+const size_t kSizes[] = {0, 1, 2, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129, 1000, 16383, 16384,
+                         16385, 50000, 100003};
+
+template <typename K, typename V, typename Kernel>
+bool check_keys(Kernel kernel) {
+    for (size_t n : kSizes) {
+        for (uint64_t range : {(uint64_t)0, (uint64_t)10}) {
+            for (int order = 0; order < 3; ++order) {
+                std::vector<K> keys = random_keys<K>(n, range, n + range);
+                if (order == 1) std::sort(keys.begin(), keys.end());
+                if (order == 2) std::sort(keys.rbegin(), keys.rend());
+                std::vector<V> values(n);
+                for (size_t i = 0; i < n; ++i) values[i] = (V)i;
+                std::vector<std::pair<K, V> > want(n);
+                for (size_t i = 0; i < n; ++i) want[i] = std::make_pair(keys[i], values[i]);
+                std::sort(want.begin(), want.end());
+
+                std::vector<K> only = keys, key_tmp(n);
+                std::vector<V> value_tmp(n);
+                kernel(only.data(), (V*)nullptr, n, key_tmp.data(), (V*)nullptr);
+                for (size_t i = 0; i < n; ++i) if (only[i] != want[i].first) return false;
+
+                // Equal keys may carry their values in any order: compare
+                // the pairs sorted by value within each key.
+                kernel(keys.data(), values.data(), n, key_tmp.data(), value_tmp.data());
+                std::vector<std::pair<K, V> > got(n);
+                for (size_t i = 0; i < n; ++i) got[i] = std::make_pair(keys[i], values[i]);
+                for (size_t i = 0; i < n; ++i) if (keys[i] != want[i].first) return false;
+                std::sort(got.begin(), got.end());
+                if (got != want) return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool check_level(const simd::KernelTable& t) {
+    return check_keys<int32_t, uint32_t>(t.sort_i32) && check_keys<int64_t, uint64_t>(t.sort_i64);
+}
+
+// The key mappings of the public functions: unsigned order and float total
+// order, against std::sort with the matching comparison.
+bool check_api() {
+    std::vector<uint32_t> u = random_keys<uint32_t>(10007, 0, 1), uw = u;
+    simd::sort(u.data(), u.size());
+    std::sort(uw.begin(), uw.end());
+    if (u != uw) return false;
+
+    std::vector<float> f(10007);
+    std::mt19937 rng(2);
+    std::normal_distribution<float> normal(0.0f, 100.0f);
+    for (float& x : f) x = normal(rng);
+    f[10] = 0.0f;
+    f[11] = -0.0f;
+    f[12] = std::numeric_limits<float>::infinity();
+    f[13] = -std::numeric_limits<float>::infinity();
+    std::vector<float> fw = f;
+    std::vector<uint32_t> rows(f.size());
+    for (size_t i = 0; i < rows.size(); ++i) rows[i] = (uint32_t)i;
+    std::vector<float> keys = f;
+    simd::sort_pairs(keys.data(), rows.data(), keys.size());
+    std::sort(fw.begin(), fw.end());
+    for (size_t i = 0; i < f.size(); ++i) {
+        if (keys[i] != fw[i] || f[rows[i]] != keys[i]) return false;
+        if (i > 0 && keys[i] == 0.0f && keys[i - 1] == 0.0f && std::signbit(keys[i]) && !std::signbit(keys[i - 1]))
+            return false;
+    }
+    return true;
+}
+
+template <typename F>
+double seconds(F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 3; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return best;
+}
+
+// M keys/s for std::sort and every level. Each run sorts a fresh copy of
+// the input; the time of the copy is taken off.
+template <typename K, typename V, typename Entry>
+void bench(const char* title, size_t n, bool pairs, Entry entry) {
+    std::vector<K> input = random_keys<K>(n, 0, 3), keys(n), key_tmp(n);
+    std::vector<V> values(n), value_tmp(n);
+    std::vector<std::pair<K, V> > both(n);
+    double copy = seconds([&] { keys = input; });
+    std::cout << "  " << std::setw(26) << std::left << title << std::right;
+    double base;
+    if (pairs) {
+        base = seconds([&] {
+            for (size_t i = 0; i < n; ++i) both[i] = std::make_pair(input[i], (V)i);
+            std::sort(both.begin(), both.end(),
+                      [](const std::pair<K, V>& a, const std::pair<K, V>& b) { return a.first < b.first; });
+        });
+    } else {
+        base = seconds([&] {
+            keys = input;
+            std::sort(keys.begin(), keys.end());
+        }) - copy;
+    }
+    std::cout << std::setw(8) << n / base / 1e6;
+    const simd::Isa levels[] = {simd::Isa::Scalar, simd::Isa::AVX2, simd::Isa::AVX512};
+    for (simd::Isa isa : levels) {
+        if (isa > simd::detect_isa()) break;
+        auto kernel = simd::kernels_for(isa).*entry;
+        double sec = seconds([&] {
+            keys = input;
+            kernel(keys.data(), pairs ? values.data() : nullptr, n, key_tmp.data(), value_tmp.data());
+        }) - copy;
+        std::cout << std::setw(8) << n / sec / 1e6 << " (" << std::setw(4) << base / sec << "x)";
+    }
+    std::cout << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::fixed << std::setprecision(1);
+    bool ok = true;
+    const simd::Isa levels[] = {simd::Isa::Scalar, simd::Isa::AVX2, simd::Isa::AVX512};
+    for (simd::Isa isa : levels) {
+        if (isa > simd::detect_isa()) break;
+        bool level_ok = check_level(simd::kernels_for(isa));
+        std::cout << std::setw(7) << simd::isa_name(isa) << " vs std::sort: " << (level_ok ? "OK" : "MISMATCH")
+                  << std::endl;
+        ok &= level_ok;
+    }
+    bool api_ok = check_api();
+    std::cout << "uint32_t and float keys: " << (api_ok ? "OK" : "MISMATCH") << std::endl;
+    ok &= api_ok;
+
+    std::cout << std::endl << "M keys/s, random keys:" << std::endl << "  " << std::setw(26) << std::left << ""
+              << std::right << "std::sort";
+    for (simd::Isa isa : levels) {
+        if (isa > simd::detect_isa()) break;
+        std::cout << std::setw(17) << simd::isa_name(isa);
+    }
+    std::cout << std::endl;
+    for (size_t n : {(size_t)1 << 16, (size_t)1 << 22}) {
+        std::string size = std::to_string(n >> 10) + " K";
+        bench<int32_t, uint32_t>(("int32, " + size).c_str(), n, false, &simd::KernelTable::sort_i32);
+        bench<int32_t, uint32_t>(("int32 + uint32, " + size).c_str(), n, true, &simd::KernelTable::sort_i32);
+        bench<int64_t, uint64_t>(("int64, " + size).c_str(), n, false, &simd::KernelTable::sort_i64);
+        bench<int64_t, uint64_t>(("int64 + uint64, " + size).c_str(), n, true, &simd::KernelTable::sort_i64);
+    }
+    return ok ? 0 : 1;
+}
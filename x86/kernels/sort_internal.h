@@ -0,0 +1,341 @@
+#ifndef SIMD_SORT_INTERNAL_H
+#define SIMD_SORT_INTERNAL_H
+
+// The sorting network and merge sort shared by the per-ISA sort kernels.
+// Everything has internal linkage so each translation unit compiles its own
+// copy with its own flags.
+//
+// The kernels are written once against an Ops struct that describes one
+// vector of L keys:
+//
+//   Key, Payload, Vec, Mask     key and payload types, one vector, one mask
+//   kLanes                      L, a power of two
+//   load(p), store(p, v)        unaligned, for keys and payloads alike
+//   partner<J>(v)               lane i gets lane i ^ J
+//   reverse(v)                  lane i gets lane L - 1 - i
+//   blend<kBits>(a, b)          b in the lanes whose bit is set, else a
+//   min(a, b), max(a, b)
+//   gt(a, b)                    lanes where a > b
+//   blend_mask<kBits>(a, b)     b's lanes where the bit is set, else a's
+//   select(m, a, b)             b where m is set, else a
+//
+// A compare-exchange step of the network takes the partner of every lane,
+// and each lane keeps the min or the max of the two; which one is a
+// constant of the step, so min, max and one blend with an immediate mask do
+// it. With payloads, the lanes that take their partner's key are computed
+// with one compare each way and both vectors are moved by that mask.
+//
+// sort():
+//   1. every block of 4L keys is sorted in registers: a bitonic network per
+//      vector, then two rounds of bitonic merges;
+//   2. the runs are merged pairwise, L keys at a time (Inoue et al.): the
+//      vector with the L largest keys seen so far is held, the next vector
+//      is loaded from the run whose head is smaller, and a two-vector
+//      bitonic merge returns the L smallest to store;
+//   3. merge passes run first inside blocks of kSortBlock keys, which stay
+//      in L2 with their temporary, then over the whole array.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace simd {
+
+namespace {
+
+// Lanes that keep the max at step (J, K) of a bitonic sort of L lanes: lane
+// i is in an ascending block of K when (i & K) == 0, and is the upper lane
+// of its pair when (i & J) != 0.
+constexpr unsigned take_max_bits(unsigned lanes, unsigned j, unsigned k, unsigned i = 0) {
+    return i == lanes ? 0u
+                      : ((((i & j) != 0) != ((i & k) != 0)) ? 1u << i : 0u) | take_max_bits(lanes, j, k, i + 1);
+}
+
+// Keys per cache block of merge passes: 64 KiB of int32 keys, 256 KiB with
+// int64 keys and payloads and their temporaries.
+const size_t kSortBlock = (size_t)1 << 14;
+
+template <typename Ops, bool kPairs>
+struct Sorter {
+    typedef typename Ops::Key K;
+    typedef typename Ops::Payload P;
+    typedef typename Ops::Vec V;
+    typedef typename Ops::Mask M;
+    static const unsigned L = Ops::kLanes;
+
+    // Compare-exchange of every lane with lane ^ J, ascending in blocks
+    // where (i & K) == 0.
+    template <unsigned J, unsigned K_>
+    static void step(V& k, V& p) {
+        const unsigned bits = take_max_bits(L, J, K_);
+        V kp = Ops::template partner<J>(k);
+        if (kPairs) {
+            V pp = Ops::template partner<J>(p);
+            M take = Ops::template blend_mask<bits>(Ops::gt(k, kp), Ops::gt(kp, k));
+            k = Ops::select(take, k, kp);
+            p = Ops::select(take, p, pp);
+        } else {
+            k = Ops::template blend<bits>(Ops::min(k, kp), Ops::max(k, kp));
+        }
+    }
+
+    // Steps J, J / 2, ..., 1 of stage K.
+    template <unsigned J, unsigned K_, bool kDone = (J == 0)>
+    struct Steps {
+        static void run(V& k, V& p) {
+            step<J, K_>(k, p);
+            Steps<J / 2, K_>::run(k, p);
+        }
+    };
+    template <unsigned J, unsigned K_>
+    struct Steps<J, K_, true> {
+        static void run(V&, V&) {}
+    };
+
+    // Stages K, 2K, ..., L of the bitonic sort.
+    template <unsigned K_, bool kDone = (K_ > L)>
+    struct Stages {
+        static void run(V& k, V& p) {
+            Steps<K_ / 2, K_>::run(k, p);
+            Stages<K_ * 2>::run(k, p);
+        }
+    };
+    template <unsigned K_>
+    struct Stages<K_, true> {
+        static void run(V&, V&) {}
+    };
+
+    // Sorts the lanes of one vector.
+    static void sort_vec(V& k, V& p) { Stages<2>::run(k, p); }
+
+    // Sorts one bitonic vector (the last stage of sort_vec).
+    static void merge_vec(V& k, V& p) { Steps<L / 2, L>::run(k, p); }
+
+    // a, b = lane-wise min and max.
+    static void cmpx(V& a, V& pa, V& b, V& pb) {
+        if (kPairs) {
+            M m = Ops::gt(a, b);
+            V lo = Ops::select(m, a, b), plo = Ops::select(m, pa, pb);
+            b = Ops::select(m, b, a);
+            pb = Ops::select(m, pb, pa);
+            a = lo;
+            pa = plo;
+        } else {
+            V lo = Ops::min(a, b);
+            b = Ops::max(a, b);
+            a = lo;
+        }
+    }
+
+    // Two sorted vectors to the 2L keys in order: a then b. a and reversed b
+    // form a bitonic sequence, which one half-cleaner splits in two.
+    static void merge2(V& a, V& pa, V& b, V& pb) {
+        b = Ops::reverse(b);
+        if (kPairs) pb = Ops::reverse(pb);
+        cmpx(a, pa, b, pb);
+        merge_vec(a, pa);
+        merge_vec(b, pb);
+    }
+
+    // Sorts 4L keys in registers.
+    static void sort_block(K* k, P* p) {
+        V a = Ops::load(k), b = Ops::load(k + L), c = Ops::load(k + 2 * L), d = Ops::load(k + 3 * L);
+        V pa = a, pb = b, pc = c, pd = d;
+        if (kPairs) {
+            pa = Ops::load(p);
+            pb = Ops::load(p + L);
+            pc = Ops::load(p + 2 * L);
+            pd = Ops::load(p + 3 * L);
+        }
+        sort_vec(a, pa);
+        sort_vec(b, pb);
+        sort_vec(c, pc);
+        sort_vec(d, pd);
+        merge2(a, pa, b, pb);
+        merge2(c, pc, d, pd);
+        // a b and c d are sorted runs of 2L; a b against reversed c d.
+        V rc = Ops::reverse(c), rd = Ops::reverse(d), prc = pc, prd = pd;
+        if (kPairs) {
+            prc = Ops::reverse(pc);
+            prd = Ops::reverse(pd);
+        }
+        cmpx(a, pa, rd, prd);
+        cmpx(b, pb, rc, prc);
+        cmpx(a, pa, b, pb);
+        cmpx(rd, prd, rc, prc);
+        merge_vec(a, pa);
+        merge_vec(b, pb);
+        merge_vec(rd, prd);
+        merge_vec(rc, prc);
+        Ops::store(k, a);
+        Ops::store(k + L, b);
+        Ops::store(k + 2 * L, rd);
+        Ops::store(k + 3 * L, rc);
+        if (kPairs) {
+            Ops::store(p, pa);
+            Ops::store(p + L, pb);
+            Ops::store(p + 2 * L, prd);
+            Ops::store(p + 3 * L, prc);
+        }
+    }
+
+    // Payload pointers are null without payloads.
+    static P* at(P* p, size_t i) { return kPairs ? p + i : p; }
+    static const P* at(const P* p, size_t i) { return kPairs ? p + i : p; }
+
+    static void insertion_sort(K* k, P* p, size_t n) {
+        for (size_t i = 1; i < n; ++i) {
+            K key = k[i];
+            P pay = kPairs ? p[i] : P();
+            size_t j = i;
+            for (; j > 0 && k[j - 1] > key; --j) {
+                k[j] = k[j - 1];
+                if (kPairs) p[j] = p[j - 1];
+            }
+            k[j] = key;
+            if (kPairs) p[j] = pay;
+        }
+    }
+
+    static void merge_scalar(const K* a, const P* pa, size_t na, const K* b, const P* pb, size_t nb, K* out,
+                             P* po) {
+        size_t i = 0, j = 0, o = 0;
+        while (i < na && j < nb) {
+            bool from_b = b[j] < a[i];
+            out[o] = from_b ? b[j] : a[i];
+            if (kPairs) po[o] = from_b ? pb[j] : pa[i];
+            ++o;
+            j += from_b;
+            i += !from_b;
+        }
+        std::memcpy(out + o, a + i, (na - i) * sizeof(K));
+        std::memcpy(out + o + na - i, b + j, (nb - j) * sizeof(K));
+        if (kPairs) {
+            std::memcpy(po + o, pa + i, (na - i) * sizeof(P));
+            std::memcpy(po + o + na - i, pb + j, (nb - j) * sizeof(P));
+        }
+    }
+
+    // Merges the sorted runs a and b into out.
+    static void merge_runs(const K* a, const P* pa, size_t na, const K* b, const P* pb, size_t nb, K* out,
+                           P* po) {
+        if (na < L || nb < L) {
+            merge_scalar(a, pa, na, b, pb, nb, out, po);
+            return;
+        }
+        V lo = Ops::load(a), hi = Ops::load(b), plo = lo, phi = hi;
+        if (kPairs) {
+            plo = Ops::load(pa);
+            phi = Ops::load(pb);
+        }
+        a += L;
+        b += L;
+        pa = at(pa, L);
+        pb = at(pb, L);
+        na -= L;
+        nb -= L;
+        for (;;) {
+            merge2(lo, plo, hi, phi);
+            Ops::store(out, lo);
+            if (kPairs) Ops::store(po, plo);
+            out += L;
+            po = at(po, L);
+            if (na < L || nb < L) break;
+            // hi holds the L largest keys so far; every key left is at
+            // least the head of its run, so the smaller head comes next.
+            bool from_a = *a <= *b;
+            lo = Ops::load(from_a ? a : b);
+            if (kPairs) plo = Ops::load(from_a ? pa : pb);
+            size_t adv_a = from_a ? L : 0, adv_b = L - adv_a;
+            a += adv_a;
+            na -= adv_a;
+            pa = at(pa, adv_a);
+            b += adv_b;
+            nb -= adv_b;
+            pb = at(pb, adv_b);
+        }
+        // hi, the short tail (under L keys) and the long one: merge the
+        // first two on the stack, then the result with the long tail.
+        K held[2 * L], merged[2 * L];
+        P pheld[2 * L], pmerged[2 * L];
+        Ops::store(held, hi);
+        if (kPairs) Ops::store(pheld, phi);
+        if (na < L) {
+            merge_scalar(held, pheld, L, a, pa, na, merged, pmerged);
+            merge_scalar(merged, pmerged, L + na, b, pb, nb, out, po);
+        } else {
+            merge_scalar(held, pheld, L, b, pb, nb, merged, pmerged);
+            merge_scalar(merged, pmerged, L + nb, a, pa, na, out, po);
+        }
+    }
+
+    // One pass over n keys: runs of `run` merged pairwise from src to dst.
+    // A last run without a partner is copied.
+    static void merge_pass(const K* src, const P* ps, K* dst, P* pd, size_t n, size_t run) {
+        for (size_t i = 0; i < n; i += 2 * run) {
+            size_t na = run < n - i ? run : n - i;
+            size_t nb = run < n - i - na ? run : n - i - na;
+            merge_runs(src + i, at(ps, i), na, src + i + na, at(ps, i + na), nb, dst + i, at(pd, i));
+        }
+    }
+
+    static void swap(K*& a, K*& b, P*& pa, P*& pb) {
+        K* t = a;
+        a = b;
+        b = t;
+        P* pt = pa;
+        pa = pb;
+        pb = pt;
+    }
+
+    static void sort(K* keys, P* values, size_t n, K* key_tmp, P* value_tmp) {
+        const size_t block = 4 * L;
+        size_t full = n / block * block;
+        for (size_t i = 0; i < full; i += block) sort_block(keys + i, at(values, i));
+        insertion_sort(keys + full, at(values, full), n - full);
+        if (n <= block) return;
+
+        K *src = keys, *dst = key_tmp;
+        P *ps = values, *pd = value_tmp;
+        size_t run = block;
+        if (n > kSortBlock) {
+            // Every cache block takes the same passes, so all of them end
+            // up in the same buffer.
+            for (size_t b = 0; b < n; b += kSortBlock) {
+                size_t m = kSortBlock < n - b ? kSortBlock : n - b;
+                K *s = src + b, *d = dst + b;
+                P *s_p = at(ps, b), *d_p = at(pd, b);
+                for (size_t r = run; r < kSortBlock; r *= 2) {
+                    merge_pass(s, s_p, d, d_p, m, r);
+                    swap(s, d, s_p, d_p);
+                }
+            }
+            for (; run < kSortBlock; run *= 2) swap(src, dst, ps, pd);
+        }
+        for (; run < n; run *= 2) {
+            merge_pass(src, ps, dst, pd, n, run);
+            swap(src, dst, ps, pd);
+        }
+        if (src != keys) {
+            std::memcpy(keys, src, n * sizeof(K));
+            if (kPairs) std::memcpy(values, ps, n * sizeof(P));
+        }
+    }
+};
+
+// Keys-only or with payloads, as the kernels are called.
+template <typename Ops>
+inline void sort_keys(typename Ops::Key* keys, typename Ops::Payload* values, size_t n, typename Ops::Key* key_tmp,
+                      typename Ops::Payload* value_tmp) {
+    if (values) {
+        Sorter<Ops, true>::sort(keys, values, n, key_tmp, value_tmp);
+    } else {
+        Sorter<Ops, false>::sort(keys, values, n, key_tmp, value_tmp);
+    }
+}
+
+} // namespace
+
+} // namespace simd
+
+#endif // SIMD_SORT_INTERNAL_H
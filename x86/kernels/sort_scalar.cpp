@@ -0,0 +1,47 @@
+#include "kernels_internal.h"
+#include "sort_internal.h"
+
+namespace simd {
+namespace scalar {
+
+namespace {
+
+// One lane: the network degenerates to compare-exchanges of whole keys and
+// the merge to a branchless scalar merge that holds the larger head.
+template <typename K, typename P>
+struct Ops1 {
+    typedef K Key;
+    typedef P Payload;
+    typedef K Vec;
+    typedef bool Mask;
+    static const unsigned kLanes = 1;
+
+    template <typename T>
+    static Vec load(const T* p) { return (Vec)*p; }
+    template <typename T>
+    static void store(T* p, Vec v) { *p = (T)v; }
+    template <unsigned J>
+    static Vec partner(Vec v) { return v; }
+    static Vec reverse(Vec v) { return v; }
+    template <unsigned kBits>
+    static Vec blend(Vec a, Vec b) { return (kBits & 1) ? b : a; }
+    static Vec min(Vec a, Vec b) { return b < a ? b : a; }
+    static Vec max(Vec a, Vec b) { return a < b ? b : a; }
+    static Mask gt(Vec a, Vec b) { return a > b; }
+    template <unsigned kBits>
+    static Mask blend_mask(Mask a, Mask b) { return (kBits & 1) ? b : a; }
+    static Vec select(Mask m, Vec a, Vec b) { return m ? b : a; }
+};
+
+} // namespace
+
+void sort_i32(int32_t* keys, uint32_t* values, size_t n, int32_t* key_tmp, uint32_t* value_tmp) {
+    sort_keys<Ops1<int32_t, uint32_t> >(keys, values, n, key_tmp, value_tmp);
+}
+
+void sort_i64(int64_t* keys, uint64_t* values, size_t n, int64_t* key_tmp, uint64_t* value_tmp) {
+    sort_keys<Ops1<int64_t, uint64_t> >(keys, values, n, key_tmp, value_tmp);
+}
+
+} // namespace scalar
+} // namespace simd
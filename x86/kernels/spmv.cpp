@@ -0,0 +1,47 @@
+#include "spmv.h"
+#include "dispatch.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace simd {
+
+namespace {
+
+// Below this many nonzeros, starting threads costs more than the product.
+const int64_t kMinNnzPerThread = 1 << 15;
+
+// First row of part `part` of `parts`, chosen so that each part covers about
+// nnz / parts nonzeros.
+size_t partition_row(const CsrMatrix& a, size_t part, size_t parts) {
+    int64_t nnz = a.row_ptr[a.rows];
+    int64_t target = (int64_t)((double)nnz * part / parts);
+    return (size_t)(std::lower_bound(a.row_ptr, a.row_ptr + a.rows, target) - a.row_ptr);
+}
+
+} // namespace
+
+void spmv(const CsrMatrix& a, const float* x, float* y, unsigned threads) {
+    const KernelTable& k = kernels();
+    int64_t nnz = a.row_ptr[a.rows];
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = (unsigned)std::min<int64_t>(threads, std::max<int64_t>(1, nnz / kMinNnzPerThread));
+    if (threads <= 1) {
+        k.spmv_f32(a, x, y, 0, a.rows);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) {
+        size_t begin = partition_row(a, t, threads);
+        size_t end = t + 1 == threads ? a.rows : partition_row(a, t + 1, threads);
+        workers.emplace_back(k.spmv_f32, std::cref(a), x, y, begin, end);
+    }
+    k.spmv_f32(a, x, y, 0, partition_row(a, 1, threads));
+    for (std::thread& w : workers) w.join();
+}
+
+} // namespace simd
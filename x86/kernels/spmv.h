@@ -0,0 +1,32 @@
+#ifndef SIMD_SPMV_H
+#define SIMD_SPMV_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+// Sparse matrix in compressed sparse row (CSR) form. Row r holds the entries
+// values[k], at column col_idx[k], for k in [row_ptr[r], row_ptr[r + 1]).
+// Column indices are 32-bit because that is what the gather instructions
+// take; row_ptr is 64-bit so nnz itself is not limited.
+struct CsrMatrix {
+    size_t rows;
+    size_t cols;
+    const int64_t* row_ptr;  // rows + 1 entries, row_ptr[0] == 0
+    const int32_t* col_idx;  // nnz entries, each in [0, cols)
+    const float* values;     // nnz entries
+};
+
+// y = A * x, with x of length a.cols and y of length a.rows.
+//
+// Rows are split between `threads` threads (0: one per hardware thread) so
+// that each gets about the same number of nonzeros, not the same number of
+// rows: in power-law matrices a few rows hold most of the work. Small
+// matrices run on the calling thread. Summation order within a row depends on
+// the ISA level, so results can differ in the last bits between levels.
+void spmv(const CsrMatrix& a, const float* x, float* y, unsigned threads = 0);
+
+} // namespace simd
+
+#endif // SIMD_SPMV_H
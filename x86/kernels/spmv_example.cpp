@@ -0,0 +1,181 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <cstdint>
+#include "dispatch.h"
+#include "spmv.h"
+
+// A CSR matrix that owns its arrays.
+struct Matrix {
+    const char* name;
+    size_t rows, cols;
+    std::vector<int64_t> row_ptr;
+    std::vector<int32_t> col_idx;
+    std::vector<float> values;
+
+    simd::CsrMatrix view() const {
+        simd::CsrMatrix m = {rows, cols, row_ptr.data(), col_idx.data(), values.data()};
+        return m;
+    }
+};
+
+// Appends one row and closes it.
+void push_row(Matrix& m, const std::vector<int32_t>& cols, std::mt19937& rng) {
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    for (int32_t c : cols) {
+        m.col_idx.push_back(c);
+        m.values.push_back(value(rng));
+    }
+    m.row_ptr.push_back((int64_t)m.col_idx.size());
+}
+
+// The three shapes below stand in for common SuiteSparse families.
+
+// Finite-element / stencil matrices: 27 entries in a band around the
+// diagonal. Consecutive rows reuse the same x-values, so gathers hit L1.
+Matrix banded(size_t n) {
+    Matrix m = {"banded, 27/row (FEM-like)", n, n, {0}, {}, {}};
+    std::mt19937 rng(1);
+    std::vector<int32_t> cols;
+    for (size_t r = 0; r < n; ++r) {
+        cols.clear();
+        for (int d = -13; d <= 13; ++d) {
+            int64_t c = (int64_t)r + d * 3;
+            if (c >= 0 && c < (int64_t)n) cols.push_back((int32_t)c);
+        }
+        push_row(m, cols, rng);
+    }
+    return m;
+}
+
+// Web and social graphs: row lengths follow a power law (most rows have a
+// handful of entries, a few have thousands) and columns are random.
+Matrix power_law(size_t n) {
+    Matrix m = {"power-law, random columns (graph-like)", n, n, {0}, {}, {}};
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::uniform_int_distribution<int32_t> col(0, (int32_t)n - 1);
+    std::vector<int32_t> cols;
+    for (size_t r = 0; r < n; ++r) {
+        // Pareto with alpha = 1.5 and minimum 2: mean 6, heavy tail.
+        size_t len = std::min<size_t>(4096, (size_t)(2.0 / std::pow(1.0 - u(rng), 1.0 / 1.5)));
+        cols.resize(len);
+        for (int32_t& c : cols) c = col(rng);
+        push_row(m, cols, rng);
+    }
+    return m;
+}
+
+// Sparse feature layers: few entries per row spread over a wide x (16 MiB),
+// so almost every gather element misses the cache.
+Matrix short_rows(size_t n, size_t cols_count) {
+    Matrix m = {"4/row over 4M columns (recommender-like)", n, cols_count, {0}, {}, {}};
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int32_t> col(0, (int32_t)cols_count - 1);
+    std::vector<int32_t> cols(4);
+    for (size_t r = 0; r < n; ++r) {
+        for (int32_t& c : cols) c = col(rng);
+        push_row(m, cols, rng);
+    }
+    return m;
+}
+
+// y against the scalar kernel, relative to the magnitude of each row.
+bool check_level(const simd::KernelTable& t, const Matrix& m, const std::vector<float>& x) {
+    simd::CsrMatrix a = m.view();
+    std::vector<float> y(m.rows), ref(m.rows);
+    t.spmv_f32(a, x.data(), y.data(), 0, m.rows);
+    simd::kernels_for(simd::Isa::Scalar).spmv_f32(a, x.data(), ref.data(), 0, m.rows);
+    for (size_t r = 0; r < m.rows; ++r) {
+        double scale = 0.0;
+        for (int64_t k = m.row_ptr[r]; k < m.row_ptr[r + 1]; ++k) {
+            scale += std::fabs(m.values[k] * x[m.col_idx[k]]);
+        }
+        if (std::fabs(y[r] - ref[r]) > 1e-5 * scale + 1e-30) return false;
+    }
+    return true;
+}
+
+template <typename F>
+double gflops(const Matrix& m, F run) {
+    run(); // warm up caches and page tables
+    const int reps = 5;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) run();
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return 2.0 * m.row_ptr.back() * reps / sec / 1e9;
+}
+
+static const simd::Isa levels[] = {simd::Isa::Scalar, simd::Isa::SSE41, simd::Isa::AVX,
+                                   simd::Isa::AVX2, simd::Isa::AVX512};
+
+bool benchmark(const Matrix& m) {
+    std::cout << std::endl << "[" << m.name << "]" << std::endl;
+    std::cout << m.rows << " rows, " << m.row_ptr.back() << " nonzeros" << std::endl;
+    std::vector<float> x(m.cols), y(m.rows);
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    for (float& v : x) v = value(rng);
+    simd::CsrMatrix a = m.view();
+
+    // Single thread, every level: where does the hardware gather win?
+    bool all_ok = true;
+    double scalar_gflops = 0.0;
+    for (simd::Isa isa : levels) {
+        if (isa > simd::kernels().isa) break;
+        const simd::KernelTable& t = simd::kernels_for(isa);
+        bool ok = check_level(t, m, x);
+        all_ok &= ok;
+        double g = gflops(m, [&] { t.spmv_f32(a, x.data(), y.data(), 0, m.rows); });
+        if (isa == simd::Isa::Scalar) scalar_gflops = g;
+        std::cout << std::setw(8) << simd::isa_name(isa) << ": " << std::fixed << std::setprecision(2)
+                  << g << " GFLOP/s (" << g / scalar_gflops << "x)" << (ok ? "" : "  MISMATCH")
+                  << std::endl;
+    }
+
+    // Threads, detected level.
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1;; threads = std::min(threads * 2, hw)) { // 1, 2, 4, ..., hw
+        double g = gflops(m, [&] { simd::spmv(a, x.data(), y.data(), threads); });
+        std::cout << std::setw(3) << threads << " threads: " << g << " GFLOP/s" << std::endl;
+        if (threads == hw) break;
+    }
+    return all_ok;
+}
+
+int main() {
+    std::cout << "--- CSR SpMV with Hardware Gathers ---" << std::endl;
+    std::cout << "Detected level: " << simd::isa_name(simd::kernels().isa) << std::endl;
+
+    // =================================================================
+    // 1. Usage: a 4x4 Matrix
+    // =================================================================
+    // [ 1 0 2 0 ]   [1]   [ 7]
+    // [ 0 3 0 0 ] * [2] = [ 6]
+    // [ 0 0 0 0 ]   [3]   [ 0]
+    // [ 4 0 5 6 ]   [4]   [43]
+    std::vector<int64_t> row_ptr = {0, 2, 3, 3, 6};
+    std::vector<int32_t> col_idx = {0, 2, 1, 0, 2, 3};
+    std::vector<float> values = {1, 2, 3, 4, 5, 6};
+    simd::CsrMatrix small = {4, 4, row_ptr.data(), col_idx.data(), values.data()};
+    float x4[4] = {1, 2, 3, 4};
+    float y4[4];
+    simd::spmv(small, x4, y4);
+    std::cout << std::endl << "A * [1 2 3 4] = [" << y4[0] << " " << y4[1] << " " << y4[2] << " " << y4[3]
+              << "]" << std::endl;
+
+    // =================================================================
+    // 2. Benchmark on Synthetic Matrices
+    // =================================================================
+    bool ok = true;
+    ok &= benchmark(banded(1 << 19));
+    ok &= benchmark(power_law(1 << 19));
+    ok &= benchmark(short_rows(1 << 20, 1 << 22));
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,17 @@
+#include "kernels_internal.h"
+
+namespace simd {
+namespace scalar {
+
+void spmv_f32(const CsrMatrix& a, const float* x, float* y, size_t row_begin, size_t row_end) {
+    for (size_t r = row_begin; r < row_end; ++r) {
+        float sum = 0.0f;
+        for (int64_t k = a.row_ptr[r]; k < a.row_ptr[r + 1]; ++k) {
+            sum += a.values[k] * x[a.col_idx[k]];
+        }
+        y[r] = sum;
+    }
+}
+
+} // namespace scalar
+} // namespace simd
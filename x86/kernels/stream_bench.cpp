@@ -0,0 +1,265 @@
+// STREAM-style bandwidth benchmark: copy, scale, add and triad for every
+// vector width and load/store flavor the CPU supports, over working sets from
+// L1 to DRAM and over thread counts. Results go to stdout (or --output) as
+// JSON; progress goes to stderr.
+//
+//   stream_bench [--quick] [--threads=1,2,8] [--max-mib=N] [--output=FILE]
+//
+// Bandwidth is counted the STREAM way: bytes the kernel reads plus bytes it
+// writes (copy and scale 8 per element, add and triad 12). The read-for-
+// ownership that regular stores cause is not counted, which is exactly the
+// traffic that streaming stores save.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include "cpu_features.h"
+#include "dispatch.h"
+#include "stream_bench.h"
+
+namespace {
+
+struct Options {
+    bool quick = false;
+    std::vector<unsigned> threads;
+    size_t max_bytes = 0;  // 0: 4x the LLC
+    std::string output;
+};
+
+// One flavor as run: a kernel set plus whether its sources are offset by one
+// float, so that vector loads straddle cache lines.
+struct Variant {
+    const simd::stream::Flavor* f;
+    bool misaligned;
+};
+
+enum Op { kCopy, kScale, kAdd, kTriad };
+const char* const kOpNames[] = {"copy", "scale", "add", "triad"};
+const size_t kOpBytes[] = {8, 8, 12, 12};
+const float kScalar = 3.0f;
+
+// Three arrays of n floats, 64-byte aligned, with room for a one-float offset.
+// The memory is left untouched, so that pages are placed by the first thread
+// that writes them.
+struct Arrays {
+    std::unique_ptr<float[]> storage;
+    float* a;
+    float* b;
+    float* c;
+    size_t n;
+
+    explicit Arrays(size_t n_) : storage(new float[3 * (n_ + 32)]), n(n_) {
+        float* p = storage.get();
+        p = (float*)(((uintptr_t)p + 63) & ~(uintptr_t)63);
+        a = p;
+        b = a + n + 16;
+        c = b + n + 16;
+    }
+};
+
+// Runs body(t) on `threads` threads (the calling one included) and returns
+// the wall time in seconds from the first start to the last finish.
+template <typename F>
+double run_threads(unsigned threads, F body) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) workers.emplace_back(body, t);
+    body(0);
+    for (std::thread& w : workers) w.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Each thread owns a contiguous slice of every array, as in STREAM's static
+// OpenMP schedule. Slices are multiples of 64 floats.
+size_t slice_of(size_t n, unsigned threads) {
+    return n / threads / 64 * 64;
+}
+
+void run_op(const Variant& v, Op op, const Arrays& m, size_t begin, size_t len) {
+    const simd::stream::Kernels& k = v.f->k;
+    size_t off = v.misaligned ? 1 : 0;
+    float* a = m.a + begin;
+    float* b = m.b + begin;
+    float* c = m.c + begin;
+    switch (op) {
+        case kCopy:  k.copy(c, a + off, len); break;
+        case kScale: k.scale(b, c + off, kScalar, len); break;
+        case kAdd:   k.add(c, a + off, b + off, len); break;
+        case kTriad: k.triad(a, b + off, c + off, kScalar, len); break;
+    }
+}
+
+// Best bandwidth in GB/s of three timed runs. Each run repeats the kernel
+// often enough to last about `target` seconds, so that thread start-up is
+// noise.
+double measure(const Variant& v, Op op, const Arrays& m, unsigned threads, double target) {
+    size_t slice = slice_of(m.n, threads);
+    size_t reps = 1;
+    auto body = [&](unsigned t) {
+        for (size_t r = 0; r < reps; ++r) run_op(v, op, m, t * slice, slice);
+    };
+    // Calibrate (this also warms caches and TLBs).
+    for (;;) {
+        double sec = run_threads(threads, body);
+        if (sec >= target / 4 || reps >= ((size_t)1 << 30)) {
+            reps = std::max<size_t>(1, (size_t)((double)reps * target / std::max(sec, 1e-9)));
+            break;
+        }
+        reps *= 4;
+    }
+    double best = 1e30;
+    for (int trial = 0; trial < 3; ++trial) best = std::min(best, run_threads(threads, body));
+    return (double)kOpBytes[op] * slice * threads * reps / best / 1e9;
+}
+
+// Runs every kernel of `v` once on small arrays with exactly representable
+// values and checks the results, so a broken flavor cannot report numbers.
+bool check_variant(const Variant& v) {
+    const size_t n = 1024;
+    Arrays m(n);
+    for (size_t i = 0; i < n + 16; ++i) {
+        m.a[i] = (float)(i % 13);
+        m.b[i] = (float)(i % 7);
+        m.c[i] = 0.0f;
+    }
+    size_t off = v.misaligned ? 1 : 0;
+    std::vector<float> a(m.a, m.a + n + 16), b(m.b, m.b + n + 16), c(m.c, m.c + n + 16);
+    // Apply the four kernels in order to the reference too.
+    for (size_t i = 0; i < n; ++i) c[i] = a[i + off];
+    for (size_t i = 0; i < n; ++i) b[i] = kScalar * c[i + off];
+    for (size_t i = 0; i < n; ++i) c[i] = a[i + off] + b[i + off];
+    for (size_t i = 0; i < n; ++i) a[i] = b[i + off] + kScalar * c[i + off];
+    for (int op = kCopy; op <= kTriad; ++op) run_op(v, (Op)op, m, 0, n);
+    return std::equal(a.begin(), a.begin() + n, m.a) && std::equal(b.begin(), b.begin() + n, m.b) &&
+           std::equal(c.begin(), c.begin() + n, m.c);
+}
+
+std::vector<Variant> supported_variants() {
+    typedef const simd::stream::Flavor* (*List)(size_t*);
+    const List lists[] = {simd::stream::flavors_scalar, simd::stream::flavors_sse41,
+                          simd::stream::flavors_avx, simd::stream::flavors_avx512};
+    std::vector<Variant> out;
+    for (List list : lists) {
+        size_t count;
+        const simd::stream::Flavor* f = list(&count);
+        for (size_t i = 0; i < count; ++i) {
+            // The SIMD_ISA cap applies here too.
+            if (f[i].isa > simd::kernels().isa) continue;
+            out.push_back(Variant{&f[i], false});
+            bool unaligned_load = std::strcmp(f[i].load, "loadu") == 0 || std::strcmp(f[i].load, "lddqu") == 0;
+            if (unaligned_load) out.push_back(Variant{&f[i], true});
+        }
+    }
+    return out;
+}
+
+bool parse_args(int argc, char** argv, Options* o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--quick") {
+            o->quick = true;
+        } else if (arg.compare(0, 10, "--threads=") == 0) {
+            std::stringstream list(arg.substr(10));
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                int t = std::atoi(item.c_str());
+                if (t <= 0) return false;
+                o->threads.push_back((unsigned)t);
+            }
+        } else if (arg.compare(0, 10, "--max-mib=") == 0) {
+            o->max_bytes = (size_t)std::atoll(arg.c_str() + 10) << 20;
+        } else if (arg.compare(0, 9, "--output=") == 0) {
+            o->output = arg.substr(9);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, &opt)) {
+        std::cerr << "usage: " << argv[0] << " [--quick] [--threads=1,2,...] [--max-mib=N] [--output=FILE]"
+                  << std::endl;
+        return 2;
+    }
+    const simd::CpuFeatures& f = simd::cpu_features();
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    if (opt.threads.empty()) {
+        for (unsigned t = 1;; t = std::min(t * 2, hw)) { // 1, 2, 4, ..., hw
+            opt.threads.push_back(t);
+            if (t == hw) break;
+        }
+    }
+    size_t llc = f.llc_bytes ? f.llc_bytes : (size_t)32 << 20;
+    size_t max_bytes = opt.max_bytes ? opt.max_bytes : std::min((size_t)1 << 30, 4 * llc);
+    double target = opt.quick ? 0.002 : 0.01;
+    size_t step = opt.quick ? 4 : 2;
+
+    std::vector<Variant> variants = supported_variants();
+    bool all_ok = true;
+    for (const Variant& v : variants) {
+        if (!check_variant(v)) {
+            std::cerr << "MISMATCH: " << simd::isa_name(v.f->isa) << " " << v.f->load << "/" << v.f->store
+                      << (v.misaligned ? " misaligned" : "") << std::endl;
+            all_ok = false;
+        }
+    }
+
+    std::ofstream file;
+    if (!opt.output.empty()) file.open(opt.output.c_str());
+    std::ostream& out = opt.output.empty() ? std::cout : file;
+
+    out << "{\n";
+    out << "  \"cpu\": {\"isa\": \"" << simd::isa_name(simd::kernels().isa) << "\", \"l1d_bytes\": " << f.l1d_bytes
+        << ", \"l2_bytes\": " << f.l2_bytes << ", \"llc_bytes\": " << f.llc_bytes
+        << ", \"hardware_threads\": " << hw << "},\n";
+    out << "  \"verified\": " << (all_ok ? "true" : "false") << ",\n";
+    out << "  \"results\": [";
+    bool first = true;
+    // Working set = all three arrays, starting well inside L1.
+    for (size_t bytes = 12 << 10; bytes <= max_bytes; bytes *= step) {
+        size_t n = bytes / 3 / sizeof(float) / 64 * 64;
+        Arrays m(n);
+        for (unsigned threads : opt.threads) {
+            if (slice_of(n, threads) == 0) continue;
+            std::cerr << "working set " << (bytes >> 10) << " KiB, " << threads << " threads" << std::endl;
+            // First touch on the thread that will use each slice.
+            size_t slice = slice_of(n, threads);
+            run_threads(threads, [&](unsigned t) {
+                size_t end = t + 1 == threads ? n + 16 : (t + 1) * slice;
+                for (size_t i = t * slice; i < end; ++i) {
+                    m.a[i] = 1.0f;
+                    m.b[i] = 2.0f;
+                    m.c[i] = 0.0f;
+                }
+            });
+            for (const Variant& v : variants) {
+                for (int op = kCopy; op <= kTriad; ++op) {
+                    double gbps = measure(v, (Op)op, m, threads, target);
+                    out << (first ? "\n" : ",\n") << "    {\"kernel\": \"" << kOpNames[op] << "\", \"isa\": \""
+                        << simd::isa_name(v.f->isa) << "\", \"bits\": " << v.f->bits << ", \"load\": \""
+                        << v.f->load << "\", \"misaligned\": " << (v.misaligned ? "true" : "false")
+                        << ", \"store\": \"" << v.f->store << "\", \"working_set_bytes\": " << 3 * n * sizeof(float)
+                        << ", \"threads\": " << threads << ", \"gbps\": " << gbps << "}";
+                    first = false;
+                }
+            }
+        }
+    }
+    out << "\n  ]\n}\n";
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+#ifndef SIMD_STREAM_BENCH_H
+#define SIMD_STREAM_BENCH_H
+
+// Kernels of stream_bench, one set per vector width and load/store flavor.
+// Like kernels_internal.h, each level lives in a translation unit compiled
+// with that level's flags, and the driver only runs flavors of levels the CPU
+// supports.
+
+#include <cstddef>
+#include "dispatch.h"
+
+namespace simd {
+namespace stream {
+
+// The four STREAM kernels. n is a multiple of 64 and every array is aligned
+// to 64 bytes, except that the sources of unaligned-load flavors may be
+// offset; destinations are always aligned (streaming stores require it).
+struct Kernels {
+    void (*copy)(float* c, const float* a, size_t n);                     // c = a
+    void (*scale)(float* b, const float* c, float s, size_t n);           // b = s * c
+    void (*add)(float* c, const float* a, const float* b, size_t n);      // c = a + b
+    void (*triad)(float* a, const float* b, const float* c, float s, size_t n); // a = b + s * c
+};
+
+struct Flavor {
+    Isa isa;            // level the flavor needs
+    int bits;           // vector width, 0 for plain C++
+    const char* load;   // "load", "loadu", "lddqu" or "scalar"
+    const char* store;  // "store", "stream" or "scalar"
+    Kernels k;
+};
+
+// Flavors of each level; the count is returned in *n.
+const Flavor* flavors_scalar(size_t* n);
+const Flavor* flavors_sse41(size_t* n);
+const Flavor* flavors_avx(size_t* n);
+const Flavor* flavors_avx512(size_t* n);
+
+} // namespace stream
+} // namespace simd
+
+#endif // SIMD_STREAM_BENCH_H
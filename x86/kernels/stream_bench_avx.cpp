@@ -0,0 +1,70 @@
+#include "stream_bench.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace stream {
+
+// 256-bit flavors: the same kernels with ymm registers. Without FMA (AVX2),
+// triad is a separate multiply and add, as in the 128-bit version.
+
+namespace {
+
+struct Load  { static __m256 get(const float* p) { return _mm256_load_ps(p); } };
+struct LoadU { static __m256 get(const float* p) { return _mm256_loadu_ps(p); } };
+struct LdDqu { static __m256 get(const float* p) { return _mm256_castsi256_ps(_mm256_lddqu_si256((const __m256i*)p)); } };
+
+struct Store {
+    static void put(float* p, __m256 v) { _mm256_store_ps(p, v); }
+    static void done() {}
+};
+struct Stream {
+    static void put(float* p, __m256 v) { _mm256_stream_ps(p, v); }
+    static void done() { _mm_sfence(); }
+};
+
+template <typename L, typename S>
+struct K {
+    static void copy(float* c, const float* a, size_t n) {
+        for (size_t i = 0; i < n; i += 8) S::put(c + i, L::get(a + i));
+        S::done();
+    }
+    static void scale(float* b, const float* c, float s, size_t n) {
+        const __m256 vs = _mm256_set1_ps(s);
+        for (size_t i = 0; i < n; i += 8) S::put(b + i, _mm256_mul_ps(vs, L::get(c + i)));
+        S::done();
+    }
+    static void add(float* c, const float* a, const float* b, size_t n) {
+        for (size_t i = 0; i < n; i += 8) S::put(c + i, _mm256_add_ps(L::get(a + i), L::get(b + i)));
+        S::done();
+    }
+    static void triad(float* a, const float* b, const float* c, float s, size_t n) {
+        const __m256 vs = _mm256_set1_ps(s);
+        for (size_t i = 0; i < n; i += 8) S::put(a + i, _mm256_add_ps(L::get(b + i), _mm256_mul_ps(vs, L::get(c + i))));
+        S::done();
+    }
+};
+
+#define FLAVOR(L, S, load, store) \
+    {Isa::AVX, 256, load, store, {K<L, S>::copy, K<L, S>::scale, K<L, S>::add, K<L, S>::triad}}
+
+const Flavor kFlavors[] = {
+    FLAVOR(Load, Store, "load", "store"),
+    FLAVOR(LoadU, Store, "loadu", "store"),
+    FLAVOR(LdDqu, Store, "lddqu", "store"),
+    FLAVOR(Load, Stream, "load", "stream"),
+    FLAVOR(LoadU, Stream, "loadu", "stream"),
+    FLAVOR(LdDqu, Stream, "lddqu", "stream"),
+};
+
+#undef FLAVOR
+
+} // namespace
+
+const Flavor* flavors_avx(size_t* n) {
+    *n = sizeof(kFlavors) / sizeof(kFlavors[0]);
+    return kFlavors;
+}
+
+} // namespace stream
+} // namespace simd
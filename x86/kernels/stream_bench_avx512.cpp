@@ -0,0 +1,67 @@
+#include "stream_bench.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace stream {
+
+// 512-bit flavors. There is no 512-bit lddqu; triad uses FMA. Every vector
+// is a full cache line, so an offset source splits every single load.
+
+namespace {
+
+struct Load  { static __m512 get(const float* p) { return _mm512_load_ps(p); } };
+struct LoadU { static __m512 get(const float* p) { return _mm512_loadu_ps(p); } };
+
+struct Store {
+    static void put(float* p, __m512 v) { _mm512_store_ps(p, v); }
+    static void done() {}
+};
+struct Stream {
+    static void put(float* p, __m512 v) { _mm512_stream_ps(p, v); }
+    static void done() { _mm_sfence(); }
+};
+
+template <typename L, typename S>
+struct K {
+    static void copy(float* c, const float* a, size_t n) {
+        for (size_t i = 0; i < n; i += 16) S::put(c + i, L::get(a + i));
+        S::done();
+    }
+    static void scale(float* b, const float* c, float s, size_t n) {
+        const __m512 vs = _mm512_set1_ps(s);
+        for (size_t i = 0; i < n; i += 16) S::put(b + i, _mm512_mul_ps(vs, L::get(c + i)));
+        S::done();
+    }
+    static void add(float* c, const float* a, const float* b, size_t n) {
+        for (size_t i = 0; i < n; i += 16) S::put(c + i, _mm512_add_ps(L::get(a + i), L::get(b + i)));
+        S::done();
+    }
+    static void triad(float* a, const float* b, const float* c, float s, size_t n) {
+        const __m512 vs = _mm512_set1_ps(s);
+        for (size_t i = 0; i < n; i += 16) S::put(a + i, _mm512_fmadd_ps(vs, L::get(c + i), L::get(b + i)));
+        S::done();
+    }
+};
+
+#define FLAVOR(L, S, load, store) \
+    {Isa::AVX512, 512, load, store, {K<L, S>::copy, K<L, S>::scale, K<L, S>::add, K<L, S>::triad}}
+
+const Flavor kFlavors[] = {
+    FLAVOR(Load, Store, "load", "store"),
+    FLAVOR(LoadU, Store, "loadu", "store"),
+    FLAVOR(Load, Stream, "load", "stream"),
+    FLAVOR(LoadU, Stream, "loadu", "stream"),
+};
+
+#undef FLAVOR
+
+} // namespace
+
+const Flavor* flavors_avx512(size_t* n) {
+    *n = sizeof(kFlavors) / sizeof(kFlavors[0]);
+    return kFlavors;
+}
+
+} // namespace stream
+} // namespace simd
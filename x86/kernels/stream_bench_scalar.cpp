@@ -0,0 +1,36 @@
+#include "stream_bench.h"
+
+namespace simd {
+namespace stream {
+
+namespace {
+
+void copy(float* c, const float* a, size_t n) {
+    for (size_t i = 0; i < n; ++i) c[i] = a[i];
+}
+
+void scale(float* b, const float* c, float s, size_t n) {
+    for (size_t i = 0; i < n; ++i) b[i] = s * c[i];
+}
+
+void add(float* c, const float* a, const float* b, size_t n) {
+    for (size_t i = 0; i < n; ++i) c[i] = a[i] + b[i];
+}
+
+void triad(float* a, const float* b, const float* c, float s, size_t n) {
+    for (size_t i = 0; i < n; ++i) a[i] = b[i] + s * c[i];
+}
+
+const Flavor kFlavors[] = {
+    {Isa::Scalar, 0, "scalar", "scalar", {copy, scale, add, triad}},
+};
+
+} // namespace
+
+const Flavor* flavors_scalar(size_t* n) {
+    *n = sizeof(kFlavors) / sizeof(kFlavors[0]);
+    return kFlavors;
+}
+
+} // namespace stream
+} // namespace simd
@@ -0,0 +1,71 @@
+#include "stream_bench.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace stream {
+
+// 128-bit flavors. lddqu (SSE3) loads 32 bytes around a misaligned address
+// and extracts the 16 it needs, which avoided cache-line-split penalties on
+// the Pentium 4; on later cores it behaves like loadu.
+
+namespace {
+
+struct Load  { static __m128 get(const float* p) { return _mm_load_ps(p); } };
+struct LoadU { static __m128 get(const float* p) { return _mm_loadu_ps(p); } };
+struct LdDqu { static __m128 get(const float* p) { return _mm_castsi128_ps(_mm_lddqu_si128((const __m128i*)p)); } };
+
+struct Store {
+    static void put(float* p, __m128 v) { _mm_store_ps(p, v); }
+    static void done() {}
+};
+struct Stream {
+    static void put(float* p, __m128 v) { _mm_stream_ps(p, v); }
+    static void done() { _mm_sfence(); }
+};
+
+template <typename L, typename S>
+struct K {
+    static void copy(float* c, const float* a, size_t n) {
+        for (size_t i = 0; i < n; i += 4) S::put(c + i, L::get(a + i));
+        S::done();
+    }
+    static void scale(float* b, const float* c, float s, size_t n) {
+        const __m128 vs = _mm_set1_ps(s);
+        for (size_t i = 0; i < n; i += 4) S::put(b + i, _mm_mul_ps(vs, L::get(c + i)));
+        S::done();
+    }
+    static void add(float* c, const float* a, const float* b, size_t n) {
+        for (size_t i = 0; i < n; i += 4) S::put(c + i, _mm_add_ps(L::get(a + i), L::get(b + i)));
+        S::done();
+    }
+    static void triad(float* a, const float* b, const float* c, float s, size_t n) {
+        const __m128 vs = _mm_set1_ps(s);
+        for (size_t i = 0; i < n; i += 4) S::put(a + i, _mm_add_ps(L::get(b + i), _mm_mul_ps(vs, L::get(c + i))));
+        S::done();
+    }
+};
+
+#define FLAVOR(L, S, load, store) \
+    {Isa::SSE41, 128, load, store, {K<L, S>::copy, K<L, S>::scale, K<L, S>::add, K<L, S>::triad}}
+
+const Flavor kFlavors[] = {
+    FLAVOR(Load, Store, "load", "store"),
+    FLAVOR(LoadU, Store, "loadu", "store"),
+    FLAVOR(LdDqu, Store, "lddqu", "store"),
+    FLAVOR(Load, Stream, "load", "stream"),
+    FLAVOR(LoadU, Stream, "loadu", "stream"),
+    FLAVOR(LdDqu, Stream, "lddqu", "stream"),
+};
+
+#undef FLAVOR
+
+} // namespace
+
+const Flavor* flavors_sse41(size_t* n) {
+    *n = sizeof(kFlavors) / sizeof(kFlavors[0]);
+    return kFlavors;
+}
+
+} // namespace stream
+} // namespace simd
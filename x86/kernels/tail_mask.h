@@ -0,0 +1,145 @@
+#ifndef SIMD_TAIL_MASK_H
+#define SIMD_TAIL_MASK_H
+
+// Masked loads and stores for the last partial vector of a loop, so that a
+// kernel needs no scalar epilogue:
+//
+//   size_t i = 0;
+//   for (; i + 8 <= n; i += 8) _mm256_storeu_ps(dst + i, f(_mm256_loadu_ps(src + i)));
+//   if (i < n) {
+//       Tail256<float> t(n - i);             // first n - i lanes
+//       t.store(dst + i, f(t.load(src + i)));
+//   }
+//
+// Lanes past the end load as 0 and are not stored. Masked-off lanes never
+// fault, so the data may end right before an unmapped page.
+//
+// Translation units built with AVX-512VL (the avx512 level) get k-register
+// masks from BZHI, which cost nothing to apply. AVX and AVX2 units get a
+// vector mask for vmaskmov / vpmaskmov, loaded from a constant table. The
+// helpers have internal linkage so each unit compiles its own copy with its
+// own flags.
+//
+// Masked AVX stores are fast on Intel cores but microcoded on AMD before
+// Zen 3; there a tail of a few elements may still be cheaper as a loop.
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace simd {
+
+namespace {
+
+// The 8 (or 4) lanes starting at kTailWindow32 + 8 - r (kTailWindow64 + 4 - r)
+// have exactly their first r lanes set: one unaligned load per tail, no
+// compare. Each table is one cache line, so the load never splits.
+alignas(64) constexpr int32_t kTailWindow32[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+alignas(64) constexpr int64_t kTailWindow64[8] = {-1, -1, -1, -1, 0, 0, 0, 0};
+
+// Tail256<T>: the first r lanes (r <= 256 / bits of T) of a 256-bit vector.
+// Tail512<T>: the same for a 512-bit vector (AVX-512 only).
+template <typename T> struct Tail256;
+template <typename T> struct Tail512;
+
+#if defined(__AVX512VL__)
+
+template <> struct Tail256<float> {
+    __mmask8 k;
+    explicit Tail256(size_t r) : k((__mmask8)_bzhi_u32(0xFF, (unsigned)r)) {}
+    __m256 load(const float* p) const { return _mm256_maskz_loadu_ps(k, p); }
+    void store(float* p, __m256 v) const { _mm256_mask_storeu_ps(p, k, v); }
+};
+
+template <> struct Tail256<int32_t> {
+    __mmask8 k;
+    explicit Tail256(size_t r) : k((__mmask8)_bzhi_u32(0xFF, (unsigned)r)) {}
+    __m256i load(const int32_t* p) const { return _mm256_maskz_loadu_epi32(k, p); }
+    void store(int32_t* p, __m256i v) const { _mm256_mask_storeu_epi32(p, k, v); }
+};
+
+template <> struct Tail256<double> {
+    __mmask8 k;
+    explicit Tail256(size_t r) : k((__mmask8)_bzhi_u32(0xF, (unsigned)r)) {}
+    __m256d load(const double* p) const { return _mm256_maskz_loadu_pd(k, p); }
+    void store(double* p, __m256d v) const { _mm256_mask_storeu_pd(p, k, v); }
+};
+
+template <> struct Tail256<int64_t> {
+    __mmask8 k;
+    explicit Tail256(size_t r) : k((__mmask8)_bzhi_u32(0xF, (unsigned)r)) {}
+    __m256i load(const int64_t* p) const { return _mm256_maskz_loadu_epi64(k, p); }
+    void store(int64_t* p, __m256i v) const { _mm256_mask_storeu_epi64(p, k, v); }
+};
+
+#elif defined(__AVX__)
+
+template <> struct Tail256<float> {
+    __m256i m;
+    explicit Tail256(size_t r) : m(_mm256_loadu_si256((const __m256i*)(kTailWindow32 + 8 - r))) {}
+    __m256 load(const float* p) const { return _mm256_maskload_ps(p, m); }
+    void store(float* p, __m256 v) const { _mm256_maskstore_ps(p, m, v); }
+};
+
+template <> struct Tail256<double> {
+    __m256i m;
+    explicit Tail256(size_t r) : m(_mm256_loadu_si256((const __m256i*)(kTailWindow64 + 4 - r))) {}
+    __m256d load(const double* p) const { return _mm256_maskload_pd(p, m); }
+    void store(double* p, __m256d v) const { _mm256_maskstore_pd(p, m, v); }
+};
+
+#if defined(__AVX2__)
+template <> struct Tail256<int32_t> {
+    __m256i m;
+    explicit Tail256(size_t r) : m(_mm256_loadu_si256((const __m256i*)(kTailWindow32 + 8 - r))) {}
+    __m256i load(const int32_t* p) const { return _mm256_maskload_epi32((const int*)p, m); }
+    void store(int32_t* p, __m256i v) const { _mm256_maskstore_epi32((int*)p, m, v); }
+};
+
+template <> struct Tail256<int64_t> {
+    __m256i m;
+    explicit Tail256(size_t r) : m(_mm256_loadu_si256((const __m256i*)(kTailWindow64 + 4 - r))) {}
+    __m256i load(const int64_t* p) const { return _mm256_maskload_epi64((const long long*)p, m); }
+    void store(int64_t* p, __m256i v) const { _mm256_maskstore_epi64((long long*)p, m, v); }
+};
+#endif
+
+#endif
+
+#if defined(__AVX512F__)
+
+template <> struct Tail512<float> {
+    __mmask16 k;
+    explicit Tail512(size_t r) : k((__mmask16)_bzhi_u32(0xFFFF, (unsigned)r)) {}
+    __m512 load(const float* p) const { return _mm512_maskz_loadu_ps(k, p); }
+    void store(float* p, __m512 v) const { _mm512_mask_storeu_ps(p, k, v); }
+};
+
+template <> struct Tail512<int32_t> {
+    __mmask16 k;
+    explicit Tail512(size_t r) : k((__mmask16)_bzhi_u32(0xFFFF, (unsigned)r)) {}
+    __m512i load(const int32_t* p) const { return _mm512_maskz_loadu_epi32(k, p); }
+    void store(int32_t* p, __m512i v) const { _mm512_mask_storeu_epi32(p, k, v); }
+};
+
+template <> struct Tail512<double> {
+    __mmask8 k;
+    explicit Tail512(size_t r) : k((__mmask8)_bzhi_u32(0xFF, (unsigned)r)) {}
+    __m512d load(const double* p) const { return _mm512_maskz_loadu_pd(k, p); }
+    void store(double* p, __m512d v) const { _mm512_mask_storeu_pd(p, k, v); }
+};
+
+template <> struct Tail512<int64_t> {
+    __mmask8 k;
+    explicit Tail512(size_t r) : k((__mmask8)_bzhi_u32(0xFF, (unsigned)r)) {}
+    __m512i load(const int64_t* p) const { return _mm512_maskz_loadu_epi64(k, p); }
+    void store(int64_t* p, __m512i v) const { _mm512_mask_storeu_epi64(p, k, v); }
+};
+
+#endif
+
+} // namespace
+
+} // namespace simd
+
+#endif // SIMD_TAIL_MASK_H
@@ -0,0 +1,25 @@
+#include "transpose.h"
+#include "dispatch.h"
+#include "memops.h"
+
+namespace simd {
+
+// int32_t and float only move bits, so they share the 32-bit kernels.
+
+void transpose(const float* src, size_t rows, size_t cols, size_t src_stride, float* dst, size_t dst_stride) {
+    kernels().transpose_u32(reinterpret_cast<const uint32_t*>(src), rows, cols, src_stride,
+                            reinterpret_cast<uint32_t*>(dst), dst_stride, nt_threshold());
+}
+
+void transpose(const int32_t* src, size_t rows, size_t cols, size_t src_stride, int32_t* dst,
+               size_t dst_stride) {
+    kernels().transpose_u32(reinterpret_cast<const uint32_t*>(src), rows, cols, src_stride,
+                            reinterpret_cast<uint32_t*>(dst), dst_stride, nt_threshold());
+}
+
+void transpose(const uint32_t* src, size_t rows, size_t cols, size_t src_stride, uint32_t* dst,
+               size_t dst_stride) {
+    kernels().transpose_u32(src, rows, cols, src_stride, dst, dst_stride, nt_threshold());
+}
+
+} // namespace simd
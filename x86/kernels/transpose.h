@@ -0,0 +1,26 @@
+#ifndef SIMD_TRANSPOSE_H
+#define SIMD_TRANSPOSE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+// Matrix transpose: dst[c * dst_stride + r] = src[r * src_stride + c] for
+// every r < rows and c < cols. Strides are in elements (src_stride >= cols,
+// dst_stride >= rows); the buffers must not overlap.
+//
+// The matrix is walked in 64 x 64 tiles, each transposed as KxK blocks in
+// registers (4x4 with SSE, 8x8 with AVX, 16x16 with AVX-512). Rows and
+// columns past the last multiple of K use a scalar loop. From nt_threshold()
+// bytes (memops.h) the output is written with streaming stores, provided dst
+// and dst_stride keep every vector store aligned.
+void transpose(const float* src, size_t rows, size_t cols, size_t src_stride, float* dst, size_t dst_stride);
+void transpose(const int32_t* src, size_t rows, size_t cols, size_t src_stride, int32_t* dst,
+               size_t dst_stride);
+void transpose(const uint32_t* src, size_t rows, size_t cols, size_t src_stride, uint32_t* dst,
+               size_t dst_stride);
+
+} // namespace simd
+
+#endif // SIMD_TRANSPOSE_H
@@ -0,0 +1,61 @@
+#include "kernels_internal.h"
+#include "transpose_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx {
+
+// 8x8 needs only AVX shuffles; integer data moves through the float domain
+// unchanged, so AVX2 adds nothing here.
+
+namespace {
+
+inline void block8(const uint32_t* s, size_t ss, uint32_t* d, size_t ds) {
+    __m256 r0 = _mm256_loadu_ps((const float*)(s));
+    __m256 r1 = _mm256_loadu_ps((const float*)(s + ss));
+    __m256 r2 = _mm256_loadu_ps((const float*)(s + 2 * ss));
+    __m256 r3 = _mm256_loadu_ps((const float*)(s + 3 * ss));
+    __m256 r4 = _mm256_loadu_ps((const float*)(s + 4 * ss));
+    __m256 r5 = _mm256_loadu_ps((const float*)(s + 5 * ss));
+    __m256 r6 = _mm256_loadu_ps((const float*)(s + 6 * ss));
+    __m256 r7 = _mm256_loadu_ps((const float*)(s + 7 * ss));
+    transpose8x8(r0, r1, r2, r3, r4, r5, r6, r7);
+    _mm256_storeu_ps((float*)(d), r0);
+    _mm256_storeu_ps((float*)(d + ds), r1);
+    _mm256_storeu_ps((float*)(d + 2 * ds), r2);
+    _mm256_storeu_ps((float*)(d + 3 * ds), r3);
+    _mm256_storeu_ps((float*)(d + 4 * ds), r4);
+    _mm256_storeu_ps((float*)(d + 5 * ds), r5);
+    _mm256_storeu_ps((float*)(d + 6 * ds), r6);
+    _mm256_storeu_ps((float*)(d + 7 * ds), r7);
+}
+
+// Two 8x8 blocks one above the other, so that each destination row gets
+// 64 consecutive bytes: a whole line for the streaming stores.
+inline void block16x8(const uint32_t* s, size_t ss, uint32_t* d, size_t ds) {
+    __m256 lo[8], hi[8];
+    for (int k = 0; k < 8; ++k) lo[k] = _mm256_loadu_ps((const float*)(s + k * ss));
+    transpose8x8(lo[0], lo[1], lo[2], lo[3], lo[4], lo[5], lo[6], lo[7]);
+    for (int k = 0; k < 8; ++k) hi[k] = _mm256_loadu_ps((const float*)(s + (8 + k) * ss));
+    transpose8x8(hi[0], hi[1], hi[2], hi[3], hi[4], hi[5], hi[6], hi[7]);
+    for (int k = 0; k < 8; ++k) {
+        _mm256_stream_ps((float*)(d + k * ds), lo[k]);
+        _mm256_stream_ps((float*)(d + k * ds + 8), hi[k]);
+    }
+}
+
+} // namespace
+
+void transpose_u32(const uint32_t* src, size_t rows, size_t cols, size_t src_stride, uint32_t* dst,
+                   size_t dst_stride, size_t nt_threshold) {
+    if (rows * cols * sizeof(uint32_t) >= nt_threshold && can_stream(dst, dst_stride, 32)) {
+        transpose_blocked<16, 8>(src, rows, cols, src_stride, dst, dst_stride, block16x8);
+        _mm_sfence();
+    } else {
+        transpose_blocked<8, 8>(src, rows, cols, src_stride, dst, dst_stride, block8);
+    }
+}
+
+} // namespace avx
+} // namespace simd
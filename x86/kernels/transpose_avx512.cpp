@@ -0,0 +1,39 @@
+#include "kernels_internal.h"
+#include "transpose_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512 {
+
+// 16x16 blocks: every destination store is one whole cache line when the
+// destination is 64-byte aligned, so streaming stores never leave a
+// write-combining buffer partly filled.
+
+namespace {
+
+template <bool kStream>
+inline void block16(const uint32_t* s, size_t ss, uint32_t* d, size_t ds) {
+    __m512 r[16];
+    for (int k = 0; k < 16; ++k) r[k] = _mm512_loadu_ps((const float*)(s + k * ss));
+    transpose16x16(r);
+    for (int k = 0; k < 16; ++k) {
+        if (kStream) _mm512_stream_ps((float*)(d + k * ds), r[k]);
+        else         _mm512_storeu_ps((float*)(d + k * ds), r[k]);
+    }
+}
+
+} // namespace
+
+void transpose_u32(const uint32_t* src, size_t rows, size_t cols, size_t src_stride, uint32_t* dst,
+                   size_t dst_stride, size_t nt_threshold) {
+    if (rows * cols * sizeof(uint32_t) >= nt_threshold && can_stream(dst, dst_stride, 64)) {
+        transpose_blocked<16, 16>(src, rows, cols, src_stride, dst, dst_stride, block16<true>);
+        _mm_sfence();
+    } else {
+        transpose_blocked<16, 16>(src, rows, cols, src_stride, dst, dst_stride, block16<false>);
+    }
+}
+
+} // namespace avx512
+} // namespace simd
@@ -0,0 +1,109 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+#include "arena.h"
+#include "dispatch.h"
+#include "memops.h"
+#include "transpose.h"
+
+namespace {
+
+// Every level against the scalar kernel, on shapes around each block size,
+// with padded strides and with streaming forced on and off.
+bool check_level(const simd::KernelTable& t) {
+    const simd::KernelTable& ref = simd::kernels_for(simd::Isa::Scalar);
+    const size_t shapes[][2] = {{1, 1},   {3, 5},   {4, 4},    {8, 8},     {16, 16}, {15, 17},
+                                {17, 33}, {64, 64}, {100, 37}, {130, 70}, {1000, 1003}};
+    for (const auto& shape : shapes) {
+        size_t rows = shape[0], cols = shape[1];
+        for (size_t pad : {(size_t)0, (size_t)3, (size_t)16}) {
+            size_t ss = cols + pad, ds = rows + pad;
+            std::vector<uint32_t> src(rows * ss);
+            for (size_t i = 0; i < src.size(); ++i) src[i] = (uint32_t)(i * 2654435761u);
+            std::vector<uint32_t> out(cols * ds + 1, 7), want(cols * ds + 1, 7);
+            ref.transpose_u32(src.data(), rows, cols, ss, want.data(), ds, SIZE_MAX);
+            for (size_t nt : {(size_t)0, SIZE_MAX}) {
+                uint32_t* dst = static_cast<uint32_t*>(simd::aligned_malloc(out.size() * 4, 64));
+                for (size_t i = 0; i < out.size(); ++i) dst[i] = 7;
+                t.transpose_u32(src.data(), rows, cols, ss, dst, ds, nt);
+                bool same = std::equal(want.begin(), want.end(), dst);
+                simd::aligned_free(dst);
+                if (!same) return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename F>
+double gbps(size_t bytes, F body) {
+    body();
+    double best = 0;
+    for (int trial = 0; trial < 3; ++trial) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (trial == 0 || sec < best) best = sec;
+    }
+    return bytes / best / 1e9;
+}
+
+// n x n floats, naive loop against each level with and without streaming.
+template <size_t L>
+bool bench(size_t n, const simd::Isa (&levels)[L]) {
+    const size_t bytes = n * n * sizeof(float);
+    float* src = static_cast<float*>(simd::map_pages(bytes));
+    float* dst = static_cast<float*>(simd::map_pages(bytes));
+    for (size_t i = 0; i < n * n; ++i) src[i] = (float)i;
+    simd::simd_memset(dst, 0, bytes);
+
+    std::cout << std::endl << n << " x " << n << " f32 transpose, GB/s (read + write):" << std::endl;
+    double naive = gbps(2 * bytes, [&] {
+        for (size_t r = 0; r < n; ++r) {
+            for (size_t c = 0; c < n; ++c) dst[c * n + r] = src[r * n + c];
+        }
+    });
+    std::cout << "  naive loop      " << std::setw(7) << naive << std::endl;
+    for (simd::Isa isa : levels) {
+        if (isa > simd::detect_isa()) break;
+        const simd::KernelTable& t = simd::kernels_for(isa);
+        auto* s = reinterpret_cast<const uint32_t*>(src);
+        auto* d = reinterpret_cast<uint32_t*>(dst);
+        double cached = gbps(2 * bytes, [&] { t.transpose_u32(s, n, n, n, d, n, SIZE_MAX); });
+        double streamed = gbps(2 * bytes, [&] { t.transpose_u32(s, n, n, n, d, n, 0); });
+        std::cout << "  " << std::left << std::setw(7) << simd::isa_name(isa) << std::right << " blocked "
+                  << std::setw(7) << cached << "   streaming " << std::setw(7) << streamed << "  ("
+                  << cached / naive << "x / " << streamed / naive << "x naive)" << std::endl;
+    }
+    bool ok = true;
+    for (size_t i = 0; i < 3 * n + 5; ++i) {
+        size_t r = i % n, c = (i * 7) % n;
+        if (dst[c * n + r] != src[r * n + c]) ok = false;
+    }
+    simd::unmap_pages(src, bytes);
+    simd::unmap_pages(dst, bytes);
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::fixed << std::setprecision(2);
+    bool ok = true;
+    const simd::Isa levels[] = {simd::Isa::Scalar, simd::Isa::SSE41, simd::Isa::AVX, simd::Isa::AVX512};
+    for (simd::Isa isa : levels) {
+        if (isa > simd::detect_isa()) break;
+        bool level_ok = check_level(simd::kernels_for(isa));
+        std::cout << std::setw(7) << simd::isa_name(isa) << " vs scalar: " << (level_ok ? "OK" : "MISMATCH")
+                  << std::endl;
+        ok &= level_ok;
+    }
+
+    // n x n floats, bandwidth counting read + write. 4096 is the
+    // power-of-two case: every row of a block falls in the same L1 set.
+    for (size_t n : {(size_t)4000, (size_t)4096}) ok &= bench(n, levels);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+#ifndef SIMD_TRANSPOSE_INTERNAL_H
+#define SIMD_TRANSPOSE_INTERNAL_H
+
+// Helpers shared by the per-ISA transpose kernels. Everything has internal
+// linkage so each translation unit compiles its own copy with its own flags.
+//
+// In-register transposes take K vectors holding rows 0..K-1 of a KxK block
+// of 32-bit elements and leave column j in vector j:
+//
+//   transpose4x4   __m128 x 4    unpacklo/hi, movelh/movehl              (SSE)
+//   transpose8x8   __m256 x 8    unpacklo/hi, shuffle_ps, permute2f128   (AVX)
+//   transpose16x16 __m512 x 16   unpacklo/hi, shuffle_ps, 2x shuffle_f32x4
+//
+// Each doubling adds one stage that moves whole groups of elements: pairs,
+// then pairs of pairs, then 128-bit lanes. A KxK transpose costs K log2(K)
+// shuffles, for K^2 elements.
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace simd {
+
+namespace {
+
+inline void transpose4x4(__m128& r0, __m128& r1, __m128& r2, __m128& r3) {
+    __m128 t0 = _mm_unpacklo_ps(r0, r1);  // a0 b0 a1 b1
+    __m128 t1 = _mm_unpackhi_ps(r0, r1);  // a2 b2 a3 b3
+    __m128 t2 = _mm_unpacklo_ps(r2, r3);  // c0 d0 c1 d1
+    __m128 t3 = _mm_unpackhi_ps(r2, r3);  // c2 d2 c3 d3
+    r0 = _mm_movelh_ps(t0, t2);           // a0 b0 c0 d0
+    r1 = _mm_movehl_ps(t2, t0);           // a1 b1 c1 d1
+    r2 = _mm_movelh_ps(t1, t3);
+    r3 = _mm_movehl_ps(t3, t1);
+}
+
+#if defined(__AVX__)
+inline void transpose8x8(__m256& r0, __m256& r1, __m256& r2, __m256& r3, __m256& r4, __m256& r5, __m256& r6,
+                         __m256& r7) {
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+    __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+    __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+    // u<k>, 128-bit lane L: column 4L + k of rows 0..3; u<4 + k>: rows 4..7.
+    __m256 u0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    __m256 u1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    __m256 u2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    __m256 u3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    __m256 u4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    __m256 u5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    __m256 u6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    __m256 u7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+    r0 = _mm256_permute2f128_ps(u0, u4, 0x20);
+    r1 = _mm256_permute2f128_ps(u1, u5, 0x20);
+    r2 = _mm256_permute2f128_ps(u2, u6, 0x20);
+    r3 = _mm256_permute2f128_ps(u3, u7, 0x20);
+    r4 = _mm256_permute2f128_ps(u0, u4, 0x31);
+    r5 = _mm256_permute2f128_ps(u1, u5, 0x31);
+    r6 = _mm256_permute2f128_ps(u2, u6, 0x31);
+    r7 = _mm256_permute2f128_ps(u3, u7, 0x31);
+}
+#endif
+
+#if defined(__AVX512F__)
+// The stages of transpose16x16, each on one group of vectors. They are
+// called with constant indices so that the arrays live in registers: GCC at
+// -O2 does not unroll the equivalent loops and spills every stage instead.
+inline void unpack_pair(const __m512* r, __m512* t, int i) {
+    t[2 * i] = _mm512_unpacklo_ps(r[2 * i], r[2 * i + 1]);
+    t[2 * i + 1] = _mm512_unpackhi_ps(r[2 * i], r[2 * i + 1]);
+}
+
+// u[4i + k], 128-bit lane L: column 4L + k of rows 4i .. 4i + 3.
+inline void shuffle_quad(const __m512* t, __m512* u, int i) {
+    u[4 * i + 0] = _mm512_shuffle_ps(t[4 * i], t[4 * i + 2], 0x44);
+    u[4 * i + 1] = _mm512_shuffle_ps(t[4 * i], t[4 * i + 2], 0xEE);
+    u[4 * i + 2] = _mm512_shuffle_ps(t[4 * i + 1], t[4 * i + 3], 0x44);
+    u[4 * i + 3] = _mm512_shuffle_ps(t[4 * i + 1], t[4 * i + 3], 0xEE);
+}
+
+// Column 4L + k is lane L of u[k], u[4 + k], u[8 + k], u[12 + k]: a 4x4
+// transpose of 128-bit lanes, in two rounds of shuffle_f32x4.
+inline void transpose_lanes(const __m512* u, __m512* r, int k) {
+    __m512 v0 = _mm512_shuffle_f32x4(u[k], u[4 + k], 0x44);
+    __m512 v1 = _mm512_shuffle_f32x4(u[k], u[4 + k], 0xEE);
+    __m512 v2 = _mm512_shuffle_f32x4(u[8 + k], u[12 + k], 0x44);
+    __m512 v3 = _mm512_shuffle_f32x4(u[8 + k], u[12 + k], 0xEE);
+    r[k] = _mm512_shuffle_f32x4(v0, v2, 0x88);
+    r[4 + k] = _mm512_shuffle_f32x4(v0, v2, 0xDD);
+    r[8 + k] = _mm512_shuffle_f32x4(v1, v3, 0x88);
+    r[12 + k] = _mm512_shuffle_f32x4(v1, v3, 0xDD);
+}
+
+inline void transpose16x16(__m512 r[16]) {
+    __m512 t[16], u[16];
+    unpack_pair(r, t, 0);
+    unpack_pair(r, t, 1);
+    unpack_pair(r, t, 2);
+    unpack_pair(r, t, 3);
+    unpack_pair(r, t, 4);
+    unpack_pair(r, t, 5);
+    unpack_pair(r, t, 6);
+    unpack_pair(r, t, 7);
+    shuffle_quad(t, u, 0);
+    shuffle_quad(t, u, 1);
+    shuffle_quad(t, u, 2);
+    shuffle_quad(t, u, 3);
+    transpose_lanes(u, r, 0);
+    transpose_lanes(u, r, 1);
+    transpose_lanes(u, r, 2);
+    transpose_lanes(u, r, 3);
+}
+#endif
+
+// Edge of kTile x kTile elements of the cache blocks: a 64 x 64 block of
+// 32-bit elements is 16 KiB on each side, so the source lines of one block
+// stay in L1 while its K-wide column strips are read one after another.
+const size_t kTransposeTile = 64;
+
+template <typename T>
+inline void transpose_scalar_loop(const T* src, size_t r0, size_t r1, size_t c0, size_t c1, size_t ss, T* dst,
+                                  size_t ds) {
+    for (size_t r = r0; r < r1; ++r) {
+        for (size_t c = c0; c < c1; ++c) dst[c * ds + r] = src[r * ss + c];
+    }
+}
+
+// Cache-blocked transpose out of register blocks: block(s, ss, d, ds)
+// transposes the KR x KC block at s (KR source rows, KC source columns) into
+// d. Inside a tile, the blocks of one destination row strip are written left
+// to right, so each destination line is completed by consecutive stores; with
+// KR * 4 = 64 each block writes whole lines, which is what streaming stores
+// need to leave the write-combining buffers full. Rows and columns past the
+// last multiple of the block are copied by the scalar loop.
+template <size_t KR, size_t KC, typename Block>
+inline void transpose_blocked(const uint32_t* src, size_t rows, size_t cols, size_t ss, uint32_t* dst,
+                              size_t ds, Block block) {
+    size_t rk = rows / KR * KR;
+    size_t ck = cols / KC * KC;
+    for (size_t i0 = 0; i0 < rk; i0 += kTransposeTile) {
+        size_t i1 = i0 + kTransposeTile < rk ? i0 + kTransposeTile : rk;
+        for (size_t j0 = 0; j0 < ck; j0 += kTransposeTile) {
+            size_t j1 = j0 + kTransposeTile < ck ? j0 + kTransposeTile : ck;
+            for (size_t j = j0; j < j1; j += KC) {
+                for (size_t i = i0; i < i1; i += KR) block(src + i * ss + j, ss, dst + j * ds + i, ds);
+            }
+        }
+    }
+    transpose_scalar_loop(src, 0, rk, ck, cols, ss, dst, ds);
+    transpose_scalar_loop(src, rk, rows, 0, cols, ss, dst, ds);
+}
+
+// Streaming stores need every destination vector aligned: the base and the
+// row stride must be multiples of the vector.
+inline bool can_stream(const void* dst, size_t ds, size_t vector_bytes) {
+    return ((uintptr_t)dst % vector_bytes) == 0 && (ds * sizeof(uint32_t)) % vector_bytes == 0;
+}
+
+} // namespace
+
+} // namespace simd
+
+#endif // SIMD_TRANSPOSE_INTERNAL_H
@@ -0,0 +1,19 @@
+#include "kernels_internal.h"
+#include "transpose_internal.h"
+
+namespace simd {
+namespace scalar {
+
+// The same cache blocking as the vector kernels, with 8x8 blocks moved one
+// element at a time.
+void transpose_u32(const uint32_t* src, size_t rows, size_t cols, size_t src_stride, uint32_t* dst,
+                   size_t dst_stride, size_t nt_threshold) {
+    (void)nt_threshold;
+    transpose_blocked<8, 8>(src, rows, cols, src_stride, dst, dst_stride,
+                         [](const uint32_t* s, size_t ss, uint32_t* d, size_t ds) {
+                             transpose_scalar_loop(s, 0, 8, 0, 8, ss, d, ds);
+                         });
+}
+
+} // namespace scalar
+} // namespace simd
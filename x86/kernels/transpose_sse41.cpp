@@ -0,0 +1,51 @@
+#include "kernels_internal.h"
+#include "transpose_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace sse41 {
+
+namespace {
+
+inline void load4(const uint32_t* s, size_t ss, __m128 r[4]) {
+    for (int k = 0; k < 4; ++k) r[k] = _mm_loadu_ps((const float*)(s + k * ss));
+    transpose4x4(r[0], r[1], r[2], r[3]);
+}
+
+inline void block4(const uint32_t* s, size_t ss, uint32_t* d, size_t ds) {
+    __m128 r[4];
+    load4(s, ss, r);
+    for (int k = 0; k < 4; ++k) _mm_storeu_ps((float*)(d + k * ds), r[k]);
+}
+
+// Four 4x4 blocks one above the other, so that each destination row gets 64
+// consecutive bytes: a whole line for the streaming stores.
+inline void block16x4(const uint32_t* s, size_t ss, uint32_t* d, size_t ds) {
+    __m128 r0[4], r1[4], r2[4], r3[4];
+    load4(s, ss, r0);
+    load4(s + 4 * ss, ss, r1);
+    load4(s + 8 * ss, ss, r2);
+    load4(s + 12 * ss, ss, r3);
+    for (int k = 0; k < 4; ++k) {
+        _mm_stream_ps((float*)(d + k * ds), r0[k]);
+        _mm_stream_ps((float*)(d + k * ds + 4), r1[k]);
+        _mm_stream_ps((float*)(d + k * ds + 8), r2[k]);
+        _mm_stream_ps((float*)(d + k * ds + 12), r3[k]);
+    }
+}
+
+} // namespace
+
+void transpose_u32(const uint32_t* src, size_t rows, size_t cols, size_t src_stride, uint32_t* dst,
+                   size_t dst_stride, size_t nt_threshold) {
+    if (rows * cols * sizeof(uint32_t) >= nt_threshold && can_stream(dst, dst_stride, 16)) {
+        transpose_blocked<16, 4>(src, rows, cols, src_stride, dst, dst_stride, block16x4);
+        _mm_sfence();
+    } else {
+        transpose_blocked<4, 4>(src, rows, cols, src_stride, dst, dst_stride, block4);
+    }
+}
+
+} // namespace sse41
+} // namespace simd
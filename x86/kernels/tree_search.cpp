@@ -0,0 +1,71 @@
+#include "tree_search.h"
+#include "amac.h"
+#include "dispatch.h"
+
+namespace simd {
+
+namespace {
+
+// Fills the subtree at k in order from sorted[i, ...); returns the next i.
+size_t fill(const uint32_t* sorted, size_t n, uint32_t* tree, size_t i, size_t k) {
+    if (k > n) return i;
+    i = fill(sorted, n, tree, i, 2 * k);
+    tree[k] = sorted[i++];
+    return fill(sorted, n, tree, i, 2 * k + 1);
+}
+
+// The descent ends one level below a leaf. The levels on which it went left
+// are the zero bits of k; the last of them is the answer, so k is shifted
+// past its trailing ones and the zero below them.
+inline uint32_t finish(uint32_t k) {
+    return k >> (__builtin_ctz(~k) + 1);
+}
+
+const size_t kInFlight = 16;
+
+struct TreeProbe {
+    struct State {
+        uint32_t key;
+        uint32_t k;
+        size_t i;
+    };
+    const uint32_t* tree;
+    uint32_t n;
+    const uint32_t* keys;
+    uint32_t* out;
+
+    const void* start(size_t i, State& s) {
+        s.key = keys[i];
+        s.k = 1;
+        s.i = i;
+        if (n == 0) {
+            out[i] = 0;
+            return nullptr;
+        }
+        return tree + 1;
+    }
+    const void* step(State& s) {
+        s.k = 2 * s.k + (tree[s.k] < s.key);
+        if (s.k <= n) return tree + s.k;
+        out[s.i] = finish(s.k);
+        return nullptr;
+    }
+};
+
+} // namespace
+
+void eytzinger_layout(const uint32_t* sorted, size_t n, uint32_t* tree) {
+    tree[0] = 0;
+    fill(sorted, n, tree, 0, 1);
+}
+
+void tree_search(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out) {
+    TreeProbe probe = {tree, (uint32_t)n, keys, out};
+    amac_run<kInFlight>(probe, m);
+}
+
+void tree_search_gather(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out) {
+    kernels().tree_search_u32(tree, n, keys, m, out);
+}
+
+} // namespace simd
@@ -0,0 +1,35 @@
+#ifndef SIMD_TREE_SEARCH_H
+#define SIMD_TREE_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+// Batched lower_bound over a sorted uint32_t index, the probe side of an
+// ordered index that is too large for the caches.
+//
+// The keys are stored in Eytzinger (BFS) order: tree[1] is the root and the
+// children of tree[k] are tree[2k] and tree[2k + 1]. A search descends one
+// level per load, branch-free, and every load depends on the one before, so
+// a lookup in a table that lives in DRAM costs one memory round trip per
+// level below the cached top of the tree.
+//
+// tree_search interleaves 16 lookups with amac_run (amac.h), so their misses
+// overlap. tree_search_gather descends 8 (AVX2) or 16 (AVX-512) lookups in
+// lockstep with one hardware gather per level; each level then waits for the
+// slowest lane. The scalar level of tree_search_gather is the plain loop.
+
+// tree[k] for k in [1, n] from sorted[0, n); tree[0] is set to 0 and unused.
+// tree holds n + 1 entries and n must be below 2^31. A uint32_t payload laid
+// out with the same call stays with its key.
+void eytzinger_layout(const uint32_t* sorted, size_t n, uint32_t* tree);
+
+// out[i] = the position in tree of the first key >= keys[i], or 0 if every
+// key is smaller, for i < m.
+void tree_search(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out);
+void tree_search_gather(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out);
+
+} // namespace simd
+
+#endif // SIMD_TREE_SEARCH_H
@@ -0,0 +1,41 @@
+#include "kernels_internal.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx2 {
+
+// Eight descents in lockstep, one vpgatherdd per level. Every lane of a
+// vector takes the same number of levels, give or take the last, so the
+// lanes stay busy; but each gather retires only when its slowest lane is
+// back, and the next level's addresses depend on it.
+
+void tree_search_u32(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out) {
+    const __m256i sign = _mm256_set1_epi32(INT32_MIN);
+    const __m256i nv = _mm256_xor_si256(_mm256_set1_epi32((int32_t)n), sign);
+    const __m256i ones = _mm256_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + 8 <= m; i += 8) {
+        // Unsigned compares as signed ones with the sign bits flipped.
+        __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(keys + i)), sign);
+        __m256i k = _mm256_set1_epi32(1);
+        for (;;) {
+            __m256i live = _mm256_andnot_si256(_mm256_cmpgt_epi32(_mm256_xor_si256(k, sign), nv), ones);
+            if (_mm256_testz_si256(live, live)) break;
+            __m256i v = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), (const int*)tree, k, live, 4);
+            __m256i lt = _mm256_and_si256(_mm256_cmpgt_epi32(x, _mm256_xor_si256(v, sign)), live);
+            k = _mm256_sub_epi32(_mm256_add_epi32(k, _mm256_and_si256(k, live)), lt);
+        }
+        alignas(32) uint32_t ks[8];
+        _mm256_store_si256((__m256i*)ks, k);
+        for (int j = 0; j < 8; ++j) out[i + j] = ks[j] >> (__builtin_ctz(~ks[j]) + 1);
+    }
+    for (; i < m; ++i) {
+        uint32_t k = 1;
+        while (k <= n) k = 2 * k + (tree[k] < keys[i]);
+        out[i] = k >> (__builtin_ctz(~k) + 1);
+    }
+}
+
+} // namespace avx2
+} // namespace simd
@@ -0,0 +1,39 @@
+#include "kernels_internal.h"
+#include "tail_mask.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512 {
+
+// Sixteen descents in lockstep, as on AVX2, with unsigned compares into mask
+// registers. The final shift past the trailing ones takes the lowest zero
+// bit of k through vplzcntd (AVX-512CD), so no lane leaves the register.
+
+void tree_search_u32(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out) {
+    const __m512i nv = _mm512_set1_epi32((int32_t)n);
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i thirty_two = _mm512_set1_epi32(32);
+    for (size_t i = 0; i < m; i += 16) {
+        Tail512<int32_t> t(m - i < 16 ? m - i : 16);
+        __m512i x = t.load((const int32_t*)keys + i);
+        // Lanes past the end start below the leaves and take no step.
+        __m512i k = _mm512_mask_mov_epi32(_mm512_add_epi32(nv, one), t.k, one);
+        for (;;) {
+            __mmask16 live = _mm512_cmple_epu32_mask(k, nv);
+            if (!live) break;
+            __m512i v = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), live, k, tree, 4);
+            __mmask16 lt = _mm512_mask_cmplt_epu32_mask(live, v, x);
+            k = _mm512_mask_add_epi32(k, live, k, k);
+            k = _mm512_mask_add_epi32(k, lt, k, one);
+        }
+        // ctz(~k) + 1 = 32 - lzcnt(lowest set bit of ~k).
+        __m512i z = _mm512_andnot_si512(k, _mm512_set1_epi32(-1));
+        __m512i low = _mm512_and_si512(z, _mm512_sub_epi32(_mm512_setzero_si512(), z));
+        __m512i shift = _mm512_sub_epi32(thirty_two, _mm512_lzcnt_epi32(low));
+        t.store((int32_t*)out + i, _mm512_srlv_epi32(k, shift));
+    }
+}
+
+} // namespace avx512
+} // namespace simd
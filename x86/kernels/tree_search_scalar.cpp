@@ -0,0 +1,17 @@
+#include "kernels_internal.h"
+
+namespace simd {
+namespace scalar {
+
+// One lookup after another: each level waits for the load of the one above.
+
+void tree_search_u32(const uint32_t* tree, size_t n, const uint32_t* keys, size_t m, uint32_t* out) {
+    for (size_t i = 0; i < m; ++i) {
+        uint32_t k = 1;
+        while (k <= n) k = 2 * k + (tree[k] < keys[i]);
+        out[i] = k >> (__builtin_ctz(~k) + 1);
+    }
+}
+
+} // namespace scalar
+} // namespace simd
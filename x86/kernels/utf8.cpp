@@ -0,0 +1,150 @@
+#include "utf8.h"
+#include "dispatch.h"
+
+namespace simd {
+
+namespace {
+
+// Bytes of the character a byte starts; 1 for ASCII and continuations.
+size_t sequence_length(uint8_t b) {
+    return b >= 0xF0 ? 4 : b >= 0xE0 ? 3 : b >= 0xC0 ? 2 : 1;
+}
+
+// Where the last character of s[0, n) starts if the end cuts it off, else n.
+size_t cut_point(const char* s, size_t n) {
+    for (size_t back = 1; back <= 3 && back <= n; ++back) {
+        uint8_t b = (uint8_t)s[n - back];
+        if ((b & 0xC0) != 0x80) return sequence_length(b) > back ? n - back : n;
+    }
+    return n;
+}
+
+// Moves bytes from the front of *src into carry until it holds the whole
+// character its first byte starts; returns whether it does.
+bool fill_carry(char* carry, size_t* size, const char** src, size_t* n) {
+    size_t need = sequence_length((uint8_t)carry[0]);
+    while (*size < need && *n) {
+        carry[(*size)++] = *(*src)++;
+        --*n;
+    }
+    return *size == need;
+}
+
+} // namespace
+
+Utf8Validator::Utf8Validator() : Utf8Validator(kernels()) {}
+
+Utf8Validator::Utf8Validator(const KernelTable& kernels)
+    : kernels_(&kernels), carry_size_(0), failed_(false) {}
+
+bool Utf8Validator::update(const char* src, size_t n) {
+    if (failed_) return false;
+    if (carry_size_) {
+        if (!fill_carry(carry_, &carry_size_, &src, &n)) return true;
+        if (!kernels_->utf8_validate(carry_, carry_size_)) {
+            failed_ = true;
+            return false;
+        }
+        carry_size_ = 0;
+    }
+    size_t cut = cut_point(src, n);
+    if (!kernels_->utf8_validate(src, cut)) {
+        failed_ = true;
+        return false;
+    }
+    for (size_t i = cut; i < n; ++i) carry_[carry_size_++] = src[i];
+    return true;
+}
+
+bool Utf8Validator::finish() {
+    bool ok = !failed_ && carry_size_ == 0;
+    carry_size_ = 0;
+    failed_ = false;
+    return ok;
+}
+
+Utf8ToUtf16::Utf8ToUtf16() : Utf8ToUtf16(kernels()) {}
+
+Utf8ToUtf16::Utf8ToUtf16(const KernelTable& kernels)
+    : kernels_(&kernels), carry_size_(0), failed_(false) {}
+
+bool Utf8ToUtf16::update(const char* src, size_t n, char16_t* dst, size_t* written) {
+    size_t k = 0, m = 0;
+    *written = 0;
+    if (failed_) return false;
+    if (carry_size_) {
+        if (!fill_carry(carry_, &carry_size_, &src, &n)) return true;
+        if (!kernels_->utf8_to_utf16(carry_, carry_size_, dst, &k)) {
+            failed_ = true;
+            return false;
+        }
+        carry_size_ = 0;
+    }
+    size_t cut = cut_point(src, n);
+    if (!kernels_->utf8_to_utf16(src, cut, dst + k, &m)) {
+        failed_ = true;
+        return false;
+    }
+    for (size_t i = cut; i < n; ++i) carry_[carry_size_++] = src[i];
+    *written = k + m;
+    return true;
+}
+
+bool Utf8ToUtf16::finish() {
+    bool ok = !failed_ && carry_size_ == 0;
+    carry_size_ = 0;
+    failed_ = false;
+    return ok;
+}
+
+Utf16ToUtf8::Utf16ToUtf8() : Utf16ToUtf8(kernels()) {}
+
+Utf16ToUtf8::Utf16ToUtf8(const KernelTable& kernels)
+    : kernels_(&kernels), carry_(0), has_carry_(false), failed_(false) {}
+
+bool Utf16ToUtf8::update(const char16_t* src, size_t n, char* dst, size_t* written) {
+    size_t k = 0, m = 0;
+    *written = 0;
+    if (failed_) return false;
+    if (has_carry_ && n) {
+        const char16_t pair[2] = {carry_, src[0]};
+        if (!kernels_->utf16_to_utf8(pair, 2, dst, &k)) {
+            failed_ = true;
+            return false;
+        }
+        has_carry_ = false;
+        ++src;
+        --n;
+    }
+    size_t cut = n && (src[n - 1] & 0xFC00) == 0xD800 ? n - 1 : n;
+    if (!kernels_->utf16_to_utf8(src, cut, dst + k, &m)) {
+        failed_ = true;
+        return false;
+    }
+    if (cut < n) {
+        carry_ = src[cut];
+        has_carry_ = true;
+    }
+    *written = k + m;
+    return true;
+}
+
+bool Utf16ToUtf8::finish() {
+    bool ok = !failed_ && !has_carry_;
+    has_carry_ = failed_ = false;
+    return ok;
+}
+
+bool utf8_validate(const char* src, size_t n) {
+    return kernels().utf8_validate(src, n);
+}
+
+bool utf8_to_utf16(const char* src, size_t n, char16_t* dst, size_t* written) {
+    return kernels().utf8_to_utf16(src, n, dst, written);
+}
+
+bool utf16_to_utf8(const char16_t* src, size_t n, char* dst, size_t* written) {
+    return kernels().utf16_to_utf8(src, n, dst, written);
+}
+
+} // namespace simd
@@ -0,0 +1,91 @@
+#ifndef SIMD_UTF8_H
+#define SIMD_UTF8_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace simd {
+
+struct KernelTable;
+
+// UTF-8 validation and UTF-8 <-> UTF-16 transcoding (RFC 3629). Valid UTF-8
+// is the shortest form of a code point up to U+10FFFF that is not a
+// surrogate (U+D800..U+DFFF); valid UTF-16 has every surrogate in a high-low
+// pair. UTF-16 is in native byte order, without a byte order mark.
+
+// Whether n bytes are valid UTF-8.
+bool utf8_validate(const char* src, size_t n);
+
+// Transcodes n bytes of UTF-8 into dst, which needs room for n units, and
+// sets *written to the units written. Returns false, with dst partly written
+// and *written 0, if src is not valid UTF-8.
+bool utf8_to_utf16(const char* src, size_t n, char16_t* dst, size_t* written);
+
+// Transcodes n units of UTF-16 into dst, which needs room for 3 * n bytes,
+// and sets *written to the bytes written. Returns false, with dst partly
+// written and *written 0, on a surrogate outside a high-low pair.
+bool utf16_to_utf8(const char16_t* src, size_t n, char* dst, size_t* written);
+
+// Streaming forms, for input that arrives in pieces of any size. Each update
+// handles the whole characters it has and keeps the start of a character cut
+// by the end of the piece (at most 3 bytes, or a high surrogate) for the
+// next call. finish reports whether the stream ended on a character boundary
+// and resets the object for a new stream. After a false return every call
+// fails until finish.
+//
+//   Utf8Validator v;
+//   while (size_t got = read(fd, buf, sizeof buf)) {
+//       if (!v.update(buf, got)) return error;
+//   }
+//   if (!v.finish()) return error;
+class Utf8Validator {
+public:
+    Utf8Validator();
+    // With a specific level's kernels, for benchmarks and cross-checking.
+    explicit Utf8Validator(const KernelTable& kernels);
+
+    bool update(const char* src, size_t n);
+    bool finish();
+
+private:
+    const KernelTable* kernels_;
+    char carry_[4];
+    size_t carry_size_;
+    bool failed_;
+};
+
+class Utf8ToUtf16 {
+public:
+    Utf8ToUtf16();
+    explicit Utf8ToUtf16(const KernelTable& kernels);
+
+    // Writes at most n + 1 units and sets *written.
+    bool update(const char* src, size_t n, char16_t* dst, size_t* written);
+    bool finish();
+
+private:
+    const KernelTable* kernels_;
+    char carry_[4];
+    size_t carry_size_;
+    bool failed_;
+};
+
+class Utf16ToUtf8 {
+public:
+    Utf16ToUtf8();
+    explicit Utf16ToUtf8(const KernelTable& kernels);
+
+    // Writes at most 3 * n + 1 bytes and sets *written.
+    bool update(const char16_t* src, size_t n, char* dst, size_t* written);
+    bool finish();
+
+private:
+    const KernelTable* kernels_;
+    char16_t carry_;   // a high surrogate waiting for its low half
+    bool has_carry_;
+    bool failed_;
+};
+
+} // namespace simd
+
+#endif // SIMD_UTF8_H
@@ -0,0 +1,89 @@
+#include "kernels_internal.h"
+#include "utf8_internal.h"
+#include "safe_load.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx2 {
+
+// The SSE4.1 kernels on 32 bytes or 16 units per block. The decoded units
+// are computed 16 at a time and packed per 128-bit half, since the pack
+// tables are pshufb controls.
+
+bool utf8_validate(const char* src, size_t n) {
+    const uint8_t* s = (const uint8_t*)src;
+    Utf8Check256 check;
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) check.add(_mm256_loadu_si256((const __m256i*)(s + i)));
+    if (i < n) check.add(load_tail_256(s + i, n - i));
+    return check.ok();
+}
+
+bool utf8_to_utf16(const char* src, size_t n, char16_t* dst, size_t* written) {
+    const Utf8Tables& t = utf8_tables();
+    const uint8_t* s = (const uint8_t*)src;
+    Utf8Check256 check;
+    size_t i = 0, k = 0;
+    *written = 0;
+    for (; i + 39 <= n; i += 32) {
+        __m256i in = _mm256_loadu_si256((const __m256i*)(s + i));
+        check.add(in);
+        if (_mm256_movemask_epi8(in) == 0) {
+            _mm256_storeu_si256((__m256i*)(dst + k), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(in)));
+            _mm256_storeu_si256((__m256i*)(dst + k + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(in, 1)));
+            k += 32;
+            continue;
+        }
+        __m256i four = _mm256_subs_epu8(in, _mm256_set1_epi8((char)0xEF));
+        if (_mm256_testz_si256(four, four)) {
+            uint32_t lead = (uint32_t)_mm256_movemask_epi8(_mm256_cmpgt_epi8(in, _mm256_set1_epi8(-65)));
+            for (size_t h = 0; h < 32; h += 16, lead >>= 16) {
+                __m256i b0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(s + i + h)));
+                __m256i b1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(s + i + h + 1)));
+                __m256i b2 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(s + i + h + 2)));
+                __m256i u = utf8_units_256(b0, b1, b2);
+                k += utf8_pack_units(_mm256_castsi256_si128(u), lead & 0xFF, t, dst + k);
+                k += utf8_pack_units(_mm256_extracti128_si256(u, 1), lead >> 8 & 0xFF, t, dst + k);
+            }
+            continue;
+        }
+        k += utf8_to_utf16_wide_32(s + i, t, dst + k);
+    }
+    for (size_t j = i; j < n; j += 32) {
+        check.add(n - j >= 32 ? _mm256_loadu_si256((const __m256i*)(s + j)) : load_tail_256(s + j, n - j));
+    }
+    while (i < n && (s[i] & 0xC0) == 0x80) ++i;
+    if (!utf8_to_utf16_scalar(s, &i, n, n, dst, &k) || !check.ok()) return false;
+    *written = k;
+    return true;
+}
+
+bool utf16_to_utf8(const char16_t* src, size_t n, char* dst, size_t* written) {
+    const Utf8Tables& t = utf8_tables();
+    size_t i = 0, k = 0;
+    *written = 0;
+    while (i + 18 <= n) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m128i lo = _mm256_castsi256_si128(v), hi = _mm256_extracti128_si256(v, 1);
+        __m256i sur = _mm256_cmpeq_epi16(_mm256_and_si256(v, _mm256_set1_epi16((short)0xF800)),
+                                         _mm256_set1_epi16((short)0xD800));
+        if (_mm256_testz_si256(v, _mm256_set1_epi16((short)0xFF80))) {
+            _mm_storeu_si128((__m128i*)(dst + k), _mm_packus_epi16(lo, hi));
+            k += 16;
+            i += 16;
+        } else if (_mm256_testz_si256(sur, sur)) {
+            k += utf16_encode_bmp_8(_mm256_cvtepu16_epi32(lo), t, dst + k);
+            k += utf16_encode_bmp_8(_mm256_cvtepu16_epi32(hi), t, dst + k);
+            i += 16;
+        } else if (!utf16_to_utf8_scalar(src, &i, i + 16, n, dst, &k)) {
+            return false;
+        }
+    }
+    if (!utf16_to_utf8_scalar(src, &i, n, n, dst, &k)) return false;
+    *written = k;
+    return true;
+}
+
+} // namespace avx2
+} // namespace simd
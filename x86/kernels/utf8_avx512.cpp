@@ -0,0 +1,89 @@
+#include "kernels_internal.h"
+#include "utf8_internal.h"
+#include "safe_load.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace avx512 {
+
+// The SSE4.1 kernels on 64 bytes or 32 units per block, with AVX-512BW
+// byte and word compares into masks. The packs stay per 128-bit lane: a
+// compress of 16-bit lanes (vpcompressw) is VBMI2.
+
+bool utf8_validate(const char* src, size_t n) {
+    const uint8_t* s = (const uint8_t*)src;
+    Utf8Check512 check;
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) check.add(_mm512_loadu_si512(s + i));
+    if (i < n) check.add(load_tail_512(s + i, n - i));
+    return check.ok();
+}
+
+bool utf8_to_utf16(const char* src, size_t n, char16_t* dst, size_t* written) {
+    const Utf8Tables& t = utf8_tables();
+    const uint8_t* s = (const uint8_t*)src;
+    Utf8Check512 check;
+    size_t i = 0, k = 0;
+    *written = 0;
+    for (; i + 71 <= n; i += 64) {
+        __m512i in = _mm512_loadu_si512(s + i);
+        check.add(in);
+        if (_mm512_movepi8_mask(in) == 0) {
+            _mm512_storeu_si512(dst + k, _mm512_cvtepu8_epi16(_mm512_castsi512_si256(in)));
+            _mm512_storeu_si512(dst + k + 32, _mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(in, 1)));
+            k += 64;
+            continue;
+        }
+        if (_mm512_cmpge_epu8_mask(in, _mm512_set1_epi8((char)0xF0)) == 0) {
+            uint64_t lead = _mm512_cmpgt_epi8_mask(in, _mm512_set1_epi8(-65));
+            for (size_t h = 0; h < 64; h += 32, lead >>= 32) {
+                __m512i b0 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(s + i + h)));
+                __m512i b1 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(s + i + h + 1)));
+                __m512i b2 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(s + i + h + 2)));
+                __m512i u = utf8_units_512(b0, b1, b2);
+                uint32_t m = (uint32_t)lead;
+                k += utf8_pack_units(_mm512_castsi512_si128(u), m & 0xFF, t, dst + k);
+                k += utf8_pack_units(_mm512_extracti32x4_epi32(u, 1), m >> 8 & 0xFF, t, dst + k);
+                k += utf8_pack_units(_mm512_extracti32x4_epi32(u, 2), m >> 16 & 0xFF, t, dst + k);
+                k += utf8_pack_units(_mm512_extracti32x4_epi32(u, 3), m >> 24, t, dst + k);
+            }
+            continue;
+        }
+        k += utf8_to_utf16_wide_64(s + i, t, dst + k);
+    }
+    for (size_t j = i; j < n; j += 64) {
+        check.add(n - j >= 64 ? _mm512_loadu_si512(s + j) : load_tail_512(s + j, n - j));
+    }
+    while (i < n && (s[i] & 0xC0) == 0x80) ++i;
+    if (!utf8_to_utf16_scalar(s, &i, n, n, dst, &k) || !check.ok()) return false;
+    *written = k;
+    return true;
+}
+
+bool utf16_to_utf8(const char16_t* src, size_t n, char* dst, size_t* written) {
+    const Utf8Tables& t = utf8_tables();
+    size_t i = 0, k = 0;
+    *written = 0;
+    while (i + 34 <= n) {
+        __m512i v = _mm512_loadu_si512(src + i);
+        if (_mm512_test_epi16_mask(v, _mm512_set1_epi16((short)0xFF80)) == 0) {
+            _mm256_storeu_si256((__m256i*)(dst + k), _mm512_cvtepi16_epi8(v));
+            k += 32;
+            i += 32;
+        } else if (_mm512_cmpeq_epi16_mask(_mm512_and_si512(v, _mm512_set1_epi16((short)0xF800)),
+                                           _mm512_set1_epi16((short)0xD800)) == 0) {
+            k += utf16_encode_bmp_16(_mm512_cvtepu16_epi32(_mm512_castsi512_si256(v)), t, dst + k);
+            k += utf16_encode_bmp_16(_mm512_cvtepu16_epi32(_mm512_extracti64x4_epi64(v, 1)), t, dst + k);
+            i += 32;
+        } else if (!utf16_to_utf8_scalar(src, &i, i + 32, n, dst, &k)) {
+            return false;
+        }
+    }
+    if (!utf16_to_utf8_scalar(src, &i, n, n, dst, &k)) return false;
+    *written = k;
+    return true;
+}
+
+} // namespace avx512
+} // namespace simd
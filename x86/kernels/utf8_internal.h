@@ -0,0 +1,633 @@
+#ifndef SIMD_UTF8_INTERNAL_H
+#define SIMD_UTF8_INTERNAL_H
+
+// Helpers shared by the per-ISA UTF-8 kernels. Everything but the tables
+// has internal linkage so each translation unit compiles its own copy with
+// its own flags.
+//
+// Validation is the lookup method of Keiser and Lemire. Almost every error
+// shows in a pair of adjacent bytes, so three pshufb lookups, on the high and
+// low nibble of the previous byte and the high nibble of the current one,
+// each give a byte of error classes (too short, too long, overlong,
+// surrogate, above U+10FFFF, two continuations) that the pair may be in; the
+// pair is in the classes all three agree on. The one error that takes three
+// or four bytes, a missing 2nd or 3rd continuation, is the pair class "two
+// continuations" where the byte 2 or 3 back is not a 3- or 4-byte lead. The
+// previous vector supplies the bytes before lane 0 (palignr), and a vector
+// of only ASCII skips the lookups.
+//
+// UTF-8 -> UTF-16, per 16 bytes:
+//   ASCII    pmovzxbw widens them to 16 units;
+//   1-3 byte each byte is taken as a lead and decoded in a 16-bit lane from
+//            itself and the next two bytes (from loads at +1 and +2); the
+//            lanes of continuation bytes are then dropped with a pshufb
+//            left-pack per 8 lanes (pack16);
+//   4 byte   each byte is taken as a lead in a 32-bit lane with the next
+//            three (loads at +1..+3), its payload bits masked by a lookup
+//            on its high nibble; pmaddubsw and pmaddwd with multipliers
+//            picked by its length give the code point, a surrogate pair
+//            where it is 4 bytes, and pack16 keeps 1 or 2 units per lead.
+// UTF-16 -> UTF-8, per 8 units:
+//   ASCII    packuswb narrows them to 8 bytes;
+//   no surrogate  each unit is encoded as 1, 2 and 3 bytes in a 32-bit lane,
+//            the right form picked by two compares, and a pshufb per 4 lanes
+//            keeps the bytes in use (pack_utf8);
+//   surrogates    scalar.
+// The validator runs over every block, so the fast paths do not check
+// anything themselves; they only keep dst within bounds whatever the input.
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace simd {
+
+struct Utf8Tables {
+    // pshufb control moving the 16-bit lanes set in an 8-bit mask to the front.
+    uint8_t pack16[256][16];
+    // For 4 units as 32-bit lanes [b0 b1 b2 -], index m1 | m2 << 4 with bit j
+    // of m1 set if unit j needs 2 bytes or more and of m2 if it needs 3:
+    // pshufb control keeping the bytes in use, and their count.
+    uint8_t pack_utf8[256][16];
+    uint8_t pack_utf8_length[256];
+};
+
+// Built once, in utf8_scalar.cpp.
+const Utf8Tables& utf8_tables();
+
+namespace {
+
+// Error classes of the lookup validator.
+const uint8_t kTooShort = 1 << 0;     // lead followed by a lead or ASCII
+const uint8_t kTooLong = 1 << 1;      // ASCII followed by a continuation
+const uint8_t kOverlong3 = 1 << 2;    // E0 80..9F
+const uint8_t kTooLarge = 1 << 3;     // F4 90..BF, F5..FF
+const uint8_t kSurrogate = 1 << 4;    // ED A0..BF
+const uint8_t kOverlong2 = 1 << 5;    // C0, C1
+const uint8_t kTooLarge1000 = 1 << 6; // F5..FF 80..8F
+const uint8_t kOverlong4 = 1 << 6;    // F0 80..8F
+const uint8_t kTwoConts = 1 << 7;     // continuation after continuation
+const uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+// Indexed by the high nibble of the previous byte.
+alignas(16) const uint8_t kUtf8Byte1High[16] = {
+    kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+    kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+    kTooShort | kOverlong2,
+    kTooShort,
+    kTooShort | kOverlong3 | kSurrogate,
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4};
+// Indexed by the low nibble of the previous byte.
+alignas(16) const uint8_t kUtf8Byte1Low[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    kCarry | kOverlong2,
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000};
+// Indexed by the high nibble of the current byte.
+alignas(16) const uint8_t kUtf8Byte2High[16] = {
+    kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooShort, kTooShort, kTooShort, kTooShort};
+
+// 4-byte transcoding path, indexed by the high nibble of a lead: the mask
+// of its payload bits, and its length as a slot (0, 4, 8, 12) of the
+// multipliers below. Continuations get 0x3F, as they do after a lead.
+alignas(16) const uint8_t kUtf8Payload[16] = {
+    0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x3F, 0x3F, 0x3F, 0x3F, 0x1F, 0x1F, 0x0F, 0x07};
+alignas(16) const uint8_t kUtf8LengthSlot[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 8, 12};
+// A 32-bit lane [lead c1 c2 c3] of payloads goes through pmaddubsw with the
+// bytes of its slot, giving lead * 64 + c1 and c2 * 64 + c3 for 4 bytes,
+// then pmaddwd with the 16-bit pair of its slot, giving the code point.
+// The multipliers of a shorter character leave out the bytes past its end.
+alignas(16) const uint8_t kUtf8WideMulBytes[16] = {1, 0, 0, 0, 64, 1, 0, 0, 64, 1, 1, 0, 64, 1, 64, 1};
+alignas(16) const uint8_t kUtf8WideMulWords[16] = {1, 0, 0, 0, 1, 0, 0, 0, 64, 0, 1, 0, 0, 16, 1, 0};
+
+// The character at s[i], i < n: its length, or 0 if it is not valid UTF-8
+// or is cut off by n.
+inline size_t utf8_decode_one(const uint8_t* s, size_t i, size_t n, uint32_t* cp) {
+    uint32_t b0 = s[i];
+    if (b0 < 0x80) {
+        *cp = b0;
+        return 1;
+    }
+    // Range of the second byte after each lead; later bytes are 80..BF.
+    size_t len;
+    uint32_t lo = 0x80, hi = 0xBF;
+    if (b0 < 0xC2) return 0;
+    else if (b0 < 0xE0) len = 2;
+    else if (b0 < 0xF0) {
+        len = 3;
+        if (b0 == 0xE0) lo = 0xA0;
+        if (b0 == 0xED) hi = 0x9F;
+    } else if (b0 < 0xF5) {
+        len = 4;
+        if (b0 == 0xF0) lo = 0x90;
+        if (b0 == 0xF4) hi = 0x8F;
+    } else return 0;
+    if (n - i < len || s[i + 1] < lo || s[i + 1] > hi) return 0;
+    uint32_t v = b0 & (0x7F >> len);
+    for (size_t j = 1; j < len; ++j) {
+        if ((s[i + j] & 0xC0) != 0x80) return 0;
+        v = v << 6 | (s[i + j] & 0x3F);
+    }
+    *cp = v;
+    return len;
+}
+
+// Decodes the characters that start in [*i, end) into dst + *k, *i at the
+// start of one and end <= n. The last may run past end; *i ends after it.
+// False if one is invalid.
+inline bool utf8_to_utf16_scalar(const uint8_t* s, size_t* i, size_t end, size_t n, char16_t* dst, size_t* k) {
+    size_t j = *i, o = *k;
+    while (j < end) {
+        uint32_t cp;
+        size_t len = utf8_decode_one(s, j, n, &cp);
+        if (!len) return false;
+        if (cp < 0x10000) {
+            dst[o++] = (char16_t)cp;
+        } else {
+            dst[o++] = (char16_t)(0xD7C0 + (cp >> 10));
+            dst[o++] = (char16_t)(0xDC00 | (cp & 0x3FF));
+        }
+        j += len;
+    }
+    *i = j;
+    *k = o;
+    return true;
+}
+
+// Encodes the units that start in [*i, end) into dst + *k, end <= n. A high
+// surrogate at end - 1 takes its low half from s[end]; *i ends after it.
+// False on an unpaired surrogate.
+inline bool utf16_to_utf8_scalar(const char16_t* s, size_t* i, size_t end, size_t n, char* dst, size_t* k) {
+    size_t j = *i, o = *k;
+    while (j < end) {
+        uint32_t u = s[j++];
+        if (u < 0x80) {
+            dst[o++] = (char)u;
+        } else if (u < 0x800) {
+            dst[o++] = (char)(0xC0 | u >> 6);
+            dst[o++] = (char)(0x80 | (u & 0x3F));
+        } else if (u - 0xD800 >= 0x800) {
+            dst[o++] = (char)(0xE0 | u >> 12);
+            dst[o++] = (char)(0x80 | (u >> 6 & 0x3F));
+            dst[o++] = (char)(0x80 | (u & 0x3F));
+        } else {
+            if (u >= 0xDC00 || j == n || s[j] < 0xDC00 || s[j] > 0xDFFF) return false;
+            uint32_t cp = 0x10000 + ((u - 0xD800) << 10) + (s[j++] - 0xDC00);
+            dst[o++] = (char)(0xF0 | cp >> 18);
+            dst[o++] = (char)(0x80 | (cp >> 12 & 0x3F));
+            dst[o++] = (char)(0x80 | (cp >> 6 & 0x3F));
+            dst[o++] = (char)(0x80 | (cp & 0x3F));
+        }
+    }
+    *i = j;
+    *k = o;
+    return true;
+}
+
+#if defined(__SSE4_1__)
+
+// The lookup validator over 16 bytes at a time.
+struct Utf8Check128 {
+    __m128i prev, incomplete, error;
+
+    Utf8Check128() : prev(_mm_setzero_si128()), incomplete(_mm_setzero_si128()), error(_mm_setzero_si128()) {}
+
+    void add(__m128i in) {
+        if (_mm_movemask_epi8(in) == 0) {
+            // A character cut by the end of the previous block is an error.
+            error = _mm_or_si128(error, incomplete);
+            prev = in;
+            incomplete = _mm_setzero_si128();
+            return;
+        }
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+        __m128i prev1 = _mm_alignr_epi8(in, prev, 15);
+        __m128i b1h = _mm_shuffle_epi8(_mm_load_si128((const __m128i*)kUtf8Byte1High),
+                                       _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+        __m128i b1l = _mm_shuffle_epi8(_mm_load_si128((const __m128i*)kUtf8Byte1Low), _mm_and_si128(prev1, nibble));
+        __m128i b2h = _mm_shuffle_epi8(_mm_load_si128((const __m128i*)kUtf8Byte2High),
+                                       _mm_and_si128(_mm_srli_epi16(in, 4), nibble));
+        __m128i special = _mm_and_si128(_mm_and_si128(b1h, b1l), b2h);
+        // Bytes 2 and 3 back that are 3- and 4-byte leads: their 2nd and 3rd
+        // continuations are the "two continuations" that are no error.
+        __m128i third = _mm_subs_epu8(_mm_alignr_epi8(in, prev, 14), _mm_set1_epi8((char)(0xE0 - 0x80)));
+        __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(in, prev, 13), _mm_set1_epi8((char)(0xF0 - 0x80)));
+        __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8((char)0x80));
+        error = _mm_or_si128(error, _mm_xor_si128(must23, special));
+        prev = in;
+        // Non-zero if the last 3 bytes start a character they do not finish.
+        incomplete = _mm_subs_epu8(in, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                     (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1)));
+    }
+
+    // After the last block: no error and no character left open.
+    bool ok() const {
+        __m128i e = _mm_or_si128(error, incomplete);
+        return _mm_testz_si128(e, e);
+    }
+};
+
+// Whether the 16 bytes hold a byte from F0, a 4-byte lead (or invalid).
+inline bool utf8_has_4byte_128(__m128i in) {
+    __m128i x = _mm_subs_epu8(in, _mm_set1_epi8((char)0xEF));
+    return !_mm_testz_si128(x, x);
+}
+
+// Mask of the bytes that are not continuations (0x80..0xBF).
+inline uint32_t utf8_lead_mask_128(__m128i in) {
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi8(in, _mm_set1_epi8(-65)));
+}
+
+// Each 16-bit lane decoded as a character of 1 to 3 bytes b0 b1 b2.
+inline __m128i utf8_units_128(__m128i b0, __m128i b1, __m128i b2) {
+    const __m128i low6 = _mm_set1_epi16(0x3F);
+    __m128i c1 = _mm_and_si128(b1, low6), c2 = _mm_and_si128(b2, low6);
+    __m128i two = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b0, _mm_set1_epi16(0x1F)), 6), c1);
+    __m128i three = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(b0, 12), _mm_slli_epi16(c1, 6)), c2);
+    __m128i u = _mm_blendv_epi8(b0, two, _mm_cmpgt_epi16(b0, _mm_set1_epi16(0xBF)));
+    return _mm_blendv_epi8(u, three, _mm_cmpgt_epi16(b0, _mm_set1_epi16(0xDF)));
+}
+
+// The lanes of u whose bit is set in the 8-bit mask m, packed to dst (8
+// units are stored); returns their count.
+inline size_t utf8_pack_units(__m128i u, uint32_t m, const Utf8Tables& t, char16_t* dst) {
+    _mm_storeu_si128((__m128i*)dst, _mm_shuffle_epi8(u, _mm_loadu_si128((const __m128i*)t.pack16[m])));
+    return (size_t)_mm_popcnt_u32(m);
+}
+
+// Bits 0..15 of x to the even bits, for the 8-bit pack16 masks of 32-bit
+// lanes: bit 2j keeps the low unit of lane j and bit 2j + 1 the high.
+inline uint32_t utf8_interleave16(uint32_t x) {
+    x = (x | x << 8) & 0x00FF00FF;
+    x = (x | x << 4) & 0x0F0F0F0F;
+    x = (x | x << 2) & 0x33333333;
+    return (x | x << 1) & 0x55555555;
+}
+
+// Bytes that are 4-byte leads followed by 3 continuations: the characters
+// that become a surrogate pair. Invalid input has no more of them than it
+// has groups of 4 bytes, so dst stays within one unit per byte.
+inline __m128i utf8_pair_leads_128(__m128i in, __m128i in1, __m128i in2, __m128i in3) {
+    const __m128i top2 = _mm_set1_epi8((char)0xC0), cont = _mm_set1_epi8((char)0x80);
+    __m128i c = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(in1, top2), cont),
+                              _mm_cmpeq_epi8(_mm_and_si128(in2, top2), cont));
+    c = _mm_and_si128(c, _mm_cmpeq_epi8(_mm_and_si128(in3, top2), cont));
+    return _mm_and_si128(c, _mm_cmpeq_epi8(_mm_max_epu8(in, _mm_set1_epi8((char)0xF0)), in));
+}
+
+// Each 32-bit lane [lead c1 c2 c3] of payloads decoded as a character of 1
+// to 4 bytes; slot has the lead's length slot in every byte of its lane,
+// and the lanes set in pair get the surrogate pair, high unit in the low
+// half.
+inline __m128i utf8_units_wide_128(__m128i q, __m128i slot, __m128i pair) {
+    __m128i idx = _mm_or_si128(slot, _mm_set1_epi32(0x03020100));
+    __m128i v = _mm_madd_epi16(
+        _mm_maddubs_epi16(q, _mm_shuffle_epi8(_mm_load_si128((const __m128i*)kUtf8WideMulBytes), idx)),
+        _mm_shuffle_epi8(_mm_load_si128((const __m128i*)kUtf8WideMulWords), idx));
+    __m128i p = _mm_sub_epi32(v, _mm_set1_epi32(0x10000));
+    p = _mm_and_si128(_mm_or_si128(_mm_srli_epi32(p, 10), _mm_slli_epi32(p, 16)), _mm_set1_epi32(0x03FF03FF));
+    return _mm_blendv_epi8(v, _mm_or_si128(p, _mm_set1_epi32((int)0xDC00D800)), pair);
+}
+
+// The 16 bytes at s, 3 more readable, with 4-byte characters: every byte
+// taken as a lead in a 32-bit lane, the lanes of leads (and the high units
+// of pairs) packed per 4.
+inline size_t utf8_to_utf16_wide_16(const uint8_t* s, const Utf8Tables& t, char16_t* dst) {
+    const __m128i low6 = _mm_set1_epi8(0x3F);
+    __m128i in = _mm_loadu_si128((const __m128i*)s);
+    __m128i in1 = _mm_loadu_si128((const __m128i*)(s + 1));
+    __m128i in2 = _mm_loadu_si128((const __m128i*)(s + 2));
+    __m128i in3 = _mm_loadu_si128((const __m128i*)(s + 3));
+    __m128i pair = utf8_pair_leads_128(in, in1, in2, in3);
+    uint32_t m = utf8_interleave16(utf8_lead_mask_128(in)) | utf8_interleave16((uint32_t)_mm_movemask_epi8(pair)) << 1;
+    __m128i nib = _mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(0x0F));
+    __m128i x = _mm_and_si128(in, _mm_shuffle_epi8(_mm_load_si128((const __m128i*)kUtf8Payload), nib));
+    __m128i slot = _mm_shuffle_epi8(_mm_load_si128((const __m128i*)kUtf8LengthSlot), nib);
+    // Bytes to 32-bit lanes: [x c1 c2 c3], and slot and pair repeated.
+    __m128i x01 = _mm_unpacklo_epi8(x, _mm_and_si128(in1, low6));
+    __m128i x23 = _mm_unpacklo_epi8(_mm_and_si128(in2, low6), _mm_and_si128(in3, low6));
+    __m128i y01 = _mm_unpackhi_epi8(x, _mm_and_si128(in1, low6));
+    __m128i y23 = _mm_unpackhi_epi8(_mm_and_si128(in2, low6), _mm_and_si128(in3, low6));
+    __m128i sl = _mm_unpacklo_epi8(slot, slot), sh = _mm_unpackhi_epi8(slot, slot);
+    __m128i pl = _mm_unpacklo_epi8(pair, pair), ph = _mm_unpackhi_epi8(pair, pair);
+    size_t k = utf8_pack_units(utf8_units_wide_128(_mm_unpacklo_epi16(x01, x23), _mm_unpacklo_epi16(sl, sl),
+                                                   _mm_unpacklo_epi16(pl, pl)), m & 0xFF, t, dst);
+    k += utf8_pack_units(utf8_units_wide_128(_mm_unpackhi_epi16(x01, x23), _mm_unpackhi_epi16(sl, sl),
+                                             _mm_unpackhi_epi16(pl, pl)), m >> 8 & 0xFF, t, dst + k);
+    k += utf8_pack_units(utf8_units_wide_128(_mm_unpacklo_epi16(y01, y23), _mm_unpacklo_epi16(sh, sh),
+                                             _mm_unpacklo_epi16(ph, ph)), m >> 16 & 0xFF, t, dst + k);
+    return k + utf8_pack_units(utf8_units_wide_128(_mm_unpackhi_epi16(y01, y23), _mm_unpackhi_epi16(sh, sh),
+                                                   _mm_unpackhi_epi16(ph, ph)), m >> 24, t, dst + k);
+}
+
+// The bytes in use of 4 encoded units (pack_utf8 index idx) to dst; 16
+// bytes are stored.
+inline size_t utf16_pack_bytes(__m128i w, unsigned idx, const Utf8Tables& t, char* dst) {
+    _mm_storeu_si128((__m128i*)dst, _mm_shuffle_epi8(w, _mm_loadu_si128((const __m128i*)t.pack_utf8[idx])));
+    return t.pack_utf8_length[idx];
+}
+
+// 4 units below U+D800 or from U+E000, in 32-bit lanes, encoded to dst (16
+// bytes are stored); returns the bytes in use.
+inline size_t utf16_encode_bmp_4(__m128i u, const Utf8Tables& t, char* dst) {
+    const __m128i low6 = _mm_set1_epi32(0x3F);
+    __m128i two = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(u, 6), _mm_slli_epi32(_mm_and_si128(u, low6), 8)),
+                               _mm_set1_epi32(0x80C0));
+    __m128i three = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(u, 12),
+                                              _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(u, 6), low6), 8)),
+                                 _mm_or_si128(_mm_slli_epi32(_mm_and_si128(u, low6), 16), _mm_set1_epi32(0x8080E0)));
+    __m128i ge80 = _mm_cmpgt_epi32(u, _mm_set1_epi32(0x7F));
+    __m128i ge800 = _mm_cmpgt_epi32(u, _mm_set1_epi32(0x7FF));
+    __m128i w = _mm_blendv_epi8(_mm_blendv_epi8(u, two, ge80), three, ge800);
+    unsigned idx = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(ge80)) |
+                   (unsigned)_mm_movemask_ps(_mm_castsi128_ps(ge800)) << 4;
+    return utf16_pack_bytes(w, idx, t, dst);
+}
+
+// Whether the 8 units hold a surrogate.
+inline bool utf16_has_surrogate_128(__m128i v) {
+    __m128i s = _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16((short)0xF800)), _mm_set1_epi16((short)0xD800));
+    return !_mm_testz_si128(s, s);
+}
+
+#endif
+
+#if defined(__AVX2__)
+
+// The lookup validator over 32 bytes at a time; the bytes before lane 0 of
+// each 128-bit half come from vperm2i128.
+struct Utf8Check256 {
+    __m256i prev, incomplete, error;
+
+    Utf8Check256()
+        : prev(_mm256_setzero_si256()), incomplete(_mm256_setzero_si256()), error(_mm256_setzero_si256()) {}
+
+    void add(__m256i in) {
+        if (_mm256_movemask_epi8(in) == 0) {
+            error = _mm256_or_si256(error, incomplete);
+            prev = in;
+            incomplete = _mm256_setzero_si256();
+            return;
+        }
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        __m256i before = _mm256_permute2x128_si256(prev, in, 0x21);
+        __m256i prev1 = _mm256_alignr_epi8(in, before, 15);
+        __m256i b1h = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)kUtf8Byte1High)),
+                                          _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+        __m256i b1l = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)kUtf8Byte1Low)),
+                                          _mm256_and_si256(prev1, nibble));
+        __m256i b2h = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)kUtf8Byte2High)),
+                                          _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble));
+        __m256i special = _mm256_and_si256(_mm256_and_si256(b1h, b1l), b2h);
+        __m256i third = _mm256_subs_epu8(_mm256_alignr_epi8(in, before, 14), _mm256_set1_epi8((char)(0xE0 - 0x80)));
+        __m256i fourth = _mm256_subs_epu8(_mm256_alignr_epi8(in, before, 13), _mm256_set1_epi8((char)(0xF0 - 0x80)));
+        __m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8((char)0x80));
+        error = _mm256_or_si256(error, _mm256_xor_si256(must23, special));
+        prev = in;
+        incomplete = _mm256_subs_epu8(in, _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                           -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                           -1, (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1)));
+    }
+
+    bool ok() const {
+        __m256i e = _mm256_or_si256(error, incomplete);
+        return _mm256_testz_si256(e, e);
+    }
+};
+
+inline __m256i utf8_units_256(__m256i b0, __m256i b1, __m256i b2) {
+    const __m256i low6 = _mm256_set1_epi16(0x3F);
+    __m256i c1 = _mm256_and_si256(b1, low6), c2 = _mm256_and_si256(b2, low6);
+    __m256i two = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(b0, _mm256_set1_epi16(0x1F)), 6), c1);
+    __m256i three = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(b0, 12), _mm256_slli_epi16(c1, 6)), c2);
+    __m256i u = _mm256_blendv_epi8(b0, two, _mm256_cmpgt_epi16(b0, _mm256_set1_epi16(0xBF)));
+    return _mm256_blendv_epi8(u, three, _mm256_cmpgt_epi16(b0, _mm256_set1_epi16(0xDF)));
+}
+
+// 8 units in 32-bit lanes as two utf16_encode_bmp_4.
+inline size_t utf16_encode_bmp_8(__m256i u, const Utf8Tables& t, char* dst) {
+    const __m256i low6 = _mm256_set1_epi32(0x3F);
+    __m256i two = _mm256_or_si256(
+        _mm256_or_si256(_mm256_srli_epi32(u, 6), _mm256_slli_epi32(_mm256_and_si256(u, low6), 8)),
+        _mm256_set1_epi32(0x80C0));
+    __m256i three = _mm256_or_si256(
+        _mm256_or_si256(_mm256_srli_epi32(u, 12), _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(u, 6), low6), 8)),
+        _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(u, low6), 16), _mm256_set1_epi32(0x8080E0)));
+    __m256i ge80 = _mm256_cmpgt_epi32(u, _mm256_set1_epi32(0x7F));
+    __m256i ge800 = _mm256_cmpgt_epi32(u, _mm256_set1_epi32(0x7FF));
+    __m256i w = _mm256_blendv_epi8(_mm256_blendv_epi8(u, two, ge80), three, ge800);
+    unsigned m1 = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(ge80));
+    unsigned m2 = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(ge800));
+    size_t k = utf16_pack_bytes(_mm256_castsi256_si128(w), (m1 & 15) | (m2 & 15) << 4, t, dst);
+    return k + utf16_pack_bytes(_mm256_extracti128_si256(w, 1), m1 >> 4 | (m2 >> 4) << 4, t, dst + k);
+}
+
+inline __m256i utf8_pair_leads_256(__m256i in, __m256i in1, __m256i in2, __m256i in3) {
+    const __m256i top2 = _mm256_set1_epi8((char)0xC0), cont = _mm256_set1_epi8((char)0x80);
+    __m256i c = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(in1, top2), cont),
+                                 _mm256_cmpeq_epi8(_mm256_and_si256(in2, top2), cont));
+    c = _mm256_and_si256(c, _mm256_cmpeq_epi8(_mm256_and_si256(in3, top2), cont));
+    return _mm256_and_si256(c, _mm256_cmpeq_epi8(_mm256_max_epu8(in, _mm256_set1_epi8((char)0xF0)), in));
+}
+
+inline __m256i utf8_units_wide_256(__m256i q, __m256i slot, __m256i pair) {
+    __m256i idx = _mm256_or_si256(slot, _mm256_set1_epi32(0x03020100));
+    __m256i v = _mm256_madd_epi16(
+        _mm256_maddubs_epi16(
+            q, _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)kUtf8WideMulBytes)), idx)),
+        _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)kUtf8WideMulWords)), idx));
+    __m256i p = _mm256_sub_epi32(v, _mm256_set1_epi32(0x10000));
+    p = _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi32(p, 10), _mm256_slli_epi32(p, 16)),
+                         _mm256_set1_epi32(0x03FF03FF));
+    return _mm256_blendv_epi8(v, _mm256_or_si256(p, _mm256_set1_epi32((int)0xDC00D800)), pair);
+}
+
+// utf8_to_utf16_wide_16 on both 16-byte halves of 32 bytes at once; the
+// unpacks stay within 128-bit halves, so quad q of each half lands in the
+// matching half of lane vector q.
+inline size_t utf8_to_utf16_wide_32(const uint8_t* s, const Utf8Tables& t, char16_t* dst) {
+    const __m256i low6 = _mm256_set1_epi8(0x3F);
+    __m256i in = _mm256_loadu_si256((const __m256i*)s);
+    __m256i in1 = _mm256_loadu_si256((const __m256i*)(s + 1));
+    __m256i in2 = _mm256_loadu_si256((const __m256i*)(s + 2));
+    __m256i in3 = _mm256_loadu_si256((const __m256i*)(s + 3));
+    __m256i pair = utf8_pair_leads_256(in, in1, in2, in3);
+    uint32_t lead = (uint32_t)_mm256_movemask_epi8(_mm256_cmpgt_epi8(in, _mm256_set1_epi8(-65)));
+    uint32_t pairs = (uint32_t)_mm256_movemask_epi8(pair);
+    __m256i nib = _mm256_and_si256(_mm256_srli_epi16(in, 4), _mm256_set1_epi8(0x0F));
+    __m256i x = _mm256_and_si256(
+        in, _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)kUtf8Payload)), nib));
+    __m256i slot = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)kUtf8LengthSlot)), nib);
+    __m256i c1 = _mm256_and_si256(in1, low6), c2 = _mm256_and_si256(in2, low6), c3 = _mm256_and_si256(in3, low6);
+    __m256i x01 = _mm256_unpacklo_epi8(x, c1), x23 = _mm256_unpacklo_epi8(c2, c3);
+    __m256i y01 = _mm256_unpackhi_epi8(x, c1), y23 = _mm256_unpackhi_epi8(c2, c3);
+    __m256i sl = _mm256_unpacklo_epi8(slot, slot), sh = _mm256_unpackhi_epi8(slot, slot);
+    __m256i pl = _mm256_unpacklo_epi8(pair, pair), ph = _mm256_unpackhi_epi8(pair, pair);
+    __m256i u[4] = {
+        utf8_units_wide_256(_mm256_unpacklo_epi16(x01, x23), _mm256_unpacklo_epi16(sl, sl), _mm256_unpacklo_epi16(pl, pl)),
+        utf8_units_wide_256(_mm256_unpackhi_epi16(x01, x23), _mm256_unpackhi_epi16(sl, sl), _mm256_unpackhi_epi16(pl, pl)),
+        utf8_units_wide_256(_mm256_unpacklo_epi16(y01, y23), _mm256_unpacklo_epi16(sh, sh), _mm256_unpacklo_epi16(ph, ph)),
+        utf8_units_wide_256(_mm256_unpackhi_epi16(y01, y23), _mm256_unpackhi_epi16(sh, sh), _mm256_unpackhi_epi16(ph, ph))};
+    uint32_t m = utf8_interleave16(lead & 0xFFFF) | utf8_interleave16(pairs & 0xFFFF) << 1;
+    size_t k = 0;
+    for (int q = 0; q < 4; ++q, m >>= 8) k += utf8_pack_units(_mm256_castsi256_si128(u[q]), m & 0xFF, t, dst + k);
+    m = utf8_interleave16(lead >> 16) | utf8_interleave16(pairs >> 16) << 1;
+    for (int q = 0; q < 4; ++q, m >>= 8) k += utf8_pack_units(_mm256_extracti128_si256(u[q], 1), m & 0xFF, t, dst + k);
+    return k;
+}
+
+#endif
+
+#if defined(__AVX512BW__)
+
+// The lookup validator over 64 bytes at a time; valignq brings the last
+// 128-bit lane of the previous block in front of the first.
+struct Utf8Check512 {
+    __m512i prev, incomplete, error;
+
+    Utf8Check512()
+        : prev(_mm512_setzero_si512()), incomplete(_mm512_setzero_si512()), error(_mm512_setzero_si512()) {}
+
+    void add(__m512i in) {
+        if (_mm512_movepi8_mask(in) == 0) {
+            error = _mm512_or_si512(error, incomplete);
+            prev = in;
+            incomplete = _mm512_setzero_si512();
+            return;
+        }
+        const __m512i nibble = _mm512_set1_epi8(0x0F);
+        __m512i before = _mm512_alignr_epi64(in, prev, 6);
+        __m512i prev1 = _mm512_alignr_epi8(in, before, 15);
+        __m512i b1h = _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_load_si128((const __m128i*)kUtf8Byte1High)),
+                                          _mm512_and_si512(_mm512_srli_epi16(prev1, 4), nibble));
+        __m512i b1l = _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_load_si128((const __m128i*)kUtf8Byte1Low)),
+                                          _mm512_and_si512(prev1, nibble));
+        __m512i b2h = _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_load_si128((const __m128i*)kUtf8Byte2High)),
+                                          _mm512_and_si512(_mm512_srli_epi16(in, 4), nibble));
+        __m512i special = _mm512_ternarylogic_epi32(b1h, b1l, b2h, 0x80);   // a & b & c
+        __m512i third = _mm512_subs_epu8(_mm512_alignr_epi8(in, before, 14), _mm512_set1_epi8((char)(0xE0 - 0x80)));
+        __m512i fourth = _mm512_subs_epu8(_mm512_alignr_epi8(in, before, 13), _mm512_set1_epi8((char)(0xF0 - 0x80)));
+        __m512i must23 = _mm512_and_si512(_mm512_or_si512(third, fourth), _mm512_set1_epi8((char)0x80));
+        error = _mm512_ternarylogic_epi32(error, must23, special, 0xF6);   // a | (b ^ c)
+        prev = in;
+        // Only the last 3 bytes can be left open.
+        incomplete = _mm512_maskz_subs_epu8(0xE000000000000000ull, in,
+                                            _mm512_set4_epi32((int)0xBFDFEFFF, -1, -1, -1));
+    }
+
+    bool ok() const {
+        return _mm512_test_epi8_mask(error, error) == 0 && _mm512_test_epi8_mask(incomplete, incomplete) == 0;
+    }
+};
+
+inline __m512i utf8_units_512(__m512i b0, __m512i b1, __m512i b2) {
+    const __m512i low6 = _mm512_set1_epi16(0x3F);
+    __m512i c1 = _mm512_and_si512(b1, low6), c2 = _mm512_and_si512(b2, low6);
+    __m512i two = _mm512_or_si512(_mm512_slli_epi16(_mm512_and_si512(b0, _mm512_set1_epi16(0x1F)), 6), c1);
+    __m512i three = _mm512_ternarylogic_epi32(_mm512_slli_epi16(b0, 12), _mm512_slli_epi16(c1, 6), c2, 0xFE);
+    __m512i u = _mm512_mask_mov_epi16(b0, _mm512_cmpgt_epu16_mask(b0, _mm512_set1_epi16(0xBF)), two);
+    return _mm512_mask_mov_epi16(u, _mm512_cmpgt_epu16_mask(b0, _mm512_set1_epi16(0xDF)), three);
+}
+
+// 16 units in 32-bit lanes as four utf16_encode_bmp_4.
+inline size_t utf16_encode_bmp_16(__m512i u, const Utf8Tables& t, char* dst) {
+    const __m512i low6 = _mm512_set1_epi32(0x3F);
+    __m512i two = _mm512_ternarylogic_epi32(_mm512_srli_epi32(u, 6), _mm512_slli_epi32(_mm512_and_si512(u, low6), 8),
+                                            _mm512_set1_epi32(0x80C0), 0xFE);
+    __m512i three = _mm512_ternarylogic_epi32(
+        _mm512_srli_epi32(u, 12), _mm512_slli_epi32(_mm512_and_si512(_mm512_srli_epi32(u, 6), low6), 8),
+        _mm512_slli_epi32(_mm512_and_si512(u, low6), 16), 0xFE);
+    three = _mm512_or_si512(three, _mm512_set1_epi32(0x8080E0));
+    __mmask16 m1 = _mm512_cmpgt_epu32_mask(u, _mm512_set1_epi32(0x7F));
+    __mmask16 m2 = _mm512_cmpgt_epu32_mask(u, _mm512_set1_epi32(0x7FF));
+    __m512i w = _mm512_mask_mov_epi32(_mm512_mask_mov_epi32(u, m1, two), m2, three);
+    size_t k = utf16_pack_bytes(_mm512_castsi512_si128(w), (m1 & 15) | (m2 & 15) << 4, t, dst);
+    k += utf16_pack_bytes(_mm512_extracti32x4_epi32(w, 1), (m1 >> 4 & 15) | (m2 >> 4 & 15) << 4, t, dst + k);
+    k += utf16_pack_bytes(_mm512_extracti32x4_epi32(w, 2), (m1 >> 8 & 15) | (m2 >> 8 & 15) << 4, t, dst + k);
+    return k + utf16_pack_bytes(_mm512_extracti32x4_epi32(w, 3), (m1 >> 12) | (m2 >> 12) << 4, t, dst + k);
+}
+
+inline __m512i utf8_units_wide_512(__m512i q, __m512i slot, __m512i pair) {
+    __m512i idx = _mm512_or_si512(slot, _mm512_set1_epi32(0x03020100));
+    __m512i v = _mm512_madd_epi16(
+        _mm512_maddubs_epi16(
+            q, _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_load_si128((const __m128i*)kUtf8WideMulBytes)), idx)),
+        _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_load_si128((const __m128i*)kUtf8WideMulWords)), idx));
+    __m512i p = _mm512_sub_epi32(v, _mm512_set1_epi32(0x10000));
+    p = _mm512_ternarylogic_epi32(_mm512_srli_epi32(p, 10), _mm512_slli_epi32(p, 16), _mm512_set1_epi32(0x03FF03FF),
+                                  0xA8);   // (a | b) & c
+    p = _mm512_or_si512(p, _mm512_set1_epi32((int)0xDC00D800));
+    return _mm512_ternarylogic_epi32(pair, p, v, 0xCA);   // a ? b : c
+}
+
+// utf8_to_utf16_wide_32 on the four 16-byte lanes of 64 bytes; the lane
+// vectors are transposed by 128-bit lanes so that each holds the 4 quads
+// of one 16-byte lane in order.
+inline size_t utf8_to_utf16_wide_64(const uint8_t* s, const Utf8Tables& t, char16_t* dst) {
+    const __m512i low6 = _mm512_set1_epi8(0x3F), top2 = _mm512_set1_epi8((char)0xC0), cont = _mm512_set1_epi8((char)0x80);
+    __m512i in = _mm512_loadu_si512(s);
+    __m512i in1 = _mm512_loadu_si512(s + 1);
+    __m512i in2 = _mm512_loadu_si512(s + 2);
+    __m512i in3 = _mm512_loadu_si512(s + 3);
+    uint64_t pairs = _mm512_cmpge_epu8_mask(in, _mm512_set1_epi8((char)0xF0)) &
+                     _mm512_cmpeq_epi8_mask(_mm512_and_si512(in1, top2), cont) &
+                     _mm512_cmpeq_epi8_mask(_mm512_and_si512(in2, top2), cont) &
+                     _mm512_cmpeq_epi8_mask(_mm512_and_si512(in3, top2), cont);
+    uint64_t lead = _mm512_cmpgt_epi8_mask(in, _mm512_set1_epi8(-65));
+    __m512i pair = _mm512_movm_epi8(pairs);
+    __m512i nib = _mm512_and_si512(_mm512_srli_epi16(in, 4), _mm512_set1_epi8(0x0F));
+    __m512i x = _mm512_and_si512(
+        in, _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_load_si128((const __m128i*)kUtf8Payload)), nib));
+    __m512i slot = _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_load_si128((const __m128i*)kUtf8LengthSlot)), nib);
+    __m512i c1 = _mm512_and_si512(in1, low6), c2 = _mm512_and_si512(in2, low6), c3 = _mm512_and_si512(in3, low6);
+    __m512i x01 = _mm512_unpacklo_epi8(x, c1), x23 = _mm512_unpacklo_epi8(c2, c3);
+    __m512i y01 = _mm512_unpackhi_epi8(x, c1), y23 = _mm512_unpackhi_epi8(c2, c3);
+    __m512i sl = _mm512_unpacklo_epi8(slot, slot), sh = _mm512_unpackhi_epi8(slot, slot);
+    __m512i pl = _mm512_unpacklo_epi8(pair, pair), ph = _mm512_unpackhi_epi8(pair, pair);
+    __m512i u0 = utf8_units_wide_512(_mm512_unpacklo_epi16(x01, x23), _mm512_unpacklo_epi16(sl, sl),
+                                     _mm512_unpacklo_epi16(pl, pl));
+    __m512i u1 = utf8_units_wide_512(_mm512_unpackhi_epi16(x01, x23), _mm512_unpackhi_epi16(sl, sl),
+                                     _mm512_unpackhi_epi16(pl, pl));
+    __m512i u2 = utf8_units_wide_512(_mm512_unpacklo_epi16(y01, y23), _mm512_unpacklo_epi16(sh, sh),
+                                     _mm512_unpacklo_epi16(ph, ph));
+    __m512i u3 = utf8_units_wide_512(_mm512_unpackhi_epi16(y01, y23), _mm512_unpackhi_epi16(sh, sh),
+                                     _mm512_unpackhi_epi16(ph, ph));
+    __m512i t0 = _mm512_shuffle_i64x2(u0, u1, 0x44), t1 = _mm512_shuffle_i64x2(u0, u1, 0xEE);
+    __m512i t2 = _mm512_shuffle_i64x2(u2, u3, 0x44), t3 = _mm512_shuffle_i64x2(u2, u3, 0xEE);
+    __m512i v[4] = {_mm512_shuffle_i64x2(t0, t2, 0x88), _mm512_shuffle_i64x2(t0, t2, 0xDD),
+                    _mm512_shuffle_i64x2(t1, t3, 0x88), _mm512_shuffle_i64x2(t1, t3, 0xDD)};
+    size_t k = 0;
+    for (int h = 0; h < 4; ++h, lead >>= 16, pairs >>= 16) {
+        uint32_t m = utf8_interleave16(lead & 0xFFFF) | utf8_interleave16(pairs & 0xFFFF) << 1;
+        k += utf8_pack_units(_mm512_castsi512_si128(v[h]), m & 0xFF, t, dst + k);
+        k += utf8_pack_units(_mm512_extracti32x4_epi32(v[h], 1), m >> 8 & 0xFF, t, dst + k);
+        k += utf8_pack_units(_mm512_extracti32x4_epi32(v[h], 2), m >> 16 & 0xFF, t, dst + k);
+        k += utf8_pack_units(_mm512_extracti32x4_epi32(v[h], 3), m >> 24, t, dst + k);
+    }
+    return k;
+}
+
+#endif
+
+} // namespace
+
+} // namespace simd
+
+#endif // SIMD_UTF8_INTERNAL_H
@@ -0,0 +1,80 @@
+#include "kernels_internal.h"
+#include "utf8_internal.h"
+
+#include <cstring>
+
+namespace simd {
+
+namespace {
+
+Utf8Tables make_tables() {
+    Utf8Tables t;
+    std::memset(&t, 0x80, sizeof t);   // pshufb zeroes a lane whose control has bit 7
+    for (unsigned m = 0; m < 256; ++m) {
+        int k = 0;
+        for (int j = 0; j < 8; ++j) {
+            if (m >> j & 1) {
+                t.pack16[m][k++] = (uint8_t)(2 * j);
+                t.pack16[m][k++] = (uint8_t)(2 * j + 1);
+            }
+        }
+        // Only the indices with m2 a subset of m1 occur.
+        unsigned m1 = m & 15, m2 = m >> 4;
+        k = 0;
+        for (int j = 0; j < 4; ++j) {
+            int bytes = 1 + (m1 >> j & 1) + (m2 >> j & 1);
+            for (int b = 0; b < bytes; ++b) t.pack_utf8[m][k++] = (uint8_t)(4 * j + b);
+        }
+        t.pack_utf8_length[m] = (uint8_t)k;
+    }
+    return t;
+}
+
+} // namespace
+
+const Utf8Tables& utf8_tables() {
+    static const Utf8Tables tables = make_tables();
+    return tables;
+}
+
+namespace scalar {
+
+bool utf8_validate(const char* src, size_t n) {
+    const uint8_t* s = (const uint8_t*)src;
+    size_t i = 0;
+    while (i < n) {
+        // 8 ASCII bytes at a time.
+        if (n - i >= 8) {
+            uint64_t w;
+            std::memcpy(&w, s + i, 8);
+            if ((w & 0x8080808080808080ull) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+        uint32_t cp;
+        size_t len = utf8_decode_one(s, i, n, &cp);
+        if (!len) return false;
+        i += len;
+    }
+    return true;
+}
+
+bool utf8_to_utf16(const char* src, size_t n, char16_t* dst, size_t* written) {
+    size_t i = 0, k = 0;
+    *written = 0;
+    if (!utf8_to_utf16_scalar((const uint8_t*)src, &i, n, n, dst, &k)) return false;
+    *written = k;
+    return true;
+}
+
+bool utf16_to_utf8(const char16_t* src, size_t n, char* dst, size_t* written) {
+    size_t i = 0, k = 0;
+    *written = 0;
+    if (!utf16_to_utf8_scalar(src, &i, n, n, dst, &k)) return false;
+    *written = k;
+    return true;
+}
+
+} // namespace scalar
+} // namespace simd
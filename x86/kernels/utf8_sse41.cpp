@@ -0,0 +1,88 @@
+#include "kernels_internal.h"
+#include "utf8_internal.h"
+#include "safe_load.h"
+
+#include <immintrin.h>
+
+namespace simd {
+namespace sse41 {
+
+// 16 bytes or 8 units per block (utf8_internal.h). The transcoders validate
+// every block as they go and report the result at the end; the blocks stop
+// short of the end by the bytes they read ahead and the slack of their
+// whole-vector stores, and the rest goes through the scalar loop.
+
+bool utf8_validate(const char* src, size_t n) {
+    const uint8_t* s = (const uint8_t*)src;
+    Utf8Check128 check;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) check.add(_mm_loadu_si128((const __m128i*)(s + i)));
+    if (i < n) check.add(load_tail_128(s + i, n - i));   // zero bytes are ASCII
+    return check.ok();
+}
+
+bool utf8_to_utf16(const char* src, size_t n, char16_t* dst, size_t* written) {
+    const Utf8Tables& t = utf8_tables();
+    const uint8_t* s = (const uint8_t*)src;
+    Utf8Check128 check;
+    size_t i = 0, k = 0;
+    *written = 0;
+    // A block reads 3 bytes past its end. k may lead the block by 3 units
+    // after a character that crossed into it, and the last 8-unit store
+    // starts at most 3 units past the block's last 4 bytes.
+    for (; i + 23 <= n; i += 16) {
+        __m128i in = _mm_loadu_si128((const __m128i*)(s + i));
+        check.add(in);
+        if (_mm_movemask_epi8(in) == 0) {
+            _mm_storeu_si128((__m128i*)(dst + k), _mm_cvtepu8_epi16(in));
+            _mm_storeu_si128((__m128i*)(dst + k + 8), _mm_cvtepu8_epi16(_mm_srli_si128(in, 8)));
+            k += 16;
+        } else if (!utf8_has_4byte_128(in)) {
+            __m128i in1 = _mm_loadu_si128((const __m128i*)(s + i + 1));
+            __m128i in2 = _mm_loadu_si128((const __m128i*)(s + i + 2));
+            uint32_t lead = utf8_lead_mask_128(in);
+            __m128i lo = utf8_units_128(_mm_cvtepu8_epi16(in), _mm_cvtepu8_epi16(in1), _mm_cvtepu8_epi16(in2));
+            __m128i hi = utf8_units_128(_mm_cvtepu8_epi16(_mm_srli_si128(in, 8)),
+                                        _mm_cvtepu8_epi16(_mm_srli_si128(in1, 8)),
+                                        _mm_cvtepu8_epi16(_mm_srli_si128(in2, 8)));
+            k += utf8_pack_units(lo, lead & 0xFF, t, dst + k);
+            k += utf8_pack_units(hi, lead >> 8, t, dst + k);
+        } else {
+            k += utf8_to_utf16_wide_16(s + i, t, dst + k);
+        }
+    }
+    for (size_t j = i; j < n; j += 16) {
+        check.add(n - j >= 16 ? _mm_loadu_si128((const __m128i*)(s + j)) : load_tail_128(s + j, n - j));
+    }
+    while (i < n && (s[i] & 0xC0) == 0x80) ++i;
+    if (!utf8_to_utf16_scalar(s, &i, n, n, dst, &k) || !check.ok()) return false;
+    *written = k;
+    return true;
+}
+
+bool utf16_to_utf8(const char16_t* src, size_t n, char* dst, size_t* written) {
+    const Utf8Tables& t = utf8_tables();
+    size_t i = 0, k = 0;
+    *written = 0;
+    // The last 16-byte store of a block may pass its 3 bytes per unit by 4.
+    while (i + 10 <= n) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        if (_mm_testz_si128(v, _mm_set1_epi16((short)0xFF80))) {
+            _mm_storel_epi64((__m128i*)(dst + k), _mm_packus_epi16(v, v));
+            k += 8;
+            i += 8;
+        } else if (!utf16_has_surrogate_128(v)) {
+            k += utf16_encode_bmp_4(_mm_cvtepu16_epi32(v), t, dst + k);
+            k += utf16_encode_bmp_4(_mm_cvtepu16_epi32(_mm_srli_si128(v, 8)), t, dst + k);
+            i += 8;
+        } else if (!utf16_to_utf8_scalar(src, &i, i + 8, n, dst, &k)) {
+            return false;
+        }
+    }
+    if (!utf16_to_utf8_scalar(src, &i, n, n, dst, &k)) return false;
+    *written = k;
+    return true;
+}
+
+} // namespace sse41
+} // namespace simd
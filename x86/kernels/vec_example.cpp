@@ -0,0 +1,362 @@
+// Every kernel here is written twice: once against simd::native_vec<T>
+// (vec_*) and once with the intrinsics of the level it is built for (raw_*).
+// CMake builds this file at three levels (vec_example_sse41, _avx2, _avx512);
+// the vec_* source is the same at all three.
+//
+// Running it checks that each pair computes bit-identical results.
+// ../check_vec_codegen.sh checks the stronger claim, that each pair compiles to
+// the same instructions.
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include "simd_vec.h"
+
+#define NOINLINE __attribute__((noinline))
+
+typedef simd::native_vec<float> V;
+typedef simd::native_vec<int32_t> VI;
+static_assert(V::lanes == VI::lanes, "float and index vectors must line up");
+
+// --- vec<T, N> ---
+
+extern "C" NOINLINE void vec_saxpy(float a, const float* x, float* y, size_t n) {
+    V va = V::broadcast(a);
+    size_t i = 0;
+    for (; i + V::lanes <= n; i += V::lanes) simd::fma(va, V::loadu(x + i), V::loadu(y + i)).storeu(y + i);
+#if SIMD_VEC_HAS_MASKED
+    if (i < n) {
+        V::mask_type m = V::first_n(n - i);
+        simd::fma(va, V::load_masked(m, x + i), V::load_masked(m, y + i)).store_masked(m, y + i);
+    }
+#else
+    for (; i < n; ++i) y[i] = a * x[i] + y[i];
+#endif
+}
+
+extern "C" NOINLINE float vec_dot(const float* x, const float* y, size_t n) {
+    V acc = V::zero();
+    size_t i = 0;
+    for (; i + V::lanes <= n; i += V::lanes) acc = simd::fma(V::loadu(x + i), V::loadu(y + i), acc);
+#if SIMD_VEC_HAS_MASKED
+    if (i < n) {
+        V::mask_type m = V::first_n(n - i);
+        acc = simd::fma(V::load_masked(m, x + i), V::load_masked(m, y + i), acc);
+    }
+    return simd::reduce_add(acc);
+#else
+    float s = simd::reduce_add(acc);
+    for (; i < n; ++i) s += x[i] * y[i];
+    return s;
+#endif
+}
+
+// Leaky ReLU: x < 0 ? x * slope : x.
+extern "C" NOINLINE void vec_leaky_relu(const float* x, float* y, float slope, size_t n) {
+    V vs = V::broadcast(slope);
+    size_t i = 0;
+    for (; i + V::lanes <= n; i += V::lanes) {
+        V v = V::loadu(x + i);
+        simd::select(v < V::zero(), v * vs, v).storeu(y + i);
+    }
+    for (; i < n; ++i) y[i] = x[i] < 0.0f ? x[i] * slope : x[i];
+}
+
+// Aligned source and destination, n a multiple of the vector length.
+extern "C" NOINLINE void vec_stream_copy(const float* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; i += V::lanes) V::load(src + i).stream(dst + i);
+    _mm_sfence();
+}
+
+#if SIMD_VEC_HAS_GATHER
+extern "C" NOINLINE float vec_gather_sum(const float* table, const int32_t* idx, size_t n) {
+    V acc = V::zero();
+    size_t i = 0;
+    for (; i + V::lanes <= n; i += V::lanes) acc += V::gather(table, VI::loadu(idx + i));
+    float s = simd::reduce_add(acc);
+    for (; i < n; ++i) s += table[idx[i]];
+    return s;
+}
+#endif
+
+#if SIMD_VEC_HAS_SCATTER
+extern "C" NOINLINE void vec_scatter(const float* src, const int32_t* idx, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + V::lanes <= n; i += V::lanes) V::loadu(src + i).scatter(dst, VI::loadu(idx + i));
+    for (; i < n; ++i) dst[idx[i]] = src[i];
+}
+#endif
+
+// --- Raw intrinsics, one set per level ---
+
+#if defined(__AVX512F__)
+
+static inline __mmask16 tail16(size_t r) {
+    return (__mmask16)_bzhi_u32(0xFFFF, (unsigned)r);
+}
+
+extern "C" NOINLINE void raw_saxpy(float a, const float* x, float* y, size_t n) {
+    __m512 va = _mm512_set1_ps(a);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+        _mm512_storeu_ps(y + i, _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+    if (i < n) {
+        __mmask16 m = tail16(n - i);
+        _mm512_mask_storeu_ps(y + i, m,
+                              _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(m, x + i), _mm512_maskz_loadu_ps(m, y + i)));
+    }
+}
+
+extern "C" NOINLINE float raw_dot(const float* x, const float* y, size_t n) {
+    __m512 acc = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) acc = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), acc);
+    if (i < n) {
+        __mmask16 m = tail16(n - i);
+        acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, x + i), _mm512_maskz_loadu_ps(m, y + i), acc);
+    }
+    return _mm512_reduce_add_ps(acc);
+}
+
+extern "C" NOINLINE void raw_leaky_relu(const float* x, float* y, float slope, size_t n) {
+    __m512 vs = _mm512_set1_ps(slope);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 v = _mm512_loadu_ps(x + i);
+        __mmask16 neg = _mm512_cmp_ps_mask(v, _mm512_setzero_ps(), _CMP_LT_OQ);
+        _mm512_storeu_ps(y + i, _mm512_mask_blend_ps(neg, v, _mm512_mul_ps(v, vs)));
+    }
+    for (; i < n; ++i) y[i] = x[i] < 0.0f ? x[i] * slope : x[i];
+}
+
+extern "C" NOINLINE void raw_stream_copy(const float* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; i += 16) _mm512_stream_ps(dst + i, _mm512_load_ps(src + i));
+    _mm_sfence();
+}
+
+extern "C" NOINLINE float raw_gather_sum(const float* table, const int32_t* idx, size_t n) {
+    __m512 acc = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+        acc = _mm512_add_ps(acc, _mm512_i32gather_ps(_mm512_loadu_si512(idx + i), table, 4));
+    float s = _mm512_reduce_add_ps(acc);
+    for (; i < n; ++i) s += table[idx[i]];
+    return s;
+}
+
+extern "C" NOINLINE void raw_scatter(const float* src, const int32_t* idx, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) _mm512_i32scatter_ps(dst, _mm512_loadu_si512(idx + i), _mm512_loadu_ps(src + i), 4);
+    for (; i < n; ++i) dst[idx[i]] = src[i];
+}
+
+#elif defined(__AVX2__)
+
+alignas(64) static const int32_t kWindow[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+
+static inline float hsum256(__m256 v) {
+    __m128 t = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    t = _mm_add_ps(t, _mm_movehl_ps(t, t));
+    t = _mm_add_ss(t, _mm_shuffle_ps(t, t, 1));
+    return _mm_cvtss_f32(t);
+}
+
+extern "C" NOINLINE void raw_saxpy(float a, const float* x, float* y, size_t n) {
+    __m256 va = _mm256_set1_ps(a);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    if (i < n) {
+        __m256i m = _mm256_loadu_si256((const __m256i*)(kWindow + 8 - (n - i)));
+        _mm256_maskstore_ps(y + i, m,
+                            _mm256_fmadd_ps(va, _mm256_maskload_ps(x + i, m), _mm256_maskload_ps(y + i, m)));
+    }
+}
+
+extern "C" NOINLINE float raw_dot(const float* x, const float* y, size_t n) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) acc = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc);
+    if (i < n) {
+        __m256i m = _mm256_loadu_si256((const __m256i*)(kWindow + 8 - (n - i)));
+        acc = _mm256_fmadd_ps(_mm256_maskload_ps(x + i, m), _mm256_maskload_ps(y + i, m), acc);
+    }
+    return hsum256(acc);
+}
+
+extern "C" NOINLINE void raw_leaky_relu(const float* x, float* y, float slope, size_t n) {
+    __m256 vs = _mm256_set1_ps(slope);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(x + i);
+        __m256 neg = _mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_LT_OQ);
+        _mm256_storeu_ps(y + i, _mm256_blendv_ps(v, _mm256_mul_ps(v, vs), neg));
+    }
+    for (; i < n; ++i) y[i] = x[i] < 0.0f ? x[i] * slope : x[i];
+}
+
+extern "C" NOINLINE void raw_stream_copy(const float* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; i += 8) _mm256_stream_ps(dst + i, _mm256_load_ps(src + i));
+    _mm_sfence();
+}
+
+extern "C" NOINLINE float raw_gather_sum(const float* table, const int32_t* idx, size_t n) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        acc = _mm256_add_ps(acc, _mm256_i32gather_ps(table, _mm256_loadu_si256((const __m256i*)(idx + i)), 4));
+    float s = hsum256(acc);
+    for (; i < n; ++i) s += table[idx[i]];
+    return s;
+}
+
+#else // SSE4.1
+
+static inline float hsum128(__m128 v) {
+    __m128 t = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    t = _mm_add_ss(t, _mm_shuffle_ps(t, t, 1));
+    return _mm_cvtss_f32(t);
+}
+
+extern "C" NOINLINE void raw_saxpy(float a, const float* x, float* y, size_t n) {
+    __m128 va = _mm_set1_ps(a);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_mul_ps(va, _mm_loadu_ps(x + i)), _mm_loadu_ps(y + i)));
+    for (; i < n; ++i) y[i] = a * x[i] + y[i];
+}
+
+extern "C" NOINLINE float raw_dot(const float* x, const float* y, size_t n) {
+    __m128 acc = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) acc = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)), acc);
+    float s = hsum128(acc);
+    for (; i < n; ++i) s += x[i] * y[i];
+    return s;
+}
+
+extern "C" NOINLINE void raw_leaky_relu(const float* x, float* y, float slope, size_t n) {
+    __m128 vs = _mm_set1_ps(slope);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(x + i);
+        __m128 neg = _mm_cmplt_ps(v, _mm_setzero_ps());
+        _mm_storeu_ps(y + i, _mm_blendv_ps(v, _mm_mul_ps(v, vs), neg));
+    }
+    for (; i < n; ++i) y[i] = x[i] < 0.0f ? x[i] * slope : x[i];
+}
+
+extern "C" NOINLINE void raw_stream_copy(const float* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; i += 4) _mm_stream_ps(dst + i, _mm_load_ps(src + i));
+    _mm_sfence();
+}
+
+#endif
+
+// --- Checks ---
+
+namespace {
+
+bool same_bits(const std::vector<float>& a, const std::vector<float>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+bool same_bits(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+bool report(const char* name, bool identical, bool correct) {
+    std::cout << "  " << name << ": " << (identical && correct ? "OK" : "MISMATCH")
+              << (identical ? "" : " (vec and raw differ)") << (correct ? "" : " (wrong result)") << std::endl;
+    return identical && correct;
+}
+
+bool cpu_has_level() {
+#if defined(__AVX512F__)
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl");
+#elif defined(__AVX2__)
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+} // namespace
+
+int main() {
+    const char* level = SIMD_VEC_NATIVE_BYTES == 64 ? "avx512" : SIMD_VEC_NATIVE_BYTES == 32 ? "avx2" : "sse4.1";
+    std::cout << "native_vec<float>: " << V::lanes << " lanes (" << level << ")" << std::endl;
+    if (!cpu_has_level()) {
+        std::cout << "CPU lacks " << level << ", skipped" << std::endl;
+        return 0;
+    }
+
+    float ramp[V::lanes];
+    for (int i = 0; i < V::lanes; ++i) ramp[i] = (float)i;
+    std::cout << "V::loadu(0, 1, 2, ...) * 2 = ";
+    simd::print(V::loadu(ramp) * V::broadcast(2.0f));
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> val(-4.0f, 4.0f);
+    bool ok = true;
+    // Lengths that hit every tail size.
+    for (size_t n : {(size_t)0, (size_t)1, (size_t)V::lanes - 1, (size_t)V::lanes, (size_t)1000, (size_t)1003}) {
+        std::cout << "n = " << n << std::endl;
+        std::vector<float> x(n), y(n);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = val(rng);
+            y[i] = val(rng);
+        }
+
+        std::vector<float> ref = y, yr = y, yv = y;
+        for (size_t i = 0; i < n; ++i) ref[i] = 1.5f * x[i] + y[i];
+        raw_saxpy(1.5f, x.data(), yr.data(), n);
+        vec_saxpy(1.5f, x.data(), yv.data(), n);
+        bool close = true;
+        for (size_t i = 0; i < n; ++i) close = close && std::fabs(yv[i] - ref[i]) <= 1e-5f * (1.0f + std::fabs(ref[i]));
+        ok &= report("saxpy", same_bits(yr, yv), close);
+
+        double dref = 0;
+        for (size_t i = 0; i < n; ++i) dref += (double)x[i] * y[i];
+        float dr = raw_dot(x.data(), y.data(), n), dv = vec_dot(x.data(), y.data(), n);
+        ok &= report("dot", same_bits(dr, dv), std::fabs(dv - dref) <= 1e-3 * (1.0 + n));
+
+        for (size_t i = 0; i < n; ++i) ref[i] = x[i] < 0.0f ? x[i] * 0.1f : x[i];
+        raw_leaky_relu(x.data(), yr.data(), 0.1f, n);
+        vec_leaky_relu(x.data(), yv.data(), 0.1f, n);
+        ok &= report("leaky_relu", same_bits(yr, yv), same_bits(yv, ref));
+
+        std::vector<int32_t> idx(n);
+        for (size_t i = 0; i < n; ++i) idx[i] = (int32_t)(rng() % n);
+#if SIMD_VEC_HAS_GATHER
+        double gref = 0;
+        for (size_t i = 0; i < n; ++i) gref += x[idx[i]];
+        float gr = raw_gather_sum(x.data(), idx.data(), n), gv = vec_gather_sum(x.data(), idx.data(), n);
+        ok &= report("gather_sum", same_bits(gr, gv), std::fabs(gv - gref) <= 1e-3 * (1.0 + n));
+#endif
+#if SIMD_VEC_HAS_SCATTER
+        // A permutation, so that the result does not depend on which duplicate wins.
+        for (size_t i = 0; i < n; ++i) idx[i] = (int32_t)i;
+        std::shuffle(idx.begin(), idx.end(), rng);
+        for (size_t i = 0; i < n; ++i) ref[idx[i]] = x[i];
+        raw_scatter(x.data(), idx.data(), yr.data(), n);
+        vec_scatter(x.data(), idx.data(), yv.data(), n);
+        ok &= report("scatter", same_bits(yr, yv), same_bits(yv, ref));
+#endif
+    }
+
+    const size_t m = 4096;
+    alignas(64) static float src[m], dr[m], dv[m];
+    for (size_t i = 0; i < m; ++i) src[i] = (float)i;
+    raw_stream_copy(src, dr, m);
+    vec_stream_copy(src, dv, m);
+    bool copied = std::memcmp(src, dv, sizeof(src)) == 0;
+    ok &= report("stream_copy", std::memcmp(dr, dv, sizeof(dr)) == 0, copied);
+
+    std::cout << (ok ? "All checks passed." : "SOME CHECKS FAILED.") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -27,10 +27,18 @@ if [ -f "./build/avx512/$EXAMPLE_NAME" ]; then
     EXAMPLE_PATH="./build/avx512/$EXAMPLE_NAME"
 fi
 
+if [ -f "./build/kernels/$EXAMPLE_NAME" ]; then
+    EXAMPLE_PATH="./build/kernels/$EXAMPLE_NAME"
+fi
+
 if [ -z "$EXAMPLE_PATH" ]; then
-    echo "Error: Example '$EXAMPLE_NAME' not found in ./build/{sse,avx,avx2,avx512}/"
+    echo "Error: Example '$EXAMPLE_NAME' not found in ./build/{sse,avx,avx2,avx512,kernels}/"
     exit 1
 fi
 
-# Run the example with QEMU, specifying a CPU with AVX512 support
-./sde-external-9.58.0-2025-06-16-lin/sde  -icl -- $EXAMPLE_PATH
\ No newline at end of file
+# CPU model to emulate. Defaults to Ice Lake (AVX-512); use e.g. SDE_CPU=-hsw
+# (AVX2) or SDE_CPU=-nhm (SSE4.2) to exercise the lower dispatch levels.
+SDE_CPU=${SDE_CPU:--icl}
+
+# Run the example with SDE, specifying a CPU with AVX512 support by default
+./sde-external-9.58.0-2025-06-16-lin/sde $SDE_CPU -- $EXAMPLE_PATH "${@:2}"
\ No newline at end of file